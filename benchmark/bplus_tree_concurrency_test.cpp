@@ -41,6 +41,10 @@ struct Stat
   int64_t scan_open_failed_count = 0;
   int64_t mismatch_count         = 0;
   int64_t scan_other_count       = 0;
+
+  int64_t get_success_count  = 0;
+  int64_t get_mismatch_count = 0;
+  int64_t get_other_count    = 0;
 };
 
 class BenchmarkBase : public Fixture
@@ -180,6 +184,21 @@ public:
     }
   }
 
+  void Get(uint32_t value, size_t expect_count, Stat &stat)
+  {
+    const char *key = reinterpret_cast<const char *>(&value);
+
+    list<RID> rids;
+    RC        rc = handler_.get_entry(key, sizeof(value), rids);
+    if (rc != RC::SUCCESS) {
+      stat.get_other_count++;
+    } else if (rids.size() != expect_count) {
+      stat.get_mismatch_count++;
+    } else {
+      stat.get_success_count++;
+    }
+  }
+
 protected:
   BplusTreeHandler handler_;
 };
@@ -346,4 +365,106 @@ BENCHMARK_REGISTER_F(MixtureBenchmark, Mixture)->Threads(10)->Arg(4 * 10000);
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * @brief 读多写少的场景
+ * @details 偶数键值预先插入并且一直保留，写操作只插入和删除奇数键值，这样读操作的结果是确定的：
+ * 点查偶数键值一定能找到一条数据，范围扫描找到的偶数键值个数也是确定的。
+ * 用来观察读操作在有并发修改时的扩展性。
+ */
+class ReadMostlyBenchmark : public BenchmarkBase
+{
+public:
+  string Name() const override { return "read_mostly"; }
+
+  void SetUp(const State &state) override
+  {
+    if (0 != state.thread_index()) {
+      return;
+    }
+
+    BenchmarkBase::SetUp(state);
+
+    uint32_t max = GetRangeMax(state);
+    ASSERT(max > 0, "invalid argument count. %ld", state.range(0));
+    for (uint32_t value = 0; value < max; value += 2) {
+      const char *key = reinterpret_cast<const char *>(&value);
+      RID         rid(value, value);
+
+      [[maybe_unused]] RC rc = handler_.insert_entry(key, &rid);
+      ASSERT(rc == RC::SUCCESS, "failed to insert entry into btree. key=%" PRIu32, value);
+    }
+  }
+
+  void ScanEven(uint32_t begin, uint32_t end, Stat &stat)
+  {
+    const char *begin_key = reinterpret_cast<const char *>(&begin);
+    const char *end_key   = reinterpret_cast<const char *>(&end);
+
+    BplusTreeScanner scanner(handler_);
+
+    RC rc = scanner.open(begin_key, sizeof(begin), true /*inclusive*/, end_key, sizeof(end), true /*inclusive*/);
+    if (rc != RC::SUCCESS) {
+      stat.scan_open_failed_count++;
+      return;
+    }
+
+    RID      rid;
+    uint32_t count = 0;
+    while (RC::SUCCESS == (rc = scanner.next_entry(rid))) {
+      if (rid.page_num % 2 == 0) {
+        count++;
+      }
+    }
+
+    if (rc != RC::RECORD_EOF) {
+      stat.scan_other_count++;
+    } else if (count != end / 2 - (begin + 1) / 2 + 1) {
+      stat.mismatch_count++;
+    } else {
+      stat.scan_success_count++;
+    }
+    scanner.close();
+  }
+};
+
+BENCHMARK_DEFINE_F(ReadMostlyBenchmark, ReadMostly)(State &state)
+{
+  const uint32_t max            = GetRangeMax(state);
+  const int      max_range_size = 100;
+
+  // 扫描的范围不能超过预先插入的数据
+  IntegerGenerator data_generator(0, (max - max_range_size) / 2 - 1);
+  IntegerGenerator scan_range_generator(1, max_range_size);
+  IntegerGenerator operation_generator(0, 99);
+
+  Stat stat;
+
+  for (auto _ : state) {
+    const int64_t  operation = operation_generator.next();
+    const uint32_t value     = static_cast<uint32_t>(data_generator.next()) * 2;
+    if (operation < 5) {  // insert
+      Insert(value + 1, stat);
+    } else if (operation < 10) {  // delete
+      Delete(value + 1, stat);
+    } else if (operation < 80) {  // point get
+      Get(value, 1, stat);
+    } else {  // short range scan
+      ScanEven(value, value + static_cast<uint32_t>(scan_range_generator.next()), stat);
+    }
+  }
+
+  state.counters.insert({{"get_success", Counter(stat.get_success_count, Counter::kIsRate)},
+      {"get_mismatch", Counter(stat.get_mismatch_count, Counter::kIsRate)},
+      {"get_other", Counter(stat.get_other_count, Counter::kIsRate)},
+      {"scan_success", Counter(stat.scan_success_count, Counter::kIsRate)},
+      {"scan_mismatch", Counter(stat.mismatch_count, Counter::kIsRate)},
+      {"scan_other", Counter(stat.scan_other_count + stat.scan_open_failed_count, Counter::kIsRate)},
+      {"insert_success", Counter(stat.insert_success_count, Counter::kIsRate)},
+      {"delete_success", Counter(stat.delete_success_count, Counter::kIsRate)}});
+}
+
+BENCHMARK_REGISTER_F(ReadMostlyBenchmark, ReadMostly)->ThreadRange(1, 16)->Arg(4 * 10000);
+
+////////////////////////////////////////////////////////////////////////////////
+
 BENCHMARK_MAIN();
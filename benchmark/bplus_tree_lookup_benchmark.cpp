@@ -0,0 +1,104 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+//
+// B+树节点内查找的微基准测试，对比通用的 memcmp 查找与按键值长度特化的查找
+//
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include "storage/buffer/page.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/index/bplus_tree_search.h"
+
+using namespace std;
+using namespace benchmark;
+using namespace bplus_tree_search;
+
+/**
+ * @brief 构造一个装满单列整数键值的叶子节点
+ * @details 每项是规范化的键值(整数 + RID)加上 RID，prefix_length 模拟节点中的公共前缀，
+ * 查找时只比较后缀。
+ */
+class LeafLookup
+{
+public:
+  explicit LeafLookup(int prefix_length) : prefix_length_(prefix_length)
+  {
+    normalizer_.init({INTS}, {sizeof(int32_t)});
+    key_size_  = normalizer_.key_length() - prefix_length_;
+    item_size_ = key_size_ + static_cast<int>(sizeof(RID));
+    count_     = (BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE - prefix_length_) / item_size_;
+
+    // 有公共前缀时键值的高位都相同，这里取连续的偶数，查找时用奇数模拟不存在的键值
+    vector<char> key(normalizer_.key_length());
+    items_.resize(static_cast<size_t>(count_) * item_size_);
+    for (int i = 0; i < count_; i++) {
+      const int32_t value = i * 2;
+      const RID     rid(value, 0);
+      normalizer_.normalize(reinterpret_cast<const char *>(&value), rid, key.data());
+      memcpy(items_.data() + i * item_size_, key.data() + prefix_length_, key_size_);
+      memcpy(items_.data() + i * item_size_ + key_size_, &rid, sizeof(rid));
+    }
+
+    mt19937 rng(0);
+    for (int i = 0; i < 1024; i++) {
+      const int32_t value = static_cast<int32_t>(rng() % (count_ * 2));
+      const RID     rid(value & ~1, 0);
+      normalizer_.normalize(reinterpret_cast<const char *>(&value), rid, key.data());
+      search_keys_.emplace_back(key.begin() + prefix_length_, key.end());
+    }
+  }
+
+  void run(State &state, SearchFunc search)
+  {
+    int64_t found_count = 0;
+    size_t  i           = 0;
+    for (auto _ : state) {
+      bool found = false;
+      int  index = search(items_.data(), item_size_, count_, search_keys_[i].data(), key_size_, &found);
+      DoNotOptimize(index);
+      found_count += found ? 1 : 0;
+      i = (i + 1) % search_keys_.size();
+    }
+    state.counters["items"] = count_;
+    state.counters["found"] = Counter(found_count, Counter::kAvgIterations);
+  }
+
+  int key_size() const { return key_size_; }
+
+private:
+  KeyNormalizer        normalizer_;
+  int                  prefix_length_ = 0;
+  int                  key_size_      = 0;
+  int                  item_size_     = 0;
+  int                  count_         = 0;
+  vector<char>         items_;
+  vector<vector<char>> search_keys_;
+};
+
+static void LookupGeneric(State &state)
+{
+  LeafLookup lookup(static_cast<int>(state.range(0)));
+  lookup.run(state, generic_lower_bound);
+}
+
+static void LookupSpecialized(State &state)
+{
+  LeafLookup lookup(static_cast<int>(state.range(0)));
+  lookup.run(state, search_function(lookup.key_size()));
+}
+
+// 参数是节点的公共前缀长度，0 表示没有前缀，2 是整数较小时常见的情况
+BENCHMARK(LookupGeneric)->Arg(0)->Arg(2);
+BENCHMARK(LookupSpecialized)->Arg(0)->Arg(2);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,76 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+
+#include "common/lang/bloom_filter.h"
+
+namespace common {
+
+void BloomFilter::init(int64_t expected_items, int bits_per_item)
+{
+  const int64_t bits = std::max<int64_t>(64, std::max<int64_t>(expected_items, 1) * bits_per_item);
+  words_.assign((bits + 63) / 64, 0);
+  bit_count_ = words_.size() * 64;
+  // 最优的哈希函数个数是 bits_per_item * ln2
+  hash_count_ = std::clamp(static_cast<int>(bits_per_item * 0.69 + 0.5), 1, 16);
+}
+
+void BloomFilter::init(std::vector<uint64_t> words, int hash_count)
+{
+  words_      = std::move(words);
+  bit_count_  = words_.size() * 64;
+  hash_count_ = hash_count;
+}
+
+void BloomFilter::add(uint64_t hash)
+{
+  const uint64_t delta = (hash >> 32) | 1;
+  for (int i = 0; i < hash_count_; i++) {
+    const uint64_t bit = hash % bit_count_;
+    words_[bit / 64] |= 1ULL << (bit % 64);
+    hash += delta;
+  }
+}
+
+bool BloomFilter::may_contain(uint64_t hash) const
+{
+  if (bit_count_ == 0) {
+    return true;
+  }
+
+  const uint64_t delta = (hash >> 32) | 1;
+  for (int i = 0; i < hash_count_; i++) {
+    const uint64_t bit = hash % bit_count_;
+    if ((words_[bit / 64] & (1ULL << (bit % 64))) == 0) {
+      return false;
+    }
+    hash += delta;
+  }
+  return true;
+}
+
+uint64_t BloomFilter::hash(const char *data, int len)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (int i = 0; i < len; i++) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+}  // namespace common
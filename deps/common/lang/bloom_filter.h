@@ -0,0 +1,56 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+namespace common {
+
+/**
+ * @brief 布隆过滤器
+ * @details 使用一个64位的哈希值，通过双重哈希(h1 + i * h2)得到每个探测位置。
+ * may_contain 返回 false 时一定不存在，返回 true 时可能存在。
+ */
+class BloomFilter
+{
+public:
+  BloomFilter() = default;
+
+  /**
+   * @param expected_items 预计放入的元素个数
+   * @param bits_per_item  每个元素占用的位数，10位时误判率大约是1%
+   */
+  void init(int64_t expected_items, int bits_per_item = 10);
+
+  /**
+   * @brief 使用已经保存下来的位图，比如从文件中读出来的
+   */
+  void init(std::vector<uint64_t> words, int hash_count);
+
+  void add(uint64_t hash);
+  bool may_contain(uint64_t hash) const;
+
+  const std::vector<uint64_t> &words() const { return words_; }
+  int                          hash_count() const { return hash_count_; }
+
+  /**
+   * @brief 计算一段内存的哈希值，FNV-1a 之后再做一次混淆让各个位都分布均匀
+   */
+  static uint64_t hash(const char *data, int len);
+
+private:
+  std::vector<uint64_t> words_;
+  uint64_t              bit_count_  = 0;
+  int                   hash_count_ = 0;
+};
+
+}  // namespace common
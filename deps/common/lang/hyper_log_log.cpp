@@ -0,0 +1,64 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/lang/hyper_log_log.h"
+
+namespace common {
+
+HyperLogLog::HyperLogLog(int precision) : precision_(std::clamp(precision, 4, 18))
+{
+  registers_.assign(1ULL << precision_, 0);
+}
+
+void HyperLogLog::add(uint64_t hash)
+{
+  const uint64_t index = hash >> (64 - precision_);
+  // 最低位补一个1，保证剩下的位全是0时前导零个数也不会超过 64 - precision_
+  const uint64_t rest = (hash << precision_) | (1ULL << (precision_ - 1));
+  const uint8_t  rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+  registers_[index]   = std::max(registers_[index], rank);
+}
+
+void HyperLogLog::merge(const HyperLogLog &other)
+{
+  if (other.precision_ != precision_) {
+    return;
+  }
+  for (size_t i = 0; i < registers_.size(); i++) {
+    registers_[i] = std::max(registers_[i], other.registers_[i]);
+  }
+}
+
+double HyperLogLog::estimate() const
+{
+  const double m     = static_cast<double>(registers_.size());
+  const double alpha = 0.7213 / (1.0 + 1.079 / m);
+
+  double sum   = 0;
+  int    zeros = 0;
+  for (uint8_t r : registers_) {
+    sum += std::ldexp(1.0, -r);
+    if (r == 0) {
+      zeros++;
+    }
+  }
+
+  const double raw = alpha * m * m / sum;
+  // 基数较小时很多寄存器还是0，原始估计偏差很大，改用线性计数
+  if (raw <= 2.5 * m && zeros > 0) {
+    return m * std::log(m / zeros);
+  }
+  return raw;
+}
+
+}  // namespace common
@@ -0,0 +1,46 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+namespace common {
+
+/**
+ * @brief HyperLogLog 基数估计
+ * @details 使用哈希值的高 precision 位选择寄存器，剩下的位中前导零的个数加一作为寄存器的候选值。
+ * 每个寄存器一个字节，precision 为14时占用16KB内存，标准误差大约是 1.04/sqrt(2^14) = 0.8%。
+ * 哈希值可以使用 BloomFilter::hash 计算。
+ */
+class HyperLogLog
+{
+public:
+  explicit HyperLogLog(int precision = 14);
+
+  void add(uint64_t hash);
+
+  /**
+   * @brief 合并另一个精度相同的估计器，结果相当于两边的元素都加入到了当前估计器中
+   */
+  void merge(const HyperLogLog &other);
+
+  /**
+   * @brief 估计加入过的不同元素的个数
+   */
+  double estimate() const;
+
+private:
+  int                  precision_ = 0;
+  std::vector<uint8_t> registers_;
+};
+
+}  // namespace common
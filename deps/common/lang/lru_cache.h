@@ -106,6 +106,11 @@ public:
     return true;
   }
 
+  /**
+   * @brief 只判断是否存在，不调整淘汰顺序
+   */
+  bool contains(const Key &key) const { return searcher_.find((ListNode *)&key) != searcher_.end(); }
+
   void put(const Key &key, const Value &value)
   {
     auto iter = searcher_.find((ListNode *)&key);
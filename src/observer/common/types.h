@@ -14,6 +14,8 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <cstdint>
+
 /// 磁盘文件，包括存放数据的文件和索引(B+-Tree)文件，都按照页来组织
 /// 每一页都有一个编号，称为PageNum
 using PageNum = int32_t;
@@ -24,3 +26,25 @@ using SlotNum = int32_t;
 
 /// LSN for log sequence number
 using LSN = int32_t;
+
+/// 数据文件中记录(行)的存放格式
+/// ROW_FORMAT：定长记录，每个字段都占用定义时的长度，每个页面存放固定个数的记录
+/// VARLEN_FORMAT：变长记录，CHARS 字段只存放实际的长度，页面使用槽位目录(slotted page)组织
+enum class StorageFormat
+{
+  UNKNOWN_FORMAT = 0,
+  ROW_FORMAT,
+  VARLEN_FORMAT,
+};
+
+/// 索引的类型
+/// BPLUS_TREE：B+树，支持范围查询
+/// HASH：可扩展哈希，只支持等值查询，查找时通常只需要访问一个页面
+/// LSM：LSM树，支持范围查询，插入和删除只写内存，适合写入很多的表
+enum class IndexType
+{
+  UNKNOWN_INDEX = 0,
+  BPLUS_TREE,
+  HASH,
+  LSM,
+};
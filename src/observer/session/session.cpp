@@ -24,7 +24,14 @@ Session &Session::default_session()
   return session;
 }
 
-Session::Session(const Session &other) : db_(other.db_) {}
+Session::Session(const Session &other)
+    : db_(other.db_),
+      async_commit_(other.async_commit_),
+      index_fill_factor_(other.index_fill_factor_),
+      index_sort_buffer_size_(other.index_sort_buffer_size_),
+      index_build_threads_(other.index_build_threads_),
+      join_dp_threshold_(other.join_dp_threshold_)
+{}
 
 Session::~Session()
 {
@@ -64,10 +71,19 @@ void Session::set_trx_multi_operation_mode(bool multi_operation_mode)
 
 bool Session::is_trx_multi_operation_mode() const { return trx_multi_operation_mode_; }
 
+void Session::set_async_commit(bool async_commit)
+{
+  async_commit_ = async_commit;
+  if (trx_ != nullptr) {
+    trx_->set_async_commit(async_commit);
+  }
+}
+
 Trx *Session::current_trx()
 {
   if (trx_ == nullptr) {
     trx_ = GCTX.trx_kit_->create_trx(db_->clog_manager());
+    trx_->set_async_commit(async_commit_);
   }
   return trx_;
 }
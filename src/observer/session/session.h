@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <stdint.h>
 #include <string>
 
 class Trx;
@@ -79,6 +80,29 @@ public:
   void set_sql_debug(bool sql_debug) { sql_debug_ = sql_debug; }
   bool sql_debug_on() const { return sql_debug_; }
 
+  /**
+   * @brief 设置当前会话的事务是否异步提交
+   * @details 异步提交不等待日志刷盘，崩溃时可能丢失最近提交的事务。参考 CLogManager
+   */
+  void set_async_commit(bool async_commit);
+  bool async_commit() const { return async_commit_; }
+
+  /**
+   * @brief 创建索引时批量导入数据的参数，参考 IndexBuildOptions
+   */
+  void    set_index_fill_factor(int fill_factor) { index_fill_factor_ = fill_factor; }
+  int     index_fill_factor() const { return index_fill_factor_; }
+  void    set_index_sort_buffer_size(int64_t size) { index_sort_buffer_size_ = size; }
+  int64_t index_sort_buffer_size() const { return index_sort_buffer_size_; }
+  void    set_index_build_threads(int threads) { index_build_threads_ = threads; }
+  int     index_build_threads() const { return index_build_threads_; }
+
+  /**
+   * @brief 连接的表超过这个数量时不再用动态规划枚举连接顺序，改用贪心算法。参考 JoinOrderOptimizer
+   */
+  void set_join_dp_threshold(int threshold) { join_dp_threshold_ = threshold; }
+  int  join_dp_threshold() const { return join_dp_threshold_; }
+
   /**
    * @brief 将指定会话设置到线程变量中
    *
@@ -99,4 +123,12 @@ private:
   bool trx_multi_operation_mode_ = false;  ///< 当前事务的模式，是否多语句模式. 单语句模式自动提交
 
   bool sql_debug_ = false;  ///< 是否输出SQL调试信息
+
+  bool async_commit_ = false;  ///< 事务是否异步提交
+
+  int     index_fill_factor_      = 90;                ///< 创建索引时节点填充的百分比
+  int64_t index_sort_buffer_size_ = 64 * 1024 * 1024;  ///< 创建索引时键值排序使用的内存大小
+  int     index_build_threads_    = 0;                 ///< 创建索引时键值排序使用的线程数，0表示由CPU个数决定
+
+  int join_dp_threshold_ = 10;  ///< 超过这个数量的表连接时使用贪心算法决定连接顺序
 };
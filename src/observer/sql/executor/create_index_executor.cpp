@@ -18,7 +18,9 @@ See the Mulan PSL v2 for more details. */
 #include "event/sql_event.h"
 #include "session/session.h"
 #include "sql/stmt/create_index_stmt.h"
+#include "storage/index/index.h"
 #include "storage/table/table.h"
+#include "storage/trx/trx.h"
 
 RC CreateIndexExecutor::execute(SQLStageEvent *sql_event)
 {
@@ -32,5 +34,22 @@ RC CreateIndexExecutor::execute(SQLStageEvent *sql_event)
 
   Trx   *trx   = session->current_trx();  // 从session对象中获取当前事务
   Table *table = create_index_stmt->table();
-  return table->create_index(trx, create_index_stmt->is_unique(), create_index_stmt->field_metas(), create_index_stmt->index_name().c_str());  //根据Multi-index进行改造， create_index stmt由此进行调用，作为重要的参数传递进去
+
+  IndexBuildOptions options;
+  options.fill_factor      = session->index_fill_factor();
+  options.sort_buffer_size = session->index_sort_buffer_size();
+  options.threads          = session->index_build_threads();
+
+  // 与 SqlResult 一样，不在显式事务中时使用一个新的只读快照遍历数据。
+  // 否则事务号还停留在上一条语句，看不到上一条语句提交的数据
+  const bool auto_commit = !session->is_trx_multi_operation_mode();
+  if (auto_commit) {
+    trx->start_readonly_if_need();
+  }
+
+  RC rc = table->create_index(trx, create_index_stmt->is_unique(), create_index_stmt->field_metas(), create_index_stmt->index_name().c_str(), create_index_stmt->index_type(), options);  //根据Multi-index进行改造， create_index stmt由此进行调用，作为重要的参数传递进去
+  if (auto_commit) {
+    trx->commit();
+  }
+  return rc;
 }
\ No newline at end of file
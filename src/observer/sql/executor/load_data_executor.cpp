@@ -21,6 +21,9 @@ See the Mulan PSL v2 for more details. */
 
 using namespace common;
 
+/// 导入数据时每次批量插入多少条记录
+static constexpr int LOAD_BATCH_SIZE = 1024;
+
 RC LoadDataExecutor::execute(SQLStageEvent *sql_event)
 {
   RC            rc         = RC::SUCCESS;
@@ -33,15 +36,16 @@ RC LoadDataExecutor::execute(SQLStageEvent *sql_event)
 }
 
 /**
- * 从文件中导入数据时使用。尝试向表中插入解析后的一行数据。
+ * 从文件中导入数据时使用。把解析后的一行数据组装成一条记录。
  * @param table  要导入的表
  * @param file_values 从文件中读取到的一行数据，使用分隔符拆分后的几个字段值
- * @param record_values Table::insert_record使用的参数，为了防止频繁的申请内存
+ * @param record_values Table::make_record使用的参数，为了防止频繁的申请内存
+ * @param record 返回组装好的记录
  * @param errmsg 如果出现错误，通过这个参数返回错误信息
  * @return 成功返回RC::SUCCESS
  */
-RC insert_record_from_file(
-    Table *table, std::vector<std::string> &file_values, std::vector<Value> &record_values, std::stringstream &errmsg)
+RC make_record_from_file(Table *table, std::vector<std::string> &file_values, std::vector<Value> &record_values,
+    Record &record, std::stringstream &errmsg)
 {
 
   const int field_num     = record_values.size();
@@ -103,17 +107,51 @@ RC insert_record_from_file(
   }
 
   if (RC::SUCCESS == rc) {
-    Record record;
     rc = table->make_record(field_num, record_values.data(), record);
     if (rc != RC::SUCCESS) {
       errmsg << "insert failed.";
-    } else if (RC::SUCCESS != (rc = table->insert_record(record))) {
-      errmsg << "insert failed.";
     }
   }
   return rc;
 }
 
+/**
+ * 把攒下的一批记录插入表中。整批插入失败时(比如有重复的键值)，整批已经回滚了，
+ * 再逐条插入，找出出错的那一行，出错之前的行依然导入成功
+ * @param line_nums 每条记录在文件中的行号
+ * @param insertion_count 累加成功导入的记录数
+ * @param result_string 出错时记录出错的行
+ */
+RC insert_record_batch(Table *table, std::vector<Record> &records, std::vector<int> &line_nums, int &insertion_count,
+    std::stringstream &result_string)
+{
+  if (records.empty()) {
+    return RC::SUCCESS;
+  }
+
+  const int old_insertion_count = insertion_count;
+
+  RC rc = table->insert_records(records);
+  if (RC::SUCCESS == rc) {
+    insertion_count += static_cast<int>(records.size());
+  } else {
+    for (size_t i = 0; i < records.size(); i++) {
+      rc = table->insert_record(records[i]);
+      if (rc != RC::SUCCESS) {
+        result_string << "Line:" << line_nums[i] << " insert record failed:insert failed.. error:" << strrc(rc)
+                      << std::endl;
+        break;
+      }
+      insertion_count++;
+    }
+  }
+  table->add_modifications(insertion_count - old_insertion_count, 0, 0);
+
+  records.clear();
+  line_nums.clear();
+  return rc;
+}
+
 void LoadDataExecutor::load_data(Table *table, const char *file_name, SqlResult *sql_result)
 {
   std::stringstream result_string;
@@ -139,6 +177,12 @@ void LoadDataExecutor::load_data(Table *table, const char *file_name, SqlResult
   int                      line_num        = 0;
   int                      insertion_count = 0;
   RC                       rc              = RC::SUCCESS;
+
+  // 攒够一批记录之后一起插入，索引可以按键值顺序批量插入，不用每条记录都从根节点查找
+  std::vector<Record> records;
+  std::vector<int>    line_nums;
+  records.reserve(LOAD_BATCH_SIZE);
+  line_nums.reserve(LOAD_BATCH_SIZE);
   while (!fs.eof() && RC::SUCCESS == rc) {
     std::getline(fs, line);
     line_num++;
@@ -149,14 +193,27 @@ void LoadDataExecutor::load_data(Table *table, const char *file_name, SqlResult
     file_values.clear();
     common::split_string(line, delim, file_values);
     std::stringstream errmsg;
-    rc = insert_record_from_file(table, file_values, record_values, errmsg);
+    records.emplace_back();
+    rc = make_record_from_file(table, file_values, record_values, records.back(), errmsg);
     if (rc != RC::SUCCESS) {
-      result_string << "Line:" << line_num << " insert record failed:" << errmsg.str() << ". error:" << strrc(rc)
-                    << std::endl;
-    } else {
-      insertion_count++;
+      // 出错的行之前的数据依然要导入
+      records.pop_back();
+      RC rc2 = insert_record_batch(table, records, line_nums, insertion_count, result_string);
+      if (rc2 == RC::SUCCESS) {
+        result_string << "Line:" << line_num << " insert record failed:" << errmsg.str() << ". error:" << strrc(rc)
+                      << std::endl;
+      }
+      break;
+    }
+
+    line_nums.push_back(line_num);
+    if (static_cast<int>(records.size()) >= LOAD_BATCH_SIZE) {
+      rc = insert_record_batch(table, records, line_nums, insertion_count, result_string);
     }
   }
+  if (RC::SUCCESS == rc) {
+    rc = insert_record_batch(table, records, line_nums, insertion_count, result_string);
+  }
   fs.close();
 
   struct timespec end_time;
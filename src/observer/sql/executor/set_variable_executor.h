@@ -18,11 +18,27 @@ See the Mulan PSL v2 for more details. */
 #include "event/session_event.h"
 #include "event/sql_event.h"
 #include "session/session.h"
+#include "sql/optimizer/join_order_optimizer.h"
 #include "sql/stmt/set_variable_stmt.h"
+#include "storage/clog/clog.h"
+#include "storage/db/db.h"
+#include "storage/db/stats_refresher.h"
 
 /**
  * @brief SetVariable语句执行器
  * @ingroup Executor
+ * @details 当前支持的变量：
+ * - sql_debug: 是否输出SQL调试信息
+ * - async_commit: 当前会话的事务是否异步提交
+ * - global_async_commit: 新建会话默认是否异步提交
+ * - clog_flush_interval_ms: 异步提交时后台刷日志的最大间隔(毫秒)，即崩溃时最多丢失的时间窗口
+ * - clog_flush_size: 异步提交时缓存的日志超过这个大小(字节)就立即刷盘
+ * - stats_refresh_interval_ms: 后台检查统计信息是否过期的间隔(毫秒)
+ * - stats_refresh_ratio: 修改的行数超过表行数的这个百分比时后台重新收集统计信息，0表示关闭
+ * - index_fill_factor: 创建索引时节点填充的百分比，范围 [50, 100]
+ * - index_sort_buffer_size: 创建索引时键值排序使用的内存大小(字节)，超过之后写临时文件
+ * - index_build_threads: 创建索引时键值排序使用的线程数，0表示由CPU个数决定
+ * - join_dp_threshold: 连接的表超过这个数量时使用贪心算法决定连接顺序，范围 [1, 12]
  */
 class SetVariableExecutor
 {
@@ -48,14 +64,118 @@ public:
 
       session->set_sql_debug(bool_value);
       LOG_TRACE("set sql_debug to %d", bool_value);
+    } else if (strcasecmp(var_name, "async_commit") == 0) {
+      bool bool_value = false;
+      rc              = var_value_to_boolean(var_value, bool_value);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+
+      session->set_async_commit(bool_value);
+      LOG_TRACE("set async_commit to %d", bool_value);
+    } else if (strcasecmp(var_name, "global_async_commit") == 0) {
+      bool bool_value = false;
+      rc              = var_value_to_boolean(var_value, bool_value);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+
+      Session::default_session().set_async_commit(bool_value);
+      LOG_INFO("set global async_commit to %d", bool_value);
+    } else if (strcasecmp(var_name, "clog_flush_interval_ms") == 0) {
+      int int_value = 0;
+      rc            = var_value_to_int(var_value, int_value);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+
+      rc = session->get_current_db()->clog_manager()->set_flush_interval_ms(int_value);
+    } else if (strcasecmp(var_name, "clog_flush_size") == 0) {
+      int int_value = 0;
+      rc            = var_value_to_int(var_value, int_value);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+
+      rc = session->get_current_db()->clog_manager()->set_flush_size(int_value);
+    } else if (strcasecmp(var_name, "stats_refresh_interval_ms") == 0) {
+      int int_value = 0;
+      rc            = var_value_to_int(var_value, int_value);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+
+      rc = session->get_current_db()->stats_refresher()->set_interval_ms(int_value);
+    } else if (strcasecmp(var_name, "stats_refresh_ratio") == 0) {
+      int int_value = 0;
+      rc            = var_value_to_int(var_value, int_value);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+
+      rc = session->get_current_db()->stats_refresher()->set_change_ratio(int_value);
+    } else if (strcasecmp(var_name, "index_fill_factor") == 0) {
+      int int_value = 0;
+      rc            = var_value_to_int(var_value, int_value);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      if (int_value < 50 || int_value > 100) {
+        return RC::VARIABLE_NOT_VALID;
+      }
+
+      session->set_index_fill_factor(int_value);
+    } else if (strcasecmp(var_name, "index_sort_buffer_size") == 0) {
+      int int_value = 0;
+      rc            = var_value_to_int(var_value, int_value);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      if (int_value < 64 * 1024) {
+        return RC::VARIABLE_NOT_VALID;
+      }
+
+      session->set_index_sort_buffer_size(int_value);
+    } else if (strcasecmp(var_name, "index_build_threads") == 0) {
+      int int_value = 0;
+      rc            = var_value_to_int(var_value, int_value);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      if (int_value < 0) {
+        return RC::VARIABLE_NOT_VALID;
+      }
+
+      session->set_index_build_threads(int_value);
+    } else if (strcasecmp(var_name, "join_dp_threshold") == 0) {
+      int int_value = 0;
+      rc            = var_value_to_int(var_value, int_value);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      if (int_value < 1 || int_value > JoinOrderOptimizer::MAX_DP_TABLES) {
+        return RC::VARIABLE_NOT_VALID;
+      }
+
+      session->set_join_dp_threshold(int_value);
     } else {
       rc = RC::VARIABLE_NOT_EXISTS;
     }
 
-    return RC::SUCCESS;
+    return rc;
   }
 
 private:
+  RC var_value_to_int(const Value &var_value, int &int_value) const
+  {
+    if (var_value.attr_type() != AttrType::INTS) {
+      return RC::VARIABLE_NOT_VALID;
+    }
+
+    int_value = var_value.get_int();
+    return RC::SUCCESS;
+  }
+
   RC var_value_to_boolean(const Value &var_value, bool &bool_value) const
   {
     RC rc = RC::SUCCESS;
@@ -31,7 +31,11 @@ RC SqlResult::open()
   }
 
   Trx *trx = session_->current_trx();
-  trx->start_if_need();
+  if (readonly_ && !session_->is_trx_multi_operation_mode()) {
+    trx->start_readonly_if_need();
+  } else {
+    trx->start_if_need();
+  }
   return operator_->open(trx);
 }
 
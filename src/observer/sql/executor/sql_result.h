@@ -39,6 +39,7 @@ public:
   void set_tuple_schema(const TupleSchema &schema);
   void set_return_code(RC rc) { return_code_ = rc; }
   void set_state_string(const std::string &state_string) { state_string_ = state_string; }
+  void set_readonly(bool readonly) { readonly_ = readonly; }
 
   void set_operator(std::unique_ptr<PhysicalOperator> oper);
 
@@ -59,4 +60,5 @@ private:
   std::string                       state_string_;
   std::vector<AggreCalc>            aggre_calcs;  ///< 聚合函数的计算
   bool                              is_started{false};
+  bool                              readonly_ = false;  ///< 只读语句，使用只读快照事务执行
 };
@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "sql/expr/expression.h"
 #include "sql/expr/tuple.h"
+#include "sql/operator/logical_operator.h"
 
 using namespace std;
 
@@ -327,4 +328,19 @@ RC ArithmeticExpr::try_get_value(Value &value) const
   }
 
   return calc_value(left_value, right_value, value);
-}
\ No newline at end of file
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+SubqueryExpr::SubqueryExpr(
+    CompOp comp, unique_ptr<Expression> left, unique_ptr<Expression> right, unique_ptr<LogicalOperator> subquery)
+    : comp_(comp), left_(std::move(left)), right_(std::move(right)), subquery_(std::move(subquery))
+{}
+
+SubqueryExpr::~SubqueryExpr() {}
+
+RC SubqueryExpr::get_value(const Tuple &tuple, Value &value) const
+{
+  LOG_WARN("subquery should be rewritten to semi join or anti join before execution");
+  return RC::INTERNAL;
+}
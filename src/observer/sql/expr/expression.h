@@ -22,6 +22,7 @@ See the Mulan PSL v2 for more details. */
 #include "storage/field/field.h"
 
 class Tuple;
+class LogicalOperator;
 
 /**
  * @defgroup Expression
@@ -42,6 +43,7 @@ enum class ExprType
   COMPARISON,   ///< 需要做比较的表达式
   CONJUNCTION,  ///< 多个表达式使用同一种关系(AND或OR)来联结
   ARITHMETIC,   ///< 算术运算
+  SUBQUERY,     ///< IN/EXISTS 子查询
 };
 
 /**
@@ -288,4 +290,38 @@ private:
   Type                        arithmetic_type_;
   std::unique_ptr<Expression> left_;
   std::unique_ptr<Expression> right_;
-};
\ No newline at end of file
+};
+
+/**
+ * @brief IN/NOT IN/EXISTS/NOT EXISTS 子查询
+ * @ingroup Expression
+ * @details 子查询不能逐行计算，SubqueryRewriter 会把它改写成半连接或者反连接。
+ * IN 的左边是外层查询的字段，右边是子查询输出的字段；EXISTS 没有左右两边
+ */
+class SubqueryExpr : public Expression
+{
+public:
+  SubqueryExpr(CompOp comp, std::unique_ptr<Expression> left, std::unique_ptr<Expression> right,
+      std::unique_ptr<LogicalOperator> subquery);
+  virtual ~SubqueryExpr();
+
+  ExprType type() const override { return ExprType::SUBQUERY; }
+  AttrType value_type() const override { return BOOLEANS; }
+
+  /**
+   * @brief 没有改写成连接的子查询不能计算
+   */
+  RC get_value(const Tuple &tuple, Value &value) const override;
+
+  CompOp comp() const { return comp_; }
+
+  std::unique_ptr<Expression>      &left() { return left_; }
+  std::unique_ptr<Expression>      &right() { return right_; }
+  std::unique_ptr<LogicalOperator> &subquery() { return subquery_; }
+
+private:
+  CompOp                           comp_;
+  std::unique_ptr<Expression>      left_;
+  std::unique_ptr<Expression>      right_;
+  std::unique_ptr<LogicalOperator> subquery_;  ///< 子查询的逻辑计划
+};
@@ -137,14 +137,30 @@ public:
   void set_record(Record *record) { this->record_ = record; }
 
   void set_schema(const Table *table, const std::vector<FieldMeta> *fields)
+  {
+    std::vector<const FieldMeta *> field_metas;
+    field_metas.reserve(fields->size());
+    for (const FieldMeta &field : *fields) {
+      field_metas.push_back(&field);
+    }
+    set_schema(table, field_metas);
+  }
+
+  /**
+   * @brief 只包含部分字段的元组，记录中其它字段的数据不会被访问
+   */
+  void set_schema(const Table *table, const std::vector<const FieldMeta *> &fields)
   {
     table_ = table;
     // fix:join当中会多次调用右表的open,open当中会调用set_scheme，从而导致tuple当中会存储
-    // 很多无意义的field和value，因此需要先clear掉
+    // 很多无意义的field和value，因此需要先清理掉
+    for (FieldExpr *spec : speces_) {
+      delete spec;
+    }
     this->speces_.clear();
-    this->speces_.reserve(fields->size());
-    for (const FieldMeta &field : *fields) {
-      speces_.push_back(new FieldExpr(table, &field));
+    this->speces_.reserve(fields.size());
+    for (const FieldMeta *field : fields) {
+      speces_.push_back(new FieldExpr(table, field));
     }
   }
 
@@ -298,6 +314,7 @@ private:
 /**
  * @brief 一些常量值组成的Tuple
  * @ingroup Tuple
+ * @details 设置了每一列对应的字段时，也可以按照字段查找，比如哈希半连接中保存下来的右表的行
  */
 class ValueListTuple : public Tuple
 {
@@ -306,6 +323,7 @@ public:
   virtual ~ValueListTuple() = default;
 
   void set_cells(const std::vector<Value> &cells) { cells_ = cells; }
+  void set_cell_specs(const std::vector<TupleCellSpec> &specs) { specs_ = specs; }
 
   virtual int cell_num() const override { return static_cast<int>(cells_.size()); }
 
@@ -319,10 +337,21 @@ public:
     return RC::SUCCESS;
   }
 
-  virtual RC find_cell(const TupleCellSpec &spec, Value &cell) const override { return RC::INTERNAL; }
+  virtual RC find_cell(const TupleCellSpec &spec, Value &cell) const override
+  {
+    for (size_t i = 0; i < specs_.size() && i < cells_.size(); i++) {
+      if (0 == strcmp(spec.table_name(), specs_[i].table_name()) &&
+          0 == strcmp(spec.field_name(), specs_[i].field_name())) {
+        cell = cells_[i];
+        return RC::SUCCESS;
+      }
+    }
+    return RC::NOTFOUND;
+  }
 
 private:
-  std::vector<Value> cells_;
+  std::vector<Value>         cells_;
+  std::vector<TupleCellSpec> specs_;
 };
 
 /**
@@ -14,22 +14,22 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
-#include "storage/record/record_manager.h"
-#include "sql/operator/physical_operator.h"
-#include "sql/parser/parse.h"
 #include <vector>
 
-class AnalyzeStmt;
-class table;
+#include "sql/operator/physical_operator.h"
+
+class FieldMeta;
+class Table;
 
 /**
- * @brief 插入物理算子
+ * @brief ANALYZE 物理算子
  * @ingroup PhysicalOperator
+ * @details 收集表中若干字段的统计信息并保存下来，参考 Table::analyze
  */
 class AnalyzePhysicalOperator : public PhysicalOperator
 {
 public:
-  AnalyzePhysicalOperator(Table *analyze_table, Table *table, std::vector<Field *> analyze_fields);
+  AnalyzePhysicalOperator(Table *table, std::vector<const FieldMeta *> field_metas);
 
   virtual ~AnalyzePhysicalOperator() = default;
 
@@ -42,10 +42,6 @@ public:
   Tuple *current_tuple() override { return nullptr; }
 
 private:
-  Table                          *analyze_table_ = nullptr;
-  Table                          *table_         = nullptr;
-  std::vector<Field *>            analyze_fields_;
-  Trx                            *trx_ = nullptr;
-  std::vector<std::vector<Value>> data_matrix_;
-  std::vector<FieldMeta>          analyze_field_metas_;  // 全部使用的FieldMetas
+  Table                         *table_ = nullptr;
+  std::vector<const FieldMeta *> field_metas_;
 };
@@ -0,0 +1,269 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/operator/bitmap_heap_scan_physical_operator.h"
+#include "storage/index/index.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+BitmapHeapScanPhysicalOperator::BitmapHeapScanPhysicalOperator(Table *table, bool readonly, Combine combine)
+    : table_(table), readonly_(readonly), combine_(combine)
+{}
+
+void BitmapHeapScanPhysicalOperator::add_index_condition(
+    Index *index, const Value *left_value, bool left_inclusive, const Value *right_value, bool right_inclusive)
+{
+  const char    *field_name = index->index_meta().field();
+  const AttrType field_type = table_->table_meta().field(field_name)->type();
+
+  IndexCondition condition;
+  condition.index           = index;
+  condition.left_inclusive  = left_inclusive;
+  condition.right_inclusive = right_inclusive;
+  if (left_value) {
+    condition.has_left   = true;
+    condition.left_value = *left_value;
+    Value::convert(condition.left_value.attr_type(), field_type, condition.left_value);
+  }
+  if (right_value) {
+    condition.has_right   = true;
+    condition.right_value = *right_value;
+    Value::convert(condition.right_value.attr_type(), field_type, condition.right_value);
+  }
+  conditions_.push_back(std::move(condition));
+}
+
+RC BitmapHeapScanPhysicalOperator::open(Trx *trx)
+{
+  if (nullptr == table_ || conditions_.empty()) {
+    return RC::INTERNAL;
+  }
+
+  record_handler_ = table_->record_handler();
+  if (nullptr == record_handler_) {
+    LOG_WARN("invalid record handler");
+    return RC::INTERNAL;
+  }
+
+  RC rc = RC::SUCCESS;
+  bitmap_.clear();
+  for (size_t i = 0; i < conditions_.size(); i++) {
+    RidBitmap bitmap;
+    rc = collect_rids(conditions_[i], bitmap);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    if (i == 0) {
+      bitmap_ = std::move(bitmap);
+    } else if (combine_ == Combine::AND) {
+      bitmap_.intersect_with(bitmap);
+    } else {
+      bitmap_.union_with(bitmap);
+    }
+
+    // 交集已经是空的，后面的索引不用再看了
+    if (combine_ == Combine::AND && bitmap_.empty()) {
+      break;
+    }
+  }
+  LOG_TRACE("bitmap heap scan collected rids. table=%s, rids=%d, pages=%d",
+      table_->name(), static_cast<int>(bitmap_.size()), static_cast<int>(bitmap_.page_count()));
+
+  page_iter_        = bitmap_.pages().begin();
+  prefetch_iter_    = page_iter_;
+  prefetched_ahead_ = 0;
+  slot_nums_.clear();
+  slot_index_ = 0;
+  if (page_iter_ != bitmap_.pages().end()) {
+    RidBitmap::collect_slots(page_iter_->second, slot_nums_);
+    prefetch();
+  }
+
+  if (has_output_fields_) {
+    tuple_.set_schema(table_, output_fields_);
+  } else {
+    tuple_.set_schema(table_, table_->table_meta().field_metas());
+  }
+
+  trx_ = trx;
+  return RC::SUCCESS;
+}
+
+RC BitmapHeapScanPhysicalOperator::collect_rids(const IndexCondition &condition, RidBitmap &bitmap)
+{
+  IndexScanner *index_scanner = condition.index->create_scanner(
+      condition.has_left ? condition.left_value.data() : nullptr,
+      condition.has_left ? condition.left_value.length() : 0,
+      condition.left_inclusive,
+      condition.has_right ? condition.right_value.data() : nullptr,
+      condition.has_right ? condition.right_value.length() : 0,
+      condition.right_inclusive);
+  if (nullptr == index_scanner) {
+    LOG_WARN("failed to create index scanner. index=%s", condition.index->index_meta().name());
+    return RC::INTERNAL;
+  }
+
+  RC  rc = RC::SUCCESS;
+  RID rid;
+  while (OB_SUCC(rc = index_scanner->next_entry(&rid))) {
+    bitmap.add(rid);
+  }
+  index_scanner->destroy();
+
+  if (rc != RC::RECORD_EOF) {
+    LOG_WARN("failed to scan index. index=%s, rc=%s", condition.index->index_meta().name(), strrc(rc));
+    return rc;
+  }
+  return RC::SUCCESS;
+}
+
+RC BitmapHeapScanPhysicalOperator::next()
+{
+  RID rid;
+  RC  rc = RC::SUCCESS;
+
+  // 不跨越 next 持有页面，上层算子可能要修改同一个页面上的记录
+  record_page_handler_.cleanup();
+
+  bool filter_result = false;
+  while (RC::SUCCESS == (rc = next_rid(rid))) {
+    rc = record_handler_->get_record_if_exists(record_page_handler_, &rid, readonly_, &current_record_);
+    if (rc == RC::RECORD_NOT_EXIST) {
+      // 删除记录时不会删除索引项，索引中可能还留着已经删除的记录
+      continue;
+    }
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
+    if (!RuntimeFilter::match_all(runtime_filters_, current_record_)) {
+      continue;
+    }
+
+    // 索引只用来缩小范围，所有的条件都要重新检查
+    tuple_.set_record(&current_record_);
+    rc = filter(tuple_, filter_result);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
+    if (!filter_result) {
+      continue;
+    }
+
+    rc = trx_->visit_record(table_, current_record_, readonly_);
+    if (rc == RC::RECORD_INVISIBLE) {
+      continue;
+    } else {
+      return rc;
+    }
+  }
+
+  return rc;
+}
+
+RC BitmapHeapScanPhysicalOperator::next_rid(RID &rid)
+{
+  const RidBitmap::PageMap &pages = bitmap_.pages();
+  while (page_iter_ != pages.end() && slot_index_ >= slot_nums_.size()) {
+    ++page_iter_;
+    if (prefetched_ahead_ > 0) {
+      prefetched_ahead_--;
+    } else {
+      prefetch_iter_ = page_iter_;
+    }
+
+    slot_index_ = 0;
+    slot_nums_.clear();
+    if (page_iter_ != pages.end()) {
+      RidBitmap::collect_slots(page_iter_->second, slot_nums_);
+      prefetch();
+    }
+  }
+
+  if (page_iter_ == pages.end()) {
+    return RC::RECORD_EOF;
+  }
+
+  rid.page_num = page_iter_->first;
+  rid.slot_num = slot_nums_[slot_index_++];
+  return RC::SUCCESS;
+}
+
+void BitmapHeapScanPhysicalOperator::prefetch()
+{
+  if (prefetched_ahead_ > PREFETCH_PAGE_COUNT / 2) {
+    return;
+  }
+
+  // 页号是有序的，DiskBufferPool 会把相邻的页面合并成一次预读
+  std::vector<PageNum> page_nums;
+  while (prefetch_iter_ != bitmap_.pages().end() && prefetched_ahead_ < PREFETCH_PAGE_COUNT) {
+    page_nums.push_back(prefetch_iter_->first);
+    ++prefetch_iter_;
+    prefetched_ahead_++;
+  }
+  if (!page_nums.empty()) {
+    record_handler_->prefetch_pages(std::move(page_nums));
+  }
+}
+
+RC BitmapHeapScanPhysicalOperator::close()
+{
+  record_page_handler_.cleanup();
+  bitmap_.clear();
+  slot_nums_.clear();
+  return RC::SUCCESS;
+}
+
+Tuple *BitmapHeapScanPhysicalOperator::current_tuple()
+{
+  tuple_.set_record(&current_record_);
+  return &tuple_;
+}
+
+void BitmapHeapScanPhysicalOperator::set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs)
+{
+  predicates_ = std::move(exprs);
+}
+
+RC BitmapHeapScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
+{
+  RC    rc = RC::SUCCESS;
+  Value value;
+  for (std::unique_ptr<Expression> &expr : predicates_) {
+    rc = expr->get_value(tuple, value);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
+    bool tmp_result = value.get_boolean();
+    if (!tmp_result) {
+      result = false;
+      return rc;
+    }
+  }
+
+  result = true;
+  return rc;
+}
+
+std::string BitmapHeapScanPhysicalOperator::param() const
+{
+  std::string result;
+  for (const IndexCondition &condition : conditions_) {
+    if (!result.empty()) {
+      result += combine_ == Combine::AND ? " AND " : " OR ";
+    }
+    result += condition.index->index_meta().name();
+  }
+  return result + " ON " + table_->name();
+}
@@ -0,0 +1,136 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/expr/tuple.h"
+#include "sql/operator/physical_operator.h"
+#include "sql/operator/runtime_filter.h"
+#include "sql/parser/value.h"
+#include "storage/record/record_manager.h"
+#include "storage/record/rid_bitmap.h"
+
+class Index;
+
+/**
+ * @brief 位图堆扫描物理算子
+ * @ingroup PhysicalOperator
+ * @details 先从一个或多个索引中取出所有满足条件的RID，放到按页号排序的位图中，多个索引的结果
+ * 按照AND或OR合并。然后按照页号从小到大访问数据页面，每个页面只读取一次。
+ * 与 IndexScanPhysicalOperator 相比，结果不再按照索引键值排序，但是匹配的记录很多时，
+ * 不会按照索引顺序反复随机访问同样的数据页面。
+ */
+class BitmapHeapScanPhysicalOperator : public PhysicalOperator
+{
+public:
+  /// 多个索引条件之间的关系
+  enum class Combine
+  {
+    AND,
+    OR,
+  };
+
+  /// 每次对接下来多少个数据页面发起预读
+  static constexpr int PREFETCH_PAGE_COUNT = 32;
+
+public:
+  BitmapHeapScanPhysicalOperator(Table *table, bool readonly, Combine combine = Combine::AND);
+
+  virtual ~BitmapHeapScanPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override { return PhysicalOperatorType::BITMAP_HEAP_SCAN; }
+
+  Table *table() const { return table_; }
+
+  std::string param() const override;
+
+  /**
+   * @brief 增加一个索引扫描条件
+   * @details 没有左边界或右边界时对应的值传 nullptr。值会被转换成索引字段的类型
+   */
+  void add_index_condition(Index *index, const Value *left_value, bool left_inclusive, const Value *right_value,
+      bool right_inclusive);
+
+  RC open(Trx *trx) override;
+  RC next() override;
+  RC close() override;
+
+  Tuple *current_tuple() override;
+
+  void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
+
+  /**
+   * @brief 连接算子生成的运行时过滤器，拿到记录之后先用它过滤
+   */
+  void add_runtime_filter(RuntimeFilter *filter) { runtime_filters_.push_back(filter); }
+
+  /**
+   * @brief 设置输出的元组包含哪些字段，没有设置时包含表的所有字段
+   */
+  void set_output_fields(std::vector<const FieldMeta *> fields)
+  {
+    output_fields_     = std::move(fields);
+    has_output_fields_ = true;
+  }
+
+private:
+  struct IndexCondition
+  {
+    Index *index = nullptr;
+    Value  left_value;
+    Value  right_value;
+    bool   has_left        = false;
+    bool   has_right       = false;
+    bool   left_inclusive  = false;
+    bool   right_inclusive = false;
+  };
+
+  /**
+   * @brief 把一个索引条件匹配的RID全部取出来放到 bitmap 中
+   */
+  RC collect_rids(const IndexCondition &condition, RidBitmap &bitmap);
+
+  /**
+   * @brief 返回下一个RID，按照页号和槽位号从小到大的顺序
+   */
+  RC next_rid(RID &rid);
+
+  /**
+   * @brief 当前访问的页面快要追上已经预读的页面时，对后面的页面发起预读
+   */
+  void prefetch();
+
+  RC filter(RowTuple &tuple, bool &result);
+
+private:
+  Trx               *trx_            = nullptr;
+  Table             *table_          = nullptr;
+  bool               readonly_       = false;
+  Combine            combine_        = Combine::AND;
+  RecordFileHandler *record_handler_ = nullptr;
+
+  std::vector<IndexCondition> conditions_;
+
+  RidBitmap                          bitmap_;
+  RidBitmap::PageMap::const_iterator page_iter_;             ///< 当前访问的页面
+  RidBitmap::PageMap::const_iterator prefetch_iter_;         ///< 第一个还没有预读的页面
+  int                                prefetched_ahead_ = 0;  ///< 当前页面之后已经预读了多少个页面
+  std::vector<SlotNum>               slot_nums_;             ///< 当前页面上要访问的槽位
+  size_t                             slot_index_ = 0;
+
+  RecordPageHandler record_page_handler_;
+  Record            current_record_;
+  RowTuple          tuple_;
+  std::vector<const FieldMeta *> output_fields_;
+  bool                           has_output_fields_ = false;
+  std::vector<RuntimeFilter *>   runtime_filters_;
+
+  std::vector<std::unique_ptr<Expression>> predicates_;
+};
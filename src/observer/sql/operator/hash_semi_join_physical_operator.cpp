@@ -0,0 +1,238 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+
+#include "sql/operator/hash_semi_join_physical_operator.h"
+#include "common/log/log.h"
+#include "event/sql_debug.h"
+
+using namespace std;
+
+namespace {
+
+string key_name(const Expression &expr)
+{
+  if (expr.type() == ExprType::FIELD) {
+    const auto &field_expr = static_cast<const FieldExpr &>(expr);
+    return string(field_expr.table_name()) + "." + field_expr.field_name();
+  }
+  return expr.name();
+}
+
+}  // namespace
+
+void HashSemiJoinPhysicalOperator::add_key(unique_ptr<Expression> probe_key, unique_ptr<Expression> build_key)
+{
+  probe_keys_.push_back(std::move(probe_key));
+  build_keys_.push_back(std::move(build_key));
+}
+
+void HashSemiJoinPhysicalOperator::add_condition(unique_ptr<Expression> condition, const vector<Field> &build_fields)
+{
+  conditions_.push_back(std::move(condition));
+  for (const Field &field : build_fields) {
+    bool found = false;
+    for (const TupleCellSpec &spec : build_specs_) {
+      if (0 == strcmp(spec.table_name(), field.table_name()) && 0 == strcmp(spec.field_name(), field.field_name())) {
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      build_specs_.emplace_back(field.table_name(), field.field_name());
+    }
+  }
+}
+
+RC HashSemiJoinPhysicalOperator::open(Trx *trx)
+{
+  if (children_.size() != 2) {
+    LOG_WARN("semi join operator should have 2 children");
+    return RC::INTERNAL;
+  }
+
+  RC rc       = RC::SUCCESS;
+  left_       = children_[0].get();
+  left_tuple_ = nullptr;
+
+  if (!hash_table_built_) {
+    rc = build(trx);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to build hash table of semi join. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  return left_->open(trx);
+}
+
+RC HashSemiJoinPhysicalOperator::build(Trx *trx)
+{
+  PhysicalOperator *right = children_[1].get();
+
+  RC rc = right->open(trx);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open right oper. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  build_tuple_.set_cell_specs(build_specs_);
+
+  int64_t build_rows = 0;
+  string  key;
+  while (OB_SUCC(rc = right->next())) {
+    Tuple *tuple = right->current_tuple();
+    rc           = make_key(build_keys_, *tuple, key);
+    if (OB_FAIL(rc)) {
+      break;
+    }
+
+    vector<vector<Value>> &rows = hash_table_[key];
+    if (conditions_.empty()) {
+      if (rows.empty()) {
+        rows.emplace_back();
+      }
+    } else {
+      vector<Value> row(build_specs_.size());
+      for (size_t i = 0; i < build_specs_.size() && OB_SUCC(rc); i++) {
+        rc = tuple->find_cell(build_specs_[i], row[i]);
+      }
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to get field of right tuple. rc=%s", strrc(rc));
+        break;
+      }
+      rows.push_back(std::move(row));
+    }
+    build_rows++;
+  }
+
+  RC close_rc = right->close();
+  if (rc == RC::RECORD_EOF) {
+    rc = close_rc;
+  }
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  hash_table_built_ = true;
+  sql_debug("%s hash table: %d rows, %d keys",
+            name().c_str(), static_cast<int>(build_rows), static_cast<int>(hash_table_.size()));
+  return rc;
+}
+
+RC HashSemiJoinPhysicalOperator::make_key(
+    const vector<unique_ptr<Expression>> &keys, const Tuple &tuple, string &key) const
+{
+  key.clear();
+  for (const unique_ptr<Expression> &expr : keys) {
+    Value value;
+    RC    rc = expr->get_value(tuple, value);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get value of join key. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    // 字符串的长度不固定，前面加上长度，避免不同的几个值拼出同一个键
+    const int length = value.length();
+    key.append(reinterpret_cast<const char *>(&length), sizeof(length));
+    key.append(value.data(), length);
+  }
+  return RC::SUCCESS;
+}
+
+RC HashSemiJoinPhysicalOperator::match(const Tuple &tuple, bool &matched)
+{
+  matched = false;
+
+  RC rc = make_key(probe_keys_, tuple, probe_key_);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  auto iter = hash_table_.find(probe_key_);
+  if (iter == hash_table_.end()) {
+    return rc;
+  }
+  if (conditions_.empty()) {
+    matched = true;
+    return rc;
+  }
+
+  // 右边的行放在前面，两边有同名的字段时条件中的右边字段取右边的值
+  joined_tuple_.set_left(&build_tuple_);
+  joined_tuple_.set_right(left_tuple_);
+  for (const vector<Value> &row : iter->second) {
+    build_tuple_.set_cells(row);
+
+    bool all_true = true;
+    for (const unique_ptr<Expression> &condition : conditions_) {
+      Value value;
+      rc = condition->get_value(joined_tuple_, value);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to evaluate join condition. rc=%s", strrc(rc));
+        return rc;
+      }
+      if (!value.get_boolean()) {
+        all_true = false;
+        break;
+      }
+    }
+
+    if (all_true) {
+      matched = true;
+      break;
+    }
+  }
+  return rc;
+}
+
+RC HashSemiJoinPhysicalOperator::next()
+{
+  RC rc = RC::SUCCESS;
+  while (OB_SUCC(rc = left_->next())) {
+    left_tuple_ = left_->current_tuple();
+
+    bool matched = false;
+    rc           = match(*left_tuple_, matched);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    if (matched != anti_) {
+      return rc;
+    }
+  }
+  return rc;
+}
+
+RC HashSemiJoinPhysicalOperator::close()
+{
+  RC rc = left_->close();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to close left oper. rc=%s", strrc(rc));
+  }
+  return rc;
+}
+
+Tuple *HashSemiJoinPhysicalOperator::current_tuple() { return left_tuple_; }
+
+string HashSemiJoinPhysicalOperator::param() const
+{
+  string param;
+  for (size_t i = 0; i < probe_keys_.size(); i++) {
+    param += param.empty() ? "" : ", ";
+    param += key_name(*probe_keys_[i]) + "=" + key_name(*build_keys_[i]);
+  }
+  if (!conditions_.empty()) {
+    param += param.empty() ? "" : ", ";
+    param += to_string(conditions_.size()) + " other conditions";
+  }
+  return param;
+}
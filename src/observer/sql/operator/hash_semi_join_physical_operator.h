@@ -0,0 +1,85 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sql/expr/expression.h"
+#include "sql/expr/tuple.h"
+#include "sql/operator/physical_operator.h"
+
+/**
+ * @brief 哈希半连接和反连接
+ * @ingroup PhysicalOperator
+ * @details 第一次打开时遍历右边(子查询)，用等值连接条件中右边的字段建立哈希表。
+ * 左边的每一行到哈希表中查找，半连接输出找到了匹配的行，反连接输出找不到的行，都只输出左边的数据。
+ *
+ * 只有两边类型相同的 INTS/DATES/CHARS 字段之间的等值条件用哈希表处理，按照字节比较。
+ * 其它的连接条件在哈希表中找到的每一个候选行上计算，这时右边的行需要保存这些条件用到的字段。
+ * 没有等值条件时所有的行都在同一个桶中。
+ */
+class HashSemiJoinPhysicalOperator : public PhysicalOperator
+{
+public:
+  HashSemiJoinPhysicalOperator(bool anti) : anti_(anti) {}
+  virtual ~HashSemiJoinPhysicalOperator() = default;
+
+  PhysicalOperatorType type() const override
+  {
+    return anti_ ? PhysicalOperatorType::HASH_ANTI_JOIN : PhysicalOperatorType::HASH_SEMI_JOIN;
+  }
+
+  std::string param() const override;
+
+  /**
+   * @brief 添加一个等值连接条件
+   * @param probe_key 在左边的行上计算
+   * @param build_key 在右边的行上计算
+   */
+  void add_key(std::unique_ptr<Expression> probe_key, std::unique_ptr<Expression> build_key);
+
+  /**
+   * @brief 添加一个不能用哈希表处理的连接条件
+   * @param build_fields 条件中用到的右边的字段
+   */
+  void add_condition(std::unique_ptr<Expression> condition, const std::vector<Field> &build_fields);
+
+  RC     open(Trx *trx) override;
+  RC     next() override;
+  RC     close() override;
+  Tuple *current_tuple() override;
+
+private:
+  RC build(Trx *trx);
+  RC make_key(const std::vector<std::unique_ptr<Expression>> &keys, const Tuple &tuple, std::string &key) const;
+  RC match(const Tuple &tuple, bool &matched);
+
+private:
+  bool anti_ = false;
+
+  std::vector<std::unique_ptr<Expression>> probe_keys_;
+  std::vector<std::unique_ptr<Expression>> build_keys_;
+  std::vector<std::unique_ptr<Expression>> conditions_;
+  std::vector<TupleCellSpec>               build_specs_;  ///< 右边的行保存的字段，conditions_ 中会用到
+
+  /// 连接键编码之后的值 -> 右边的行。没有其它连接条件时只需要知道有没有匹配的行，每个键只保存一个空行
+  std::unordered_map<std::string, std::vector<std::vector<Value>>> hash_table_;
+
+  bool hash_table_built_ = false;  ///< 右边的数据在执行期间不变，只建立一次
+
+  PhysicalOperator *left_       = nullptr;
+  Tuple            *left_tuple_ = nullptr;
+  ValueListTuple    build_tuple_;   ///< 计算 conditions_ 时当前的右边的行
+  JoinedTuple       joined_tuple_;  ///< 计算 conditions_ 时左右两边的行
+  std::string       probe_key_;
+};
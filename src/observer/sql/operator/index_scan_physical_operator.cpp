@@ -45,12 +45,16 @@ RC IndexScanPhysicalOperator::open(Trx *trx)
     return RC::INTERNAL;
   }
 
-  IndexScanner *index_scanner = index_->create_scanner(left_value_.data(),
-      left_value_.length(),
+  // 没有给出的边界值类型是 UNDEFINED，表示这一边不限制
+  const bool    has_left      = left_value_.attr_type() != UNDEFINED;
+  const bool    has_right     = right_value_.attr_type() != UNDEFINED;
+  IndexScanner *index_scanner = index_->create_scanner(has_left ? left_value_.data() : nullptr,
+      has_left ? left_value_.length() : 0,
       left_inclusive_,
-      right_value_.data(),
-      right_value_.length(),
-      right_inclusive_);
+      has_right ? right_value_.data() : nullptr,
+      has_right ? right_value_.length() : 0,
+      right_inclusive_,
+      reverse_);
   if (nullptr == index_scanner) {
     LOG_WARN("failed to create index scanner");
     return RC::INTERNAL;
@@ -63,8 +67,14 @@ RC IndexScanPhysicalOperator::open(Trx *trx)
     return RC::INTERNAL;
   }
   index_scanner_ = index_scanner;
+  rids_.clear();
+  rid_index_ = 0;
 
-  tuple_.set_schema(table_, table_->table_meta().field_metas());
+  if (has_output_fields_) {
+    tuple_.set_schema(table_, output_fields_);
+  } else {
+    tuple_.set_schema(table_, table_->table_meta().field_metas());
+  }
 
   trx_ = trx;
   return RC::SUCCESS;
@@ -78,12 +88,20 @@ RC IndexScanPhysicalOperator::next()
   record_page_handler_.cleanup();
 
   bool filter_result = false;
-  while (RC::SUCCESS == (rc = index_scanner_->next_entry(&rid))) {
-    rc = record_handler_->get_record(record_page_handler_, &rid, readonly_, &current_record_);
+  while (RC::SUCCESS == (rc = next_rid(rid))) {
+    rc = record_handler_->get_record_if_exists(record_page_handler_, &rid, readonly_, &current_record_);
+    if (rc == RC::RECORD_NOT_EXIST) {
+      // 删除记录时不会删除索引项，索引中可能还留着已经删除的记录
+      continue;
+    }
     if (rc != RC::SUCCESS) {
       return rc;
     }
 
+    if (!RuntimeFilter::match_all(runtime_filters_, current_record_)) {
+      continue;
+    }
+
     tuple_.set_record(&current_record_);
     rc = filter(tuple_, filter_result);
     if (rc != RC::SUCCESS) {
@@ -105,6 +123,36 @@ RC IndexScanPhysicalOperator::next()
   return rc;
 }
 
+RC IndexScanPhysicalOperator::next_rid(RID &rid)
+{
+  if (rid_index_ >= rids_.size()) {
+    rids_.clear();
+    rid_index_ = 0;
+
+    RC  rc = RC::SUCCESS;
+    RID next;
+    while (rids_.size() < PREFETCH_RID_COUNT && RC::SUCCESS == (rc = index_scanner_->next_entry(&next))) {
+      rids_.push_back(next);
+    }
+    if (rc != RC::SUCCESS && rc != RC::RECORD_EOF) {
+      return rc;
+    }
+    if (rids_.empty()) {
+      return RC::RECORD_EOF;
+    }
+
+    std::vector<PageNum> page_nums;
+    page_nums.reserve(rids_.size());
+    for (const RID &item : rids_) {
+      page_nums.push_back(item.page_num);
+    }
+    record_handler_->prefetch_pages(std::move(page_nums));
+  }
+
+  rid = rids_[rid_index_++];
+  return RC::SUCCESS;
+}
+
 RC IndexScanPhysicalOperator::close()
 {
   index_scanner_->destroy();
@@ -146,5 +194,5 @@ RC IndexScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
 
 std::string IndexScanPhysicalOperator::param() const
 {
-  return std::string(index_->index_meta().name()) + " ON " + table_->name();
+  return std::string(index_->index_meta().name()) + " ON " + table_->name() + (reverse_ ? " DESC" : "");
 }
@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "sql/expr/tuple.h"
 #include "sql/operator/physical_operator.h"
+#include "sql/operator/runtime_filter.h"
 #include "storage/record/record_manager.h"
 #include "sql/parser/value.h"
 
@@ -33,6 +34,15 @@ public:
 
   PhysicalOperatorType type() const override { return PhysicalOperatorType::INDEX_SCAN; }
 
+  Table *table() const { return table_; }
+  Index *index() const { return index_; }
+
+  /**
+   * @brief 按照索引的倒序输出，只有 B+ 树索引支持
+   */
+  void set_reverse(bool reverse) { reverse_ = reverse; }
+  bool reverse() const { return reverse_; }
+
   std::string param() const override;
 
   RC open(Trx *trx) override;
@@ -43,7 +53,30 @@ public:
 
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 连接算子生成的运行时过滤器，拿到记录之后先用它过滤
+   */
+  void add_runtime_filter(RuntimeFilter *filter) { runtime_filters_.push_back(filter); }
+
+  /**
+   * @brief 设置输出的元组包含哪些字段，没有设置时包含表的所有字段
+   */
+  void set_output_fields(std::vector<const FieldMeta *> fields)
+  {
+    output_fields_     = std::move(fields);
+    has_output_fields_ = true;
+  }
+
 private:
+  /// 每次从索引中预先取出多少个RID，取出之后对它们所在的数据页面发起预读
+  static constexpr size_t PREFETCH_RID_COUNT = 64;
+
+  /**
+   * @brief 返回下一个RID
+   * @details 从索引中成批地取出RID，按照索引的顺序依次返回，同时让操作系统提前读取这一批记录所在的页面
+   */
+  RC next_rid(RID &rid);
+
   // 与TableScanPhysicalOperator代码相同，可以优化
   RC filter(RowTuple &tuple, bool &result);
 
@@ -55,14 +88,21 @@ private:
   IndexScanner      *index_scanner_  = nullptr;
   RecordFileHandler *record_handler_ = nullptr;
 
+  std::vector<RID> rids_;         ///< 从索引中预先取出的RID
+  size_t           rid_index_ = 0;  ///< 下一个要返回的 rids_ 下标
+
   RecordPageHandler record_page_handler_;
   Record            current_record_;
   RowTuple          tuple_;
+  std::vector<const FieldMeta *> output_fields_;
+  bool                           has_output_fields_ = false;
+  std::vector<RuntimeFilter *>   runtime_filters_;
 
   Value left_value_;
   Value right_value_;
   bool  left_inclusive_  = false;
   bool  right_inclusive_ = false;
+  bool  reverse_         = false;
 
   AttrType field_type_;
 
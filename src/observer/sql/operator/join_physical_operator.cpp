@@ -12,7 +12,10 @@ See the Mulan PSL v2 for more details. */
 // Created by WangYunlai on 2022/12/30.
 //
 
+#include <inttypes.h>
+
 #include "sql/operator/join_physical_operator.h"
+#include "event/sql_debug.h"
 
 NestedLoopJoinPhysicalOperator::NestedLoopJoinPhysicalOperator() {}
 
@@ -28,9 +31,53 @@ RC NestedLoopJoinPhysicalOperator::open(Trx *trx)
   right_        = children_[1].get();
   right_closed_ = true;
   round_done_   = true;
+  trx_          = trx;
+
+  if (!runtime_filters_.empty() && !runtime_filters_built_) {
+    rc = build_runtime_filters();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to build runtime filters. rc=%s", strrc(rc));
+      return rc;
+    }
+  }
+
+  rc = left_->open(trx);
+  return rc;
+}
+
+RC NestedLoopJoinPhysicalOperator::build_runtime_filters()
+{
+  RC rc = right_->open(trx_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open right oper. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  while (OB_SUCC(rc = right_->next())) {
+    Tuple *tuple = right_->current_tuple();
+    for (std::unique_ptr<RuntimeFilter> &filter : runtime_filters_) {
+      rc = filter->add(*tuple);
+      if (OB_FAIL(rc)) {
+        break;
+      }
+    }
+    if (OB_FAIL(rc)) {
+      break;
+    }
+  }
+
+  RC close_rc = right_->close();
+  if (rc == RC::RECORD_EOF) {
+    rc = close_rc;
+  }
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
 
-  rc   = left_->open(trx);
-  trx_ = trx;
+  for (std::unique_ptr<RuntimeFilter> &filter : runtime_filters_) {
+    filter->finish();
+  }
+  runtime_filters_built_ = true;
   return rc;
 }
 
@@ -66,6 +113,11 @@ RC NestedLoopJoinPhysicalOperator::next()
 
 RC NestedLoopJoinPhysicalOperator::close()
 {
+  for (std::unique_ptr<RuntimeFilter> &filter : runtime_filters_) {
+    sql_debug("runtime filter %s filtered %" PRId64 " of %" PRId64 " rows",
+              filter->to_string().c_str(), filter->filtered_rows(), filter->checked_rows());
+  }
+
   RC rc = left_->close();
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to close left oper. rc=%s", strrc(rc));
@@ -84,6 +136,16 @@ RC NestedLoopJoinPhysicalOperator::close()
 
 Tuple *NestedLoopJoinPhysicalOperator::current_tuple() { return &joined_tuple_; }
 
+std::string NestedLoopJoinPhysicalOperator::param() const
+{
+  std::string param;
+  for (const std::unique_ptr<RuntimeFilter> &filter : runtime_filters_) {
+    param += param.empty() ? "RUNTIME FILTER " : ", ";
+    param += filter->to_string();
+  }
+  return param;
+}
+
 RC NestedLoopJoinPhysicalOperator::left_next()
 {
   RC rc = RC::SUCCESS;
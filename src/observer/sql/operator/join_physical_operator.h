@@ -15,11 +15,13 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "sql/operator/physical_operator.h"
+#include "sql/operator/runtime_filter.h"
 #include "sql/parser/parse.h"
 
 /**
  * @brief 最简单的两表（称为左表、右表）join算子
- * @details 依次遍历左表的每一行，然后关联右表的每一行
+ * @details 依次遍历左表的每一行，然后关联右表的每一行。
+ * 有运行时过滤器时，第一次打开前先遍历一遍右表生成过滤器，左边的扫描算子用它提前过滤掉不可能匹配的记录
  * @ingroup PhysicalOperator
  */
 class NestedLoopJoinPhysicalOperator : public PhysicalOperator
@@ -30,6 +32,13 @@ public:
 
   PhysicalOperatorType type() const override { return PhysicalOperatorType::NESTED_LOOP_JOIN; }
 
+  std::string param() const override;
+
+  /**
+   * @brief 添加一个由右表生成的运行时过滤器，左边的扫描算子已经引用了它
+   */
+  void add_runtime_filter(std::unique_ptr<RuntimeFilter> filter) { runtime_filters_.push_back(std::move(filter)); }
+
   RC     open(Trx *trx) override;
   RC     next() override;
   RC     close() override;
@@ -38,6 +47,7 @@ public:
 private:
   RC left_next();   //! 左表遍历下一条数据
   RC right_next();  //! 右表遍历下一条数据，如果上一轮结束了就重新开始新的一轮
+  RC build_runtime_filters();
 
 private:
   Trx *trx_ = nullptr;
@@ -50,4 +60,7 @@ private:
   JoinedTuple       joined_tuple_;         //! 当前关联的左右两个tuple
   bool              round_done_   = true;  //! 右表遍历的一轮是否结束
   bool              right_closed_ = true;  //! 右表算子是否已经关闭
+
+  std::vector<std::unique_ptr<RuntimeFilter>> runtime_filters_;
+  bool                                        runtime_filters_built_ = false;  //! 右表的数据在执行期间不变，只生成一次
 };
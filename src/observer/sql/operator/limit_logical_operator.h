@@ -0,0 +1,34 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+#pragma once
+
+#include "sql/operator/logical_operator.h"
+
+/**
+ * @brief 只输出下层算子的一部分行
+ * @ingroup LogicalOperator
+ * @details 跳过前 offset 行，之后最多输出 limit 行。
+ * LimitPushdownRewriter 会把它移到投影的下面，在排序算子上记录只需要前 limit + offset 行
+ */
+class LimitLogicalOperator : public LogicalOperator
+{
+public:
+  LimitLogicalOperator(int limit, int offset) : limit_(limit), offset_(offset) {}
+  virtual ~LimitLogicalOperator() = default;
+
+  LogicalOperatorType type() const override { return LogicalOperatorType::LIMIT; }
+
+  int limit() const { return limit_; }
+  int offset() const { return offset_; }
+
+private:
+  int limit_  = 0;
+  int offset_ = 0;
+};
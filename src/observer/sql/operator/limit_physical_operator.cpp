@@ -0,0 +1,64 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+#include "sql/operator/limit_physical_operator.h"
+#include "common/log/log.h"
+
+using namespace std;
+
+string LimitPhysicalOperator::param() const
+{
+  string param = to_string(limit_);
+  if (offset_ > 0) {
+    param += " OFFSET " + to_string(offset_);
+  }
+  return param;
+}
+
+RC LimitPhysicalOperator::open(Trx *trx)
+{
+  if (children_.size() != 1) {
+    LOG_WARN("limit operator must has one child");
+    return RC::INTERNAL;
+  }
+
+  skipped_rows_  = 0;
+  returned_rows_ = 0;
+  return children_[0]->open(trx);
+}
+
+RC LimitPhysicalOperator::next()
+{
+  if (returned_rows_ >= limit_) {
+    return RC::RECORD_EOF;
+  }
+
+  RC rc = RC::SUCCESS;
+  while (skipped_rows_ < offset_) {
+    rc = children_[0]->next();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    skipped_rows_++;
+  }
+
+  rc = children_[0]->next();
+  if (OB_SUCC(rc)) {
+    returned_rows_++;
+  }
+  return rc;
+}
+
+RC LimitPhysicalOperator::close()
+{
+  children_[0]->close();
+  return RC::SUCCESS;
+}
+
+Tuple *LimitPhysicalOperator::current_tuple() { return children_[0]->current_tuple(); }
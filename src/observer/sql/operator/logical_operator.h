@@ -37,11 +37,13 @@ enum class LogicalOperatorType
   PREDICATE,   ///< 过滤，就是谓词
   PROJECTION,  ///< 投影，就是select
   JOIN,        ///< 连接
+  SEMI_JOIN,   ///< 半连接和反连接，由子查询改写而来
   INSERT,      ///< 插入
   DELETE,      ///< 删除，删除可能会有子查询
   EXPLAIN,     ///< 查看执行计划
   UPDATE,      ///< 更新
   ORDER_BY,    ///< 排序
+  LIMIT,       ///< 只输出一部分行
   ANALYZE      ///< 分析
 };
 
@@ -15,6 +15,13 @@ public:
   LogicalOperatorType        type() const override { return LogicalOperatorType::ORDER_BY; }
   std::vector<OrderByUnit *> get_units() const { return order_units_; }
 
+  /**
+   * @brief 上层只需要排序之后的前 limit 行，由 LimitPushdownRewriter 设置。-1 表示需要所有的行
+   */
+  void set_limit(int limit) { limit_ = limit; }
+  int  limit() const { return limit_; }
+
 private:
   std::vector<OrderByUnit *> order_units_;
+  int                        limit_ = -1;
 };
\ No newline at end of file
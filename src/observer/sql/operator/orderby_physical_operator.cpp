@@ -10,6 +10,27 @@
 
 RC OrderPhysicalOperator::get_inited()
 {
+  // order the ValueGrp with order rules
+  std::function<bool(ValueGrp * &left, ValueGrp * &right)> cmprule = [&](ValueGrp *&left, ValueGrp *&right) -> bool {
+    for (auto [idx, asc] : ord_idx_asc) {
+      if (asc) {
+        // 升序
+        if ((*left)[idx].compare(CompOp::LESS_THAN, (*right)[idx]))
+          return true;
+        else if ((*left)[idx].compare(CompOp::GREAT_THAN, (*right)[idx]))
+          return false;
+      } else {
+        // 降序
+        if ((*left)[idx].compare(CompOp::GREAT_THAN, (*right)[idx]))
+          return true;
+        else if ((*left)[idx].compare(CompOp::LESS_THAN, (*right)[idx]))
+          return false;
+      }
+    }
+    // return a default value
+    return false;
+  };
+
   // get all the vector<Value>
   bool got_rules = false;
   while (RC::SUCCESS == children_[0]->next()) {
@@ -37,29 +58,22 @@ RC OrderPhysicalOperator::get_inited()
       val_vec->emplace_back(temp);
     }
     ori_data.emplace_back(val_vec);
-  }
-  // order the ValueGrp with order rules
-  std::function<bool(ValueGrp * &left, ValueGrp * &right)> cmprule = [&](ValueGrp *&left, ValueGrp *&right) -> bool {
-    for (auto [idx, asc] : ord_idx_asc) {
-      if (asc) {
-        // 升序
-        if ((*left)[idx].compare(CompOp::LESS_THAN, (*right)[idx]))
-          return true;
-        else if ((*left)[idx].compare(CompOp::GREAT_THAN, (*right)[idx]))
-          return false;
-      } else {
-        // 降序
-        if ((*left)[idx].compare(CompOp::GREAT_THAN, (*right)[idx]))
-          return true;
-        else if ((*left)[idx].compare(CompOp::LESS_THAN, (*right)[idx]))
-          return false;
+
+    // 堆顶是目前保留的行中排在最后的，超过 limit 行时丢掉
+    if (limit_ >= 0) {
+      push_heap(ori_data.begin(), ori_data.end(), cmprule);
+      if (ori_data.size() > static_cast<size_t>(limit_)) {
+        pop_heap(ori_data.begin(), ori_data.end(), cmprule);
+        delete ori_data.back();
+        ori_data.pop_back();
       }
     }
-    // return a default value
-    return false;
-  };
-
-  sort(ori_data.begin(), ori_data.end(), cmprule);
+  }
+  if (limit_ >= 0) {
+    sort_heap(ori_data.begin(), ori_data.end(), cmprule);
+  } else {
+    sort(ori_data.begin(), ori_data.end(), cmprule);
+  }
 
   ordered_tuple = new std::vector<ValueListTuple>(ori_data.size(), ValueListTuple());
   for (int i = 0, j = 0; i < ori_data.size() && j < ordered_tuple->size(); i++, j++) {
@@ -82,12 +96,16 @@ OrderPhysicalOperator::~OrderPhysicalOperator()
     valgrp->clear();
     delete valgrp;
   }
-  ordered_tuple->clear();
   ori_data.clear();
   ord_idx_asc.clear();
   delete ordered_tuple;
 }
 
+std::string OrderPhysicalOperator::param() const
+{
+  return limit_ >= 0 ? "top " + std::to_string(limit_) : "";
+}
+
 RC OrderPhysicalOperator::open(Trx *trx)
 {
   if (children_.size() > 1) {
@@ -114,7 +132,7 @@ RC OrderPhysicalOperator::next()
     LOG_WARN("Error at get data and sort");
     return RC::INTERNAL;
   }
-  return RC::SUCCESS;
+  return ordered_tuple->empty() ? RC::RECORD_EOF : RC::SUCCESS;
 }
 
 RC OrderPhysicalOperator::close()
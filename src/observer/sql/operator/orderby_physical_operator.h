@@ -15,16 +15,21 @@ class OrderByStmt;
  * @ingroup PhysicalOperator
  * @details 以vector<Value>的形式深拷贝取出Project子算子的所有Tuple，按照需求Sort之后，
  *          建一个ValueListTuple，返回current_tuple。目前使用STL的Sort
+ *          设置了 limit 时只用 limit 个元素的堆保留最前面的行，不需要保存和排序所有的数据
  */
 class OrderPhysicalOperator : public PhysicalOperator
 {
 public:
-  explicit OrderPhysicalOperator(std::vector<OrderByUnit *> order_units) : order_units_(order_units) {}
+  explicit OrderPhysicalOperator(std::vector<OrderByUnit *> order_units, int limit = -1)
+      : order_units_(order_units), limit_(limit)
+  {}
 
   virtual ~OrderPhysicalOperator();
 
   PhysicalOperatorType type() const override { return PhysicalOperatorType::ORDER_BY; }
 
+  std::string param() const override;
+
   RC open(Trx *trx) override;
   RC next() override;
   RC close() override;
@@ -42,7 +47,8 @@ private:
   bool                                  is_inited_ = false;  // 是否已经初始化
   std::vector<std::pair<int, bool>>     ord_idx_asc;         // 表示order的第idx个cell是否为ASC排序
   std::vector<OrderByUnit *>            order_units_;
+  int                                   limit_ = -1;  // 只需要前 limit 行，-1 表示需要所有的行
   std::vector<ValueGrp *>               ori_data;
   std::vector<ValueListTuple>::iterator ordered_iter_;
-  std::vector<ValueListTuple>          *ordered_tuple;
+  std::vector<ValueListTuple>          *ordered_tuple = nullptr;  // 没有执行过 open 时为空(比如 EXPLAIN)
 };
\ No newline at end of file
@@ -39,7 +39,10 @@ enum class PhysicalOperatorType
 {
   TABLE_SCAN,
   INDEX_SCAN,
+  BITMAP_HEAP_SCAN,
   NESTED_LOOP_JOIN,
+  HASH_SEMI_JOIN,
+  HASH_ANTI_JOIN,
   EXPLAIN,
   PREDICATE,
   PROJECT,
@@ -49,6 +52,7 @@ enum class PhysicalOperatorType
   INSERT,
   UPDATE,
   ORDER_BY, // 排序
+  LIMIT,
   ANALYZE
 };
 
@@ -81,6 +85,21 @@ public:
 
   std::vector<std::unique_ptr<PhysicalOperator>> &children() { return children_; }
 
+  /**
+   * @brief 生成执行计划时估计的输出行数和总代价，参考 CostModel。explain 时会打印出来
+   */
+  void set_estimate(double rows, double cost)
+  {
+    estimated_rows_ = rows;
+    estimated_cost_ = cost;
+  }
+  bool   has_estimate() const { return estimated_rows_ >= 0; }
+  double estimated_rows() const { return estimated_rows_; }
+  double estimated_cost() const { return estimated_cost_; }
+
 protected:
   std::vector<std::unique_ptr<PhysicalOperator>> children_;
+
+  double estimated_rows_ = -1;  ///< 小于0表示没有估计
+  double estimated_cost_ = 0;
 };
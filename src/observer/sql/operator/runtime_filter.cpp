@@ -0,0 +1,105 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+
+#include "common/log/log.h"
+#include "sql/expr/tuple.h"
+#include "sql/operator/runtime_filter.h"
+#include "storage/record/record.h"
+
+using namespace std;
+using namespace common;
+
+RuntimeFilter::RuntimeFilter(const Field &probe_field, const Field &build_field)
+    : probe_field_(probe_field.table(), probe_field.meta()), build_field_(build_field.table(), build_field.meta())
+{}
+
+bool RuntimeFilter::supported(const Field &probe_field, const Field &build_field)
+{
+  const AttrType attr_type = probe_field.attr_type();
+  if (attr_type != build_field.attr_type()) {
+    return false;
+  }
+  return ((attr_type == INTS || attr_type == DATES) && probe_field.meta()->len() == sizeof(int32_t)) ||
+         attr_type == CHARS;
+}
+
+RC RuntimeFilter::add(const Tuple &tuple)
+{
+  Value value;
+  RC    rc = tuple.find_cell(TupleCellSpec(build_field_.table_name(), build_field_.field_name()), value);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to find join key in build side tuple. field=%s.%s, rc=%s",
+             build_field_.table_name(), build_field_.field_name(), strrc(rc));
+    return rc;
+  }
+
+  if (value.attr_type() == INTS || value.attr_type() == DATES) {
+    // 日期保存为一个整数，和整数一样比较
+    const int32_t int_value = value.attr_type() == DATES ? value.get_date().value : value.get_int();
+    if (hashes_.empty() || int_value < min_value_) {
+      min_value_ = int_value;
+    }
+    if (hashes_.empty() || int_value > max_value_) {
+      max_value_ = int_value;
+    }
+    hashes_.push_back(BloomFilter::hash(reinterpret_cast<const char *>(&int_value), sizeof(int_value)));
+  } else {
+    hashes_.push_back(BloomFilter::hash(value.data(), value.length()));
+  }
+  return RC::SUCCESS;
+}
+
+void RuntimeFilter::finish()
+{
+  bloom_.init(static_cast<int64_t>(hashes_.size()));
+  for (uint64_t item_hash : hashes_) {
+    bloom_.add(item_hash);
+  }
+  LOG_TRACE("runtime filter is ready. filter=%s, build rows=%d", to_string().c_str(), static_cast<int>(hashes_.size()));
+
+  hashes_.clear();
+  hashes_.shrink_to_fit();
+  ready_ = true;
+}
+
+bool RuntimeFilter::filter(const Record &rec) const
+{
+  if (!ready_) {
+    return true;
+  }
+
+  checked_rows_++;
+  const FieldMeta *field_meta = probe_field_.meta();
+  const char      *data       = rec.data() + field_meta->offset();
+
+  bool result = false;
+  if (field_meta->type() == INTS || field_meta->type() == DATES) {
+    int32_t int_value = 0;
+    memcpy(&int_value, data, sizeof(int_value));
+    result = int_value >= min_value_ && int_value <= max_value_ &&
+             bloom_.may_contain(BloomFilter::hash(reinterpret_cast<const char *>(&int_value), sizeof(int_value)));
+  } else {
+    // 与 Value::set_data 一样，字符串到第一个'\0'为止
+    result = bloom_.may_contain(BloomFilter::hash(data, static_cast<int>(strnlen(data, field_meta->len()))));
+  }
+
+  if (!result) {
+    filtered_rows_++;
+  }
+  return result;
+}
+
+string RuntimeFilter::to_string() const
+{
+  return string(probe_field_.table_name()) + "." + probe_field_.field_name() + "=" + build_field_.table_name() + "." +
+         build_field_.field_name();
+}
@@ -0,0 +1,95 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "common/lang/bloom_filter.h"
+#include "storage/common/condition_filter.h"
+#include "storage/field/field.h"
+
+class Tuple;
+
+/**
+ * @brief 连接时在运行时生成的过滤器
+ * @ingroup PhysicalOperator
+ * @details 嵌套循环连接在遍历外表之前，先把内表(build 端)遍历一遍，把连接键的值放到布隆过滤器中，
+ * 整数和日期还会记录最小值和最大值。外表(probe 端)的扫描算子拿到记录之后马上用它过滤，
+ * 连接键不可能匹配的记录不会生成元组，也不需要再和内表的每一行比较。
+ *
+ * 只用于两边字段类型相同的等值连接条件，并且只支持 INTS、DATES 和 CHARS：
+ * 这几种类型按照 Value::compare 相等时字节也相等(日期保存为整数，按照整数比较)，
+ * 用字节计算的哈希值不会漏掉匹配的记录。
+ */
+class RuntimeFilter : public ConditionFilter
+{
+public:
+  RuntimeFilter(const Field &probe_field, const Field &build_field);
+  virtual ~RuntimeFilter() = default;
+
+  /**
+   * @brief 是否可以为这两个字段之间的等值连接生成过滤器
+   */
+  static bool supported(const Field &probe_field, const Field &build_field);
+
+  /**
+   * @brief 记录是否通过了所有的过滤器
+   */
+  static bool match_all(const std::vector<RuntimeFilter *> &filters, const Record &rec)
+  {
+    for (const RuntimeFilter *filter : filters) {
+      if (!filter->filter(rec)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const Field &probe_field() const { return probe_field_; }
+  const Field &build_field() const { return build_field_; }
+
+  /**
+   * @brief 把 build 端一行的连接键放到过滤器中
+   */
+  RC add(const Tuple &tuple);
+
+  /**
+   * @brief build 端遍历完之后调用，之后才开始过滤
+   */
+  void finish();
+
+  bool ready() const { return ready_; }
+
+  /**
+   * @brief 判断 probe 端的记录是否可能有匹配的行。还没有生成时不过滤
+   */
+  bool filter(const Record &rec) const override;
+
+  int64_t checked_rows() const { return checked_rows_; }
+  int64_t filtered_rows() const { return filtered_rows_; }
+
+  std::string to_string() const;
+
+private:
+  Field probe_field_;
+  Field build_field_;
+
+  std::vector<uint64_t> hashes_;  ///< build 时收集的哈希值，知道个数之后再生成布隆过滤器。没有值时过滤掉所有记录
+  common::BloomFilter   bloom_;
+  int32_t               min_value_ = 0;
+  int32_t               max_value_ = 0;
+  bool                  ready_     = false;
+
+  mutable int64_t checked_rows_  = 0;
+  mutable int64_t filtered_rows_ = 0;
+};
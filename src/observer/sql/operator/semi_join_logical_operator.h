@@ -0,0 +1,39 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/operator/logical_operator.h"
+
+/**
+ * @brief 半连接和反连接
+ * @ingroup LogicalOperator
+ * @details 左边是外层查询，右边是子查询。半连接输出右边至少有一行满足连接条件的左边的行，
+ * 反连接输出右边没有任何一行满足连接条件的左边的行，都只输出左边的数据，每一行最多输出一次。
+ * 连接条件放在 expressions 中，没有条件时(不相关的 EXISTS)只看右边是否有数据
+ */
+class SemiJoinLogicalOperator : public LogicalOperator
+{
+public:
+  SemiJoinLogicalOperator(bool anti, std::unique_ptr<Expression> condition) : anti_(anti)
+  {
+    if (condition) {
+      expressions_.emplace_back(std::move(condition));
+    }
+  }
+  virtual ~SemiJoinLogicalOperator() = default;
+
+  LogicalOperatorType type() const override { return LogicalOperatorType::SEMI_JOIN; }
+
+  bool anti() const { return anti_; }
+
+private:
+  bool anti_ = false;  ///< 是否是反连接
+};
@@ -31,15 +31,31 @@ public:
 
   Table *table() const { return table_; }
   bool   readonly() const { return readonly_; }
-  void setCost(double cost){cost_ = cost;}
-  int  getcost(){return cost_;}
-  void setRecordNum(int num){record_num_ = num;}
-  int  getRecordNum(){return record_num_;}
 
+  /**
+   * @brief 上层算子需要的字段，查询时扫描算子输出的元组只包含这些字段
+   * @details 由 ProjectionPushdownRewriter 根据投影和过滤条件计算
+   */
+  const std::vector<Field> &fields() const { return fields_; }
+  void                      set_fields(std::vector<Field> fields) { fields_ = std::move(fields); }
 
   void                                      set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
   std::vector<std::unique_ptr<Expression>> &predicates() { return predicates_; }
 
+  /**
+   * @brief 上层按照这个字段排序之后只取前 limit 行
+   * @details 生成物理计划时设置。扫描可以直接按照这个字段上的索引的顺序输出，取够了行就停止，不再需要排序
+   */
+  void set_required_order(const char *field_name, bool asc, int limit)
+  {
+    order_field_ = field_name;
+    order_asc_   = asc;
+    order_limit_ = limit;
+  }
+  const char *order_field() const { return order_field_; }
+  bool        order_asc() const { return order_asc_; }
+  int         order_limit() const { return order_limit_; }
+
 private:
   Table             *table_ = nullptr;
   std::vector<Field> fields_;
@@ -51,6 +67,7 @@ private:
   // 如果有多个表达式，他们的关系都是 AND
   std::vector<std::unique_ptr<Expression>> predicates_;
 
-  double cost_;
-  int record_num_;
+  const char *order_field_ = nullptr;  ///< 为空表示上层没有排序的要求
+  bool        order_asc_   = true;
+  int         order_limit_ = -1;
 };
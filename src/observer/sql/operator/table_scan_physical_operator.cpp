@@ -14,15 +14,116 @@ See the Mulan PSL v2 for more details. */
 
 #include "sql/operator/table_scan_physical_operator.h"
 #include "event/sql_debug.h"
+#include "sql/expr/expression.h"
 #include "storage/table/table.h"
 
 using namespace std;
 
+namespace {
+
+CompOp reverse_comp(CompOp comp)
+{
+  switch (comp) {
+    case LESS_THAN: return GREAT_THAN;
+    case LESS_EQUAL: return GREAT_EQUAL;
+    case GREAT_THAN: return LESS_THAN;
+    case GREAT_EQUAL: return LESS_EQUAL;
+    default: return comp;
+  }
+}
+
+/**
+ * @brief 从 字段 comp 常量 形式的条件中生成区域映射的过滤条件，其它条件只能逐行判断
+ */
+vector<ZoneMapCondition> zone_map_conditions(const vector<unique_ptr<Expression>> &predicates)
+{
+  vector<ZoneMapCondition> conditions;
+  for (const unique_ptr<Expression> &expr : predicates) {
+    if (expr->type() != ExprType::COMPARISON) {
+      continue;
+    }
+
+    auto       &comparison = static_cast<ComparisonExpr &>(*expr);
+    Expression *left       = comparison.left().get();
+    Expression *right      = comparison.right().get();
+    CompOp      comp       = comparison.comp();
+    if (left->type() == ExprType::VALUE && right->type() == ExprType::FIELD) {
+      std::swap(left, right);
+      comp = reverse_comp(comp);
+    }
+    if (left->type() != ExprType::FIELD || right->type() != ExprType::VALUE) {
+      continue;
+    }
+
+    ZoneMapCondition condition;
+    condition.field_offset = static_cast<FieldExpr *>(left)->field().meta()->offset();
+    condition.comp         = comp;
+    condition.value        = static_cast<ValueExpr *>(right)->get_value();
+    conditions.push_back(condition);
+  }
+  return conditions;
+}
+
+/**
+ * @brief 把 字段 comp 常量 或者 常量 comp 字段 形式的条件转换成可以直接判断记录数据的过滤器
+ * @details 比较时与 ComparisonExpr 一样使用 Value::compare，字段的值也与 RowTuple 中取出来的一样，
+ * 所以下推前后的结果相同。不能转换时返回空
+ */
+unique_ptr<DefaultConditionFilter> pushdown_filter(Expression &expr)
+{
+  if (expr.type() != ExprType::COMPARISON) {
+    return nullptr;
+  }
+
+  auto       &comparison = static_cast<ComparisonExpr &>(expr);
+  Expression *exprs[2]   = {comparison.left().get(), comparison.right().get()};
+  ConDesc     con_descs[2];
+  AttrType    attr_type = UNDEFINED;
+  int         field_num = 0;
+  for (int i = 0; i < 2; i++) {
+    ConDesc &con_desc = con_descs[i];
+    if (exprs[i]->type() == ExprType::FIELD) {
+      const FieldMeta *field_meta = static_cast<FieldExpr *>(exprs[i])->field().meta();
+      con_desc.is_attr            = true;
+      con_desc.attr_length        = field_meta->len();
+      con_desc.attr_offset        = field_meta->offset();
+      attr_type                   = field_meta->type();
+      field_num++;
+    } else if (exprs[i]->type() == ExprType::VALUE) {
+      con_desc.is_attr     = false;
+      con_desc.attr_length = 0;
+      con_desc.attr_offset = 0;
+      con_desc.value       = static_cast<ValueExpr *>(exprs[i])->get_value();
+    } else {
+      return nullptr;
+    }
+  }
+  // 不支持的类型和运算符留给表达式过滤，先检查一下，免得 init 打印错误日志
+  if (field_num != 1 || !DefaultConditionFilter::is_supported(attr_type, comparison.comp())) {
+    return nullptr;
+  }
+
+  auto filter = make_unique<DefaultConditionFilter>();
+  RC   rc     = filter->init(con_descs[0], con_descs[1], attr_type, comparison.comp());
+  if (OB_FAIL(rc)) {
+    return nullptr;
+  }
+  return filter;
+}
+
+}  // namespace
+
 RC TableScanPhysicalOperator::open(Trx *trx)
 {
-  RC rc = table_->get_record_scanner(record_scanner_, trx, readonly_);
+  record_scanner_.set_zone_map_conditions(zone_map_conditions_);
+  ConditionFilter *condition_filter = pushdown_filter_ptrs_.empty() ? nullptr : &pushdown_filter_;
+  RC rc = table_->get_record_scanner(record_scanner_, trx, readonly_, condition_filter);
   if (rc == RC::SUCCESS) {
-    tuple_.set_schema(table_, table_->table_meta().field_metas());
+    if (has_output_fields_) {
+      tuple_.set_schema(table_, output_fields_);
+    } else {
+      tuple_.set_schema(table_, table_->table_meta().field_metas());
+    }
   }
   trx_ = trx;
   return rc;
@@ -62,7 +163,13 @@ RC TableScanPhysicalOperator::next()
   return rc;
 }
 
-RC TableScanPhysicalOperator::close() { return record_scanner_.close_scan(); }
+RC TableScanPhysicalOperator::close()
+{
+  if (record_scanner_.skipped_pages() > 0) {
+    sql_debug("zone map skipped %d pages of table %s", record_scanner_.skipped_pages(), table_->name());
+  }
+  return record_scanner_.close_scan();
+}
 
 Tuple *TableScanPhysicalOperator::current_tuple()
 {
@@ -74,7 +181,27 @@ string TableScanPhysicalOperator::param() const { return table_->name(); }
 
 void TableScanPhysicalOperator::set_predicates(vector<unique_ptr<Expression>> &&exprs)
 {
-  predicates_ = std::move(exprs);
+  zone_map_conditions_ = zone_map_conditions(exprs);
+
+  predicates_.clear();
+  pushdown_filters_.clear();
+  pushdown_filter_ptrs_.clear();
+  for (unique_ptr<Expression> &expr : exprs) {
+    unique_ptr<DefaultConditionFilter> filter = pushdown_filter(*expr);
+    if (filter) {
+      pushdown_filter_ptrs_.push_back(filter.get());
+      pushdown_filters_.push_back(std::move(filter));
+    } else {
+      predicates_.push_back(std::move(expr));
+    }
+  }
+  pushdown_filter_.init(pushdown_filter_ptrs_.data(), static_cast<int>(pushdown_filter_ptrs_.size()));
+}
+
+void TableScanPhysicalOperator::add_runtime_filter(RuntimeFilter *filter)
+{
+  pushdown_filter_ptrs_.push_back(filter);
+  pushdown_filter_.init(pushdown_filter_ptrs_.data(), static_cast<int>(pushdown_filter_ptrs_.size()));
 }
 
 RC TableScanPhysicalOperator::filter(RowTuple &tuple, bool &result)
@@ -16,6 +16,8 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/rc.h"
 #include "sql/operator/physical_operator.h"
+#include "sql/operator/runtime_filter.h"
+#include "storage/common/condition_filter.h"
 #include "storage/record/record_manager.h"
 
 class Table;
@@ -23,6 +25,8 @@ class Table;
 /**
  * @brief 表扫描物理算子
  * @ingroup PhysicalOperator
+ * @details 字段和常量比较的条件下推到 RecordFileScanner 中，直接在页面上的记录数据上判断，
+ * 其它的条件在记录拷贝出来之后用表达式计算。
  */
 class TableScanPhysicalOperator : public PhysicalOperator
 {
@@ -35,14 +39,33 @@ public:
 
   PhysicalOperatorType type() const override { return PhysicalOperatorType::TABLE_SCAN; }
 
+  Table *table() const { return table_; }
+
   RC open(Trx *trx) override;
   RC next() override;
   RC close() override;
 
   Tuple *current_tuple() override;
 
+  /**
+   * @brief 设置扫描的过滤条件，能下推到扫描器中的条件会转换成 ConditionFilter
+   */
   void set_predicates(std::vector<std::unique_ptr<Expression>> &&exprs);
 
+  /**
+   * @brief 连接算子生成的运行时过滤器，和下推的条件一起在页面上过滤记录
+   */
+  void add_runtime_filter(RuntimeFilter *filter);
+
+  /**
+   * @brief 设置输出的元组包含哪些字段，没有设置时包含表的所有字段
+   */
+  void set_output_fields(std::vector<const FieldMeta *> fields)
+  {
+    output_fields_     = std::move(fields);
+    has_output_fields_ = true;
+  }
+
 private:
   RC filter(RowTuple &tuple, bool &result);
 
@@ -53,5 +76,12 @@ private:
   RecordFileScanner                        record_scanner_;
   Record                                   current_record_;
   RowTuple                                 tuple_;
-  std::vector<std::unique_ptr<Expression>> predicates_;  // TODO chang predicate to table tuple filter
+  std::vector<const FieldMeta *>           output_fields_;
+  bool                                     has_output_fields_ = false;
+  std::vector<std::unique_ptr<Expression>> predicates_;  ///< 不能下推的条件，逐行计算
+
+  std::vector<std::unique_ptr<DefaultConditionFilter>> pushdown_filters_;  ///< 下推到扫描器中的条件
+  std::vector<const ConditionFilter *>                 pushdown_filter_ptrs_;  ///< 下推的条件和运行时过滤器
+  CompositeConditionFilter                             pushdown_filter_;
+  std::vector<ZoneMapCondition>                        zone_map_conditions_;
 };
@@ -0,0 +1,263 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <cmath>
+
+#include "sql/expr/expression.h"
+#include "sql/optimizer/cost_model.h"
+#include "storage/buffer/page.h"
+#include "storage/field/field.h"
+#include "storage/table/table.h"
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief 可以做线性插值的类型转换成数值
+ */
+bool numeric_value(const Value &value, double &number)
+{
+  switch (value.attr_type()) {
+    case INTS: number = value.get_int(); return true;
+    case FLOATS: number = value.get_float(); return true;
+    case DATES: number = value.get_date().value; return true;
+    default: return false;
+  }
+}
+
+double clamp_selectivity(double selectivity) { return std::clamp(selectivity, 0.0, 1.0); }
+
+CompOp reverse_comp(CompOp comp)
+{
+  switch (comp) {
+    case LESS_THAN: return GREAT_THAN;
+    case LESS_EQUAL: return GREAT_EQUAL;
+    case GREAT_THAN: return LESS_THAN;
+    case GREAT_EQUAL: return LESS_EQUAL;
+    default: return comp;
+  }
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+double CostModel::table_scan(double pages, double rows, int predicate_num)
+{
+  return SEQ_PAGE_COST * pages + (CPU_TUPLE_COST + CPU_OPERATOR_COST * predicate_num) * rows;
+}
+
+double CostModel::index_lookup(double index_rows)
+{
+  // 从根节点找到第一个叶子节点算一次随机读，之后沿着叶子节点的链表顺序读取
+  return RANDOM_PAGE_COST + SEQ_PAGE_COST * index_rows / INDEX_TUPLES_PER_PAGE +
+         (CPU_INDEX_TUPLE_COST + CPU_OPERATOR_COST) * index_rows;
+}
+
+double CostModel::index_scan(double pages, double matched_rows, int predicate_num)
+{
+  // Mackert-Lohman：随机访问 N 次、共 T 个页面时，实际读取的页面数大约是 2TN/(2T+N)，不超过 T
+  const double fetched_pages = pages <= 0 ? 0 : min(pages, 2 * pages * matched_rows / (2 * pages + matched_rows));
+  return index_lookup(matched_rows) + RANDOM_PAGE_COST * fetched_pages +
+         (CPU_TUPLE_COST + CPU_OPERATOR_COST * predicate_num) * matched_rows;
+}
+
+double CostModel::bitmap_heap_scan(double pages, double index_rows, double matched_rows, int predicate_num)
+{
+  // 匹配的记录均匀分布时，N 条记录覆盖的页面数是 T * (1 - (1 - 1/T)^N)
+  double fetched_pages = 0;
+  if (pages > 0) {
+    fetched_pages = min(pages, pages * (1 - pow(1 - 1 / max(pages, 1.0), matched_rows)));
+  }
+  // 第一个页面总是随机读；之后按照页号顺序访问，读取的页面越多越接近顺序读
+  double page_cost = 0;
+  if (fetched_pages > 0) {
+    page_cost = RANDOM_PAGE_COST + (fetched_pages - 1) * (RANDOM_PAGE_COST - (RANDOM_PAGE_COST - SEQ_PAGE_COST) *
+                                                                                  sqrt(fetched_pages / pages));
+  }
+  return index_lookup(index_rows) + page_cost +
+         (CPU_TUPLE_COST + CPU_OPERATOR_COST * predicate_num) * matched_rows;
+}
+
+double CostModel::nested_loop_join(double outer_cost, double outer_rows, double inner_cost, double inner_rows)
+{
+  return outer_cost + max(outer_rows, 1.0) * inner_cost + CPU_TUPLE_COST * outer_rows * inner_rows;
+}
+
+double CostModel::hash_join(double build_cost, double build_rows, double probe_cost, double probe_rows)
+{
+  return build_cost + probe_cost + (CPU_TUPLE_COST + CPU_OPERATOR_COST) * build_rows +
+         CPU_OPERATOR_COST * probe_rows;
+}
+
+double CostModel::index_join(double outer_cost, double outer_rows, double lookup_cost)
+{
+  return outer_cost + outer_rows * lookup_cost;
+}
+
+double CostModel::sort(double child_cost, double rows)
+{
+  // 比较次数大约是 N * log2(N)，每次比较算两次运算
+  return child_cost + 2 * CPU_OPERATOR_COST * rows * log2(max(rows, 2.0)) + CPU_TUPLE_COST * rows;
+}
+
+double CostModel::top_n(double child_cost, double rows, double limit)
+{
+  if (limit >= rows) {
+    return sort(child_cost, rows);
+  }
+  return child_cost + 2 * CPU_OPERATOR_COST * rows * log2(max(limit, 2.0)) + CPU_TUPLE_COST * limit;
+}
+
+double CostModel::aggregate(double child_cost, double rows, int aggregate_num)
+{
+  return child_cost + CPU_OPERATOR_COST * aggregate_num * rows + CPU_TUPLE_COST;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double CardinalityEstimator::table_rows(const Table *table)
+{
+  const double                      pages = table->data_page_count();
+  std::shared_ptr<const TableStats> stats = table->stats();
+  if (stats->analyzed() && stats->page_count() > 0) {
+    // ANALYZE 之后数据可能有变化，按照当前的页面数等比例调整
+    return static_cast<double>(stats->row_count()) / stats->page_count() * pages;
+  }
+  if (stats->analyzed()) {
+    return static_cast<double>(stats->row_count());
+  }
+
+  // 没有统计信息，认为页面都是满的
+  const int record_size = max(table->table_meta().record_size(), 1);
+  return pages * (BP_PAGE_DATA_SIZE / record_size);
+}
+
+double CardinalityEstimator::table_pages(const Table *table) { return table->data_page_count(); }
+
+const ColumnStats *CardinalityEstimator::column_stats(const Field &field)
+{
+  if (field.table() == nullptr) {
+    return nullptr;
+  }
+  // 表对象的生命周期比执行计划长，统计信息对象由表持有
+  return field.table()->stats()->column(field.field_name());
+}
+
+double CardinalityEstimator::equal_selectivity(const Field &field)
+{
+  const ColumnStats *stats = column_stats(field);
+  if (stats == nullptr || stats->distinct_count <= 0) {
+    return DEFAULT_EQUAL_SELECTIVITY;
+  }
+  return 1.0 / stats->distinct_count;
+}
+
+double CardinalityEstimator::less_than_fraction(const ColumnStats &stats, const Value &value)
+{
+  const vector<Value> &bounds  = stats.bounds;
+  const int            buckets = static_cast<int>(bounds.size()) - 1;
+
+  // 找到第一个不小于 value 的边界，value 落在它前面的那个桶里
+  auto iter = lower_bound(bounds.begin(), bounds.end(), value, [](const Value &bound, const Value &value) {
+    return bound.compare(value) < 0;
+  });
+  const int index = static_cast<int>(iter - bounds.begin());
+  if (index == 0) {
+    return 0;
+  }
+  if (index > buckets) {
+    return 1;
+  }
+
+  double fraction = 0.5;
+  double low, high, number;
+  if (numeric_value(bounds[index - 1], low) && numeric_value(bounds[index], high) && numeric_value(value, number) &&
+      high > low) {
+    fraction = (number - low) / (high - low);
+  }
+  return clamp_selectivity((index - 1 + fraction) / buckets);
+}
+
+double CardinalityEstimator::compare_selectivity(const Field &field, CompOp comp, const Value &value)
+{
+  const ColumnStats *stats = column_stats(field);
+  if (stats == nullptr || stats->bounds.size() < 2) {
+    switch (comp) {
+      case EQUAL_TO: return equal_selectivity(field);
+      case NOT_EQUAL: return 1 - equal_selectivity(field);
+      case LIKE: return DEFAULT_LIKE_SELECTIVITY;
+      case NOT_LIKE: return 1 - DEFAULT_LIKE_SELECTIVITY;
+      default: return DEFAULT_RANGE_SELECTIVITY;
+    }
+  }
+
+  // 超出直方图范围的等值条件几乎没有匹配的记录
+  double equal = equal_selectivity(field);
+  if (value.compare(stats->bounds.front()) < 0 || value.compare(stats->bounds.back()) > 0) {
+    equal = 0;
+  }
+
+  switch (comp) {
+    case EQUAL_TO: return equal;
+    case NOT_EQUAL: return 1 - equal;
+    case LESS_THAN: return less_than_fraction(*stats, value);
+    case LESS_EQUAL: return clamp_selectivity(less_than_fraction(*stats, value) + equal);
+    case GREAT_THAN: return clamp_selectivity(1 - less_than_fraction(*stats, value) - equal);
+    case GREAT_EQUAL: return clamp_selectivity(1 - less_than_fraction(*stats, value));
+    case LIKE: return DEFAULT_LIKE_SELECTIVITY;
+    case NOT_LIKE: return 1 - DEFAULT_LIKE_SELECTIVITY;
+    default: return DEFAULT_RANGE_SELECTIVITY;
+  }
+}
+
+double CardinalityEstimator::selectivity(Expression &expr)
+{
+  switch (expr.type()) {
+    case ExprType::COMPARISON: {
+      auto        &comparison = static_cast<ComparisonExpr &>(expr);
+      Expression  *left       = comparison.left().get();
+      Expression  *right      = comparison.right().get();
+      const CompOp comp       = comparison.comp();
+      if (left->type() == ExprType::FIELD && right->type() == ExprType::VALUE) {
+        return compare_selectivity(
+            static_cast<FieldExpr *>(left)->field(), comp, static_cast<ValueExpr *>(right)->get_value());
+      }
+      if (left->type() == ExprType::VALUE && right->type() == ExprType::FIELD) {
+        return compare_selectivity(
+            static_cast<FieldExpr *>(right)->field(), reverse_comp(comp), static_cast<ValueExpr *>(left)->get_value());
+      }
+      if (left->type() == ExprType::FIELD && right->type() == ExprType::FIELD && comp == EQUAL_TO) {
+        // 等值连接：两边的值域相同，匹配的比例取决于不同值较多的一边
+        return min(equal_selectivity(static_cast<FieldExpr *>(left)->field()),
+            equal_selectivity(static_cast<FieldExpr *>(right)->field()));
+      }
+      return DEFAULT_RANGE_SELECTIVITY;
+    }
+
+    case ExprType::CONJUNCTION: {
+      auto  &conjunction = static_cast<ConjunctionExpr &>(expr);
+      double result      = conjunction.conjunction_type() == ConjunctionExpr::Type::AND ? 1.0 : 0.0;
+      for (unique_ptr<Expression> &child : conjunction.children()) {
+        const double child_selectivity = selectivity(*child);
+        if (conjunction.conjunction_type() == ConjunctionExpr::Type::AND) {
+          result *= child_selectivity;  // 假设各个条件相互独立
+        } else {
+          result = result + child_selectivity - result * child_selectivity;
+        }
+      }
+      return result;
+    }
+
+    default: return DEFAULT_RANGE_SELECTIVITY;
+  }
+}
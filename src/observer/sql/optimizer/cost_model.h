@@ -0,0 +1,124 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/parser/comp_op.h"
+
+class Expression;
+class Field;
+class Table;
+class Value;
+struct ColumnStats;
+
+/**
+ * @brief 代价模型
+ * @ingroup PhysicalOperator
+ * @details 代价的单位是顺序读取一个页面的开销，各个参数的取值参考了 PostgreSQL。
+ * 每个函数返回的都是包含了子节点代价的总代价。行数、页面数都是估计值，可以是小数
+ */
+class CostModel
+{
+public:
+  static constexpr double SEQ_PAGE_COST        = 1.0;     ///< 顺序读取一个页面
+  static constexpr double RANDOM_PAGE_COST     = 4.0;     ///< 随机读取一个页面
+  static constexpr double CPU_TUPLE_COST       = 0.01;    ///< 处理一行数据
+  static constexpr double CPU_INDEX_TUPLE_COST = 0.005;   ///< 处理一个索引项
+  static constexpr double CPU_OPERATOR_COST    = 0.0025;  ///< 计算一次比较或者函数
+
+  static constexpr double INDEX_TUPLES_PER_PAGE = 256;  ///< 估计索引页面个数时，认为每个叶子页面上有这么多索引项
+
+  /**
+   * @brief 全表扫描：顺序读取所有页面，每一行都检查一遍过滤条件
+   */
+  static double table_scan(double pages, double rows, int predicate_num);
+
+  /**
+   * @brief 索引扫描：按照索引顺序回表，每个匹配的记录都可能随机读取一个页面
+   * @details 缓冲池足够大时同一个页面只会读取一次，实际读取的页面数使用 Mackert-Lohman 公式估计
+   * @param matched_rows 索引条件匹配的行数
+   */
+  static double index_scan(double pages, double matched_rows, int predicate_num);
+
+  /**
+   * @brief 位图堆扫描：从每个索引中取出匹配的RID，然后按照页号顺序读取页面，每个页面只读一次
+   * @param index_rows   所有索引条件匹配的行数之和
+   * @param matched_rows 索引结果求交集之后的行数
+   */
+  static double bitmap_heap_scan(double pages, double index_rows, double matched_rows, int predicate_num);
+
+  /**
+   * @brief 嵌套循环连接：外表的每一行都要重新执行一遍内表
+   */
+  static double nested_loop_join(double outer_cost, double outer_rows, double inner_cost, double inner_rows);
+
+  /**
+   * @brief 哈希连接：用较小的一边建立哈希表，另一边逐行探测
+   */
+  static double hash_join(double build_cost, double build_rows, double probe_cost, double probe_rows);
+
+  /**
+   * @brief 索引连接：外表的每一行在内表的索引上查找一次
+   * @param lookup_cost 在内表上做一次索引查找(包括回表)的代价
+   */
+  static double index_join(double outer_cost, double outer_rows, double lookup_cost);
+
+  static double sort(double child_cost, double rows);
+
+  /**
+   * @brief 只保留前 limit 行的排序：用 limit 个元素的堆过滤所有的输入，每行最多比较 log2(limit) 次
+   */
+  static double top_n(double child_cost, double rows, double limit);
+
+  static double aggregate(double child_cost, double rows, int aggregate_num);
+
+private:
+  /**
+   * @brief 在索引上找到 index_rows 个索引项的代价，不包括回表
+   */
+  static double index_lookup(double index_rows);
+};
+
+/**
+ * @brief 基数估计
+ * @details 使用 ANALYZE 收集的统计信息(参考 TableStats)估计表的大小和过滤条件的选择率。
+ * 没有统计信息时根据数据文件的大小估计行数，选择率使用默认值
+ */
+class CardinalityEstimator
+{
+public:
+  static constexpr double DEFAULT_EQUAL_SELECTIVITY = 0.005;      ///< 不知道不同值个数时，等值条件的选择率
+  static constexpr double DEFAULT_RANGE_SELECTIVITY = 1.0 / 3.0;  ///< 没有直方图时，范围条件的选择率
+  static constexpr double DEFAULT_LIKE_SELECTIVITY  = 0.1;
+
+  static double table_rows(const Table *table);
+  static double table_pages(const Table *table);
+
+  /**
+   * @brief 估计过滤条件的选择率，也就是满足条件的行数占比
+   * @details 支持字段与常量的比较、字段之间的等值比较(连接条件)，以及它们的AND/OR组合。
+   * 其它的表达式当作无法估计，返回 DEFAULT_RANGE_SELECTIVITY
+   */
+  static double selectivity(Expression &expr);
+
+  /**
+   * @brief 估计 field comp value 的选择率
+   */
+  static double compare_selectivity(const Field &field, CompOp comp, const Value &value);
+
+private:
+  static const ColumnStats *column_stats(const Field &field);
+  static double             equal_selectivity(const Field &field);
+
+  /**
+   * @brief 根据直方图估计小于 value 的行数占比
+   */
+  static double less_than_fraction(const ColumnStats &stats, const Value &value);
+};
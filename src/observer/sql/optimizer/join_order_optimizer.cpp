@@ -0,0 +1,277 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+#include "common/log/log.h"
+#include "sql/expr/expression.h"
+#include "sql/optimizer/cost_model.h"
+#include "sql/optimizer/join_order_optimizer.h"
+#include "storage/table/table.h"
+
+using namespace std;
+
+namespace {
+
+bool is_subset(uint64_t set, uint64_t super_set) { return (set & ~super_set) == 0; }
+
+/**
+ * @brief 动态规划中每个子集的最优连接方式
+ */
+struct DpEntry
+{
+  bool     valid = false;
+  uint64_t left  = 0;  ///< 外表包含的表，叶子节点为0
+  uint64_t right = 0;
+  double   rows  = 0;
+  double   cost  = 0;
+};
+
+}  // namespace
+
+JoinOrderOptimizer::JoinOrderOptimizer(const vector<Table *> &tables, vector<unique_ptr<Expression>> &conjuncts)
+    : tables_(tables), conjuncts_(conjuncts)
+{
+  for (unique_ptr<Expression> &conjunct : conjuncts_) {
+    conjunct_tables_.push_back(tables_of(*conjunct));
+    selectivities_.push_back(CardinalityEstimator::selectivity(*conjunct));
+  }
+}
+
+uint64_t JoinOrderOptimizer::tables_of(Expression &expr) const
+{
+  switch (expr.type()) {
+    case ExprType::FIELD: {
+      const Table *table = static_cast<FieldExpr &>(expr).field().table();
+      for (size_t i = 0; i < tables_.size(); i++) {
+        if (tables_[i] == table) {
+          return uint64_t(1) << i;
+        }
+      }
+      return 0;
+    }
+    case ExprType::COMPARISON: {
+      auto &comparison = static_cast<ComparisonExpr &>(expr);
+      return tables_of(*comparison.left()) | tables_of(*comparison.right());
+    }
+    case ExprType::CONJUNCTION: {
+      uint64_t result = 0;
+      for (unique_ptr<Expression> &child : static_cast<ConjunctionExpr &>(expr).children()) {
+        result |= tables_of(*child);
+      }
+      return result;
+    }
+    default: return 0;
+  }
+}
+
+unique_ptr<JoinTreeNode> JoinOrderOptimizer::leaf(int table) const
+{
+  auto node    = make_unique<JoinTreeNode>();
+  node->table  = table;
+  node->tables = uint64_t(1) << table;
+
+  // 只引用这一张表的条件在扫描时过滤
+  Table *t             = tables_[table];
+  int    predicate_num = 0;
+  node->rows           = CardinalityEstimator::table_rows(t);
+  for (size_t i = 0; i < conjuncts_.size(); i++) {
+    if (conjunct_tables_[i] == node->tables) {
+      node->rows *= selectivities_[i];
+      predicate_num++;
+    }
+  }
+  node->rows = max(node->rows, 1.0);
+  node->cost = CostModel::table_scan(
+      CardinalityEstimator::table_pages(t), CardinalityEstimator::table_rows(t), predicate_num);
+  return node;
+}
+
+void JoinOrderOptimizer::estimate_join(
+    const JoinTreeNode &left, const JoinTreeNode &right, double &rows, double &cost) const
+{
+  // 连接之后的行数与连接顺序无关，只和两边的行数以及它们之间的条件有关
+  int predicate_num = 0;
+  rows              = left.rows * right.rows;
+  for (size_t i = 0; i < conjuncts_.size(); i++) {
+    const uint64_t tables = conjunct_tables_[i];
+    if ((tables & left.tables) != 0 && (tables & right.tables) != 0 && is_subset(tables, left.tables | right.tables)) {
+      rows *= selectivities_[i];
+      predicate_num++;
+    }
+  }
+  cost = CostModel::nested_loop_join(left.cost, left.rows, right.cost, right.rows) +
+         CostModel::CPU_OPERATOR_COST * predicate_num * left.rows * right.rows;
+  rows = max(rows, 1.0);
+}
+
+unique_ptr<JoinTreeNode> JoinOrderOptimizer::join(unique_ptr<JoinTreeNode> left, unique_ptr<JoinTreeNode> right) const
+{
+  auto node    = make_unique<JoinTreeNode>();
+  node->tables = left->tables | right->tables;
+  estimate_join(*left, *right, node->rows, node->cost);
+  node->left  = std::move(left);
+  node->right = std::move(right);
+  return node;
+}
+
+bool JoinOrderOptimizer::connected(uint64_t left, uint64_t right) const
+{
+  for (uint64_t tables : conjunct_tables_) {
+    if ((tables & left) != 0 && (tables & right) != 0 && is_subset(tables, left | right)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+unique_ptr<JoinTreeNode> JoinOrderOptimizer::from_order() const
+{
+  unique_ptr<JoinTreeNode> result;
+  for (int i = 0; i < static_cast<int>(tables_.size()); i++) {
+    result = result ? join(std::move(result), leaf(i)) : leaf(i);
+  }
+  return result;
+}
+
+unique_ptr<JoinTreeNode> JoinOrderOptimizer::optimize(int dp_threshold) const
+{
+  const int table_num = static_cast<int>(tables_.size());
+  if (table_num <= 1) {
+    return from_order();
+  }
+
+  unique_ptr<JoinTreeNode> result;
+  if (table_num <= min(dp_threshold, MAX_DP_TABLES)) {
+    result = dp(false /*allow_cross_product*/);
+    if (!result) {
+      // 连接图不连通，只能使用笛卡尔积
+      result = dp(true /*allow_cross_product*/);
+    }
+  } else {
+    result = greedy();
+  }
+
+  LOG_TRACE("join order optimized. tables=%d, rows=%f, cost=%f", table_num, result->rows, result->cost);
+  return result;
+}
+
+unique_ptr<JoinTreeNode> JoinOrderOptimizer::dp(bool allow_cross_product) const
+{
+  const int      table_num = static_cast<int>(tables_.size());
+  const uint64_t all       = (uint64_t(1) << table_num) - 1;
+
+  vector<DpEntry>                  best(all + 1);
+  vector<unique_ptr<JoinTreeNode>> leaves(table_num);
+  for (int i = 0; i < table_num; i++) {
+    leaves[i]      = leaf(i);
+    DpEntry &entry = best[uint64_t(1) << i];
+    entry.valid    = true;
+    entry.rows     = leaves[i]->rows;
+    entry.cost     = leaves[i]->cost;
+  }
+
+  // 子集按照数值从小到大处理，它的所有真子集都已经处理过了
+  JoinTreeNode left_node;
+  JoinTreeNode right_node;
+  for (uint64_t set = 1; set <= all; set++) {
+    if ((set & (set - 1)) == 0) {
+      continue;  // 只有一张表
+    }
+
+    DpEntry &entry = best[set];
+    for (uint64_t left = (set - 1) & set; left != 0; left = (left - 1) & set) {
+      const uint64_t right = set ^ left;
+      if (!best[left].valid || !best[right].valid) {
+        continue;
+      }
+      if (!allow_cross_product && !connected(left, right)) {
+        continue;
+      }
+
+      left_node.tables  = left;
+      left_node.rows    = best[left].rows;
+      left_node.cost    = best[left].cost;
+      right_node.tables = right;
+      right_node.rows   = best[right].rows;
+      right_node.cost   = best[right].cost;
+
+      double rows = 0;
+      double cost = 0;
+      estimate_join(left_node, right_node, rows, cost);
+      if (!entry.valid || cost < entry.cost) {
+        entry.valid = true;
+        entry.left  = left;
+        entry.right = right;
+        entry.rows  = rows;
+        entry.cost  = cost;
+      }
+    }
+  }
+
+  if (!best[all].valid) {
+    return nullptr;
+  }
+
+  // 从全集开始还原连接树
+  function<unique_ptr<JoinTreeNode>(uint64_t)> build = [&](uint64_t set) -> unique_ptr<JoinTreeNode> {
+    const DpEntry &entry = best[set];
+    if (entry.left == 0) {
+      return std::move(leaves[__builtin_ctzll(set)]);
+    }
+    return join(build(entry.left), build(entry.right));
+  };
+  return build(all);
+}
+
+unique_ptr<JoinTreeNode> JoinOrderOptimizer::greedy() const
+{
+  vector<unique_ptr<JoinTreeNode>> trees;
+  for (int i = 0; i < static_cast<int>(tables_.size()); i++) {
+    trees.push_back(leaf(i));
+  }
+
+  // 每次合并代价最小的两棵树，有连接条件的优先
+  while (trees.size() > 1) {
+    size_t best_left      = 0;
+    size_t best_right     = 0;
+    bool   best_connected = false;
+    double best_cost      = numeric_limits<double>::max();
+    for (size_t i = 0; i < trees.size(); i++) {
+      for (size_t j = 0; j < trees.size(); j++) {
+        if (i == j) {
+          continue;
+        }
+        const bool is_connected = connected(trees[i]->tables, trees[j]->tables);
+        if (best_connected && !is_connected) {
+          continue;
+        }
+
+        double rows = 0;
+        double cost = 0;
+        estimate_join(*trees[i], *trees[j], rows, cost);
+        if ((is_connected && !best_connected) || cost < best_cost) {
+          best_left      = i;
+          best_right     = j;
+          best_connected = is_connected;
+          best_cost      = cost;
+        }
+      }
+    }
+
+    unique_ptr<JoinTreeNode> node = join(std::move(trees[best_left]), std::move(trees[best_right]));
+    trees.erase(trees.begin() + max(best_left, best_right));
+    trees.erase(trees.begin() + min(best_left, best_right));
+    trees.push_back(std::move(node));
+  }
+  return std::move(trees.front());
+}
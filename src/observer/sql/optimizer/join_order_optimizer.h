@@ -0,0 +1,96 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+class Expression;
+class Table;
+
+/**
+ * @brief 连接树的节点
+ * @details 叶子节点对应一张表；内部节点是左右两棵子树的嵌套循环连接，左边是外表
+ */
+struct JoinTreeNode
+{
+  int                           table = -1;  ///< 叶子节点对应的表在 tables 中的下标，内部节点是-1
+  std::unique_ptr<JoinTreeNode> left;
+  std::unique_ptr<JoinTreeNode> right;
+
+  uint64_t tables = 0;  ///< 这棵子树包含的表，每张表一位
+  double   rows   = 0;  ///< 估计的输出行数
+  double   cost   = 0;  ///< 估计的总代价
+};
+
+/**
+ * @brief 连接顺序优化
+ * @ingroup LogicalOperator
+ * @details 把 FROM 中的表和 WHERE 中的条件看作一张连接图：表是顶点，同时引用两张表的条件是边。
+ * 表的个数不超过 dp_threshold 时使用动态规划(DPsub)枚举连接图中所有不包含笛卡尔积的连接树，
+ * 包括 bushy 树，找到代价最小的一个；表太多时使用贪心算法，每次合并代价最小的两棵子树。
+ * 连接图不连通时才会出现笛卡尔积。
+ * 行数和代价使用 CardinalityEstimator 和 CostModel 估计，连接方式按照嵌套循环连接计算。
+ */
+class JoinOrderOptimizer
+{
+public:
+  static constexpr int MAX_TABLES    = 64;  ///< 每张表占 uint64_t 中的一位
+  static constexpr int MAX_DP_TABLES = 12;  ///< 动态规划需要枚举 3^n 个子集对，表再多就太慢了
+
+  /**
+   * @param tables    参与连接的表，不能超过 MAX_TABLES 个
+   * @param conjuncts WHERE 中用 AND 连接的各个条件
+   */
+  JoinOrderOptimizer(const std::vector<Table *> &tables, std::vector<std::unique_ptr<Expression>> &conjuncts);
+
+  /**
+   * @brief 按照FROM子句中的顺序生成左深树
+   */
+  std::unique_ptr<JoinTreeNode> from_order() const;
+
+  /**
+   * @brief 生成代价最小的连接树
+   * @param dp_threshold 表的个数超过这个值时使用贪心算法
+   */
+  std::unique_ptr<JoinTreeNode> optimize(int dp_threshold) const;
+
+  /**
+   * @brief 条件引用了哪些表，每张表一位。不引用任何表的条件返回0
+   */
+  uint64_t tables_of(size_t conjunct) const { return conjunct_tables_[conjunct]; }
+
+private:
+  uint64_t tables_of(Expression &expr) const;
+
+  std::unique_ptr<JoinTreeNode> leaf(int table) const;
+  std::unique_ptr<JoinTreeNode> join(std::unique_ptr<JoinTreeNode> left, std::unique_ptr<JoinTreeNode> right) const;
+
+  /**
+   * @brief left 和 right 之间是否有连接条件
+   */
+  bool connected(uint64_t left, uint64_t right) const;
+
+  /**
+   * @brief 估计 left 和 right 连接之后的行数和代价，左边是外表
+   */
+  void estimate_join(const JoinTreeNode &left, const JoinTreeNode &right, double &rows, double &cost) const;
+
+  std::unique_ptr<JoinTreeNode> dp(bool allow_cross_product) const;
+  std::unique_ptr<JoinTreeNode> greedy() const;
+
+private:
+  const std::vector<Table *>               &tables_;
+  std::vector<std::unique_ptr<Expression>> &conjuncts_;
+  std::vector<uint64_t>                     conjunct_tables_;
+  std::vector<double>                       selectivities_;
+};
@@ -0,0 +1,56 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+#include <algorithm>
+#include <limits>
+
+#include "sql/optimizer/limit_pushdown_rewriter.h"
+#include "common/log/log.h"
+#include "sql/operator/limit_logical_operator.h"
+#include "sql/operator/orderby_logical_operator.h"
+
+using namespace std;
+
+RC LimitPushdownRewriter::rewrite(unique_ptr<LogicalOperator> &oper, bool &change_made)
+{
+  if (oper->type() != LogicalOperatorType::LIMIT || oper->children().size() != 1) {
+    return RC::SUCCESS;
+  }
+
+  auto                        &limit_oper = static_cast<LimitLogicalOperator &>(*oper);
+  unique_ptr<LogicalOperator> &child      = oper->children().front();
+  switch (child->type()) {
+    case LogicalOperatorType::PROJECTION: {
+      // 聚合查询的 LIMIT 在创建 SelectStmt 时已经去掉了，这里的投影不会改变行数
+      if (child->children().size() != 1) {
+        break;
+      }
+      unique_ptr<LogicalOperator> project_oper = std::move(child);
+      child                                    = std::move(project_oper->children().front());
+      project_oper->children().front()         = std::move(oper);
+      oper                                     = std::move(project_oper);
+      change_made                              = true;
+      LOG_TRACE("pushdown limit under projection");
+    } break;
+
+    case LogicalOperatorType::ORDER_BY: {
+      auto         &order_oper = static_cast<OrderLogicalOperator &>(*child);
+      const int64_t rows       = static_cast<int64_t>(limit_oper.limit()) + limit_oper.offset();
+      const int     top_n      = static_cast<int>(std::min<int64_t>(rows, numeric_limits<int>::max()));
+      if (order_oper.limit() != top_n) {
+        order_oper.set_limit(top_n);
+        change_made = true;
+        LOG_TRACE("pushdown limit to order by. top n=%d", top_n);
+      }
+    } break;
+
+    default: break;
+  }
+  return RC::SUCCESS;
+}
@@ -0,0 +1,28 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+#pragma once
+
+#include "sql/optimizer/rewrite_rule.h"
+
+/**
+ * @brief 把 LIMIT 推到投影的下面，并告诉排序算子只需要前几行
+ * @ingroup Rewriter
+ * @details 投影不改变行数，LIMIT 可以放到投影的下面，取够了行之后投影也不用再处理剩下的数据。
+ * LIMIT 下面是排序时，排序算子只需要保留前 limit + offset 行，可以用一个小堆代替完整的排序。
+ * 生成物理计划时还可能直接按照索引的顺序扫描，参考 PhysicalPlanGenerator
+ */
+class LimitPushdownRewriter : public RewriteRule
+{
+public:
+  LimitPushdownRewriter()          = default;
+  virtual ~LimitPushdownRewriter() = default;
+
+  RC rewrite(std::unique_ptr<LogicalOperator> &oper, bool &change_made) override;
+};
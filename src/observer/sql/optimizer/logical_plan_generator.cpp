@@ -14,15 +14,19 @@ See the Mulan PSL v2 for more details. */
 
 #include "sql/optimizer/logical_plan_generator.h"
 
+#include <algorithm>
+#include <functional>
+
 #include <common/log/log.h>
 
-#include "sql/optimizer/optimization_join_logical_rewriter.h"
+#include "sql/optimizer/join_order_optimizer.h"
 #include "sql/operator/calc_logical_operator.h"
 #include "sql/operator/delete_logical_operator.h"
 #include "sql/operator/explain_logical_operator.h"
 #include "sql/operator/insert_logical_operator.h"
 #include "sql/operator/update_logical_operator.h"
 #include "sql/operator/join_logical_operator.h"
+#include "sql/operator/limit_logical_operator.h"
 #include "sql/operator/logical_operator.h"
 #include "sql/operator/predicate_logical_operator.h"
 #include "sql/operator/project_logical_operator.h"
@@ -42,6 +46,57 @@ See the Mulan PSL v2 for more details. */
 
 using namespace std;
 
+namespace {
+
+/**
+ * @brief 把过滤条件中的每一项转换成比较表达式，它们之间是 AND 的关系。子查询由 create_subquery_exprs 处理
+ */
+void create_comparison_exprs(FilterStmt *filter_stmt, std::vector<unique_ptr<Expression>> &cmp_exprs)
+{
+  const std::vector<FilterUnit *> &filter_units = filter_stmt->filter_units();
+  for (const FilterUnit *filter_unit : filter_units) {  // 将每一个谓词过滤操作构建成比较表达式
+    if (filter_unit->sub_select() != nullptr) {
+      continue;
+    }
+
+    const FilterObj &filter_obj_left  = filter_unit->left();
+    const FilterObj &filter_obj_right = filter_unit->right();
+
+    unique_ptr<Expression> left(filter_obj_left.is_attr
+                                    ? static_cast<Expression *>(new FieldExpr(filter_obj_left.field))
+                                    : static_cast<Expression *>(new ValueExpr(filter_obj_left.value)));
+
+    unique_ptr<Expression> right(filter_obj_right.is_attr
+                                     ? static_cast<Expression *>(new FieldExpr(filter_obj_right.field))
+                                     : static_cast<Expression *>(new ValueExpr(filter_obj_right.value)));
+
+    ComparisonExpr *cmp_expr = new ComparisonExpr(filter_unit->comp(), std::move(left), std::move(right));
+    cmp_exprs.emplace_back(cmp_expr);
+  }
+}
+
+/**
+ * @brief 把满足 pick 的条件从 conjuncts 中拿出来，生成一个谓词算子。没有满足的条件时返回空
+ */
+unique_ptr<LogicalOperator> create_predicate(
+    std::vector<unique_ptr<Expression>> &conjuncts, const std::function<bool(size_t)> &pick)
+{
+  std::vector<unique_ptr<Expression>> picked;
+  for (size_t i = 0; i < conjuncts.size(); i++) {
+    if (conjuncts[i] && pick(i)) {
+      picked.emplace_back(std::move(conjuncts[i]));
+    }
+  }
+  if (picked.empty()) {
+    return nullptr;
+  }
+
+  unique_ptr<ConjunctionExpr> conjunction_expr(new ConjunctionExpr(ConjunctionExpr::Type::AND, picked));
+  return unique_ptr<LogicalOperator>(new PredicateLogicalOperator(std::move(conjunction_expr)));
+}
+
+}  // namespace
+
 RC LogicalPlanGenerator::create(Stmt *stmt, unique_ptr<LogicalOperator> &logical_operator, SQLStageEvent *sql_event)
 {
   RC rc = RC::SUCCESS;
@@ -102,185 +157,51 @@ RC LogicalPlanGenerator::create_plan(CalcStmt *calc_stmt, std::unique_ptr<Logica
   return RC::SUCCESS;
 }
 
-// 用于Analyze之后进行优化连接操作
-RC LogicalPlanGenerator::create_tables(SQLStageEvent *sql_event, std::vector<Table *> tables)
-{
-  RC rc = RC::SUCCESS;
-  // 根据session_event 找到session 再找到当前的数据库
-  const char   *zhifang       = "relstatistics";
-  SessionEvent *session_event = sql_event->session_event();
-  Db           *db            = session_event->session()->get_current_db();
-  Table        *relstatistics = db->find_table(zhifang);
-
-  RowTuple          tuple_;
-  bool              readonly_ = false;
-  RecordFileScanner record_scanner_;
-  Record            current_record_;
-  Trx              *trx = session_event->session()->current_trx();
-
-  rc = relstatistics->get_record_scanner(record_scanner_, trx, readonly_);
-  if (rc == RC::SUCCESS) {
-    tuple_.set_schema(relstatistics, relstatistics->table_meta().field_metas());
-  }
-
-  bool                            filter_result = true;
-  bool                            flag          = false;  // if it is analyzed
-  std::vector<std::vector<Value>> name_record;
-  while (record_scanner_.has_next()) {
-    rc = record_scanner_.next(current_record_);
-    if (rc != RC::SUCCESS) {
-      return rc;
-    } else {
-      flag = true;
-    }
-
-    tuple_.set_record(&current_record_);
-
-    int                cell_num = tuple_.cell_num();
-    Value              table_name;
-    Value              record_num;
-    std::vector<Value> a;
-
-    rc = tuple_.cell_at(0, table_name);
-    if (rc != RC::SUCCESS) {
-      return rc;
-    }
-    rc = tuple_.cell_at(4, record_num);
-    if (rc != RC::SUCCESS) {
-      return rc;
-    }
-
-    a.push_back(table_name);
-    a.push_back(record_num);
-    name_record.push_back(a);
-
-    if (filter_result) {
-      sql_debug("get a tuple: !!!!!!!!!!!!!!!%s", tuple_.to_string().c_str());
-      break;
-    } else {
-      sql_debug("a tuple is filtered: !!!!!!!!!!!! %s", tuple_.to_string().c_str());
-      rc = RC::RECORD_EOF;
-    }
-  }
-
-  // if the table is analyzed
-  if (flag) {
-    int k = -1, j = -1;
-    for (int i = 0; i < tables.size(); i++) {
-      string p = tables[i]->name();
-      if (0 == strcmp("Book", tables[i]->name())) {
-        tables[i]->set_cost(90001);
-        k = i;
-      }
-      if (0 == strcmp("Customer", tables[i]->name())) {
-        tables[i]->set_cost(15000);
-      }
-      if (0 == strcmp("Orders", tables[i]->name())) {
-        tables[i]->set_cost(100000);
-      }
-      if (0 == strcmp("Publisher", tables[i]->name())) {
-        tables[i]->set_cost(5000);
-        j = i;
-      }
-
-      LOG_TRACE("TABLE????!!!!!!!!:%s", tables[i]->name());
-    }
-
-    if (k < tables.size() && j < tables.size() && k >= 0 && j >= 0) {
-      LOG_TRACE("TABLE????!!!!!!!!????? %d, %d",k ,j);
-      Table *temp = tables[k];
-      tables[k]   = tables[j];
-      tables[j]   = temp;
-    }
-  }
-  return rc;
-}
 // 生成select类型逻辑
 RC LogicalPlanGenerator::create_plan(
     SelectStmt *select_stmt, unique_ptr<LogicalOperator> &logical_operator, SQLStageEvent *sql_event)
 {
-  RC                          rc = RC::SUCCESS;
-  unique_ptr<LogicalOperator> table_oper(nullptr);
+  RC rc = RC::SUCCESS;
   // smt获取表 + 列
   const std::vector<Table *> &tables     = select_stmt->tables();
   const std::vector<Field>   &all_fields = select_stmt->query_fields();
 
-  std::vector<Table *> tablec;
-  for (Table *table : tables) {
-    Table *s = table;
-    tablec.push_back(s);
-  }
-  // rc = create_tables(sql_event, tablec);
-
-  const char   *zhifang       = "relstatistics";
-  SessionEvent *session_event = sql_event->session_event();
-  Db           *db            = session_event->session()->get_current_db();
-  Table        *relstatistics = db->find_table(zhifang);
-  bool          flag          = false;
-  if (relstatistics != nullptr) {
-    RowTuple          tuple_;
-    bool              readonly_ = false;
-    RecordFileScanner record_scanner_;
-    Record            current_record_;
-    Trx              *trx = session_event->session()->current_trx();
-
-    rc = relstatistics->get_record_scanner(record_scanner_, trx, readonly_);
-    if (rc == RC::SUCCESS) {
-      tuple_.set_schema(relstatistics, relstatistics->table_meta().field_metas());
-    }
-
-    bool                            filter_result = true;
-    std::vector<std::vector<Value>> name_record;
-    while (record_scanner_.has_next()) {
-      rc = record_scanner_.next(current_record_);
-      if (rc != RC::SUCCESS) {
-        return rc;
-      } else {
-        flag = true;
-      }
-    }
+  if (tables.size() > JoinOrderOptimizer::MAX_TABLES) {
+    LOG_WARN("too many tables to join. table num=%d", tables.size());
+    return RC::INVALID_ARGUMENT;
   }
 
-  if (flag) {
-    for (auto current_table : tablec) {
-      calculate_cost(current_table);
-    }
-
-    if (set_table_optimization(tablec) != RC::SUCCESS) {
-      LOG_DEBUG("Error when set_table_optimization");
-    }
+  // WHERE 中的每个条件放到引用的表都已经连接上的最低的节点上
+  std::vector<unique_ptr<Expression>> conjuncts;
+  create_comparison_exprs(select_stmt->filter_stmt(), conjuncts);
+
+  // 所有的表都有统计信息时才按照代价调整连接顺序，否则保持FROM子句中的顺序
+  JoinOrderOptimizer       join_optimizer(tables, conjuncts);
+  unique_ptr<JoinTreeNode> join_tree;
+  const bool               analyzed = std::all_of(tables.begin(), tables.end(), [](Table *table) {
+    return table->stats()->analyzed();
+  });
+  if (analyzed) {
+    join_tree = join_optimizer.optimize(sql_event->session_event()->session()->join_dp_threshold());
+  } else {
+    join_tree = join_optimizer.from_order();
   }
 
-  for (Table *table : tablec) {  // 将所有表遍历连接
-    LOG_TRACE("TABLE????!!!!!!!!:%s", table->name());
-    std::vector<Field> fields;
-    for (const Field &field : all_fields) {
-      if (0 == strcmp(field.table_name(), table->name())) {
-        fields.push_back(field);
-      }
-    }
-
-    // 获取遍历table用的逻辑算子
-    unique_ptr<LogicalOperator> table_get_oper(new TableGetLogicalOperator(table, fields, true /*readonly*/));
-    if (table_oper == nullptr) {
-      table_oper = std::move(table_get_oper);
-    } else {
-      // 构建查询计划
-      JoinLogicalOperator *join_oper = new JoinLogicalOperator;
-      join_oper->add_child(std::move(table_oper));
-      join_oper->add_child(std::move(table_get_oper));
-      table_oper = unique_ptr<LogicalOperator>(join_oper);
+  unique_ptr<LogicalOperator> table_oper;
+  if (join_tree) {
+    rc = create_plan(*join_tree, tables, all_fields, join_optimizer, conjuncts, table_oper);
+    if (rc != RC::SUCCESS) {
+      LOG_WARN("failed to create join logical plan. rc=%s", strrc(rc));
+      return rc;
     }
   }
 
-  // 谓词与投影操作
-  unique_ptr<LogicalOperator> predicate_oper;
-
-  rc = create_plan(select_stmt->filter_stmt(), predicate_oper);  // 谓词过滤
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to create predicate logical plan. rc=%s", strrc(rc));
+  // 剩下的是不引用任何表的条件。子查询放在连接树的上面，由 SubqueryRewriter 改写成半连接或者反连接
+  rc = create_subquery_exprs(select_stmt->filter_stmt(), conjuncts, sql_event);
+  if (OB_FAIL(rc)) {
     return rc;
   }
+  unique_ptr<LogicalOperator> predicate_oper = create_predicate(conjuncts, [](size_t) { return true; });
 
   unique_ptr<LogicalOperator> orderby_oper;
   rc = create_plan(select_stmt->order_by_stmt(), orderby_oper);
@@ -305,10 +226,16 @@ RC LogicalPlanGenerator::create_plan(
   if (orderby_oper) {
     orderby_oper->add_child(std::move(project_oper));
     logical_operator.swap(orderby_oper);
-    return RC::SUCCESS;
+  } else {
+    logical_operator.swap(project_oper);
   }
 
-  logical_operator.swap(project_oper);
+  // LIMIT 作用在最终的结果上，由 LimitPushdownRewriter 再往下推
+  if (select_stmt->limit() >= 0) {
+    unique_ptr<LogicalOperator> limit_oper(new LimitLogicalOperator(select_stmt->limit(), select_stmt->offset()));
+    limit_oper->add_child(std::move(logical_operator));
+    logical_operator.swap(limit_oper);
+  }
   return RC::SUCCESS;
 }
 
@@ -327,60 +254,94 @@ RC LogicalPlanGenerator::create_plan(OrderByStmt *order_by_stmt, std::unique_ptr
   return RC::SUCCESS;
 }
 
-// 构建select逻辑查询计划 filter
-RC LogicalPlanGenerator::create_plan(FilterStmt *filter_stmt, unique_ptr<LogicalOperator> &logical_operator)
+RC LogicalPlanGenerator::create_plan(JoinTreeNode &join_tree, const std::vector<Table *> &tables,
+    const std::vector<Field> &all_fields, const JoinOrderOptimizer &join_optimizer,
+    std::vector<unique_ptr<Expression>> &conjuncts, unique_ptr<LogicalOperator> &logical_operator)
 {
-  std::vector<unique_ptr<Expression>> cmp_exprs;
-  const std::vector<FilterUnit *>    &filter_units = filter_stmt->filter_units();
-  for (const FilterUnit *filter_unit : filter_units) {  // 将每一个谓词过滤操作构建成比较表达式
-    const FilterObj &filter_obj_left  = filter_unit->left();
-    const FilterObj &filter_obj_right = filter_unit->right();
-
-    unique_ptr<Expression> left(filter_obj_left.is_attr
-                                    ? static_cast<Expression *>(new FieldExpr(filter_obj_left.field))
-                                    : static_cast<Expression *>(new ValueExpr(filter_obj_left.value)));
+  RC rc = RC::SUCCESS;
+  if (join_tree.table >= 0) {
+    Table             *table = tables[join_tree.table];
+    std::vector<Field> fields;
+    for (const Field &field : all_fields) {
+      if (0 == strcmp(field.table_name(), table->name())) {
+        fields.push_back(field);
+      }
+    }
 
-    unique_ptr<Expression> right(filter_obj_right.is_attr
-                                     ? static_cast<Expression *>(new FieldExpr(filter_obj_right.field))
-                                     : static_cast<Expression *>(new ValueExpr(filter_obj_right.value)));
+    // 获取遍历table用的逻辑算子
+    logical_operator.reset(new TableGetLogicalOperator(table, fields, true /*readonly*/));
+  } else {
+    unique_ptr<LogicalOperator> left_oper;
+    unique_ptr<LogicalOperator> right_oper;
+    rc = create_plan(*join_tree.left, tables, all_fields, join_optimizer, conjuncts, left_oper);
+    if (OB_SUCC(rc)) {
+      rc = create_plan(*join_tree.right, tables, all_fields, join_optimizer, conjuncts, right_oper);
+    }
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
 
-    ComparisonExpr *cmp_expr = new ComparisonExpr(filter_unit->comp(), std::move(left), std::move(right));
-    cmp_exprs.emplace_back(cmp_expr);
+    JoinLogicalOperator *join_oper = new JoinLogicalOperator;
+    join_oper->add_child(std::move(left_oper));
+    join_oper->add_child(std::move(right_oper));
+    logical_operator.reset(join_oper);
   }
 
-  unique_ptr<PredicateLogicalOperator> predicate_oper;
-  if (!cmp_exprs.empty()) {
-    unique_ptr<ConjunctionExpr> conjunction_expr(new ConjunctionExpr(ConjunctionExpr::Type::AND, cmp_exprs));
-    predicate_oper = unique_ptr<PredicateLogicalOperator>(new PredicateLogicalOperator(std::move(conjunction_expr)));
+  // 子树已经拿走了它们能计算的条件，剩下的引用的表都在这棵树中的条件就在这里计算。
+  // 只引用一张表的条件会由 PredicatePushdownRewriter 继续下推到扫描算子中
+  unique_ptr<LogicalOperator> predicate_oper = create_predicate(conjuncts, [&](size_t i) {
+    const uint64_t conjunct_tables = join_optimizer.tables_of(i);
+    return conjunct_tables != 0 && (conjunct_tables & ~join_tree.tables) == 0;
+  });
+  if (predicate_oper) {
+    predicate_oper->add_child(std::move(logical_operator));
+    logical_operator = std::move(predicate_oper);
   }
-
-  logical_operator = std::move(predicate_oper);
-  return RC::SUCCESS;
+  return rc;
 }
 
-RC LogicalPlanGenerator::create_plan(AnalyzeStmt *analyze_stmt, unique_ptr<LogicalOperator> &logical_operator)
+RC LogicalPlanGenerator::create_subquery_exprs(
+    FilterStmt *filter_stmt, std::vector<unique_ptr<Expression>> &subquery_exprs, SQLStageEvent *sql_event)
 {
-  Table               *analyze_table = analyze_stmt->analyze_table();
-  Table               *table         = analyze_stmt->table();
-  std::vector<Field *> query_fields  = analyze_stmt->query_fields();
+  for (const FilterUnit *filter_unit : filter_stmt->filter_units()) {
+    SelectStmt *sub_select = filter_unit->sub_select();
+    if (sub_select == nullptr) {
+      continue;
+    }
 
-  // 将vector<Field *> 转换为vector<Field> 用于获取表列
-  std::vector<Field> fields;
-  for (auto field_ptr : analyze_stmt->query_fields()) {
-    fields.push_back(*field_ptr);  // 将指针指向的 Field 对象添加到 vector 中
-  }
-  // 指针得到从表中获取数据的算子
-  unique_ptr<LogicalOperator> table_get_oper(new TableGetLogicalOperator(table, fields, true /*readonly*/));
-  unique_ptr<LogicalOperator> analyze_oper(new AnalyzeLogicalOperator(analyze_table, table, query_fields));
+    unique_ptr<LogicalOperator> subquery_oper;
+    RC                          rc = create_plan(sub_select, subquery_oper, sql_event);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to create subquery logical plan. rc=%s", strrc(rc));
+      return rc;
+    }
 
-  analyze_oper->add_child(std::move(table_get_oper));
+    unique_ptr<Expression> left;
+    unique_ptr<Expression> right;
+    if (filter_unit->comp() == IN_OP || filter_unit->comp() == NOT_IN_OP) {
+      left.reset(new FieldExpr(filter_unit->left().field));
+      right.reset(new FieldExpr(sub_select->query_fields().front()));
+    }
+    subquery_exprs.emplace_back(
+        new SubqueryExpr(filter_unit->comp(), std::move(left), std::move(right), std::move(subquery_oper)));
+  }
+  return RC::SUCCESS;
+}
 
-  logical_operator = std::move(analyze_oper);
+// 构建select逻辑查询计划 filter
+RC LogicalPlanGenerator::create_plan(FilterStmt *filter_stmt, unique_ptr<LogicalOperator> &logical_operator)
+{
+  std::vector<unique_ptr<Expression>> cmp_exprs;
+  create_comparison_exprs(filter_stmt, cmp_exprs);
 
-  LOG_DEBUG("[[[[[[[[[here]]]]]]]]]");
+  logical_operator = create_predicate(cmp_exprs, [](size_t) { return true; });
+  return RC::SUCCESS;
+}
 
-  // AnalyzeLogicalOperator *analyze_operator = new AnalyzeLogicalOperator(analyze_table, table, query_fields);
-  // logical_operator.reset(analyze_oper);
+RC LogicalPlanGenerator::create_plan(AnalyzeStmt *analyze_stmt, unique_ptr<LogicalOperator> &logical_operator)
+{
+  // ANALYZE 自己按页面采样读取数据，不需要下层的扫描算子
+  logical_operator.reset(new AnalyzeLogicalOperator(analyze_stmt->table(), analyze_stmt->query_fields()));
   return RC::SUCCESS;
 }
 
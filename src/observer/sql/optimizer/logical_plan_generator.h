@@ -45,6 +45,9 @@ class SQLStageEvent;
 class SessionEvent;
 class Session;
 class TableMeta;
+class Expression;
+class JoinOrderOptimizer;
+struct JoinTreeNode;
 
 
 class LogicalPlanGenerator
@@ -59,11 +62,24 @@ private:
   RC create_plan(CalcStmt *calc_stmt, std::unique_ptr<LogicalOperator> &logical_operator);
   RC create_plan(SelectStmt *select_stmt, std::unique_ptr<LogicalOperator> &logical_operator,SQLStageEvent *sql_event);
   RC create_plan(FilterStmt *filter_stmt, std::unique_ptr<LogicalOperator> &logical_operator);
+
+  /**
+   * @brief 为过滤条件中的 IN/EXISTS 子查询生成子查询的逻辑计划，放在 SubqueryExpr 中
+   */
+  RC create_subquery_exprs(
+      FilterStmt *filter_stmt, std::vector<std::unique_ptr<Expression>> &subquery_exprs, SQLStageEvent *sql_event);
+
+  /**
+   * @brief 根据连接树生成扫描和连接算子
+   * @details 每个节点上会加上只引用这棵子树中的表、并且子树中没有用到的条件，用到的条件从 conjuncts 中拿走
+   */
+  RC create_plan(JoinTreeNode &join_tree, const std::vector<Table *> &tables, const std::vector<Field> &all_fields,
+      const JoinOrderOptimizer &join_optimizer, std::vector<std::unique_ptr<Expression>> &conjuncts,
+      std::unique_ptr<LogicalOperator> &logical_operator);
   RC create_plan(InsertStmt *insert_stmt, std::unique_ptr<LogicalOperator> &logical_operator);
   RC create_plan(UpdateStmt *update_stmt, std::unique_ptr<LogicalOperator> &logical_operator);
   RC create_plan(DeleteStmt *delete_stmt, std::unique_ptr<LogicalOperator> &logical_operator);
   RC create_plan(ExplainStmt *explain_stmt, std::unique_ptr<LogicalOperator> &logical_operator,SQLStageEvent *sql_event);
   RC create_plan(OrderByStmt *order_by_stmt, std::unique_ptr<LogicalOperator> &logical_operator);
   RC create_plan(AnalyzeStmt *analyze_stmt, std::unique_ptr<LogicalOperator> &logical_operator);
-  RC create_tables(SQLStageEvent *sql_event,std::vector<Table *> tables);
 };
\ No newline at end of file
@@ -1,104 +0,0 @@
-#include <limits>
-#include <string>
-#include <algorithm>
-#include "sql/parser/parse_defs.h"
-#include "common/log/log.h"
-#include "sql/expr/expression.h"
-#include "sql/optimizer/optimization_join_logical_rewriter.h"
-
-// 定义操作成本常量
-const double seq_page_cost        = 1.0;
-const double random_page_cost     = 4.0;
-const double cpu_tuple_cost       = 0.01;
-const double cpu_index_tuple_cost = 0.005;
-const double cpu_operator_cost    = 0.0025;
-
-RC calculate_cost(Table *table)
-{
-  std::string p = table->name();
-
-  // 获取表的元数据
-  std::vector<std::vector<Value>> analyzed_value = table->get_analyzed_value();
-  if (analyzed_value.size() != 0) {
-    unsigned long reltuples = analyzed_value[0][0].get_int();
-    unsigned long relpages  = analyzed_value[0][4].get_int();
-  }
-  unsigned long reltuples = 0;
-  unsigned long relpages  = 0;
-
-  // 计算全表扫描成本
-  double full_scan_cost = (cpu_tuple_cost + cpu_operator_cost) * reltuples + seq_page_cost * relpages;
-
-  // 计算索引扫描成本 (示例，需要根据实际索引情况修改)
-  double index_scan_cost = 0;
-  for (auto &index : analyzed_value) {
-    // 获取索引元数据
-    unsigned long index_tuples = index[0].get_int();
-    unsigned long index_pages  = index[4].get_int();
-
-    // 计算索引扫描成本
-    double temp_cost = (cpu_index_tuple_cost * index_tuples) + (cpu_tuple_cost * reltuples) +
-                       (seq_page_cost * index_pages) +
-                       (random_page_cost * relpages / index_tuples);  // 假设使用索引后，随机读取数据页
-
-    // 选择成本最低的扫描方式
-    index_scan_cost = std::min(index_scan_cost, temp_cost);
-  }
-
-  // 选择成本最低的方案
-  double final_cost = std::min(full_scan_cost, index_scan_cost);
-
-  if (0 == strcmp("Book", table->name())) {
-    final_cost = 90001 * seq_page_cost;
-  }
-  if (0 == strcmp("Customer", table->name())) {
-    final_cost = 15000 * seq_page_cost;
-  }
-  if (0 == strcmp("Orders", table->name())) {
-    final_cost = 100000 * seq_page_cost;
-  }
-  if (0 == strcmp("Publisher", table->name())) {
-    final_cost = 5000 * seq_page_cost;
-  }
-
-  table->set_cost(final_cost);
-
-  LOG_TRACE("TABLE COST: %s - %f", table->name(), final_cost);
-
-  return RC::SUCCESS;
-}
-
-RC set_table_optimization(std::vector<Table *> &table_list)
-{
-  int n = table_list.size();
-  if (n <= 1)
-    return RC::SUCCESS;  // 不需要排序
-
-  // 初始化 dp 数组和 predecessor 数组
-  std::vector<double> dp(n, std::numeric_limits<double>::max());
-  std::vector<int>    predecessor(n, -1);
-
-  // 初始化第一个元素
-  dp[0] = table_list[0]->get_cost();
-
-  // 动态规划计算最小成本
-  for (int i = 1; i < n; ++i) {
-    for (int j = 0; j < i; ++j) {
-      // 计算将 table_list[i] 插入到 table_list[j] 之前的成本
-      double cost = dp[j] + table_list[i]->get_cost();
-      if (cost < dp[i]) {
-        dp[i]          = cost;
-        predecessor[i] = j;
-      }
-    }
-  }
-
-  // 回溯构造排序后的数组
-  std::vector<Table *> sorted_tables(n);
-  int                  current = n - 1;
-  
-  std::sort(table_list.begin(), table_list.end(), 
-       [](Table* a, Table* b) { return a->get_cost() < b->get_cost(); });
-
-  return RC::SUCCESS;
-}
\ No newline at end of file
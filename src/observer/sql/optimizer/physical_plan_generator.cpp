@@ -12,17 +12,22 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai on 2022/12/14.
 //
 
+#include <algorithm>
+#include <limits>
+#include <string.h>
 #include <utility>
 
 #include "sql/parser/parse_defs.h"
 #include "common/log/log.h"
 #include "sql/expr/expression.h"
+#include "sql/operator/bitmap_heap_scan_physical_operator.h"
 #include "sql/operator/calc_logical_operator.h"
 #include "sql/operator/calc_physical_operator.h"
 #include "sql/operator/delete_logical_operator.h"
 #include "sql/operator/delete_physical_operator.h"
 #include "sql/operator/explain_logical_operator.h"
 #include "sql/operator/explain_physical_operator.h"
+#include "sql/operator/hash_semi_join_physical_operator.h"
 #include "sql/operator/index_scan_physical_operator.h"
 #include "sql/operator/insert_logical_operator.h"
 #include "sql/operator/insert_physical_operator.h"
@@ -30,13 +35,18 @@ See the Mulan PSL v2 for more details. */
 #include "sql/operator/update_physical_operator.h"
 #include "sql/operator/join_logical_operator.h"
 #include "sql/operator/join_physical_operator.h"
+#include "sql/operator/limit_logical_operator.h"
+#include "sql/operator/limit_physical_operator.h"
 #include "sql/operator/predicate_logical_operator.h"
 #include "sql/operator/predicate_physical_operator.h"
 #include "sql/operator/project_logical_operator.h"
 #include "sql/operator/project_physical_operator.h"
+#include "sql/operator/semi_join_logical_operator.h"
 #include "sql/operator/table_get_logical_operator.h"
 #include "sql/operator/table_scan_physical_operator.h"
+#include "sql/optimizer/cost_model.h"
 #include "sql/optimizer/physical_plan_generator.h"
+#include "storage/index/index.h"
 #include "sql/operator/orderby_logical_operator.h"
 #include "sql/operator/orderby_physical_operator.h"
 #include "sql/operator/analyze_logical_operator.h"
@@ -74,6 +84,10 @@ RC PhysicalPlanGenerator::create(LogicalOperator &logical_operator, unique_ptr<P
       return create_plan(static_cast<OrderLogicalOperator &>(logical_operator), oper);
     }
 
+    case LogicalOperatorType::LIMIT: {
+      return create_plan(static_cast<LimitLogicalOperator &>(logical_operator), oper);
+    } break;
+
     case LogicalOperatorType::INSERT: {
       return create_plan(static_cast<InsertLogicalOperator &>(logical_operator), oper);
     } break;
@@ -94,6 +108,10 @@ RC PhysicalPlanGenerator::create(LogicalOperator &logical_operator, unique_ptr<P
       return create_plan(static_cast<JoinLogicalOperator &>(logical_operator), oper);
     } break;
 
+    case LogicalOperatorType::SEMI_JOIN: {
+      return create_plan(static_cast<SemiJoinLogicalOperator &>(logical_operator), oper);
+    } break;
+
     default: {
       return RC::INVALID_ARGUMENT;
     }
@@ -101,69 +119,604 @@ RC PhysicalPlanGenerator::create(LogicalOperator &logical_operator, unique_ptr<P
   return rc;
 }
 
+namespace {
+
+/**
+ * @brief 一个字段上可以交给索引处理的条件
+ */
+struct IndexCondition
+{
+  const Field *field           = nullptr;
+  Index       *index           = nullptr;
+  const Value *left_value      = nullptr;  ///< 没有下边界时为空
+  const Value *right_value     = nullptr;  ///< 没有上边界时为空
+  bool         left_inclusive  = false;
+  bool         right_inclusive = false;
+  bool         equal           = false;
+  double       estimated_rows  = 0;
+};
+
+/**
+ * @brief 把 field comp value 形式的条件合并到同一个字段的 IndexCondition 中
+ * @details 等值条件优先。同一边有多个范围条件时只取第一个，所有条件最后都会在扫描时重新检查
+ */
+void add_index_condition(vector<IndexCondition> &conditions, const Field &field, CompOp comp, const Value &value)
+{
+  // 值转换成字段类型时可能会丢失精度(比如浮点数转换成整数)，范围条件只处理类型相同的情况
+  if (comp != EQUAL_TO && value.attr_type() != field.attr_type()) {
+    return;
+  }
+
+  auto iter = std::find_if(conditions.begin(), conditions.end(), [&field](const IndexCondition &condition) {
+    return 0 == strcmp(condition.field->field_name(), field.field_name());
+  });
+  if (iter == conditions.end()) {
+    iter        = conditions.emplace(conditions.end());
+    iter->field = &field;
+  }
+
+  IndexCondition &condition = *iter;
+  if (condition.equal) {
+    return;
+  }
+
+  switch (comp) {
+    case EQUAL_TO: {
+      condition.equal           = true;
+      condition.left_value      = &value;
+      condition.right_value     = &value;
+      condition.left_inclusive  = true;
+      condition.right_inclusive = true;
+    } break;
+    case GREAT_THAN:
+    case GREAT_EQUAL: {
+      if (condition.left_value == nullptr) {
+        condition.left_value     = &value;
+        condition.left_inclusive = comp == GREAT_EQUAL;
+      }
+    } break;
+    case LESS_THAN:
+    case LESS_EQUAL: {
+      if (condition.right_value == nullptr) {
+        condition.right_value     = &value;
+        condition.right_inclusive = comp == LESS_EQUAL;
+      }
+    } break;
+    default: break;
+  }
+}
+
+/**
+ * @brief 根据统计信息估计索引条件匹配的记录数
+ */
+double estimate_index_rows(const IndexCondition &condition, const Value &left_value, const Value &right_value,
+    double table_rows)
+{
+  double selectivity = 1.0;
+  if (condition.equal) {
+    selectivity = CardinalityEstimator::compare_selectivity(*condition.field, EQUAL_TO, left_value);
+  } else {
+    // 两边都有边界时，范围内的比例 = 大于下边界的比例 + 小于上边界的比例 - 1
+    if (condition.left_value != nullptr) {
+      selectivity = CardinalityEstimator::compare_selectivity(
+          *condition.field, condition.left_inclusive ? GREAT_EQUAL : GREAT_THAN, left_value);
+    }
+    if (condition.right_value != nullptr) {
+      selectivity += CardinalityEstimator::compare_selectivity(
+                         *condition.field, condition.right_inclusive ? LESS_EQUAL : LESS_THAN, right_value) -
+                     1;
+    }
+  }
+  return table_rows * std::max(selectivity, 0.0);
+}
+
+/**
+ * @brief 估计索引条件匹配的记录数
+ * @details 表已经 ANALYZE 过时只使用统计信息和直方图估计，不访问索引。
+ * 没有统计信息时默认的选择率误差很大，查询语句先直接在索引上数，数到 limit 就停止，
+ * 匹配的记录很少时得到的是准确的值，代价也很小。修改数据的语句不在计划阶段访问索引
+ * @param probe 没有统计信息时是否可以在索引上数
+ */
+double estimate_index_rows(const IndexCondition &condition, int limit, double table_rows, bool probe)
+{
+  const AttrType field_type = condition.field->attr_type();
+
+  Value left_value;
+  Value right_value;
+  if (condition.left_value != nullptr) {
+    left_value = *condition.left_value;
+    Value::convert(left_value.attr_type(), field_type, left_value);
+  }
+  if (condition.right_value != nullptr) {
+    right_value = *condition.right_value;
+    Value::convert(right_value.attr_type(), field_type, right_value);
+  }
+
+  const double estimated_rows = estimate_index_rows(condition, left_value, right_value, table_rows);
+  if (!probe || condition.field->table()->stats()->analyzed()) {
+    return estimated_rows;
+  }
+
+  IndexScanner *index_scanner = condition.index->create_scanner(
+      condition.left_value != nullptr ? left_value.data() : nullptr,
+      condition.left_value != nullptr ? left_value.length() : 0,
+      condition.left_inclusive,
+      condition.right_value != nullptr ? right_value.data() : nullptr,
+      condition.right_value != nullptr ? right_value.length() : 0,
+      condition.right_inclusive);
+  if (nullptr == index_scanner) {
+    return estimated_rows;
+  }
+
+  int rows = 0;
+  RID rid;
+  while (rows < limit && RC::SUCCESS == index_scanner->next_entry(&rid)) {
+    rows++;
+  }
+  index_scanner->destroy();
+  if (rows < limit) {
+    return rows;
+  }
+  return std::max<double>(limit, estimated_rows);
+}
+
+/**
+ * @brief 判断是否是 field comp value 或者 value comp field 形式的条件
+ */
+bool is_field_condition(Expression &expr, const Field &field)
+{
+  if (expr.type() != ExprType::COMPARISON) {
+    return false;
+  }
+  auto       &comparison = static_cast<ComparisonExpr &>(expr);
+  Expression *left       = comparison.left().get();
+  Expression *right      = comparison.right().get();
+  Expression *field_expr = nullptr;
+  if (left->type() == ExprType::FIELD && right->type() == ExprType::VALUE) {
+    field_expr = left;
+  } else if (left->type() == ExprType::VALUE && right->type() == ExprType::FIELD) {
+    field_expr = right;
+  }
+  return field_expr != nullptr &&
+         0 == strcmp(static_cast<FieldExpr *>(field_expr)->field().field_name(), field.field_name());
+}
+
+/**
+ * @brief 估计的行数至少是1，与 PostgreSQL 一样，避免后面的计算中出现0
+ */
+double clamp_rows(double rows) { return std::max(rows, 1.0); }
+
+/**
+ * @brief 在子树中找到扫描这张表的算子，只穿过过滤和连接算子
+ */
+PhysicalOperator *find_scan(PhysicalOperator &oper, const Table *table)
+{
+  switch (oper.type()) {
+    case PhysicalOperatorType::TABLE_SCAN: {
+      return static_cast<TableScanPhysicalOperator &>(oper).table() == table ? &oper : nullptr;
+    }
+    case PhysicalOperatorType::INDEX_SCAN: {
+      return static_cast<IndexScanPhysicalOperator &>(oper).table() == table ? &oper : nullptr;
+    }
+    case PhysicalOperatorType::BITMAP_HEAP_SCAN: {
+      return static_cast<BitmapHeapScanPhysicalOperator &>(oper).table() == table ? &oper : nullptr;
+    }
+    case PhysicalOperatorType::PREDICATE:
+    case PhysicalOperatorType::NESTED_LOOP_JOIN: {
+      for (unique_ptr<PhysicalOperator> &child : oper.children()) {
+        PhysicalOperator *scan = find_scan(*child, table);
+        if (scan != nullptr) {
+          return scan;
+        }
+      }
+      return nullptr;
+    }
+    default: return nullptr;
+  }
+}
+
+void add_runtime_filter(PhysicalOperator &scan, RuntimeFilter *filter)
+{
+  switch (scan.type()) {
+    case PhysicalOperatorType::TABLE_SCAN: {
+      static_cast<TableScanPhysicalOperator &>(scan).add_runtime_filter(filter);
+    } break;
+    case PhysicalOperatorType::INDEX_SCAN: {
+      static_cast<IndexScanPhysicalOperator &>(scan).add_runtime_filter(filter);
+    } break;
+    case PhysicalOperatorType::BITMAP_HEAP_SCAN: {
+      static_cast<BitmapHeapScanPhysicalOperator &>(scan).add_runtime_filter(filter);
+    } break;
+    default: break;
+  }
+}
+
+/**
+ * @brief 为连接条件中的等值条件生成运行时过滤器
+ * @details 右表(内表)的字段生成过滤器，左边子树中扫描另一个字段所在表的算子用它过滤。
+ * 当前的连接都是内连接，连接键在右表中不存在的记录不会出现在结果中，所以可以在扫描时直接丢掉
+ */
+void create_runtime_filters(Expression &expr, NestedLoopJoinPhysicalOperator &join_oper)
+{
+  if (expr.type() == ExprType::CONJUNCTION) {
+    auto &conjunction = static_cast<ConjunctionExpr &>(expr);
+    if (conjunction.conjunction_type() == ConjunctionExpr::Type::AND) {
+      for (unique_ptr<Expression> &child : conjunction.children()) {
+        create_runtime_filters(*child, join_oper);
+      }
+    }
+    return;
+  }
+
+  if (expr.type() != ExprType::COMPARISON) {
+    return;
+  }
+  auto &comparison = static_cast<ComparisonExpr &>(expr);
+  if (comparison.comp() != EQUAL_TO || comparison.left()->type() != ExprType::FIELD ||
+      comparison.right()->type() != ExprType::FIELD) {
+    return;
+  }
+
+  const Field *probe_field = &static_cast<FieldExpr &>(*comparison.left()).field();
+  const Field *build_field = &static_cast<FieldExpr &>(*comparison.right()).field();
+  PhysicalOperator &outer  = *join_oper.children()[0];
+  PhysicalOperator &inner  = *join_oper.children()[1];
+  if (find_scan(outer, probe_field->table()) == nullptr) {
+    std::swap(probe_field, build_field);
+  }
+
+  PhysicalOperator *probe_scan = find_scan(outer, probe_field->table());
+  if (probe_scan == nullptr || find_scan(inner, build_field->table()) == nullptr ||
+      !RuntimeFilter::supported(*probe_field, *build_field)) {
+    return;
+  }
+
+  auto filter = make_unique<RuntimeFilter>(*probe_field, *build_field);
+  add_runtime_filter(*probe_scan, filter.get());
+  LOG_TRACE("add runtime filter to join. filter=%s", filter->to_string().c_str());
+  join_oper.add_runtime_filter(std::move(filter));
+}
+
+void collect_tables(LogicalOperator &oper, vector<const Table *> &tables)
+{
+  if (oper.type() == LogicalOperatorType::TABLE_GET) {
+    tables.push_back(static_cast<TableGetLogicalOperator &>(oper).table());
+  }
+  for (unique_ptr<LogicalOperator> &child : oper.children()) {
+    collect_tables(*child, tables);
+  }
+}
+
+bool contains_table(const vector<const Table *> &tables, const Table *table)
+{
+  return std::find(tables.begin(), tables.end(), table) != tables.end();
+}
+
+/**
+ * @brief 收集表达式中引用的 tables 中的表的字段
+ */
+void collect_fields(Expression &expr, const vector<const Table *> &tables, vector<Field> &fields)
+{
+  switch (expr.type()) {
+    case ExprType::FIELD: {
+      const Field &field = static_cast<FieldExpr &>(expr).field();
+      if (contains_table(tables, field.table())) {
+        fields.push_back(field);
+      }
+    } break;
+    case ExprType::CAST: {
+      collect_fields(*static_cast<CastExpr &>(expr).child(), tables, fields);
+    } break;
+    case ExprType::COMPARISON: {
+      auto &comparison = static_cast<ComparisonExpr &>(expr);
+      collect_fields(*comparison.left(), tables, fields);
+      collect_fields(*comparison.right(), tables, fields);
+    } break;
+    case ExprType::CONJUNCTION: {
+      for (unique_ptr<Expression> &child : static_cast<ConjunctionExpr &>(expr).children()) {
+        collect_fields(*child, tables, fields);
+      }
+    } break;
+    case ExprType::ARITHMETIC: {
+      auto &arithmetic = static_cast<ArithmeticExpr &>(expr);
+      collect_fields(*arithmetic.left(), tables, fields);
+      if (arithmetic.right()) {
+        collect_fields(*arithmetic.right(), tables, fields);
+      }
+    } break;
+    default: break;
+  }
+}
+
+/**
+ * @brief 是否是可以用哈希表处理的等值连接条件：左右两边的字段分别来自连接的两边，类型相同并且可以按照字节比较
+ * @details 可以时把条件调整成左边的字段在 = 的左边
+ */
+bool to_hash_key(Expression &expr, const vector<const Table *> &probe_tables, const vector<const Table *> &build_tables)
+{
+  if (expr.type() != ExprType::COMPARISON) {
+    return false;
+  }
+  auto &comparison = static_cast<ComparisonExpr &>(expr);
+  if (comparison.comp() != EQUAL_TO || comparison.left()->type() != ExprType::FIELD ||
+      comparison.right()->type() != ExprType::FIELD) {
+    return false;
+  }
+
+  // 浮点数比较时有误差，不能按照字节比较
+  const Field   &left_field  = static_cast<FieldExpr &>(*comparison.left()).field();
+  const Field   &right_field = static_cast<FieldExpr &>(*comparison.right()).field();
+  const AttrType attr_type   = left_field.attr_type();
+  if (attr_type != right_field.attr_type() || (attr_type != INTS && attr_type != DATES && attr_type != CHARS)) {
+    return false;
+  }
+
+  if (contains_table(probe_tables, left_field.table()) && contains_table(build_tables, right_field.table())) {
+    return true;
+  }
+  if (contains_table(probe_tables, right_field.table()) && contains_table(build_tables, left_field.table())) {
+    std::swap(comparison.left(), comparison.right());
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief 找到排序算子下面扫描这张表的 TableGet，只穿过投影和过滤算子
+ */
+TableGetLogicalOperator *find_table_get(LogicalOperator &oper, const Table *table)
+{
+  switch (oper.type()) {
+    case LogicalOperatorType::TABLE_GET: {
+      auto &table_get_oper = static_cast<TableGetLogicalOperator &>(oper);
+      return table_get_oper.table() == table ? &table_get_oper : nullptr;
+    }
+    case LogicalOperatorType::PROJECTION:
+    case LogicalOperatorType::PREDICATE: {
+      return oper.children().size() == 1 ? find_table_get(*oper.children().front(), table) : nullptr;
+    }
+    default: return nullptr;
+  }
+}
+
+/**
+ * @brief 字段上可以按照顺序扫描的索引。只有 B+ 树索引的扫描是有序的
+ */
+Index *find_ordered_index(const Table *table, const char *field_name)
+{
+  Index *index = table->find_range_index_by_field(field_name);
+  if (index == nullptr || index->index_meta().type() != IndexType::BPLUS_TREE) {
+    return nullptr;
+  }
+  return index;
+}
+
+/**
+ * @brief 物理计划的输出是否已经按照这个字段排好了序
+ */
+bool provides_order(PhysicalOperator &oper, const OrderByUnit &unit)
+{
+  switch (oper.type()) {
+    case PhysicalOperatorType::INDEX_SCAN: {
+      auto &index_scan_oper = static_cast<IndexScanPhysicalOperator &>(oper);
+      return index_scan_oper.table() == unit.get_table() && index_scan_oper.reverse() != unit.get_asc() &&
+             index_scan_oper.index() == find_ordered_index(unit.get_table(), unit.get_fields()->name());
+    }
+    case PhysicalOperatorType::PROJECT:
+    case PhysicalOperatorType::PREDICATE: {
+      return oper.children().size() == 1 && provides_order(*oper.children().front(), unit);
+    }
+    default: return false;
+  }
+}
+
+}  // namespace
+
 RC PhysicalPlanGenerator::create_plan(TableGetLogicalOperator &table_get_oper, unique_ptr<PhysicalOperator> &oper)
 {
   vector<unique_ptr<Expression>> &predicates = table_get_oper.predicates();
   // 看看是否有可以用于索引查找的表达式
   Table *table = table_get_oper.table();
 
-  Index     *index      = nullptr;
-  ValueExpr *value_expr = nullptr;
+  const double table_rows  = CardinalityEstimator::table_rows(table);
+  const double table_pages = CardinalityEstimator::table_pages(table);
+
+  vector<IndexCondition> conditions;
   for (auto &expr : predicates) {
-    if (expr->type() == ExprType::COMPARISON) {
-      auto comparison_expr = static_cast<ComparisonExpr *>(expr.get());
-      // 简单处理，就找等值查询
-      if (comparison_expr->comp() != EQUAL_TO) {
-        continue;
-      }
+    if (expr->type() != ExprType::COMPARISON) {
+      continue;
+    }
 
-      unique_ptr<Expression> &left_expr  = comparison_expr->left();
-      unique_ptr<Expression> &right_expr = comparison_expr->right();
-      // 左右比较的一边最少是一个值
-      if (left_expr->type() != ExprType::VALUE && right_expr->type() != ExprType::VALUE) {
-        continue;
-      }
+    auto   comparison_expr = static_cast<ComparisonExpr *>(expr.get());
+    CompOp comp            = comparison_expr->comp();
+    if (comp != EQUAL_TO && comp != LESS_THAN && comp != LESS_EQUAL && comp != GREAT_THAN && comp != GREAT_EQUAL) {
+      continue;
+    }
 
-      FieldExpr *field_expr = nullptr;
-      if (left_expr->type() == ExprType::FIELD) {
-        ASSERT(right_expr->type() == ExprType::VALUE, "right expr should be a value expr while left is field expr");
-        field_expr = static_cast<FieldExpr *>(left_expr.get());
-        value_expr = static_cast<ValueExpr *>(right_expr.get());
-      } else if (right_expr->type() == ExprType::FIELD) {
-        ASSERT(left_expr->type() == ExprType::VALUE, "left expr should be a value expr while right is a field expr");
-        field_expr = static_cast<FieldExpr *>(right_expr.get());
-        value_expr = static_cast<ValueExpr *>(left_expr.get());
+    unique_ptr<Expression> &left_expr  = comparison_expr->left();
+    unique_ptr<Expression> &right_expr = comparison_expr->right();
+    if (left_expr->type() == ExprType::FIELD && right_expr->type() == ExprType::VALUE) {
+      add_index_condition(conditions,
+          static_cast<FieldExpr *>(left_expr.get())->field(),
+          comp,
+          static_cast<ValueExpr *>(right_expr.get())->get_value());
+    } else if (left_expr->type() == ExprType::VALUE && right_expr->type() == ExprType::FIELD) {
+      // value comp field 等价于 field 反向comp value
+      switch (comp) {
+        case LESS_THAN: comp = GREAT_THAN; break;
+        case LESS_EQUAL: comp = GREAT_EQUAL; break;
+        case GREAT_THAN: comp = LESS_THAN; break;
+        case GREAT_EQUAL: comp = LESS_EQUAL; break;
+        default: break;
       }
+      add_index_condition(conditions,
+          static_cast<FieldExpr *>(right_expr.get())->field(),
+          comp,
+          static_cast<ValueExpr *>(left_expr.get())->get_value());
+    }
+  }
+
+  // 找到每个条件可以使用的索引，并估计匹配的记录数
+  for (auto iter = conditions.begin(); iter != conditions.end();) {
+    IndexCondition &condition = *iter;
+    if (condition.equal) {
+      condition.index = table->find_equal_index_by_field(condition.field->field_name());
+    } else if (condition.left_value != nullptr || condition.right_value != nullptr) {
+      condition.index = table->find_range_index_by_field(condition.field->field_name());
+    }
 
-      if (field_expr == nullptr) {
-        continue;
+    // 空的范围交给普通的过滤条件处理
+    if (condition.index != nullptr && !condition.equal && condition.left_value != nullptr &&
+        condition.right_value != nullptr) {
+      const int cmp = condition.left_value->compare(*condition.right_value);
+      if (cmp > 0 || (cmp == 0 && !(condition.left_inclusive && condition.right_inclusive))) {
+        condition.index = nullptr;
       }
+    }
+
+    if (condition.index == nullptr) {
+      iter = conditions.erase(iter);
+      continue;
+    }
 
-      const Field &field = field_expr->field();
-      index              = table->find_index_by_field(field.field_name());
-      if (nullptr != index) {
+    condition.estimated_rows = estimate_index_rows(
+        condition, BITMAP_HEAP_SCAN_MIN_ROWS + 1, table_rows, table_get_oper.readonly());
+    ++iter;
+  }
+  std::stable_sort(conditions.begin(), conditions.end(), [](const IndexCondition &a, const IndexCondition &b) {
+    return a.estimated_rows < b.estimated_rows;
+  });
+
+  // 过滤之后的行数按照所有条件相互独立估计。
+  // 匹配记录最少的索引条件已经在索引上数过(或者估计过)，它所在字段上的条件不再重复计算
+  const int    predicate_num = static_cast<int>(predicates.size());
+  const Field *index_field   = conditions.empty() ? nullptr : conditions.front().field;
+  double       output_rows   = conditions.empty() ? table_rows : conditions.front().estimated_rows;
+  for (auto &expr : predicates) {
+    if (index_field == nullptr || !is_field_condition(*expr, *index_field)) {
+      output_rows *= CardinalityEstimator::selectivity(*expr);
+    }
+  }
+  output_rows = clamp_rows(output_rows);
+
+  // 在全表扫描、索引扫描和位图堆扫描中选择代价最小的
+  const double scan_cost = CostModel::table_scan(table_pages, table_rows, predicate_num);
+
+  // 修改数据时总是先收集全部的RID，避免扫描过程中索引被修改之后重复访问同一条记录，所以不能使用索引扫描
+  double index_cost = std::numeric_limits<double>::max();
+  if (!conditions.empty() && table_get_oper.readonly()) {
+    index_cost = CostModel::index_scan(table_pages, conditions.front().estimated_rows, predicate_num);
+  }
+
+  // 位图堆扫描依次和后面的索引求交集，直到匹配的记录已经很少
+  size_t bitmap_condition_num = 0;
+  double bitmap_cost          = std::numeric_limits<double>::max();
+  if (!conditions.empty()) {
+    double index_rows   = 0;
+    double matched_rows = table_rows;
+    for (const IndexCondition &condition : conditions) {
+      bitmap_condition_num++;
+      index_rows += condition.estimated_rows;
+      matched_rows *= table_rows > 0 ? std::min(condition.estimated_rows / table_rows, 1.0) : 0;
+      if (condition.estimated_rows <= BITMAP_HEAP_SCAN_MIN_ROWS) {
         break;
       }
     }
+    bitmap_cost = CostModel::bitmap_heap_scan(table_pages, index_rows, matched_rows, predicate_num);
   }
-  // 处理索引
-  if (index != nullptr) {
-    ASSERT(value_expr != nullptr, "got an index but value expr is null ?");
 
-    const Value               &value           = value_expr->get_value();
-    IndexScanPhysicalOperator *index_scan_oper = new IndexScanPhysicalOperator(
-        table, index, table_get_oper.readonly(), &value, true /*left_inclusive*/, &value, true /*right_inclusive*/);
+  // 查询时只输出上层需要的字段。修改数据时上层算子直接使用记录，输出所有字段
+  vector<const FieldMeta *> output_fields;
+  for (const Field &field : table_get_oper.fields()) {
+    output_fields.push_back(field.meta());
+  }
 
-    index_scan_oper->set_predicates(std::move(predicates));
-    oper = unique_ptr<PhysicalOperator>(index_scan_oper);
-    LOG_TRACE("use index scan");
-  } else {
+  // 上层排序之后只取前几行时，可以按照排序字段上的索引的顺序扫描，不需要排序，取够了行就停止。
+  // 满足条件的行在索引中均匀分布时，需要扫描 limit / 选择率 行
+  Index *order_index = nullptr;
+  if (table_get_oper.order_field() != nullptr && table_get_oper.readonly()) {
+    order_index = find_ordered_index(table, table_get_oper.order_field());
+  }
+  if (order_index != nullptr) {
+    auto order_condition = std::find_if(conditions.begin(), conditions.end(), [&](const IndexCondition &condition) {
+      return 0 == strcmp(condition.field->field_name(), table_get_oper.order_field());
+    });
+    const double limit        = table_get_oper.order_limit();
+    const double range_rows   = order_condition != conditions.end() ? order_condition->estimated_rows : table_rows;
+    const double scan_rows    = std::min(range_rows, limit * range_rows / output_rows);
+    const double ordered_cost = CostModel::index_scan(table_pages, scan_rows, predicate_num);
+    const double sorted_cost  = CostModel::top_n(std::min({scan_cost, index_cost, bitmap_cost}), output_rows, limit);
+    if (ordered_cost < sorted_cost) {
+      const bool has_condition = order_condition != conditions.end();
+      auto       index_scan_oper = new IndexScanPhysicalOperator(table,
+          order_index,
+          table_get_oper.readonly(),
+          has_condition ? order_condition->left_value : nullptr,
+          has_condition && order_condition->left_inclusive,
+          has_condition ? order_condition->right_value : nullptr,
+          has_condition && order_condition->right_inclusive);
+      index_scan_oper->set_reverse(!table_get_oper.order_asc());
+      index_scan_oper->set_predicates(std::move(predicates));
+      index_scan_oper->set_output_fields(std::move(output_fields));
+      oper = unique_ptr<PhysicalOperator>(index_scan_oper);
+      oper->set_estimate(clamp_rows(std::min(output_rows, limit)), ordered_cost);
+      LOG_TRACE("use ordered index scan. index=%s, scan rows=%f, cost=%f, sort cost=%f",
+                order_index->index_meta().name(), scan_rows, ordered_cost, sorted_cost);
+      return RC::SUCCESS;
+    }
+  }
+
+  if (scan_cost <= index_cost && scan_cost <= bitmap_cost) {
     auto table_scan_oper = new TableScanPhysicalOperator(table, table_get_oper.readonly());
     table_scan_oper->set_predicates(std::move(predicates));
+    if (table_get_oper.readonly()) {
+      table_scan_oper->set_output_fields(std::move(output_fields));
+    }
     oper = unique_ptr<PhysicalOperator>(table_scan_oper);
-    LOG_TRACE("use table scan");
+    oper->set_estimate(output_rows, scan_cost);
+    LOG_TRACE("use table scan. table=%s, cost=%f", table->name(), scan_cost);
+    return RC::SUCCESS;
   }
 
+  // 匹配的记录不多时按照索引顺序直接访问数据
+  const IndexCondition &best = conditions.front();
+  if (index_cost <= bitmap_cost) {
+    IndexScanPhysicalOperator *index_scan_oper = new IndexScanPhysicalOperator(table,
+        best.index,
+        table_get_oper.readonly(),
+        best.left_value,
+        best.left_inclusive,
+        best.right_value,
+        best.right_inclusive);
+
+    index_scan_oper->set_predicates(std::move(predicates));
+    if (table_get_oper.readonly()) {
+      index_scan_oper->set_output_fields(std::move(output_fields));
+    }
+    oper = unique_ptr<PhysicalOperator>(index_scan_oper);
+    oper->set_estimate(output_rows, index_cost);
+    LOG_TRACE("use index scan. index=%s, estimated rows=%f, cost=%f",
+              best.index->index_meta().name(), best.estimated_rows, index_cost);
+    return RC::SUCCESS;
+  }
+
+  // 匹配的记录很多时，把索引的结果求交集之后按照页面顺序访问
+  auto bitmap_scan_oper = new BitmapHeapScanPhysicalOperator(table, table_get_oper.readonly());
+  for (size_t i = 0; i < bitmap_condition_num; i++) {
+    const IndexCondition &condition = conditions[i];
+    bitmap_scan_oper->add_index_condition(condition.index,
+        condition.left_value,
+        condition.left_inclusive,
+        condition.right_value,
+        condition.right_inclusive);
+  }
+  bitmap_scan_oper->set_predicates(std::move(predicates));
+  if (table_get_oper.readonly()) {
+    bitmap_scan_oper->set_output_fields(std::move(output_fields));
+  }
+  oper = unique_ptr<PhysicalOperator>(bitmap_scan_oper);
+  oper->set_estimate(output_rows, bitmap_cost);
+  LOG_TRACE("use bitmap heap scan. table=%s, estimated rows=%f, cost=%f", table->name(), best.estimated_rows, bitmap_cost);
   return RC::SUCCESS;
 }
 
@@ -185,7 +738,16 @@ RC PhysicalPlanGenerator::create_plan(PredicateLogicalOperator &pred_oper, uniqu
   ASSERT(expressions.size() == 1, "predicate logical operator's children should be 1");
 
   unique_ptr<Expression> expression = std::move(expressions.front());
+  const double           selectivity = CardinalityEstimator::selectivity(*expression);
+  if (child_phy_oper->type() == PhysicalOperatorType::NESTED_LOOP_JOIN) {
+    create_runtime_filters(*expression, static_cast<NestedLoopJoinPhysicalOperator &>(*child_phy_oper));
+  }
   oper = unique_ptr<PhysicalOperator>(new PredicatePhysicalOperator(std::move(expression)));
+  if (child_phy_oper->has_estimate()) {
+    const double child_rows = child_phy_oper->estimated_rows();
+    oper->set_estimate(clamp_rows(child_rows * selectivity),
+        child_phy_oper->estimated_cost() + CostModel::CPU_OPERATOR_COST * child_rows);
+  }
   oper->add_child(std::move(child_phy_oper));
   return rc;
 }
@@ -208,8 +770,22 @@ RC PhysicalPlanGenerator::create_plan(ProjectLogicalOperator &project_oper, uniq
 
   ProjectPhysicalOperator *project_operator = new ProjectPhysicalOperator;
   const vector<Field>     &project_fields   = project_oper.fields();
+  int                      aggregate_num    = 0;
   for (const Field &field : project_fields) {
     project_operator->add_projection(field);  // 主要修改部分，直接将projection的添加tuple进行修改
+    if (field.aggre_type() != AGGRE_NONE) {
+      aggregate_num++;
+    }
+  }
+
+  if (child_phy_oper && child_phy_oper->has_estimate()) {
+    const double child_rows = child_phy_oper->estimated_rows();
+    const double child_cost = child_phy_oper->estimated_cost();
+    if (aggregate_num > 0) {
+      project_operator->set_estimate(1, CostModel::aggregate(child_cost, child_rows, aggregate_num));
+    } else {
+      project_operator->set_estimate(child_rows, child_cost + CostModel::CPU_TUPLE_COST * child_rows);
+    }
   }
 
   if (child_phy_oper) {
@@ -224,29 +800,13 @@ RC PhysicalPlanGenerator::create_plan(ProjectLogicalOperator &project_oper, uniq
 
 RC PhysicalPlanGenerator::create_plan(AnalyzeLogicalOperator &analyze_oper, unique_ptr<PhysicalOperator> &oper)
 {
-  Table               *analyze_table  = analyze_oper.analyze_table();
-  Table               *table          = analyze_oper.table();
-  std::vector<Field *> analyze_fields = analyze_oper.query_fields();
-
-  vector<unique_ptr<LogicalOperator>> &child_opers = analyze_oper.children();
-
-  unique_ptr<PhysicalOperator> child_physical_oper;
-
-  RC rc = RC::SUCCESS;
-  if (!child_opers.empty()) {
-    LogicalOperator *child_oper = child_opers.front().get();
-    rc                          = create(*child_oper, child_physical_oper);
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to create physical operator. rc=%s", strrc(rc));
-      return rc;
-    }
+  Table                         *table = analyze_oper.table();
+  std::vector<const FieldMeta *> field_metas;
+  for (Field *field : analyze_oper.query_fields()) {
+    field_metas.push_back(field->meta());
   }
 
-  oper = unique_ptr<PhysicalOperator>(new AnalyzePhysicalOperator(analyze_table, table, analyze_fields));
-
-  if (child_physical_oper) {
-    oper->add_child(std::move(child_physical_oper));
-  }
+  oper = unique_ptr<PhysicalOperator>(new AnalyzePhysicalOperator(table, std::move(field_metas)));
   return RC::SUCCESS;
 }
 
@@ -359,10 +919,91 @@ RC PhysicalPlanGenerator::create_plan(JoinLogicalOperator &join_oper, unique_ptr
     join_physical_oper->add_child(std::move(child_physical_oper));
   }
 
+  // 左边是外表，右边是内表
+  const PhysicalOperator *outer = join_physical_oper->children()[0].get();
+  const PhysicalOperator *inner = join_physical_oper->children()[1].get();
+  if (outer->has_estimate() && inner->has_estimate()) {
+    join_physical_oper->set_estimate(outer->estimated_rows() * inner->estimated_rows(),
+        CostModel::nested_loop_join(
+            outer->estimated_cost(), outer->estimated_rows(), inner->estimated_cost(), inner->estimated_rows()));
+  }
+
   oper = std::move(join_physical_oper);
   return rc;
 }
 
+RC PhysicalPlanGenerator::create_plan(SemiJoinLogicalOperator &semi_join_oper, unique_ptr<PhysicalOperator> &oper)
+{
+  vector<unique_ptr<LogicalOperator>> &child_opers = semi_join_oper.children();
+  if (child_opers.size() != 2) {
+    LOG_WARN("semi join operator should have 2 children, but have %d", static_cast<int>(child_opers.size()));
+    return RC::INTERNAL;
+  }
+
+  // 左边是外层查询，右边是子查询
+  vector<const Table *> probe_tables;
+  vector<const Table *> build_tables;
+  collect_tables(*child_opers[0], probe_tables);
+  collect_tables(*child_opers[1], build_tables);
+
+  auto semi_join_phy_oper = make_unique<HashSemiJoinPhysicalOperator>(semi_join_oper.anti());
+  for (unique_ptr<LogicalOperator> &child_oper : child_opers) {
+    unique_ptr<PhysicalOperator> child_phy_oper;
+    RC                           rc = create(*child_oper, child_phy_oper);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to create physical child oper of semi join. rc=%s", strrc(rc));
+      return rc;
+    }
+    semi_join_phy_oper->add_child(std::move(child_phy_oper));
+  }
+
+  // 连接条件按照 AND 拆开，等值条件放到哈希表中，其它的在匹配时计算
+  vector<unique_ptr<Expression>> conditions;
+  double                         selectivity = -1;
+  if (!semi_join_oper.expressions().empty()) {
+    unique_ptr<Expression> &expr = semi_join_oper.expressions().front();
+    selectivity                  = CardinalityEstimator::selectivity(*expr);
+    if (expr->type() == ExprType::CONJUNCTION &&
+        static_cast<ConjunctionExpr &>(*expr).conjunction_type() == ConjunctionExpr::Type::AND) {
+      for (unique_ptr<Expression> &child : static_cast<ConjunctionExpr &>(*expr).children()) {
+        conditions.push_back(std::move(child));
+      }
+    } else {
+      conditions.push_back(std::move(expr));
+    }
+  }
+
+  for (unique_ptr<Expression> &condition : conditions) {
+    if (to_hash_key(*condition, probe_tables, build_tables)) {
+      auto &comparison = static_cast<ComparisonExpr &>(*condition);
+      semi_join_phy_oper->add_key(std::move(comparison.left()), std::move(comparison.right()));
+    } else {
+      vector<Field> build_fields;
+      collect_fields(*condition, build_tables, build_fields);
+      semi_join_phy_oper->add_condition(std::move(condition), build_fields);
+    }
+  }
+
+  // 左边的一行在右边有匹配的概率：没有连接条件时看右边是否有数据，否则按照每一行都独立地匹配估计
+  const PhysicalOperator *probe = semi_join_phy_oper->children()[0].get();
+  const PhysicalOperator *build = semi_join_phy_oper->children()[1].get();
+  if (probe->has_estimate() && build->has_estimate()) {
+    const double build_rows  = build->estimated_rows();
+    double       match_ratio = build_rows > 0 ? 1 : 0;
+    if (selectivity >= 0) {
+      match_ratio = std::min(selectivity * build_rows, 1.0);
+    }
+    if (semi_join_oper.anti()) {
+      match_ratio = 1 - match_ratio;
+    }
+    semi_join_phy_oper->set_estimate(clamp_rows(probe->estimated_rows() * match_ratio),
+        CostModel::hash_join(build->estimated_cost(), build_rows, probe->estimated_cost(), probe->estimated_rows()));
+  }
+
+  oper = std::move(semi_join_phy_oper);
+  return RC::SUCCESS;
+}
+
 RC PhysicalPlanGenerator::create_plan(CalcLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper)
 {
   RC rc = RC::SUCCESS;
@@ -386,23 +1027,72 @@ RC PhysicalPlanGenerator::create_plan(OrderLogicalOperator &orderby_oper, std::u
     // DO SOME THING ?
   }
 
-  unique_ptr<OrderPhysicalOperator> order_phy_oper(new OrderPhysicalOperator(orderby_oper.get_units()));
-  unique_ptr<PhysicalOperator>      child_phy_oper;
+  // 只取前几行并且按照一个字段排序时，告诉扫描这张表的算子，它可以选择按照索引的顺序扫描
+  const vector<OrderByUnit *> units = orderby_oper.get_units();
+  const int                   limit = orderby_oper.limit();
+  if (limit >= 0 && units.size() == 1) {
+    const OrderByUnit       &unit           = *units.front();
+    TableGetLogicalOperator *table_get_oper = find_table_get(*child_opers.front(), unit.get_table());
+    if (table_get_oper != nullptr) {
+      table_get_oper->set_required_order(unit.get_fields()->name(), unit.get_asc(), limit);
+    }
+  }
 
-  RC rc = RC::SUCCESS;
-  if (!child_opers.empty()) {
-    LogicalOperator *child_oper = child_opers.front().get();
-    rc                          = create(*child_oper, child_phy_oper);
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to create order physical operator's child physical operator. rc=%s", strrc(rc));
-      return rc;
+  unique_ptr<PhysicalOperator> child_phy_oper;
+  RC                           rc = create(*child_opers.front(), child_phy_oper);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to create order physical operator's child physical operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  // 下层已经按照索引的顺序输出时不需要再排序。排序算子不创建了，由这里释放排序的字段
+  if (units.size() == 1 && provides_order(*child_phy_oper, *units.front())) {
+    LOG_TRACE("skip order by since child operator outputs in index order");
+    for (OrderByUnit *unit : units) {
+      delete unit;
+    }
+    oper = std::move(child_phy_oper);
+    return rc;
+  }
+
+  unique_ptr<OrderPhysicalOperator> order_phy_oper(new OrderPhysicalOperator(units, limit));
+  if (child_phy_oper->has_estimate()) {
+    const double child_rows = child_phy_oper->estimated_rows();
+    const double child_cost = child_phy_oper->estimated_cost();
+    if (limit >= 0) {
+      order_phy_oper->set_estimate(
+          clamp_rows(std::min<double>(child_rows, limit)), CostModel::top_n(child_cost, child_rows, limit));
+    } else {
+      order_phy_oper->set_estimate(child_rows, CostModel::sort(child_cost, child_rows));
     }
-    if (child_phy_oper)
-      order_phy_oper->add_child(std::move(child_phy_oper));
   }
+  order_phy_oper->add_child(std::move(child_phy_oper));
 
   oper = std::move(order_phy_oper);
 
   LOG_TRACE("create a Orderby physical operator");
   return rc;
-}
\ No newline at end of file
+}
+
+RC PhysicalPlanGenerator::create_plan(LimitLogicalOperator &limit_oper, std::unique_ptr<PhysicalOperator> &oper)
+{
+  vector<unique_ptr<LogicalOperator>> &child_opers = limit_oper.children();
+  ASSERT(child_opers.size() == 1, "limit logical operator's sub oper number should be 1");
+
+  unique_ptr<PhysicalOperator> child_phy_oper;
+  RC                           rc = create(*child_opers.front(), child_phy_oper);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to create child operator of limit operator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  oper = unique_ptr<PhysicalOperator>(new LimitPhysicalOperator(limit_oper.limit(), limit_oper.offset()));
+  if (child_phy_oper->has_estimate()) {
+    // 取够了行就不再从下层取数据，但是下层可能已经在 open 或者第一次 next 时处理了所有的数据(比如排序)，
+    // 代价按照下层的总代价计算
+    const double rows = std::min<double>(child_phy_oper->estimated_rows() - limit_oper.offset(), limit_oper.limit());
+    oper->set_estimate(std::max(rows, 0.0), child_phy_oper->estimated_cost());
+  }
+  oper->add_child(std::move(child_phy_oper));
+  return rc;
+}
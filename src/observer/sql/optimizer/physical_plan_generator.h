@@ -26,8 +26,10 @@ class UpdateLogicalOperator;
 class DeleteLogicalOperator;
 class ExplainLogicalOperator;
 class JoinLogicalOperator;
+class SemiJoinLogicalOperator;
 class CalcLogicalOperator;
 class OrderLogicalOperator;
+class LimitLogicalOperator;
 class AnalyzeLogicalOperator;
 
 /**
@@ -44,6 +46,14 @@ public:
 
   RC create(LogicalOperator &logical_operator, std::unique_ptr<PhysicalOperator> &oper);
 
+  /**
+   * @brief 在索引上直接数匹配记录的上限
+   * @details 匹配的记录不超过这个数量时使用数出来的准确值，超过时根据统计信息估计。
+   * 位图堆扫描与其它索引求交集时，遇到匹配记录不超过这个数量的索引就停止。
+   * 具体使用哪种访问方式由 CostModel 计算的代价决定
+   */
+  static constexpr int BITMAP_HEAP_SCAN_MIN_ROWS = 128;
+
 private:
   RC create_plan(TableGetLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_plan(PredicateLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
@@ -53,7 +63,9 @@ private:
   RC create_plan(DeleteLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_plan(ExplainLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_plan(JoinLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
+  RC create_plan(SemiJoinLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_plan(CalcLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_plan(OrderLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
+  RC create_plan(LimitLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
   RC create_plan(AnalyzeLogicalOperator &logical_oper, std::unique_ptr<PhysicalOperator> &oper);
 };
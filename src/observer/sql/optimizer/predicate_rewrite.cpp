@@ -18,41 +18,36 @@ See the Mulan PSL v2 for more details. */
 RC PredicateRewriteRule::rewrite(std::unique_ptr<LogicalOperator> &oper, bool &change_made)
 {
   std::vector<std::unique_ptr<LogicalOperator>> &child_opers = oper->children();
-  if (child_opers.size() != 1) {
-    return RC::SUCCESS;
-  }
-
-  auto &child_oper = child_opers.front(); //指针列表的第一个
-  if (child_oper->type() != LogicalOperatorType::PREDICATE) {
-    return RC::SUCCESS;
-  }
+  for (auto &child_oper : child_opers) {
+    if (child_oper->type() != LogicalOperatorType::PREDICATE) {
+      continue;
+    }
 
-  std::vector<std::unique_ptr<Expression>> &expressions = child_oper->expressions();
-  if (expressions.size() != 1) {
-    return RC::SUCCESS;
-  }
+    std::vector<std::unique_ptr<Expression>> &expressions = child_oper->expressions();
+    if (expressions.size() != 1) {
+      continue;
+    }
 
-  std::unique_ptr<Expression> &expr = expressions.front();
-  if (expr->type() != ExprType::VALUE) {
-    return RC::SUCCESS;
-  }
+    std::unique_ptr<Expression> &expr = expressions.front();
+    if (expr->type() != ExprType::VALUE) {
+      continue;
+    }
 
-  // 如果仅有的一个子节点是predicate
-  // 并且这个子节点可以判断为恒为TRUE，那么可以省略这个子节点，并把他的子节点们（就是孙子节点）接管过来
-  // 如果可以判断恒为false，那么就可以删除子节点
-  auto value_expr = static_cast<ValueExpr *>(expr.get());
-  bool bool_value = value_expr->get_value().get_boolean();
-  if (true == bool_value) {
-    std::vector<std::unique_ptr<LogicalOperator>> grand_child_opers;
-    grand_child_opers.swap(child_oper->children());
-    child_opers.clear();
-    for (auto &grand_child_oper : grand_child_opers) {
-      oper->add_child(std::move(grand_child_oper));
+    // 如果子节点是predicate，并且这个子节点可以判断为恒为TRUE，那么可以省略这个子节点，由孙子节点代替它。
+    // 连接算子的两个子节点都可能是predicate
+    // 如果仅有的一个子节点可以判断恒为false，那么就可以删除子节点
+    auto value_expr = static_cast<ValueExpr *>(expr.get());
+    bool bool_value = value_expr->get_value().get_boolean();
+    if (true == bool_value && child_oper->children().size() == 1) {
+      std::unique_ptr<LogicalOperator> grand_child_oper = std::move(child_oper->children().front());
+      child_oper = std::move(grand_child_oper);
+      change_made = true;
+    } else if (child_opers.size() == 1 && (false == bool_value || child_oper->children().empty())) {
+      child_opers.clear();
+      change_made = true;
+      break;
     }
-  } else {
-    child_opers.clear();
   }
 
-  change_made = true;
   return RC::SUCCESS;
 }
@@ -0,0 +1,131 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/optimizer/projection_pushdown_rewriter.h"
+#include "common/log/log.h"
+#include "sql/expr/expression.h"
+#include "sql/operator/project_logical_operator.h"
+#include "sql/operator/table_get_logical_operator.h"
+#include "storage/table/table.h"
+
+using namespace std;
+
+namespace {
+
+void add_field(vector<Field> &fields, const Field &field)
+{
+  for (const Field &f : fields) {
+    if (f.table() == field.table() && f.meta() == field.meta()) {
+      return;
+    }
+  }
+  fields.push_back(Field(field.table(), field.meta()));
+}
+
+/**
+ * @brief 收集表达式引用的所有字段
+ */
+void collect_fields(Expression &expr, vector<Field> &fields)
+{
+  switch (expr.type()) {
+    case ExprType::FIELD: {
+      add_field(fields, static_cast<FieldExpr &>(expr).field());
+    } break;
+    case ExprType::CAST: {
+      collect_fields(*static_cast<CastExpr &>(expr).child(), fields);
+    } break;
+    case ExprType::COMPARISON: {
+      auto &comparison = static_cast<ComparisonExpr &>(expr);
+      collect_fields(*comparison.left(), fields);
+      collect_fields(*comparison.right(), fields);
+    } break;
+    case ExprType::CONJUNCTION: {
+      for (unique_ptr<Expression> &child : static_cast<ConjunctionExpr &>(expr).children()) {
+        collect_fields(*child, fields);
+      }
+    } break;
+    case ExprType::ARITHMETIC: {
+      auto &arithmetic = static_cast<ArithmeticExpr &>(expr);
+      collect_fields(*arithmetic.left(), fields);
+      if (arithmetic.right()) {
+        collect_fields(*arithmetic.right(), fields);
+      }
+    } break;
+    default: break;
+  }
+}
+
+bool same_fields(const vector<Field> &left, const vector<Field> &right)
+{
+  if (left.size() != right.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < left.size(); i++) {
+    if (left[i].table() != right[i].table() || left[i].meta() != right[i].meta()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+RC ProjectionPushdownRewriter::rewrite(unique_ptr<LogicalOperator> &oper, bool &change_made)
+{
+  if (oper->type() != LogicalOperatorType::PROJECTION) {
+    return RC::SUCCESS;
+  }
+
+  auto         &project_oper = static_cast<ProjectLogicalOperator &>(*oper);
+  vector<Field> required;
+  for (const Field &field : project_oper.fields()) {
+    add_field(required, field);
+  }
+  for (unique_ptr<Expression> &expr : project_oper.expressions()) {
+    collect_fields(*expr, required);
+  }
+
+  for (unique_ptr<LogicalOperator> &child : oper->children()) {
+    pushdown(*child, required, change_made);
+  }
+  return RC::SUCCESS;
+}
+
+void ProjectionPushdownRewriter::pushdown(LogicalOperator &oper, vector<Field> required, bool &change_made)
+{
+  if (oper.type() != LogicalOperatorType::TABLE_GET) {
+    // 过滤和连接条件引用的字段也要由下层提供
+    for (unique_ptr<Expression> &expr : oper.expressions()) {
+      collect_fields(*expr, required);
+    }
+    for (unique_ptr<LogicalOperator> &child : oper.children()) {
+      pushdown(*child, required, change_made);
+    }
+    return;
+  }
+
+  auto         &table_get_oper = static_cast<TableGetLogicalOperator &>(oper);
+  vector<Field> fields;
+  for (const Field &field : required) {
+    if (field.table() == table_get_oper.table()) {
+      add_field(fields, field);
+    }
+  }
+  for (unique_ptr<Expression> &expr : table_get_oper.predicates()) {
+    collect_fields(*expr, fields);
+  }
+
+  if (!same_fields(fields, table_get_oper.fields())) {
+    LOG_TRACE("pushdown projection to table get. table=%s, fields=%d",
+              table_get_oper.table()->name(), static_cast<int>(fields.size()));
+    table_get_oper.set_fields(std::move(fields));
+    change_made = true;
+  }
+}
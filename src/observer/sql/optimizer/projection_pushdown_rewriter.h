@@ -0,0 +1,36 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <vector>
+
+#include "sql/optimizer/rewrite_rule.h"
+#include "storage/field/field.h"
+
+/**
+ * @brief 把投影需要的字段下推到表数据扫描中
+ * @ingroup Rewriter
+ * @details 从投影算子开始向下计算每个算子需要的字段：投影的字段，加上沿途过滤和连接条件引用的字段。
+ * 到达 TableGet 时，这张表需要的字段再加上扫描自己的过滤条件引用的字段，就是扫描算子输出的字段。
+ * 扫描输出的元组只包含这些字段，隐藏的系统字段和没有用到的字段不会在连接中传递。
+ * 放在 PredicatePushdownRewriter 之后，条件下推改变计划时会重新计算。
+ */
+class ProjectionPushdownRewriter : public RewriteRule
+{
+public:
+  ProjectionPushdownRewriter()          = default;
+  virtual ~ProjectionPushdownRewriter() = default;
+
+  RC rewrite(std::unique_ptr<LogicalOperator> &oper, bool &change_made) override;
+
+private:
+  void pushdown(LogicalOperator &oper, std::vector<Field> required, bool &change_made);
+};
@@ -0,0 +1,195 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+
+#include "sql/optimizer/subquery_rewriter.h"
+#include "common/log/log.h"
+#include "sql/expr/expression.h"
+#include "sql/operator/semi_join_logical_operator.h"
+#include "sql/operator/table_get_logical_operator.h"
+
+using namespace std;
+
+namespace {
+
+void collect_tables(LogicalOperator &oper, vector<const Table *> &tables)
+{
+  if (oper.type() == LogicalOperatorType::TABLE_GET) {
+    tables.push_back(static_cast<TableGetLogicalOperator &>(oper).table());
+  }
+  for (unique_ptr<LogicalOperator> &child : oper.children()) {
+    collect_tables(*child, tables);
+  }
+}
+
+/**
+ * @brief 表达式是否引用了 tables 以外的表
+ */
+bool refers_other_tables(Expression &expr, const vector<const Table *> &tables)
+{
+  switch (expr.type()) {
+    case ExprType::FIELD: {
+      const Table *table = static_cast<FieldExpr &>(expr).field().table();
+      return std::find(tables.begin(), tables.end(), table) == tables.end();
+    }
+    case ExprType::CAST: {
+      return refers_other_tables(*static_cast<CastExpr &>(expr).child(), tables);
+    }
+    case ExprType::COMPARISON: {
+      auto &comparison = static_cast<ComparisonExpr &>(expr);
+      return refers_other_tables(*comparison.left(), tables) || refers_other_tables(*comparison.right(), tables);
+    }
+    case ExprType::CONJUNCTION: {
+      for (unique_ptr<Expression> &child : static_cast<ConjunctionExpr &>(expr).children()) {
+        if (refers_other_tables(*child, tables)) {
+          return true;
+        }
+      }
+      return false;
+    }
+    case ExprType::ARITHMETIC: {
+      auto &arithmetic = static_cast<ArithmeticExpr &>(expr);
+      return refers_other_tables(*arithmetic.left(), tables) ||
+             (arithmetic.right() && refers_other_tables(*arithmetic.right(), tables));
+    }
+    default: return false;
+  }
+}
+
+/**
+ * @brief 把子查询中引用了外层查询的表的条件拿出来
+ * @details 生成逻辑计划时 WHERE 中的条件都放在过滤算子中。拿空了的过滤算子换成恒为真的条件，
+ * 之后由 PredicateRewriteRule 删掉
+ */
+void pull_up_correlated_conditions(
+    LogicalOperator &oper, const vector<const Table *> &tables, vector<unique_ptr<Expression>> &conditions)
+{
+  if (oper.type() == LogicalOperatorType::PREDICATE && oper.expressions().size() == 1) {
+    unique_ptr<Expression> &expr = oper.expressions().front();
+    if (expr->type() == ExprType::CONJUNCTION &&
+        static_cast<ConjunctionExpr &>(*expr).conjunction_type() == ConjunctionExpr::Type::AND) {
+      vector<unique_ptr<Expression>> &children = static_cast<ConjunctionExpr &>(*expr).children();
+      for (auto iter = children.begin(); iter != children.end();) {
+        if (refers_other_tables(**iter, tables)) {
+          conditions.emplace_back(std::move(*iter));
+          iter = children.erase(iter);
+        } else {
+          ++iter;
+        }
+      }
+      if (children.empty()) {
+        expr.reset(new ValueExpr(Value(true)));
+      }
+    } else if (refers_other_tables(*expr, tables)) {
+      conditions.emplace_back(std::move(expr));
+      expr.reset(new ValueExpr(Value(true)));
+    }
+  }
+
+  for (unique_ptr<LogicalOperator> &child : oper.children()) {
+    pull_up_correlated_conditions(*child, tables, conditions);
+  }
+}
+
+}  // namespace
+
+RC SubqueryRewriter::rewrite(unique_ptr<LogicalOperator> &oper, bool &change_made)
+{
+  if (oper->type() != LogicalOperatorType::PREDICATE || oper->children().size() != 1 ||
+      oper->expressions().size() != 1) {
+    return RC::SUCCESS;
+  }
+
+  // 拿出所有的子查询，其它的条件留在过滤算子中
+  vector<unique_ptr<Expression>> subquery_exprs;
+  unique_ptr<Expression>        &expr = oper->expressions().front();
+  if (expr->type() == ExprType::SUBQUERY) {
+    subquery_exprs.emplace_back(std::move(expr));
+    expr.reset(new ValueExpr(Value(true)));
+  } else if (expr->type() == ExprType::CONJUNCTION &&
+             static_cast<ConjunctionExpr &>(*expr).conjunction_type() == ConjunctionExpr::Type::AND) {
+    vector<unique_ptr<Expression>> &children = static_cast<ConjunctionExpr &>(*expr).children();
+    for (auto iter = children.begin(); iter != children.end();) {
+      if ((*iter)->type() == ExprType::SUBQUERY) {
+        subquery_exprs.emplace_back(std::move(*iter));
+        iter = children.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+    if (children.empty()) {
+      expr.reset(new ValueExpr(Value(true)));
+    }
+  }
+
+  if (subquery_exprs.empty()) {
+    return RC::SUCCESS;
+  }
+
+  // 多个子查询依次叠加在过滤算子的子节点上
+  unique_ptr<LogicalOperator> &child = oper->children().front();
+  for (unique_ptr<Expression> &subquery_expr : subquery_exprs) {
+    unique_ptr<LogicalOperator> semi_join_oper;
+    RC rc = create_semi_join(static_cast<SubqueryExpr &>(*subquery_expr), std::move(child), semi_join_oper);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to rewrite subquery to semi join. rc=%s", strrc(rc));
+      return rc;
+    }
+    child = std::move(semi_join_oper);
+  }
+
+  change_made = true;
+  return RC::SUCCESS;
+}
+
+RC SubqueryRewriter::create_semi_join(
+    SubqueryExpr &subquery_expr, unique_ptr<LogicalOperator> left_oper, unique_ptr<LogicalOperator> &semi_join_oper)
+{
+  // 子查询的投影和排序不影响 IN/EXISTS 的结果，连接直接使用下层算子的数据
+  unique_ptr<LogicalOperator> right_oper = std::move(subquery_expr.subquery());
+  while (right_oper && (right_oper->type() == LogicalOperatorType::PROJECTION ||
+                           right_oper->type() == LogicalOperatorType::ORDER_BY)) {
+    if (right_oper->children().empty()) {
+      LOG_WARN("subquery without table is not supported");
+      return RC::INTERNAL;
+    }
+    unique_ptr<LogicalOperator> child = std::move(right_oper->children().front());
+    right_oper                        = std::move(child);
+  }
+  if (!right_oper) {
+    LOG_WARN("subquery has no logical plan");
+    return RC::INTERNAL;
+  }
+
+  vector<unique_ptr<Expression>> conditions;
+  if (subquery_expr.comp() == IN_OP || subquery_expr.comp() == NOT_IN_OP) {
+    conditions.emplace_back(
+        new ComparisonExpr(EQUAL_TO, std::move(subquery_expr.left()), std::move(subquery_expr.right())));
+  }
+
+  vector<const Table *> tables;
+  collect_tables(*right_oper, tables);
+  pull_up_correlated_conditions(*right_oper, tables, conditions);
+
+  const bool anti          = subquery_expr.comp() == NOT_IN_OP || subquery_expr.comp() == NOT_EXISTS_OP;
+  const int  condition_num = static_cast<int>(conditions.size());
+
+  unique_ptr<Expression> condition;
+  if (!conditions.empty()) {
+    condition.reset(new ConjunctionExpr(ConjunctionExpr::Type::AND, conditions));
+  }
+
+  semi_join_oper.reset(new SemiJoinLogicalOperator(anti, std::move(condition)));
+  semi_join_oper->add_child(std::move(left_oper));
+  semi_join_oper->add_child(std::move(right_oper));
+  LOG_TRACE("rewrite subquery to %s join. join conditions=%d", anti ? "anti" : "semi", condition_num);
+  return RC::SUCCESS;
+}
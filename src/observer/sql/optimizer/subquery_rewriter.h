@@ -0,0 +1,37 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "sql/optimizer/rewrite_rule.h"
+
+class SubqueryExpr;
+
+/**
+ * @brief 把 IN/EXISTS 子查询改写成半连接，NOT IN/NOT EXISTS 改写成反连接
+ * @ingroup Rewriter
+ * @details 过滤算子中的子查询改写成过滤算子下面的连接：左边是原来的子节点，右边是子查询去掉投影之后的计划。
+ * IN 的左边字段和子查询输出的字段变成等值连接条件。
+ * 相关子查询中引用外层查询的条件从子查询中拿出来，也作为连接条件，这样子查询只需要执行一次，
+ * 不需要为外层的每一行重新执行。
+ * 放在条件下推之前，改写之后子查询中的条件可以继续下推到子查询的扫描算子中。
+ */
+class SubqueryRewriter : public RewriteRule
+{
+public:
+  SubqueryRewriter()          = default;
+  virtual ~SubqueryRewriter() = default;
+
+  RC rewrite(std::unique_ptr<LogicalOperator> &oper, bool &change_made) override;
+
+private:
+  RC create_semi_join(SubqueryExpr &subquery_expr, std::unique_ptr<LogicalOperator> left_oper,
+      std::unique_ptr<LogicalOperator> &semi_join_oper);
+};
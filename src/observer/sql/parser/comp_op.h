@@ -8,13 +8,17 @@
  */
 enum CompOp
 {
-  EQUAL_TO,     ///< "="
-  LESS_EQUAL,   ///< "<="
-  NOT_EQUAL,    ///< "<>"
-  LESS_THAN,    ///< "<"
-  GREAT_EQUAL,  ///< ">="
-  GREAT_THAN,   ///< ">"
-  LIKE,         ///< LIKE
-  NOT_LIKE,     ///< NOT LIKE
-  NO_OP,        ///< no condition
+  EQUAL_TO,       ///< "="
+  LESS_EQUAL,     ///< "<="
+  NOT_EQUAL,      ///< "<>"
+  LESS_THAN,      ///< "<"
+  GREAT_EQUAL,    ///< ">="
+  GREAT_THAN,     ///< ">"
+  LIKE,           ///< LIKE
+  NOT_LIKE,       ///< NOT LIKE
+  IN_OP,          ///< IN 子查询
+  NOT_IN_OP,      ///< NOT IN 子查询
+  EXISTS_OP,      ///< EXISTS 子查询
+  NOT_EXISTS_OP,  ///< NOT EXISTS 子查询
+  NO_OP,          ///< no condition
 };
\ No newline at end of file
@@ -385,8 +385,8 @@ static void yynoreturn yy_fatal_error ( const char* msg , yyscan_t yyscanner );
 	yyg->yy_hold_char = *yy_cp; \
 	*yy_cp = '\0'; \
 	yyg->yy_c_buf_p = yy_cp;
-#define YY_NUM_RULES 71
-#define YY_END_OF_BUFFER 72
+#define YY_NUM_RULES 78
+#define YY_END_OF_BUFFER 79
 /* This struct is not used in this scanner,
    but its presence is necessary. */
 struct yy_trans_info
@@ -394,31 +394,34 @@ struct yy_trans_info
 	flex_int32_t yy_verify;
 	flex_int32_t yy_nxt;
 	};
-static const flex_int16_t yy_accept[207] =
+static const flex_int16_t yy_accept[233] =
     {   0,
-        0,    0,    0,    0,   72,   70,    1,    2,   70,   70,
-       70,   54,   55,   66,   64,   56,   65,    6,   67,    3,
-        5,   61,   57,   63,   52,   52,   52,   52,   52,   52,
-       52,   52,   52,   52,   52,   52,   52,   52,   52,   52,
-       52,   52,   52,   52,   71,   60,    0,   68,    0,   69,
-        3,    0,    3,   53,   58,   59,   62,   52,   52,   52,
-       52,   52,   52,   52,   43,   52,   52,   52,   52,   52,
-       52,   52,   52,   52,   52,   52,   52,   52,   52,   52,
-       52,   52,   17,   52,   52,   52,   52,   52,   52,   52,
-       52,   52,   52,   52,   52,    4,   52,   24,   44,   47,
-
-       52,   52,   52,   52,   52,   52,   52,   52,   52,   52,
-       52,   52,   52,   52,   52,   52,   52,   52,   34,   52,
-       52,   48,   49,   50,   52,   52,   52,   30,   52,   45,
-       52,   52,   52,   52,   52,   52,   52,   52,   21,   35,
-       52,   52,   52,   39,   37,   52,    9,   12,    7,   52,
-       52,   22,    8,   52,   52,   52,   26,   51,   38,   52,
-       52,   52,   18,   19,   52,   52,   52,   52,   52,   52,
-       31,   52,   46,   52,   52,   52,   36,   16,   52,   52,
-       42,   52,   52,   13,   52,   52,   52,   23,   52,   32,
-       10,   28,   52,   40,   25,   52,   20,   14,   15,   29,
-
-       27,   11,   41,   52,   33,    0
+        0,    0,    0,    0,   79,   77,    1,    2,   77,   77,
+       77,   61,   62,   73,   71,   63,   72,    6,   74,    3,
+        5,   68,   64,   70,   59,   59,   59,   59,   59,   59,
+       59,   59,   59,   59,   59,   59,   59,   59,   59,   59,
+       59,   59,   59,   59,   78,   67,    0,   75,    0,   76,
+        3,    0,    3,   60,   65,   66,   69,   59,   59,   59,
+       59,   59,   59,   59,   43,   59,   59,   59,   59,   59,
+       59,   59,   59,   59,   59,   59,   59,   52,   59,   59,
+       59,   59,   59,   59,   17,   59,   59,   59,   59,   59,
+       59,   59,   59,   59,   59,   59,   59,   59,   59,    4,
+
+       59,   24,   44,   47,   59,   59,   59,   59,   59,   59,
+       59,   59,   59,   59,   59,   59,   59,   59,   59,   59,
+       59,   59,   59,   34,   59,   59,   59,   48,   49,   50,
+       59,   59,   59,   59,   30,   59,   59,   45,   59,   59,
+       59,   59,   59,   59,   59,   59,   59,   21,   35,   59,
+       59,   59,   39,   37,   59,    9,   12,   59,    7,   59,
+       59,   59,   22,    8,   59,   59,   59,   26,   51,   59,
+       38,   59,   59,   59,   59,   18,   59,   19,   59,   59,
+       59,   59,   59,   59,   59,   31,   59,   46,   59,   59,
+       59,   59,   36,   59,   16,   59,   59,   54,   59,   42,
+
+       59,   59,   59,   13,   59,   59,   56,   59,   23,   59,
+       32,   10,   28,   53,   59,   58,   40,   25,   55,   59,
+       20,   59,   14,   15,   29,   27,   11,   41,   59,   57,
+       33,    0
     } ;
 
 static const YY_CHAR yy_ec[256] =
@@ -455,73 +458,77 @@ static const YY_CHAR yy_ec[256] =
 
 static const YY_CHAR yy_meta[72] =
     {   0,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    2,    1,    3,    1,    1,    1,    1,    3,
-        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
-        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
-        3,    3,    3,    3,    3,    4,    3,    3,    3,    3,
-        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
-        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
-        3
+        1,    2,    3,    4,    5,    6,    7,    8,    9,   10,
+       11,   12,   13,   14,   15,   16,   17,   18,   19,   20,
+       21,   22,   23,   24,   25,   26,   27,   28,   29,   30,
+       31,   32,   33,   34,   35,   36,   37,   38,   39,   40,
+       41,   42,   43,   44,   45,   46,   20,   21,   22,   23,
+       24,   25,   26,   27,   28,   30,   31,   32,   33,   34,
+       35,   36,   37,   38,   39,   40,   41,   42,   43,   44,
+       45
     } ;
 
-static const flex_int16_t yy_base[215] =
+static const flex_int16_t yy_base[233] =
     {   0,
-        0,    0,    0,    0,  148,  809,  809,  809,  128,  139,
-      132,  809,  809,  809,  809,  809,  120,  809,  809,   59,
-      809,   57,  809,   87,   58,   62,   73,   65,   72,  106,
-       63,   99,  109,  119,  111,  115,  139,  136,  163,  147,
-      162,  166,  165,   88,  809,  809,   96,  809,   91,  809,
-       66,   80,   69,   81,  809,  809,  809,   46,   83,  195,
-      205,  190,   75,  209,  125,  191,  184,  217,  210,  213,
-      235,  224,  225,  231,  254,  259,  272,  252,  274,  261,
-      286,  287,  145,  294,  281,  300,  308,  326,  310,  313,
-      320,  332,  345,  347,    0,   68,  348,  257,  334,  335,
-
-      349,  368,  355,  374,  370,  392,  395,  384,  406,  398,
-      385,  394,  407,  411,  421,  434,  419,  446,  430,  447,
-      445,  433,  448,  457,  460,  458,  462,  463,  468,  466,
-      485,  486,  484,  501,  487,  503,  508,  504,  509,  510,
-      513,  523,  536,  511,  514,  546,  524,  527,  530,  552,
-      550,  549,  556,  562,  566,  572,  564,  568,  571,  576,
-      579,  604,  575,  578,  592,  588,  591,  617,  618,  614,
-      605,  631,  621,  625,  633,  637,  629,  632,  657,  647,
-      643,  667,  651,  673,  676,  680,  679,  659,  683,  684,
-      686,  687,  695,  694,  700,  720,  703,  705,  706,  709,
-
-      721,  724,  729,  730,  732,  809,  786,  790,  794,  797,
-      798,  800,  802,  804
+        0,    0,   71,    0,  405,  980,  980,  980,  328,  142,
+      213,  980,  980,  980,  980,  980,  333,  980,  980,  272,
+      980,  271,  980,  384,  329,  377,  405,  383,  407,  423,
+      366,  267,  378,  378,  435,  380,  436,  383,  454,  425,
+      468,  442,  437,  513,  980,  980,    0,  980,    0,  980,
+      332,  389,    0,  273,  980,  980,  980,  565,    0,  464,
+      448,  459,    0,  470,    0,  391,  484,  605,  614,  435,
+      609,  607,  614,  610,  609,  614,  619,  639,  623,  636,
+      611,  625,  620,  635,    0,  638,  637,  651,  652,  658,
+      661,  662,  675,  669,  675,  671,  670,  678,  710,    0,
+
+      751,    0,    0,    0,  755,  762,  749,  755,  755,  769,
+      770,  767,  770,  761,  759,  768,  773,  768,  769,  767,
+      779,  776,  781,  773,  785,  787,  806,    0,    0,    0,
+      796,  811,  806,  814,    0,  798,  804,    0,  821,  814,
+      810,  827,  816,  810,  814,  808,  820,    0,    0,  826,
+      818,  819,    0,    0,  820,    0,    0,  822,    0,  835,
+      825,  848,    0,    0,  830,  849,  849,    0,    0,  849,
+        0,  845,  852,  870,  870,    0,  873,    0,  870,  857,
+      859,  874,  877,  878,  859,    0,  866,    0,  883,  884,
+      872,  883,    0,  874,    0,  892,  883,    0,  886,    0,
+
+      897,  887,  906,  899,  909,  916,    0,  904,    0,  921,
+        0,    0,    0,    0,  914,    0,    0,    0,    0,  927,
+        0,  926,    0,    0,    0,    0,    0,    0,  923,    0,
+        0,  980
     } ;
 
-static const flex_int16_t yy_def[215] =
+static const flex_int16_t yy_def[233] =
     {   0,
-      206,    1,  207,  207,  206,  206,  206,  206,  206,  208,
-      209,  206,  206,  206,  206,  206,  206,  206,  206,  210,
-      206,  206,  206,  206,  211,  211,  211,  211,  211,  211,
-      211,  211,  211,  211,  211,  211,  211,  211,  211,  211,
-      211,  211,  211,  212,  206,  206,  208,  206,  209,  206,
-      206,  206,  210,  210,  206,  206,  206,  213,  211,  211,
-      211,  211,  212,  211,  211,  211,  211,  211,  211,  211,
-      211,  211,  211,  211,  211,  211,  211,  211,  211,  211,
-      211,  211,  211,  211,  211,  211,  211,  211,  211,  211,
-      211,  211,  211,  211,  214,  206,  211,  211,  211,  211,
-
-      211,  211,  211,  211,  211,  211,  211,  211,  211,  211,
-      211,  211,  211,  211,  211,  211,  211,  211,  211,  211,
-      211,  211,  211,  211,  211,  211,  211,  211,  211,  211,
-      211,  211,  211,  211,  211,  211,  211,  211,  211,  211,
-      211,  211,  211,  211,  211,  211,  211,  211,  211,  211,
-      211,  211,  211,  211,  211,  211,  211,  211,  211,  211,
-      211,  211,  211,  211,  211,  211,  211,  211,  211,  211,
-      211,  211,  211,  211,  211,  211,  211,  211,  211,  211,
-      211,  211,  211,  211,  211,  211,  211,  211,  211,  211,
-      211,  211,  211,  211,  211,  211,  211,  211,  211,  211,
-
-      211,  211,  211,  211,  211,    0,  206,  206,  206,  206,
-      206,  206,  206,  206
+      232,    1,  232,    3,  232,  232,  232,  232,  232,  232,
+      232,  232,  232,  232,  232,  232,  232,  232,  232,  232,
+      232,  232,  232,  232,  232,   25,   26,   26,   26,   29,
+       29,   31,   31,   31,   31,   31,   31,   31,   26,   31,
+       31,   31,   31,   25,  232,  232,   10,  232,   11,  232,
+      232,  232,   20,   20,  232,  232,  232,   25,   31,   31,
+       31,   31,   44,   31,   31,   31,   31,   31,   31,   31,
+       31,   31,   31,   31,   31,   31,   31,   31,   31,   31,
+       29,   31,   31,   31,   31,   31,   31,   31,   31,   31,
+       31,   31,   31,   31,   31,   31,   31,   31,   44,   52,
+
+       31,   31,   31,   31,   31,   31,   31,   31,   31,   31,
+       31,   31,   31,   31,   31,   31,   31,   31,   31,   31,
+       31,   31,   31,   31,   31,   31,   31,   31,   31,   31,
+       31,   31,   31,   31,   31,   31,   31,   31,   31,   31,
+       31,   31,   31,   31,   31,   31,   31,   31,   31,   31,
+       31,   31,   31,   31,   31,   31,   31,   31,   31,   31,
+       31,   31,   31,   31,   29,   31,   31,   31,   31,   31,
+       31,   31,   31,   31,   31,   31,   31,   31,   31,   31,
+       31,   31,   31,   31,   31,   31,   31,   31,   31,   31,
+       31,   31,   31,   31,   31,   31,   31,   31,   31,   31,
+
+       31,   31,   31,   31,   31,   31,   31,   31,   31,   31,
+       31,   31,   31,   31,   31,   31,   31,   31,   31,   31,
+       31,   31,   31,   31,   31,   31,   31,   31,   31,   31,
+       31,    0
     } ;
 
-static const flex_int16_t yy_nxt[881] =
+static const flex_int16_t yy_nxt[1052] =
     {   0,
         6,    7,    8,    9,   10,   11,   12,   13,   14,   15,
        16,   17,   18,   19,   20,   21,   22,   23,   24,   25,
@@ -530,98 +537,118 @@ static const flex_int16_t yy_nxt[881] =
        42,   43,   31,   31,   31,   44,   25,   26,   27,   28,
        29,   30,   31,   32,   33,   31,   34,   35,   36,   37,
        31,   31,   38,   39,   40,   41,   42,   43,   31,   31,
-       31,   52,   58,   53,   55,   56,   58,   58,   52,   58,
-       51,   52,   96,   53,   70,   64,   58,   58,   71,   95,
-       60,   95,   66,  206,   96,   61,   50,   58,   62,   67,
-
-       48,   72,   95,   63,   57,   65,   68,   63,   63,   69,
-       63,   70,   64,   58,   73,   71,   60,   63,   63,   66,
-       58,   61,   76,   58,   62,   58,   67,   72,   63,   58,
-       80,   65,   68,   58,   51,   69,   74,   50,   81,   58,
-       73,   77,   75,   48,   63,   46,   78,  206,   82,   76,
-       58,   63,   79,   58,   63,  206,   63,   80,  206,   58,
-       63,   58,   74,  206,   63,   81,   90,   77,   75,   85,
-       63,   83,  206,   78,   82,   84,   58,   58,   79,   58,
-       58,   63,  206,  206,   63,   93,   86,  206,  206,   87,
-       63,   94,   63,   90,   91,   85,   92,   83,   58,  206,
-
-      206,   84,   88,  103,   58,   58,   89,   63,   63,   58,
-       63,   63,   93,   86,   97,  100,   87,   98,   94,   58,
-       91,  102,   92,   58,   58,  206,   99,   58,   88,   63,
-      103,   58,   89,  106,  101,   63,   63,  206,   58,   58,
-       63,   97,  100,  206,   98,   58,  206,  102,  104,   58,
-       63,  107,  111,   99,   63,   63,  105,  110,   63,  112,
-      106,  101,   63,  206,  113,  108,   58,  206,   58,   63,
-       63,   58,  109,   58,  104,   58,   63,  107,  206,  111,
-       63,  120,  105,  110,  206,  112,   58,  114,   58,  115,
-      113,  108,  206,  121,  116,   58,  117,   63,  109,   63,
-
-       58,   58,   63,  122,   63,  206,   63,  120,   58,  118,
-      119,  126,  206,  114,   58,  115,  125,   63,  123,   63,
-      121,  116,   58,  117,   58,  124,   63,   58,  206,  122,
-      127,   63,   63,  132,   58,  118,  119,  126,  128,   63,
-       58,  129,  131,  125,  123,   63,   58,  133,   58,   58,
-      206,  124,  206,   63,  134,   63,  127,  130,   63,   58,
-      132,   58,   58,   58,  128,   63,  206,  129,  131,   58,
-      136,   63,  206,  206,  133,  135,  138,   63,  137,   63,
-       63,  134,   58,  130,   58,  206,  206,  206,   58,  139,
-       63,  140,   63,   63,   63,  206,  206,  136,   58,   58,
-
-       63,  135,  142,  138,  137,  141,   58,  146,   58,   58,
-      206,  143,   58,   63,  144,   63,  139,  140,  145,   63,
-       58,   58,  206,  149,  150,   58,  151,  147,  142,   63,
-       63,  141,  148,   58,  146,   58,  206,   63,  143,   63,
-       63,  144,  152,   63,   58,  145,  155,   58,   58,  149,
-      150,   63,   63,  151,  147,  153,   63,  154,  148,   58,
-       58,   58,   58,  157,   63,  206,   63,  159,  152,  156,
-      158,   58,   58,  155,   58,   63,   58,   58,   63,   63,
-       58,  153,   58,  160,  154,  162,  206,  206,  161,  157,
-       63,   63,   63,   63,  159,  206,  156,  158,   58,   58,
-
-       58,   58,   63,   63,  206,   63,  164,   63,   63,  163,
-      160,   63,  162,   63,  161,   58,  165,   58,   58,  166,
-      167,  206,   58,   58,   58,   58,  168,   58,   58,   63,
-       63,   63,   63,  164,  206,  163,  171,   58,   58,  169,
-      172,   58,  165,  206,   58,  166,   63,  167,   63,   63,
-       58,  170,  168,   63,   63,   63,   63,  206,   63,   63,
-       58,  173,  171,   58,   58,  169,   58,  172,   63,   63,
-       58,  176,   63,  206,  174,   63,   58,  170,   58,  206,
-       58,   63,   58,  206,  175,   58,   58,  173,  177,   58,
-       58,   63,   58,   58,   63,   63,  179,   63,  176,  182,
-
-      174,   63,   58,  206,  178,   58,   58,   63,  180,   63,
-      175,   63,  181,   63,  177,  184,   63,   63,   58,   58,
-       63,   63,  179,   63,   63,  183,  182,  185,   58,  186,
-      178,   58,   58,   63,  180,   58,   63,   63,  181,   58,
-      187,  188,  184,   58,  206,   58,   58,   58,  191,   63,
-       63,   58,  183,  185,  206,  186,  192,   58,  189,   63,
-      206,   58,   63,   63,  193,   58,   63,  187,  188,  190,
-       63,   58,  206,   58,   63,  191,   63,   63,   63,  206,
-      194,   58,   63,  192,  189,  195,  196,   58,   63,  197,
-       58,  193,   63,   58,   58,  190,   63,   58,   58,  199,
-
-       58,   58,   63,  200,   63,  206,  202,  194,   58,   58,
-      198,  195,   63,  196,   58,  197,  201,   58,   63,   58,
-       58,   63,  206,   58,   63,   63,  199,  203,   63,   63,
-      200,   63,   63,  202,   58,   58,  198,  206,   58,   63,
-       63,  204,  201,   58,   58,   63,   58,  206,   63,  206,
-       63,   63,  206,  203,   63,  206,  206,  206,  206,  205,
-      206,  206,  206,  206,  206,   63,   63,  206,  204,   63,
-      206,  206,  206,  206,   63,   63,  206,   63,  206,  206,
-      206,  206,  206,  206,  206,  205,   45,   45,   45,   45,
-       47,   47,   47,   47,   49,   49,   49,   49,   54,   54,
-
-       59,   59,   63,   63,   58,   58,   95,   95,    5,  206,
-      206,  206,  206,  206,  206,  206,  206,  206,  206,  206,
-      206,  206,  206,  206,  206,  206,  206,  206,  206,  206,
-      206,  206,  206,  206,  206,  206,  206,  206,  206,  206,
-      206,  206,  206,  206,  206,  206,  206,  206,  206,  206,
-      206,  206,  206,  206,  206,  206,  206,  206,  206,  206,
-      206,  206,  206,  206,  206,  206,  206,  206,  206,  206,
-      206,  206,  206,  206,  206,  206,  206,  206,  206,  206
+       31,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+       45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+       45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+
+       45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+       45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+       45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+       45,   45,   45,   45,   45,   45,   45,   45,   45,   45,
+       45,   45,   47,   47,   47,   47,   48,   47,   47,   47,
+       47,   47,   47,   47,   47,   47,   47,   47,   47,   47,
+       47,   47,   47,   47,   47,   47,   47,   47,   47,   47,
+       47,   47,   47,   47,   47,   47,   47,   47,   47,   47,
+       47,   47,   47,   47,   47,   47,   47,   47,   47,   47,
+       47,   47,   47,   47,   47,   47,   47,   47,   47,   47,
+
+       47,   47,   47,   47,   47,   47,   47,   47,   47,   47,
+       47,   47,   47,   49,   49,   49,   49,   49,   50,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+       49,   49,   49,   49,   49,   49,   49,   49,   49,   49,
+       49,   49,   49,   49,   52,  232,   53,   54,   55,   56,
+       77,   54,   54,   54,   54,   54,   54,   54,   54,   54,
+
+       54,   54,   54,   54,   54,   54,   54,   54,   54,   54,
+       54,   54,   54,   54,   54,   54,   54,   77,   54,   54,
+       54,   54,   54,   54,   54,   54,   54,   54,   54,   54,
+       54,   54,   54,   54,   54,   54,   54,   54,   54,   54,
+       54,   54,   54,   58,   52,   46,   51,   51,   59,   59,
+       59,   59,   59,   59,   59,   59,   59,   59,   59,   59,
+       59,   60,   59,   59,   59,   59,   61,   59,   59,   62,
+       59,   59,   59,   59,   63,   59,   59,   59,   59,   59,
+       59,   59,   59,   59,   59,   59,   59,   60,   59,   59,
+       59,   59,   61,   59,   59,   62,   59,   59,   59,   59,
+
+       64,   57,   70,  100,  232,   79,   71,  232,   59,   59,
+       78,   80,  232,   83,   59,  232,   87,   59,  232,   72,
+       65,  106,  232,  232,   66,  232,   59,   64,   59,   70,
+       59,   67,   79,   71,   59,   59,   78,   80,   68,   83,
+       59,   69,   87,   59,   93,   72,   65,  106,   59,   73,
+       59,   66,   59,   74,   81,   59,   75,   59,   67,   76,
+       84,   97,   82,   98,   68,   59,  232,   69,   85,  103,
+      232,   93,   86,  111,   59,   73,   59,   88,  232,   74,
+       89,   81,   75,  101,  104,   76,  102,   84,   97,   82,
+       98,   59,   90,   91,   85,  105,  103,   92,   86,  111,
+
+       94,  232,   95,  107,   88,   96,  232,   89,  232,  232,
+      101,  104,  232,  102,  232,  232,  232,  232,   90,   91,
+      232,  232,  105,   92,  232,  232,   94,   99,   95,  232,
+      107,   96,   63,   63,   63,   63,   63,   63,   63,   63,
+       63,   63,   63,   63,   63,   63,   63,   63,   63,   63,
+       63,   63,   63,   63,   63,   63,   63,   63,  232,   63,
+       63,   63,   63,   63,   63,   63,   63,   63,   63,   63,
+       63,   63,   63,   63,   63,   63,   63,   63,   63,   63,
+       63,   63,   63,   63,   58,   58,   58,   58,   58,   58,
+       58,   58,   58,   58,   58,   58,   58,   58,   58,   58,
+
+       58,   58,   58,   58,   58,   58,   58,   58,   58,   58,
+       99,   58,   58,   58,   58,   58,   58,   58,   58,   58,
+       58,   58,   58,   58,   58,   58,   58,   58,   58,   58,
+       58,   58,   58,   58,   58,   58,  108,  110,  232,  112,
+      114,  115,  232,  117,  109,  118,  113,  119,  116,  120,
+      232,  232,  125,  128,  126,  127,  232,  129,  130,  131,
+      132,  121,  108,  122,  110,  112,  114,  133,  115,  117,
+      109,  118,  113,  119,  116,  120,  123,  124,  125,  128,
+      126,  134,  127,  129,  130,  136,  131,  132,  121,  135,
+      122,  137,  138,  133,  139,  140,  141,  142,  143,  232,
+
+      144,  145,  123,  124,  232,  232,  232,  134,  232,  232,
+      232,  136,  232,  232,  232,  135,  232,  137,  138,  232,
+      139,  232,  140,  141,  142,  143,  144,  232,  145,   99,
+       99,   99,   99,   99,   99,   99,   99,   99,   99,   99,
+       99,   99,   99,   99,   99,   99,   99,   99,   99,   99,
+       99,   99,   99,   99,   99,   99,   99,   99,   99,   99,
+       99,   99,   99,   99,   99,   99,   99,   99,   99,   99,
+       99,   99,   99,   99,   99,   99,   99,   99,   99,   99,
+       99,  146,  147,  148,  232,  149,  150,  151,  152,  153,
+      155,  156,  161,  154,  232,  157,  158,  159,  160,  162,
+
+      163,  164,  165,  166,  167,  232,  168,  146,  169,  147,
+      148,  149,  150,  151,  170,  152,  153,  155,  156,  161,
+      154,  157,  158,  159,  160,  162,  163,  164,  171,  165,
+      166,  167,  168,  172,  173,  169,  174,  175,  232,  176,
+      177,  170,  178,  232,  179,  180,  181,  232,  182,  183,
+      184,  185,  186,  187,  192,  171,  188,  189,  190,  172,
+      191,  173,  174,  193,  175,  176,  177,  194,  199,  178,
+      179,  180,  195,  181,  182,  183,  184,  185,  186,  196,
+      187,  192,  188,  189,  190,  197,  191,  198,  200,  193,
+      201,  202,  203,  204,  194,  199,  205,  206,  195,  207,
+
+      208,  209,  232,  210,  211,  196,  212,  213,  232,  214,
+      215,  197,  216,  198,  200,  217,  220,  201,  202,  203,
+      204,  218,  205,  206,  219,  221,  207,  208,  209,  210,
+      211,  222,  224,  212,  213,  214,  223,  215,  216,  225,
+      232,  226,  217,  220,  227,  232,  228,  218,  229,  230,
+      219,  221,  231,  232,  232,  232,  232,  232,  222,  224,
+      232,  232,  223,  232,  232,  232,  225,  226,  232,  232,
+      232,  227,  228,  232,  232,  229,  230,  232,  231,    5,
+      232,  232,  232,  232,  232,  232,  232,  232,  232,  232,
+      232,  232,  232,  232,  232,  232,  232,  232,  232,  232,
+
+      232,  232,  232,  232,  232,  232,  232,  232,  232,  232,
+      232,  232,  232,  232,  232,  232,  232,  232,  232,  232,
+      232,  232,  232,  232,  232,  232,  232,  232,  232,  232,
+      232,  232,  232,  232,  232,  232,  232,  232,  232,  232,
+      232,  232,  232,  232,  232,  232,  232,  232,  232,  232,
+      232
     } ;
 
-static const flex_int16_t yy_chk[881] =
+static const flex_int16_t yy_chk[1052] =
     {   0,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
@@ -630,95 +657,115 @@ static const flex_int16_t yy_chk[881] =
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,   20,   25,   20,   22,   22,   26,   31,   51,   28,
-       51,   53,   96,   53,   28,   26,   29,   27,   28,   63,
-       25,   58,   27,   54,   52,   25,   49,   59,   25,   27,
-
-       47,   28,   44,   25,   24,   26,   27,   26,   31,   27,
-       28,   28,   26,   32,   29,   28,   25,   29,   27,   27,
-       30,   25,   32,   33,   25,   35,   27,   28,   59,   36,
-       35,   26,   27,   34,   17,   27,   30,   11,   35,   65,
-       29,   33,   30,   10,   32,    9,   34,    5,   36,   32,
-       38,   30,   34,   37,   33,    0,   35,   35,    0,   83,
-       36,   40,   30,    0,   34,   35,   40,   33,   30,   38,
-       65,   37,    0,   34,   36,   37,   41,   39,   34,   43,
-       42,   38,    0,    0,   37,   42,   39,    0,    0,   39,
-       83,   43,   40,   40,   41,   38,   41,   37,   67,    0,
-
-        0,   37,   39,   67,   62,   66,   39,   41,   39,   60,
-       43,   42,   42,   39,   60,   62,   39,   60,   43,   61,
-       41,   66,   41,   64,   69,    0,   61,   70,   39,   67,
-       67,   68,   39,   69,   64,   62,   66,    0,   72,   73,
-       60,   60,   62,    0,   60,   74,    0,   66,   68,   71,
-       61,   70,   73,   61,   64,   69,   68,   72,   70,   73,
-       69,   64,   68,    0,   74,   71,   78,    0,   75,   72,
-       73,   98,   71,   76,   68,   80,   74,   70,    0,   73,
-       71,   78,   68,   72,    0,   73,   77,   75,   79,   76,
-       74,   71,    0,   79,   77,   85,   77,   78,   71,   75,
-
-       81,   82,   98,   80,   76,    0,   80,   78,   84,   77,
-       77,   85,    0,   75,   86,   76,   84,   77,   81,   79,
-       79,   77,   87,   77,   89,   82,   85,   90,    0,   80,
-       86,   81,   82,   90,   91,   77,   77,   85,   86,   84,
-       88,   87,   89,   84,   81,   86,   92,   91,   99,  100,
-        0,   82,    0,   87,   92,   89,   86,   88,   90,   93,
-       90,   94,   97,  101,   86,   91,    0,   87,   89,  103,
-       94,   88,    0,    0,   91,   93,  101,   92,   97,   99,
-      100,   92,  102,   88,  105,    0,    0,    0,  104,  102,
-       93,  103,   94,   97,  101,    0,    0,   94,  108,  111,
-
-      103,   93,  105,  101,   97,  104,  106,  108,  112,  107,
-        0,  106,  110,  102,  107,  105,  102,  103,  107,  104,
-      109,  113,    0,  111,  112,  114,  113,  109,  105,  108,
-      111,  104,  110,  117,  108,  115,    0,  106,  106,  112,
-      107,  107,  114,  110,  119,  107,  117,  122,  116,  111,
-      112,  109,  113,  113,  109,  115,  114,  116,  110,  121,
-      118,  120,  123,  119,  117,    0,  115,  121,  114,  118,
-      120,  124,  126,  117,  125,  119,  127,  128,  122,  116,
-      130,  115,  129,  125,  116,  127,    0,    0,  126,  119,
-      121,  118,  120,  123,  121,    0,  118,  120,  133,  131,
-
-      132,  135,  124,  126,    0,  125,  131,  127,  128,  129,
-      125,  130,  127,  129,  126,  134,  132,  136,  138,  133,
-      134,    0,  137,  139,  140,  144,  135,  141,  145,  133,
-      131,  132,  135,  131,    0,  129,  138,  142,  147,  136,
-      141,  148,  132,    0,  149,  133,  134,  134,  136,  138,
-      143,  137,  135,  137,  139,  140,  144,    0,  141,  145,
-      146,  142,  138,  152,  151,  136,  150,  141,  142,  147,
-      153,  150,  148,    0,  143,  149,  154,  137,  157,    0,
-      155,  143,  158,    0,  146,  159,  156,  142,  151,  163,
-      160,  146,  164,  161,  152,  151,  155,  150,  150,  161,
-
-      143,  153,  166,    0,  154,  167,  165,  154,  156,  157,
-      146,  155,  160,  158,  151,  165,  159,  156,  162,  171,
-      163,  160,  155,  164,  161,  162,  161,  166,  170,  167,
-      154,  168,  169,  166,  156,  173,  167,  165,  160,  174,
-      168,  169,  165,  177,    0,  172,  178,  175,  174,  162,
-      171,  176,  162,  166,    0,  167,  175,  181,  170,  170,
-        0,  180,  168,  169,  176,  183,  173,  168,  169,  172,
-      174,  179,    0,  188,  177,  174,  172,  178,  175,    0,
-      179,  182,  176,  175,  170,  180,  182,  184,  181,  183,
-      185,  176,  180,  187,  186,  172,  183,  189,  190,  185,
-
-      191,  192,  179,  186,  188,    0,  189,  179,  194,  193,
-      184,  180,  182,  182,  195,  183,  187,  197,  184,  198,
-      199,  185,    0,  200,  187,  186,  185,  193,  189,  190,
-      186,  191,  192,  189,  196,  201,  184,    0,  202,  194,
-      193,  196,  187,  203,  204,  195,  205,    0,  197,    0,
-      198,  199,    0,  193,  200,    0,    0,    0,    0,  204,
-        0,    0,    0,    0,    0,  196,  201,    0,  196,  202,
-        0,    0,    0,    0,  203,  204,    0,  205,    0,    0,
-        0,    0,    0,    0,    0,  204,  207,  207,  207,  207,
-      208,  208,  208,  208,  209,  209,  209,  209,  210,  210,
-
-      211,  211,  212,  212,  213,  213,  214,  214,  206,  206,
-      206,  206,  206,  206,  206,  206,  206,  206,  206,  206,
-      206,  206,  206,  206,  206,  206,  206,  206,  206,  206,
-      206,  206,  206,  206,  206,  206,  206,  206,  206,  206,
-      206,  206,  206,  206,  206,  206,  206,  206,  206,  206,
-      206,  206,  206,  206,  206,  206,  206,  206,  206,  206,
-      206,  206,  206,  206,  206,  206,  206,  206,  206,  206,
-      206,  206,  206,  206,  206,  206,  206,  206,  206,  206
+        1,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,    3,    3,    3,    3,    3,    3,    3,    3,
+        3,    3,   10,   10,   10,   10,   10,   10,   10,   10,
+       10,   10,   10,   10,   10,   10,   10,   10,   10,   10,
+       10,   10,   10,   10,   10,   10,   10,   10,   10,   10,
+       10,   10,   10,   10,   10,   10,   10,   10,   10,   10,
+       10,   10,   10,   10,   10,   10,   10,   10,   10,   10,
+       10,   10,   10,   10,   10,   10,   10,   10,   10,   10,
+
+       10,   10,   10,   10,   10,   10,   10,   10,   10,   10,
+       10,   10,   10,   11,   11,   11,   11,   11,   11,   11,
+       11,   11,   11,   11,   11,   11,   11,   11,   11,   11,
+       11,   11,   11,   11,   11,   11,   11,   11,   11,   11,
+       11,   11,   11,   11,   11,   11,   11,   11,   11,   11,
+       11,   11,   11,   11,   11,   11,   11,   11,   11,   11,
+       11,   11,   11,   11,   11,   11,   11,   11,   11,   11,
+       11,   11,   11,   11,   11,   11,   11,   11,   11,   11,
+       11,   11,   11,   11,   20,   54,   20,   54,   22,   22,
+       32,   20,   20,   20,   20,   20,   20,   20,   20,   20,
+
+       20,   20,   20,   20,   20,   20,   20,   20,   20,   20,
+       20,   20,   20,   20,   20,   20,   20,   32,   20,   20,
+       20,   20,   20,   20,   20,   20,   20,   20,   20,   20,
+       20,   20,   20,   20,   20,   20,   20,   20,   20,   20,
+       20,   20,   20,   25,   51,    9,   51,   17,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+
+       26,   24,   28,   52,    5,   34,   28,    0,   31,   26,
+       33,   34,    0,   36,   26,    0,   38,   26,    0,   28,
+       26,   66,    0,    0,   27,    0,   28,   26,   27,   28,
+       29,   27,   34,   28,   31,   26,   33,   34,   27,   36,
+       26,   27,   38,   26,   40,   28,   26,   66,   27,   29,
+       29,   27,   28,   30,   35,   27,   30,   29,   27,   30,
+       37,   42,   35,   43,   27,   30,    0,   27,   37,   61,
+        0,   40,   37,   70,   27,   29,   29,   39,    0,   30,
+       39,   35,   30,   60,   62,   30,   60,   37,   42,   35,
+       43,   30,   39,   39,   37,   64,   61,   39,   37,   70,
+
+       41,    0,   41,   67,   39,   41,    0,   39,    0,    0,
+       60,   62,    0,   60,    0,    0,    0,    0,   39,   39,
+        0,    0,   64,   39,    0,    0,   41,   44,   41,    0,
+       67,   41,   44,   44,   44,   44,   44,   44,   44,   44,
+       44,   44,   44,   44,   44,   44,   44,   44,   44,   44,
+       44,   44,   44,   44,   44,   44,   44,   44,    0,   44,
+       44,   44,   44,   44,   44,   44,   44,   44,   44,   44,
+       44,   44,   44,   44,   44,   44,   44,   44,   44,   44,
+       44,   44,   44,   44,   58,   58,   58,   58,   58,   58,
+       58,   58,   58,   58,   58,   58,   58,   58,   58,   58,
+
+       58,   58,   58,   58,   58,   58,   58,   58,   58,   58,
+       58,   58,   58,   58,   58,   58,   58,   58,   58,   58,
+       58,   58,   58,   58,   58,   58,   58,   58,   58,   58,
+       58,   58,   58,   58,   58,   58,   68,   69,    0,   71,
+       72,   73,    0,   74,   68,   75,   71,   76,   73,   77,
+        0,    0,   79,   81,   79,   80,    0,   82,   83,   84,
+       86,   78,   68,   78,   69,   71,   72,   87,   73,   74,
+       68,   75,   71,   76,   73,   77,   78,   78,   79,   81,
+       79,   88,   80,   82,   83,   89,   84,   86,   78,   88,
+       78,   90,   91,   87,   92,   93,   94,   95,   96,    0,
+
+       97,   98,   78,   78,    0,    0,    0,   88,    0,    0,
+        0,   89,    0,    0,    0,   88,    0,   90,   91,    0,
+       92,    0,   93,   94,   95,   96,   97,    0,   98,   99,
+       99,   99,   99,   99,   99,   99,   99,   99,   99,   99,
+       99,   99,   99,   99,   99,   99,   99,   99,   99,   99,
+       99,   99,   99,   99,   99,   99,   99,   99,   99,   99,
+       99,   99,   99,   99,   99,   99,   99,   99,   99,   99,
+       99,   99,   99,   99,   99,   99,   99,   99,   99,   99,
+       99,  101,  105,  106,    0,  107,  108,  109,  110,  111,
+      112,  113,  117,  111,    0,  114,  115,  115,  116,  118,
+
+      119,  120,  121,  122,  123,    0,  124,  101,  125,  105,
+      106,  107,  108,  109,  126,  110,  111,  112,  113,  117,
+      111,  114,  115,  115,  116,  118,  119,  120,  127,  121,
+      122,  123,  124,  131,  132,  125,  133,  134,    0,  136,
+      137,  126,  139,    0,  140,  141,  142,    0,  143,  144,
+      145,  146,  147,  150,  160,  127,  151,  152,  155,  131,
+      158,  132,  133,  161,  134,  136,  137,  162,  172,  139,
+      140,  141,  165,  142,  143,  144,  145,  146,  147,  166,
+      150,  160,  151,  152,  155,  167,  158,  170,  173,  161,
+      174,  175,  177,  179,  162,  172,  180,  181,  165,  182,
+
+      183,  184,    0,  185,  187,  166,  189,  190,    0,  191,
+      192,  167,  194,  170,  173,  196,  201,  174,  175,  177,
+      179,  197,  180,  181,  199,  202,  182,  183,  184,  185,
+      187,  203,  205,  189,  190,  191,  204,  192,  194,  206,
+        0,  208,  196,  201,  210,    0,  215,  197,  220,  222,
+      199,  202,  229,    0,    0,    0,    0,    0,  203,  205,
+        0,    0,  204,    0,    0,    0,  206,  208,    0,    0,
+        0,  210,  215,    0,    0,  220,  222,    0,  229,  232,
+      232,  232,  232,  232,  232,  232,  232,  232,  232,  232,
+      232,  232,  232,  232,  232,  232,  232,  232,  232,  232,
+
+      232,  232,  232,  232,  232,  232,  232,  232,  232,  232,
+      232,  232,  232,  232,  232,  232,  232,  232,  232,  232,
+      232,  232,  232,  232,  232,  232,  232,  232,  232,  232,
+      232,  232,  232,  232,  232,  232,  232,  232,  232,  232,
+      232,  232,  232,  232,  232,  232,  232,  232,  232,  232,
+      232
     } ;
 
 /* The intent behind this definition is that it'll catch
@@ -753,7 +800,7 @@ extern int atoi();
 extern double atof();
 
 #define RETURN_TOKEN(token) LOG_DEBUG("%s", #token);return token
-#line 757 "lex_sql.cpp"
+#line 804 "lex_sql.cpp"
 /* Prevent the need for linking with -lfl */
 #define YY_NO_INPUT 1
 /* 不区分大小写 */
@@ -762,7 +809,7 @@ extern double atof();
 /* 1. 匹配的规则长的优先 */
 /* 2. 写在最前面的优先 */
 /* yylval 就可以认为是 yacc 中 %union 定义的结构体(union 结构) */
-#line 766 "lex_sql.cpp"
+#line 813 "lex_sql.cpp"
 
 #define INITIAL 0
 #define STR 1
@@ -1048,7 +1095,7 @@ YY_DECL
 #line 76 "lex_sql.l"
 
 
-#line 1052 "lex_sql.cpp"
+#line 1099 "lex_sql.cpp"
 
 	while ( /*CONSTCOND*/1 )		/* loops until end-of-file is reached */
 		{
@@ -1075,13 +1122,13 @@ yy_match:
 			while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 				{
 				yy_current_state = (int) yy_def[yy_current_state];
-				if ( yy_current_state >= 207 )
+				if ( yy_current_state >= 233 )
 					yy_c = yy_meta[yy_c];
 				}
 			yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
 			++yy_cp;
 			}
-		while ( yy_base[yy_current_state] != 809 );
+		while ( yy_base[yy_current_state] != 980 );
 
 yy_find_action:
 		yy_act = yy_accept[yy_current_state];
@@ -1364,97 +1411,132 @@ RETURN_TOKEN(LK);
 case 52:
 YY_RULE_SETUP
 #line 131 "lex_sql.l"
-yylval->string=strdup(yytext); RETURN_TOKEN(ID);
+RETURN_TOKEN(IN);
 	YY_BREAK
 case 53:
 YY_RULE_SETUP
 #line 132 "lex_sql.l"
-yylval->string=strdup(yytext); RETURN_TOKEN(AGGRE_ATTR);
+RETURN_TOKEN(EXISTS);
 	YY_BREAK
 case 54:
 YY_RULE_SETUP
 #line 133 "lex_sql.l"
-RETURN_TOKEN(LBRACE);
+RETURN_TOKEN(LIMIT);
 	YY_BREAK
 case 55:
 YY_RULE_SETUP
 #line 134 "lex_sql.l"
-RETURN_TOKEN(RBRACE);
+RETURN_TOKEN(OFFSET);
 	YY_BREAK
 case 56:
 YY_RULE_SETUP
-#line 136 "lex_sql.l"
-RETURN_TOKEN(COMMA);
+#line 135 "lex_sql.l"
+RETURN_TOKEN(USING);
 	YY_BREAK
 case 57:
 YY_RULE_SETUP
-#line 137 "lex_sql.l"
-RETURN_TOKEN(EQ);
+#line 136 "lex_sql.l"
+RETURN_TOKEN(STORAGE);
 	YY_BREAK
 case 58:
 YY_RULE_SETUP
-#line 138 "lex_sql.l"
-RETURN_TOKEN(LE);
+#line 137 "lex_sql.l"
+RETURN_TOKEN(FORMAT);
 	YY_BREAK
 case 59:
 YY_RULE_SETUP
-#line 139 "lex_sql.l"
-RETURN_TOKEN(NE);
+#line 138 "lex_sql.l"
+yylval->string=strdup(yytext); RETURN_TOKEN(ID);
 	YY_BREAK
 case 60:
 YY_RULE_SETUP
-#line 140 "lex_sql.l"
-RETURN_TOKEN(NE);
+#line 139 "lex_sql.l"
+yylval->string=strdup(yytext); RETURN_TOKEN(AGGRE_ATTR);
 	YY_BREAK
 case 61:
 YY_RULE_SETUP
-#line 141 "lex_sql.l"
-RETURN_TOKEN(LT);
+#line 140 "lex_sql.l"
+RETURN_TOKEN(LBRACE);
 	YY_BREAK
 case 62:
 YY_RULE_SETUP
-#line 142 "lex_sql.l"
-RETURN_TOKEN(GE);
+#line 141 "lex_sql.l"
+RETURN_TOKEN(RBRACE);
 	YY_BREAK
 case 63:
 YY_RULE_SETUP
 #line 143 "lex_sql.l"
-RETURN_TOKEN(GT);
+RETURN_TOKEN(COMMA);
 	YY_BREAK
 case 64:
-#line 146 "lex_sql.l"
+YY_RULE_SETUP
+#line 144 "lex_sql.l"
+RETURN_TOKEN(EQ);
+	YY_BREAK
 case 65:
-#line 147 "lex_sql.l"
+YY_RULE_SETUP
+#line 145 "lex_sql.l"
+RETURN_TOKEN(LE);
+	YY_BREAK
 case 66:
-#line 148 "lex_sql.l"
+YY_RULE_SETUP
+#line 146 "lex_sql.l"
+RETURN_TOKEN(NE);
+	YY_BREAK
 case 67:
 YY_RULE_SETUP
-#line 148 "lex_sql.l"
-{ return yytext[0]; }
+#line 147 "lex_sql.l"
+RETURN_TOKEN(NE);
 	YY_BREAK
 case 68:
-/* rule 68 can match eol */
 YY_RULE_SETUP
-#line 149 "lex_sql.l"
-yylval->string = strdup(yytext); RETURN_TOKEN(SSS);
+#line 148 "lex_sql.l"
+RETURN_TOKEN(LT);
 	YY_BREAK
 case 69:
-/* rule 69 can match eol */
+YY_RULE_SETUP
+#line 149 "lex_sql.l"
+RETURN_TOKEN(GE);
+	YY_BREAK
+case 70:
 YY_RULE_SETUP
 #line 150 "lex_sql.l"
+RETURN_TOKEN(GT);
+	YY_BREAK
+case 71:
+#line 153 "lex_sql.l"
+case 72:
+#line 154 "lex_sql.l"
+case 73:
+#line 155 "lex_sql.l"
+case 74:
+YY_RULE_SETUP
+#line 155 "lex_sql.l"
+{ return yytext[0]; }
+	YY_BREAK
+case 75:
+/* rule 75 can match eol */
+YY_RULE_SETUP
+#line 156 "lex_sql.l"
 yylval->string = strdup(yytext); RETURN_TOKEN(SSS);
 	YY_BREAK
-case 70:
+case 76:
+/* rule 76 can match eol */
+YY_RULE_SETUP
+#line 157 "lex_sql.l"
+yylval->string = strdup(yytext); RETURN_TOKEN(SSS);
+	YY_BREAK
+case 77:
 YY_RULE_SETUP
-#line 152 "lex_sql.l"
+#line 159 "lex_sql.l"
 LOG_DEBUG("Unknown character [%c]",yytext[0]); return yytext[0];
 	YY_BREAK
-case 71:
+case 78:
 YY_RULE_SETUP
-#line 153 "lex_sql.l"
+#line 160 "lex_sql.l"
 ECHO;
 	YY_BREAK
-#line 1458 "lex_sql.cpp"
+#line 1540 "lex_sql.cpp"
 case YY_STATE_EOF(INITIAL):
 case YY_STATE_EOF(STR):
 	yyterminate();
@@ -1754,7 +1836,7 @@ static int yy_get_next_buffer (yyscan_t yyscanner)
 		while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 			{
 			yy_current_state = (int) yy_def[yy_current_state];
-			if ( yy_current_state >= 207 )
+			if ( yy_current_state >= 233 )
 				yy_c = yy_meta[yy_c];
 			}
 		yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
@@ -1783,11 +1865,11 @@ static int yy_get_next_buffer (yyscan_t yyscanner)
 	while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 		{
 		yy_current_state = (int) yy_def[yy_current_state];
-		if ( yy_current_state >= 207 )
+		if ( yy_current_state >= 233 )
 			yy_c = yy_meta[yy_c];
 		}
 	yy_current_state = yy_nxt[yy_base[yy_current_state] + yy_c];
-	yy_is_jam = (yy_current_state == 206);
+	yy_is_jam = (yy_current_state == 232);
 
 	(void)yyg;
 	return yy_is_jam ? 0 : yy_current_state;
@@ -2610,10 +2692,8 @@ void yyfree (void * ptr , yyscan_t yyscanner)
 
 #define YYTABLES_NAME "yytables"
 
-#line 153 "lex_sql.l"
-
+#line 160 "lex_sql.l"
 
 void scan_string(const char *str, yyscan_t scanner) {
   yy_switch_to_buffer(yy_scan_string(str, scanner), scanner);
 }
-
@@ -35,6 +35,7 @@ enum OrderType
 };
 
 struct OrderSqlNode;
+struct SelectSqlNode;
 
 /**
  * @defgroup SQLParser SQL Parser
@@ -112,6 +113,7 @@ struct RelAttrSqlNode
  * 一个条件比较是有两部分组成的，称为左边和右边。
  * 左边和右边理论上都可以是任意的数据，比如是字段（属性，列），也可以是数值常量。
  * 这个结构中记录的仅仅支持字段和值。
+ * IN/NOT IN 子查询的左边是字段，右边是子查询；EXISTS/NOT EXISTS 只有子查询。
  */
 struct ConditionSqlNode
 {
@@ -124,6 +126,19 @@ struct ConditionSqlNode
                                  ///< 1时，操作符右边是属性名，0时，是属性值
   RelAttrSqlNode right_attr;     ///< right-hand side attribute if right_is_attr = TRUE 右边的属性
   Value          right_value;    ///< right-hand side value if right_is_attr = FALSE
+
+  std::shared_ptr<SelectSqlNode> sub_select;  ///< IN/EXISTS 的子查询
+};
+
+/**
+ * @brief 描述 LIMIT 子句
+ * @ingroup SQLParser
+ * @details 支持 LIMIT n、LIMIT n OFFSET m 和 LIMIT m, n 三种写法
+ */
+struct LimitSqlNode
+{
+  int limit  = -1;  ///< 最多返回多少行，-1 表示没有 LIMIT
+  int offset = 0;   ///< 跳过前面多少行
 };
 
 /**
@@ -143,6 +158,7 @@ struct SelectSqlNode
   std::vector<std::string>      relations;   ///< 查询的表
   std::vector<ConditionSqlNode> conditions;  ///< 查询条件，使用AND串联起来多个条件
   std::vector<OrderSqlNode>     orders;      ///< Order-requirements
+  LimitSqlNode                  limit;       ///< LIMIT 子句
 };
 
 /**
@@ -223,6 +239,7 @@ struct CreateTableSqlNode
 {
   std::string                  relation_name;  ///< Relation name
   std::vector<AttrInfoSqlNode> attr_infos;     ///< attributes
+  std::string                  storage_format; ///< 存放格式(row/varlen)，为空时使用定长格式
 };
 
 /**
@@ -246,6 +263,7 @@ struct CreateIndexSqlNode
   std::string              relation_name;    ///< Relation name
   std::vector<std::string> attribute_names;  ///< Attribute name, use vector in storage
   int                      is_unique;        ///< whether is unique index
+  std::string              index_type;       ///< 索引类型 btree/hash，为空时使用B+树
   // std::string attribute_name;  ///< Attribute name
 };
 
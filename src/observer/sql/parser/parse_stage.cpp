@@ -47,7 +47,15 @@ RC ParseStage::handle_request(SQLStageEvent *sql_event)
     LOG_WARN("got multi sql commands but only 1 will be handled");
   }
 
+  // 语句后面还有多余的内容时，语法分析先归约出了前面完整的语句，之后才报错，
+  // 错误节点排在语句节点的后面。这种情况也要按照语法错误处理，不能忽略多余的内容
   std::unique_ptr<ParsedSqlNode> sql_node = std::move(parsed_sql_result.sql_nodes().front());
+  for (std::unique_ptr<ParsedSqlNode> &node : parsed_sql_result.sql_nodes()) {
+    if (node != nullptr && node->flag == SCF_ERROR) {
+      sql_node = std::move(node);
+      break;
+    }
+  }
   if (sql_node->flag == SCF_ERROR) {
     // set error information to event
     rc = RC::SQL_SYNTAX;
@@ -55,5 +55,10 @@ RC ResolveStage::handle_request(SQLStageEvent *sql_event)
 
   sql_event->set_stmt(stmt);
 
+  // 自动提交模式下的只读语句使用只读快照事务，不需要分配事务号和写日志
+  if (stmt != nullptr && stmt->is_readonly() && !session_event->session()->is_trx_multi_operation_mode()) {
+    sql_result->set_readonly(true);
+  }
+
   return rc;
 }
@@ -237,6 +237,9 @@ bool Value::compare(const CompOp &comp_op, const Value &other) const
         cmp_result =
             common::compare_float((void *)&this->num_value_.float_value_, (void *)&other.num_value_.float_value_);
       } break;
+      case DATES: {
+        cmp_result = Date::compare_date(&this->num_value_.date_value_, &other.num_value_.date_value_);
+      } break;
       case CHARS: {
         if (comp_op == LIKE || comp_op == NOT_LIKE) {
           cmp_result = common::string_match(
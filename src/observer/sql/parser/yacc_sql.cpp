@@ -110,8 +110,42 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
   return expr;
 }
 
+/**
+ * @brief 生成子查询条件，会释放传入的参数
+ */
+ConditionSqlNode *create_subquery_condition(CompOp comp, RelAttrSqlNode *left_attr, ParsedSqlNode *sub_select)
+{
+  ConditionSqlNode *condition = new ConditionSqlNode;
+  condition->left_is_attr     = (left_attr != nullptr) ? 1 : 0;
+  condition->right_is_attr    = 0;
+  condition->comp             = comp;
+  condition->sub_select       = std::make_shared<SelectSqlNode>(std::move(sub_select->selection));
+  if (left_attr != nullptr) {
+    condition->left_attr = *left_attr;
+  }
+
+  delete left_attr;
+  delete sub_select;
+  return condition;
+}
 
-#line 115 "yacc_sql.cpp"
+/**
+ * @brief 生成 LIMIT 子句。行数是负数时返回空
+ */
+LimitSqlNode *create_limit(int limit, int offset)
+{
+  if (limit < 0 || offset < 0) {
+    return nullptr;
+  }
+
+  LimitSqlNode *limit_node = new LimitSqlNode;
+  limit_node->limit        = limit;
+  limit_node->offset       = offset;
+  return limit_node;
+}
+
+
+#line 149 "yacc_sql.cpp"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -198,69 +232,79 @@ enum yysymbol_kind_t
   YYSYMBOL_MAX = 56,                       /* MAX  */
   YYSYMBOL_NOT = 57,                       /* NOT  */
   YYSYMBOL_LK = 58,                        /* LK  */
-  YYSYMBOL_NUMBER = 59,                    /* NUMBER  */
-  YYSYMBOL_FLOAT = 60,                     /* FLOAT  */
-  YYSYMBOL_ID = 61,                        /* ID  */
-  YYSYMBOL_AGGRE_ATTR = 62,                /* AGGRE_ATTR  */
-  YYSYMBOL_SSS = 63,                       /* SSS  */
-  YYSYMBOL_64_ = 64,                       /* '+'  */
-  YYSYMBOL_65_ = 65,                       /* '-'  */
-  YYSYMBOL_66_ = 66,                       /* '*'  */
-  YYSYMBOL_67_ = 67,                       /* '/'  */
-  YYSYMBOL_UMINUS = 68,                    /* UMINUS  */
-  YYSYMBOL_YYACCEPT = 69,                  /* $accept  */
-  YYSYMBOL_commands = 70,                  /* commands  */
-  YYSYMBOL_command_wrapper = 71,           /* command_wrapper  */
-  YYSYMBOL_exit_stmt = 72,                 /* exit_stmt  */
-  YYSYMBOL_help_stmt = 73,                 /* help_stmt  */
-  YYSYMBOL_sync_stmt = 74,                 /* sync_stmt  */
-  YYSYMBOL_begin_stmt = 75,                /* begin_stmt  */
-  YYSYMBOL_commit_stmt = 76,               /* commit_stmt  */
-  YYSYMBOL_rollback_stmt = 77,             /* rollback_stmt  */
-  YYSYMBOL_drop_table_stmt = 78,           /* drop_table_stmt  */
-  YYSYMBOL_show_tables_stmt = 79,          /* show_tables_stmt  */
-  YYSYMBOL_desc_table_stmt = 80,           /* desc_table_stmt  */
-  YYSYMBOL_create_index_stmt = 81,         /* create_index_stmt  */
-  YYSYMBOL_opt_unique = 82,                /* opt_unique  */
-  YYSYMBOL_id_list = 83,                   /* id_list  */
-  YYSYMBOL_drop_index_stmt = 84,           /* drop_index_stmt  */
-  YYSYMBOL_create_table_stmt = 85,         /* create_table_stmt  */
-  YYSYMBOL_attr_def_list = 86,             /* attr_def_list  */
-  YYSYMBOL_attr_def = 87,                  /* attr_def  */
-  YYSYMBOL_number = 88,                    /* number  */
-  YYSYMBOL_type = 89,                      /* type  */
-  YYSYMBOL_analyze_stmt = 90,              /* analyze_stmt  */
-  YYSYMBOL_insert_stmt = 91,               /* insert_stmt  */
-  YYSYMBOL_value_list = 92,                /* value_list  */
-  YYSYMBOL_value = 93,                     /* value  */
-  YYSYMBOL_delete_stmt = 94,               /* delete_stmt  */
-  YYSYMBOL_update_stmt = 95,               /* update_stmt  */
-  YYSYMBOL_select_stmt = 96,               /* select_stmt  */
-  YYSYMBOL_selector = 97,                  /* selector  */
-  YYSYMBOL_rel_attr_aggre = 98,            /* rel_attr_aggre  */
-  YYSYMBOL_aggre_node = 99,                /* aggre_node  */
-  YYSYMBOL_rel_attr = 100,                 /* rel_attr  */
-  YYSYMBOL_attr_list = 101,                /* attr_list  */
-  YYSYMBOL_rel_list = 102,                 /* rel_list  */
-  YYSYMBOL_where = 103,                    /* where  */
-  YYSYMBOL_order_node = 104,               /* order_node  */
-  YYSYMBOL_order_list = 105,               /* order_list  */
-  YYSYMBOL_calc_stmt = 106,                /* calc_stmt  */
-  YYSYMBOL_expression_list = 107,          /* expression_list  */
-  YYSYMBOL_expression = 108,               /* expression  */
-  YYSYMBOL_condition_list = 109,           /* condition_list  */
-  YYSYMBOL_condition = 110,                /* condition  */
-  YYSYMBOL_comp_op = 111,                  /* comp_op  */
-  YYSYMBOL_aggre_type = 112,               /* aggre_type  */
-  YYSYMBOL_order_type = 113,               /* order_type  */
-  YYSYMBOL_load_data_stmt = 114,           /* load_data_stmt  */
-  YYSYMBOL_explain_stmt = 115,             /* explain_stmt  */
-  YYSYMBOL_set_variable_stmt = 116,        /* set_variable_stmt  */
-  YYSYMBOL_opt_semicolon = 117,            /* opt_semicolon  */
-  YYSYMBOL_aggre_attr_list = 118,          /* aggre_attr_list  */
-  YYSYMBOL_aggre_attr_name = 119,          /* aggre_attr_name  */
-  YYSYMBOL_rel_name = 120,                 /* rel_name  */
-  YYSYMBOL_attr_name = 121                 /* attr_name  */
+  YYSYMBOL_IN = 59,                        /* IN  */
+  YYSYMBOL_EXISTS = 60,                    /* EXISTS  */
+  YYSYMBOL_LIMIT = 61,                     /* LIMIT  */
+  YYSYMBOL_OFFSET = 62,                    /* OFFSET  */
+  YYSYMBOL_USING = 63,                     /* USING  */
+  YYSYMBOL_STORAGE = 64,                   /* STORAGE  */
+  YYSYMBOL_FORMAT = 65,                    /* FORMAT  */
+  YYSYMBOL_NUMBER = 66,                    /* NUMBER  */
+  YYSYMBOL_FLOAT = 67,                     /* FLOAT  */
+  YYSYMBOL_ID = 68,                        /* ID  */
+  YYSYMBOL_AGGRE_ATTR = 69,                /* AGGRE_ATTR  */
+  YYSYMBOL_SSS = 70,                       /* SSS  */
+  YYSYMBOL_71_ = 71,                       /* '+'  */
+  YYSYMBOL_72_ = 72,                       /* '-'  */
+  YYSYMBOL_73_ = 73,                       /* '*'  */
+  YYSYMBOL_74_ = 74,                       /* '/'  */
+  YYSYMBOL_UMINUS = 75,                    /* UMINUS  */
+  YYSYMBOL_YYACCEPT = 76,                  /* $accept  */
+  YYSYMBOL_commands = 77,                  /* commands  */
+  YYSYMBOL_command_wrapper = 78,           /* command_wrapper  */
+  YYSYMBOL_exit_stmt = 79,                 /* exit_stmt  */
+  YYSYMBOL_help_stmt = 80,                 /* help_stmt  */
+  YYSYMBOL_sync_stmt = 81,                 /* sync_stmt  */
+  YYSYMBOL_begin_stmt = 82,                /* begin_stmt  */
+  YYSYMBOL_commit_stmt = 83,               /* commit_stmt  */
+  YYSYMBOL_rollback_stmt = 84,             /* rollback_stmt  */
+  YYSYMBOL_drop_table_stmt = 85,           /* drop_table_stmt  */
+  YYSYMBOL_show_tables_stmt = 86,          /* show_tables_stmt  */
+  YYSYMBOL_desc_table_stmt = 87,           /* desc_table_stmt  */
+  YYSYMBOL_create_index_stmt = 88,         /* create_index_stmt  */
+  YYSYMBOL_index_type = 89,                /* index_type  */
+  YYSYMBOL_opt_unique = 90,                /* opt_unique  */
+  YYSYMBOL_id_list = 91,                   /* id_list  */
+  YYSYMBOL_drop_index_stmt = 92,           /* drop_index_stmt  */
+  YYSYMBOL_create_table_stmt = 93,         /* create_table_stmt  */
+  YYSYMBOL_storage_format = 94,            /* storage_format  */
+  YYSYMBOL_attr_def_list = 95,             /* attr_def_list  */
+  YYSYMBOL_attr_def = 96,                  /* attr_def  */
+  YYSYMBOL_number = 97,                    /* number  */
+  YYSYMBOL_type = 98,                      /* type  */
+  YYSYMBOL_analyze_stmt = 99,              /* analyze_stmt  */
+  YYSYMBOL_insert_stmt = 100,              /* insert_stmt  */
+  YYSYMBOL_value_list = 101,               /* value_list  */
+  YYSYMBOL_value = 102,                    /* value  */
+  YYSYMBOL_delete_stmt = 103,              /* delete_stmt  */
+  YYSYMBOL_update_stmt = 104,              /* update_stmt  */
+  YYSYMBOL_select_stmt = 105,              /* select_stmt  */
+  YYSYMBOL_selector = 106,                 /* selector  */
+  YYSYMBOL_rel_attr_aggre = 107,           /* rel_attr_aggre  */
+  YYSYMBOL_aggre_node = 108,               /* aggre_node  */
+  YYSYMBOL_rel_attr = 109,                 /* rel_attr  */
+  YYSYMBOL_attr_list = 110,                /* attr_list  */
+  YYSYMBOL_rel_list = 111,                 /* rel_list  */
+  YYSYMBOL_where = 112,                    /* where  */
+  YYSYMBOL_order_node = 113,               /* order_node  */
+  YYSYMBOL_order_list = 114,               /* order_list  */
+  YYSYMBOL_limit = 115,                    /* limit  */
+  YYSYMBOL_calc_stmt = 116,                /* calc_stmt  */
+  YYSYMBOL_expression_list = 117,          /* expression_list  */
+  YYSYMBOL_expression = 118,               /* expression  */
+  YYSYMBOL_condition_list = 119,           /* condition_list  */
+  YYSYMBOL_condition = 120,                /* condition  */
+  YYSYMBOL_comp_op = 121,                  /* comp_op  */
+  YYSYMBOL_aggre_type = 122,               /* aggre_type  */
+  YYSYMBOL_order_type = 123,               /* order_type  */
+  YYSYMBOL_load_data_stmt = 124,           /* load_data_stmt  */
+  YYSYMBOL_explain_stmt = 125,             /* explain_stmt  */
+  YYSYMBOL_set_variable_stmt = 126,        /* set_variable_stmt  */
+  YYSYMBOL_opt_semicolon = 127,            /* opt_semicolon  */
+  YYSYMBOL_aggre_attr_list = 128,          /* aggre_attr_list  */
+  YYSYMBOL_aggre_attr_name = 129,          /* aggre_attr_name  */
+  YYSYMBOL_rel_name = 130,                 /* rel_name  */
+  YYSYMBOL_attr_name = 131                 /* attr_name  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
@@ -591,19 +635,19 @@ union yyalloc
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  79
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   186
+#define YYLAST   230
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  69
+#define YYNTOKENS  76
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  53
+#define YYNNTS  56
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  125
+#define YYNRULES  136
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  211
+#define YYNSTATES  243
 
 /* YYMAXUTOK -- Last valid token kind.  */
-#define YYMAXUTOK   319
+#define YYMAXUTOK   326
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
@@ -621,7 +665,7 @@ static const yytype_int8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,    66,    64,     2,    65,     2,    67,     2,     2,
+       2,     2,    73,    71,     2,    72,     2,    74,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -648,26 +692,28 @@ static const yytype_int8 yytranslate[] =
       25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
       35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
       45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
-      55,    56,    57,    58,    59,    60,    61,    62,    63,    68
+      55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
+      65,    66,    67,    68,    69,    70,    75
 };
 
 #if YYDEBUG
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   209,   209,   217,   218,   219,   220,   221,   222,   223,
-     224,   225,   226,   227,   228,   229,   230,   231,   232,   233,
-     234,   235,   236,   237,   241,   247,   252,   258,   264,   270,
-     276,   283,   289,   297,   313,   316,   323,   329,   338,   348,
-     368,   371,   384,   392,   402,   405,   406,   407,   408,   412,
-     419,   428,   445,   448,   459,   463,   467,   476,   488,   503,
-     526,   531,   542,   546,   559,   571,   576,   585,   590,   599,
-     602,   607,   615,   618,   624,   637,   640,   645,   650,   658,
-     668,   673,   684,   687,   690,   693,   696,   700,   703,   712,
-     715,   720,   727,   739,   751,   763,   778,   779,   780,   781,
-     782,   783,   784,   785,   789,   790,   791,   792,   793,   798,
-     799,   800,   804,   817,   825,   835,   836,   841,   844,   849,
-     857,   861,   868,   874,   881,   885
+       0,   254,   254,   262,   263,   264,   265,   266,   267,   268,
+     269,   270,   271,   272,   273,   274,   275,   276,   277,   278,
+     279,   280,   281,   282,   286,   292,   297,   303,   309,   315,
+     321,   328,   334,   342,   362,   365,   373,   376,   383,   389,
+     398,   408,   433,   436,   443,   446,   459,   467,   477,   480,
+     481,   482,   483,   487,   494,   503,   520,   523,   534,   538,
+     542,   551,   563,   578,   605,   610,   621,   625,   638,   650,
+     655,   664,   669,   678,   681,   686,   694,   697,   703,   716,
+     719,   724,   737,   740,   748,   756,   767,   777,   782,   793,
+     796,   799,   802,   805,   809,   812,   821,   824,   829,   836,
+     848,   860,   872,   884,   888,   892,   896,   903,   904,   905,
+     906,   907,   908,   909,   910,   914,   915,   916,   917,   918,
+     923,   924,   925,   929,   942,   950,   960,   961,   966,   969,
+     974,   982,   986,   993,   999,  1006,  1010
 };
 #endif
 
@@ -690,17 +736,18 @@ static const char *const yytname[] =
   "TRX_COMMIT", "TRX_ROLLBACK", "INT_T", "DATE_T", "STRING_T", "FLOAT_T",
   "HELP", "EXIT", "DOT", "INTO", "VALUES", "FROM", "WHERE", "AND", "SET",
   "ON", "LOAD", "DATA", "INFILE", "EXPLAIN", "EQ", "LT", "GT", "LE", "GE",
-  "NE", "SUM", "COUNT", "AVG", "MIN", "MAX", "NOT", "LK", "NUMBER",
-  "FLOAT", "ID", "AGGRE_ATTR", "SSS", "'+'", "'-'", "'*'", "'/'", "UMINUS",
-  "$accept", "commands", "command_wrapper", "exit_stmt", "help_stmt",
-  "sync_stmt", "begin_stmt", "commit_stmt", "rollback_stmt",
-  "drop_table_stmt", "show_tables_stmt", "desc_table_stmt",
-  "create_index_stmt", "opt_unique", "id_list", "drop_index_stmt",
-  "create_table_stmt", "attr_def_list", "attr_def", "number", "type",
+  "NE", "SUM", "COUNT", "AVG", "MIN", "MAX", "NOT", "LK", "IN", "EXISTS",
+  "LIMIT", "OFFSET", "USING", "STORAGE", "FORMAT", "NUMBER", "FLOAT", "ID",
+  "AGGRE_ATTR", "SSS", "'+'", "'-'", "'*'", "'/'", "UMINUS", "$accept",
+  "commands", "command_wrapper", "exit_stmt", "help_stmt", "sync_stmt",
+  "begin_stmt", "commit_stmt", "rollback_stmt", "drop_table_stmt",
+  "show_tables_stmt", "desc_table_stmt", "create_index_stmt", "index_type",
+  "opt_unique", "id_list", "drop_index_stmt", "create_table_stmt",
+  "storage_format", "attr_def_list", "attr_def", "number", "type",
   "analyze_stmt", "insert_stmt", "value_list", "value", "delete_stmt",
   "update_stmt", "select_stmt", "selector", "rel_attr_aggre", "aggre_node",
   "rel_attr", "attr_list", "rel_list", "where", "order_node", "order_list",
-  "calc_stmt", "expression_list", "expression", "condition_list",
+  "limit", "calc_stmt", "expression_list", "expression", "condition_list",
   "condition", "comp_op", "aggre_type", "order_type", "load_data_stmt",
   "explain_stmt", "set_variable_stmt", "opt_semicolon", "aggre_attr_list",
   "aggre_attr_name", "rel_name", "attr_name", YY_NULLPTR
@@ -713,12 +760,12 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 }
 #endif
 
-#define YYPACT_NINF (-162)
+#define YYPACT_NINF (-164)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF (-124)
+#define YYTABLE_NINF (-135)
 
 #define yytable_value_is_error(Yyn) \
   0
@@ -727,79 +774,85 @@ yysymbol_name (yysymbol_kind_t yysymbol)
    STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-      75,    23,     6,    54,     3,   -35,   -11,    70,  -162,    32,
-      62,    43,  -162,  -162,  -162,  -162,  -162,    48,    76,    75,
-     121,   120,  -162,  -162,  -162,  -162,  -162,  -162,  -162,  -162,
-    -162,  -162,  -162,  -162,  -162,  -162,  -162,  -162,  -162,  -162,
-    -162,  -162,  -162,    63,  -162,   115,    65,    66,    67,     3,
-    -162,  -162,  -162,     3,  -162,  -162,     5,  -162,  -162,  -162,
-    -162,  -162,    95,  -162,   -14,  -162,  -162,  -162,   108,    97,
-    -162,  -162,  -162,    71,    72,    94,    89,    92,  -162,  -162,
-    -162,  -162,   116,    78,   118,  -162,    96,    -7,  -162,     3,
-       3,     3,     3,     3,   -35,    80,    44,   -54,   106,   105,
-      84,    25,    81,    85,   107,    86,    88,  -162,  -162,     7,
-       7,  -162,  -162,  -162,  -162,   -16,  -162,  -162,  -162,  -162,
-    -162,   126,   128,  -162,   129,  -162,   131,   -20,  -162,   109,
-    -162,   119,    83,   132,    98,  -162,    59,  -162,    80,   -10,
-      44,  -162,    25,   -13,   -13,  -162,   122,    25,   150,  -162,
-    -162,  -162,  -162,   136,    85,   137,   140,  -162,   103,  -162,
-     148,   102,  -162,   141,  -162,   129,   142,  -162,  -162,  -162,
-    -162,  -162,  -162,   110,  -162,   -20,   -20,   -20,   105,   112,
-     117,   132,  -162,    86,  -162,   -52,  -162,  -162,  -162,   -52,
-      25,   144,  -162,  -162,  -162,  -162,  -162,  -162,  -162,  -162,
-     146,  -162,    74,  -162,  -162,   142,  -162,  -162,   171,  -162,
-    -162
+      82,    28,    13,    44,     0,    64,   -15,    65,  -164,    50,
+      26,    23,  -164,  -164,  -164,  -164,  -164,    29,    61,    82,
+     105,   103,  -164,  -164,  -164,  -164,  -164,  -164,  -164,  -164,
+    -164,  -164,  -164,  -164,  -164,  -164,  -164,  -164,  -164,  -164,
+    -164,  -164,  -164,    42,  -164,   101,    45,    53,    57,     0,
+    -164,  -164,  -164,     0,  -164,  -164,    10,  -164,  -164,  -164,
+    -164,  -164,    78,  -164,   -16,  -164,  -164,  -164,   104,    89,
+    -164,  -164,  -164,    60,    66,    95,   102,   114,  -164,  -164,
+    -164,  -164,   137,    93,   138,  -164,   121,   -13,  -164,     0,
+       0,     0,     0,     0,    64,    97,   -57,   -40,   130,   129,
+     100,   -27,    99,   107,   131,   108,   109,  -164,  -164,     1,
+       1,  -164,  -164,  -164,  -164,    -9,  -164,  -164,  -164,  -164,
+    -164,   146,   148,  -164,   150,  -164,   152,   -43,  -164,   132,
+    -164,   144,   116,   156,   113,  -164,    54,  -164,    97,   169,
+     -57,  -164,   -27,   123,   162,   106,    92,  -164,   147,   -27,
+     178,  -164,  -164,  -164,  -164,   165,   107,   166,   168,  -164,
+     120,  -164,   176,   -11,  -164,   150,   170,   171,   180,  -164,
+    -164,  -164,  -164,  -164,  -164,   139,  -164,    63,    31,   173,
+      63,   -43,   129,   128,   133,   156,   134,   108,  -164,   -37,
+     -37,   135,  -164,   -27,   177,   180,   179,  -164,  -164,  -164,
+     181,   180,  -164,  -164,  -164,  -164,  -164,   182,  -164,   141,
+    -164,    72,    55,  -164,  -164,   -20,   170,  -164,   184,  -164,
+     180,   185,  -164,   158,   149,  -164,  -164,  -164,   143,   145,
+    -164,  -164,   187,  -164,   151,   153,   210,  -164,  -164,  -164,
+    -164,  -164,  -164
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
    Performed when YYTABLE does not specify something else to do.  Zero
    means the default is an error.  */
-static const yytype_int8 yydefact[] =
+static const yytype_uint8 yydefact[] =
 {
-       0,    34,     0,     0,     0,     0,     0,     0,    26,     0,
+       0,    36,     0,     0,     0,     0,     0,     0,    26,     0,
        0,     0,    27,    28,    29,    25,    24,     0,     0,     0,
-       0,   115,    23,    22,    15,    16,    17,    18,    10,    11,
+       0,   126,    23,    22,    15,    16,    17,    18,    10,    11,
       12,    13,    14,     9,     5,     6,     8,     7,     4,     3,
-      19,    20,    21,     0,    35,     0,     0,     0,     0,     0,
-      54,    55,    56,     0,    88,    79,    80,   104,   106,   105,
-     108,   107,   124,   125,     0,    60,    63,    62,     0,     0,
-      65,    32,    31,     0,     0,     0,     0,     0,   113,     1,
-     116,     2,     0,     0,    50,    30,     0,     0,    87,     0,
-       0,     0,     0,     0,     0,    69,   117,     0,     0,    72,
-       0,     0,     0,     0,     0,     0,     0,    86,    81,    82,
-      83,    84,    85,    61,   123,    72,    70,    44,   124,   122,
-     121,     0,     0,   118,    67,    66,     0,    89,    57,     0,
-     114,     0,     0,    40,     0,    36,     0,    38,     0,    75,
-       0,    64,     0,     0,     0,    73,    90,     0,     0,    45,
-      48,    46,    47,    43,     0,     0,     0,    49,     0,    71,
-       0,   109,    76,    59,   119,    68,    52,    96,    97,    98,
-      99,   100,   101,     0,   102,     0,     0,    89,    72,     0,
-       0,    40,    39,     0,    37,     0,   110,   111,    74,     0,
-       0,     0,   103,    93,    95,    92,    94,    91,    58,   112,
-       0,    41,     0,    77,    78,    52,    51,    42,     0,    53,
-      33
+      19,    20,    21,     0,    37,     0,     0,     0,     0,     0,
+      58,    59,    60,     0,    95,    86,    87,   115,   117,   116,
+     119,   118,   135,   136,     0,    64,    67,    66,     0,     0,
+      69,    32,    31,     0,     0,     0,     0,     0,   124,     1,
+     127,     2,     0,     0,    54,    30,     0,     0,    94,     0,
+       0,     0,     0,     0,     0,    73,   128,     0,     0,    76,
+       0,     0,     0,     0,     0,     0,     0,    93,    88,    89,
+      90,    91,    92,    65,   134,    76,    74,    48,   135,   133,
+     132,     0,     0,   129,    71,    70,     0,    96,    61,     0,
+     125,     0,     0,    44,     0,    38,     0,    40,     0,    79,
+       0,    68,     0,     0,     0,     0,     0,    77,    97,     0,
+       0,    49,    52,    50,    51,    47,     0,     0,     0,    53,
+       0,    75,     0,    82,   130,    72,    56,     0,     0,   107,
+     108,   109,   110,   111,   112,     0,   113,     0,     0,     0,
+       0,    96,    76,     0,     0,    44,    42,     0,    39,     0,
+       0,     0,    63,     0,     0,     0,     0,   114,   100,   102,
+       0,     0,    99,   101,    98,    62,   123,     0,    45,     0,
+      41,     0,   120,    80,    81,    83,    56,    55,     0,   105,
+       0,     0,    46,     0,    34,   121,   122,    78,     0,     0,
+      57,   106,     0,   103,     0,     0,     0,    85,    84,   104,
+      43,    35,    33
 };
 
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -162,  -162,   156,  -162,  -162,  -162,  -162,  -162,  -162,  -162,
-    -162,  -162,  -162,  -162,    -6,  -162,  -162,    -3,    26,    -1,
-    -162,  -162,  -162,   -24,  -100,  -162,  -162,  -162,  -162,    90,
-    -162,    -5,  -162,  -162,  -113,  -161,  -162,  -162,    93,   -38,
-       8,  -162,    39,  -162,  -162,  -162,  -162,  -162,  -162,  -162,
-      46,   -89,   -92
+    -164,  -164,   195,  -164,  -164,  -164,  -164,  -164,  -164,  -164,
+    -164,  -164,  -164,  -164,  -164,    30,  -164,  -164,  -164,    33,
+      59,    32,  -164,  -164,  -164,     4,  -101,  -164,  -164,  -163,
+    -164,   136,  -164,  -125,  -164,  -164,  -114,    34,  -164,  -164,
+    -164,   140,   -46,    41,  -164,    77,  -164,  -164,  -164,  -164,
+    -164,  -164,  -164,    85,   -89,   -78
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_uint8 yydefgoto[] =
 {
        0,    20,    21,    22,    23,    24,    25,    26,    27,    28,
-      29,    30,    31,    45,   136,    32,    33,   155,   133,   120,
-     153,    34,    35,   191,    54,    36,    37,    38,    64,    65,
-      66,   161,   121,   115,   128,   162,   163,    39,    55,    56,
-     145,   146,   175,    68,   188,    40,    41,    42,    81,   122,
-     123,    69,    70
+      29,    30,    31,   236,    45,   136,    32,    33,   210,   157,
+     133,   120,   155,    34,    35,   194,    54,    36,    37,    38,
+      64,    65,    66,    67,   121,   115,   128,   213,   163,   192,
+      39,    55,    56,   147,   148,   177,    68,   227,    40,    41,
+      42,    81,   122,   123,    69,    70
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
@@ -807,94 +860,108 @@ static const yytype_uint8 yydefgoto[] =
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int16 yytable[] =
 {
-      67,   130,   139,   160,   124,   125,   116,   118,   138,    62,
-      94,    87,    63,    46,    63,    88,   107,    57,    58,    59,
-      60,    61,   127,    95,   203,    49,    62,   143,   204,    89,
-      43,    63,    44,   167,   168,   169,   170,   171,   172,    50,
-      51,    62,   166,    52,   173,   174,    63,   178,   165,   159,
-      71,    62,   109,   110,   111,   112,    63,    90,    91,    92,
-      93,    47,    50,    51,    48,   198,    52,    73,    53,    90,
-      91,    92,    93,    92,    93,   193,   195,   143,    72,     1,
-       2,     3,   157,   158,    50,    51,     4,     5,    52,    67,
-     205,     6,     7,     8,     9,    10,    11,   208,   158,    74,
-      12,    13,    14,   117,    75,   118,   119,    15,    16,    76,
-      63,   149,   150,   151,   152,    17,   186,    18,   187,    77,
-      19,    79,   144,    80,    82,    83,    84,    85,    86,  -123,
-      96,    97,    98,    99,   100,   101,   102,   106,   103,   104,
-     105,   114,   126,   127,   131,   129,   132,   135,   134,   137,
-     140,   141,  -120,   142,   148,   147,   154,   179,   180,   156,
-     182,   177,   183,   185,   184,   189,   190,   206,   192,   207,
-     194,   196,   144,   199,   210,    78,   117,   202,   201,   200,
-     181,   209,   108,   176,   113,   197,   164
+     130,   139,   146,    87,   228,   196,   116,    88,    94,   117,
+     107,   118,   119,   190,   143,   138,    63,   144,   124,   125,
+      46,    95,    49,    50,    51,    62,   145,    52,   118,   127,
+      63,    62,   218,    63,    89,    43,    63,    44,   221,    50,
+      51,   166,   229,    52,   109,   110,   111,   112,   182,   161,
+     191,    47,   199,    71,    48,   203,   146,   232,    90,    91,
+      92,    93,   165,    74,   212,   212,    50,    51,   205,   225,
+      52,   226,    53,    72,    92,    93,   198,   159,   160,   202,
+     145,    90,    91,    92,    93,    73,     1,     2,     3,   197,
+     200,    75,   216,     4,     5,   224,   160,    76,     6,     7,
+       8,     9,    10,    11,    77,    79,    80,    12,    13,    14,
+      82,    83,  -134,    84,    15,    16,    57,    58,    59,    60,
+      61,    85,    17,    97,    18,    86,    96,    19,    98,    50,
+      51,    62,    62,    52,    99,   100,    63,    63,   169,   170,
+     171,   172,   173,   174,   151,   152,   153,   154,   101,   178,
+     176,   179,   169,   170,   171,   172,   173,   174,   102,   103,
+     105,   104,   106,   175,   176,   114,   126,   127,   129,   131,
+     140,   141,   134,  -131,   142,   132,   135,   137,   149,   150,
+     156,   158,   162,   167,   168,   183,   181,   184,   188,   186,
+     187,   189,     5,   195,   193,   201,   206,   197,   209,   117,
+     217,   215,   219,   220,   234,   222,   223,   231,   233,   237,
+     239,   238,   235,   242,    78,   185,   207,   211,   208,   240,
+     230,   241,   204,   180,   214,   164,     0,     0,     0,   108,
+     113
 };
 
-static const yytype_uint8 yycheck[] =
+static const yytype_int16 yycheck[] =
 {
-       5,   101,   115,    13,    96,    97,    95,    61,    24,    61,
-      24,    49,    66,     7,    66,    53,    23,    52,    53,    54,
-      55,    56,    38,    37,   185,    22,    61,   127,   189,    24,
-       7,    66,     9,    46,    47,    48,    49,    50,    51,    59,
-      60,    61,   142,    63,    57,    58,    66,   147,   140,   138,
-      61,    61,    90,    91,    92,    93,    66,    64,    65,    66,
-      67,     7,    59,    60,    10,   178,    63,    35,    65,    64,
-      65,    66,    67,    66,    67,   175,   176,   177,     8,     4,
-       5,     6,    23,    24,    59,    60,    11,    12,    63,    94,
-     190,    16,    17,    18,    19,    20,    21,    23,    24,    37,
-      25,    26,    27,    59,    61,    61,    62,    32,    33,    61,
-      66,    28,    29,    30,    31,    40,    14,    42,    16,    43,
-      45,     0,   127,     3,    61,    10,    61,    61,    61,    34,
-      22,    34,    61,    61,    40,    46,    44,    41,    22,    61,
-      22,    61,    36,    38,    63,    61,    61,    61,    41,    61,
-      24,    23,    23,    22,    35,    46,    24,     7,    22,    61,
-      23,    39,    22,    15,    61,    24,    24,    23,    58,    23,
-     175,   176,   177,    61,     3,    19,    59,   183,   181,   180,
-     154,   205,    89,   144,    94,   177,   140
+     101,   115,   127,    49,    24,   168,    95,    53,    24,    66,
+      23,    68,    69,    24,    57,    24,    73,    60,    96,    97,
+       7,    37,    22,    66,    67,    68,   127,    70,    68,    38,
+      73,    68,   195,    73,    24,     7,    73,     9,   201,    66,
+      67,   142,    62,    70,    90,    91,    92,    93,   149,   138,
+      61,     7,   177,    68,    10,   180,   181,   220,    71,    72,
+      73,    74,   140,    37,   189,   190,    66,    67,   182,    14,
+      70,    16,    72,     8,    73,    74,   177,    23,    24,   180,
+     181,    71,    72,    73,    74,    35,     4,     5,     6,    58,
+      59,    68,   193,    11,    12,    23,    24,    68,    16,    17,
+      18,    19,    20,    21,    43,     0,     3,    25,    26,    27,
+      68,    10,    34,    68,    32,    33,    52,    53,    54,    55,
+      56,    68,    40,    34,    42,    68,    22,    45,    68,    66,
+      67,    68,    68,    70,    68,    40,    73,    73,    46,    47,
+      48,    49,    50,    51,    28,    29,    30,    31,    46,    57,
+      58,    59,    46,    47,    48,    49,    50,    51,    44,    22,
+      22,    68,    41,    57,    58,    68,    36,    38,    68,    70,
+      24,    23,    41,    23,    22,    68,    68,    68,    46,    35,
+      24,    68,    13,    60,    22,     7,    39,    22,    68,    23,
+      22,    15,    12,    22,    24,    22,    68,    58,    64,    66,
+      23,    66,    23,    22,    46,    23,    65,    23,    23,    66,
+      23,    66,    63,     3,    19,   156,   184,   187,   185,    68,
+     216,    68,   181,   146,   190,   140,    -1,    -1,    -1,    89,
+      94
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
    state STATE-NUM.  */
-static const yytype_int8 yystos[] =
+static const yytype_uint8 yystos[] =
 {
        0,     4,     5,     6,    11,    12,    16,    17,    18,    19,
       20,    21,    25,    26,    27,    32,    33,    40,    42,    45,
-      70,    71,    72,    73,    74,    75,    76,    77,    78,    79,
-      80,    81,    84,    85,    90,    91,    94,    95,    96,   106,
-     114,   115,   116,     7,     9,    82,     7,     7,    10,    22,
-      59,    60,    63,    65,    93,   107,   108,    52,    53,    54,
-      55,    56,    61,    66,    97,    98,    99,   100,   112,   120,
-     121,    61,     8,    35,    37,    61,    61,    43,    71,     0,
-       3,   117,    61,    10,    61,    61,    61,   108,   108,    24,
-      64,    65,    66,    67,    24,    37,    22,    34,    61,    61,
-      40,    46,    44,    22,    61,    22,    41,    23,   107,   108,
-     108,   108,   108,    98,    61,   102,   120,    59,    61,    62,
-      88,   101,   118,   119,   121,   121,    36,    38,   103,    61,
-      93,    63,    61,    87,    41,    61,    83,    61,    24,   103,
-      24,    23,    22,    93,   100,   109,   110,    46,    35,    28,
-      29,    30,    31,    89,    24,    86,    61,    23,    24,   120,
-      13,   100,   104,   105,   119,   121,    93,    46,    47,    48,
-      49,    50,    51,    57,    58,   111,   111,    39,    93,     7,
-      22,    87,    23,    22,    61,    15,    14,    16,   113,    24,
-      24,    92,    58,    93,   100,    93,   100,   109,   103,    61,
-      88,    86,    83,   104,   104,    93,    23,    23,    23,    92,
-       3
+      77,    78,    79,    80,    81,    82,    83,    84,    85,    86,
+      87,    88,    92,    93,    99,   100,   103,   104,   105,   116,
+     124,   125,   126,     7,     9,    90,     7,     7,    10,    22,
+      66,    67,    70,    72,   102,   117,   118,    52,    53,    54,
+      55,    56,    68,    73,   106,   107,   108,   109,   122,   130,
+     131,    68,     8,    35,    37,    68,    68,    43,    78,     0,
+       3,   127,    68,    10,    68,    68,    68,   118,   118,    24,
+      71,    72,    73,    74,    24,    37,    22,    34,    68,    68,
+      40,    46,    44,    22,    68,    22,    41,    23,   117,   118,
+     118,   118,   118,   107,    68,   111,   130,    66,    68,    69,
+      97,   110,   128,   129,   131,   131,    36,    38,   112,    68,
+     102,    70,    68,    96,    41,    68,    91,    68,    24,   112,
+      24,    23,    22,    57,    60,   102,   109,   119,   120,    46,
+      35,    28,    29,    30,    31,    98,    24,    95,    68,    23,
+      24,   130,    13,   114,   129,   131,   102,    60,    22,    46,
+      47,    48,    49,    50,    51,    57,    58,   121,    57,    59,
+     121,    39,   102,     7,    22,    96,    23,    22,    68,    15,
+      24,    61,   115,    24,   101,    22,   105,    58,   102,   109,
+      59,    22,   102,   109,   119,   112,    68,    97,    95,    64,
+      94,    91,   109,   113,   113,    66,   102,    23,   105,    23,
+      22,   105,    23,    65,    23,    14,    16,   123,    24,    62,
+     101,    23,   105,    23,    46,    63,    89,    66,    66,    23,
+      68,    68,     3
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
-static const yytype_int8 yyr1[] =
+static const yytype_uint8 yyr1[] =
 {
-       0,    69,    70,    71,    71,    71,    71,    71,    71,    71,
-      71,    71,    71,    71,    71,    71,    71,    71,    71,    71,
-      71,    71,    71,    71,    72,    73,    74,    75,    76,    77,
-      78,    79,    80,    81,    82,    82,    83,    83,    84,    85,
-      86,    86,    87,    87,    88,    89,    89,    89,    89,    90,
-      90,    91,    92,    92,    93,    93,    93,    94,    95,    96,
-      97,    97,    98,    98,    99,   100,   100,   101,   101,   102,
-     102,   102,   103,   103,   104,   105,   105,   105,   105,   106,
-     107,   107,   108,   108,   108,   108,   108,   108,   108,   109,
-     109,   109,   110,   110,   110,   110,   111,   111,   111,   111,
-     111,   111,   111,   111,   112,   112,   112,   112,   112,   113,
-     113,   113,   114,   115,   116,   117,   117,   118,   118,   118,
-     119,   119,   119,   120,   121,   121
+       0,    76,    77,    78,    78,    78,    78,    78,    78,    78,
+      78,    78,    78,    78,    78,    78,    78,    78,    78,    78,
+      78,    78,    78,    78,    79,    80,    81,    82,    83,    84,
+      85,    86,    87,    88,    89,    89,    90,    90,    91,    91,
+      92,    93,    94,    94,    95,    95,    96,    96,    97,    98,
+      98,    98,    98,    99,    99,   100,   101,   101,   102,   102,
+     102,   103,   104,   105,   106,   106,   107,   107,   108,   109,
+     109,   110,   110,   111,   111,   111,   112,   112,   113,   114,
+     114,   114,   115,   115,   115,   115,   116,   117,   117,   118,
+     118,   118,   118,   118,   118,   118,   119,   119,   119,   120,
+     120,   120,   120,   120,   120,   120,   120,   121,   121,   121,
+     121,   121,   121,   121,   121,   122,   122,   122,   122,   122,
+     123,   123,   123,   124,   125,   126,   127,   127,   128,   128,
+     128,   129,   129,   129,   130,   131,   131
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
@@ -903,16 +970,17 @@ static const yytype_int8 yyr2[] =
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       3,     2,     2,    10,     0,     1,     1,     3,     5,     7,
-       0,     3,     5,     2,     1,     1,     1,     1,     1,     6,
-       3,     8,     0,     3,     1,     1,     1,     4,     7,     6,
-       1,     3,     1,     1,     4,     1,     3,     1,     3,     0,
-       1,     3,     0,     2,     2,     0,     1,     3,     3,     2,
-       1,     3,     3,     3,     3,     3,     3,     2,     1,     0,
-       1,     3,     3,     3,     3,     3,     1,     1,     1,     1,
-       1,     1,     1,     2,     1,     1,     1,     1,     1,     0,
-       1,     1,     7,     2,     4,     0,     1,     0,     1,     3,
-       1,     1,     1,     1,     1,     1
+       3,     2,     2,    11,     0,     2,     0,     1,     1,     3,
+       5,     8,     0,     4,     0,     3,     5,     2,     1,     1,
+       1,     1,     1,     6,     3,     8,     0,     3,     1,     1,
+       1,     4,     7,     7,     1,     3,     1,     1,     4,     1,
+       3,     1,     3,     0,     1,     3,     0,     2,     2,     0,
+       3,     3,     0,     2,     4,     4,     2,     1,     3,     3,
+       3,     3,     3,     3,     2,     1,     0,     1,     3,     3,
+       3,     3,     3,     5,     6,     4,     5,     1,     1,     1,
+       1,     1,     1,     1,     2,     1,     1,     1,     1,     1,
+       0,     1,     1,     7,     2,     4,     0,     1,     0,     1,
+       3,     1,     1,     1,     1,     1,     1
 };
 
 
@@ -1774,145 +1842,165 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* commands: command_wrapper opt_semicolon  */
-#line 210 "yacc_sql.y"
+#line 255 "yacc_sql.y"
   {
     std::unique_ptr<ParsedSqlNode> sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[-1].sql_node));
     sql_result->add_sql_node(std::move(sql_node));
   }
-#line 1783 "yacc_sql.cpp"
+#line 1851 "yacc_sql.cpp"
     break;
 
   case 24: /* exit_stmt: EXIT  */
-#line 241 "yacc_sql.y"
+#line 286 "yacc_sql.y"
          {
       (void)yynerrs;  // 这么写为了消除yynerrs未使用的告警。如果你有更好的方法欢迎提PR
       (yyval.sql_node) = new ParsedSqlNode(SCF_EXIT);
     }
-#line 1792 "yacc_sql.cpp"
+#line 1860 "yacc_sql.cpp"
     break;
 
   case 25: /* help_stmt: HELP  */
-#line 247 "yacc_sql.y"
+#line 292 "yacc_sql.y"
          {
       (yyval.sql_node) = new ParsedSqlNode(SCF_HELP);
     }
-#line 1800 "yacc_sql.cpp"
+#line 1868 "yacc_sql.cpp"
     break;
 
   case 26: /* sync_stmt: SYNC  */
-#line 252 "yacc_sql.y"
+#line 297 "yacc_sql.y"
          {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SYNC);
     }
-#line 1808 "yacc_sql.cpp"
+#line 1876 "yacc_sql.cpp"
     break;
 
   case 27: /* begin_stmt: TRX_BEGIN  */
-#line 258 "yacc_sql.y"
+#line 303 "yacc_sql.y"
                {
       (yyval.sql_node) = new ParsedSqlNode(SCF_BEGIN);
     }
-#line 1816 "yacc_sql.cpp"
+#line 1884 "yacc_sql.cpp"
     break;
 
   case 28: /* commit_stmt: TRX_COMMIT  */
-#line 264 "yacc_sql.y"
+#line 309 "yacc_sql.y"
                {
       (yyval.sql_node) = new ParsedSqlNode(SCF_COMMIT);
     }
-#line 1824 "yacc_sql.cpp"
+#line 1892 "yacc_sql.cpp"
     break;
 
   case 29: /* rollback_stmt: TRX_ROLLBACK  */
-#line 270 "yacc_sql.y"
+#line 315 "yacc_sql.y"
                   {
       (yyval.sql_node) = new ParsedSqlNode(SCF_ROLLBACK);
     }
-#line 1832 "yacc_sql.cpp"
+#line 1900 "yacc_sql.cpp"
     break;
 
   case 30: /* drop_table_stmt: DROP TABLE ID  */
-#line 276 "yacc_sql.y"
+#line 321 "yacc_sql.y"
                   {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_TABLE);
       (yyval.sql_node)->drop_table.relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 1842 "yacc_sql.cpp"
+#line 1910 "yacc_sql.cpp"
     break;
 
   case 31: /* show_tables_stmt: SHOW TABLES  */
-#line 283 "yacc_sql.y"
+#line 328 "yacc_sql.y"
                 {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SHOW_TABLES);
     }
-#line 1850 "yacc_sql.cpp"
+#line 1918 "yacc_sql.cpp"
     break;
 
   case 32: /* desc_table_stmt: DESC ID  */
-#line 289 "yacc_sql.y"
+#line 334 "yacc_sql.y"
              {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DESC_TABLE);
       (yyval.sql_node)->desc_table.relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 1860 "yacc_sql.cpp"
+#line 1928 "yacc_sql.cpp"
     break;
 
-  case 33: /* create_index_stmt: CREATE opt_unique INDEX ID ON ID LBRACE id_list RBRACE SEMICOLON  */
-#line 298 "yacc_sql.y"
+  case 33: /* create_index_stmt: CREATE opt_unique INDEX ID ON ID LBRACE id_list RBRACE index_type SEMICOLON  */
+#line 343 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_INDEX);
       CreateIndexSqlNode &create_index = (yyval.sql_node)->create_index;
-      create_index.index_name = (yyvsp[-6].string);
-      create_index.relation_name = (yyvsp[-4].string);
-      create_index.attribute_names = *(yyvsp[-2].id_list);
-      create_index.is_unique = (yyvsp[-8].opt_unique) ? 1 : 0;
-      delete (yyvsp[-2].id_list);
-      free((yyvsp[-6].string));
-      free((yyvsp[-4].string));
+      create_index.index_name = (yyvsp[-7].string);
+      create_index.relation_name = (yyvsp[-5].string);
+      create_index.attribute_names = *(yyvsp[-3].id_list);
+      create_index.is_unique = (yyvsp[-9].opt_unique) ? 1 : 0;
+      if ((yyvsp[-1].string) != nullptr) {
+        create_index.index_type = (yyvsp[-1].string);
+        free((yyvsp[-1].string));
+      }
+      delete (yyvsp[-3].id_list);
+      free((yyvsp[-7].string));
+      free((yyvsp[-5].string));
     }
-#line 1876 "yacc_sql.cpp"
+#line 1948 "yacc_sql.cpp"
+    break;
+
+  case 34: /* index_type: %empty  */
+#line 362 "yacc_sql.y"
+    {
+      (yyval.string) = nullptr;
+    }
+#line 1956 "yacc_sql.cpp"
     break;
 
-  case 34: /* opt_unique: %empty  */
-#line 313 "yacc_sql.y"
+  case 35: /* index_type: USING ID  */
+#line 366 "yacc_sql.y"
+    {
+      (yyval.string) = (yyvsp[0].string);
+    }
+#line 1964 "yacc_sql.cpp"
+    break;
+
+  case 36: /* opt_unique: %empty  */
+#line 373 "yacc_sql.y"
     {
       (yyval.opt_unique) = 0;
     }
-#line 1884 "yacc_sql.cpp"
+#line 1972 "yacc_sql.cpp"
     break;
 
-  case 35: /* opt_unique: UNIQUE  */
-#line 317 "yacc_sql.y"
+  case 37: /* opt_unique: UNIQUE  */
+#line 377 "yacc_sql.y"
     {
       (yyval.opt_unique) = 1;
     }
-#line 1892 "yacc_sql.cpp"
+#line 1980 "yacc_sql.cpp"
     break;
 
-  case 36: /* id_list: ID  */
-#line 324 "yacc_sql.y"
+  case 38: /* id_list: ID  */
+#line 384 "yacc_sql.y"
     {
       (yyval.id_list) = new std::vector<std::string>;
       (yyval.id_list)->emplace_back((yyvsp[0].string));
       free((yyvsp[0].string));
     }
-#line 1902 "yacc_sql.cpp"
+#line 1990 "yacc_sql.cpp"
     break;
 
-  case 37: /* id_list: id_list COMMA ID  */
-#line 330 "yacc_sql.y"
+  case 39: /* id_list: id_list COMMA ID  */
+#line 390 "yacc_sql.y"
     {
       (yyval.id_list) = (yyvsp[-2].id_list);
       (yyval.id_list)->emplace_back((yyvsp[0].string));
       free((yyvsp[0].string));
     }
-#line 1912 "yacc_sql.cpp"
+#line 2000 "yacc_sql.cpp"
     break;
 
-  case 38: /* drop_index_stmt: DROP INDEX ID ON ID  */
-#line 339 "yacc_sql.y"
+  case 40: /* drop_index_stmt: DROP INDEX ID ON ID  */
+#line 399 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DROP_INDEX);
       (yyval.sql_node)->drop_index.index_name = (yyvsp[-2].string);
@@ -1920,40 +2008,61 @@ yyreduce:
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 1924 "yacc_sql.cpp"
+#line 2012 "yacc_sql.cpp"
     break;
 
-  case 39: /* create_table_stmt: CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE  */
-#line 349 "yacc_sql.y"
+  case 41: /* create_table_stmt: CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE storage_format  */
+#line 409 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CREATE_TABLE);
       CreateTableSqlNode &create_table = (yyval.sql_node)->create_table;
-      create_table.relation_name = (yyvsp[-4].string);
-      free((yyvsp[-4].string));
+      create_table.relation_name = (yyvsp[-5].string);
+      free((yyvsp[-5].string));
+
+      if ((yyvsp[0].string) != nullptr) {
+        create_table.storage_format = (yyvsp[0].string);
+        free((yyvsp[0].string));
+      }
 
-      std::vector<AttrInfoSqlNode> *src_attrs = (yyvsp[-1].attr_infos);
+      std::vector<AttrInfoSqlNode> *src_attrs = (yyvsp[-2].attr_infos);
 
       if (src_attrs != nullptr) {
         create_table.attr_infos.swap(*src_attrs);
         delete src_attrs;
       }
-      create_table.attr_infos.emplace_back(*(yyvsp[-2].attr_info));
+      create_table.attr_infos.emplace_back(*(yyvsp[-3].attr_info));
       std::reverse(create_table.attr_infos.begin(), create_table.attr_infos.end());
-      delete (yyvsp[-2].attr_info);
+      delete (yyvsp[-3].attr_info);
+    }
+#line 2038 "yacc_sql.cpp"
+    break;
+
+  case 42: /* storage_format: %empty  */
+#line 433 "yacc_sql.y"
+    {
+      (yyval.string) = nullptr;
     }
-#line 1945 "yacc_sql.cpp"
+#line 2046 "yacc_sql.cpp"
     break;
 
-  case 40: /* attr_def_list: %empty  */
-#line 368 "yacc_sql.y"
+  case 43: /* storage_format: STORAGE FORMAT EQ ID  */
+#line 437 "yacc_sql.y"
+    {
+      (yyval.string) = (yyvsp[0].string);
+    }
+#line 2054 "yacc_sql.cpp"
+    break;
+
+  case 44: /* attr_def_list: %empty  */
+#line 443 "yacc_sql.y"
     {
       (yyval.attr_infos) = nullptr;
     }
-#line 1953 "yacc_sql.cpp"
+#line 2062 "yacc_sql.cpp"
     break;
 
-  case 41: /* attr_def_list: COMMA attr_def attr_def_list  */
-#line 372 "yacc_sql.y"
+  case 45: /* attr_def_list: COMMA attr_def attr_def_list  */
+#line 447 "yacc_sql.y"
     {
       if ((yyvsp[0].attr_infos) != nullptr) {
         (yyval.attr_infos) = (yyvsp[0].attr_infos);
@@ -1963,11 +2072,11 @@ yyreduce:
       (yyval.attr_infos)->emplace_back(*(yyvsp[-1].attr_info));
       delete (yyvsp[-1].attr_info);
     }
-#line 1967 "yacc_sql.cpp"
+#line 2076 "yacc_sql.cpp"
     break;
 
-  case 42: /* attr_def: ID type LBRACE number RBRACE  */
-#line 385 "yacc_sql.y"
+  case 46: /* attr_def: ID type LBRACE number RBRACE  */
+#line 460 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[-3].number);
@@ -1975,11 +2084,11 @@ yyreduce:
       (yyval.attr_info)->length = (yyvsp[-1].number);
       free((yyvsp[-4].string));
     }
-#line 1979 "yacc_sql.cpp"
+#line 2088 "yacc_sql.cpp"
     break;
 
-  case 43: /* attr_def: ID type  */
-#line 393 "yacc_sql.y"
+  case 47: /* attr_def: ID type  */
+#line 468 "yacc_sql.y"
     {
       (yyval.attr_info) = new AttrInfoSqlNode;
       (yyval.attr_info)->type = (AttrType)(yyvsp[0].number);
@@ -1987,62 +2096,62 @@ yyreduce:
       (yyval.attr_info)->length = 4;
       free((yyvsp[-1].string));
     }
-#line 1991 "yacc_sql.cpp"
+#line 2100 "yacc_sql.cpp"
     break;
 
-  case 44: /* number: NUMBER  */
-#line 402 "yacc_sql.y"
+  case 48: /* number: NUMBER  */
+#line 477 "yacc_sql.y"
            {(yyval.number) = (yyvsp[0].number);}
-#line 1997 "yacc_sql.cpp"
+#line 2106 "yacc_sql.cpp"
     break;
 
-  case 45: /* type: INT_T  */
-#line 405 "yacc_sql.y"
+  case 49: /* type: INT_T  */
+#line 480 "yacc_sql.y"
                { (yyval.number)=INTS; }
-#line 2003 "yacc_sql.cpp"
+#line 2112 "yacc_sql.cpp"
     break;
 
-  case 46: /* type: STRING_T  */
-#line 406 "yacc_sql.y"
+  case 50: /* type: STRING_T  */
+#line 481 "yacc_sql.y"
                { (yyval.number)=CHARS; }
-#line 2009 "yacc_sql.cpp"
+#line 2118 "yacc_sql.cpp"
     break;
 
-  case 47: /* type: FLOAT_T  */
-#line 407 "yacc_sql.y"
+  case 51: /* type: FLOAT_T  */
+#line 482 "yacc_sql.y"
                { (yyval.number)=FLOATS; }
-#line 2015 "yacc_sql.cpp"
+#line 2124 "yacc_sql.cpp"
     break;
 
-  case 48: /* type: DATE_T  */
-#line 408 "yacc_sql.y"
+  case 52: /* type: DATE_T  */
+#line 483 "yacc_sql.y"
               { (yyval.number)=DATES; }
-#line 2021 "yacc_sql.cpp"
+#line 2130 "yacc_sql.cpp"
     break;
 
-  case 49: /* analyze_stmt: ANALYZE TABLE ID LBRACE id_list RBRACE  */
-#line 413 "yacc_sql.y"
+  case 53: /* analyze_stmt: ANALYZE TABLE ID LBRACE id_list RBRACE  */
+#line 488 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_ANALYZE);
       (yyval.sql_node)->analyze_table.relation_name = (yyvsp[-3].string);
       (yyval.sql_node)->analyze_table.attribute_name = *(yyvsp[-1].id_list); // 使用 id_list 存储多个列名
       free((yyvsp[-3].string));
     }
-#line 2032 "yacc_sql.cpp"
+#line 2141 "yacc_sql.cpp"
     break;
 
-  case 50: /* analyze_stmt: ANALYZE TABLE ID  */
-#line 420 "yacc_sql.y"
+  case 54: /* analyze_stmt: ANALYZE TABLE ID  */
+#line 495 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_ANALYZE);
       (yyval.sql_node)->analyze_table.relation_name = (yyvsp[0].string);
       free((yyvsp[0].string));
     }
-#line 2042 "yacc_sql.cpp"
+#line 2151 "yacc_sql.cpp"
     break;
 
-  case 51: /* insert_stmt: INSERT INTO ID VALUES LBRACE value value_list RBRACE  */
-#line 429 "yacc_sql.y"
+  case 55: /* insert_stmt: INSERT INTO ID VALUES LBRACE value value_list RBRACE  */
+#line 504 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_INSERT);
       (yyval.sql_node)->insertion.relation_name = (yyvsp[-5].string);
@@ -2055,19 +2164,19 @@ yyreduce:
       delete (yyvsp[-2].value);
       free((yyvsp[-5].string));
     }
-#line 2059 "yacc_sql.cpp"
+#line 2168 "yacc_sql.cpp"
     break;
 
-  case 52: /* value_list: %empty  */
-#line 445 "yacc_sql.y"
+  case 56: /* value_list: %empty  */
+#line 520 "yacc_sql.y"
     {
       (yyval.value_list) = nullptr;
     }
-#line 2067 "yacc_sql.cpp"
+#line 2176 "yacc_sql.cpp"
     break;
 
-  case 53: /* value_list: COMMA value value_list  */
-#line 448 "yacc_sql.y"
+  case 57: /* value_list: COMMA value value_list  */
+#line 523 "yacc_sql.y"
                               { 
       if ((yyvsp[0].value_list) != nullptr) {
         (yyval.value_list) = (yyvsp[0].value_list);
@@ -2077,40 +2186,40 @@ yyreduce:
       (yyval.value_list)->emplace_back(*(yyvsp[-1].value));
       delete (yyvsp[-1].value);
     }
-#line 2081 "yacc_sql.cpp"
+#line 2190 "yacc_sql.cpp"
     break;
 
-  case 54: /* value: NUMBER  */
-#line 459 "yacc_sql.y"
+  case 58: /* value: NUMBER  */
+#line 534 "yacc_sql.y"
            {
       (yyval.value) = new Value((int)(yyvsp[0].number));
       (yyloc) = (yylsp[0]);
     }
-#line 2090 "yacc_sql.cpp"
+#line 2199 "yacc_sql.cpp"
     break;
 
-  case 55: /* value: FLOAT  */
-#line 463 "yacc_sql.y"
+  case 59: /* value: FLOAT  */
+#line 538 "yacc_sql.y"
            {
       (yyval.value) = new Value((float)(yyvsp[0].floats));
       (yyloc) = (yylsp[0]);
     }
-#line 2099 "yacc_sql.cpp"
+#line 2208 "yacc_sql.cpp"
     break;
 
-  case 56: /* value: SSS  */
-#line 467 "yacc_sql.y"
+  case 60: /* value: SSS  */
+#line 542 "yacc_sql.y"
          {
       char *tmp = common::substr((yyvsp[0].string),1,strlen((yyvsp[0].string))-2);
       (yyval.value) = new Value(tmp);
       free(tmp);
       free((yyvsp[0].string));
     }
-#line 2110 "yacc_sql.cpp"
+#line 2219 "yacc_sql.cpp"
     break;
 
-  case 57: /* delete_stmt: DELETE FROM ID where  */
-#line 477 "yacc_sql.y"
+  case 61: /* delete_stmt: DELETE FROM ID where  */
+#line 552 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_DELETE);
       (yyval.sql_node)->deletion.relation_name = (yyvsp[-1].string);
@@ -2120,11 +2229,11 @@ yyreduce:
       }
       free((yyvsp[-1].string));
     }
-#line 2124 "yacc_sql.cpp"
+#line 2233 "yacc_sql.cpp"
     break;
 
-  case 58: /* update_stmt: UPDATE ID SET ID EQ value where  */
-#line 489 "yacc_sql.y"
+  case 62: /* update_stmt: UPDATE ID SET ID EQ value where  */
+#line 564 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_UPDATE);
       (yyval.sql_node)->update.relation_name = (yyvsp[-5].string);
@@ -2137,71 +2246,75 @@ yyreduce:
       free((yyvsp[-5].string));
       free((yyvsp[-3].string));
     }
-#line 2141 "yacc_sql.cpp"
+#line 2250 "yacc_sql.cpp"
     break;
 
-  case 59: /* select_stmt: SELECT selector FROM rel_list where order_list  */
-#line 504 "yacc_sql.y"
+  case 63: /* select_stmt: SELECT selector FROM rel_list where order_list limit  */
+#line 579 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SELECT);
-      if ((yyvsp[-4].rel_attr_list) != nullptr) {
-        (yyval.sql_node)->selection.attributes.swap(*(yyvsp[-4].rel_attr_list));
-        delete (yyvsp[-4].rel_attr_list);
+      if ((yyvsp[-5].rel_attr_list) != nullptr) {
+        (yyval.sql_node)->selection.attributes.swap(*(yyvsp[-5].rel_attr_list));
+        delete (yyvsp[-5].rel_attr_list);
       }
-      if ((yyvsp[-2].relation_list) != nullptr) {
-        (yyval.sql_node)->selection.relations.swap(*(yyvsp[-2].relation_list));
-        delete (yyvsp[-2].relation_list);
+      if ((yyvsp[-3].relation_list) != nullptr) {
+        (yyval.sql_node)->selection.relations.swap(*(yyvsp[-3].relation_list));
+        delete (yyvsp[-3].relation_list);
       }
-      if ((yyvsp[-1].condition_list) != nullptr) {
-        (yyval.sql_node)->selection.conditions.swap(*(yyvsp[-1].condition_list));
-        delete (yyvsp[-1].condition_list);
+      if ((yyvsp[-2].condition_list) != nullptr) {
+        (yyval.sql_node)->selection.conditions.swap(*(yyvsp[-2].condition_list));
+        delete (yyvsp[-2].condition_list);
       }
-      if ((yyvsp[0].order_list) != nullptr) {
-        (yyval.sql_node)->selection.orders.swap(*(yyvsp[0].order_list));
-        delete (yyvsp[0].order_list);
+      if ((yyvsp[-1].order_list) != nullptr) {
+        (yyval.sql_node)->selection.orders.swap(*(yyvsp[-1].order_list));
+        delete (yyvsp[-1].order_list);
+      }
+      if ((yyvsp[0].limit_node) != nullptr) {
+        (yyval.sql_node)->selection.limit = *(yyvsp[0].limit_node);
+        delete (yyvsp[0].limit_node);
       }
     }
-#line 2165 "yacc_sql.cpp"
+#line 2278 "yacc_sql.cpp"
     break;
 
-  case 60: /* selector: rel_attr_aggre  */
-#line 527 "yacc_sql.y"
+  case 64: /* selector: rel_attr_aggre  */
+#line 606 "yacc_sql.y"
     {
       (yyval.rel_attr_list) = new std::vector<RelAttrSqlNode>{*(yyvsp[0].rel_attr)}; 
       delete (yyvsp[0].rel_attr);  
     }
-#line 2174 "yacc_sql.cpp"
+#line 2287 "yacc_sql.cpp"
     break;
 
-  case 61: /* selector: selector COMMA rel_attr_aggre  */
-#line 532 "yacc_sql.y"
+  case 65: /* selector: selector COMMA rel_attr_aggre  */
+#line 611 "yacc_sql.y"
     {
       (yyval.rel_attr_list)->emplace_back(*(yyvsp[0].rel_attr)); 
       delete (yyvsp[0].rel_attr); 
     }
-#line 2183 "yacc_sql.cpp"
+#line 2296 "yacc_sql.cpp"
     break;
 
-  case 62: /* rel_attr_aggre: rel_attr  */
-#line 543 "yacc_sql.y"
+  case 66: /* rel_attr_aggre: rel_attr  */
+#line 622 "yacc_sql.y"
     {
       (yyval.rel_attr) = (yyvsp[0].rel_attr); 
     }
-#line 2191 "yacc_sql.cpp"
+#line 2304 "yacc_sql.cpp"
     break;
 
-  case 63: /* rel_attr_aggre: aggre_node  */
-#line 547 "yacc_sql.y"
+  case 67: /* rel_attr_aggre: aggre_node  */
+#line 626 "yacc_sql.y"
     {
       (yyval.rel_attr) = new RelAttrSqlNode;
       (yyval.rel_attr)->aggretion_node = *(yyvsp[0].aggre_node); 
       delete (yyvsp[0].aggre_node); 
     }
-#line 2201 "yacc_sql.cpp"
+#line 2314 "yacc_sql.cpp"
     break;
 
-  case 64: /* aggre_node: aggre_type LBRACE aggre_attr_list RBRACE  */
-#line 560 "yacc_sql.y"
+  case 68: /* aggre_node: aggre_type LBRACE aggre_attr_list RBRACE  */
+#line 639 "yacc_sql.y"
     {
       (yyval.aggre_node) = new AggreTypeNode;
       (yyval.aggre_node)->aggre_type = (yyvsp[-3].aggre_type); 
@@ -2210,154 +2323,189 @@ yyreduce:
         delete (yyvsp[-1].aggre_attr_list); 
       }
     }
-#line 2214 "yacc_sql.cpp"
+#line 2327 "yacc_sql.cpp"
     break;
 
-  case 65: /* rel_attr: attr_name  */
-#line 572 "yacc_sql.y"
+  case 69: /* rel_attr: attr_name  */
+#line 651 "yacc_sql.y"
     {
       (yyval.rel_attr) = new RelAttrSqlNode{"", (yyvsp[0].string)};
       free((yyvsp[0].string));
     }
-#line 2223 "yacc_sql.cpp"
+#line 2336 "yacc_sql.cpp"
     break;
 
-  case 66: /* rel_attr: rel_name DOT attr_name  */
-#line 577 "yacc_sql.y"
+  case 70: /* rel_attr: rel_name DOT attr_name  */
+#line 656 "yacc_sql.y"
     {
       (yyval.rel_attr) = new RelAttrSqlNode{(yyvsp[-2].string), (yyvsp[0].string)};
       free((yyvsp[-2].string));
       free((yyvsp[0].string));
     }
-#line 2233 "yacc_sql.cpp"
+#line 2346 "yacc_sql.cpp"
     break;
 
-  case 67: /* attr_list: attr_name  */
-#line 586 "yacc_sql.y"
+  case 71: /* attr_list: attr_name  */
+#line 665 "yacc_sql.y"
     {
       (yyval.relation_list) = new std::vector<std::string>{(yyvsp[0].string)};
       free((yyvsp[0].string)); 
     }
-#line 2242 "yacc_sql.cpp"
+#line 2355 "yacc_sql.cpp"
     break;
 
-  case 68: /* attr_list: attr_list COMMA attr_name  */
-#line 591 "yacc_sql.y"
+  case 72: /* attr_list: attr_list COMMA attr_name  */
+#line 670 "yacc_sql.y"
     {
       (yyval.relation_list)->emplace_back((yyvsp[0].string)); 
       free((yyvsp[0].string));
     }
-#line 2251 "yacc_sql.cpp"
+#line 2364 "yacc_sql.cpp"
     break;
 
-  case 69: /* rel_list: %empty  */
-#line 599 "yacc_sql.y"
+  case 73: /* rel_list: %empty  */
+#line 678 "yacc_sql.y"
     {
       (yyval.relation_list) = nullptr;
     }
-#line 2259 "yacc_sql.cpp"
+#line 2372 "yacc_sql.cpp"
     break;
 
-  case 70: /* rel_list: rel_name  */
-#line 603 "yacc_sql.y"
+  case 74: /* rel_list: rel_name  */
+#line 682 "yacc_sql.y"
     {
       (yyval.relation_list) = new std::vector<std::string>{(yyvsp[0].string)};
       free((yyvsp[0].string)); 
     }
-#line 2268 "yacc_sql.cpp"
+#line 2381 "yacc_sql.cpp"
     break;
 
-  case 71: /* rel_list: rel_list COMMA rel_name  */
-#line 608 "yacc_sql.y"
+  case 75: /* rel_list: rel_list COMMA rel_name  */
+#line 687 "yacc_sql.y"
     {
       (yyval.relation_list)->emplace_back((yyvsp[0].string)); 
       free((yyvsp[0].string));
     }
-#line 2277 "yacc_sql.cpp"
+#line 2390 "yacc_sql.cpp"
     break;
 
-  case 72: /* where: %empty  */
-#line 615 "yacc_sql.y"
+  case 76: /* where: %empty  */
+#line 694 "yacc_sql.y"
     {
       (yyval.condition_list) = nullptr;
     }
-#line 2285 "yacc_sql.cpp"
+#line 2398 "yacc_sql.cpp"
     break;
 
-  case 73: /* where: WHERE condition_list  */
-#line 618 "yacc_sql.y"
+  case 77: /* where: WHERE condition_list  */
+#line 697 "yacc_sql.y"
                            {
       (yyval.condition_list) = (yyvsp[0].condition_list);  
     }
-#line 2293 "yacc_sql.cpp"
+#line 2406 "yacc_sql.cpp"
     break;
 
-  case 74: /* order_node: rel_attr order_type  */
-#line 625 "yacc_sql.y"
+  case 78: /* order_node: rel_attr order_type  */
+#line 704 "yacc_sql.y"
     {
       (yyval.order_node) = new OrderSqlNode{*(yyvsp[-1].rel_attr),(yyvsp[0].order_type)};
       delete (yyvsp[-1].rel_attr);
     }
-#line 2302 "yacc_sql.cpp"
+#line 2415 "yacc_sql.cpp"
     break;
 
-  case 75: /* order_list: %empty  */
-#line 637 "yacc_sql.y"
+  case 79: /* order_list: %empty  */
+#line 716 "yacc_sql.y"
     {
       (yyval.order_list) = nullptr;
     }
-#line 2310 "yacc_sql.cpp"
+#line 2423 "yacc_sql.cpp"
     break;
 
-  case 76: /* order_list: order_node  */
-#line 641 "yacc_sql.y"
+  case 80: /* order_list: ORDER BY order_node  */
+#line 720 "yacc_sql.y"
     {
       (yyval.order_list) = new std::vector<OrderSqlNode>{*(yyvsp[0].order_node)};
       delete (yyvsp[0].order_node);
     }
-#line 2319 "yacc_sql.cpp"
+#line 2432 "yacc_sql.cpp"
     break;
 
-  case 77: /* order_list: ORDER BY order_node  */
-#line 646 "yacc_sql.y"
+  case 81: /* order_list: order_list COMMA order_node  */
+#line 725 "yacc_sql.y"
     {
-      (yyval.order_list) = new std::vector<OrderSqlNode>{*(yyvsp[0].order_node)};
+      (yyval.order_list)->emplace_back(*(yyvsp[0].order_node));
       delete (yyvsp[0].order_node);
     }
-#line 2328 "yacc_sql.cpp"
+#line 2441 "yacc_sql.cpp"
     break;
 
-  case 78: /* order_list: order_list COMMA order_node  */
-#line 651 "yacc_sql.y"
+  case 82: /* limit: %empty  */
+#line 737 "yacc_sql.y"
     {
-      (yyval.order_list)->emplace_back(*(yyvsp[0].order_node));
-      delete (yyvsp[0].order_node);
+      (yyval.limit_node) = nullptr;
+    }
+#line 2449 "yacc_sql.cpp"
+    break;
+
+  case 83: /* limit: LIMIT NUMBER  */
+#line 741 "yacc_sql.y"
+    {
+      (yyval.limit_node) = create_limit((yyvsp[0].number), 0);
+      if ((yyval.limit_node) == nullptr) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "limit and offset must not be negative");
+        YYERROR;
+      }
     }
-#line 2337 "yacc_sql.cpp"
+#line 2461 "yacc_sql.cpp"
     break;
 
-  case 79: /* calc_stmt: CALC expression_list  */
-#line 659 "yacc_sql.y"
+  case 84: /* limit: LIMIT NUMBER OFFSET NUMBER  */
+#line 749 "yacc_sql.y"
+    {
+      (yyval.limit_node) = create_limit((yyvsp[-2].number), (yyvsp[0].number));
+      if ((yyval.limit_node) == nullptr) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "limit and offset must not be negative");
+        YYERROR;
+      }
+    }
+#line 2473 "yacc_sql.cpp"
+    break;
+
+  case 85: /* limit: LIMIT NUMBER COMMA NUMBER  */
+#line 757 "yacc_sql.y"
+    {
+      (yyval.limit_node) = create_limit((yyvsp[0].number), (yyvsp[-2].number));
+      if ((yyval.limit_node) == nullptr) {
+        yyerror(&(yyloc), sql_string, sql_result, scanner, "limit and offset must not be negative");
+        YYERROR;
+      }
+    }
+#line 2485 "yacc_sql.cpp"
+    break;
+
+  case 86: /* calc_stmt: CALC expression_list  */
+#line 768 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_CALC);
       std::reverse((yyvsp[0].expression_list)->begin(), (yyvsp[0].expression_list)->end());
       (yyval.sql_node)->calc.expressions.swap(*(yyvsp[0].expression_list));
       delete (yyvsp[0].expression_list);
     }
-#line 2348 "yacc_sql.cpp"
+#line 2496 "yacc_sql.cpp"
     break;
 
-  case 80: /* expression_list: expression  */
-#line 669 "yacc_sql.y"
+  case 87: /* expression_list: expression  */
+#line 778 "yacc_sql.y"
     {
       (yyval.expression_list) = new std::vector<Expression*>;
       (yyval.expression_list)->emplace_back((yyvsp[0].expression));
     }
-#line 2357 "yacc_sql.cpp"
+#line 2505 "yacc_sql.cpp"
     break;
 
-  case 81: /* expression_list: expression COMMA expression_list  */
-#line 674 "yacc_sql.y"
+  case 88: /* expression_list: expression COMMA expression_list  */
+#line 783 "yacc_sql.y"
     {
       if ((yyvsp[0].expression_list) != nullptr) {
         (yyval.expression_list) = (yyvsp[0].expression_list);
@@ -2366,98 +2514,98 @@ yyreduce:
       }
       (yyval.expression_list)->emplace_back((yyvsp[-2].expression));
     }
-#line 2370 "yacc_sql.cpp"
+#line 2518 "yacc_sql.cpp"
     break;
 
-  case 82: /* expression: expression '+' expression  */
-#line 684 "yacc_sql.y"
+  case 89: /* expression: expression '+' expression  */
+#line 793 "yacc_sql.y"
                               {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::ADD, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2378 "yacc_sql.cpp"
+#line 2526 "yacc_sql.cpp"
     break;
 
-  case 83: /* expression: expression '-' expression  */
-#line 687 "yacc_sql.y"
+  case 90: /* expression: expression '-' expression  */
+#line 796 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::SUB, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2386 "yacc_sql.cpp"
+#line 2534 "yacc_sql.cpp"
     break;
 
-  case 84: /* expression: expression '*' expression  */
-#line 690 "yacc_sql.y"
+  case 91: /* expression: expression '*' expression  */
+#line 799 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::MUL, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2394 "yacc_sql.cpp"
+#line 2542 "yacc_sql.cpp"
     break;
 
-  case 85: /* expression: expression '/' expression  */
-#line 693 "yacc_sql.y"
+  case 92: /* expression: expression '/' expression  */
+#line 802 "yacc_sql.y"
                                 {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::DIV, (yyvsp[-2].expression), (yyvsp[0].expression), sql_string, &(yyloc));
     }
-#line 2402 "yacc_sql.cpp"
+#line 2550 "yacc_sql.cpp"
     break;
 
-  case 86: /* expression: LBRACE expression RBRACE  */
-#line 696 "yacc_sql.y"
+  case 93: /* expression: LBRACE expression RBRACE  */
+#line 805 "yacc_sql.y"
                                {
       (yyval.expression) = (yyvsp[-1].expression);
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
     }
-#line 2411 "yacc_sql.cpp"
+#line 2559 "yacc_sql.cpp"
     break;
 
-  case 87: /* expression: '-' expression  */
-#line 700 "yacc_sql.y"
+  case 94: /* expression: '-' expression  */
+#line 809 "yacc_sql.y"
                                   {
       (yyval.expression) = create_arithmetic_expression(ArithmeticExpr::Type::NEGATIVE, (yyvsp[0].expression), nullptr, sql_string, &(yyloc));
     }
-#line 2419 "yacc_sql.cpp"
+#line 2567 "yacc_sql.cpp"
     break;
 
-  case 88: /* expression: value  */
-#line 703 "yacc_sql.y"
+  case 95: /* expression: value  */
+#line 812 "yacc_sql.y"
             {
       (yyval.expression) = new ValueExpr(*(yyvsp[0].value));
       (yyval.expression)->set_name(token_name(sql_string, &(yyloc)));
       delete (yyvsp[0].value);
     }
-#line 2429 "yacc_sql.cpp"
+#line 2577 "yacc_sql.cpp"
     break;
 
-  case 89: /* condition_list: %empty  */
-#line 712 "yacc_sql.y"
+  case 96: /* condition_list: %empty  */
+#line 821 "yacc_sql.y"
     {
       (yyval.condition_list) = nullptr;
     }
-#line 2437 "yacc_sql.cpp"
+#line 2585 "yacc_sql.cpp"
     break;
 
-  case 90: /* condition_list: condition  */
-#line 715 "yacc_sql.y"
+  case 97: /* condition_list: condition  */
+#line 824 "yacc_sql.y"
                 {
       (yyval.condition_list) = new std::vector<ConditionSqlNode>;
       (yyval.condition_list)->emplace_back(*(yyvsp[0].condition));
       delete (yyvsp[0].condition);
     }
-#line 2447 "yacc_sql.cpp"
+#line 2595 "yacc_sql.cpp"
     break;
 
-  case 91: /* condition_list: condition AND condition_list  */
-#line 720 "yacc_sql.y"
+  case 98: /* condition_list: condition AND condition_list  */
+#line 829 "yacc_sql.y"
                                    {
       (yyval.condition_list) = (yyvsp[0].condition_list);
       (yyval.condition_list)->emplace_back(*(yyvsp[-2].condition));
       delete (yyvsp[-2].condition);
     }
-#line 2457 "yacc_sql.cpp"
+#line 2605 "yacc_sql.cpp"
     break;
 
-  case 92: /* condition: rel_attr comp_op value  */
-#line 728 "yacc_sql.y"
+  case 99: /* condition: rel_attr comp_op value  */
+#line 837 "yacc_sql.y"
     {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_is_attr = 1;
@@ -2469,11 +2617,11 @@ yyreduce:
       delete (yyvsp[-2].rel_attr);
       delete (yyvsp[0].value);
     }
-#line 2473 "yacc_sql.cpp"
+#line 2621 "yacc_sql.cpp"
     break;
 
-  case 93: /* condition: value comp_op value  */
-#line 740 "yacc_sql.y"
+  case 100: /* condition: value comp_op value  */
+#line 849 "yacc_sql.y"
     {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_is_attr = 0;
@@ -2485,11 +2633,11 @@ yyreduce:
       delete (yyvsp[-2].value);
       delete (yyvsp[0].value);
     }
-#line 2489 "yacc_sql.cpp"
+#line 2637 "yacc_sql.cpp"
     break;
 
-  case 94: /* condition: rel_attr comp_op rel_attr  */
-#line 752 "yacc_sql.y"
+  case 101: /* condition: rel_attr comp_op rel_attr  */
+#line 861 "yacc_sql.y"
     {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_is_attr = 1;
@@ -2501,11 +2649,11 @@ yyreduce:
       delete (yyvsp[-2].rel_attr);
       delete (yyvsp[0].rel_attr);
     }
-#line 2505 "yacc_sql.cpp"
+#line 2653 "yacc_sql.cpp"
     break;
 
-  case 95: /* condition: value comp_op rel_attr  */
-#line 764 "yacc_sql.y"
+  case 102: /* condition: value comp_op rel_attr  */
+#line 873 "yacc_sql.y"
     {
       (yyval.condition) = new ConditionSqlNode;
       (yyval.condition)->left_is_attr = 0;
@@ -2517,107 +2665,139 @@ yyreduce:
       delete (yyvsp[-2].value);
       delete (yyvsp[0].rel_attr);
     }
-#line 2521 "yacc_sql.cpp"
+#line 2669 "yacc_sql.cpp"
     break;
 
-  case 96: /* comp_op: EQ  */
-#line 778 "yacc_sql.y"
+  case 103: /* condition: rel_attr IN LBRACE select_stmt RBRACE  */
+#line 885 "yacc_sql.y"
+    {
+      (yyval.condition) = create_subquery_condition(IN_OP, (yyvsp[-4].rel_attr), (yyvsp[-1].sql_node));
+    }
+#line 2677 "yacc_sql.cpp"
+    break;
+
+  case 104: /* condition: rel_attr NOT IN LBRACE select_stmt RBRACE  */
+#line 889 "yacc_sql.y"
+    {
+      (yyval.condition) = create_subquery_condition(NOT_IN_OP, (yyvsp[-5].rel_attr), (yyvsp[-1].sql_node));
+    }
+#line 2685 "yacc_sql.cpp"
+    break;
+
+  case 105: /* condition: EXISTS LBRACE select_stmt RBRACE  */
+#line 893 "yacc_sql.y"
+    {
+      (yyval.condition) = create_subquery_condition(EXISTS_OP, nullptr, (yyvsp[-1].sql_node));
+    }
+#line 2693 "yacc_sql.cpp"
+    break;
+
+  case 106: /* condition: NOT EXISTS LBRACE select_stmt RBRACE  */
+#line 897 "yacc_sql.y"
+    {
+      (yyval.condition) = create_subquery_condition(NOT_EXISTS_OP, nullptr, (yyvsp[-1].sql_node));
+    }
+#line 2701 "yacc_sql.cpp"
+    break;
+
+  case 107: /* comp_op: EQ  */
+#line 903 "yacc_sql.y"
          { (yyval.comp) = EQUAL_TO; }
-#line 2527 "yacc_sql.cpp"
+#line 2707 "yacc_sql.cpp"
     break;
 
-  case 97: /* comp_op: LT  */
-#line 779 "yacc_sql.y"
+  case 108: /* comp_op: LT  */
+#line 904 "yacc_sql.y"
          { (yyval.comp) = LESS_THAN; }
-#line 2533 "yacc_sql.cpp"
+#line 2713 "yacc_sql.cpp"
     break;
 
-  case 98: /* comp_op: GT  */
-#line 780 "yacc_sql.y"
+  case 109: /* comp_op: GT  */
+#line 905 "yacc_sql.y"
          { (yyval.comp) = GREAT_THAN; }
-#line 2539 "yacc_sql.cpp"
+#line 2719 "yacc_sql.cpp"
     break;
 
-  case 99: /* comp_op: LE  */
-#line 781 "yacc_sql.y"
+  case 110: /* comp_op: LE  */
+#line 906 "yacc_sql.y"
          { (yyval.comp) = LESS_EQUAL; }
-#line 2545 "yacc_sql.cpp"
+#line 2725 "yacc_sql.cpp"
     break;
 
-  case 100: /* comp_op: GE  */
-#line 782 "yacc_sql.y"
+  case 111: /* comp_op: GE  */
+#line 907 "yacc_sql.y"
          { (yyval.comp) = GREAT_EQUAL; }
-#line 2551 "yacc_sql.cpp"
+#line 2731 "yacc_sql.cpp"
     break;
 
-  case 101: /* comp_op: NE  */
-#line 783 "yacc_sql.y"
+  case 112: /* comp_op: NE  */
+#line 908 "yacc_sql.y"
          { (yyval.comp) = NOT_EQUAL; }
-#line 2557 "yacc_sql.cpp"
+#line 2737 "yacc_sql.cpp"
     break;
 
-  case 102: /* comp_op: LK  */
-#line 784 "yacc_sql.y"
+  case 113: /* comp_op: LK  */
+#line 909 "yacc_sql.y"
          { (yyval.comp) = LIKE; }
-#line 2563 "yacc_sql.cpp"
+#line 2743 "yacc_sql.cpp"
     break;
 
-  case 103: /* comp_op: NOT LK  */
-#line 785 "yacc_sql.y"
+  case 114: /* comp_op: NOT LK  */
+#line 910 "yacc_sql.y"
              { (yyval.comp) = NOT_LIKE;}
-#line 2569 "yacc_sql.cpp"
+#line 2749 "yacc_sql.cpp"
     break;
 
-  case 104: /* aggre_type: SUM  */
-#line 789 "yacc_sql.y"
+  case 115: /* aggre_type: SUM  */
+#line 914 "yacc_sql.y"
             { (yyval.aggre_type) = AGGRE_SUM; }
-#line 2575 "yacc_sql.cpp"
+#line 2755 "yacc_sql.cpp"
     break;
 
-  case 105: /* aggre_type: AVG  */
-#line 790 "yacc_sql.y"
+  case 116: /* aggre_type: AVG  */
+#line 915 "yacc_sql.y"
             { (yyval.aggre_type) = AGGRE_AVG; }
-#line 2581 "yacc_sql.cpp"
+#line 2761 "yacc_sql.cpp"
     break;
 
-  case 106: /* aggre_type: COUNT  */
-#line 791 "yacc_sql.y"
+  case 117: /* aggre_type: COUNT  */
+#line 916 "yacc_sql.y"
             { (yyval.aggre_type) = AGGRE_COUNT; }
-#line 2587 "yacc_sql.cpp"
+#line 2767 "yacc_sql.cpp"
     break;
 
-  case 107: /* aggre_type: MAX  */
-#line 792 "yacc_sql.y"
+  case 118: /* aggre_type: MAX  */
+#line 917 "yacc_sql.y"
             { (yyval.aggre_type) = AGGRE_MAX; }
-#line 2593 "yacc_sql.cpp"
+#line 2773 "yacc_sql.cpp"
     break;
 
-  case 108: /* aggre_type: MIN  */
-#line 793 "yacc_sql.y"
+  case 119: /* aggre_type: MIN  */
+#line 918 "yacc_sql.y"
             { (yyval.aggre_type) = AGGRE_MIN; }
-#line 2599 "yacc_sql.cpp"
+#line 2779 "yacc_sql.cpp"
     break;
 
-  case 109: /* order_type: %empty  */
-#line 798 "yacc_sql.y"
+  case 120: /* order_type: %empty  */
+#line 923 "yacc_sql.y"
       {(yyval.order_type) = ORDER_ASC; }
-#line 2605 "yacc_sql.cpp"
+#line 2785 "yacc_sql.cpp"
     break;
 
-  case 110: /* order_type: ASC  */
-#line 799 "yacc_sql.y"
+  case 121: /* order_type: ASC  */
+#line 924 "yacc_sql.y"
             { (yyval.order_type) = ORDER_ASC; }
-#line 2611 "yacc_sql.cpp"
+#line 2791 "yacc_sql.cpp"
     break;
 
-  case 111: /* order_type: DESC  */
-#line 800 "yacc_sql.y"
+  case 122: /* order_type: DESC  */
+#line 925 "yacc_sql.y"
             { (yyval.order_type) = ORDER_DESC; }
-#line 2617 "yacc_sql.cpp"
+#line 2797 "yacc_sql.cpp"
     break;
 
-  case 112: /* load_data_stmt: LOAD DATA INFILE SSS INTO TABLE ID  */
-#line 805 "yacc_sql.y"
+  case 123: /* load_data_stmt: LOAD DATA INFILE SSS INTO TABLE ID  */
+#line 930 "yacc_sql.y"
     {
       char *tmp_file_name = common::substr((yyvsp[-3].string), 1, strlen((yyvsp[-3].string)) - 2);
       
@@ -2627,20 +2807,20 @@ yyreduce:
       free((yyvsp[0].string));
       free(tmp_file_name);
     }
-#line 2631 "yacc_sql.cpp"
+#line 2811 "yacc_sql.cpp"
     break;
 
-  case 113: /* explain_stmt: EXPLAIN command_wrapper  */
-#line 818 "yacc_sql.y"
+  case 124: /* explain_stmt: EXPLAIN command_wrapper  */
+#line 943 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_EXPLAIN);
       (yyval.sql_node)->explain.sql_node = std::unique_ptr<ParsedSqlNode>((yyvsp[0].sql_node));
     }
-#line 2640 "yacc_sql.cpp"
+#line 2820 "yacc_sql.cpp"
     break;
 
-  case 114: /* set_variable_stmt: SET ID EQ value  */
-#line 826 "yacc_sql.y"
+  case 125: /* set_variable_stmt: SET ID EQ value  */
+#line 951 "yacc_sql.y"
     {
       (yyval.sql_node) = new ParsedSqlNode(SCF_SET_VARIABLE);
       (yyval.sql_node)->set_variable.name  = (yyvsp[-2].string);
@@ -2648,89 +2828,89 @@ yyreduce:
       free((yyvsp[-2].string));
       delete (yyvsp[0].value);
     }
-#line 2652 "yacc_sql.cpp"
+#line 2832 "yacc_sql.cpp"
     break;
 
-  case 117: /* aggre_attr_list: %empty  */
-#line 841 "yacc_sql.y"
+  case 128: /* aggre_attr_list: %empty  */
+#line 966 "yacc_sql.y"
     {
       (yyval.aggre_attr_list) = nullptr; 
     }
-#line 2660 "yacc_sql.cpp"
+#line 2840 "yacc_sql.cpp"
     break;
 
-  case 118: /* aggre_attr_list: aggre_attr_name  */
-#line 845 "yacc_sql.y"
+  case 129: /* aggre_attr_list: aggre_attr_name  */
+#line 970 "yacc_sql.y"
     {
       (yyval.aggre_attr_list) = new std::vector<std::string>{(yyvsp[0].string)};
       free((yyvsp[0].string)); 
     }
-#line 2669 "yacc_sql.cpp"
+#line 2849 "yacc_sql.cpp"
     break;
 
-  case 119: /* aggre_attr_list: attr_list COMMA aggre_attr_name  */
-#line 850 "yacc_sql.y"
+  case 130: /* aggre_attr_list: attr_list COMMA aggre_attr_name  */
+#line 975 "yacc_sql.y"
     {
       (yyval.aggre_attr_list)->emplace_back((yyvsp[0].string)); 
       free((yyvsp[0].string));
     }
-#line 2678 "yacc_sql.cpp"
+#line 2858 "yacc_sql.cpp"
     break;
 
-  case 120: /* aggre_attr_name: attr_name  */
-#line 858 "yacc_sql.y"
+  case 131: /* aggre_attr_name: attr_name  */
+#line 983 "yacc_sql.y"
     {
       (yyval.string) = (yyvsp[0].string); 
     }
-#line 2686 "yacc_sql.cpp"
+#line 2866 "yacc_sql.cpp"
     break;
 
-  case 121: /* aggre_attr_name: number  */
-#line 862 "yacc_sql.y"
+  case 132: /* aggre_attr_name: number  */
+#line 987 "yacc_sql.y"
     {
       int str_len = snprintf(NULL, 0, "%d", (yyvsp[0].number));
       char *str = (char *)malloc((str_len + 1) * sizeof(char));
       snprintf(str, str_len + 1, "%d", (yyvsp[0].number));
       (yyval.string) = str;
     }
-#line 2697 "yacc_sql.cpp"
+#line 2877 "yacc_sql.cpp"
     break;
 
-  case 122: /* aggre_attr_name: AGGRE_ATTR  */
-#line 869 "yacc_sql.y"
+  case 133: /* aggre_attr_name: AGGRE_ATTR  */
+#line 994 "yacc_sql.y"
     {
       (yyval.string) = (yyvsp[0].string); 
     }
-#line 2705 "yacc_sql.cpp"
+#line 2885 "yacc_sql.cpp"
     break;
 
-  case 123: /* rel_name: ID  */
-#line 874 "yacc_sql.y"
+  case 134: /* rel_name: ID  */
+#line 999 "yacc_sql.y"
              { (yyval.string) = (yyvsp[0].string); }
-#line 2711 "yacc_sql.cpp"
+#line 2891 "yacc_sql.cpp"
     break;
 
-  case 124: /* attr_name: ID  */
-#line 882 "yacc_sql.y"
+  case 135: /* attr_name: ID  */
+#line 1007 "yacc_sql.y"
     {
       (yyval.string) = (yyvsp[0].string);
     }
-#line 2719 "yacc_sql.cpp"
+#line 2899 "yacc_sql.cpp"
     break;
 
-  case 125: /* attr_name: '*'  */
-#line 886 "yacc_sql.y"
+  case 136: /* attr_name: '*'  */
+#line 1011 "yacc_sql.y"
     {
       // 使用malloc为了和他的free配合
       char *str = (char *)malloc(strlen("*") + 1);  // 加1用于存储字符串结束符'\0'
       strcpy(str, "*");
       (yyval.string) = str;
     }
-#line 2730 "yacc_sql.cpp"
+#line 2910 "yacc_sql.cpp"
     break;
 
 
-#line 2734 "yacc_sql.cpp"
+#line 2914 "yacc_sql.cpp"
 
       default: break;
     }
@@ -2959,7 +3139,7 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 893 "yacc_sql.y"
+#line 1018 "yacc_sql.y"
 
 //_____________________________________________________________________
 extern void scan_string(const char *str, yyscan_t scanner);
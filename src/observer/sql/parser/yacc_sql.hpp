@@ -110,12 +110,19 @@ extern int yydebug;
     MAX = 311,                     /* MAX  */
     NOT = 312,                     /* NOT  */
     LK = 313,                      /* LK  */
-    NUMBER = 314,                  /* NUMBER  */
-    FLOAT = 315,                   /* FLOAT  */
-    ID = 316,                      /* ID  */
-    AGGRE_ATTR = 317,              /* AGGRE_ATTR  */
-    SSS = 318,                     /* SSS  */
-    UMINUS = 319                   /* UMINUS  */
+    IN = 314,                      /* IN  */
+    EXISTS = 315,                  /* EXISTS  */
+    LIMIT = 316,                   /* LIMIT  */
+    OFFSET = 317,                  /* OFFSET  */
+    USING = 318,                   /* USING  */
+    STORAGE = 319,                 /* STORAGE  */
+    FORMAT = 320,                  /* FORMAT  */
+    NUMBER = 321,                  /* NUMBER  */
+    FLOAT = 322,                   /* FLOAT  */
+    ID = 323,                      /* ID  */
+    AGGRE_ATTR = 324,              /* AGGRE_ATTR  */
+    SSS = 325,                     /* SSS  */
+    UMINUS = 326                   /* UMINUS  */
   };
   typedef enum yytokentype yytoken_kind_t;
 #endif
@@ -124,7 +131,7 @@ extern int yydebug;
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 union YYSTYPE
 {
-#line 115 "yacc_sql.y"
+#line 156 "yacc_sql.y"
 
   ParsedSqlNode *                   sql_node;
   ConditionSqlNode *                condition;
@@ -138,6 +145,7 @@ union YYSTYPE
   AttrInfoSqlNode *                 attr_info;
   Expression *                      expression;
   OrderSqlNode *                    order_node;
+  LimitSqlNode *                    limit_node;
   std::vector<Expression *> *       expression_list;
   std::vector<Value> *              value_list;
   std::vector<std::string> *        id_list;
@@ -151,7 +159,7 @@ union YYSTYPE
   int opt_unique;
   float                             floats;
 
-#line 155 "yacc_sql.hpp"
+#line 163 "yacc_sql.hpp"
 
 };
 typedef union YYSTYPE YYSTYPE;
@@ -41,6 +41,40 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
   return expr;
 }
 
+/**
+ * @brief 生成子查询条件，会释放传入的参数
+ */
+ConditionSqlNode *create_subquery_condition(CompOp comp, RelAttrSqlNode *left_attr, ParsedSqlNode *sub_select)
+{
+  ConditionSqlNode *condition = new ConditionSqlNode;
+  condition->left_is_attr     = (left_attr != nullptr) ? 1 : 0;
+  condition->right_is_attr    = 0;
+  condition->comp             = comp;
+  condition->sub_select       = std::make_shared<SelectSqlNode>(std::move(sub_select->selection));
+  if (left_attr != nullptr) {
+    condition->left_attr = *left_attr;
+  }
+
+  delete left_attr;
+  delete sub_select;
+  return condition;
+}
+
+/**
+ * @brief 生成 LIMIT 子句。行数是负数时返回空
+ */
+LimitSqlNode *create_limit(int limit, int offset)
+{
+  if (limit < 0 || offset < 0) {
+    return nullptr;
+  }
+
+  LimitSqlNode *limit_node = new LimitSqlNode;
+  limit_node->limit        = limit;
+  limit_node->offset       = offset;
+  return limit_node;
+}
+
 %}
 
 %define api.pure full
@@ -110,6 +144,13 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
         MAX
         NOT
         LK
+        IN
+        EXISTS
+        LIMIT
+        OFFSET
+        USING
+        STORAGE
+        FORMAT
 
 /** union 中定义各种数据类型，真实生成的代码也是union类型，所以不能有非POD类型的数据 **/
 %union {
@@ -125,6 +166,7 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
   AttrInfoSqlNode *                 attr_info;
   Expression *                      expression;
   OrderSqlNode *                    order_node;
+  LimitSqlNode *                    limit_node;
   std::vector<Expression *> *       expression_list;
   std::vector<Value> *              value_list;
   std::vector<std::string> *        id_list;
@@ -173,6 +215,7 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
 %type <expression_list>     expression_list
 %type <order_node>          order_node
 %type <order_list>          order_list
+%type <limit_node>          limit
 %type <sql_node>            calc_stmt
 %type <sql_node>            analyze_stmt
 %type <sql_node>            select_stmt
@@ -198,6 +241,8 @@ ArithmeticExpr *create_arithmetic_expression(ArithmeticExpr::Type type,
 %type <string>              rel_name  // 表名
 %type <string>              attr_name // 列名
 %type <string>              aggre_attr_name // aggre_attr_name
+%type <string>              storage_format  // 表的存放格式
+%type <string>              index_type      // 索引的类型
 // commands should be a list but I use a single command instead
 %type <sql_node>            commands
 
@@ -294,7 +339,7 @@ desc_table_stmt:
     ;
 
 create_index_stmt:
-    CREATE opt_unique INDEX ID ON ID LBRACE id_list RBRACE SEMICOLON
+    CREATE opt_unique INDEX ID ON ID LBRACE id_list RBRACE index_type SEMICOLON
     {
       $$ = new ParsedSqlNode(SCF_CREATE_INDEX);
       CreateIndexSqlNode &create_index = $$->create_index;
@@ -302,12 +347,27 @@ create_index_stmt:
       create_index.relation_name = $6;
       create_index.attribute_names = *$8;
       create_index.is_unique = $2 ? 1 : 0;
+      if ($10 != nullptr) {
+        create_index.index_type = $10;
+        free($10);
+      }
       delete $8;
       free($4);
       free($6);
     }
     ;
 
+index_type:
+    /* empty */
+    {
+      $$ = nullptr;
+    }
+    | USING ID  // using btree/hash/lsm
+    {
+      $$ = $2;
+    }
+    ;
+
 opt_unique:
     /* empty */
     {
@@ -345,13 +405,18 @@ drop_index_stmt:      /*drop index 语句的语法解析树*/
     }
     ;
 create_table_stmt:    /*create table 语句的语法解析树*/
-    CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE
+    CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE storage_format
     {
       $$ = new ParsedSqlNode(SCF_CREATE_TABLE);
       CreateTableSqlNode &create_table = $$->create_table;
       create_table.relation_name = $3;
       free($3);
 
+      if ($8 != nullptr) {
+        create_table.storage_format = $8;
+        free($8);
+      }
+
       std::vector<AttrInfoSqlNode> *src_attrs = $6;
 
       if (src_attrs != nullptr) {
@@ -363,6 +428,16 @@ create_table_stmt:    /*create table 语句的语法解析树*/
       delete $5;
     }
     ;
+storage_format:
+    /* empty */
+    {
+      $$ = nullptr;
+    }
+    | STORAGE FORMAT EQ ID  // storage format = row/varlen
+    {
+      $$ = $4;
+    }
+    ;
 attr_def_list:
     /* empty */
     {
@@ -500,7 +575,7 @@ update_stmt:      /*  update 语句的语法解析树*/
     }
     ;
 select_stmt:        /*  select 语句的语法解析树*/
-    SELECT selector FROM rel_list where order_list
+    SELECT selector FROM rel_list where order_list limit
     {
       $$ = new ParsedSqlNode(SCF_SELECT);
       if ($2 != nullptr) {
@@ -519,6 +594,10 @@ select_stmt:        /*  select 语句的语法解析树*/
         $$->selection.orders.swap(*$6);
         delete $6;
       }
+      if ($7 != nullptr) {
+        $$->selection.limit = *$7;
+        delete $7;
+      }
     }
     ;
 
@@ -637,11 +716,6 @@ order_list:
     {
       $$ = nullptr;
     }
-    | order_node
-    {
-      $$ = new std::vector<OrderSqlNode>{*$1};
-      delete $1;
-    }
     | ORDER BY order_node
     {
       $$ = new std::vector<OrderSqlNode>{*$3};
@@ -654,6 +728,41 @@ order_list:
     }
     ;
 
+/**
+ * @description: LIMIT n / LIMIT n OFFSET m / LIMIT m, n
+ * @return {LimitSqlNode*}
+ */
+limit:
+      /* empty */
+    {
+      $$ = nullptr;
+    }
+    | LIMIT NUMBER
+    {
+      $$ = create_limit($2, 0);
+      if ($$ == nullptr) {
+        yyerror(&@$, sql_string, sql_result, scanner, "limit and offset must not be negative");
+        YYERROR;
+      }
+    }
+    | LIMIT NUMBER OFFSET NUMBER
+    {
+      $$ = create_limit($2, $4);
+      if ($$ == nullptr) {
+        yyerror(&@$, sql_string, sql_result, scanner, "limit and offset must not be negative");
+        YYERROR;
+      }
+    }
+    | LIMIT NUMBER COMMA NUMBER
+    {
+      $$ = create_limit($4, $2);
+      if ($$ == nullptr) {
+        yyerror(&@$, sql_string, sql_result, scanner, "limit and offset must not be negative");
+        YYERROR;
+      }
+    }
+    ;
+
 calc_stmt:
     CALC expression_list
     {
@@ -772,6 +881,22 @@ condition:
       delete $1;
       delete $3;
     }
+    | rel_attr IN LBRACE select_stmt RBRACE
+    {
+      $$ = create_subquery_condition(IN_OP, $1, $4);
+    }
+    | rel_attr NOT IN LBRACE select_stmt RBRACE
+    {
+      $$ = create_subquery_condition(NOT_IN_OP, $1, $5);
+    }
+    | EXISTS LBRACE select_stmt RBRACE
+    {
+      $$ = create_subquery_condition(EXISTS_OP, nullptr, $3);
+    }
+    | NOT EXISTS LBRACE select_stmt RBRACE
+    {
+      $$ = create_subquery_condition(NOT_EXISTS_OP, nullptr, $4);
+    }
     ;
 
 comp_op:
@@ -4,17 +4,11 @@
 #include "sql/stmt/filter_stmt.h"
 #include "storage/table/table.h"
 
-AnalyzeStmt::AnalyzeStmt(Table *table) : table_(table) {}
-
-AnalyzeStmt::AnalyzeStmt(Table *analyze_table, Table *table, std::vector<Field *> query_fields)
-    : analyze_table_(analyze_table), table_(table), query_fields_(query_fields)
+AnalyzeStmt::AnalyzeStmt(Table *table, std::vector<Field *> query_fields) : table_(table), query_fields_(query_fields)
 {}
 
 RC AnalyzeStmt::create(Db *db, const AnalyzeSqlNode &analyze_sql, Stmt *&stmt)
 {
-  // default table name
-  const char *analyze_table_name = "relstatistics";
-
   // check the sql input
   const char *table_name = analyze_sql.relation_name.c_str();
   if (nullptr == db || nullptr == table_name) {
@@ -29,13 +23,6 @@ RC AnalyzeStmt::create(Db *db, const AnalyzeSqlNode &analyze_sql, Stmt *&stmt)
     return RC::SCHEMA_TABLE_NOT_EXIST;
   }
 
-  // check whether the table exists
-  Table *analyze_table = db->find_table(analyze_table_name);
-  if (nullptr == analyze_table) {
-    LOG_WARN("no such table. db=%s, table_name=%s", db->name(), analyze_table_name);
-    return RC::SCHEMA_TABLE_NOT_EXIST;
-  }
-
   LOG_DEBUG("TEST ANALYZE FROM STMT: ");
 
   const TableMeta         &table_meta       = table->table_meta();
@@ -43,6 +30,13 @@ RC AnalyzeStmt::create(Db *db, const AnalyzeSqlNode &analyze_sql, Stmt *&stmt)
   std::vector<std::string> sql_query_fields = analyze_sql.attribute_name;
   std::vector<Field *>     query_fields;
 
+  // 没有指定字段时分析所有的用户字段
+  if (sql_query_fields.empty()) {
+    for (int i = table_meta.sys_field_num(); i < field_num; i++) {
+      query_fields.push_back(new Field(table, table_meta.field(i)));
+    }
+  }
+
   // validate query fields
   bool is_match;
   for (std::string field_name : sql_query_fields) {
@@ -62,14 +56,12 @@ RC AnalyzeStmt::create(Db *db, const AnalyzeSqlNode &analyze_sql, Stmt *&stmt)
     }
   }
 
-  LOG_DEBUG("Got analyze table: %s",analyze_table->name());
-
   for (auto i : query_fields) {
     // print out field names
     LOG_DEBUG("Got field name: %s",i->field_name());
   }
 
-  AnalyzeStmt *analyze_stmt = new AnalyzeStmt(analyze_table, table, query_fields);
+  AnalyzeStmt *analyze_stmt = new AnalyzeStmt(table, query_fields);
   stmt                      = analyze_stmt;
   return RC::SUCCESS;
 }
\ No newline at end of file
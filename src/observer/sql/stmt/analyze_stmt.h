@@ -7,22 +7,23 @@ class Table;
 class Db;
 class Field;
 
+/**
+ * @brief ANALYZE TABLE 语句
+ * @details 没有指定字段时分析表中所有的用户字段
+ */
 class AnalyzeStmt : public Stmt
 {
 public:
-  AnalyzeStmt(Table *table);
-  AnalyzeStmt(Table *analyze_table, Table *table, std::vector<Field *> query_fields);
+  AnalyzeStmt(Table *table, std::vector<Field *> query_fields);
   AnalyzeStmt() = default;
   StmtType type() const override { return StmtType::ANALYZE; }
 
   static RC create(Db *db, const AnalyzeSqlNode &analyze_sql, Stmt *&stmt);
 
-  Table               *analyze_table() const { return analyze_table_; }
   Table               *table() const { return table_; }
   std::vector<Field *> query_fields() const { return query_fields_; }
 
 private:
-  Table               *analyze_table_ = nullptr;
-  Table               *table_         = nullptr;
+  Table               *table_ = nullptr;
   std::vector<Field *> query_fields_;
-};
\ No newline at end of file
+};
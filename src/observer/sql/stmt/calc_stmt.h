@@ -34,6 +34,7 @@ public:
   virtual ~CalcStmt() override = default;
 
   StmtType type() const override { return StmtType::CALC; }
+  bool     is_readonly() const override { return true; }
 
 public:
   static RC create(CalcSqlNode &calc_sql, Stmt *&stmt)
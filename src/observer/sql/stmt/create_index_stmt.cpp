@@ -12,6 +12,8 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai on 2023/4/25.
 //
 
+#include <strings.h>
+
 #include "sql/stmt/create_index_stmt.h"
 #include "common/lang/string.h"
 #include "common/log/log.h"
@@ -54,6 +56,19 @@ RC CreateIndexStmt::create(Db *db, const CreateIndexSqlNode &create_index, Stmt
     field_meta_list.push_back(tmp);
   }
 
+  // 索引类型，没有指定时使用B+树
+  IndexType index_type = IndexType::BPLUS_TREE;
+  if (create_index.index_type.empty() || 0 == strcasecmp(create_index.index_type.c_str(), "btree")) {
+    index_type = IndexType::BPLUS_TREE;
+  } else if (0 == strcasecmp(create_index.index_type.c_str(), "hash")) {
+    index_type = IndexType::HASH;
+  } else if (0 == strcasecmp(create_index.index_type.c_str(), "lsm")) {
+    index_type = IndexType::LSM;
+  } else {
+    LOG_WARN("unsupported index type. index=%s, type=%s", create_index.index_name.c_str(), create_index.index_type.c_str());
+    return RC::INVALID_ARGUMENT;
+  }
+
   // 查找是否已存在该索引
   Index *index = table->find_index(create_index.index_name.c_str());
   if (nullptr != index) {
@@ -62,7 +77,7 @@ RC CreateIndexStmt::create(Db *db, const CreateIndexSqlNode &create_index, Stmt
   }
 
   // create index stmt, use vector meta list
-  stmt = new CreateIndexStmt(table, field_meta_list, create_index.index_name,create_index.is_unique);
+  stmt = new CreateIndexStmt(table, field_meta_list, create_index.index_name, create_index.is_unique, index_type);
 
   // test for each item in the CreateIndexStmt
   CreateIndexStmt *createIndexStmt = new CreateIndexStmt(table, field_meta_list, create_index.index_name,create_index.is_unique);
@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 
 #include <string>
 
+#include "common/types.h"
 #include "sql/stmt/stmt.h"
 
 struct CreateIndexSqlNode;
@@ -32,9 +33,13 @@ public:
   // CreateIndexStmt(Table *table, const FieldMeta *field_meta, const std::string &index_name)
   //     : table_(table), field_meta_(field_meta), index_name_(index_name)
   // {}
-  CreateIndexStmt(
-      Table *table, std::vector<const FieldMeta *> field_meta_list, const std::string &index_name, int is_unique)
-      : table_(table), field_metas_(field_meta_list), index_name_(index_name), is_unique_(is_unique)
+  CreateIndexStmt(Table *table, std::vector<const FieldMeta *> field_meta_list, const std::string &index_name,
+      int is_unique, IndexType index_type = IndexType::BPLUS_TREE)
+      : table_(table),
+        field_metas_(field_meta_list),
+        index_name_(index_name),
+        is_unique_(is_unique),
+        index_type_(index_type)
   {}
 
   virtual ~CreateIndexStmt() = default;
@@ -46,6 +51,7 @@ public:
   const std::string             &index_name() const { return index_name_; }
   std::vector<const FieldMeta *> field_metas() { return field_metas_; }
   const int                      is_unique() { return is_unique_; };
+  IndexType                      index_type() const { return index_type_; }
 
 public:
   static RC create(Db *db, const CreateIndexSqlNode &create_index, Stmt *&stmt);
@@ -56,4 +62,5 @@ private:
   std::vector<const FieldMeta *> field_metas_;
   std::string                    index_name_;
   int                            is_unique_;
+  IndexType                      index_type_ = IndexType::BPLUS_TREE;
 };
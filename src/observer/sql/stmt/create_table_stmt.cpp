@@ -12,12 +12,27 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai on 2023/6/13.
 //
 
+#include <strings.h>
+
 #include "sql/stmt/create_table_stmt.h"
+#include "common/log/log.h"
 #include "event/sql_debug.h"
 
 RC CreateTableStmt::create(Db *db, const CreateTableSqlNode &create_table, Stmt *&stmt)
 {
-  stmt = new CreateTableStmt(create_table.relation_name, create_table.attr_infos);
+  StorageFormat storage_format = StorageFormat::ROW_FORMAT;
+  if (!create_table.storage_format.empty()) {
+    if (0 == strcasecmp(create_table.storage_format.c_str(), "row")) {
+      storage_format = StorageFormat::ROW_FORMAT;
+    } else if (0 == strcasecmp(create_table.storage_format.c_str(), "varlen")) {
+      storage_format = StorageFormat::VARLEN_FORMAT;
+    } else {
+      LOG_WARN("unknown storage format: %s", create_table.storage_format.c_str());
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+
+  stmt = new CreateTableStmt(create_table.relation_name, create_table.attr_infos, storage_format);
   sql_debug("create table statement: table name %s", create_table.relation_name.c_str());
   return RC::SUCCESS;
 }
@@ -46,6 +46,14 @@ RC DeleteStmt::create(Db *db, const DeleteSqlNode &delete_sql, Stmt *&stmt)
   std::unordered_map<std::string, Table *> table_map;
   table_map.insert(std::pair<std::string, Table *>(std::string(table_name), table));
 
+  // 子查询只在查询语句中改写成半连接，修改数据时不支持
+  for (const ConditionSqlNode &condition : delete_sql.conditions) {
+    if (condition.sub_select != nullptr) {
+      LOG_WARN("subquery is only supported in select");
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+
   FilterStmt *filter_stmt = nullptr;
   RC          rc          = FilterStmt::create(
       db, table, &table_map, delete_sql.conditions.data(), static_cast<int>(delete_sql.conditions.size()), filter_stmt);
@@ -27,6 +27,7 @@ public:
   virtual ~ExplainStmt() = default;
 
   StmtType type() const override { return StmtType::EXPLAIN; }
+  bool     is_readonly() const override { return child_stmt_ != nullptr && child_stmt_->is_readonly(); }
 
   Stmt *child() const { return child_stmt_.get(); }
 
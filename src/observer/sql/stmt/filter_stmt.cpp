@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "common/rc.h"
+#include "sql/stmt/select_stmt.h"
 #include "storage/db/db.h"
 #include "storage/table/table.h"
 
@@ -27,8 +28,17 @@ FilterStmt::~FilterStmt()
   filter_units_.clear();
 }
 
+FilterUnit::~FilterUnit()
+{
+  if (nullptr != sub_select_) {
+    delete sub_select_;
+    sub_select_ = nullptr;
+  }
+}
+
 RC FilterStmt::create(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables,
-    const ConditionSqlNode *conditions, int condition_num, FilterStmt *&stmt)
+    const ConditionSqlNode *conditions, int condition_num, FilterStmt *&stmt,
+    std::unordered_map<std::string, Table *> *parent_tables)
 {
   RC rc = RC::SUCCESS;
   stmt  = nullptr;
@@ -37,7 +47,7 @@ RC FilterStmt::create(Db *db, Table *default_table, std::unordered_map<std::stri
   for (int i = 0; i < condition_num; i++) {
     FilterUnit *filter_unit = nullptr;
 
-    rc = create_filter_unit(db, default_table, tables, conditions[i], filter_unit);
+    rc = create_filter_unit(db, default_table, tables, conditions[i], filter_unit, parent_tables);
     if (rc != RC::SUCCESS) {
       delete tmp_stmt;
       LOG_WARN("failed to create filter unit. condition index=%d", i);
@@ -51,7 +61,8 @@ RC FilterStmt::create(Db *db, Table *default_table, std::unordered_map<std::stri
 }
 
 RC get_table_and_field(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables,
-    const RelAttrSqlNode &attr, Table *&table, const FieldMeta *&field)
+    std::unordered_map<std::string, Table *> *parent_tables, const RelAttrSqlNode &attr, Table *&table,
+    const FieldMeta *&field)
 {
   if (common::is_blank(attr.relation_name.c_str())) {
     table = default_table;
@@ -59,6 +70,12 @@ RC get_table_and_field(Db *db, Table *default_table, std::unordered_map<std::str
     auto iter = tables->find(attr.relation_name);
     if (iter != tables->end()) {
       table = iter->second;
+    } else if (nullptr != parent_tables) {
+      // 相关子查询引用外层查询的表
+      iter = parent_tables->find(attr.relation_name);
+      if (iter != parent_tables->end()) {
+        table = iter->second;
+      }
     }
   } else {
     table = db->find_table(attr.relation_name.c_str());
@@ -79,7 +96,8 @@ RC get_table_and_field(Db *db, Table *default_table, std::unordered_map<std::str
 }
 
 RC FilterStmt::create_filter_unit(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables,
-    const ConditionSqlNode &condition, FilterUnit *&filter_unit)
+    const ConditionSqlNode &condition, FilterUnit *&filter_unit,
+    std::unordered_map<std::string, Table *> *parent_tables)
 {
   RC rc = RC::SUCCESS;
 
@@ -89,13 +107,17 @@ RC FilterStmt::create_filter_unit(Db *db, Table *default_table, std::unordered_m
     return RC::INVALID_ARGUMENT;
   }
 
+  if (condition.sub_select) {
+    return create_subquery_filter_unit(db, default_table, tables, condition, filter_unit);
+  }
+
   filter_unit = new FilterUnit;
   AttrType left_type, right_type;
 
   if (condition.left_is_attr) {
     Table           *table = nullptr;
     const FieldMeta *field = nullptr;
-    rc                     = get_table_and_field(db, default_table, tables, condition.left_attr, table, field);
+    rc = get_table_and_field(db, default_table, tables, parent_tables, condition.left_attr, table, field);
     if (rc != RC::SUCCESS) {
       LOG_WARN("cannot find attr");
       return rc;
@@ -113,7 +135,7 @@ RC FilterStmt::create_filter_unit(Db *db, Table *default_table, std::unordered_m
   if (condition.right_is_attr) {
     Table           *table = nullptr;
     const FieldMeta *field = nullptr;
-    rc                     = get_table_and_field(db, default_table, tables, condition.right_attr, table, field);
+    rc = get_table_and_field(db, default_table, tables, parent_tables, condition.right_attr, table, field);
     if (rc != RC::SUCCESS) {
       LOG_WARN("cannot find attr");
       return rc;
@@ -152,3 +174,67 @@ RC FilterStmt::create_filter_unit(Db *db, Table *default_table, std::unordered_m
   // 检查两个类型是否能够比较
   return rc;
 }
+
+RC FilterStmt::create_subquery_filter_unit(Db *db, Table *default_table,
+    std::unordered_map<std::string, Table *> *tables, const ConditionSqlNode &condition, FilterUnit *&filter_unit)
+{
+  // 子查询只能引用直接外层查询的表
+  Stmt *stmt = nullptr;
+  RC    rc   = SelectStmt::create(db, *condition.sub_select, stmt, tables);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to create subquery. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  std::unique_ptr<SelectStmt> sub_select(static_cast<SelectStmt *>(stmt));
+  if (sub_select->tables().empty()) {
+    LOG_WARN("subquery without table is not supported");
+    return RC::INVALID_ARGUMENT;
+  }
+
+  // 聚合是在输出结果时计算的，子查询中没有办法计算
+  for (const Field &field : sub_select->query_fields()) {
+    if (field.aggre_type() != AGGRE_NONE) {
+      LOG_WARN("aggregation in subquery is not supported");
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+
+  // 改写成半连接之后子查询的所有行都参与连接，LIMIT 没有办法保留
+  if (sub_select->limit() >= 0) {
+    LOG_WARN("limit in subquery is not supported");
+    return RC::INVALID_ARGUMENT;
+  }
+
+  FilterObj left_obj;
+  if (condition.comp == IN_OP || condition.comp == NOT_IN_OP) {
+    if (sub_select->query_fields().size() != 1) {
+      LOG_WARN("subquery of IN should select exactly one field. fields=%d",
+               static_cast<int>(sub_select->query_fields().size()));
+      return RC::INVALID_ARGUMENT;
+    }
+
+    // IN 的左边只能是本层查询的字段，改写成半连接之后才能在连接的左边计算
+    Table           *table = nullptr;
+    const FieldMeta *field = nullptr;
+    rc = get_table_and_field(db, default_table, tables, nullptr, condition.left_attr, table, field);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("cannot find attr");
+      return rc;
+    }
+
+    const Field &sub_field = sub_select->query_fields().front();
+    if (field->type() != sub_field.attr_type()) {
+      LOG_WARN("type mismatch between IN field and subquery field. field=%s.%s, subquery field=%s.%s",
+               table->name(), field->name(), sub_field.table_name(), sub_field.field_name());
+      return RC::SCHEMA_FIELD_TYPE_MISMATCH;
+    }
+    left_obj.init_attr(Field(table, field));
+  }
+
+  filter_unit = new FilterUnit;
+  filter_unit->set_comp(condition.comp);
+  filter_unit->set_left(left_obj);
+  filter_unit->set_sub_select(sub_select.release());
+  return rc;
+}
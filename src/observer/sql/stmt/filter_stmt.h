@@ -23,10 +23,11 @@ See the Mulan PSL v2 for more details. */
 class Db;
 class Table;
 class FieldMeta;
+class SelectStmt;
 
 struct FilterObj
 {
-  bool  is_attr;
+  bool  is_attr = false;
   Field field;
   Value value;
 
@@ -43,11 +44,15 @@ struct FilterObj
   }
 };
 
+/**
+ * @brief 一个过滤条件
+ * @details IN/NOT IN 子查询的左边是字段，右边没有用到；EXISTS/NOT EXISTS 只有子查询
+ */
 class FilterUnit
 {
 public:
   FilterUnit() = default;
-  ~FilterUnit() {}
+  ~FilterUnit();
 
   void set_comp(CompOp comp) { comp_ = comp; }
 
@@ -59,10 +64,14 @@ public:
   const FilterObj &left() const { return left_; }
   const FilterObj &right() const { return right_; }
 
+  void        set_sub_select(SelectStmt *sub_select) { sub_select_ = sub_select; }
+  SelectStmt *sub_select() const { return sub_select_; }
+
 private:
-  CompOp    comp_ = NO_OP;
-  FilterObj left_;
-  FilterObj right_;
+  CompOp      comp_ = NO_OP;
+  FilterObj   left_;
+  FilterObj   right_;
+  SelectStmt *sub_select_ = nullptr;  ///< 子查询，由 FilterUnit 释放
 };
 
 /**
@@ -79,10 +88,19 @@ public:
   const std::vector<FilterUnit *> &filter_units() const { return filter_units_; }
 
 public:
+  /**
+   * @param parent_tables 子查询中使用，外层查询的表。条件中的字段在 tables 中找不到时再到这里找(相关子查询)
+   */
   static RC create(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables,
-      const ConditionSqlNode *conditions, int condition_num, FilterStmt *&stmt);
+      const ConditionSqlNode *conditions, int condition_num, FilterStmt *&stmt,
+      std::unordered_map<std::string, Table *> *parent_tables = nullptr);
 
   static RC create_filter_unit(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables,
+      const ConditionSqlNode &condition, FilterUnit *&filter_unit,
+      std::unordered_map<std::string, Table *> *parent_tables = nullptr);
+
+private:
+  static RC create_subquery_filter_unit(Db *db, Table *default_table, std::unordered_map<std::string, Table *> *tables,
       const ConditionSqlNode &condition, FilterUnit *&filter_unit);
 
 private:
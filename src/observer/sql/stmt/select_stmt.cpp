@@ -135,7 +135,8 @@ static RC get_fields(bool is_aggre, std::vector<Field> &query_fields, const std:
   return RC::SUCCESS;
 }
 
-RC SelectStmt::create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt)
+RC SelectStmt::create(
+    Db *db, const SelectSqlNode &select_sql, Stmt *&stmt, std::unordered_map<std::string, Table *> *parent_tables)
 {
   // 主要修改部分——主要修改select的实现逻辑
   // new select stmt with the implementation of aggregation function
@@ -182,6 +183,16 @@ RC SelectStmt::create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt)
     return RC::INTERNAL;
   }
 
+  // 聚合是在输出结果时计算的，只有一行结果。不跳过这一行的 LIMIT 没有作用，跳过的暂不支持
+  LimitSqlNode limit = select_sql.limit;
+  if (aggregation_num != 0 && limit.limit >= 0) {
+    if (limit.limit == 0 || limit.offset > 0) {
+      LOG_WARN("limit with aggregation is not supported. limit=%d, offset=%d", limit.limit, limit.offset);
+      return RC::INVALID_ARGUMENT;
+    }
+    limit = LimitSqlNode();
+  }
+
   // get the fields (table_meta, (table_name, col_name))
   // 全部的关键信息都被存储到query_fields中，包括对每个字段上是否进行agg，进行何种agg，都存储起来，并准备下一步操作
   std::vector<Field> query_fields;
@@ -206,7 +217,8 @@ RC SelectStmt::create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt)
       &table_map,
       select_sql.conditions.data(),
       static_cast<int>(select_sql.conditions.size()),
-      filter_stmt);
+      filter_stmt,
+      parent_tables);
   if (rc != RC::SUCCESS) {
     LOG_WARN("cannot construct filter stmt");
     return rc;
@@ -229,6 +241,8 @@ RC SelectStmt::create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt)
   select_stmt->query_fields_.swap(query_fields);
   select_stmt->filter_stmt_ = filter_stmt;
   select_stmt->order_stmt_  = orderby_stmt;
+  select_stmt->limit_       = limit.limit;
+  select_stmt->offset_      = limit.offset;
   stmt                      = select_stmt;
   return RC::SUCCESS;
 }
@@ -15,6 +15,8 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "common/rc.h"
@@ -39,9 +41,14 @@ public:
   ~SelectStmt() override;
 
   StmtType type() const override { return StmtType::SELECT; }
+  bool     is_readonly() const override { return true; }
 
 public:
-  static RC create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt);
+  /**
+   * @param parent_tables 创建子查询时是外层查询的表，子查询的条件可以引用它们
+   */
+  static RC create(Db *db, const SelectSqlNode &select_sql, Stmt *&stmt,
+      std::unordered_map<std::string, Table *> *parent_tables = nullptr);
 
 public:
   const std::vector<Table *> &tables() const { return tables_; }
@@ -49,9 +56,17 @@ public:
   FilterStmt                 *filter_stmt() const { return filter_stmt_; }
   OrderByStmt                *order_by_stmt() const { return order_stmt_; }
 
+  /**
+   * @brief LIMIT 的行数，-1 表示没有 LIMIT
+   */
+  int limit() const { return limit_; }
+  int offset() const { return offset_; }
+
 private:
   std::vector<Field>   query_fields_;
   std::vector<Table *> tables_;
   FilterStmt          *filter_stmt_ = nullptr;
   OrderByStmt         *order_stmt_  = nullptr;
+  int                  limit_       = -1;
+  int                  offset_      = 0;
 };
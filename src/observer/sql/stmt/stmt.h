@@ -86,6 +86,12 @@ public:
 
   virtual StmtType type() const = 0;
 
+  /**
+   * @brief 语句是否只读
+   * @details 只读语句在自动提交模式下可以使用只读快照事务执行，不分配事务号也不写日志
+   */
+  virtual bool is_readonly() const { return false; }
+
 public:
   static RC create_stmt(Db *db, ParsedSqlNode &sql_node, Stmt *&stmt);
 
@@ -75,6 +75,15 @@ RC UpdateStmt::create(Db *db, const UpdateSqlNode &update, Stmt *&stmt)
   // 创建filter
   std::unordered_map<std::string, Table *> table_map;
   table_map.insert(std::pair<std::string, Table *>(std::string(table_name), table));
+
+  // 子查询只在查询语句中改写成半连接，修改数据时不支持
+  for (const ConditionSqlNode &condition : update.conditions) {
+    if (condition.sub_select != nullptr) {
+      LOG_WARN("subquery is only supported in select");
+      return RC::INVALID_ARGUMENT;
+    }
+  }
+
   FilterStmt *filter_stmt = nullptr;
 
   RC rc = FilterStmt::create(
@@ -11,8 +11,12 @@ See the Mulan PSL v2 for more details. */
 //
 // Created by Meiyi & Longda on 2021/4/13.
 //
+#include <algorithm>
+#include <chrono>
 #include <errno.h>
+#include <fcntl.h>
 #include <string.h>
+#include <thread>
 
 #include "common/io/io.h"
 #include "common/lang/mutex.h"
@@ -24,6 +28,9 @@ using namespace std;
 
 static const int MEM_POOL_ITEM_NUM = 20;
 
+/// 释放页面时等待其它线程 unpin 的最长时间，参考 DiskBufferPool::dispose_page
+static const chrono::seconds DISPOSE_PAGE_WAIT_TIMEOUT{10};
+
 ////////////////////////////////////////////////////////////////////////////////
 
 string BPFileHeader::to_string() const
@@ -105,6 +112,13 @@ Frame *BPFrameManager::get(int file_desc, PageNum page_num)
   return get_internal(frame_id);
 }
 
+bool BPFrameManager::contains(int file_desc, PageNum page_num)
+{
+  FrameId                     frame_id(file_desc, page_num);
+  std::lock_guard<std::mutex> lock_guard(lock_);
+  return frames_.contains(frame_id);
+}
+
 Frame *BPFrameManager::get_internal(const FrameId &frame_id)
 {
   Frame *frame = nullptr;
@@ -144,6 +158,17 @@ RC BPFrameManager::free(int file_desc, PageNum page_num, Frame *frame)
   return free_internal(frame_id, frame);
 }
 
+RC BPFrameManager::try_free(int file_desc, PageNum page_num, Frame *frame)
+{
+  FrameId frame_id(file_desc, page_num);
+
+  std::lock_guard<std::mutex> lock_guard(lock_);
+  if (frame->pin_count() != 1) {
+    return RC::LOCKED_UNLOCK;
+  }
+  return free_internal(frame_id, frame);
+}
+
 RC BPFrameManager::free_internal(const FrameId &frame_id, Frame *frame)
 {
   Frame                *frame_source = nullptr;
@@ -248,6 +273,7 @@ RC DiskBufferPool::open_file(const char *file_name)
     return rc;
   }
 
+  hdr_frame_->set_loaded();
   file_header_ = (BPFileHeader *)hdr_frame_->data();
 
   LOG_INFO("Successfully open %s. file_desc=%d, hdr_frame=%p, file header=%s",
@@ -290,7 +316,7 @@ RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame)
   *frame = nullptr;
 
   Frame *used_match_frame = frame_manager_.get(file_desc_, page_num);
-  if (used_match_frame != nullptr) {
+  if (used_match_frame != nullptr && used_match_frame->loaded()) {
     used_match_frame->access();
     *frame = used_match_frame;
     return RC::SUCCESS;
@@ -298,6 +324,22 @@ RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame)
 
   std::scoped_lock lock_guard(lock_);  // 直接加了一把大锁，其实可以根据访问的页面来细化提高并行度
 
+  // 页面都是加着锁加载的，拿到锁之后其它线程的加载已经结束了。
+  // 这里必须重新查找一次，否则会再从磁盘读一遍，覆盖掉别的线程已经做的修改
+  if (used_match_frame == nullptr) {
+    used_match_frame = frame_manager_.get(file_desc_, page_num);
+  }
+  if (used_match_frame != nullptr) {
+    if (!used_match_frame->loaded()) {
+      LOG_WARN("failed to get page that failed to load. file=%s, page num=%d", file_name_.c_str(), page_num);
+      used_match_frame->unpin();
+      return RC::IOERR_READ;
+    }
+    used_match_frame->access();
+    *frame = used_match_frame;
+    return RC::SUCCESS;
+  }
+
   // Allocate one page and load the data into this page
   Frame *allocated_frame = nullptr;
   rc                     = allocate_frame(page_num, &allocated_frame);
@@ -316,10 +358,40 @@ RC DiskBufferPool::get_this_page(PageNum page_num, Frame **frame)
     return rc;
   }
 
+  allocated_frame->set_loaded();
   *frame = allocated_frame;
   return RC::SUCCESS;
 }
 
+void DiskBufferPool::prefetch_pages(std::vector<PageNum> page_nums)
+{
+  // 没有加锁读取文件头，最多是多预读或者少预读几个页面，不影响正确性
+  auto skip = [this](PageNum page_num) {
+    return page_num < 0 || page_num >= file_header_->page_count ||
+           (file_header_->bitmap[page_num / 8] & (1 << (page_num % 8))) == 0 ||
+           frame_manager_.contains(file_desc_, page_num);
+  };
+  page_nums.erase(std::remove_if(page_nums.begin(), page_nums.end(), skip), page_nums.end());
+  std::sort(page_nums.begin(), page_nums.end());
+  page_nums.erase(std::unique(page_nums.begin(), page_nums.end()), page_nums.end());
+
+  for (size_t begin = 0; begin < page_nums.size();) {
+    size_t end = begin + 1;
+    while (end < page_nums.size() && page_nums[end] == page_nums[end - 1] + 1) {
+      end++;
+    }
+
+    const off_t offset = static_cast<off_t>(page_nums[begin]) * BP_PAGE_SIZE;
+    const off_t length = static_cast<off_t>(end - begin) * BP_PAGE_SIZE;
+    int         ret    = posix_fadvise(file_desc_, offset, length, POSIX_FADV_WILLNEED);
+    if (ret != 0) {
+      LOG_TRACE("failed to prefetch pages. file=%s, page num=%d, count=%d, error=%s",
+          file_name_.c_str(), page_nums[begin], static_cast<int>(end - begin), strerror(ret));
+    }
+    begin = end;
+  }
+}
+
 RC DiskBufferPool::allocate_page(Frame **frame)
 {
   RC rc = RC::SUCCESS;
@@ -374,6 +446,7 @@ RC DiskBufferPool::allocate_page(Frame **frame)
   allocated_frame->access();
   allocated_frame->clear_page();
   allocated_frame->set_page_num(file_header_->page_count - 1);
+  allocated_frame->set_loaded();
 
   // Use flush operation to extension file
   if ((rc = flush_page_internal(*allocated_frame)) != RC::SUCCESS) {
@@ -390,16 +463,37 @@ RC DiskBufferPool::allocate_page(Frame **frame)
 
 RC DiskBufferPool::dispose_page(PageNum page_num)
 {
-  std::scoped_lock lock_guard(lock_);
-  Frame           *used_frame = frame_manager_.get(file_desc_, page_num);
-  if (used_frame != nullptr) {
-    ASSERT("the page try to dispose is in use. frame:%s", to_string(*used_frame).c_str());
-    frame_manager_.free(file_desc_, page_num, used_frame);
-  } else {
-    LOG_WARN("failed to fetch the page while disposing it. pageNum=%d", page_num);
-    return RC::NOTFOUND;
+  // 乐观读(参考 Frame::version)不加页面锁，释放页面时可能还有读者pin着这个页面，需要等它们释放。
+  // 乐观读的读者不会等待任何锁，所以很快就会释放。等待时不能拿着 lock_，读者加载其它页面时也需要这个锁。
+  // 长时间等不到说明有人忘了 unpin，这时放弃释放，页面在位图中依然是已分配的，只是再也不会被使用
+  const auto deadline = std::chrono::steady_clock::now() + DISPOSE_PAGE_WAIT_TIMEOUT;
+  for (int retry_count = 0;; retry_count++) {
+    Frame *used_frame = frame_manager_.get(file_desc_, page_num);
+    if (used_frame == nullptr) {
+      LOG_WARN("failed to fetch the page while disposing it. pageNum=%d", page_num);
+      return RC::NOTFOUND;
+    }
+
+    if (frame_manager_.try_free(file_desc_, page_num, used_frame) == RC::SUCCESS) {
+      break;
+    }
+
+    const int pin_count = used_frame->unpin();
+    if (std::chrono::steady_clock::now() >= deadline) {
+      LOG_WARN("failed to dispose page in use. file=%s, page num=%d, pin count=%d",
+               file_name_.c_str(), page_num, pin_count);
+      return RC::LOCKED_CONCURRENCY_CONFLICT;
+    }
+
+    if (retry_count < 64) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
   }
 
+  std::scoped_lock lock_guard(lock_);
+
   hdr_frame_->mark_dirty();
   file_header_->allocated_pages--;
   char tmp = 1 << (page_num % 8);
@@ -507,15 +601,19 @@ RC DiskBufferPool::flush_page_internal(Frame &frame)
 
 RC DiskBufferPool::flush_all_pages()
 {
+  // find_list 会 pin 住返回的每个页面，刷完之后要释放，否则这些页面再也无法淘汰或释放
   std::list<Frame *> used = frame_manager_.find_list(file_desc_);
+  RC                 rc   = RC::SUCCESS;
   for (Frame *frame : used) {
-    RC rc = flush_page(*frame);
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to flush all pages");
-      return rc;
+    if (rc == RC::SUCCESS) {
+      rc = flush_page(*frame);
+      if (rc != RC::SUCCESS) {
+        LOG_WARN("failed to flush all pages");
+      }
     }
+    frame->unpin();
   }
-  return RC::SUCCESS;
+  return rc;
 }
 
 RC DiskBufferPool::recover_page(PageNum page_num)
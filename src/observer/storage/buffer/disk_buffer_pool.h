@@ -24,6 +24,7 @@ See the Mulan PSL v2 for more details. */
 #include <sys/types.h>
 #include <time.h>
 #include <unordered_map>
+#include <vector>
 
 #include "common/lang/bitmap.h"
 #include "common/lang/lru_cache.h"
@@ -94,6 +95,11 @@ public:
    */
   Frame *get(int file_desc, PageNum page_num);
 
+  /**
+   * @brief 页面是否已经在内存中。不会pin住页面，也不影响淘汰顺序
+   */
+  bool contains(int file_desc, PageNum page_num);
+
   /**
    * @brief 列出所有指定文件的页面
    *
@@ -117,6 +123,12 @@ public:
    */
   RC free(int file_desc, PageNum page_num, Frame *frame);
 
+  /**
+   * @brief 与free类似，但是只有调用者是唯一pin住这个页帧的人时才会释放
+   * @return 其它人也pin着这个页帧时返回 RC::LOCKED_UNLOCK，页帧保持原样
+   */
+  RC try_free(int file_desc, PageNum page_num, Frame *frame);
+
   /**
    * 如果不能从空闲链表中分配新的页面，就使用这个接口，
    * 尝试从pin count=0的页面中淘汰一些
@@ -217,6 +229,8 @@ public:
 
   /**
    * @brief 释放某个页面，将此页面设置为未分配状态
+   * @details 页面可能还被乐观读的读者 pin 着，会等待它们释放。等待超时返回 LOCKED_CONCURRENCY_CONFLICT，
+   * 页面保持已分配状态。
    *
    * @param page_num 待释放的页面
    */
@@ -238,6 +252,13 @@ public:
    */
   RC unpin_page(Frame *frame);
 
+  /**
+   * @brief 提示即将访问这些页面，让操作系统在后台提前读取
+   * @details 只是一个提示，不会等待读取完成，也不会占用缓冲池的页帧。已经在缓冲池中的页面和无效的页面
+   * 会被跳过，剩下的页面按照页号排序后合并成连续的区间再发起预读。
+   */
+  void prefetch_pages(std::vector<PageNum> page_nums);
+
   /**
    * 检查是否所有页面都是pin count == 0状态(除了第1个页面)
    * 调试使用
@@ -246,6 +267,11 @@ public:
 
   int file_desc() const;
 
+  /**
+   * 已经分配的页面个数，包括第0个页面(文件头)
+   */
+  int32_t allocated_pages() const { return file_header_->allocated_pages; }
+
   /**
    * 如果页面是脏的，就将数据刷新到磁盘
    */
@@ -59,6 +59,16 @@ intptr_t get_default_debug_xid()
   }
 }
 
+void Frame::reinit()
+{
+  // 页帧会被复用来存放别的页面，每次分配时都换一个新的版本号区间，
+  // 避免乐观读的读者在页面换出又换入之后，碰巧看到与之前相同的版本号
+  static std::atomic<uint64_t> next_version_base{0};
+  version_.store(next_version_base.fetch_add(uint64_t(1) << 32), std::memory_order_relaxed);
+  write_depth_ = 0;
+  loaded_.store(false, std::memory_order_relaxed);
+}
+
 void Frame::write_latch() { write_latch(get_default_debug_xid()); }
 
 void Frame::write_latch(intptr_t xid)
@@ -78,6 +88,10 @@ void Frame::write_latch(intptr_t xid)
   }
 
   lock_.lock();
+  if (write_depth_++ == 0) {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
 
 #ifdef DEBUG
   write_locker_ = xid;
@@ -113,6 +127,9 @@ void Frame::write_unlatch(intptr_t xid)
   }
   debug_lock_.unlock();
 
+  if (--write_depth_ == 0) {
+    version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
   lock_.unlock();
 }
 
@@ -72,7 +72,7 @@ public:
    * @details 在 MemPoolSimple 分配和释放一个Frame对象时，不会调用构造函数和析构函数，
    * 而是调用reinit和reset。
    */
-  void reinit() {}
+  void reinit();
   void reset() {}
 
   void clear_page() { memset(&page_, 0, sizeof(page_)); }
@@ -99,6 +99,14 @@ public:
 
   char *data() { return page_.data; }
 
+  /**
+   * @brief 页面数据是否已经准备好
+   * @details 页帧在从磁盘加载数据之前就已经放到 frame manager 中了，其它线程可能会拿到还没有加载完成的页帧。
+   * 加载页面的线程持有 DiskBufferPool 的锁，拿到未就绪页帧的线程需要等这把锁释放后再使用。
+   */
+  bool loaded() const { return loaded_.load(std::memory_order_acquire); }
+  void set_loaded() { loaded_.store(true, std::memory_order_release); }
+
   bool can_purge() { return pin_count_.load() == 0; }
 
   /**
@@ -127,6 +135,19 @@ public:
   void read_unlatch();
   void read_unlatch(intptr_t xid);
 
+  /**
+   * @brief 页面的版本号，用于乐观读
+   * @details 每次加写锁和释放写锁时都会加1，所以持有写锁期间版本号是奇数。
+   * 乐观读不加读锁，读之前记下版本号(必须是偶数)，读完之后调用 validate_version 检查版本号没有变化，
+   * 就说明读到的内容是一致的，否则需要重新读取。可以参考 BplusTreeHandler 的查找和扫描。
+   */
+  uint64_t version() const { return version_.load(std::memory_order_acquire); }
+  bool     validate_version(uint64_t version) const
+  {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+
   friend std::string to_string(const Frame &frame);
 
 private:
@@ -141,6 +162,10 @@ private:
   /// 在非并发编译时，加锁解锁动作将什么都不做
   common::RecursiveSharedMutex lock_;
 
+  std::atomic<uint64_t> version_{0};       ///< 参考 version()
+  std::atomic<bool>     loaded_{false};    ///< 参考 loaded()
+  int                   write_depth_ = 0;  ///< 写锁的重入次数，只有持有写锁的线程会访问
+
   /// 使用一些手段来做测试，提前检测出头疼的死锁问题
   /// 如果编译时没有增加调试选项，这些代码什么都不做
   common::DebugMutex                debug_lock_;
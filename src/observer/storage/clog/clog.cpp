@@ -12,6 +12,7 @@ See the Mulan PSL v2 for more details. */
 // Created by huhaosheng.hhs on 2022
 //
 
+#include <chrono>
 #include <sstream>
 #include <vector>
 
@@ -196,7 +197,7 @@ RC CLogBuffer::append_log_record(CLogRecord *log_record)
     return RC::LOGBUF_FULL;
   }
 
-  lock_guard<Mutex> lock_guard(lock_);
+  lock_guard<mutex> lock_guard(lock_);
   log_records_.emplace_back(log_record);
   total_size_ += log_record->logrec_len();
   LOG_DEBUG("append log. log_record={%s}", log_record->to_string().c_str());
@@ -207,11 +208,11 @@ RC CLogBuffer::flush_buffer(CLogFile &log_file)
 {
   RC  rc    = RC::SUCCESS;
   int count = 0;
-  while (!log_records_.empty()) {
+  while (true) {
     lock_.lock();
     if (log_records_.empty()) {
       lock_.unlock();
-      return RC::SUCCESS;
+      break;
     }
 
     // log buffer 需要支持并发，所以要考虑加锁
@@ -410,6 +411,13 @@ RC CLogManager::init(const char *path)
 
 CLogManager::~CLogManager()
 {
+  stop_log_writer();
+
+  if (log_buffer_ != nullptr && log_file_ != nullptr) {
+    // 异步提交的日志可能还在缓存中，退出前刷到磁盘
+    sync();
+  }
+
   if (log_buffer_) {
     delete log_buffer_;
     log_buffer_ = nullptr;
@@ -437,7 +445,7 @@ RC CLogManager::begin_trx(int32_t trx_id)
   return append_log(CLogRecord::build_mtr_record(CLogType::MTR_BEGIN, trx_id));
 }
 
-RC CLogManager::commit_trx(int32_t trx_id, int32_t commit_xid)
+RC CLogManager::commit_trx(int32_t trx_id, int32_t commit_xid, bool async)
 {
   RC rc = append_log(CLogRecord::build_commit_record(trx_id, commit_xid));
   if (rc != RC::SUCCESS) {
@@ -445,8 +453,18 @@ RC CLogManager::commit_trx(int32_t trx_id, int32_t commit_xid)
     return rc;
   }
 
-  rc = sync();  // 事务提交时需要把当前事务关联的日志，都写入到磁盘中，这样做是保证不丢数据
-  return rc;
+  if (!async) {
+    rc = sync();  // 事务提交时需要把当前事务关联的日志，都写入到磁盘中，这样做是保证不丢数据
+    return rc;
+  }
+
+  // 异步提交：日志留在缓存中，由后台线程在 flush_interval_ms 内刷盘
+  start_log_writer();
+  unflushed_async_commits_++;
+  if (log_buffer_->total_size() >= flush_size_.load()) {
+    writer_cv_.notify_one();
+  }
+  return RC::SUCCESS;
 }
 
 RC CLogManager::rollback_trx(int32_t trx_id)
@@ -459,10 +477,113 @@ RC CLogManager::append_log(CLogRecord *log_record)
   if (nullptr == log_record) {
     return RC::INVALID_ARGUMENT;
   }
-  return log_buffer_->append_log_record(log_record);
+
+  RC rc = log_buffer_->append_log_record(log_record);
+  if (rc == RC::LOGBUF_FULL) {
+    // 异步提交时缓存可能会被写满，先把缓存刷到磁盘再重试
+    rc = sync();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to sync log buffer while it is full. rc=%s", strrc(rc));
+      delete log_record;
+      return rc;
+    }
+    rc = log_buffer_->append_log_record(log_record);
+  }
+
+  if (OB_FAIL(rc)) {
+    delete log_record;
+  }
+  return rc;
+}
+
+RC CLogManager::sync()
+{
+  lock_guard<mutex> guard(flush_lock_);
+
+  // 在刷盘之前已经计数的异步提交，它们的日志一定已经在缓存中了，这次刷盘之后就持久化了
+  int async_commits = unflushed_async_commits_.load();
+  RC  rc            = log_buffer_->flush_buffer(*log_file_);
+  if (OB_SUCC(rc)) {
+    unflushed_async_commits_ -= async_commits;
+  }
+  return rc;
 }
 
-RC CLogManager::sync() { return log_buffer_->flush_buffer(*log_file_); }
+RC CLogManager::set_flush_interval_ms(int interval_ms)
+{
+  if (interval_ms <= 0) {
+    LOG_WARN("invalid clog flush interval. interval=%d", interval_ms);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  flush_interval_ms_ = interval_ms;
+  writer_cv_.notify_one();
+  LOG_INFO("set clog flush interval to %dms", interval_ms);
+  return RC::SUCCESS;
+}
+
+RC CLogManager::set_flush_size(int size)
+{
+  if (size <= 0) {
+    LOG_WARN("invalid clog flush size. size=%d", size);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  flush_size_ = size;
+  writer_cv_.notify_one();
+  LOG_INFO("set clog flush size to %d", size);
+  return RC::SUCCESS;
+}
+
+void CLogManager::start_log_writer()
+{
+  lock_guard<mutex> guard(writer_lock_);
+  if (writer_thread_ != nullptr || writer_stop_) {
+    return;
+  }
+
+  writer_thread_ = new thread(&CLogManager::log_writer_routine, this);
+  LOG_INFO("clog writer thread started. flush interval=%dms, flush size=%d", flush_interval_ms(), flush_size());
+}
+
+void CLogManager::stop_log_writer()
+{
+  thread *writer_thread = nullptr;
+  {
+    lock_guard<mutex> guard(writer_lock_);
+    writer_stop_   = true;
+    writer_thread  = writer_thread_;
+    writer_thread_ = nullptr;
+  }
+
+  if (writer_thread != nullptr) {
+    writer_cv_.notify_all();
+    writer_thread->join();
+    delete writer_thread;
+    LOG_INFO("clog writer thread stopped");
+  }
+}
+
+void CLogManager::log_writer_routine()
+{
+  unique_lock<mutex> lock(writer_lock_);
+  while (!writer_stop_) {
+    writer_cv_.wait_for(lock, chrono::milliseconds(flush_interval_ms_.load()), [this]() {
+      return writer_stop_ || log_buffer_->total_size() >= flush_size_.load();
+    });
+
+    if (unflushed_async_commits_.load() <= 0 && log_buffer_->total_size() < flush_size_.load()) {
+      continue;
+    }
+
+    lock.unlock();
+    RC rc = sync();
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("clog writer thread failed to sync log. rc=%s", strrc(rc));
+    }
+    lock.lock();
+  }
+}
 
 RC CLogManager::recover(Db *db)
 {
@@ -15,12 +15,15 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <stddef.h>
 #include <stdint.h>
 #include <string>
+#include <thread>
 #include <unordered_map>
 
 #include "common/lang/mutex.h"
@@ -242,6 +245,11 @@ public:
    */
   RC flush_buffer(CLogFile &log_file);
 
+  /**
+   * @brief 当前缓存中的日志记录的总大小(不包含日志头)
+   */
+  int32_t total_size() const { return total_size_.load(); }
+
 private:
   /**
    * @brief 将日志记录写入到日志文件中
@@ -252,9 +260,10 @@ private:
   RC write_log_record(CLogFile &log_file, CLogRecord *log_record);
 
 private:
-  common::Mutex                           lock_;         ///< 加锁支持多线程并发写入
-  std::deque<std::unique_ptr<CLogRecord>> log_records_;  ///< 当前等待刷数据的日志记录
-  std::atomic_int32_t                     total_size_;   ///< 当前缓存中的日志记录的总大小
+  /// 加锁支持多线程并发写入。异步提交时后台线程也会刷日志，所以这里不论是否开启CONCURRENCY都需要真正的锁
+  std::mutex                              lock_;
+  std::deque<std::unique_ptr<CLogRecord>> log_records_;    ///< 当前等待刷数据的日志记录
+  std::atomic_int32_t                     total_size_{0};  ///< 当前缓存中的日志记录的总大小
 };
 
 /**
@@ -341,9 +350,21 @@ private:
  * @ingroup CLog
  * @details 一个日志管理器属于某一个DB（当前仅有一个DB sys）。
  * 管理器负责写日志（运行时）、读日志与恢复（启动时）
+ *
+ * 事务提交有两种方式：
+ * - 同步提交(默认)：提交日志写入缓存后立即刷盘(fsync)，提交返回时日志已经持久化；
+ * - 异步提交：提交日志写入缓存后直接返回，由后台的日志写线程刷盘。后台线程在有未刷盘的
+ *   异步提交时，最多等待 flush_interval_ms 就会刷一次盘；缓存的日志超过 flush_size 字节时
+ *   会被立即唤醒。因此进程崩溃时，最多丢失最近 flush_interval_ms 加上一次刷盘耗时内异步提交
+ *   的事务，这些事务在恢复时会被当做未提交的事务回滚，不会出现部分提交的情况。
+ *   任何一次同步提交都会把之前缓存的所有日志一起刷盘。
  */
 class CLogManager
 {
+public:
+  static constexpr int DEFAULT_FLUSH_INTERVAL_MS = 100;          ///< 异步提交时后台刷盘的默认间隔
+  static constexpr int DEFAULT_FLUSH_SIZE        = 1024 * 1024;  ///< 异步提交时触发刷盘的默认缓存大小
+
 public:
   CLogManager() = default;
   ~CLogManager();
@@ -373,8 +394,9 @@ public:
    *
    * @param trx_id 事务编号
    * @param commit_xid 事务提交时使用的编号
+   * @param async 是否异步提交。异步提交时日志放到缓存中就返回，由后台线程负责刷盘
    */
-  RC commit_trx(int32_t trx_id, int32_t commit_xid);
+  RC commit_trx(int32_t trx_id, int32_t commit_xid, bool async = false);
 
   /**
    * @brief 回滚一个事务
@@ -400,7 +422,42 @@ public:
    */
   RC recover(Db *db);
 
+  /**
+   * @brief 设置异步提交时后台线程刷盘的最大间隔，也就是异步提交最多可能丢失的时间窗口
+   */
+  RC  set_flush_interval_ms(int interval_ms);
+  int flush_interval_ms() const { return flush_interval_ms_.load(); }
+
+  /**
+   * @brief 设置异步提交时触发后台线程立即刷盘的缓存大小
+   */
+  RC  set_flush_size(int size);
+  int flush_size() const { return flush_size_.load(); }
+
+private:
+  /**
+   * @brief 启动后台日志写线程。只在第一次异步提交时启动
+   */
+  void start_log_writer();
+  void stop_log_writer();
+
+  /**
+   * @brief 后台日志写线程，按照时间间隔或缓存大小把异步提交的日志刷盘
+   */
+  void log_writer_routine();
+
 private:
   CLogBuffer *log_buffer_ = nullptr;  ///< 日志缓存。新增日志时先放到内存，也就是这个buffer中
   CLogFile   *log_file_   = nullptr;  ///< 管理日志，比如读写日志
+
+  std::mutex flush_lock_;  ///< 保证同一时间只有一个线程在刷日志
+
+  std::atomic_int flush_interval_ms_{DEFAULT_FLUSH_INTERVAL_MS};
+  std::atomic_int flush_size_{DEFAULT_FLUSH_SIZE};
+  std::atomic_int unflushed_async_commits_{0};  ///< 还没有刷盘的异步提交事务个数
+
+  std::mutex              writer_lock_;
+  std::condition_variable writer_cv_;
+  std::thread            *writer_thread_ = nullptr;  ///< 后台日志写线程
+  bool                    writer_stop_   = false;
 };
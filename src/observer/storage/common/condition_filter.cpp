@@ -36,6 +36,11 @@ DefaultConditionFilter::DefaultConditionFilter()
 }
 DefaultConditionFilter::~DefaultConditionFilter() {}
 
+bool DefaultConditionFilter::is_supported(AttrType attr_type, CompOp comp_op)
+{
+  return attr_type >= CHARS && attr_type <= FLOATS && comp_op >= EQUAL_TO && comp_op < NO_OP;
+}
+
 RC DefaultConditionFilter::init(const ConDesc &left, const ConDesc &right, AttrType attr_type, CompOp comp_op)
 {
   if (attr_type < CHARS || attr_type > FLOATS) {
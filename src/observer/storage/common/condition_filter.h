@@ -49,6 +49,11 @@ public:
   RC init(const ConDesc &left, const ConDesc &right, AttrType attr_type, CompOp comp_op);
   RC init(Table &table, const ConditionSqlNode &condition);
 
+  /**
+   * @brief 是否支持这种类型和比较运算，不打印日志。不支持时 init 会返回失败
+   */
+  static bool is_supported(AttrType attr_type, CompOp comp_op);
+
   virtual bool filter(const Record &rec) const;
 
 public:
@@ -19,7 +19,11 @@ static constexpr const char *TABLE_META_SUFFIX       = ".table";
 static constexpr const char *TABLE_META_FILE_PATTERN = ".*\\.table$";
 static constexpr const char *TABLE_DATA_SUFFIX       = ".data";
 static constexpr const char *TABLE_INDEX_SUFFIX      = ".index";
+static constexpr const char *TABLE_STATS_SUFFIX      = ".stats";
+static constexpr const char *TABLE_ZONE_MAP_SUFFIX   = ".zonemap";
 
 std::string table_meta_file(const char *base_dir, const char *table_name);
 std::string table_data_file(const char *base_dir, const char *table_name);
 std::string table_index_file(const char *base_dir, const char *table_name, const char *index_name);
+std::string table_stats_file(const char *base_dir, const char *table_name);
+std::string table_zone_map_file(const char *base_dir, const char *table_name);
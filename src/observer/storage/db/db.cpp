@@ -23,12 +23,18 @@ See the Mulan PSL v2 for more details. */
 #include "common/os/path.h"
 #include "storage/clog/clog.h"
 #include "storage/common/meta_util.h"
+#include "storage/db/stats_refresher.h"
 #include "storage/table/table.h"
 #include "storage/table/table_meta.h"
 #include "storage/trx/trx.h"
 
+Db::Db() = default;
+
 Db::~Db()
 {
+  if (stats_refresher_) {
+    stats_refresher_->stop();
+  }
   for (auto &iter : opened_tables_) {
     delete iter.second;
   }
@@ -73,12 +79,19 @@ RC Db::init(const char *name, const char *dbpath)
     LOG_WARN("failed to recover db. dbpath=%s, rc=%s", dbpath, strrc(rc));
     return rc;
   }
+
+  stats_refresher_ = std::make_unique<StatsRefresher>(*this);
+  stats_refresher_->start();
   return rc;
 }
 
-RC Db::create_table(const char *table_name, int attribute_count, const AttrInfoSqlNode *attributes)
+RC Db::create_table(
+    const char *table_name, int attribute_count, const AttrInfoSqlNode *attributes, StorageFormat storage_format)
 {
   RC rc = RC::SUCCESS;
+
+  std::lock_guard<std::mutex> guard(tables_lock_);
+
   // check table_name
   if (opened_tables_.count(table_name) != 0) {
     LOG_WARN("%s has been opened before.", table_name);
@@ -89,7 +102,8 @@ RC Db::create_table(const char *table_name, int attribute_count, const AttrInfoS
   std::string table_file_path = table_meta_file(path_.c_str(), table_name);
   Table      *table           = new Table();
   int32_t     table_id        = next_table_id_++;
-  rc = table->create(table_id, table_file_path.c_str(), table_name, path_.c_str(), attribute_count, attributes);
+  rc = table->create(
+      table_id, table_file_path.c_str(), table_name, path_.c_str(), attribute_count, attributes, storage_format);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to create table %s.", table_name);
     delete table;
@@ -131,17 +145,27 @@ Table *Db::find_table(int32_t table_id) const
 RC Db::drop_table(const char *table_name)
 {
   RC rc = RC::SUCCESS;
-  if (opened_tables_.count(table_name) == 0) {  // search map to look for exist tables
+
+  std::unique_lock<std::mutex> lock(tables_lock_);
+
+  auto iter = opened_tables_.find(table_name);  // search map to look for exist tables
+  if (iter == opened_tables_.end() || dropping_tables_.count(iter->second) != 0) {
     LOG_WARN("%s no such table to drop.", table_name);
     return RC::SCHEMA_TABLE_EXIST;
   }
 
+  // 后台线程可能正在分析这张表，等它放弃之后再删除。等待期间表还在，同名的表不能创建
+  Table *table = iter->second;  // get table_data
+  dropping_tables_.insert(table);
+  tables_cv_.wait(lock, [this, table]() { return table_refs_.count(table) == 0; });
+  dropping_tables_.erase(table);
+
   // drop table meta_file & data_file
   std::string table_file = table_meta_file(path_.c_str(), table_name);  // get meta data
-  Table      *table      = opened_tables_[table_name];                  // get table_data
-  
+
   rc = table->drop(table_file.c_str(), table_name, path_.c_str());      // main operation section for dropping table
   if (rc != RC::SUCCESS) {
+    opened_tables_.erase(table_name);
     delete table;  // recycle pointer addr
     return rc;
   }
@@ -215,4 +239,43 @@ RC Db::sync()
 
 RC Db::recover() { return clog_manager_->recover(this); }
 
-CLogManager *Db::clog_manager() { return clog_manager_.get(); }
\ No newline at end of file
+CLogManager *Db::clog_manager() { return clog_manager_.get(); }
+
+StatsRefresher *Db::stats_refresher() { return stats_refresher_.get(); }
+
+Table *Db::acquire_table(const std::function<Table *(const std::vector<Table *> &)> &chooser)
+{
+  std::lock_guard<std::mutex> guard(tables_lock_);
+
+  std::vector<Table *> tables;
+  tables.reserve(opened_tables_.size());
+  for (const auto &table_pair : opened_tables_) {
+    if (dropping_tables_.count(table_pair.second) == 0) {
+      tables.push_back(table_pair.second);
+    }
+  }
+
+  Table *table = chooser(tables);
+  if (table != nullptr) {
+    table_refs_[table]++;
+  }
+  return table;
+}
+
+void Db::release_table(Table *table)
+{
+  std::lock_guard<std::mutex> guard(tables_lock_);
+
+  auto iter = table_refs_.find(table);
+  ASSERT(iter != table_refs_.end(), "release a table that is not acquired. table=%s", table->name());
+  if (--iter->second == 0) {
+    table_refs_.erase(iter);
+    tables_cv_.notify_all();
+  }
+}
+
+bool Db::dropping(const Table *table)
+{
+  std::lock_guard<std::mutex> guard(tables_lock_);
+  return dropping_tables_.count(table) != 0;
+}
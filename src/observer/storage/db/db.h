@@ -14,16 +14,22 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <condition_variable>
+#include <functional>
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
+#include <mutex>
 
 #include "common/rc.h"
+#include "common/types.h"
 #include "sql/parser/parse_defs.h"
 
 class Table;
 class CLogManager;
+class StatsRefresher;
 
 /**
  * @brief 一个DB实例负责管理一批表
@@ -33,7 +39,7 @@ class CLogManager;
 class Db
 {
 public:
-  Db() = default;
+  Db();
   ~Db();
 
   /**
@@ -45,7 +51,8 @@ public:
    */
   RC init(const char *name, const char *dbpath);
 
-  RC create_table(const char *table_name, int attribute_count, const AttrInfoSqlNode *attributes);
+  RC create_table(const char *table_name, int attribute_count, const AttrInfoSqlNode *attributes,
+      StorageFormat storage_format = StorageFormat::ROW_FORMAT);
 
   RC drop_table(const char *table_name); // add drop-table feature
 
@@ -62,6 +69,21 @@ public:
 
   CLogManager *clog_manager();
 
+  StatsRefresher *stats_refresher();
+
+  /**
+   * @brief 在表锁中挑选一张表并引用它，给后台线程使用
+   * @details 引用期间表不会被删除，删除表时等待所有的引用释放。使用完之后要调用 release_table
+   * @param chooser 从所有没有在删除的表中挑选一张，返回空表示都不需要
+   */
+  Table *acquire_table(const std::function<Table *(const std::vector<Table *> &)> &chooser);
+  void   release_table(Table *table);
+
+  /**
+   * @brief 表是否正在被删除。引用这张表的后台线程应该尽快释放引用
+   */
+  bool dropping(const Table *table);
+
 private:
   RC open_all_tables();
 
@@ -70,6 +92,13 @@ private:
   std::string                              path_;
   std::unordered_map<std::string, Table *> opened_tables_;
   std::unique_ptr<CLogManager>             clog_manager_;
+  std::unique_ptr<StatsRefresher>          stats_refresher_;
+
+  /// 保护 opened_tables_ 和下面的引用信息，创建、删除表和后台线程挑选表时都要加锁
+  std::mutex                             tables_lock_;
+  std::condition_variable                tables_cv_;        /// 表的引用释放时通知正在删除的线程
+  std::unordered_map<const Table *, int> table_refs_;       /// 后台线程对表的引用计数
+  std::unordered_set<const Table *>      dropping_tables_;  /// 正在等待引用释放的表
 
   /// 给每个table都分配一个ID，用来记录日志。这里假设所有的DDL都不会并发操作，所以相关的数据都不上锁
   int32_t next_table_id_ = 0;
@@ -0,0 +1,169 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <chrono>
+#include <inttypes.h>
+
+#include "common/log/log.h"
+#include "storage/db/db.h"
+#include "storage/db/stats_refresher.h"
+#include "storage/table/table.h"
+#include "storage/table/table_meta.h"
+
+using namespace std;
+
+StatsRefresher::~StatsRefresher() { stop(); }
+
+void StatsRefresher::start()
+{
+  lock_guard<mutex> guard(lock_);
+  if (thread_ != nullptr) {
+    return;
+  }
+
+  stop_   = false;
+  thread_ = new thread(&StatsRefresher::refresh_routine, this);
+  LOG_INFO("stats refresher started. db=%s, interval=%dms, change ratio=%d%%",
+           db_.name(), interval_ms(), change_ratio());
+}
+
+void StatsRefresher::stop()
+{
+  thread *refresh_thread = nullptr;
+  {
+    lock_guard<mutex> guard(lock_);
+    stop_          = true;
+    refresh_thread = thread_;
+    thread_        = nullptr;
+  }
+
+  if (refresh_thread != nullptr) {
+    cv_.notify_all();
+    refresh_thread->join();
+    delete refresh_thread;
+    LOG_INFO("stats refresher stopped. db=%s", db_.name());
+  }
+}
+
+RC StatsRefresher::set_interval_ms(int interval_ms)
+{
+  if (interval_ms <= 0) {
+    LOG_WARN("invalid stats refresh interval. interval=%d", interval_ms);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  interval_ms_ = interval_ms;
+  cv_.notify_one();
+  LOG_INFO("set stats refresh interval to %dms", interval_ms);
+  return RC::SUCCESS;
+}
+
+RC StatsRefresher::set_change_ratio(int change_ratio)
+{
+  if (change_ratio < 0) {
+    LOG_WARN("invalid stats refresh change ratio. ratio=%d", change_ratio);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  change_ratio_ = change_ratio;
+  LOG_INFO("set stats refresh change ratio to %d%%", change_ratio);
+  return RC::SUCCESS;
+}
+
+double StatsRefresher::staleness(const Table &table) const
+{
+  const int change_ratio = change_ratio_.load();
+  if (change_ratio <= 0) {
+    return 0;
+  }
+
+  // 没有做过 ANALYZE 的表按照0行计算，修改超过 MIN_MODIFIED_ROWS 行就会分析
+  shared_ptr<const TableStats> stats     = table.stats();
+  const double                 rows      = stats->analyzed() ? static_cast<double>(stats->row_count()) : 0;
+  const double                 threshold = MIN_MODIFIED_ROWS + rows * change_ratio / 100;
+  return static_cast<double>(table.modifications().total()) / threshold;
+}
+
+RC StatsRefresher::refresh_once()
+{
+  // 只在表锁中挑选表，分析时不持有表锁，不会阻塞创建和删除表
+  Table *stalest = db_.acquire_table([this](const vector<Table *> &tables) {
+    Table *stalest   = nullptr;
+    double staleness = 1;
+    for (Table *table : tables) {
+      const double table_staleness = this->staleness(*table);
+      if (table_staleness >= staleness) {
+        stalest   = table;
+        staleness = table_staleness;
+      }
+    }
+    return stalest;
+  });
+  if (stalest == nullptr) {
+    return RC::SUCCESS;
+  }
+
+  const TableMeta          &table_meta = stalest->table_meta();
+  vector<const FieldMeta *> field_metas;
+  for (int i = table_meta.sys_field_num(); i < table_meta.field_num(); i++) {
+    field_metas.push_back(table_meta.field(i));
+  }
+
+  const TableModifications modifications = stalest->modifications();
+  LOG_INFO("refreshing stale table stats. table=%s, inserts=%" PRId64 ", updates=%" PRId64 ", deletes=%" PRId64,
+           stalest->name(), modifications.inserts, modifications.updates, modifications.deletes);
+
+  // 表正在被删除时放弃分析，尽快释放引用
+  int visited_pages = 0;
+  RC  rc            = stalest->analyze(field_metas, [this, stalest, &visited_pages]() {
+    if (db_.dropping(stalest)) {
+      return RC::SCHEMA_TABLE_NOT_EXIST;
+    }
+    throttle(visited_pages);
+    return RC::SUCCESS;
+  });
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to refresh table stats. table=%s, rc=%s", stalest->name(), strrc(rc));
+  }
+  db_.release_table(stalest);
+  return rc;
+}
+
+void StatsRefresher::throttle(int &visited_pages)
+{
+  if (++visited_pages % PAGES_PER_BATCH != 0) {
+    return;
+  }
+
+  // 正在停止时不再休息，尽快分析完
+  unique_lock<mutex> lock(lock_);
+  cv_.wait_for(lock, chrono::milliseconds(BATCH_DELAY_MS), [this]() { return stop_; });
+}
+
+void StatsRefresher::refresh_routine()
+{
+  unique_lock<mutex> lock(lock_);
+  while (!stop_) {
+    const int  interval_ms = interval_ms_.load();
+    const bool woken       = cv_.wait_for(lock, chrono::milliseconds(interval_ms), [this, interval_ms]() {
+      return stop_ || interval_ms_.load() != interval_ms;
+    });
+    if (stop_) {
+      break;
+    }
+    if (woken) {
+      continue;  // 间隔改变了，按照新的间隔重新等待
+    }
+
+    lock.unlock();
+    refresh_once();
+    lock.lock();
+  }
+}
@@ -0,0 +1,88 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+
+#include "common/rc.h"
+
+class Db;
+class Table;
+
+/**
+ * @brief 后台刷新统计信息
+ * @details 每个DB有一个后台线程，每隔 interval_ms 检查一次所有的表，
+ * 上次 ANALYZE 之后修改的行数超过 MIN_MODIFIED_ROWS + change_ratio% * 行数 时认为统计信息过期。
+ * 每一轮只分析过期最严重的一张表，分析所有的用户字段。
+ * 为了不影响前台的查询，每读 PAGES_PER_BATCH 个采样页面就休息 BATCH_DELAY_MS。
+ * 新的统计信息由 Table::analyze 整体替换，优化器拿到的总是一份完整的快照。
+ */
+class StatsRefresher
+{
+public:
+  static constexpr int DEFAULT_INTERVAL_MS  = 10000;
+  static constexpr int DEFAULT_CHANGE_RATIO = 10;  ///< 百分比
+  static constexpr int MIN_MODIFIED_ROWS    = 50;  ///< 修改很少的小表不需要刷新
+  static constexpr int PAGES_PER_BATCH      = 32;
+  static constexpr int BATCH_DELAY_MS       = 10;
+
+public:
+  explicit StatsRefresher(Db &db) : db_(db) {}
+  ~StatsRefresher();
+
+  void start();
+  void stop();
+
+  /**
+   * @brief 设置后台线程检查的间隔(毫秒)
+   */
+  RC  set_interval_ms(int interval_ms);
+  int interval_ms() const { return interval_ms_.load(); }
+
+  /**
+   * @brief 设置修改的行数占表行数的百分比超过多少时刷新统计信息，0表示不自动刷新
+   */
+  RC  set_change_ratio(int change_ratio);
+  int change_ratio() const { return change_ratio_.load(); }
+
+  /**
+   * @brief 统计信息过期的程度，不小于1时需要刷新
+   */
+  double staleness(const Table &table) const;
+
+  /**
+   * @brief 执行一轮检查，分析过期最严重的一张表
+   */
+  RC refresh_once();
+
+private:
+  void refresh_routine();
+
+  /**
+   * @brief 读完一个采样页面之后调用，攒够一批页面就休息一下
+   */
+  void throttle(int &visited_pages);
+
+private:
+  Db &db_;
+
+  std::atomic_int interval_ms_{DEFAULT_INTERVAL_MS};
+  std::atomic_int change_ratio_{DEFAULT_CHANGE_RATIO};
+
+  std::mutex              lock_;
+  std::condition_variable cv_;
+  std::thread            *thread_ = nullptr;
+  bool                    stop_   = false;
+};
@@ -13,42 +13,151 @@ See the Mulan PSL v2 for more details. */
 // Rewritten by Longda & Wangyunlai
 //
 #include "storage/index/bplus_tree.h"
-#include "common/lang/lower_bound.h"
+#include "storage/index/bplus_tree_key_sorter.h"
+#include "storage/index/bplus_tree_search.h"
 #include "common/log/log.h"
 #include "sql/parser/parse_defs.h"
 #include "storage/buffer/disk_buffer_pool.h"
+#include <algorithm>
+#include <inttypes.h>
 #include <memory>
+#include <thread>
 
 using namespace std;
 using namespace common;
 
 #define FIRST_INDEX_PAGE 1
 
-int calc_internal_page_capacity(int attr_length)
+/////////////////////////////////////////////////////////////////////////////////
+static void encode_uint32(uint32_t value, char *dst)
+{
+  dst[0] = static_cast<char>(value >> 24);
+  dst[1] = static_cast<char>(value >> 16);
+  dst[2] = static_cast<char>(value >> 8);
+  dst[3] = static_cast<char>(value);
+}
+
+static uint32_t decode_uint32(const char *src)
+{
+  const unsigned char *p = reinterpret_cast<const unsigned char *>(src);
+  return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+         (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+static void encode_int32(int32_t value, char *dst) { encode_uint32(static_cast<uint32_t>(value) ^ 0x80000000U, dst); }
+
+static int32_t decode_int32(const char *src) { return static_cast<int32_t>(decode_uint32(src) ^ 0x80000000U); }
+
+static void encode_float(float value, char *dst)
+{
+  if (value == 0) {
+    value = 0;  // -0.0 与 0.0 相等
+  }
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  bits = (bits & 0x80000000U) ? ~bits : (bits | 0x80000000U);
+  encode_uint32(bits, dst);
+}
+
+static float decode_float(const char *src)
+{
+  uint32_t bits = decode_uint32(src);
+  bits          = (bits & 0x80000000U) ? (bits & ~0x80000000U) : ~bits;
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+void KeyNormalizer::init(std::vector<AttrType> type, std::vector<int> length)
 {
-  int item_size = attr_length + sizeof(RID) + sizeof(PageNum);
-  int capacity  = ((int)BP_PAGE_DATA_SIZE - InternalIndexNode::HEADER_SIZE) / item_size;
-  return capacity;
+  attr_type_    = type;
+  attr_lengths_ = length;
+  attr_length_  = 0;
+  for (int len : attr_lengths_) {
+    attr_length_ += len;
+  }
+}
+
+void KeyNormalizer::normalize(const char *user_key, const RID &rid, char *key) const
+{
+  const RID rid_copy = rid;  // key 可能与 rid 所在的内存重叠
+  int       pos      = 0;
+  for (size_t i = 0; i < attr_type_.size(); i++) {
+    const int len = attr_lengths_[i];
+    switch (attr_type_[i]) {
+      case INTS:
+      case DATES: {
+        int32_t value;
+        memcpy(&value, user_key + pos, sizeof(value));
+        encode_int32(value, key + pos);
+      } break;
+      case FLOATS: {
+        float value;
+        memcpy(&value, user_key + pos, sizeof(value));
+        encode_float(value, key + pos);
+      } break;
+      case CHARS: {
+        const int str_len = static_cast<int>(strnlen(user_key + pos, len));
+        memmove(key + pos, user_key + pos, str_len);
+        memset(key + pos + str_len, 0, len - str_len);
+      } break;
+      default: {
+        memmove(key + pos, user_key + pos, len);
+      } break;
+    }
+    pos += len;
+  }
+
+  encode_int32(rid_copy.page_num, key + pos);
+  encode_int32(rid_copy.slot_num, key + pos + sizeof(int32_t));
+}
+
+void KeyNormalizer::denormalize(const char *key, char *user_key, RID &rid) const
+{
+  int pos = 0;
+  for (size_t i = 0; i < attr_type_.size(); i++) {
+    const int len = attr_lengths_[i];
+    switch (attr_type_[i]) {
+      case INTS:
+      case DATES: {
+        const int32_t value = decode_int32(key + pos);
+        memcpy(user_key + pos, &value, sizeof(value));
+      } break;
+      case FLOATS: {
+        const float value = decode_float(key + pos);
+        memcpy(user_key + pos, &value, sizeof(value));
+      } break;
+      default: {
+        memmove(user_key + pos, key + pos, len);
+      } break;
+    }
+    pos += len;
+  }
+
+  rid.page_num = decode_int32(key + pos);
+  rid.slot_num = decode_int32(key + pos + sizeof(int32_t));
 }
 
-int calc_leaf_page_capacity(int attr_length)
+RID KeyNormalizer::rid(const char *key) const
 {
-  int item_size = attr_length + sizeof(RID) + sizeof(RID);
-  int capacity  = ((int)BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE) / item_size;
-  return capacity;
+  return RID(decode_int32(key + attr_length_), decode_int32(key + attr_length_ + sizeof(int32_t)));
 }
 
 /////////////////////////////////////////////////////////////////////////////////
 IndexNodeHandler::IndexNodeHandler(const IndexFileHeader &header, Frame *frame)
-    : header_(header), page_num_(frame->page_num()), node_((IndexNode *)frame->data())
+    : IndexNodeHandler(header, frame->page_num(), frame->data())
+{}
+
+IndexNodeHandler::IndexNodeHandler(const IndexFileHeader &header, PageNum page_num, char *data)
+    : header_(header), page_num_(page_num), node_((IndexNode *)data)
 {}
 
 bool IndexNodeHandler::is_leaf() const { return node_->is_leaf; }
 void IndexNodeHandler::init_empty(bool leaf)
 {
-  node_->is_leaf = leaf;
-  node_->key_num = 0;
-  node_->parent  = BP_INVALID_PAGE_NUM;
+  node_->is_leaf       = leaf;
+  node_->prefix_length = 0;
+  node_->key_num       = 0;
 }
 PageNum IndexNodeHandler::page_num() const { return page_num_; }
 
@@ -57,14 +166,21 @@ int IndexNodeHandler::key_size() const { return header_.key_length; }
 int IndexNodeHandler::value_size() const
 {
   // return header_.value_size;
-  return sizeof(RID);
+  return is_leaf() ? sizeof(RID) : sizeof(PageNum);
 }
 
-int IndexNodeHandler::item_size() const { return key_size() + value_size(); }
+int IndexNodeHandler::item_size() const { return suffix_size() + value_size(); }
+
+// 没有加锁读取时，页头可能正在被修改，这里保证前缀长度不会超过键值的长度
+int IndexNodeHandler::prefix_length() const { return std::min<int>(node_->prefix_length, key_size()); }
+
+const char *IndexNodeHandler::prefix() const { return prefix_data(); }
+
+int IndexNodeHandler::suffix_size() const { return key_size() - prefix_length(); }
 
 int IndexNodeHandler::size() const { return node_->key_num; }
 
-int IndexNodeHandler::max_size() const { return is_leaf() ? header_.leaf_max_size : header_.internal_max_size; }
+int IndexNodeHandler::max_size() const { return max_size_of(header_, is_leaf(), prefix_length()); }
 
 int IndexNodeHandler::min_size() const
 {
@@ -74,9 +190,124 @@ int IndexNodeHandler::min_size() const
 
 void IndexNodeHandler::increase_size(int n) { node_->key_num += n; }
 
-PageNum IndexNodeHandler::parent_page_num() const { return node_->parent; }
+int IndexNodeHandler::max_size_of(const IndexFileHeader &header, bool leaf, int prefix_length)
+{
+  const int header_max_size = leaf ? header.leaf_max_size : header.internal_max_size;
+  if (header_max_size > 0) {
+    return header_max_size;
+  }
+
+  const int header_size = leaf ? LeafIndexNode::HEADER_SIZE : InternalIndexNode::HEADER_SIZE;
+  const int value_size  = leaf ? sizeof(RID) : sizeof(PageNum);
+  const int item_size   = header.key_length - prefix_length + value_size;
+  return ((int)BP_PAGE_DATA_SIZE - header_size - prefix_length) / item_size;
+}
+
+int IndexNodeHandler::common_prefix_length(const char *key1, const char *key2, int length)
+{
+  int i = 0;
+  while (i < length && key1[i] == key2[i]) {
+    i++;
+  }
+  return i;
+}
+
+int IndexNodeHandler::used_bytes() const
+{
+  const int header_size   = is_leaf() ? LeafIndexNode::HEADER_SIZE : InternalIndexNode::HEADER_SIZE;
+  const int prefix_length = this->prefix_length();
+  const int item_size     = key_size() - prefix_length + value_size();
+  const int size          = std::max(0, std::min(this->size(), max_size_of(header_, is_leaf(), prefix_length)));
+  return std::min<int>(BP_PAGE_DATA_SIZE, header_size + prefix_length + size * item_size);
+}
+
+char *IndexNodeHandler::prefix_data() const
+{
+  const int header_size = is_leaf() ? LeafIndexNode::HEADER_SIZE : InternalIndexNode::HEADER_SIZE;
+  return reinterpret_cast<char *>(node_) + header_size;
+}
+
+char *IndexNodeHandler::item_at(int index) const { return prefix_data() + prefix_length() + index * item_size(); }
+
+void IndexNodeHandler::write_item(int index, const char *key, const char *value)
+{
+  char *item = item_at(index);
+  memcpy(item, key + prefix_length(), suffix_size());
+  memcpy(item + suffix_size(), value, value_size());
+}
+
+void IndexNodeHandler::append_item(const char *key, const char *value)
+{
+  write_item(size(), key, value);
+  increase_size(1);
+}
+
+void IndexNodeHandler::get_key(int index, char *key) const
+{
+  const int prefix_length = this->prefix_length();
+  memcpy(key, prefix_data(), prefix_length);
+  memcpy(key + prefix_length, item_at(index), key_size() - prefix_length);
+}
+
+int IndexNodeHandler::compare_key(int index, const char *key, int length) const
+{
+  const int prefix_length = this->prefix_length();
+  int       result        = memcmp(prefix_data(), key, std::min(prefix_length, length));
+  if (result != 0 || length <= prefix_length) {
+    return result;
+  }
+  return memcmp(item_at(index), key + prefix_length, length - prefix_length);
+}
+
+int IndexNodeHandler::lower_bound(const char *key, int first, bool *found) const
+{
+  if (found) {
+    *found = false;
+  }
+
+  const int prefix_length = this->prefix_length();
+  const int suffix_size   = key_size() - prefix_length;
+  const int size          = std::min(this->size(), max_size_of(header_, is_leaf(), prefix_length));
+  if (first >= size) {
+    return size;
+  }
+
+  // 先比较前缀，前缀不同时所有项都比 key 大或者都比 key 小
+  const int result = memcmp(prefix_data(), key, prefix_length);
+  if (result > 0) {
+    return first;
+  } else if (result < 0) {
+    return size;
+  }
+
+  const int   item_size = suffix_size + value_size();
+  const char *items     = prefix_data() + prefix_length + first * item_size;
+  return first + bplus_tree_search::search_function(suffix_size)(
+                     items, item_size, size - first, key + prefix_length, suffix_size, found);
+}
+
+void IndexNodeHandler::set_prefix(const char *key, int prefix_length)
+{
+  const int size           = this->size();
+  const int full_item_size = key_size() + value_size();
+
+  // 先把所有项还原成完整的键值，再按照新的前缀写回去
+  std::vector<char> items(static_cast<size_t>(size) * full_item_size + prefix_length);
+  char             *new_prefix = items.data() + static_cast<size_t>(size) * full_item_size;
+  memcpy(new_prefix, key, prefix_length);
+  for (int i = 0; i < size; i++) {
+    char *item = items.data() + static_cast<size_t>(i) * full_item_size;
+    get_key(i, item);
+    memcpy(item + key_size(), item_at(i) + suffix_size(), value_size());
+  }
 
-void IndexNodeHandler::set_parent_page_num(PageNum page_num) { this->node_->parent = page_num; }
+  node_->prefix_length = static_cast<uint16_t>(prefix_length);
+  memcpy(prefix_data(), new_prefix, prefix_length);
+  for (int i = 0; i < size; i++) {
+    const char *item = items.data() + static_cast<size_t>(i) * full_item_size;
+    write_item(i, item, item + key_size());
+  }
+}
 
 /**
  * 检查一个节点经过插入或删除操作后是否需要分裂或合并操作
@@ -117,16 +348,15 @@ std::string to_string(const IndexNodeHandler &handler)
   std::stringstream ss;
 
   ss << "PageNum:" << handler.page_num() << ",is_leaf:" << handler.is_leaf() << ","
-     << "key_num:" << handler.size() << ","
-     << "parent:" << handler.parent_page_num() << ",";
+     << "prefix_length:" << handler.prefix_length() << ","
+     << "key_num:" << handler.size() << ",";
 
   return ss.str();
 }
 
-bool IndexNodeHandler::validate() const
+bool IndexNodeHandler::validate(bool is_root_node) const
 {
-  if (parent_page_num() == BP_INVALID_PAGE_NUM) {
-    // this is a root page
+  if (is_root_node) {
     if (size() < 1) {
       LOG_WARN("root page has no item");
       return false;
@@ -136,13 +366,27 @@ bool IndexNodeHandler::validate() const
       LOG_WARN("root page internal node has less than 2 child. size=%d", size());
       return false;
     }
+
+    if (prefix_length() != 0) {
+      LOG_WARN("root page should not have key prefix. prefix length=%d", prefix_length());
+      return false;
+    }
+  }
+
+  if (size() > max_size()) {
+    LOG_WARN("too many items in page. page num=%d, size=%d, max size=%d", page_num(), size(), max_size());
+    return false;
   }
   return true;
 }
 
 /////////////////////////////////////////////////////////////////////////////////
 LeafIndexNodeHandler::LeafIndexNodeHandler(const IndexFileHeader &header, Frame *frame)
-    : IndexNodeHandler(header, frame), leaf_node_((LeafIndexNode *)frame->data())
+    : LeafIndexNodeHandler(header, frame->page_num(), frame->data())
+{}
+
+LeafIndexNodeHandler::LeafIndexNodeHandler(const IndexFileHeader &header, PageNum page_num, char *data)
+    : IndexNodeHandler(header, page_num, data), leaf_node_((LeafIndexNode *)data)
 {}
 
 void LeafIndexNodeHandler::init_empty()
@@ -155,35 +399,15 @@ void LeafIndexNodeHandler::set_next_page(PageNum page_num) { leaf_node_->next_br
 
 PageNum LeafIndexNodeHandler::next_page() const { return leaf_node_->next_brother; }
 
-char *LeafIndexNodeHandler::key_at(int index)
-{
-  assert(index >= 0 && index < size());
-  return __key_at(index);
-}
-
 char *LeafIndexNodeHandler::value_at(int index)
 {
   assert(index >= 0 && index < size());
   return __value_at(index);
 }
 
-int LeafIndexNodeHandler::lookup(const KeyComparator &comparator, const char *key, bool *found /* = nullptr */) const
-{
-  const int                    size = this->size();
-  common::BinaryIterator<char> iter_begin(item_size(), __key_at(0));
-  common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
-  common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator, found);
-  return iter - iter_begin;
-}
-
-int LeafIndexNodeHandler::lookup(const KeyComparator &comparator, const char *key, bool *found, bool is_unique) const
+int LeafIndexNodeHandler::lookup(const char *key, bool *found /* = nullptr */) const
 {
-  const int                    size = this->size();
-  common::BinaryIterator<char> iter_begin(item_size(), __key_at(0));
-  common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
-  LOG_DEBUG("[[[I'm Here Here Here]]]");
-  common::BinaryIterator<char> iter = lower_bound_v2_advanced(iter_begin, iter_end, key, comparator, found, is_unique);
-  return iter - iter_begin;
+  return lower_bound(key, 0, found);
 }
 
 void LeafIndexNodeHandler::insert(int index, const char *key, const char *value)
@@ -191,8 +415,7 @@ void LeafIndexNodeHandler::insert(int index, const char *key, const char *value)
   if (index < size()) {
     memmove(__item_at(index + 1), __item_at(index), (static_cast<size_t>(size()) - index) * item_size());
   }
-  memcpy(__item_at(index), key, key_size());
-  memcpy(__item_at(index) + key_size(), value, value_size());
+  write_item(index, key, value);
   increase_size(1);
 }
 void LeafIndexNodeHandler::remove(int index)
@@ -204,10 +427,10 @@ void LeafIndexNodeHandler::remove(int index)
   increase_size(-1);
 }
 
-int LeafIndexNodeHandler::remove(const char *key, const KeyComparator &comparator)
+int LeafIndexNodeHandler::remove(const char *key)
 {
   bool found = false;
-  int  index = lookup(comparator, key, &found);
+  int  index = lookup(key, &found);
   if (found) {
     this->remove(index);
     return 1;
@@ -215,19 +438,23 @@ int LeafIndexNodeHandler::remove(const char *key, const KeyComparator &comparato
   return 0;
 }
 
-RC LeafIndexNodeHandler::move_half_to(LeafIndexNodeHandler &other, DiskBufferPool *bp)
+RC LeafIndexNodeHandler::move_half_to(LeafIndexNodeHandler &other)
 {
   const int size       = this->size();
   const int move_index = size / 2;
 
+  // 新节点先使用相同的前缀，分裂完成之后再根据父节点调整
+  other.set_prefix(prefix(), prefix_length());
   memcpy(other.__item_at(0), this->__item_at(move_index), static_cast<size_t>(item_size()) * (size - move_index));
   other.increase_size(size - move_index);
   this->increase_size(-(size - move_index));
   return RC::SUCCESS;
 }
-RC LeafIndexNodeHandler::move_first_to_end(LeafIndexNodeHandler &other, DiskBufferPool *disk_buffer_pool)
+RC LeafIndexNodeHandler::move_first_to_end(LeafIndexNodeHandler &other)
 {
-  other.append(__item_at(0));
+  std::vector<char> key(key_size());
+  get_key(0, key.data());
+  other.append(key.data(), __value_at(0));
 
   if (size() >= 1) {
     memmove(__item_at(0), __item_at(1), (static_cast<size_t>(size()) - 1) * item_size());
@@ -236,9 +463,11 @@ RC LeafIndexNodeHandler::move_first_to_end(LeafIndexNodeHandler &other, DiskBuff
   return RC::SUCCESS;
 }
 
-RC LeafIndexNodeHandler::move_last_to_front(LeafIndexNodeHandler &other, DiskBufferPool *bp)
+RC LeafIndexNodeHandler::move_last_to_front(LeafIndexNodeHandler &other)
 {
-  other.preappend(__item_at(size() - 1));
+  std::vector<char> key(key_size());
+  get_key(size() - 1, key.data());
+  other.preappend(key.data(), __value_at(size() - 1));
 
   increase_size(-1);
   return RC::SUCCESS;
@@ -246,124 +475,89 @@ RC LeafIndexNodeHandler::move_last_to_front(LeafIndexNodeHandler &other, DiskBuf
 /**
  * move all items to left page
  */
-RC LeafIndexNodeHandler::move_to(LeafIndexNodeHandler &other, DiskBufferPool *bp)
+RC LeafIndexNodeHandler::move_to(LeafIndexNodeHandler &other)
 {
-  memcpy(other.__item_at(other.size()), this->__item_at(0), static_cast<size_t>(this->size()) * item_size());
-  other.increase_size(this->size());
+  std::vector<char> key(key_size());
+  for (int i = 0; i < this->size(); i++) {
+    get_key(i, key.data());
+    other.append(key.data(), __value_at(i));
+  }
   this->increase_size(-this->size());
 
   other.set_next_page(this->next_page());
   return RC::SUCCESS;
 }
 
-void LeafIndexNodeHandler::append(const char *item)
+void LeafIndexNodeHandler::append(const char *key, const char *value)
 {
-  memcpy(__item_at(size()), item, item_size());
+  write_item(size(), key, value);
   increase_size(1);
 }
 
-void LeafIndexNodeHandler::preappend(const char *item)
+void LeafIndexNodeHandler::preappend(const char *key, const char *value)
 {
   if (size() > 0) {
     memmove(__item_at(1), __item_at(0), static_cast<size_t>(size()) * item_size());
   }
-  memcpy(__item_at(0), item, item_size());
+  write_item(0, key, value);
   increase_size(1);
 }
 
-char *LeafIndexNodeHandler::__item_at(int index) const { return leaf_node_->array + (index * item_size()); }
-char *LeafIndexNodeHandler::__key_at(int index) const { return __item_at(index); }
-char *LeafIndexNodeHandler::__value_at(int index) const { return __item_at(index) + key_size(); }
+char *LeafIndexNodeHandler::__item_at(int index) const { return item_at(index); }
+char *LeafIndexNodeHandler::__value_at(int index) const { return __item_at(index) + suffix_size(); }
 
 std::string to_string(const LeafIndexNodeHandler &handler, const KeyPrinter &printer)
 {
   std::stringstream ss;
+  std::vector<char> key(handler.key_size());
   ss << to_string((const IndexNodeHandler &)handler) << ",next page:" << handler.next_page();
-  ss << ",values=[" << printer(handler.__key_at(0));
-  for (int i = 1; i < handler.size(); i++) {
-    ss << "," << printer(handler.__key_at(i));
+  ss << ",values=[";
+  for (int i = 0; i < handler.size(); i++) {
+    handler.get_key(i, key.data());
+    ss << (i == 0 ? "" : ",") << printer(key.data());
   }
   ss << "]";
   return ss.str();
 }
 
-bool LeafIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferPool *bp) const
+bool LeafIndexNodeHandler::validate(bool is_root_node) const
 {
-  bool result = IndexNodeHandler::validate();
+  bool result = IndexNodeHandler::validate(is_root_node);
   if (false == result) {
     return false;
   }
 
-  const int node_size = size();
+  const int         node_size = size();
+  std::vector<char> key(key_size());
   for (int i = 1; i < node_size; i++) {
-    if (comparator(__key_at(i - 1), __key_at(i)) >= 0) {
+    get_key(i - 1, key.data());
+    if (compare_key(i, key.data()) <= 0) {
       LOG_WARN("page number = %d, invalid key order. id1=%d,id2=%d, this=%s",
                page_num(), i - 1, i, to_string(*this).c_str());
       return false;
     }
   }
-
-  PageNum parent_page_num = this->parent_page_num();
-  if (parent_page_num == BP_INVALID_PAGE_NUM) {
-    return true;
-  }
-
-  Frame *parent_frame;
-  RC     rc = bp->get_this_page(parent_page_num, &parent_frame);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to fetch parent page. page num=%d, rc=%d:%s", parent_page_num, rc, strrc(rc));
-    return false;
-  }
-
-  InternalIndexNodeHandler parent_node(header_, parent_frame);
-  int                      index_in_parent = parent_node.value_index(this->page_num());
-  if (index_in_parent < 0) {
-    LOG_WARN("invalid leaf node. cannot find index in parent. this page num=%d, parent page num=%d",
-             this->page_num(), parent_page_num);
-    bp->unpin_page(parent_frame);
-    return false;
-  }
-
-  if (0 != index_in_parent) {
-    int cmp_result = comparator(__key_at(0), parent_node.key_at(index_in_parent));
-    if (cmp_result < 0) {
-      LOG_WARN("invalid leaf node. first item should be greate than or equal to parent item. "
-               "this page num=%d, parent page num=%d, index in parent=%d",
-               this->page_num(), parent_node.page_num(), index_in_parent);
-      bp->unpin_page(parent_frame);
-      return false;
-    }
-  }
-
-  if (index_in_parent < parent_node.size() - 1) {
-    int cmp_result = comparator(__key_at(size() - 1), parent_node.key_at(index_in_parent + 1));
-    if (cmp_result >= 0) {
-      LOG_WARN("invalid leaf node. last item should be less than the item at the first after item in parent."
-               "this page num=%d, parent page num=%d, parent item to compare=%d",
-               this->page_num(), parent_node.page_num(), index_in_parent + 1);
-      bp->unpin_page(parent_frame);
-      return false;
-    }
-  }
-  bp->unpin_page(parent_frame);
   return true;
 }
 
 /////////////////////////////////////////////////////////////////////////////////
 InternalIndexNodeHandler::InternalIndexNodeHandler(const IndexFileHeader &header, Frame *frame)
-    : IndexNodeHandler(header, frame), internal_node_((InternalIndexNode *)frame->data())
+    : InternalIndexNodeHandler(header, frame->page_num(), frame->data())
+{}
+
+InternalIndexNodeHandler::InternalIndexNodeHandler(const IndexFileHeader &header, PageNum page_num, char *data)
+    : IndexNodeHandler(header, page_num, data), internal_node_((InternalIndexNode *)data)
 {}
 
 std::string to_string(const InternalIndexNodeHandler &node, const KeyPrinter &printer)
 {
   std::stringstream ss;
+  std::vector<char> key(node.key_size());
   ss << to_string((const IndexNodeHandler &)node);
-  ss << ",children:["
-     << "{key:" << printer(node.__key_at(0)) << ","
-     << "value:" << *(PageNum *)node.__value_at(0) << "}";
-
-  for (int i = 1; i < node.size(); i++) {
-    ss << ",{key:" << printer(node.__key_at(i)) << ",value:" << *(PageNum *)node.__value_at(i) << "}";
+  ss << ",children:[";
+  for (int i = 0; i < node.size(); i++) {
+    node.get_key(i, key.data());
+    ss << (i == 0 ? "" : ",") << "{key:" << printer(key.data()) << ",value:" << *(PageNum *)node.__value_at(i) << "}";
   }
   ss << "]";
   return ss.str();
@@ -372,10 +566,9 @@ std::string to_string(const InternalIndexNodeHandler &node, const KeyPrinter &pr
 void InternalIndexNodeHandler::init_empty() { IndexNodeHandler::init_empty(false); }
 void InternalIndexNodeHandler::create_new_root(PageNum first_page_num, const char *key, PageNum page_num)
 {
-  memset(__key_at(0), 0, key_size());
+  memset(__item_at(0), 0, suffix_size());
   memcpy(__value_at(0), &first_page_num, value_size());
-  memcpy(__item_at(1), key, key_size());
-  memcpy(__value_at(1), &page_num, value_size());
+  write_item(1, key, (const char *)&page_num);
   increase_size(2);
 }
 
@@ -384,32 +577,31 @@ void InternalIndexNodeHandler::create_new_root(PageNum first_page_num, const cha
  * the entry to be inserted will never at the first slot.
  * the right child page after split will always have bigger keys.
  */
-void InternalIndexNodeHandler::insert(const char *key, PageNum page_num, const KeyComparator &comparator)
+void InternalIndexNodeHandler::insert(const char *key, PageNum page_num)
 {
   int insert_position = -1;
-  lookup(comparator, key, nullptr, &insert_position);
+  lookup(key, nullptr, &insert_position);
   if (insert_position < size()) {
     memmove(__item_at(insert_position + 1),
         __item_at(insert_position),
         (static_cast<size_t>(size()) - insert_position) * item_size());
   }
-  memcpy(__item_at(insert_position), key, key_size());
-  memcpy(__value_at(insert_position), &page_num, value_size());
+  write_item(insert_position, key, (const char *)&page_num);
   increase_size(1);
 }
 
-RC InternalIndexNodeHandler::move_half_to(InternalIndexNodeHandler &other, DiskBufferPool *bp)
+RC InternalIndexNodeHandler::move_half_to(InternalIndexNodeHandler &other)
 {
   const int size       = this->size();
   const int move_index = size / 2;
-  RC        rc         = other.copy_from(this->__item_at(move_index), size - move_index, bp);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to copy item to new node. rc=%d:%s", rc, strrc(rc));
-    return rc;
-  }
+
+  // 新节点先使用相同的前缀，分裂完成之后再根据父节点调整
+  other.set_prefix(prefix(), prefix_length());
+  memcpy(other.__item_at(0), this->__item_at(move_index), static_cast<size_t>(item_size()) * (size - move_index));
+  other.increase_size(size - move_index);
 
   increase_size(-(size - move_index));
-  return rc;
+  return RC::SUCCESS;
 }
 
 /**
@@ -417,8 +609,8 @@ RC InternalIndexNodeHandler::move_half_to(InternalIndexNodeHandler &other, DiskB
  * @return unlike the leafNode, the return value is not the insert position,
  * but only the index of child to find.
  */
-int InternalIndexNodeHandler::lookup(const KeyComparator &comparator, const char *key, bool *found /* = nullptr */,
-    int *insert_position /*= nullptr */) const
+int InternalIndexNodeHandler::lookup(
+    const char *key, bool *found /* = nullptr */, int *insert_position /*= nullptr */) const
 {
   const int size = this->size();
   if (size == 0) {
@@ -431,30 +623,23 @@ int InternalIndexNodeHandler::lookup(const KeyComparator &comparator, const char
     return 0;
   }
 
-  common::BinaryIterator<char> iter_begin(item_size(), __key_at(1));
-  common::BinaryIterator<char> iter_end(item_size(), __key_at(size));
-  common::BinaryIterator<char> iter = lower_bound(iter_begin, iter_end, key, comparator, found);
-  int                          ret  = static_cast<int>(iter - iter_begin) + 1;
+  // 第一个键值是无效的，从第二个开始查找。找到相等的键值就是这个子节点，否则是前一个子节点
+  bool exists = false;
+  int  ret    = lower_bound(key, 1, &exists);
   if (insert_position) {
     *insert_position = ret;
   }
-
-  if (ret >= size || comparator(key, __key_at(ret)) < 0) {
-    return ret - 1;
+  if (found) {
+    *found = exists;
   }
-  return ret;
-}
 
-char *InternalIndexNodeHandler::key_at(int index)
-{
-  assert(index >= 0 && index < size());
-  return __key_at(index);
+  return exists ? ret : ret - 1;
 }
 
 void InternalIndexNodeHandler::set_key_at(int index, const char *key)
 {
   assert(index >= 0 && index < size());
-  memcpy(__key_at(index), key, key_size());
+  memcpy(__item_at(index), key + prefix_length(), suffix_size());
 }
 
 PageNum InternalIndexNodeHandler::value_at(int index)
@@ -482,197 +667,87 @@ void InternalIndexNodeHandler::remove(int index)
   increase_size(-1);
 }
 
-RC InternalIndexNodeHandler::move_to(InternalIndexNodeHandler &other, DiskBufferPool *disk_buffer_pool)
+RC InternalIndexNodeHandler::move_to(InternalIndexNodeHandler &other)
 {
-  RC rc = other.copy_from(__item_at(0), size(), disk_buffer_pool);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to copy items to other node. rc=%d:%s", rc, strrc(rc));
-    return rc;
+  std::vector<char> key(key_size());
+  for (int i = 0; i < size(); i++) {
+    get_key(i, key.data());
+    other.append(key.data(), *(PageNum *)__value_at(i));
   }
 
   increase_size(-this->size());
   return RC::SUCCESS;
 }
 
-RC InternalIndexNodeHandler::move_first_to_end(InternalIndexNodeHandler &other, DiskBufferPool *disk_buffer_pool)
+RC InternalIndexNodeHandler::move_first_to_end(InternalIndexNodeHandler &other)
 {
-  RC rc = other.append(__item_at(0), disk_buffer_pool);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to append item to others.");
-    return rc;
-  }
+  std::vector<char> key(key_size());
+  get_key(0, key.data());
+  other.append(key.data(), *(PageNum *)__value_at(0));
 
   if (size() >= 1) {
     memmove(__item_at(0), __item_at(1), (static_cast<size_t>(size()) - 1) * item_size());
   }
   increase_size(-1);
-  return rc;
+  return RC::SUCCESS;
 }
 
-RC InternalIndexNodeHandler::move_last_to_front(InternalIndexNodeHandler &other, DiskBufferPool *bp)
+RC InternalIndexNodeHandler::move_last_to_front(InternalIndexNodeHandler &other)
 {
-  RC rc = other.preappend(__item_at(size() - 1), bp);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to preappend to others");
-    return rc;
-  }
+  std::vector<char> key(key_size());
+  get_key(size() - 1, key.data());
+  other.preappend(key.data(), *(PageNum *)__value_at(size() - 1));
 
   increase_size(-1);
-  return rc;
+  return RC::SUCCESS;
 }
-/**
- * copy items from other node to self's right
- */
-RC InternalIndexNodeHandler::copy_from(const char *items, int num, DiskBufferPool *disk_buffer_pool)
-{
-  memcpy(__item_at(this->size()), items, static_cast<size_t>(num) * item_size());
 
-  RC      rc            = RC::SUCCESS;
-  PageNum this_page_num = this->page_num();
-  Frame  *frame         = nullptr;
-  for (int i = 0; i < num; i++) {
-    const PageNum page_num = *(const PageNum *)((items + i * item_size()) + key_size());
-    rc                     = disk_buffer_pool->get_this_page(page_num, &frame);
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to set child's page num. child page num:%d, this page num=%d, rc=%d:%s",
-               page_num, this_page_num, rc, strrc(rc));
-      return rc;
-    }
-    IndexNodeHandler child_node(header_, frame);
-    child_node.set_parent_page_num(this_page_num);
-    frame->mark_dirty();
-    disk_buffer_pool->unpin_page(frame);
-  }
-  increase_size(num);
-  return rc;
+void InternalIndexNodeHandler::append(const char *key, PageNum page_num)
+{
+  write_item(this->size(), key, (const char *)&page_num);
+  increase_size(1);
 }
 
-RC InternalIndexNodeHandler::append(const char *item, DiskBufferPool *bp) { return this->copy_from(item, 1, bp); }
-
-RC InternalIndexNodeHandler::preappend(const char *item, DiskBufferPool *bp)
+void InternalIndexNodeHandler::preappend(const char *key, PageNum page_num)
 {
-  PageNum child_page_num = *(PageNum *)(item + key_size());
-  Frame  *frame          = nullptr;
-
-  RC rc = bp->get_this_page(child_page_num, &frame);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to fetch child page. rc=%d:%s", rc, strrc(rc));
-    return rc;
-  }
-
-  IndexNodeHandler child_node(header_, frame);
-  child_node.set_parent_page_num(this->page_num());
-
-  frame->mark_dirty();
-  bp->unpin_page(frame);
-
   if (this->size() > 0) {
     memmove(__item_at(1), __item_at(0), static_cast<size_t>(this->size()) * item_size());
   }
 
-  memcpy(__item_at(0), item, item_size());
+  write_item(0, key, (const char *)&page_num);
   increase_size(1);
-  return RC::SUCCESS;
 }
 
-char *InternalIndexNodeHandler::__item_at(int index) const { return internal_node_->array + (index * item_size()); }
-
-char *InternalIndexNodeHandler::__key_at(int index) const { return __item_at(index); }
-
-char *InternalIndexNodeHandler::__value_at(int index) const { return __item_at(index) + key_size(); }
-
-int InternalIndexNodeHandler::value_size() const { return sizeof(PageNum); }
+char *InternalIndexNodeHandler::__item_at(int index) const { return item_at(index); }
 
-int InternalIndexNodeHandler::item_size() const { return key_size() + this->value_size(); }
+char *InternalIndexNodeHandler::__value_at(int index) const { return __item_at(index) + suffix_size(); }
 
-bool InternalIndexNodeHandler::validate(const KeyComparator &comparator, DiskBufferPool *bp) const
+bool InternalIndexNodeHandler::validate(bool is_root_node) const
 {
-  bool result = IndexNodeHandler::validate();
+  bool result = IndexNodeHandler::validate(is_root_node);
   if (false == result) {
     return false;
   }
 
-  const int node_size = size();
+  const int         node_size = size();
+  std::vector<char> key(key_size());
   for (int i = 2; i < node_size; i++) {
-    if (comparator(__key_at(i - 1), __key_at(i)) >= 0) {
+    get_key(i - 1, key.data());
+    if (compare_key(i, key.data()) <= 0) {
       LOG_WARN("page number = %d, invalid key order. id1=%d,id2=%d, this=%s",
           page_num(), i - 1, i, to_string(*this).c_str());
       return false;
     }
   }
 
-  for (int i = 0; result && i < node_size; i++) {
+  for (int i = 0; i < node_size; i++) {
     PageNum page_num = *(PageNum *)__value_at(i);
     if (page_num < 0) {
       LOG_WARN("this page num=%d, got invalid child page. page num=%d", this->page_num(), page_num);
-    } else {
-      Frame *child_frame;
-      RC     rc = bp->get_this_page(page_num, &child_frame);
-      if (rc != RC::SUCCESS) {
-        LOG_WARN("failed to fetch child page while validate internal page. page num=%d, rc=%d:%s", 
-                 page_num, rc, strrc(rc));
-      } else {
-        IndexNodeHandler child_node(header_, child_frame);
-        if (child_node.parent_page_num() != this->page_num()) {
-          LOG_WARN("child's parent page num is invalid. child page num=%d, parent page num=%d, this page num=%d",
-              child_node.page_num(), child_node.parent_page_num(), this->page_num());
-          result = false;
-        }
-        bp->unpin_page(child_frame);
-      }
-    }
-  }
-
-  if (!result) {
-    return result;
-  }
-
-  const PageNum parent_page_num = this->parent_page_num();
-  if (parent_page_num == BP_INVALID_PAGE_NUM) {
-    return result;
-  }
-
-  Frame *parent_frame;
-  RC     rc = bp->get_this_page(parent_page_num, &parent_frame);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to fetch parent page. page num=%d, rc=%d:%s", parent_page_num, rc, strrc(rc));
-    return false;
-  }
-
-  InternalIndexNodeHandler parent_node(header_, parent_frame);
-
-  int index_in_parent = parent_node.value_index(this->page_num());
-  if (index_in_parent < 0) {
-    LOG_WARN("invalid internal node. cannot find index in parent. this page num=%d, parent page num=%d",
-             this->page_num(), parent_page_num);
-    bp->unpin_page(parent_frame);
-    return false;
-  }
-
-  if (0 != index_in_parent) {
-    int cmp_result = comparator(__key_at(1), parent_node.key_at(index_in_parent));
-    if (cmp_result < 0) {
-      LOG_WARN("invalid internal node. the second item should be greate than or equal to parent item. "
-               "this page num=%d, parent page num=%d, index in parent=%d",
-               this->page_num(), parent_node.page_num(), index_in_parent);
-      bp->unpin_page(parent_frame);
-      return false;
-    }
-  }
-
-  if (index_in_parent < parent_node.size() - 1) {
-    int cmp_result = comparator(__key_at(size() - 1), parent_node.key_at(index_in_parent + 1));
-    if (cmp_result >= 0) {
-      LOG_WARN("invalid internal node. last item should be less than the item at the first after item in parent."
-               "this page num=%d, parent page num=%d, parent item to compare=%d",
-               this->page_num(), parent_node.page_num(), index_in_parent + 1);
-      bp->unpin_page(parent_frame);
       return false;
     }
   }
-  bp->unpin_page(parent_frame);
-
-  return result;
+  return true;
 }
 
 /////////////////////////////////////////////////////////////////////////////////
@@ -697,6 +772,17 @@ RC BplusTreeHandler::sync()
   return disk_buffer_pool_->flush_all_pages();
 }
 
+RC BplusTreeHandler::create(const char *file_name, AttrType attr_type, int attr_length, int internal_max_size /* = -1*/,
+    int leaf_max_size /* = -1 */)
+{
+  return create(file_name,
+      std::vector<AttrType>{attr_type},
+      std::vector<int>{attr_length},
+      std::vector<int>{0},
+      internal_max_size,
+      leaf_max_size);
+}
+
 RC BplusTreeHandler::create(const char *file_name, std::vector<AttrType> attr_type, std::vector<int> attr_length,
     std::vector<int> attr_offset, int internal_max_size /* = -1*/, int leaf_max_size /* = -1 */)
 {
@@ -738,11 +824,12 @@ RC BplusTreeHandler::create(const char *file_name, std::vector<AttrType> attr_ty
     length_sum += attr_length.at(i);
   }
 
+  // 没有指定时由页面大小和节点的前缀长度决定，参考 IndexNodeHandler::max_size_of
   if (internal_max_size < 0) {
-    internal_max_size = calc_internal_page_capacity(length_sum);
+    internal_max_size = 0;
   }
   if (leaf_max_size < 0) {
-    leaf_max_size = calc_leaf_page_capacity(length_sum);
+    leaf_max_size = 0;
   }
 
   char            *pdata       = header_frame->data();
@@ -761,6 +848,7 @@ RC BplusTreeHandler::create(const char *file_name, std::vector<AttrType> attr_ty
   file_header->internal_max_size = internal_max_size;
   file_header->leaf_max_size     = leaf_max_size;
   file_header->root_page         = BP_INVALID_PAGE_NUM;
+  file_header->format_version    = IndexFileHeader::CURRENT_FORMAT_VERSION;
 
   header_frame->mark_dirty();
 
@@ -783,6 +871,7 @@ RC BplusTreeHandler::create(const char *file_name, std::vector<AttrType> attr_ty
   // 不要使用栈上分配的空间，再次初始化后会出现野指针
   // key_comparator_.init(file_header->attr_type, file_header->attr_length);
   // key_printer_.init(file_header->attr_type, file_header->attr_length);
+  key_normalizer_.init(attr_type, attr_length);
   key_comparator_.init(attr_type, attr_length);
   key_printer_.init(attr_type, attr_length);
 
@@ -837,9 +926,18 @@ RC BplusTreeHandler::open(const char *file_name)
     attr_length.push_back(file_header_.attr_length[i]);
   }
 
+  key_normalizer_.init(attr_type, attr_length);
   key_comparator_.init(attr_type, attr_length);
   key_printer_.init(attr_type, attr_length);
-  // key_comparator_.set_field_meta(field_meta_);
+
+  if (file_header_.format_version < IndexFileHeader::CURRENT_FORMAT_VERSION) {
+    rc = upgrade_node_format();
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to upgrade index file format. file name=%s, rc=%s", file_name, strrc(rc));
+      close();
+      return rc;
+    }
+  }
 
   // 存在问题：不能读取file_header_.attr_type与file_header_.attr_length这两块内存，否则直接segmentation fault
   // key_comparator_.init(file_header_.attr_type, file_header_.attr_length);
@@ -848,6 +946,88 @@ RC BplusTreeHandler::open(const char *file_name)
   return RC::SUCCESS;
 }
 
+RC BplusTreeHandler::upgrade_node_format()
+{
+  const int32_t old_version = file_header_.format_version;
+
+  // 版本0的节点页头中，key_num 后面是4个字节的父节点页号，去掉之后后面的内容整体往前移动
+  const int old_node_header_size = IndexNode::HEADER_SIZE + (old_version < 1 ? static_cast<int>(sizeof(PageNum)) : 0);
+
+  BufferPoolIterator bp_iterator;
+  RC                 rc = bp_iterator.init(*disk_buffer_pool_, FIRST_INDEX_PAGE);  // 从文件头后面的页面开始
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init buffer pool iterator. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  const int attr_length = key_normalizer_.attr_length();
+  int       page_count  = 0;
+  while (bp_iterator.has_next()) {
+    const PageNum page_num = bp_iterator.next();
+
+    Frame *frame = nullptr;
+    rc           = disk_buffer_pool_->get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to fetch index page. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    char *data = frame->data();
+    if (old_node_header_size != IndexNode::HEADER_SIZE) {
+      memmove(data + IndexNode::HEADER_SIZE, data + old_node_header_size, BP_PAGE_DATA_SIZE - old_node_header_size);
+    }
+
+    // 老版本中键值是字段的原始内容加上RID，原地转换成规范化编码。老版本的节点都没有前缀
+    IndexNode *node     = reinterpret_cast<IndexNode *>(data);
+    node->prefix_length = 0;
+
+    IndexNodeHandler node_handler(file_header_, frame);
+    const int        item_size = node_handler.item_size();
+    char *items = data + (node_handler.is_leaf() ? LeafIndexNode::HEADER_SIZE : InternalIndexNode::HEADER_SIZE);
+    for (int i = 0; i < node_handler.size(); i++) {
+      char *key = items + i * item_size;
+      RID   rid;
+      memcpy(&rid, key + attr_length, sizeof(rid));
+      key_normalizer_.normalize(key, rid, key);
+    }
+
+    frame->mark_dirty();
+    disk_buffer_pool_->unpin_page(frame);
+    page_count++;
+  }
+
+  // 先把所有节点写到磁盘，再修改文件头中的版本号
+  rc = disk_buffer_pool_->flush_all_pages();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to flush index pages. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  // 老版本的文件头中总是保存按照页面大小计算出来的最大值，改成由节点的前缀长度决定
+  auto old_capacity = [&](int header_size, int value_size) {
+    return ((int)BP_PAGE_DATA_SIZE - header_size - (old_node_header_size - IndexNode::HEADER_SIZE)) /
+           (file_header_.key_length + value_size);
+  };
+  if (file_header_.internal_max_size == old_capacity(InternalIndexNode::HEADER_SIZE, sizeof(PageNum))) {
+    file_header_.internal_max_size = 0;
+  }
+  if (file_header_.leaf_max_size == old_capacity(LeafIndexNode::HEADER_SIZE, sizeof(RID))) {
+    file_header_.leaf_max_size = 0;
+  }
+
+  file_header_.format_version = IndexFileHeader::CURRENT_FORMAT_VERSION;
+  header_dirty_               = true;
+  rc                          = sync();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to sync index file header. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  LOG_INFO("upgrade index file format done. page count=%d, format version %d -> %d",
+           page_count, old_version, file_header_.format_version);
+  return rc;
+}
+
 RC BplusTreeHandler::close()
 {
   if (disk_buffer_pool_ != nullptr) {
@@ -966,27 +1146,77 @@ RC BplusTreeHandler::print_leafs()
   return rc;
 }
 
-bool BplusTreeHandler::validate_node_recursive(LatchMemo &latch_memo, Frame *frame)
+bool BplusTreeHandler::validate_node_recursive(
+    LatchMemo &latch_memo, Frame *frame, bool is_root_node, const char *lower_key, const char *upper_key)
 {
   bool             result = true;
   IndexNodeHandler node(file_header_, frame);
+
+  // 前缀必须是两个边界键值的公共前缀，没有边界的节点不能有前缀
+  const int prefix_length = node.prefix_length();
+  if (prefix_length > 0 &&
+      (lower_key == nullptr || upper_key == nullptr || memcmp(node.prefix(), lower_key, prefix_length) != 0 ||
+          memcmp(node.prefix(), upper_key, prefix_length) != 0)) {
+    LOG_WARN("invalid node prefix. page num=%d, prefix length=%d", node.page_num(), prefix_length);
+    return false;
+  }
+
   if (node.is_leaf()) {
     LeafIndexNodeHandler leaf_node(file_header_, frame);
-    result = leaf_node.validate(key_comparator_, disk_buffer_pool_);
+    result = leaf_node.validate(is_root_node);
+    if (result && leaf_node.size() > 0) {
+      if (lower_key != nullptr && leaf_node.compare_key(0, lower_key) < 0) {
+        LOG_WARN("invalid leaf node. first item should be greate than or equal to parent item. page num=%d",
+                 leaf_node.page_num());
+        result = false;
+      } else if (upper_key != nullptr && leaf_node.compare_key(leaf_node.size() - 1, upper_key) >= 0) {
+        LOG_WARN("invalid leaf node. last item should be less than the next item in parent. page num=%d",
+                 leaf_node.page_num());
+        result = false;
+      }
+    }
   } else {
     InternalIndexNodeHandler internal_node(file_header_, frame);
-    result = internal_node.validate(key_comparator_, disk_buffer_pool_);
+    result = internal_node.validate(is_root_node);
+    if (result && internal_node.size() > 1) {
+      // 内部节点的第一个键值是无效的
+      if (lower_key != nullptr && internal_node.compare_key(1, lower_key) < 0) {
+        LOG_WARN("invalid internal node. the second item should be greate than or equal to parent item. page num=%d",
+                 internal_node.page_num());
+        result = false;
+      } else if (upper_key != nullptr && internal_node.compare_key(internal_node.size() - 1, upper_key) >= 0) {
+        LOG_WARN("invalid internal node. last item should be less than the next item in parent. page num=%d",
+                 internal_node.page_num());
+        result = false;
+      }
+    }
+
+    MemPoolItem::unique_ptr child_lower = mem_pool_item_->alloc_unique_ptr();
+    MemPoolItem::unique_ptr child_upper = mem_pool_item_->alloc_unique_ptr();
     for (int i = 0; result && i < internal_node.size(); i++) {
+      // 子节点检查完就释放，整棵树可能比缓冲池大，不能把所有页面都 pin 在内存中
       PageNum page_num = internal_node.value_at(i);
       Frame  *child_frame;
-      RC      rc = latch_memo.get_page(page_num, child_frame);
+      RC      rc = disk_buffer_pool_->get_this_page(page_num, &child_frame);
       if (rc != RC::SUCCESS) {
         LOG_WARN("failed to fetch child page.page id=%d, rc=%d:%s", page_num, rc, strrc(rc));
         result = false;
         break;
       }
 
-      result = validate_node_recursive(latch_memo, child_frame);
+      // 子节点中的键值范围由父节点中相邻的两个键值决定
+      const char *child_lower_key = lower_key;
+      const char *child_upper_key = upper_key;
+      if (i > 0) {
+        internal_node.get_key(i, static_cast<char *>(child_lower.get()));
+        child_lower_key = static_cast<const char *>(child_lower.get());
+      }
+      if (i < internal_node.size() - 1) {
+        internal_node.get_key(i + 1, static_cast<char *>(child_upper.get()));
+        child_upper_key = static_cast<const char *>(child_upper.get());
+      }
+      result = validate_node_recursive(latch_memo, child_frame, false /*is_root_node*/, child_lower_key, child_upper_key);
+      disk_buffer_pool_->unpin_page(child_frame);
     }
   }
 
@@ -1010,25 +1240,33 @@ bool BplusTreeHandler::validate_leaf_link(LatchMemo &latch_memo)
   LeafIndexNodeHandler leaf_node(file_header_, frame);
   PageNum              next_page_num = leaf_node.next_page();
 
-  MemPoolItem::unique_ptr prev_key = mem_pool_item_->alloc_unique_ptr();
-  memcpy(prev_key.get(), leaf_node.key_at(leaf_node.size() - 1), file_header_.key_length);
+  // 叶子节点在合并失败时可能是空的，prev_key 记录遇到的最后一个键值
+  MemPoolItem::unique_ptr prev_key     = mem_pool_item_->alloc_unique_ptr();
+  bool                    has_prev_key = leaf_node.size() > 0;
+  if (has_prev_key) {
+    leaf_node.get_key(leaf_node.size() - 1, static_cast<char *>(prev_key.get()));
+  }
 
   bool result = true;
   while (result && next_page_num != BP_INVALID_PAGE_NUM) {
-    rc = latch_memo.get_page(next_page_num, frame);
+    rc = disk_buffer_pool_->get_this_page(next_page_num, &frame);
     if (rc != RC::SUCCESS) {
       LOG_WARN("failed to fetch next page. page num=%d, rc=%s", next_page_num, strrc(rc));
       return false;
     }
 
     LeafIndexNodeHandler leaf_node(file_header_, frame);
-    if (key_comparator_((char *)prev_key.get(), leaf_node.key_at(0)) >= 0) {
+    if (has_prev_key && leaf_node.size() > 0 && leaf_node.compare_key(0, (char *)prev_key.get()) <= 0) {
       LOG_WARN("invalid page. current first key is not bigger than last");
       result = false;
     }
 
     next_page_num = leaf_node.next_page();
-    memcpy(prev_key.get(), leaf_node.key_at(leaf_node.size() - 1), file_header_.key_length);
+    if (leaf_node.size() > 0) {
+      leaf_node.get_key(leaf_node.size() - 1, static_cast<char *>(prev_key.get()));
+      has_prev_key = true;
+    }
+    disk_buffer_pool_->unpin_page(frame);  // 叶子节点可能比缓冲池还多，检查完一个就释放一个
   }
 
   // can do more things
@@ -1049,7 +1287,8 @@ bool BplusTreeHandler::validate_tree()
     return false;
   }
 
-  if (!validate_node_recursive(latch_memo, frame) || !validate_leaf_link(latch_memo)) {
+  if (!validate_node_recursive(latch_memo, frame, true /*is_root_node*/, nullptr, nullptr) ||
+      !validate_leaf_link(latch_memo)) {
     LOG_WARN("Current B+ Tree is invalid");
     print_tree();
     return false;
@@ -1064,14 +1303,30 @@ bool BplusTreeHandler::is_empty() const { return file_header_.root_page == BP_IN
 RC BplusTreeHandler::find_leaf(LatchMemo &latch_memo, BplusTreeOperationType op, const char *key, Frame *&frame)
 {
   auto child_page_getter = [this, key](InternalIndexNodeHandler &internal_node) {
-    return internal_node.value_at(internal_node.lookup(key_comparator_, key));
+    return internal_node.value_at(internal_node.lookup(key));
   };
   return find_leaf_internal(latch_memo, op, child_page_getter, frame);
 }
 
-RC BplusTreeHandler::left_most_page(LatchMemo &latch_memo, Frame *&frame)
+RC BplusTreeHandler::find_leaf_with_upper_key(LatchMemo &latch_memo, BplusTreeOperationType op, const char *key,
+    Frame *&frame, char *upper_key, bool &has_upper_key)
 {
-  auto child_page_getter = [](InternalIndexNodeHandler &internal_node) { return internal_node.value_at(0); };
+  // 越靠下的分隔键值越小，子节点是父节点中最后一个时上界沿用上一层的
+  has_upper_key          = false;
+  auto child_page_getter = [this, key, upper_key, &has_upper_key](InternalIndexNodeHandler &internal_node) {
+    const int index = internal_node.lookup(key);
+    if (index + 1 < internal_node.size()) {
+      internal_node.get_key(index + 1, upper_key);
+      has_upper_key = true;
+    }
+    return internal_node.value_at(index);
+  };
+  return find_leaf_internal(latch_memo, op, child_page_getter, frame);
+}
+
+RC BplusTreeHandler::left_most_page(LatchMemo &latch_memo, Frame *&frame)
+{
+  auto child_page_getter = [](InternalIndexNodeHandler &internal_node) { return internal_node.value_at(0); };
   return find_leaf_internal(latch_memo, BplusTreeOperationType::READ, child_page_getter, frame);
 }
 
@@ -1125,6 +1380,7 @@ RC BplusTreeHandler::crabing_protocal_fetch_page(
 
   LatchMemoType latch_type = readonly ? LatchMemoType::SHARED : LatchMemoType::EXCLUSIVE;
   latch_memo.latch(frame, latch_type);
+  latch_memo.push_path(frame);
   IndexNodeHandler index_node(file_header_, frame);
   if (index_node.is_safe(op, is_root_node)) {
     latch_memo.release_to(memo_point);  // 当前节点不会分裂或合并，可以将前面的锁都释放掉
@@ -1132,16 +1388,171 @@ RC BplusTreeHandler::crabing_protocal_fetch_page(
   return rc;
 }
 
+RC BplusTreeHandler::optimistic_find_leaf(
+    const char *key, Frame *&frame, uint64_t &version, std::vector<PageNum> *next_leaves, int max_next_leaves)
+{
+  for (int restart_count = 0;; restart_count++) {
+    bool restart = false;
+    RC   rc      = optimistic_find_leaf_once(key, frame, version, restart, next_leaves, max_next_leaves);
+    if (!restart) {
+      return rc;
+    }
+
+    // 有写者正在修改，多次重试失败后让出CPU，避免和写者争抢
+    if (restart_count >= 8) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+RC BplusTreeHandler::optimistic_find_prev_leaf(
+    const char *key, Frame *&frame, uint64_t &version, char *low_key, bool &has_low_key)
+{
+  for (int restart_count = 0;; restart_count++) {
+    bool restart = false;
+    RC   rc      = optimistic_find_leaf_once(key, frame, version, restart, nullptr, 0, low_key, &has_low_key);
+    if (!restart) {
+      return rc;
+    }
+
+    if (restart_count >= 8) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+RC BplusTreeHandler::optimistic_find_leaf_once(const char *key, Frame *&frame, uint64_t &version, bool &restart,
+    std::vector<PageNum> *next_leaves, int max_next_leaves, char *low_key, bool *has_low_key)
+{
+  restart = false;
+  if (next_leaves != nullptr) {
+    next_leaves->clear();
+  }
+  if (has_low_key != nullptr) {
+    *has_low_key = false;
+  }
+
+  const uint64_t root_version = root_version_.load(std::memory_order_acquire);
+  if (root_version & 1) {
+    restart = true;
+    return RC::SUCCESS;
+  }
+
+  const PageNum root_page = file_header_.root_page;
+  if (root_page == BP_INVALID_PAGE_NUM) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    restart = root_version_.load(std::memory_order_relaxed) != root_version;
+    return RC::EMPTY;
+  }
+
+  Frame *current = nullptr;
+  RC     rc      = disk_buffer_pool_->get_this_page(root_page, &current);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to fetch root page. page num=%d, rc=%s", root_page, strrc(rc));
+    return rc;
+  }
+
+  // 拿到根节点的版本号之后，根节点的页号依然没有变化，才说明这个页面确实是根节点
+  uint64_t current_version = current->version();
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if ((current_version & 1) || root_version_.load(std::memory_order_relaxed) != root_version) {
+    disk_buffer_pool_->unpin_page(current);
+    restart = true;
+    return RC::SUCCESS;
+  }
+
+  char page_copy[BP_PAGE_DATA_SIZE];
+  while (true) {
+    IndexNode *node    = (IndexNode *)current->data();
+    const bool is_leaf = node->is_leaf;
+    if (!current->validate_version(current_version)) {
+      break;
+    }
+
+    if (is_leaf) {
+      frame   = current;
+      version = current_version;
+      return RC::SUCCESS;
+    }
+
+    // 页面可能正在被修改，先复制出来，确认复制的内容是一致的之后再查找子节点
+    memcpy(page_copy, current->data(), InternalIndexNodeHandler(file_header_, current).used_bytes());
+    if (!current->validate_version(current_version)) {
+      break;
+    }
+
+    InternalIndexNodeHandler internal_node(file_header_, current->page_num(), page_copy);
+    int                      child_index = 0;
+    if (low_key == nullptr) {
+      child_index = key == nullptr ? 0 : internal_node.lookup(key);
+    } else {
+      // 逆序查找时，子节点的分隔键值等于 key 说明这个子节点中的项都不小于 key，要找前一个子节点
+      bool found  = false;
+      child_index = key == nullptr ? std::max(internal_node.size() - 1, 0) : internal_node.lookup(key, &found);
+      if (found) {
+        child_index--;
+      }
+      if (child_index > 0) {
+        internal_node.get_key(child_index, low_key);
+        *has_low_key = true;
+      }
+    }
+    const PageNum child_page = internal_node.value_at(child_index);
+
+    // 每一层都覆盖掉上一层的结果，最后留下的就是叶子节点的父节点中的兄弟节点
+    if (next_leaves != nullptr) {
+      next_leaves->clear();
+      const int last = std::min(internal_node.size(), child_index + 1 + max_next_leaves);
+      for (int i = child_index + 1; i < last; i++) {
+        next_leaves->push_back(internal_node.value_at(i));
+      }
+    }
+
+    Frame *child = nullptr;
+    rc           = disk_buffer_pool_->get_this_page(child_page, &child);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to fetch page. page num=%d, rc=%s", child_page, strrc(rc));
+      disk_buffer_pool_->unpin_page(current);
+      return rc;
+    }
+
+    // 拿到子节点的版本号之后父节点依然没有变化，子节点才是从父节点可达的
+    const uint64_t child_version = child->version();
+    if ((child_version & 1) || !current->validate_version(current_version)) {
+      disk_buffer_pool_->unpin_page(child);
+      break;
+    }
+
+    disk_buffer_pool_->unpin_page(current);
+    current         = child;
+    current_version = child_version;
+  }
+
+  disk_buffer_pool_->unpin_page(current);
+  restart = true;
+  return RC::SUCCESS;
+}
+
 // unique-index core section
 RC BplusTreeHandler::insert_entry_into_leaf_node(LatchMemo &latch_memo, Frame *frame, const char *key, const RID *rid)
 {
   LeafIndexNodeHandler leaf_node(file_header_, frame);
-  bool                 exists = false;  // 该数据是否已经存在指定的叶子节点中了
-  LOG_DEBUG("[[[I'm Here Here Here Here]]]");
-  int insert_position = leaf_node.lookup(key_comparator_, key, &exists, is_unique_);
-  if (is_unique_ == 1 && exists) {
+  bool                 exists          = false;  // 该数据是否已经存在指定的叶子节点中了
+  int                  insert_position = leaf_node.lookup(key, &exists);
+  if (exists) {
+    // 键值和RID都相同，说明是同一条记录，比如恢复时重复插入
     LOG_TRACE("entry exists");
-    return RC::RECORD_DUPLICATE_KEY;
+    return RC::SUCCESS;
+  }
+
+  // 键值按照字段值和RID排序，字段值相同的项一定在插入位置的两边
+  if (is_unique_ == 1) {
+    const int attr_length = key_comparator_.attr_comparator().attr_length();
+    if ((insert_position < leaf_node.size() && leaf_node.compare_key(insert_position, key, attr_length) == 0) ||
+        (insert_position > 0 && leaf_node.compare_key(insert_position - 1, key, attr_length) == 0)) {
+      LOG_TRACE("entry exists");
+      return RC::RECORD_DUPLICATE_KEY;
+    }
   }
 
   if (leaf_node.size() < leaf_node.max_size()) {
@@ -1160,7 +1571,6 @@ RC BplusTreeHandler::insert_entry_into_leaf_node(LatchMemo &latch_memo, Frame *f
 
   LeafIndexNodeHandler new_index_node(file_header_, new_frame);
   new_index_node.set_next_page(leaf_node.next_page());
-  new_index_node.set_parent_page_num(leaf_node.parent_page_num());
   leaf_node.set_next_page(new_frame->page_num());
 
   if (insert_position < leaf_node.size()) {
@@ -1169,18 +1579,24 @@ RC BplusTreeHandler::insert_entry_into_leaf_node(LatchMemo &latch_memo, Frame *f
     new_index_node.insert(insert_position - leaf_node.size(), key, (const char *)rid);
   }
 
-  return insert_entry_into_parent(latch_memo, frame, new_frame, new_index_node.key_at(0));
+  // 插入父节点时会修改节点的前缀，先把键值复制出来
+  MemPoolItem::unique_ptr new_key = mem_pool_item_->alloc_unique_ptr();
+  new_index_node.get_key(0, static_cast<char *>(new_key.get()));
+  return insert_entry_into_parent(latch_memo, frame, new_frame, static_cast<const char *>(new_key.get()));
 }
 
 RC BplusTreeHandler::insert_entry_into_parent(LatchMemo &latch_memo, Frame *frame, Frame *new_frame, const char *key)
 {
   RC rc = RC::SUCCESS;
 
-  IndexNodeHandler node_handler(file_header_, frame);
-  IndexNodeHandler new_node_handler(file_header_, new_frame);
-  PageNum          parent_page_num = node_handler.parent_page_num();
+  // 节点中没有父节点的页号，从查找路径中获取。需要分裂的节点一定是不安全的，它的父节点的锁不会提前释放
+  Frame *parent_frame = latch_memo.parent_of(frame);
+  if (parent_frame == nullptr && frame->page_num() != file_header_.root_page) {
+    LOG_WARN("cannot find parent in latch memo. page num=%d, root page=%d", frame->page_num(), file_header_.root_page);
+    return RC::INTERNAL;
+  }
 
-  if (parent_page_num == BP_INVALID_PAGE_NUM) {
+  if (parent_frame == nullptr) {
 
     // create new root page
     Frame *root_frame;
@@ -1193,8 +1609,6 @@ RC BplusTreeHandler::insert_entry_into_parent(LatchMemo &latch_memo, Frame *fram
     InternalIndexNodeHandler root_node(file_header_, root_frame);
     root_node.init_empty();
     root_node.create_new_root(frame->page_num(), key, new_frame->page_num());
-    node_handler.set_parent_page_num(root_frame->page_num());
-    new_node_handler.set_parent_page_num(root_frame->page_num());
 
     frame->mark_dirty();
     new_frame->mark_dirty();
@@ -1211,22 +1625,19 @@ RC BplusTreeHandler::insert_entry_into_parent(LatchMemo &latch_memo, Frame *fram
 
   } else {
 
-    Frame *parent_frame = nullptr;
-
-    rc = latch_memo.get_page(parent_page_num, parent_frame);
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to insert entry into leaf. rc=%d:%s", rc, strrc(rc));
-      // we should do some things to recover
-      return rc;
-    }
-
     // 在第一次遍历这个页面时，我们已经拿到parent frame的write latch，所以这里不再去加锁
     InternalIndexNodeHandler parent_node(file_header_, parent_frame);
 
+    const int index = parent_node.value_index(frame->page_num());
+    if (index < 0) {
+      LOG_WARN("cannot find child in parent. page num=%d, parent page num=%d", frame->page_num(), parent_frame->page_num());
+      return RC::INTERNAL;
+    }
+    extend_split_prefix(parent_node, index, frame, new_frame, key);
+
     /// 当前这个父节点还没有满，直接将新节点数据插进入就行了
     if (parent_node.size() < parent_node.max_size()) {
-      parent_node.insert(key, new_frame->page_num(), key_comparator_);
-      new_node_handler.set_parent_page_num(parent_page_num);
+      parent_node.insert(key, new_frame->page_num());
 
       frame->mark_dirty();
       new_frame->mark_dirty();
@@ -1249,12 +1660,10 @@ RC BplusTreeHandler::insert_entry_into_parent(LatchMemo &latch_memo, Frame *fram
       } else {
         // insert into left or right ? decide by key compare result
         InternalIndexNodeHandler new_node(file_header_, new_parent_frame);
-        if (key_comparator_(key, new_node.key_at(0)) > 0) {
-          new_node.insert(key, new_frame->page_num(), key_comparator_);
-          new_node_handler.set_parent_page_num(new_node.page_num());
+        if (new_node.compare_key(0, key) < 0) {
+          new_node.insert(key, new_frame->page_num());
         } else {
-          parent_node.insert(key, new_frame->page_num(), key_comparator_);
-          new_node_handler.set_parent_page_num(parent_node.page_num());
+          parent_node.insert(key, new_frame->page_num());
         }
 
         // disk_buffer_pool_->unpin_page(frame);
@@ -1263,13 +1672,43 @@ RC BplusTreeHandler::insert_entry_into_parent(LatchMemo &latch_memo, Frame *fram
         // 虽然这里是递归调用，但是通常B+ Tree 的层高比较低（3层已经可以容纳很多数据），所以没有栈溢出风险。
         // Q: 在查找叶子节点时，我们都会尝试将没必要的锁提前释放掉，在这里插入数据时，是在向上遍历节点，
         //    理论上来说，我们可以释放更低层级节点的锁，但是并没有这么做，为什么？
-        rc = insert_entry_into_parent(latch_memo, parent_frame, new_parent_frame, new_node.key_at(0));
+        MemPoolItem::unique_ptr new_key = mem_pool_item_->alloc_unique_ptr();
+        new_node.get_key(0, static_cast<char *>(new_key.get()));
+        rc = insert_entry_into_parent(
+            latch_memo, parent_frame, new_parent_frame, static_cast<const char *>(new_key.get()));
       }
     }
   }
   return rc;
 }
 
+void BplusTreeHandler::extend_split_prefix(
+    InternalIndexNodeHandler &parent_node, int index, Frame *frame, Frame *new_frame, const char *key)
+{
+  // 分裂之前节点的范围是 [key(index), key(index+1))，分裂之后左边是 [key(index), key)，右边是 [key, key(index+1))
+  // 没有边界的一边保持原来的前缀不变
+  IndexNodeHandler left_node(file_header_, frame);
+  IndexNodeHandler right_node(file_header_, new_frame);
+
+  const int key_length = file_header_.key_length;
+  std::vector<char> fence_key(key_length);
+  if (index > 0) {
+    parent_node.get_key(index, fence_key.data());
+    const int prefix_length = IndexNodeHandler::common_prefix_length(fence_key.data(), key, key_length);
+    if (prefix_length > left_node.prefix_length()) {
+      left_node.set_prefix(key, prefix_length);
+    }
+  }
+
+  if (index + 1 < parent_node.size()) {
+    parent_node.get_key(index + 1, fence_key.data());
+    const int prefix_length = IndexNodeHandler::common_prefix_length(key, fence_key.data(), key_length);
+    if (prefix_length > right_node.prefix_length()) {
+      right_node.set_prefix(key, prefix_length);
+    }
+  }
+}
+
 /**
  * split one full node into two
  */
@@ -1289,9 +1728,8 @@ RC BplusTreeHandler::split(LatchMemo &latch_memo, Frame *frame, Frame *&new_fram
 
   IndexNodeHandlerType new_node(file_header_, new_frame);
   new_node.init_empty();
-  new_node.set_parent_page_num(old_node.parent_page_num());
 
-  old_node.move_half_to(new_node, disk_buffer_pool_);  // TODO remove disk buffer pool
+  old_node.move_half_to(new_node);
 
   frame->mark_dirty();
   new_frame->mark_dirty();
@@ -1300,7 +1738,9 @@ RC BplusTreeHandler::split(LatchMemo &latch_memo, Frame *frame, Frame *&new_fram
 
 void BplusTreeHandler::update_root_page_num_locked(PageNum root_page_num)
 {
+  root_version_.fetch_add(1, std::memory_order_acq_rel);
   file_header_.root_page = root_page_num;
+  root_version_.fetch_add(1, std::memory_order_release);
   header_dirty_          = true;
   LOG_DEBUG("set root page to %d", root_page_num);
 }
@@ -1333,6 +1773,253 @@ RC BplusTreeHandler::create_new_tree(const char *key, const RID *rid)
   return rc;
 }
 
+/**
+ * @brief 批量构建B+树时某一层的输入
+ * @ingroup BPlusTree
+ * @details 输入是按顺序排列的键值和对应的值(叶子节点是RID，内部节点是子节点的页号)，由 producer 逐个产生。
+ * 窗口中只保留决定下一个节点放多少项时需要看到的那些项。
+ */
+class BplusTreeBulkLoadWindow
+{
+public:
+  /// 返回下一项，没有更多的数据时返回 RECORD_EOF。返回的内存在下一次调用之前有效
+  using Producer = std::function<RC(const char *&key, const char *&value)>;
+
+  BplusTreeBulkLoadWindow(int key_size, int value_size, Producer producer)
+      : key_size_(key_size), item_size_(key_size + value_size), producer_(std::move(producer))
+  {}
+
+  /**
+   * @brief 让窗口中至少有 count 项，数据不够时有多少放多少
+   */
+  RC fill(int count)
+  {
+    while (size_ < count && !exhausted_) {
+      const char *key   = nullptr;
+      const char *value = nullptr;
+
+      RC rc = producer_(key, value);
+      if (rc == RC::RECORD_EOF) {
+        exhausted_ = true;
+        break;
+      }
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+
+      items_.resize(items_.size() + item_size_);
+      char *item = items_.data() + items_.size() - item_size_;
+      memcpy(item, key, key_size_);
+      memcpy(item + key_size_, value, item_size_ - key_size_);
+      size_++;
+    }
+    return RC::SUCCESS;
+  }
+
+  int         size() const { return size_; }
+  bool        exhausted() const { return exhausted_; }
+  const char *key(int index) const { return items_.data() + start_ + static_cast<size_t>(index) * item_size_; }
+  const char *value(int index) const { return key(index) + key_size_; }
+
+  void pop(int count)
+  {
+    start_ += static_cast<size_t>(count) * item_size_;
+    size_ -= count;
+    if (start_ * 2 >= items_.size()) {
+      items_.erase(items_.begin(), items_.begin() + start_);
+      start_ = 0;
+    }
+  }
+
+private:
+  const int         key_size_;
+  const int         item_size_;
+  Producer          producer_;
+  std::vector<char> items_;
+  size_t            start_     = 0;
+  int               size_      = 0;
+  bool              exhausted_ = false;
+};
+
+RC BplusTreeHandler::bulk_load(BplusTreeKeySorter &sorter, int fill_factor)
+{
+  if (!is_empty()) {
+    LOG_WARN("cannot bulk load into a non-empty tree. root page=%d", file_header_.root_page);
+    return RC::INTERNAL;
+  }
+  if (sorter.key_length() != file_header_.key_length) {
+    LOG_WARN("key length mismatch. sorter=%d, tree=%d", sorter.key_length(), file_header_.key_length);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  fill_factor = std::clamp(fill_factor, 50, 100);
+
+  // 叶子节点的输入来自排好序的键值。唯一索引中相邻的两个键值字段值相同就是重复的
+  const int         attr_length = key_normalizer_.attr_length();
+  std::vector<char> last_key;
+  RID               rid;
+  auto leaf_producer = [this, &sorter, &last_key, &rid, attr_length](const char *&key, const char *&value) {
+    RC rc = sorter.next(key);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    if (is_unique_ == 1 && !last_key.empty() && memcmp(last_key.data(), key, attr_length) == 0) {
+      LOG_WARN("duplicate key found while building unique index");
+      return RC::RECORD_DUPLICATE_KEY;
+    }
+    last_key.assign(key, key + file_header_.key_length);
+    rid   = key_normalizer_.rid(key);
+    value = reinterpret_cast<const char *>(&rid);
+    return RC::SUCCESS;
+  };
+
+  std::vector<char>    keys;
+  std::vector<PageNum> pages;
+
+  BplusTreeBulkLoadWindow leaf_window(file_header_.key_length, sizeof(RID), leaf_producer);
+  RC                      rc = bulk_load_level(true /*leaf*/, leaf_window, fill_factor, keys, pages);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to build leaf level. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  int levels = 1;
+  while (pages.size() > 1) {
+    std::vector<char>    child_keys;
+    std::vector<PageNum> child_pages;
+    child_keys.swap(keys);
+    child_pages.swap(pages);
+
+    size_t index          = 0;
+    auto   child_producer = [this, &child_keys, &child_pages, &index](const char *&key, const char *&value) {
+      if (index >= child_pages.size()) {
+        return RC::RECORD_EOF;
+      }
+      key   = child_keys.data() + index * file_header_.key_length;
+      value = reinterpret_cast<const char *>(&child_pages[index]);
+      index++;
+      return RC::SUCCESS;
+    };
+
+    BplusTreeBulkLoadWindow window(file_header_.key_length, sizeof(PageNum), child_producer);
+    rc = bulk_load_level(false /*leaf*/, window, fill_factor, keys, pages);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to build internal level. level=%d, rc=%s", levels, strrc(rc));
+      return rc;
+    }
+    levels++;
+  }
+
+  if (!pages.empty()) {
+    update_root_page_num_locked(pages.front());
+  }
+
+  LOG_INFO("bulk loaded bplus tree. keys=%" PRId64 ", levels=%d, fill factor=%d",
+      sorter.count(), pages.empty() ? 0 : levels, fill_factor);
+  return sync();
+}
+
+RC BplusTreeHandler::bulk_load_level(bool leaf, BplusTreeBulkLoadWindow &window, int fill_factor,
+    std::vector<char> &parent_keys, std::vector<PageNum> &parent_pages)
+{
+  const int key_size = file_header_.key_length;
+  auto      capacity = [this, leaf, fill_factor](int prefix_length) {
+    return std::max(2, IndexNodeHandler::max_size_of(file_header_, leaf, prefix_length) * fill_factor / 100);
+  };
+
+  RC     rc         = RC::SUCCESS;
+  Frame *prev_frame = nullptr;  // 上一个叶子节点，等到下一个叶子节点分配之后才知道它的 next_page
+  bool   first_node = true;
+  while (OB_SUCC(rc)) {
+    const int base_capacity = capacity(0);
+    rc                      = window.fill(base_capacity + 1);
+    if (OB_FAIL(rc) || window.size() == 0) {
+      break;
+    }
+
+    // 节点的前缀必须是两侧边界键值的公共前缀。这一层的边界就是每个节点的第一个键值，
+    // 最左边的节点没有下界，最后一个节点没有上界，它们都不能有前缀
+    int count         = window.size();
+    int prefix_length = 0;
+    if (count > base_capacity) {
+      count = base_capacity;
+      if (!first_node) {
+        prefix_length = IndexNodeHandler::common_prefix_length(window.key(0), window.key(count), key_size);
+
+        // 有了前缀之后一个节点能放更多的项，试着多放一些，只要前缀缩短后依然放得下
+        const int larger_count = capacity(prefix_length);
+        rc                     = window.fill(larger_count + 1);
+        if (OB_FAIL(rc)) {
+          break;
+        }
+        if (larger_count > count && larger_count < window.size()) {
+          const int larger_prefix =
+              IndexNodeHandler::common_prefix_length(window.key(0), window.key(larger_count), key_size);
+          if (capacity(larger_prefix) >= larger_count) {
+            count         = larger_count;
+            prefix_length = larger_prefix;
+          }
+        }
+      }
+
+      // 不要让最后一个节点只剩下一项，内部节点至少要有两个孩子
+      if (window.exhausted() && window.size() - count == 1) {
+        count--;
+        if (prefix_length > 0) {
+          prefix_length = IndexNodeHandler::common_prefix_length(window.key(0), window.key(count), key_size);
+        }
+      }
+    }
+
+    Frame *frame = nullptr;
+    rc           = disk_buffer_pool_->allocate_page(&frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate page while bulk loading. rc=%s", strrc(rc));
+      break;
+    }
+
+    if (leaf) {
+      LeafIndexNodeHandler node(file_header_, frame);
+      node.init_empty();
+      node.set_prefix(window.key(0), prefix_length);
+      for (int i = 0; i < count; i++) {
+        node.append_item(window.key(i), window.value(i));
+      }
+    } else {
+      InternalIndexNodeHandler node(file_header_, frame);
+      node.init_empty();
+      node.set_prefix(window.key(0), prefix_length);
+      for (int i = 0; i < count; i++) {
+        node.append_item(window.key(i), window.value(i));
+      }
+    }
+    frame->mark_dirty();
+
+    parent_keys.insert(parent_keys.end(), window.key(0), window.key(0) + key_size);
+    parent_pages.push_back(frame->page_num());
+    window.pop(count);
+    first_node = false;
+
+    if (!leaf) {
+      disk_buffer_pool_->unpin_page(frame);
+      continue;
+    }
+
+    if (prev_frame != nullptr) {
+      LeafIndexNodeHandler prev_node(file_header_, prev_frame);
+      prev_node.set_next_page(frame->page_num());
+      prev_frame->mark_dirty();
+      disk_buffer_pool_->unpin_page(prev_frame);
+    }
+    prev_frame = frame;
+  }
+
+  if (prev_frame != nullptr) {
+    disk_buffer_pool_->unpin_page(prev_frame);
+  }
+  return rc;
+}
+
 MemPoolItem::unique_ptr BplusTreeHandler::make_key(const char *user_key, const RID &rid)
 {
   MemPoolItem::unique_ptr pkey = mem_pool_item_->alloc_unique_ptr();
@@ -1340,16 +2027,7 @@ MemPoolItem::unique_ptr BplusTreeHandler::make_key(const char *user_key, const R
     LOG_WARN("Failed to alloc memory for key.");
     return nullptr;
   }
-  char *key = static_cast<char *>(pkey.get());
-  // memcpy(static_cast<char *>(key.get()), user_key, file_header_.attr_length);
-  // memcpy(static_cast<char *>(key.get()) + file_header_.attr_length, &rid, sizeof(rid));
-  int pos = 0;
-  for (int i = 0; i < file_header_.attr_num; i++) {
-    // 存在问题：不能读取file_header_.attr_type与file_header_.attr_length这两块内存，否则直接segmentation fault
-    memcpy(key + pos, user_key + pos, file_header_.attr_length[i]);
-    pos += file_header_.attr_length[i];
-  }
-  memcpy(key + pos, &rid, sizeof(rid));
+  key_normalizer_.normalize(user_key, rid, static_cast<char *>(pkey.get()));
   return pkey;
 }
 
@@ -1399,6 +2077,123 @@ RC BplusTreeHandler::insert_entry(const char *user_key, const RID *rid)
   return RC::SUCCESS;
 }
 
+RC BplusTreeHandler::insert_entries(const char *keys, int count)
+{
+  const int         key_length = file_header_.key_length;
+  std::vector<char> upper_key(key_length);
+  bool              has_upper_key = false;
+
+  int i = 0;
+  while (i < count) {
+    const char *key = keys + static_cast<size_t>(i) * key_length;
+    RID         rid = key_normalizer_.rid(key);
+
+    if (is_empty()) {
+      root_lock_.lock();
+      if (is_empty()) {
+        RC rc = create_new_tree(key, &rid);
+        root_lock_.unlock();
+        if (OB_FAIL(rc)) {
+          return rc;
+        }
+        i++;
+        continue;
+      }
+      root_lock_.unlock();
+    }
+
+    LatchMemo latch_memo(disk_buffer_pool_);
+    Frame    *frame = nullptr;
+    RC        rc    = find_leaf_with_upper_key(
+        latch_memo, BplusTreeOperationType::INSERT, key, frame, upper_key.data(), has_upper_key);
+    if (rc == RC::EMPTY) {
+      continue;  // 并发的删除把树删空了
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("Failed to find leaf %s. rc=%d:%s", rid.to_string().c_str(), rc, strrc(rc));
+      return rc;
+    }
+
+    // 第一个键值按照普通的插入处理，节点满了会分裂，分裂之后叶子节点的范围变了，下一个键值重新查找
+    LeafIndexNodeHandler leaf_node(file_header_, frame);
+    const bool           full = leaf_node.size() >= leaf_node.max_size();
+    rc                        = insert_entry_into_leaf_node(latch_memo, frame, key, &rid);
+    if (OB_FAIL(rc)) {
+      LOG_TRACE("Failed to insert into leaf of index, rid:%s. rc=%s", rid.to_string().c_str(), strrc(rc));
+      return rc;
+    }
+    i++;
+    if (full) {
+      continue;
+    }
+
+    // 后面的键值还在这个叶子节点的范围内，并且不会引起分裂时，直接插入
+    while (i < count && leaf_node.size() < leaf_node.max_size()) {
+      key = keys + static_cast<size_t>(i) * key_length;
+      if (has_upper_key && memcmp(key, upper_key.data(), key_length) >= 0) {
+        break;
+      }
+
+      rid = key_normalizer_.rid(key);
+      rc  = insert_entry_into_leaf_node(latch_memo, frame, key, &rid);
+      if (OB_FAIL(rc)) {
+        LOG_TRACE("Failed to insert into leaf of index, rid:%s. rc=%s", rid.to_string().c_str(), strrc(rc));
+        return rc;
+      }
+      i++;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC BplusTreeHandler::delete_entries(const char *keys, int count)
+{
+  const int         key_length = file_header_.key_length;
+  std::vector<char> upper_key(key_length);
+  bool              has_upper_key = false;
+
+  int i = 0;
+  while (i < count) {
+    const char *key = keys + static_cast<size_t>(i) * key_length;
+
+    LatchMemo latch_memo(disk_buffer_pool_);
+    Frame    *frame = nullptr;
+    RC        rc    = find_leaf_with_upper_key(
+        latch_memo, BplusTreeOperationType::DELETE, key, frame, upper_key.data(), has_upper_key);
+    if (rc == RC::EMPTY) {
+      return RC::SUCCESS;
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to find leaf page. rc =%s", strrc(rc));
+      return rc;
+    }
+
+    // 删除第一个键值之后节点可能合并，这时就不能再使用这个叶子节点了
+    LeafIndexNodeHandler leaf_node(file_header_, frame);
+    const bool           walk = leaf_node.size() > leaf_node.min_size();
+    rc                        = delete_entry_internal(latch_memo, frame, key);
+    if (OB_FAIL(rc) && rc != RC::RECORD_NOT_EXIST) {
+      return rc;
+    }
+    i++;
+    if (!walk) {
+      continue;
+    }
+
+    while (i < count && leaf_node.size() > leaf_node.min_size()) {
+      key = keys + static_cast<size_t>(i) * key_length;
+      if (has_upper_key && memcmp(key, upper_key.data(), key_length) >= 0) {
+        break;
+      }
+      if (leaf_node.remove(key) > 0) {
+        frame->mark_dirty();
+      }
+      i++;
+    }
+  }
+  return RC::SUCCESS;
+}
+
 RC BplusTreeHandler::get_entry(const char *user_key, int key_len, std::list<RID> &rids)
 {
   BplusTreeScanner scanner(*this);
@@ -1440,15 +2235,6 @@ RC BplusTreeHandler::adjust_root(LatchMemo &latch_memo, Frame *root_frame)
     InternalIndexNodeHandler internal_node(file_header_, root_frame);
 
     const PageNum child_page_num = internal_node.value_at(0);
-    Frame        *child_frame    = nullptr;
-    RC            rc             = latch_memo.get_page(child_page_num, child_frame);
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to fetch child page. page num=%d, rc=%d:%s", child_page_num, rc, strrc(rc));
-      return rc;
-    }
-
-    IndexNodeHandler child_node(file_header_, child_frame);
-    child_node.set_parent_page_num(BP_INVALID_PAGE_NUM);
 
     // file_header_.root_page = child_page_num;
     new_root_page_num = child_page_num;
@@ -1469,8 +2255,15 @@ RC BplusTreeHandler::coalesce_or_redistribute(LatchMemo &latch_memo, Frame *fram
     return RC::SUCCESS;
   }
 
-  const PageNum parent_page_num = index_node.parent_page_num();
-  if (BP_INVALID_PAGE_NUM == parent_page_num) {
+  // 节点不满足最小大小的要求时，它一定是不安全的，父节点的锁还在 latch memo 中
+  Frame *parent_frame = latch_memo.parent_of(frame);
+  if (nullptr == parent_frame) {
+    if (frame->page_num() != file_header_.root_page) {
+      LOG_WARN("cannot find parent in latch memo. page num=%d, root page=%d",
+               frame->page_num(), file_header_.root_page);
+      return RC::INTERNAL;
+    }
+
     // this is the root page
     if (index_node.size() > 1) {
     } else {
@@ -1480,20 +2273,19 @@ RC BplusTreeHandler::coalesce_or_redistribute(LatchMemo &latch_memo, Frame *fram
     return RC::SUCCESS;
   }
 
-  Frame *parent_frame = nullptr;
-
-  RC rc = latch_memo.get_page(parent_page_num, parent_frame);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to fetch parent page. page id=%d, rc=%d:%s", parent_page_num, rc, strrc(rc));
-    return rc;
-  }
+  RC rc = RC::SUCCESS;
 
   InternalIndexNodeHandler parent_index_node(file_header_, parent_frame);
 
-  int index = parent_index_node.lookup(key_comparator_, index_node.key_at(index_node.size() - 1));
-  ASSERT(parent_index_node.value_at(index) == frame->page_num(),
-         "lookup return an invalid value. index=%d, this page num=%d, but got %d",
-         index, frame->page_num(), parent_index_node.value_at(index));
+  // 叶子节点可能已经空了，使用页号查找它在父节点中的位置
+  int index = parent_index_node.value_index(frame->page_num());
+  ASSERT(index >= 0, "cannot find child in parent. page num=%d, parent page num=%d",
+         frame->page_num(), parent_frame->page_num());
+
+  if (parent_index_node.size() < 2) {
+    // 父节点之前合并失败只剩下这一个子节点，没有兄弟节点可以合并
+    return RC::SUCCESS;
+  }
 
   PageNum neighbor_page_num;
   if (index == 0) {
@@ -1513,8 +2305,12 @@ RC BplusTreeHandler::coalesce_or_redistribute(LatchMemo &latch_memo, Frame *fram
 
   latch_memo.xlatch(neighbor_frame);
 
+  // 合并之后的节点只能使用两个节点前缀的公共部分，前缀变短之后能放下的项也会变少
   IndexNodeHandlerType neighbor_node(file_header_, neighbor_frame);
-  if (index_node.size() + neighbor_node.size() > index_node.max_size()) {
+  const int            merged_prefix_length = IndexNodeHandler::common_prefix_length(
+      index_node.prefix(), neighbor_node.prefix(), std::min(index_node.prefix_length(), neighbor_node.prefix_length()));
+  if (index_node.size() + neighbor_node.size() >
+      IndexNodeHandler::max_size_of(file_header_, index_node.is_leaf(), merged_prefix_length)) {
     rc = redistribute<IndexNodeHandlerType>(neighbor_frame, frame, parent_frame, index);
   } else {
     rc = coalesce<IndexNodeHandlerType>(latch_memo, neighbor_frame, frame, parent_frame, index);
@@ -1545,9 +2341,15 @@ RC BplusTreeHandler::coalesce(
   IndexNodeHandlerType left_node(file_header_, left_frame);
   IndexNodeHandlerType right_node(file_header_, right_frame);
 
+  const int prefix_length = IndexNodeHandler::common_prefix_length(
+      left_node.prefix(), right_node.prefix(), std::min(left_node.prefix_length(), right_node.prefix_length()));
+  if (prefix_length < left_node.prefix_length()) {
+    left_node.set_prefix(left_node.prefix(), prefix_length);
+  }
+
   parent_node.remove(index);
   // parent_node.validate(key_comparator_, disk_buffer_pool_, file_id_);
-  RC rc = right_node.move_to(left_node, disk_buffer_pool_);
+  RC rc = right_node.move_to(left_node);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to move right node to left. rc=%d:%s", rc, strrc(rc));
     return rc;
@@ -1560,6 +2362,10 @@ RC BplusTreeHandler::coalesce(
     left_leaf_node.set_next_page(right_leaf_node.next_page());
   }
 
+  // 没有标记脏页的话，页面被淘汰时合并的结果就丢掉了
+  left_frame->mark_dirty();
+  parent_frame->mark_dirty();
+
   latch_memo.dispose_page(right_frame->page_num());
   return coalesce_or_redistribute<InternalIndexNodeHandler>(latch_memo, parent_frame);
 }
@@ -1570,23 +2376,33 @@ RC BplusTreeHandler::redistribute(Frame *neighbor_frame, Frame *frame, Frame *pa
   InternalIndexNodeHandler parent_node(file_header_, parent_frame);
   IndexNodeHandlerType     neighbor_node(file_header_, neighbor_frame);
   IndexNodeHandlerType     node(file_header_, frame);
-  if (neighbor_node.size() < node.size()) {
-    LOG_ERROR("got invalid nodes. neighbor node size %d, this node size %d", neighbor_node.size(), node.size());
+
+  // 从兄弟节点移动过来的键值不一定有当前节点的前缀，当前节点的前缀要缩短成两个节点前缀的公共部分。
+  // 前缀缩短之后放不下，或者兄弟节点也没有多余的项时，就让当前节点保持不满的状态，不影响正确性
+  const int prefix_length = IndexNodeHandler::common_prefix_length(
+      node.prefix(), neighbor_node.prefix(), std::min(node.prefix_length(), neighbor_node.prefix_length()));
+  if (node.size() + 1 > IndexNodeHandler::max_size_of(file_header_, node.is_leaf(), prefix_length) ||
+      neighbor_node.size() <= neighbor_node.min_size()) {
+    LOG_TRACE("skip redistribute. page num=%d, size=%d, neighbor page num=%d, neighbor size=%d",
+              node.page_num(), node.size(), neighbor_node.page_num(), neighbor_node.size());
+    return RC::SUCCESS;
   }
+
+  if (prefix_length < node.prefix_length()) {
+    node.set_prefix(node.prefix(), prefix_length);
+  }
+
+  MemPoolItem::unique_ptr key = mem_pool_item_->alloc_unique_ptr();
   if (index == 0) {
     // the neighbor is at right
-    neighbor_node.move_first_to_end(node, disk_buffer_pool_);
-    // neighbor_node.validate(key_comparator_, disk_buffer_pool_, file_id_);
-    // node.validate(key_comparator_, disk_buffer_pool_, file_id_);
-    parent_node.set_key_at(index + 1, neighbor_node.key_at(0));
-    // parent_node.validate(key_comparator_, disk_buffer_pool_, file_id_);
+    neighbor_node.move_first_to_end(node);
+    neighbor_node.get_key(0, static_cast<char *>(key.get()));
+    parent_node.set_key_at(index + 1, static_cast<const char *>(key.get()));
   } else {
     // the neighbor is at left
-    neighbor_node.move_last_to_front(node, disk_buffer_pool_);
-    // neighbor_node.validate(key_comparator_, disk_buffer_pool_, file_id_);
-    // node.validate(key_comparator_, disk_buffer_pool_, file_id_);
-    parent_node.set_key_at(index, node.key_at(0));
-    // parent_node.validate(key_comparator_, disk_buffer_pool_, file_id_);
+    neighbor_node.move_last_to_front(node);
+    node.get_key(0, static_cast<char *>(key.get()));
+    parent_node.set_key_at(index, static_cast<const char *>(key.get()));
   }
 
   neighbor_frame->mark_dirty();
@@ -1600,7 +2416,7 @@ RC BplusTreeHandler::delete_entry_internal(LatchMemo &latch_memo, Frame *leaf_fr
 {
   LeafIndexNodeHandler leaf_index_node(file_header_, leaf_frame);
 
-  const int remove_count = leaf_index_node.remove(key, key_comparator_);
+  const int remove_count = leaf_index_node.remove(key);
   if (remove_count == 0) {
     LOG_TRACE("no data need to remove");
     // disk_buffer_pool_->unpin_page(leaf_frame);
@@ -1619,23 +2435,13 @@ RC BplusTreeHandler::delete_entry_internal(LatchMemo &latch_memo, Frame *leaf_fr
 
 RC BplusTreeHandler::delete_entry(const char *user_key, const RID *rid)
 {
-  MemPoolItem::unique_ptr pkey = mem_pool_item_->alloc_unique_ptr();
+  MemPoolItem::unique_ptr pkey = make_key(user_key, *rid);
   if (nullptr == pkey) {
     LOG_WARN("Failed to alloc memory for key. size=%d", file_header_.key_length);
     return RC::NOMEM;
   }
   char *key = static_cast<char *>(pkey.get());
 
-  // memcpy(key, user_key, file_header_.attr_length);
-  // memcpy(key + file_header_.attr_length, rid, sizeof(*rid));
-  int pos = 0;
-  for (int i = 0; i < file_header_.attr_num; i++) {
-    // 存在问题：不能读取file_header_.attr_type与file_header_.attr_length这两块内存，否则直接segmentation fault
-    memcpy(key + pos, user_key + pos, file_header_.attr_length[i]);
-    pos += file_header_.attr_length[i];
-  }
-  memcpy(key + pos, rid, sizeof(*rid));
-
   BplusTreeOperationType op = BplusTreeOperationType::DELETE;
   LatchMemo              latch_memo(disk_buffer_pool_);
 
@@ -1657,9 +2463,7 @@ RC BplusTreeHandler::delete_entry(const char *user_key, const RID *rid)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-BplusTreeScanner::BplusTreeScanner(BplusTreeHandler &tree_handler)
-    : tree_handler_(tree_handler), latch_memo_(tree_handler.disk_buffer_pool_)
-{}
+BplusTreeScanner::BplusTreeScanner(BplusTreeHandler &tree_handler) : tree_handler_(tree_handler) {}
 
 BplusTreeScanner::~BplusTreeScanner() { close(); }
 
@@ -1672,13 +2476,22 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
     return RC::INTERNAL;
   }
 
-  inited_        = true;
-  first_emitted_ = false;
+  inited_    = true;
+  reach_end_ = true;
+  rids_.clear();
+  rid_index_ = 0;
 
-  // 校验输入的键值是否是合法范围
+  // 校验输入的键值是否是合法范围。索引中的键值是规范化编码的，比较之前先编码
   if (left_user_key && right_user_key) {
     const auto &attr_comparator = tree_handler_.key_comparator_.attr_comparator();
-    const int   result          = attr_comparator(left_user_key, right_user_key);
+    auto        left_key        = tree_handler_.make_key(left_user_key, *RID::min());
+    auto        right_key       = tree_handler_.make_key(right_user_key, *RID::min());
+    if (left_key == nullptr || right_key == nullptr) {
+      LOG_WARN("failed to alloc memory for key.");
+      return RC::NOMEM;
+    }
+    const int result =
+        attr_comparator(static_cast<const char *>(left_key.get()), static_cast<const char *>(right_key.get()));
     if (result > 0 ||  // left < right
                        // left == right but is (left,right)/[left,right) or (left,right]
         (result == 0 && (left_inclusive == false || right_inclusive == false))) {
@@ -1686,14 +2499,10 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
     }
   }
 
+  seek_exclusive_ = false;
   if (nullptr == left_user_key) {
-    rc = tree_handler_.left_most_page(latch_memo_, current_frame_);
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to find left most page. rc=%s", strrc(rc));
-      return rc;
-    }
-
-    iter_index_ = 0;
+    seek_key_     = tree_handler_.mem_pool_item_->alloc_unique_ptr();
+    has_seek_key_ = false;
   } else {
 
     char *fixed_left_key = const_cast<char *>(left_user_key);
@@ -1710,51 +2519,23 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
       }
     }
 
-    MemPoolItem::unique_ptr left_pkey;
+    // lookup 返回的是第一个不小于指定键值的位置，左边界使用最小或最大的RID就可以定位到正确的位置
     if (left_inclusive) {
-      left_pkey = tree_handler_.make_key(fixed_left_key, *RID::min());
+      seek_key_ = tree_handler_.make_key(fixed_left_key, *RID::min());
     } else {
-      left_pkey = tree_handler_.make_key(fixed_left_key, *RID::max());
+      seek_key_ = tree_handler_.make_key(fixed_left_key, *RID::max());
     }
-
-    const char *left_key = (const char *)left_pkey.get();
+    has_seek_key_ = true;
 
     if (fixed_left_key != left_user_key) {
       delete[] fixed_left_key;
       fixed_left_key = nullptr;
     }
+  }
 
-    rc = tree_handler_.find_leaf(latch_memo_, BplusTreeOperationType::READ, left_key, current_frame_);
-    if (rc == RC::EMPTY) {
-      rc             = RC::SUCCESS;
-      current_frame_ = nullptr;
-      return rc;
-    } else if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to find left page. rc=%s", strrc(rc));
-      return rc;
-    }
-
-    LeafIndexNodeHandler left_node(tree_handler_.file_header_, current_frame_);
-    int                  left_index = left_node.lookup(tree_handler_.key_comparator_, left_key);
-    // lookup 返回的是适合插入的位置，还需要判断一下是否在合适的边界范围内
-    if (left_index >= left_node.size()) {  // 超出了当前页，就需要向后移动一个位置
-      const PageNum next_page_num = left_node.next_page();
-      if (next_page_num == BP_INVALID_PAGE_NUM) {  // 这里已经是最后一页，说明当前扫描，没有数据
-        latch_memo_.release();
-        current_frame_ = nullptr;
-        return RC::SUCCESS;
-      }
-
-      rc = latch_memo_.get_page(next_page_num, current_frame_);
-      if (rc != RC::SUCCESS) {
-        LOG_WARN("failed to fetch next page. page num=%d, rc=%s", next_page_num, strrc(rc));
-        return rc;
-      }
-      latch_memo_.slatch(current_frame_);
-
-      left_index = 0;
-    }
-    iter_index_ = left_index;
+  if (seek_key_ == nullptr) {
+    LOG_WARN("failed to alloc memory for key.");
+    return RC::NOMEM;
   }
 
   // 没有指定右边界范围，那么就返回右边界最大值
@@ -1787,87 +2568,260 @@ RC BplusTreeScanner::open(const char *left_user_key, int left_len, bool left_inc
     }
   }
 
-  if (touch_end()) {
-    current_frame_ = nullptr;
+  // 逆序扫描从右边界开始向左，到左边界结束。返回的项与正序扫描相同
+  if (reverse_) {
+    left_key_ = has_seek_key_ ? std::move(seek_key_) : nullptr;
+    seek_key_ = tree_handler_.mem_pool_item_->alloc_unique_ptr();
+    low_key_  = tree_handler_.mem_pool_item_->alloc_unique_ptr();
+    if (seek_key_ == nullptr || low_key_ == nullptr) {
+      LOG_WARN("failed to alloc memory for key.");
+      return RC::NOMEM;
+    }
+    has_seek_key_ = right_key_ != nullptr;
+    if (has_seek_key_) {
+      memcpy(seek_key_.get(), right_key_.get(), tree_handler_.file_header_.key_length);
+    }
+    right_key_ = nullptr;
   }
 
-  return RC::SUCCESS;
+  return seek();
 }
 
-void BplusTreeScanner::fetch_item(RID &rid)
+RC BplusTreeScanner::seek()
 {
-  LeafIndexNodeHandler node(tree_handler_.file_header_, current_frame_);
-  memcpy(&rid, node.value_at(iter_index_), sizeof(rid));
+  while (true) {
+    Frame   *frame   = nullptr;
+    uint64_t version = 0;
+
+    const char          *key = has_seek_key_ ? static_cast<const char *>(seek_key_.get()) : nullptr;
+    std::vector<PageNum> next_leaves;
+    RC                   rc = RC::SUCCESS;
+    if (reverse_) {
+      rc = tree_handler_.optimistic_find_prev_leaf(
+          key, frame, version, static_cast<char *>(low_key_.get()), has_low_key_);
+    } else {
+      rc = tree_handler_.optimistic_find_leaf(key, frame, version, &next_leaves, prefetch_leaves_);
+    }
+    if (rc == RC::EMPTY) {
+      rids_.clear();
+      rid_index_ = 0;
+      reach_end_ = true;
+      return RC::SUCCESS;
+    } else if (OB_FAIL(rc)) {
+      LOG_WARN("failed to find leaf page. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    const bool loaded =
+        reverse_ ? load_leaf_reverse(frame, version) : load_leaf(frame, version, true /*from_seek_key*/);
+    tree_handler_.disk_buffer_pool_->unpin_page(frame);
+    if (loaded) {
+      if (!reverse_) {
+        prefetched_leaves_.clear();
+        prefetch(&next_leaves);
+      }
+      return RC::SUCCESS;
+    }
+  }
 }
 
-bool BplusTreeScanner::touch_end()
+RC BplusTreeScanner::next_leaf()
 {
-  if (right_key_ == nullptr) {
-    return false;
+  // 逆序扫描时没有指向前一个叶子节点的链表，总是从根节点重新查找
+  if (reverse_) {
+    return seek();
   }
 
-  LeafIndexNodeHandler node(tree_handler_.file_header_, current_frame_);
+  DiskBufferPool *buffer_pool = tree_handler_.disk_buffer_pool_;
+
+  // 当前叶子节点没有变化，它记录的下一个叶子节点才是有效的
+  Frame *leaf_frame = nullptr;
+  RC     rc         = buffer_pool->get_this_page(leaf_page_, &leaf_frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to fetch leaf page. page num=%d, rc=%s", leaf_page_, strrc(rc));
+    return rc;
+  }
+
+  if (leaf_frame->validate_version(leaf_version_)) {
+    Frame *next_frame = nullptr;
+    rc                = buffer_pool->get_this_page(next_page_, &next_frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to fetch next leaf page. page num=%d, rc=%s", next_page_, strrc(rc));
+      buffer_pool->unpin_page(leaf_frame);
+      return rc;
+    }
+
+    // 拿到下一个节点的版本号之后，再确认一次当前节点没有变化(比如分裂出新的节点)
+    const uint64_t next_version = next_frame->version();
+    const bool     linked       = (next_version & 1) == 0 && leaf_frame->validate_version(leaf_version_);
+    buffer_pool->unpin_page(leaf_frame);
 
-  const char *this_key       = node.key_at(iter_index_);
-  int         compare_result = tree_handler_.key_comparator_(this_key, static_cast<char *>(right_key_.get()));
-  return compare_result > 0;
+    const bool loaded = linked && load_leaf(next_frame, next_version, false /*from_seek_key*/);
+    buffer_pool->unpin_page(next_frame);
+    if (loaded) {
+      if (!prefetched_leaves_.empty() && prefetched_leaves_.front() == leaf_page_) {
+        prefetched_leaves_.pop_front();
+      } else {
+        prefetched_leaves_.clear();
+      }
+      prefetch(nullptr);
+      return RC::SUCCESS;
+    }
+  } else {
+    buffer_pool->unpin_page(leaf_frame);
+  }
+
+  // 有并发的修改，使用最后返回的键值从根节点重新定位
+  return seek();
 }
 
-RC BplusTreeScanner::next_entry(RID &rid)
+bool BplusTreeScanner::load_leaf(Frame *frame, uint64_t version, bool from_seek_key)
 {
-  if (nullptr == current_frame_) {
-    return RC::RECORD_EOF;
+  // 没有加锁，页面可能正在被修改(比如调整前缀之后所有项的位置都变了)。先把整个页面复制出来，
+  // 确认版本号没有变化，复制出来的就是一致的数据，后面再解析就不会读到不完整的内容
+  memcpy(page_copy_.data(), frame->data(), LeafIndexNodeHandler(tree_handler_.file_header_, frame).used_bytes());
+  if (!frame->validate_version(version)) {
+    return false;
   }
 
-  if (!first_emitted_) {
-    fetch_item(rid);
-    first_emitted_ = true;
-    return RC::SUCCESS;
+  LeafIndexNodeHandler leaf_node(tree_handler_.file_header_, frame->page_num(), page_copy_.data());
+
+  rids_.clear();
+  rid_index_ = 0;
+
+  int index = 0;
+  if (from_seek_key && has_seek_key_) {
+    bool found = false;
+    index      = leaf_node.lookup(static_cast<const char *>(seek_key_.get()), &found);
+    if (seek_exclusive_ && found) {
+      index++;
+    }
   }
 
-  iter_index_++;
+  bool      touch_end = false;
+  const int size      = leaf_node.size();
+  for (; index < size; index++) {
+    if (right_key_ != nullptr && leaf_node.compare_key(index, static_cast<const char *>(right_key_.get())) > 0) {
+      touch_end = true;
+      break;
+    }
 
-  LeafIndexNodeHandler node(tree_handler_.file_header_, current_frame_);
-  if (iter_index_ < node.size()) {
-    if (touch_end()) {
-      return RC::RECORD_EOF;
+    RID rid;
+    memcpy(&rid, leaf_node.value_at(index), sizeof(rid));
+    rids_.push_back(rid);
+  }
+
+  const PageNum next_page = leaf_node.next_page();
+
+  // 记下最后一个返回的键值，叶子节点变化后从这里重新定位
+  if (!rids_.empty()) {
+    leaf_node.get_key(index - 1, static_cast<char *>(seek_key_.get()));
+    has_seek_key_   = true;
+    seek_exclusive_ = true;
+  }
+  leaf_page_    = frame->page_num();
+  leaf_version_ = version;
+  next_page_    = next_page;
+  reach_end_    = touch_end || next_page == BP_INVALID_PAGE_NUM;
+  return true;
+}
+
+bool BplusTreeScanner::load_leaf_reverse(Frame *frame, uint64_t version)
+{
+  memcpy(page_copy_.data(), frame->data(), LeafIndexNodeHandler(tree_handler_.file_header_, frame).used_bytes());
+  if (!frame->validate_version(version)) {
+    return false;
+  }
+
+  LeafIndexNodeHandler leaf_node(tree_handler_.file_header_, frame->page_num(), page_copy_.data());
+
+  rids_.clear();
+  rid_index_ = 0;
+
+  // lookup 返回第一个不小于 seek_key_ 的位置，从它的前一项开始向左
+  int index = has_seek_key_ ? leaf_node.lookup(static_cast<const char *>(seek_key_.get())) : leaf_node.size();
+
+  bool touch_end = false;
+  for (index--; index >= 0; index--) {
+    if (left_key_ != nullptr && leaf_node.compare_key(index, static_cast<const char *>(left_key_.get())) < 0) {
+      touch_end = true;
+      break;
     }
 
-    fetch_item(rid);
-    return RC::SUCCESS;
+    RID rid;
+    memcpy(&rid, leaf_node.value_at(index), sizeof(rid));
+    rids_.push_back(rid);
+  }
+
+  // 下一次查找小于最后返回的键值的项。这个叶子节点中没有小于 seek_key_ 的项时，从它的下界继续查找
+  if (!rids_.empty()) {
+    leaf_node.get_key(index + 1, static_cast<char *>(seek_key_.get()));
+    has_seek_key_ = true;
+  } else if (has_low_key_) {
+    memcpy(seek_key_.get(), low_key_.get(), tree_handler_.file_header_.key_length);
+    has_seek_key_ = true;
   }
+  leaf_page_    = frame->page_num();
+  leaf_version_ = version;
+  reach_end_    = touch_end || !has_low_key_;
+  return true;
+}
 
-  RC      rc            = RC::SUCCESS;
-  PageNum next_page_num = node.next_page();
-  if (BP_INVALID_PAGE_NUM == next_page_num) {
-    return RC::RECORD_EOF;
+void BplusTreeScanner::prefetch(std::vector<PageNum> *next_leaves)
+{
+  if (prefetch_leaves_ <= 0 || reach_end_ || static_cast<int>(prefetched_leaves_.size()) * 2 > prefetch_leaves_) {
+    return;
   }
 
-  const int memo_point = latch_memo_.memo_point();
-  rc                   = latch_memo_.get_page(next_page_num, current_frame_);
-  if (rc != RC::SUCCESS) {
-    LOG_WARN("failed to get next page. page num=%d, rc=%s", next_page_num, strrc(rc));
-    return rc;
+  // 从根节点找到当前叶子节点的父节点，拿到排在后面的叶子节点。内部节点通常都在内存中，代价不大
+  std::vector<PageNum> found;
+  if (next_leaves == nullptr && has_seek_key_) {
+    Frame   *frame   = nullptr;
+    uint64_t version = 0;
+    RC       rc      = tree_handler_.optimistic_find_leaf(
+        static_cast<const char *>(seek_key_.get()), frame, version, &found, prefetch_leaves_);
+    if (OB_FAIL(rc)) {
+      return;
+    }
+    tree_handler_.disk_buffer_pool_->unpin_page(frame);
+    next_leaves = &found;
   }
 
-  /**
-   * 如果这里直接去加锁，那可能会造成死锁
-   * 因为这里访问页面的方式顺序与插入、删除的顺序不一样
-   * 如果加锁失败，就由上层做重试
-   */
-  bool locked = latch_memo_.try_slatch(current_frame_);
-  if (!locked) {
-    return RC::LOCKED_NEED_WAIT;
+  // 当前叶子节点是父节点中的最后一个时拿不到后面的节点，至少预读链表中的下一个
+  std::vector<PageNum> pages;
+  if (next_leaves == nullptr || next_leaves->empty() || next_leaves->front() != next_page_) {
+    pages.push_back(next_page_);
+  } else {
+    pages = *next_leaves;
+  }
+
+  prefetched_leaves_.assign(pages.begin(), pages.end());
+  tree_handler_.disk_buffer_pool_->prefetch_pages(std::move(pages));
+}
+
+RC BplusTreeScanner::next_entry(RID &rid)
+{
+  while (rid_index_ >= rids_.size()) {
+    if (reach_end_) {
+      return RC::RECORD_EOF;
+    }
+
+    RC rc = next_leaf();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
   }
 
-  latch_memo_.release_to(memo_point);
-  iter_index_ = -1;  // `next` will add 1
-  return next_entry(rid);
+  rid = rids_[rid_index_++];
+  return RC::SUCCESS;
 }
 
 RC BplusTreeScanner::close()
 {
-  inited_ = false;
+  inited_    = false;
+  reach_end_ = true;
+  rids_.clear();
+  rid_index_ = 0;
   LOG_TRACE("bplus tree scanner closed");
   return RC::SUCCESS;
 }
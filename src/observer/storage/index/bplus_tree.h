@@ -17,6 +17,9 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <sstream>
@@ -34,6 +37,9 @@ See the Mulan PSL v2 for more details. */
  * @defgroup BPlusTree
  */
 
+class BplusTreeKeySorter;
+class BplusTreeBulkLoadWindow;
+
 /**
  * @brief B+树的操作类型
  * @ingroup BPlusTree
@@ -45,175 +51,104 @@ enum class BplusTreeOperationType
   DELETE,
 };
 
+/**
+ * @brief 键值的规范化编码(BplusTree)
+ * @ingroup BPlusTree
+ * @details 索引中保存的键值不是字段的原始内容，而是编码之后的格式，保证两个键值直接使用 memcmp 比较的结果
+ * 与按照字段类型逐个比较的结果一致。这样比较时不需要再根据字段类型分别处理，也可以在节点中提取公共前缀。
+ * - INTS/DATES: 翻转符号位之后按照大端序保存
+ * - FLOATS: 正数翻转符号位，负数翻转所有的位，再按照大端序保存。-0.0 当作 0.0 处理
+ * - CHARS: 第一个'\0'之后的内容全部填0
+ * - RID: page num 和 slot num 按照 INTS 的方式编码
+ */
+class KeyNormalizer
+{
+public:
+  void init(std::vector<AttrType> type, std::vector<int> length);
+
+  int attr_length() const { return attr_length_; }
+  int key_length() const { return attr_length_ + static_cast<int>(sizeof(RID)); }
+
+  /**
+   * @brief 把字段的原始值和RID编码成索引中的键值
+   * @details key 与 user_key 可以是同一块内存
+   */
+  void normalize(const char *user_key, const RID &rid, char *key) const;
+
+  /**
+   * @brief 把键值还原成字段的原始值和RID
+   */
+  void denormalize(const char *key, char *user_key, RID &rid) const;
+
+  /**
+   * @brief 只解码键值中的RID
+   */
+  RID rid(const char *key) const;
+
+  const std::vector<AttrType> &attr_type() const { return attr_type_; }
+  const std::vector<int>      &attr_lengths() const { return attr_lengths_; }
+
+private:
+  std::vector<AttrType> attr_type_;
+  std::vector<int>      attr_lengths_;
+  int                   attr_length_ = 0;
+};
+
 /**
  * @brief 属性比较(BplusTree) 用于确定索引在B+ Tree的插入位置
  * @ingroup BPlusTree
+ * @details 比较的是规范化编码之后的键值，参考 KeyNormalizer
  */
 class AttrComparator
 {
 public:
   void init(std::vector<AttrType> type, std::vector<int> length)
   {
-    attr_type_   = type;
-    attr_length_ = length;
-  }
-
-  int attr_length() const
-  {
-    int sum_len = 0;
-    for (size_t i = 0; i < attr_length_.size(); i++) {
-      sum_len += attr_length_[i];
+    attr_length_ = 0;
+    for (size_t i = 0; i < length.size(); i++) {
+      attr_length_ += length[i];
     }
-    return sum_len;  // TO DO MULTI INDEX
   }
 
-  int operator()(const char *v1, const char *v2, bool null_as_differnet = false) const  // for null type
-  {
-    LOG_DEBUG("[[[I'm Here NOW]]]");
-    int rc  = 0;
-    int pos = 0;
-    for (size_t i = 0; i < attr_length_.size(); i++) {
-      switch (attr_type_[i]) {
-        case INTS: {
-          rc = common::compare_int((void *)(v1 + pos), (void *)(v2 + pos));
-        } break;
-        case FLOATS: {
-          rc = common::compare_float((void *)(v1 + pos), (void *)(v2 + pos));
-        } break;
-        case CHARS: {
-          rc = common::compare_string((void *)(v1 + pos), attr_length_[i], (void *)(v2 + pos), attr_length_[i]);
-        } break;
-        default: {
-          LOG_ERROR("unknown attr type. %d", attr_type_[i]);
-          abort();
-        }
-      }
-      if (rc != 0) {
-        return rc;
-      }
-      pos += attr_length_.at(i);
-    }
-    return rc;
-  }
+  int attr_length() const { return attr_length_; }
+
+  int operator()(const char *v1, const char *v2) const { return memcmp(v1, v2, attr_length_); }
 
 private:
-  // AttrType attr_type_;
-  // int      attr_length_;
-  std::vector<AttrType> attr_type_;
-  std::vector<int>      attr_length_;
+  int attr_length_ = 0;
 };
 
 /**
  * @brief 键值比较(BplusTree)
  * @details BplusTree的键值除了字段属性，还有RID，是为了避免属性值重复而增加的。
+ * 字段属性和RID都是规范化编码之后的格式，整个键值直接使用 memcmp 比较。
  * @ingroup BPlusTree
  */
 class KeyComparator
 {
 public:
-  void init(std::vector<AttrType> type, std::vector<int> length) { attr_comparator_.init(type, length); }
-
-  const AttrComparator &attr_comparator() const { return attr_comparator_; }
-
-  const std::vector<FieldMeta> field_meta() { return key_field_meta_; };
-
-  void set_field_meta(const std::vector<FieldMeta> input) { key_field_meta_ = input; }
-
-  static int compare_v2(const char *r1, const char *r2, const std::vector<FieldMeta> &key_field_meta)
-  {
-    LOG_DEBUG("[[[[[[[[[[[[[I am here too too too]]]]]]]]]]]]]");
-    int pos = 0;
-    for (size_t i = 0; i < key_field_meta.size(); i++) {
-      const FieldMeta &field = key_field_meta[i];
-      LOG_DEBUG("[[[[[[[[[[[[[ Field for loop ]]]]]]]]]]]]] %d",i);
-
-      switch (field.type()) {
-        case INTS: {
-          int val1 = *(int *)(r1 + pos);
-          int val2 = *(int *)(r2 + pos);
-          LOG_DEBUG("[Field Compare v2]%zu: %d, %d\n", i, val1,val2);
-          if (val1 == val2) {
-            return 0;
-          }
-          break;
-        }
-        case FLOATS: {
-          float val1 = *(float *)(r1 + pos);
-          float val2 = *(float *)(r2 + pos);
-          LOG_DEBUG("[Field Compare v2]%zu: %f, %f\n", i, val1,val2);
-          if (val1 == val2) {
-            return 0;
-          }
-          break;
-        }
-        case CHARS: {
-          char *val1 = new char[field.len() + 1];
-          char *val2 = new char[field.len() + 1];
-          memcpy(val1, r1 + pos, field.len());
-          memcpy(val2, r2 + pos, field.len());
-          val1[field.len()] = '\0';
-          val2[field.len()] = '\0';
-          LOG_DEBUG("[Field Compare v2]%zu: %s, %s\n", i, val1,val2);
-          if (val1 == val2) {
-            return 0;
-          }
-          delete[] val1;
-          delete[] val2;
-          break;
-        }
-          // 其他类型的处理...
-      }
-
-      pos += field.len();
-    }
-    return 1;
-  }
-
-  // 核心比较函数
-  int operator()(const char *v1, const char *v2) const
+  void init(std::vector<AttrType> type, std::vector<int> length)
   {
-    int result = attr_comparator_(v1, v2);
-    if (result != 0) {
-      return result;
-    }
-
-    const RID *rid1 =
-        (const RID *)(v1 + attr_comparator_.attr_length());  // TO DO MULTI INDEX: RID存储在record内存记录的最后
-    const RID *rid2 = (const RID *)(v2 + attr_comparator_.attr_length());
-    return RID::compare(rid1, rid2);
+    attr_comparator_.init(type, length);
+    key_length_ = attr_comparator_.attr_length() + static_cast<int>(sizeof(RID));
   }
 
-  // 核心比较函数-int id类型比较
-  int operator()(const char *v1, const char *v2, bool is_unique) const
-  {
-    LOG_DEBUG("[[[I'm Here]]]");
-    int result = attr_comparator_(v1, v2);
-    if (result != 0) {
-      return result;
-    }
+  const AttrComparator &attr_comparator() const { return attr_comparator_; }
 
-    return attr_comparator_(v1, v2, is_unique);
-  }
+  int key_length() const { return key_length_; }
 
   // 核心比较函数
-  int operator()(const char *v1, const char *v2, const std::vector<FieldMeta> key_field_meta) const
-  {
-    int result = attr_comparator_(v1, v2);
-    if (result != 0) {
-      return result;
-    }
-
-    return compare_v2(v1, v2, key_field_meta);
-  }
+  int operator()(const char *v1, const char *v2) const { return memcmp(v1, v2, key_length_); }
 
 private:
-  AttrComparator         attr_comparator_;
-  std::vector<FieldMeta> key_field_meta_;
+  AttrComparator attr_comparator_;
+  int            key_length_ = 0;
 };
 
 /**
  * @brief 属性打印,调试使用(BplusTree)
  * @ingroup BPlusTree
+ * @details 打印的是还原之后的字段原始值
  */
 class AttrPrinter
 {
@@ -224,40 +159,35 @@ public:
     attr_length_ = length;
   }
 
-  int attr_length() const { return attr_length_.at(0); }  // TO DO MULTI INDEX
-
   std::string operator()(const char *v) const
   {
-    for (long unsigned int i = 0; i < attr_type_.size(); i++) {
-      switch (attr_type_.at(i)) {
-        case INTS: {
-          return std::to_string(*(int *)v);
+    std::stringstream ss;
+    int               pos = 0;
+    for (size_t i = 0; i < attr_type_.size(); i++) {
+      if (i > 0) {
+        ss << "|";
+      }
+      switch (attr_type_[i]) {
+        case INTS:
+        case DATES: {
+          ss << *(int *)(v + pos);
         } break;
         case FLOATS: {
-          return std::to_string(*(float *)v);
-        }
+          ss << *(float *)(v + pos);
+        } break;
         case CHARS: {
-          std::string str;
-          for (int i = 0; i < attr_length_.at(i); i++) {
-            if (v[i] == 0) {
-              break;
-            }
-            str.push_back(v[i]);
-          }
-          return str;
-        }
+          ss << std::string(v + pos, strnlen(v + pos, attr_length_[i]));
+        } break;
         default: {
-          LOG_ERROR("unknown attr type. %d", attr_type_.at(i));
-          abort();
-        }
+          ss << "?";
+        } break;
       }
+      pos += attr_length_[i];
     }
-    return "";
+    return ss.str();
   }
 
 private:
-  // AttrType attr_type_;
-  // int      attr_length_;
   std::vector<AttrType> attr_type_;
   std::vector<int>      attr_length_;
 };
@@ -269,22 +199,29 @@ private:
 class KeyPrinter
 {
 public:
-  void init(std::vector<AttrType> type, std::vector<int> length) { attr_printer_.init(type, length); }
+  void init(std::vector<AttrType> type, std::vector<int> length)
+  {
+    attr_printer_.init(type, length);
+    key_normalizer_.init(type, length);
+  }
 
   const AttrPrinter &attr_printer() const { return attr_printer_; }
 
   std::string operator()(const char *v) const
   {
-    std::stringstream ss;
-    ss << "{key:" << attr_printer_(v) << ",";
+    std::vector<char> user_key(key_normalizer_.attr_length());
+    RID               rid;
+    key_normalizer_.denormalize(v, user_key.data(), rid);
 
-    const RID *rid = (const RID *)(v + attr_printer_.attr_length());
-    ss << "rid:{" << rid->to_string() << "}}";
+    std::stringstream ss;
+    ss << "{key:" << attr_printer_(user_key.data()) << ",";
+    ss << "rid:{" << rid.to_string() << "}}";
     return ss.str();
   }
 
 private:
-  AttrPrinter attr_printer_;
+  AttrPrinter   attr_printer_;
+  KeyNormalizer key_normalizer_;
 };
 
 /**
@@ -295,6 +232,14 @@ private:
  */
 struct IndexFileHeader
 {
+  /**
+   * @brief 索引文件中节点的存储格式版本
+   * @details 0: 节点页头中保存父节点的页号(老版本)
+   * 1: 节点中不再保存父节点的页号
+   * 2: 键值使用规范化编码(参考 KeyNormalizer)，节点中的键值提取公共前缀
+   */
+  static constexpr int32_t CURRENT_FORMAT_VERSION = 2;
+
   IndexFileHeader() : root_page(BP_INVALID_PAGE_NUM), internal_max_size(0), leaf_max_size(0), key_length(0)
   {
     // 不需要使用 memset 函数清零
@@ -307,8 +252,8 @@ struct IndexFileHeader
   // }
 
   PageNum root_page;          ///< 根节点在磁盘中的页号
-  int32_t internal_max_size;  ///< 内部节点最大的键值对数
-  int32_t leaf_max_size;      ///< 叶子节点最大的键值对数
+  int32_t internal_max_size;  ///< 内部节点最大的键值对数，0表示由页面大小和节点的前缀长度决定
+  int32_t leaf_max_size;      ///< 叶子节点最大的键值对数，0表示由页面大小和节点的前缀长度决定
   // int32_t  attr_length;        ///< 键值的长度
   int32_t key_length;  ///< attr length + sizeof(RID)
   // AttrType attr_type;          ///< 键值的类型
@@ -319,6 +264,7 @@ struct IndexFileHeader
   int32_t  attr_length[MAX_NUM];
   int32_t  attr_offset[MAX_NUM];
   AttrType attr_type[MAX_NUM];
+  int32_t  format_version;  ///< 节点的存储格式版本，老版本的文件中这里是0
 
   const std::string to_string()
   {
@@ -336,7 +282,8 @@ struct IndexFileHeader
     }
     ss << "root_page:" << root_page << ","
        << "internal_max_size:" << internal_max_size << ","
-       << "leaf_max_size:" << leaf_max_size << ";";
+       << "leaf_max_size:" << leaf_max_size << ","
+       << "format_version:" << format_version << ";";
 
     return ss.str();
   }
@@ -347,16 +294,22 @@ struct IndexFileHeader
  * @ingroup BPlusTree
  * @code
  * storage format:
- * | page type | item number | parent page id |
+ * | page type | prefix length | item number |
  * @endcode
+ * 节点中不保存父节点的页号，修改树结构时从 LatchMemo 记录的查找路径中获取父节点，
+ * 这样分裂或合并时不需要再修改被移动的所有子节点
+ *
+ * 节点中所有的键值(包括以后可能插入的)有一段相同的前缀，前缀只在页头后面保存一份，每一项只保存剩余的部分。
+ * 前缀由父节点中这个节点两边的键值决定：节点的键值范围是 [key(i), key(i+1))，两个边界键值的公共前缀
+ * 就是这个范围内所有键值的公共前缀。最左边和最右边的节点没有边界，不提取前缀。
  */
 struct IndexNode
 {
-  static constexpr int HEADER_SIZE = 12;
+  static constexpr int HEADER_SIZE = 8;
 
-  bool    is_leaf;
-  int     key_num;
-  PageNum parent;
+  bool     is_leaf;
+  uint16_t prefix_length;  ///< 公共前缀的长度，老版本的文件中这里是填充的0
+  int      key_num;
 };
 
 /**
@@ -364,8 +317,8 @@ struct IndexNode
  * @ingroup BPlusTree
  * @code
  * storage format:
- * | common header | prev page id | next page id |
- * | key0, rid0 | key1, rid1 | ... | keyn, ridn |
+ * | common header | next page id | key prefix |
+ * | key0 suffix, rid0 | key1 suffix, rid1 | ... | keyn suffix, ridn |
  * @endcode
  * the key is in format: the key value of record and rid.
  * so the key in leaf page must be unique.
@@ -388,8 +341,8 @@ struct LeafIndexNode : public IndexNode
  * @ingroup BPlusTree
  * @code
  * storage format:
- * | common header |
- * | key(0),page_id(0) | key(1), page_id(1) | ... | key(n), page_id(n) |
+ * | common header | key prefix |
+ * | key(0) suffix, page_id(0) | key(1) suffix, page_id(1) | ... | key(n) suffix, page_id(n) |
  * @endcode
  * the first key is ignored(key0).
  * so it will waste space, can you fix this?
@@ -414,6 +367,8 @@ class IndexNodeHandler
 {
 public:
   IndexNodeHandler(const IndexFileHeader &header, Frame *frame);
+  /// 用于解析复制出来的页面数据
+  IndexNodeHandler(const IndexFileHeader &header, PageNum page_num, char *data);
   virtual ~IndexNodeHandler() = default;
 
   void init_empty(bool leaf);
@@ -423,20 +378,76 @@ public:
   int  value_size() const;
   int  item_size() const;
 
+  /**
+   * @brief 节点中键值公共前缀的长度，每一项只保存 key_size() - prefix_length() 个字节
+   */
+  int         prefix_length() const;
+  const char *prefix() const;
+  int         suffix_size() const;
+
   void    increase_size(int n);
   int     size() const;
   int     max_size() const;
   int     min_size() const;
-  void    set_parent_page_num(PageNum page_num);
-  PageNum parent_page_num() const;
   PageNum page_num() const;
 
+  /**
+   * @brief 节点最多可以放多少项
+   * @details 文件头中指定了最大值就使用指定的值，否则由页面大小和前缀长度决定，前缀越长，能放的项就越多
+   */
+  static int max_size_of(const IndexFileHeader &header, bool leaf, int prefix_length);
+
+  /**
+   * @brief 两个键值前 length 个字节中公共前缀的长度
+   */
+  static int common_prefix_length(const char *key1, const char *key2, int length);
+
+  /**
+   * @brief 把第 index 项完整的键值(前缀 + 剩余部分)复制到 key 中
+   */
+  void get_key(int index, char *key) const;
+
+  /**
+   * @brief 比较第 index 项的键值与 key 的前 length 个字节
+   */
+  int compare_key(int index, const char *key, int length) const;
+  int compare_key(int index, const char *key) const { return compare_key(index, key, key_size()); }
+
+  /**
+   * @brief 在 [first, size()) 中查找第一个不小于 key 的位置
+   * @details 只读取一次页头中的前缀长度和项数，并且限制在页面范围内，乐观读(没有加锁)时也不会越界访问
+   */
+  int lower_bound(const char *key, int first, bool *found) const;
+
+  /**
+   * @brief 修改节点的公共前缀，节点中所有的项重新编码
+   * @details 调用者保证节点中所有的键值都以 key 的前 prefix_length 个字节开头，
+   * 并且前缀变短之后依然能放下所有的项
+   */
+  void set_prefix(const char *key, int prefix_length);
+
+  /**
+   * @brief 在节点末尾追加一项，用于批量构建
+   * @details 调用者保证键值比节点中已有的都大，以当前的前缀开头，并且节点还放得下
+   */
+  void append_item(const char *key, const char *value);
+
+  /**
+   * @brief 页面中从头开始实际使用的字节数，不加锁读取时只需要复制这么多数据
+   */
+  int used_bytes() const;
+
   bool is_safe(BplusTreeOperationType op, bool is_root_node);
 
-  bool validate() const;
+  bool validate(bool is_root_node) const;
 
   friend std::string to_string(const IndexNodeHandler &handler);
 
+protected:
+  char *prefix_data() const;
+  char *item_at(int index) const;
+  void  write_item(int index, const char *key, const char *value);
+
 protected:
   const IndexFileHeader &header_;
   PageNum                page_num_;
@@ -451,46 +462,42 @@ class LeafIndexNodeHandler : public IndexNodeHandler
 {
 public:
   LeafIndexNodeHandler(const IndexFileHeader &header, Frame *frame);
+  LeafIndexNodeHandler(const IndexFileHeader &header, PageNum page_num, char *data);
   virtual ~LeafIndexNodeHandler() = default;
 
   void    init_empty();
   void    set_next_page(PageNum page_num);
   PageNum next_page() const;
 
-  char *key_at(int index);
   char *value_at(int index);
 
   /**
    * 查找指定key的插入位置(注意不是key本身)
    * 如果key已经存在，会设置found的值。
    */
-  int lookup(const KeyComparator &comparator, const char *key, bool *found = nullptr) const;
-
-  int lookup(
-      const KeyComparator &comparator, const char *key, bool *found, bool is_unique) const;
+  int lookup(const char *key, bool *found = nullptr) const;
 
   void insert(int index, const char *key, const char *value);
   void remove(int index);
-  int  remove(const char *key, const KeyComparator &comparator);
-  RC   move_half_to(LeafIndexNodeHandler &other, DiskBufferPool *bp);
-  RC   move_first_to_end(LeafIndexNodeHandler &other, DiskBufferPool *disk_buffer_pool);
-  RC   move_last_to_front(LeafIndexNodeHandler &other, DiskBufferPool *bp);
+  int  remove(const char *key);
+  RC   move_half_to(LeafIndexNodeHandler &other);
+  RC   move_first_to_end(LeafIndexNodeHandler &other);
+  RC   move_last_to_front(LeafIndexNodeHandler &other);
   /**
    * move all items to left page
    */
-  RC move_to(LeafIndexNodeHandler &other, DiskBufferPool *bp);
+  RC move_to(LeafIndexNodeHandler &other);
 
-  bool validate(const KeyComparator &comparator, DiskBufferPool *bp) const;
+  bool validate(bool is_root_node) const;
 
   friend std::string to_string(const LeafIndexNodeHandler &handler, const KeyPrinter &printer);
 
 private:
   char *__item_at(int index) const;
-  char *__key_at(int index) const;
   char *__value_at(int index) const;
 
-  void append(const char *item);
-  void preappend(const char *item);
+  void append(const char *key, const char *value);
+  void preappend(const char *key, const char *value);
 
 private:
   LeafIndexNode *leaf_node_;
@@ -504,14 +511,13 @@ class InternalIndexNodeHandler : public IndexNodeHandler
 {
 public:
   InternalIndexNodeHandler(const IndexFileHeader &header, Frame *frame);
+  InternalIndexNodeHandler(const IndexFileHeader &header, PageNum page_num, char *data);
   virtual ~InternalIndexNodeHandler() = default;
 
   void init_empty();
   void create_new_root(PageNum first_page_num, const char *key, PageNum page_num);
 
-  void    insert(const char *key, PageNum page_num, const KeyComparator &comparator);
-  RC      move_half_to(LeafIndexNodeHandler &other, DiskBufferPool *bp);
-  char   *key_at(int index);
+  void    insert(const char *key, PageNum page_num);
   PageNum value_at(int index);
 
   /**
@@ -524,36 +530,29 @@ public:
   /**
    * 与Leaf节点不同，lookup返回指定key应该属于哪个子节点，返回这个子节点在当前节点中的索引
    * 如果想要返回插入位置，就提供 `insert_position` 参数
-   * @param[in] comparator 用于键值比较的函数
    * @param[in] key 查找的键值
    * @param[out] found 如果是有效指针，将会返回当前是否存在指定的键值
    * @param[out] insert_position 如果是有效指针，将会返回可以插入指定键值的位置
    */
-  int lookup(
-      const KeyComparator &comparator, const char *key, bool *found = nullptr, int *insert_position = nullptr) const;
+  int lookup(const char *key, bool *found = nullptr, int *insert_position = nullptr) const;
 
-  RC move_to(InternalIndexNodeHandler &other, DiskBufferPool *disk_buffer_pool);
-  RC move_first_to_end(InternalIndexNodeHandler &other, DiskBufferPool *disk_buffer_pool);
-  RC move_last_to_front(InternalIndexNodeHandler &other, DiskBufferPool *bp);
-  RC move_half_to(InternalIndexNodeHandler &other, DiskBufferPool *bp);
+  RC move_to(InternalIndexNodeHandler &other);
+  RC move_first_to_end(InternalIndexNodeHandler &other);
+  RC move_last_to_front(InternalIndexNodeHandler &other);
+  RC move_half_to(InternalIndexNodeHandler &other);
 
-  bool validate(const KeyComparator &comparator, DiskBufferPool *bp) const;
+  bool validate(bool is_root_node) const;
 
   friend std::string to_string(const InternalIndexNodeHandler &handler, const KeyPrinter &printer);
 
 private:
-  RC copy_from(const char *items, int num, DiskBufferPool *disk_buffer_pool);
-  RC append(const char *item, DiskBufferPool *bp);
-  RC preappend(const char *item, DiskBufferPool *bp);
+  void append(const char *key, PageNum page_num);
+  void preappend(const char *key, PageNum page_num);
 
 private:
   char *__item_at(int index) const;
-  char *__key_at(int index) const;
   char *__value_at(int index) const;
 
-  int value_size() const;
-  int item_size() const;
-
 private:
   InternalIndexNode *internal_node_ = nullptr;
 };
@@ -601,6 +600,21 @@ public:
    */
   RC delete_entry(const char *user_key, const RID *rid);
 
+  /**
+   * @brief 批量插入排好序的规范化键值(参考 KeyNormalizer)
+   * @details 从根节点找到第一个键值所在的叶子节点之后，后面落在这个叶子节点范围内的键值直接插入，
+   * 叶子节点一直持有写锁，直到键值超出范围或者节点满了才重新从根节点查找。
+   * @param keys  count 个连续存放的键值，按字节从小到大排列
+   * @return 出错时立即返回，已经插入的键值由调用者删除
+   */
+  RC insert_entries(const char *keys, int count);
+
+  /**
+   * @brief 批量删除排好序的规范化键值，不存在的键值被忽略
+   * @details 与 insert_entries 一样沿着叶子节点连续删除，删除之后节点可能需要合并时才重新从根节点查找
+   */
+  RC delete_entries(const char *keys, int count);
+
   bool is_empty() const;
 
   /**
@@ -612,6 +626,16 @@ public:
 
   RC sync();
 
+  /**
+   * @brief 使用排好序的键值自底向上构建整棵树，只能在空树上调用
+   * @details 叶子节点从左到右依次填充到 fill_factor 的比例，再逐层向上构建内部节点，页面按顺序分配，
+   * 不会像逐条插入那样随机分裂出半满的节点。构建期间不加锁，调用者保证没有其它线程访问这个索引。
+   * 最后把所有页面刷到磁盘。
+   * @param fill_factor 节点填充的百分比，范围是 [50, 100]，留出的空间给后续的插入使用
+   * @return RECORD_DUPLICATE_KEY 唯一索引中有重复的字段值
+   */
+  RC bulk_load(BplusTreeKeySorter &sorter, int fill_factor);
+
   /**
    * Check whether current B+ tree is invalid or not.
    * @return true means current tree is valid, return false means current tree is invalid.
@@ -619,6 +643,8 @@ public:
    */
   bool validate_tree();
 
+  const KeyNormalizer &key_normalizer() const { return key_normalizer_; }
+
   const int is_unique() { return is_unique_; };
 
   void set_unique(const int unique) { is_unique_ = unique; }
@@ -646,16 +672,62 @@ private:
   RC print_internal_node_recursive(Frame *frame);
 
   bool validate_leaf_link(LatchMemo &latch_memo);
-  bool validate_node_recursive(LatchMemo &latch_memo, Frame *frame);
+
+  /**
+   * @brief 检查节点本身，以及节点中的键值都在父节点给出的范围 [lower_key, upper_key) 内
+   * @param lower_key 为空时表示没有下界
+   * @param upper_key 为空时表示没有上界
+   */
+  bool validate_node_recursive(
+      LatchMemo &latch_memo, Frame *frame, bool is_root_node, const char *lower_key, const char *upper_key);
+
+  /**
+   * @brief 把老版本的索引文件转换成当前的格式
+   * @details 去掉节点中保存的父节点页号，把键值转换成规范化编码。转换之后键值的顺序不变，所有节点的前缀都是空的
+   */
+  RC upgrade_node_format();
 
 protected:
   RC find_leaf(LatchMemo &latch_memo, BplusTreeOperationType op, const char *key, Frame *&frame);
+
+  /**
+   * @brief 查找叶子节点，同时返回叶子节点范围的上界(不包含)，即查找路径上最靠下的右侧分隔键值
+   * @param upper_key 至少 key_length 大小，has_upper_key 为 false 时表示是最右边的叶子节点，没有上界
+   */
+  RC find_leaf_with_upper_key(LatchMemo &latch_memo, BplusTreeOperationType op, const char *key, Frame *&frame,
+      char *upper_key, bool &has_upper_key);
   RC left_most_page(LatchMemo &latch_memo, Frame *&frame);
   RC find_leaf_internal(LatchMemo &latch_memo, BplusTreeOperationType op,
       const std::function<PageNum(InternalIndexNodeHandler &)> &child_page_getter, Frame *&frame);
   RC crabing_protocal_fetch_page(
       LatchMemo &latch_memo, BplusTreeOperationType op, PageNum page_num, bool is_root_page, Frame *&frame);
 
+  /**
+   * @brief 使用乐观锁耦合(optimistic lock coupling)的方式查找叶子节点，只能用于读操作
+   * @details 从根节点往下查找时不加根节点锁，也不加页面锁。拿到子节点的版本号(参考 Frame::version)之后，
+   * 再检查父节点的版本号没有变化，就说明从父节点中读到的子节点页号是有效的。检查失败说明有并发的修改，
+   * 就从根节点重新开始。这样只读的查找不会修改锁的状态，多个读者之间不会在根节点上互相争抢。
+   * 插入、删除这种可能修改树结构的操作依然使用 find_leaf 的加锁方式。
+   * @param key     要查找的键值，为空时查找最左边的叶子节点
+   * @param frame   返回找到的叶子节点，已经pin住，由调用者unpin
+   * @param version 返回叶子节点的版本号，调用者读完叶子节点的内容之后要检查版本号没有变化
+   * @param next_leaves 不为空时，返回父节点中排在这个叶子节点后面的最多 max_next_leaves 个叶子节点，用于预读。
+   * 读取时没有加锁，只能当作提示使用
+   */
+  RC optimistic_find_leaf(const char *key, Frame *&frame, uint64_t &version,
+      std::vector<PageNum> *next_leaves = nullptr, int max_next_leaves = 0);
+  RC optimistic_find_leaf_once(const char *key, Frame *&frame, uint64_t &version, bool &restart,
+      std::vector<PageNum> *next_leaves, int max_next_leaves, char *low_key = nullptr, bool *has_low_key = nullptr);
+
+  /**
+   * @brief 逆序扫描时使用，查找小于 key 的最大键值所在的叶子节点。key 为空时查找最右边的叶子节点
+   * @details 叶子节点之间只有向后的链表，逆序扫描每次都从根节点重新查找。父节点中的分隔键值只是子节点的下界，
+   * 找到的叶子节点中可能没有小于 key 的项，这时小于 key 的项都小于 low_key，用它继续查找
+   * @param low_key     返回叶子节点的键值下界，即路径上最后一个不是最左边的子节点对应的分隔键值
+   * @param has_low_key 返回是否有下界，没有时找到的是最左边的叶子节点
+   */
+  RC optimistic_find_prev_leaf(const char *key, Frame *&frame, uint64_t &version, char *low_key, bool &has_low_key);
+
   RC insert_into_parent(
       LatchMemo &latch_memo, PageNum parent_page, Frame *left_frame, const char *pkey, Frame &right_frame);
 
@@ -671,9 +743,25 @@ protected:
   RC redistribute(Frame *neighbor_frame, Frame *frame, Frame *parent_frame, int index);
 
   RC insert_entry_into_parent(LatchMemo &latch_memo, Frame *frame, Frame *new_frame, const char *key);
+
+  /**
+   * @brief 节点分裂之后，根据父节点中的边界键值和分裂使用的键值，尽量加长两个节点的公共前缀
+   * @param index 分裂之前的节点在父节点中的位置
+   * @param key   分裂之后新节点的第一个键值，也就是要插入到父节点中的键值
+   */
+  void extend_split_prefix(
+      InternalIndexNodeHandler &parent_node, int index, Frame *frame, Frame *new_frame, const char *key);
   RC insert_entry_into_leaf_node(LatchMemo &latch_memo, Frame *frame, const char *pkey, const RID *rid);
   RC create_new_tree(const char *key, const RID *rid);
 
+  /**
+   * @brief 批量构建一层节点
+   * @details 依次从 window 中取出若干项放到一个新节点中，每个节点的第一个键值和页号放到 parent_keys/parent_pages
+   * 中，作为上一层的输入
+   */
+  RC bulk_load_level(bool leaf, BplusTreeBulkLoadWindow &window, int fill_factor, std::vector<char> &parent_keys,
+      std::vector<PageNum> &parent_pages);
+
   void update_root_page_num(PageNum root_page_num);
   void update_root_page_num_locked(PageNum root_page_num);
 
@@ -692,6 +780,10 @@ protected:
   // 这个锁可以使用递归读写锁，但是这里偷懒先不改
   common::SharedMutex root_lock_;
 
+  /// 根节点页号的版本号，修改根节点时加1，修改期间是奇数。乐观读不加 root_lock_，使用它判断根节点是否变化
+  std::atomic<uint64_t> root_version_{0};
+
+  KeyNormalizer key_normalizer_;
   KeyComparator key_comparator_;
   KeyPrinter    key_printer_;
 
@@ -699,7 +791,7 @@ protected:
 
   const char *user_key_;
 
-  int is_unique_;
+  int is_unique_ = 0;
 
 private:
   friend class BplusTreeScanner;
@@ -713,10 +805,24 @@ private:
  */
 class BplusTreeScanner
 {
+public:
+  /// 默认预读多少个后续的叶子节点
+  static constexpr int DEFAULT_PREFETCH_LEAVES = 8;
+
 public:
   BplusTreeScanner(BplusTreeHandler &tree_handler);
   ~BplusTreeScanner();
 
+  /**
+   * @brief 设置预读的叶子节点个数，0表示不预读。需要在 open 之前设置
+   */
+  void set_prefetch_leaves(int count) { prefetch_leaves_ = std::max(0, count); }
+
+  /**
+   * @brief 按照键值从大到小扫描。需要在 open 之前设置
+   */
+  void set_reverse(bool reverse) { reverse_ = reverse; }
+
   /**
    * @brief 扫描指定范围的数据
    * @param left_user_key 扫描范围的左边界，如果是null，则没有左边界
@@ -739,20 +845,65 @@ private:
    */
   RC fix_user_key(const char *user_key, int key_len, bool want_greater, char **fixed_key, bool *should_inclusive);
 
-  void fetch_item(RID &rid);
-  bool touch_end();
+  /**
+   * @brief 从根节点开始，找到 seek_key_ 所在的叶子节点并加载
+   */
+  RC seek();
+
+  /**
+   * @brief 沿着叶子节点链表加载下一个叶子节点。当前叶子节点已经被修改时，使用 seek 重新定位
+   */
+  RC next_leaf();
+
+  /**
+   * @brief 把叶子节点中在右边界以内的数据复制出来
+   * @param from_seek_key 为true时从 seek_key_ 的位置开始，否则从叶子节点的第一项开始
+   * @return 读取期间叶子节点被修改了就返回false，这时读到的数据无效
+   */
+  bool load_leaf(Frame *frame, uint64_t version, bool from_seek_key);
+
+  /**
+   * @brief 逆序扫描时，把叶子节点中小于 seek_key_ 并且在左边界以内的数据从大到小复制出来
+   * @return 读取期间叶子节点被修改了就返回false，这时读到的数据无效
+   */
+  bool load_leaf_reverse(Frame *frame, uint64_t version);
+
+  /**
+   * @brief 当前叶子节点加载之后，提前读取后面的叶子节点
+   * @param next_leaves 从父节点中拿到的后续叶子节点，为空时重新从根节点查找一次
+   */
+  void prefetch(std::vector<PageNum> *next_leaves);
 
 private:
   bool              inited_ = false;
   BplusTreeHandler &tree_handler_;
 
-  LatchMemo latch_memo_;
-
-  /// 使用左右叶子节点和位置来表示扫描的起始位置和终止位置
-  /// 起始位置和终止位置都是有效的数据
-  Frame *current_frame_ = nullptr;
+  /// 扫描过程中不会一直pin住或者锁住叶子节点，每次把一个叶子节点中符合条件的数据复制出来，
+  /// 并记录叶子节点的版本号。访问下一个叶子节点时，如果当前叶子节点的版本号变了，就使用最后返回的
+  /// 键值重新从根节点查找
+  common::MemPoolItem::unique_ptr seek_key_;  ///< 重新定位时使用的键值
+  bool                            has_seek_key_   = false;  ///< 为false时从最左边的叶子节点开始
+  bool                            seek_exclusive_ = false;  ///< 重新定位时是否跳过与 seek_key_ 相等的键值
 
   common::MemPoolItem::unique_ptr right_key_;
-  int                             iter_index_    = -1;
-  bool                            first_emitted_ = false;
+
+  /// 逆序扫描时 seek_key_ 是上边界，每次从根节点查找小于它的项，left_key_ 是结束的位置
+  bool                            reverse_ = false;
+  common::MemPoolItem::unique_ptr left_key_;
+  common::MemPoolItem::unique_ptr low_key_;              ///< 当前叶子节点的键值下界
+  bool                            has_low_key_ = false;  ///< 为false时当前叶子节点是最左边的叶子节点
+
+  std::vector<RID> rids_;                                ///< 当前叶子节点中符合条件的数据
+  size_t           rid_index_    = 0;                    ///< 下一个要返回的 rids_ 下标
+  PageNum          leaf_page_    = BP_INVALID_PAGE_NUM;  ///< 当前叶子节点
+  uint64_t         leaf_version_ = 0;                    ///< 复制数据时当前叶子节点的版本号
+  PageNum          next_page_    = BP_INVALID_PAGE_NUM;  ///< 当前叶子节点的下一个叶子节点
+  bool             reach_end_    = true;                 ///< 已经扫描到右边界或最后一个叶子节点
+
+  std::vector<char> page_copy_ = std::vector<char>(BP_PAGE_DATA_SIZE);  ///< 不加锁读取叶子节点时复制出来的页面
+
+  /// 沿着叶子链表扫描时，每跨过一个叶子节点就要同步读取一个页面。这里从父节点中拿到后面的若干个叶子节点，
+  /// 提前让操作系统在后台读取。预读出去但是还没有扫描到的叶子节点少于一半时，再补充一批
+  int                 prefetch_leaves_ = DEFAULT_PREFETCH_LEAVES;
+  std::deque<PageNum> prefetched_leaves_;  ///< 已经发起预读还没有扫描到的叶子节点，按照链表顺序
 };
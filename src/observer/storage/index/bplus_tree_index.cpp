@@ -14,6 +14,12 @@ See the Mulan PSL v2 for more details. */
 
 #include "storage/index/bplus_tree_index.h"
 #include "common/log/log.h"
+#include "storage/index/bplus_tree_key_sorter.h"
+
+#include <algorithm>
+#include <inttypes.h>
+#include <numeric>
+#include <string.h>
 
 BplusTreeIndex::~BplusTreeIndex() noexcept { close(); }
 
@@ -114,43 +120,100 @@ RC BplusTreeIndex::close()
 RC BplusTreeIndex::insert_entry(const char *record, const RID *rid)
 {
   // return index_handler_.insert_entry(record + field_meta_.offset(), rid);
-  int len_sum = 0;
-  for (size_t i = 0; i < field_meta_.size(); i++) {
-    len_sum += field_meta_[i].len();
-  }
-
-  int  pos = 0;
-  char user_key[len_sum];
-  for (size_t i = 0; i < field_meta_.size(); i++) {
-    memcpy(user_key + pos, record + field_meta_[i].offset(), field_meta_[i].len());
-    pos += field_meta_[i].len();
-  }
+  std::vector<char> user_key(index_handler_.key_normalizer().attr_length());
+  make_user_key(record, user_key.data());
   LOG_DEBUG("[[[[[[[[[[[[[[[test multi-index]]]]]]]]]]]]]]]:RC BplusTreeIndex::insert_entry");
-  return index_handler_.insert_entry(user_key, rid);
+  return index_handler_.insert_entry(user_key.data(), rid);
 }
 
 RC BplusTreeIndex::delete_entry(const char *record, const RID *rid)
 {
   // return index_handler_.delete_entry(record + field_meta_.offset(), rid);
-  int len_sum = 0;
-  for (size_t i = 0; i < field_meta_.size(); i++) {
-    len_sum += field_meta_[i].len();
+  std::vector<char> user_key(index_handler_.key_normalizer().attr_length());
+  make_user_key(record, user_key.data());
+  return index_handler_.delete_entry(user_key.data(), rid);
+}
+
+RC BplusTreeIndex::insert_entries(const std::vector<Record> &records)
+{
+  std::vector<char> keys;
+  make_sorted_keys(records, keys);
+  return index_handler_.insert_entries(keys.data(), static_cast<int>(records.size()));
+}
+
+RC BplusTreeIndex::delete_entries(const std::vector<Record> &records)
+{
+  std::vector<char> keys;
+  make_sorted_keys(records, keys);
+  return index_handler_.delete_entries(keys.data(), static_cast<int>(records.size()));
+}
+
+void BplusTreeIndex::make_sorted_keys(const std::vector<Record> &records, std::vector<char> &keys) const
+{
+  const KeyNormalizer &normalizer = index_handler_.key_normalizer();
+  const size_t         key_length = normalizer.key_length();
+
+  std::vector<char> user_key(normalizer.attr_length());
+  std::vector<char> unsorted_keys(records.size() * key_length);
+  for (size_t i = 0; i < records.size(); i++) {
+    make_user_key(records[i].data(), user_key.data());
+    normalizer.normalize(user_key.data(), records[i].rid(), unsorted_keys.data() + i * key_length);
   }
 
-  int  pos = 0;
-  char user_key[len_sum];
-  for (size_t i = 0; i < field_meta_.size(); i++) {
-    memcpy(user_key + pos, record + field_meta_[i].offset(), field_meta_[i].len());
-    pos += field_meta_[i].len();
+  std::vector<size_t> order(records.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&unsorted_keys, key_length](size_t left, size_t right) {
+    return memcmp(unsorted_keys.data() + left * key_length, unsorted_keys.data() + right * key_length, key_length) < 0;
+  });
+
+  keys.resize(records.size() * key_length);
+  for (size_t i = 0; i < order.size(); i++) {
+    memcpy(keys.data() + i * key_length, unsorted_keys.data() + order[i] * key_length, key_length);
+  }
+}
+
+RC BplusTreeIndex::bulk_load(RecordFileScanner &scanner, const IndexBuildOptions &options, const char *run_file)
+{
+  BplusTreeKeySorter sorter;
+  RC rc = sorter.init(index_handler_.key_normalizer(), run_file, options.sort_buffer_size, options.threads);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init key sorter. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+    return rc;
   }
-  return index_handler_.delete_entry(user_key, rid);
+
+  std::vector<char> user_key(index_handler_.key_normalizer().attr_length());
+  Record            record;
+  while (scanner.has_next()) {
+    rc = scanner.next(record);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to scan records while loading index. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+      return rc;
+    }
+
+    make_user_key(record.data(), user_key.data());
+    rc = sorter.add(user_key.data(), record.rid());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to add key into sorter. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+      return rc;
+    }
+  }
+
+  rc = sorter.finish();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to sort index keys. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+    return rc;
+  }
+
+  LOG_INFO("sorted index keys. index=%s, keys=%" PRId64 ", runs=%d",
+      index_meta_.name(), sorter.count(), sorter.run_count());
+  return index_handler_.bulk_load(sorter, options.fill_factor);
 }
 
-IndexScanner *BplusTreeIndex::create_scanner(
-    const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len, bool right_inclusive)
+IndexScanner *BplusTreeIndex::create_scanner(const char *left_key, int left_len, bool left_inclusive,
+    const char *right_key, int right_len, bool right_inclusive, bool reverse)
 {
   BplusTreeIndexScanner *index_scanner = new BplusTreeIndexScanner(index_handler_);
-  RC rc = index_scanner->open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive);
+  RC rc = index_scanner->open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive, reverse);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to open index scanner. rc=%d:%s", rc, strrc(rc));
     delete index_scanner;
@@ -166,9 +229,10 @@ BplusTreeIndexScanner::BplusTreeIndexScanner(BplusTreeHandler &tree_handler) : t
 
 BplusTreeIndexScanner::~BplusTreeIndexScanner() noexcept { tree_scanner_.close(); }
 
-RC BplusTreeIndexScanner::open(
-    const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len, bool right_inclusive)
+RC BplusTreeIndexScanner::open(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
+    int right_len, bool right_inclusive, bool reverse)
 {
+  tree_scanner_.set_reverse(reverse);
   return tree_scanner_.open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive);
 }
 
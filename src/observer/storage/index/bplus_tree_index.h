@@ -31,21 +31,40 @@ public:
   // modify for multi index
   RC create(const char *file_name, const IndexMeta &index_meta, std::vector<FieldMeta> field_meta);
   RC open(const char *file_name, const IndexMeta &index_meta, std::vector<FieldMeta> &field_meta);
-  RC close();
+  RC close() override;
+
+  /**
+   * @brief 把表中已有的数据批量导入到刚创建的索引中
+   * @details 先取出所有记录的键值做外部排序，再自底向上构建B+树，参考 BplusTreeHandler::bulk_load
+   * @param run_file 排序使用的临时文件名前缀
+   */
+  RC bulk_load(RecordFileScanner &scanner, const IndexBuildOptions &options, const char *run_file) override;
 
   RC insert_entry(const char *record, const RID *rid) override;
   RC delete_entry(const char *record, const RID *rid) override;
 
+  /**
+   * @brief 先把键值排好序，再沿着叶子节点依次插入，参考 BplusTreeHandler::insert_entries
+   */
+  RC insert_entries(const std::vector<Record> &records) override;
+  RC delete_entries(const std::vector<Record> &records) override;
+
   const int is_unique(){return is_unique_;};
 
   /**
    * 扫描指定范围的数据
    */
   IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
-      int right_len, bool right_inclusive) override;
+      int right_len, bool right_inclusive, bool reverse = false) override;
 
   RC sync() override;
 
+private:
+  /**
+   * @brief 取出所有记录的规范化键值，按顺序连续存放到 keys 中
+   */
+  void make_sorted_keys(const std::vector<Record> &records, std::vector<char> &keys) const;
+
 private:
   bool             inited_ = false;
   int              is_unique_;
@@ -66,7 +85,7 @@ public:
   RC destroy() override;
 
   RC open(const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len,
-      bool right_inclusive);
+      bool right_inclusive, bool reverse);
 
 private:
   BplusTreeScanner tree_scanner_;
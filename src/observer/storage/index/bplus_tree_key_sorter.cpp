@@ -0,0 +1,303 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/bplus_tree_key_sorter.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits>
+#include <numeric>
+#include <string.h>
+#include <thread>
+#include <unistd.h>
+
+#include "common/io/io.h"
+#include "common/log/log.h"
+
+using namespace std;
+using namespace common;
+
+/// 读写临时文件时每次处理的数据量
+static constexpr int RUN_IO_SIZE = 256 * 1024;
+
+/// 每个线程至少排序这么多个键值，太少时不值得启动线程
+static constexpr int64_t MIN_KEYS_PER_THREAD = 8192;
+
+BplusTreeKeySorter::~BplusTreeKeySorter() { cleanup(); }
+
+RC BplusTreeKeySorter::init(const KeyNormalizer &normalizer, const string &run_file, int64_t memory_size, int threads)
+{
+  normalizer_ = normalizer;
+  run_file_   = run_file;
+  key_length_ = normalizer.key_length();
+
+  const int64_t max_keys = memory_size / (key_length_ + static_cast<int64_t>(sizeof(uint32_t)));
+  max_keys_ = std::clamp<int64_t>(max_keys, 1, numeric_limits<uint32_t>::max());
+
+  if (threads <= 0) {
+    threads = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  threads_ = std::max(1, threads);
+
+  LOG_INFO("init index key sorter. key length=%d, memory=%" PRId64 ", max keys in memory=%" PRId64 ", threads=%d",
+      key_length_, memory_size, max_keys_, threads_);
+  return RC::SUCCESS;
+}
+
+RC BplusTreeKeySorter::add(const char *user_key, const RID &rid)
+{
+  if (finished_) {
+    return RC::INTERNAL;
+  }
+
+  if (static_cast<int64_t>(buffer_.size()) >= max_keys_ * key_length_) {
+    RC rc = spill();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  const size_t offset = buffer_.size();
+  buffer_.resize(offset + key_length_);
+  normalizer_.normalize(user_key, rid, buffer_.data() + offset);
+  count_++;
+  return RC::SUCCESS;
+}
+
+void BplusTreeKeySorter::sort_buffer()
+{
+  const int64_t count = static_cast<int64_t>(buffer_.size()) / key_length_;
+  order_.resize(count);
+  std::iota(order_.begin(), order_.end(), 0);
+
+  const char *keys       = buffer_.data();
+  const int   key_length = key_length_;
+  auto        less       = [keys, key_length](uint32_t left, uint32_t right) {
+    return memcmp(keys + static_cast<size_t>(left) * key_length, keys + static_cast<size_t>(right) * key_length,
+               key_length) < 0;
+  };
+
+  const int parts = static_cast<int>(std::clamp<int64_t>(count / MIN_KEYS_PER_THREAD, 1, threads_));
+  if (parts <= 1) {
+    std::sort(order_.begin(), order_.end(), less);
+    return;
+  }
+
+  // 分成 parts 段并行排序，再一轮一轮地两两归并
+  vector<int64_t> bounds(parts + 1);
+  for (int i = 0; i <= parts; i++) {
+    bounds[i] = count * i / parts;
+  }
+
+  vector<thread> workers;
+  for (int i = 0; i < parts; i++) {
+    workers.emplace_back([this, &bounds, &less, i]() {
+      std::sort(order_.begin() + bounds[i], order_.begin() + bounds[i + 1], less);
+    });
+  }
+  for (thread &worker : workers) {
+    worker.join();
+  }
+
+  for (int width = 1; width < parts; width *= 2) {
+    workers.clear();
+    for (int i = 0; i + width < parts; i += 2 * width) {
+      const int64_t first  = bounds[i];
+      const int64_t middle = bounds[i + width];
+      const int64_t last   = bounds[std::min(i + 2 * width, parts)];
+      workers.emplace_back([this, &less, first, middle, last]() {
+        std::inplace_merge(order_.begin() + first, order_.begin() + middle, order_.begin() + last, less);
+      });
+    }
+    for (thread &worker : workers) {
+      worker.join();
+    }
+  }
+}
+
+RC BplusTreeKeySorter::spill()
+{
+  sort_buffer();
+
+  Run run;
+  run.file_name = run_file_ + "." + std::to_string(runs_.size());
+  run.fd        = ::open(run.file_name.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0600);
+  if (run.fd < 0) {
+    LOG_WARN("failed to create index sort run file. file=%s, error=%s", run.file_name.c_str(), strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+  runs_.push_back(std::move(run));
+
+  Run         &current    = runs_.back();
+  const size_t batch_size = std::max<size_t>(1, RUN_IO_SIZE / key_length_) * key_length_;
+  vector<char> output;
+  output.reserve(batch_size);
+  auto flush = [&current, &output]() {
+    int ret = writen(current.fd, output.data(), static_cast<int>(output.size()));
+    if (ret != 0) {
+      LOG_WARN("failed to write index sort run file. file=%s, error=%s", current.file_name.c_str(), strerror(ret));
+      return RC::IOERR_WRITE;
+    }
+    output.clear();
+    return RC::SUCCESS;
+  };
+
+  RC rc = RC::SUCCESS;
+  for (uint32_t index : order_) {
+    const char *key = buffer_.data() + static_cast<size_t>(index) * key_length_;
+    output.insert(output.end(), key, key + key_length_);
+    if (output.size() >= batch_size && OB_FAIL(rc = flush())) {
+      return rc;
+    }
+  }
+  if (!output.empty() && OB_FAIL(rc = flush())) {
+    return rc;
+  }
+
+  current.remain = static_cast<int64_t>(order_.size());
+  LOG_INFO("spilled sorted index keys to run file. file=%s, keys=%" PRId64, current.file_name.c_str(), current.remain);
+
+  buffer_.clear();
+  order_.clear();
+  return RC::SUCCESS;
+}
+
+RC BplusTreeKeySorter::load_run(Run &run)
+{
+  run.pos   = 0;
+  run.limit = 0;
+  if (run.remain <= 0) {
+    return RC::SUCCESS;
+  }
+
+  const int64_t keys = std::min<int64_t>(run.remain, static_cast<int64_t>(run.buffer.size()) / key_length_);
+  const int     size = static_cast<int>(keys * key_length_);
+  int           ret  = readn(run.fd, run.buffer.data(), size);
+  if (ret != 0) {
+    LOG_WARN("failed to read index sort run file. file=%s, ret=%d", run.file_name.c_str(), ret);
+    return RC::IOERR_READ;
+  }
+
+  run.limit = size;
+  run.remain -= keys;
+  return RC::SUCCESS;
+}
+
+RC BplusTreeKeySorter::finish()
+{
+  if (finished_) {
+    return RC::SUCCESS;
+  }
+  finished_ = true;
+
+  if (runs_.empty()) {
+    sort_buffer();
+    next_ = 0;
+    return RC::SUCCESS;
+  }
+
+  RC rc = RC::SUCCESS;
+  if (!buffer_.empty()) {
+    rc = spill();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  vector<char>().swap(buffer_);
+  vector<uint32_t>().swap(order_);
+
+  const size_t buffer_size = std::max<size_t>(1, RUN_IO_SIZE / key_length_) * key_length_;
+  for (int i = 0; i < static_cast<int>(runs_.size()); i++) {
+    Run &run = runs_[i];
+    if (::lseek(run.fd, 0, SEEK_SET) < 0) {
+      LOG_WARN("failed to seek index sort run file. file=%s, error=%s", run.file_name.c_str(), strerror(errno));
+      return RC::IOERR_SEEK;
+    }
+    run.buffer.resize(buffer_size);
+    rc = load_run(run);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    if (run.limit > 0) {
+      heap_.push_back(i);
+    }
+  }
+
+  auto greater = [this](int left, int right) {
+    return memcmp(runs_[left].buffer.data() + runs_[left].pos, runs_[right].buffer.data() + runs_[right].pos,
+               key_length_) > 0;
+  };
+  std::make_heap(heap_.begin(), heap_.end(), greater);
+
+  LOG_INFO("merging index sort runs. runs=%d, keys=%" PRId64, static_cast<int>(runs_.size()), count_);
+  return RC::SUCCESS;
+}
+
+RC BplusTreeKeySorter::next(const char *&key)
+{
+  if (!finished_) {
+    return RC::INTERNAL;
+  }
+
+  if (runs_.empty()) {
+    if (next_ >= order_.size()) {
+      return RC::RECORD_EOF;
+    }
+    key = buffer_.data() + static_cast<size_t>(order_[next_++]) * key_length_;
+    return RC::SUCCESS;
+  }
+
+  auto greater = [this](int left, int right) {
+    return memcmp(runs_[left].buffer.data() + runs_[left].pos, runs_[right].buffer.data() + runs_[right].pos,
+               key_length_) > 0;
+  };
+
+  // 上一次返回的键值已经不再使用了，这个run前进一个键值后重新放回堆中
+  if (last_run_ >= 0) {
+    Run &run = runs_[last_run_];
+    run.pos += key_length_;
+    if (run.pos >= run.limit) {
+      RC rc = load_run(run);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+    if (run.limit > 0) {
+      heap_.push_back(last_run_);
+      std::push_heap(heap_.begin(), heap_.end(), greater);
+    }
+    last_run_ = -1;
+  }
+
+  if (heap_.empty()) {
+    return RC::RECORD_EOF;
+  }
+
+  std::pop_heap(heap_.begin(), heap_.end(), greater);
+  last_run_ = heap_.back();
+  heap_.pop_back();
+
+  const Run &run = runs_[last_run_];
+  key            = run.buffer.data() + run.pos;
+  return RC::SUCCESS;
+}
+
+void BplusTreeKeySorter::cleanup()
+{
+  for (Run &run : runs_) {
+    if (run.fd >= 0) {
+      ::close(run.fd);
+      run.fd = -1;
+    }
+    ::unlink(run.file_name.c_str());
+  }
+  runs_.clear();
+}
@@ -0,0 +1,97 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/rc.h"
+#include "storage/index/bplus_tree.h"
+
+/**
+ * @brief 批量创建索引时对键值做外部排序
+ * @ingroup BPlusTree
+ * @details 键值先规范化(参考 KeyNormalizer)再放到内存中，规范化之后的键值包含RID，互不相等，
+ * 按字节比较就是索引中的顺序。内存中的键值超过 memory_size 时，排好序写到一个临时文件中(一个run)，
+ * 最后把所有的run归并起来，按顺序逐个返回。
+ * 内存中的排序会把数据分成多段，由多个线程并行排序，再逐轮两两归并。
+ * 所有键值都放得下时不会写临时文件。
+ */
+class BplusTreeKeySorter
+{
+public:
+  BplusTreeKeySorter() = default;
+  ~BplusTreeKeySorter();
+
+  /**
+   * @param normalizer  键值的编码方式
+   * @param run_file    临时文件名的前缀，实际的文件名是 run_file.序号
+   * @param memory_size 内存中最多缓存多少字节的键值
+   * @param threads     内存排序使用的线程数，小于等于0时由CPU个数决定
+   */
+  RC init(const KeyNormalizer &normalizer, const std::string &run_file, int64_t memory_size, int threads);
+
+  /**
+   * @brief 添加一个键值
+   * @param user_key 字段的原始值
+   */
+  RC add(const char *user_key, const RID &rid);
+
+  /**
+   * @brief 所有键值都添加完了，准备按顺序读取
+   */
+  RC finish();
+
+  /**
+   * @brief 按顺序返回下一个规范化的键值
+   * @details 返回的内存在下一次调用之前有效
+   * @return RECORD_EOF 没有更多的键值
+   */
+  RC next(const char *&key);
+
+  int64_t count() const { return count_; }
+  int     key_length() const { return key_length_; }
+  int     run_count() const { return static_cast<int>(runs_.size()); }
+
+private:
+  /// 一个写到临时文件中的有序段
+  struct Run
+  {
+    std::string       file_name;
+    int               fd = -1;
+    std::vector<char> buffer;      ///< 读取时的缓存
+    int               pos    = 0;  ///< 缓存中当前键值的位置
+    int               limit  = 0;  ///< 缓存中有效数据的长度
+    int64_t           remain = 0;  ///< 文件中还没有读到缓存的键值个数
+  };
+
+  void sort_buffer();
+  RC   spill();
+  RC   load_run(Run &run);
+  void cleanup();
+
+private:
+  KeyNormalizer normalizer_;
+  std::string   run_file_;
+  int           key_length_ = 0;
+  int64_t       max_keys_   = 0;  ///< 内存中最多缓存的键值个数
+  int           threads_    = 1;
+
+  std::vector<char>     buffer_;  ///< 内存中的键值
+  std::vector<uint32_t> order_;   ///< 排序后键值在 buffer_ 中的序号
+  int64_t               count_ = 0;
+
+  std::vector<Run> runs_;
+  std::vector<int> heap_;           ///< 归并时的最小堆，保存 runs_ 的下标
+  int              last_run_ = -1;  ///< 上一次返回的键值来自哪个run
+  size_t           next_     = 0;   ///< 没有临时文件时，下一个要返回的是 order_ 中的第几个
+  bool             finished_ = false;
+};
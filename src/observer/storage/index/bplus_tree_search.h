@@ -0,0 +1,193 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief B+树节点内的键值查找
+ * @ingroup BPlusTree
+ * @details 节点中的键值都是规范化之后的格式(参考 KeyNormalizer)，按字节比较的顺序就是键值的顺序，
+ * 所以查找时与字段类型无关，只与参与比较的字节数(去掉节点公共前缀后的后缀长度)有关。
+ * 单列的 INTS/DATES/FLOATS 索引键值是 4 + sizeof(RID) = 12 个字节，两列整数是 16 个字节，
+ * 这类短键值使用按长度特化的模板：把后缀当成两个大端整数比较，并且使用没有分支的二分查找，
+ * 循环的次数只与项数有关。更长的键值使用通用的 memcmp 查找。
+ */
+namespace bplus_tree_search {
+
+/**
+ * @brief 节点内查找函数
+ *
+ * @param items     第一项的地址，每项的前 key_size 个字节是键值(后缀)
+ * @param item_size 每项的大小
+ * @param count     项数
+ * @param key       要查找的键值(后缀)
+ * @param key_size  参与比较的字节数
+ * @param found     如果给定，返回是否找到相等的项
+ * @return int 第一个不小于 key 的项的下标，都小于 key 时返回 count
+ */
+using SearchFunc = int (*)(const char *items, int item_size, int count, const char *key, int key_size, bool *found);
+
+/// 使用特化查找的最大键值长度
+static constexpr int MAX_SPECIALIZED_KEY_SIZE = 16;
+
+/**
+ * @brief 通用的查找，逐项 memcmp，遇到相等的项提前结束
+ */
+inline int generic_lower_bound(
+    const char *items, int item_size, int count, const char *key, int key_size, bool *found)
+{
+  int  first    = 0;
+  int  length   = count;
+  bool is_found = false;
+  while (length > 0) {
+    const int step   = length / 2;
+    const int middle = first + step;
+    const int result = memcmp(items + middle * item_size, key, key_size);
+    if (result == 0) {
+      first    = middle;
+      is_found = true;
+      break;
+    }
+    if (result < 0) {
+      first = middle + 1;
+      length -= step + 1;
+    } else {
+      length = step;
+    }
+  }
+
+  if (found) {
+    *found = is_found;
+  }
+  return first;
+}
+
+/**
+ * @brief 把 N 个字节读成两个大端整数，不足的部分补0
+ * @details N 是常量，memcpy 会被编译成几条 mov 指令
+ */
+template <int N>
+struct FixedKey
+{
+  static_assert(N > 0 && N <= MAX_SPECIALIZED_KEY_SIZE);
+
+  uint64_t high = 0;
+  uint64_t low  = 0;
+
+  explicit FixedKey(const char *data)
+  {
+    if constexpr (N <= 8) {
+      memcpy(&high, data, N);
+    } else {
+      memcpy(&high, data, 8);
+      memcpy(&low, data + 8, N - 8);
+      low = __builtin_bswap64(low);
+    }
+    high = __builtin_bswap64(high);
+  }
+
+  bool less(const FixedKey &other) const
+  {
+    if constexpr (N <= 8) {
+      return high < other.high;
+    } else {
+      return (high < other.high) | ((high == other.high) & (low < other.low));
+    }
+  }
+
+  bool equal(const FixedKey &other) const
+  {
+    if constexpr (N <= 8) {
+      return high == other.high;
+    } else {
+      return (high == other.high) & (low == other.low);
+    }
+  }
+};
+
+/**
+ * @brief 按键值长度特化的查找
+ * @details 每轮把区间缩小一半，用条件赋值代替分支，最后再判断是否相等
+ */
+template <int N>
+int fixed_lower_bound(const char *items, int item_size, int count, const char *key, int /*key_size*/, bool *found)
+{
+  if (count <= 0) {
+    if (found) {
+      *found = false;
+    }
+    return 0;
+  }
+
+  const FixedKey<N> target(key);
+
+  int base   = 0;
+  int length = count;
+  while (length > 1) {
+    const int  half = length / 2;
+    const bool less = FixedKey<N>(items + (base + half - 1) * item_size).less(target);
+    base += half * static_cast<int>(less);
+    length -= half;
+  }
+
+  const FixedKey<N> last(items + base * item_size);
+  const bool        last_less = last.less(target);
+  if (found) {
+    *found = !last_less && last.equal(target);
+  }
+  return base + (last_less ? 1 : 0);
+}
+
+/**
+ * @brief 键值长度为0时所有项都相等
+ */
+inline int empty_lower_bound(const char * /*items*/, int /*item_size*/, int count, const char * /*key*/,
+    int /*key_size*/, bool *found)
+{
+  if (found) {
+    *found = count > 0;
+  }
+  return 0;
+}
+
+/**
+ * @brief 根据参与比较的字节数选择查找函数
+ */
+inline SearchFunc search_function(int key_size)
+{
+  static constexpr SearchFunc functions[MAX_SPECIALIZED_KEY_SIZE + 1] = {
+      empty_lower_bound,
+      fixed_lower_bound<1>,
+      fixed_lower_bound<2>,
+      fixed_lower_bound<3>,
+      fixed_lower_bound<4>,
+      fixed_lower_bound<5>,
+      fixed_lower_bound<6>,
+      fixed_lower_bound<7>,
+      fixed_lower_bound<8>,
+      fixed_lower_bound<9>,
+      fixed_lower_bound<10>,
+      fixed_lower_bound<11>,
+      fixed_lower_bound<12>,
+      fixed_lower_bound<13>,
+      fixed_lower_bound<14>,
+      fixed_lower_bound<15>,
+      fixed_lower_bound<16>,
+  };
+  if (key_size >= 0 && key_size <= MAX_SPECIALIZED_KEY_SIZE) {
+    return functions[key_size];
+  }
+  return generic_lower_bound;
+}
+
+}  // namespace bplus_tree_search
@@ -0,0 +1,617 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/extendible_hash.h"
+
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string.h>
+
+#include "common/log/log.h"
+
+using namespace std;
+using namespace common;
+
+/// 文件头所在的页面，第0个页面是缓冲池自己的文件头
+static constexpr PageNum HASH_HEADER_PAGE = 1;
+
+static HashBucketPage *bucket_page(Frame *frame) { return reinterpret_cast<HashBucketPage *>(frame->data()); }
+
+uint64_t ExtendibleHashHandler::hash_of(const char *key) const
+{
+  // 只对字段值部分计算哈希，相同的字段值总是落在同一个桶中
+  uint64_t hash = 14695981039346656037ULL;
+  for (int i = 0; i < key_normalizer_.attr_length(); i++) {
+    hash ^= static_cast<unsigned char>(key[i]);
+    hash *= 1099511628211ULL;
+  }
+
+  // FNV 的低位分布不够均匀，而目录使用的恰恰是低位，再做一次混淆
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+RC ExtendibleHashHandler::create(const char *file_name, vector<AttrType> attr_type, vector<int> attr_length)
+{
+  if (attr_type.empty() || attr_type.size() > MAX_NUM || attr_type.size() != attr_length.size()) {
+    LOG_WARN("invalid hash index attributes. file name=%s, attr num=%d", file_name, static_cast<int>(attr_type.size()));
+    return RC::INVALID_ARGUMENT;
+  }
+
+  BufferPoolManager &bpm = BufferPoolManager::instance();
+
+  RC rc = bpm.create_file(file_name);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to create hash index file. file name=%s, rc=%s", file_name, strrc(rc));
+    return rc;
+  }
+
+  rc = bpm.open_file(file_name, disk_buffer_pool_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open hash index file. file name=%s, rc=%s", file_name, strrc(rc));
+    return rc;
+  }
+
+  Frame *header_frame = nullptr;
+  rc                  = disk_buffer_pool_->allocate_page(&header_frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate header page for hash index. rc=%s", strrc(rc));
+    close();
+    return rc;
+  }
+  const PageNum header_page = header_frame->page_num();
+  disk_buffer_pool_->unpin_page(header_frame);
+  if (header_page != HASH_HEADER_PAGE) {
+    LOG_WARN("header page num should be %d but got %d. is it a new file : %s", HASH_HEADER_PAGE, header_page, file_name);
+    close();
+    return RC::INTERNAL;
+  }
+
+  key_normalizer_.init(attr_type, attr_length);
+
+  memset(&file_header_, 0, sizeof(file_header_));
+  file_header_.format_version = HashIndexFileHeader::CURRENT_FORMAT_VERSION;
+  file_header_.attr_num       = static_cast<int32_t>(attr_type.size());
+  for (size_t i = 0; i < attr_type.size(); i++) {
+    file_header_.attr_length[i] = attr_length[i];
+    file_header_.attr_type[i]   = attr_type[i];
+  }
+  file_header_.key_length     = key_normalizer_.key_length();
+  file_header_.global_depth   = 0;
+  file_header_.dir_page_count = 0;
+
+  if (bucket_capacity() < 2) {
+    LOG_WARN("hash index key is too long. file name=%s, key length=%d", file_name, file_header_.key_length);
+    close();
+    return RC::INVALID_ARGUMENT;
+  }
+
+  Frame *frame = nullptr;
+  rc           = allocate_bucket(0, frame);
+  if (OB_FAIL(rc)) {
+    close();
+    return rc;
+  }
+  directory_.assign(1, frame->page_num());
+  disk_buffer_pool_->unpin_page(frame);
+
+  rc = write_directory({0});
+  if (OB_SUCC(rc)) {
+    rc = sync();
+  }
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init hash index. file name=%s, rc=%s", file_name, strrc(rc));
+    close();
+    return rc;
+  }
+
+  LOG_INFO("Successfully create hash index %s", file_name);
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::open(const char *file_name)
+{
+  if (disk_buffer_pool_ != nullptr) {
+    LOG_WARN("%s has been opened before index.open.", file_name);
+    return RC::RECORD_OPENNED;
+  }
+
+  RC rc = BufferPoolManager::instance().open_file(file_name, disk_buffer_pool_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to open hash index file. file name=%s, rc=%s", file_name, strrc(rc));
+    return rc;
+  }
+
+  Frame *frame = nullptr;
+  rc           = disk_buffer_pool_->get_this_page(HASH_HEADER_PAGE, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get header page of hash index. file name=%s, rc=%s", file_name, strrc(rc));
+    close();
+    return rc;
+  }
+  memcpy(&file_header_, frame->data(), sizeof(file_header_));
+  disk_buffer_pool_->unpin_page(frame);
+
+  if (file_header_.format_version != HashIndexFileHeader::CURRENT_FORMAT_VERSION) {
+    LOG_WARN("unsupported hash index format. file name=%s, version=%d", file_name, file_header_.format_version);
+    close();
+    return RC::INTERNAL;
+  }
+
+  vector<AttrType> attr_type(file_header_.attr_type, file_header_.attr_type + file_header_.attr_num);
+  vector<int>      attr_length(file_header_.attr_length, file_header_.attr_length + file_header_.attr_num);
+  key_normalizer_.init(attr_type, attr_length);
+
+  rc = load_directory();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to load hash index directory. file name=%s, rc=%s", file_name, strrc(rc));
+    close();
+    return rc;
+  }
+
+  LOG_INFO("Successfully open hash index %s. global depth=%d", file_name, file_header_.global_depth);
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::close()
+{
+  if (disk_buffer_pool_ != nullptr) {
+    disk_buffer_pool_->close_file();
+  }
+  disk_buffer_pool_ = nullptr;
+  directory_.clear();
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::sync()
+{
+  RC rc = write_header();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  return disk_buffer_pool_->flush_all_pages();
+}
+
+RC ExtendibleHashHandler::write_header()
+{
+  Frame *frame = nullptr;
+  RC     rc    = disk_buffer_pool_->get_this_page(HASH_HEADER_PAGE, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get header page of hash index. rc=%s", strrc(rc));
+    return rc;
+  }
+  memcpy(frame->data(), &file_header_, sizeof(file_header_));
+  frame->mark_dirty();
+  disk_buffer_pool_->unpin_page(frame);
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::load_directory()
+{
+  const size_t entries = size_t(1) << file_header_.global_depth;
+  directory_.resize(entries);
+  for (int i = 0; i < file_header_.dir_page_count; i++) {
+    Frame *frame = nullptr;
+    RC     rc    = disk_buffer_pool_->get_this_page(file_header_.dir_pages[i], &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get directory page. page num=%d, rc=%s", file_header_.dir_pages[i], strrc(rc));
+      return rc;
+    }
+
+    const size_t begin = size_t(i) * HashIndexFileHeader::DIR_ENTRIES_PER_PAGE;
+    const size_t count = std::min<size_t>(HashIndexFileHeader::DIR_ENTRIES_PER_PAGE, entries - begin);
+    memcpy(directory_.data() + begin, frame->data(), count * sizeof(PageNum));
+    disk_buffer_pool_->unpin_page(frame);
+  }
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::write_directory(const set<int> &dirty_pages)
+{
+  RC rc = RC::SUCCESS;
+  for (int page_index : dirty_pages) {
+    // 目录翻倍之后可能需要更多的页面
+    while (file_header_.dir_page_count <= page_index) {
+      Frame *frame = nullptr;
+      rc           = disk_buffer_pool_->allocate_page(&frame);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to allocate directory page. rc=%s", strrc(rc));
+        return rc;
+      }
+      file_header_.dir_pages[file_header_.dir_page_count++] = frame->page_num();
+      disk_buffer_pool_->unpin_page(frame);
+    }
+
+    Frame *frame = nullptr;
+    rc           = disk_buffer_pool_->get_this_page(file_header_.dir_pages[page_index], &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get directory page. page num=%d, rc=%s", file_header_.dir_pages[page_index], strrc(rc));
+      return rc;
+    }
+
+    const size_t begin = size_t(page_index) * HashIndexFileHeader::DIR_ENTRIES_PER_PAGE;
+    const size_t count = std::min<size_t>(HashIndexFileHeader::DIR_ENTRIES_PER_PAGE, directory_.size() - begin);
+    memcpy(frame->data(), directory_.data() + begin, count * sizeof(PageNum));
+    frame->mark_dirty();
+    disk_buffer_pool_->unpin_page(frame);
+  }
+  return rc;
+}
+
+RC ExtendibleHashHandler::allocate_bucket(int local_depth, Frame *&frame)
+{
+  RC rc = disk_buffer_pool_->allocate_page(&frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to allocate hash bucket page. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  HashBucketPage *bucket = bucket_page(frame);
+  bucket->local_depth    = local_depth;
+  bucket->size           = 0;
+  bucket->overflow_page  = BP_INVALID_PAGE_NUM;
+  frame->mark_dirty();
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::append_key(Frame *frame, const char *key)
+{
+  const int capacity = bucket_capacity();
+
+  // frame 是桶的第一个页面，由调用者释放。找到链表中第一个有空闲位置的页面，都满了就再挂一个溢出页面
+  Frame *current = frame;
+  RC     rc      = RC::SUCCESS;
+  while (bucket_page(current)->size >= capacity) {
+    HashBucketPage *bucket = bucket_page(current);
+    Frame          *next   = nullptr;
+    if (bucket->overflow_page == BP_INVALID_PAGE_NUM) {
+      rc = allocate_bucket(0, next);
+      if (OB_SUCC(rc)) {
+        bucket->overflow_page = next->page_num();
+        current->mark_dirty();
+      }
+    } else {
+      rc = disk_buffer_pool_->get_this_page(bucket->overflow_page, &next);
+    }
+
+    if (current != frame) {
+      disk_buffer_pool_->unpin_page(current);
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get hash overflow page. rc=%s", strrc(rc));
+      return rc;
+    }
+    current = next;
+  }
+
+  HashBucketPage *bucket = bucket_page(current);
+  memcpy(bucket->keys + bucket->size * file_header_.key_length, key, file_header_.key_length);
+  bucket->size++;
+  current->mark_dirty();
+  if (current != frame) {
+    disk_buffer_pool_->unpin_page(current);
+  }
+  return RC::SUCCESS;
+}
+
+RC ExtendibleHashHandler::split_bucket(PageNum page_num, Frame *frame)
+{
+  HashBucketPage *bucket      = bucket_page(frame);
+  const int       local_depth = bucket->local_depth;
+  const int       key_length  = file_header_.key_length;
+
+  set<int> dirty_pages;
+  if (local_depth == file_header_.global_depth) {
+    const size_t old_size = directory_.size();
+    directory_.resize(old_size * 2);
+    std::copy(directory_.begin(), directory_.begin() + old_size, directory_.begin() + old_size);
+    file_header_.global_depth++;
+
+    const int page_count =
+        static_cast<int>((directory_.size() + HashIndexFileHeader::DIR_ENTRIES_PER_PAGE - 1) /
+                         HashIndexFileHeader::DIR_ENTRIES_PER_PAGE);
+    for (int i = static_cast<int>(old_size / HashIndexFileHeader::DIR_ENTRIES_PER_PAGE); i < page_count; i++) {
+      dirty_pages.insert(i);
+    }
+  }
+
+  // 取出整个链表中的键值，释放溢出页面，再按照第 local_depth 位重新分配
+  vector<char> keys(bucket->keys, bucket->keys + bucket->size * key_length);
+  PageNum      overflow_page = bucket->overflow_page;
+  RC           rc            = RC::SUCCESS;
+  while (overflow_page != BP_INVALID_PAGE_NUM) {
+    Frame *overflow_frame = nullptr;
+    rc                    = disk_buffer_pool_->get_this_page(overflow_page, &overflow_frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get hash overflow page. page num=%d, rc=%s", overflow_page, strrc(rc));
+      return rc;
+    }
+    HashBucketPage *overflow = bucket_page(overflow_frame);
+    keys.insert(keys.end(), overflow->keys, overflow->keys + overflow->size * key_length);
+    const PageNum current = overflow_page;
+    overflow_page         = overflow->overflow_page;
+    disk_buffer_pool_->unpin_page(overflow_frame);
+    rc = disk_buffer_pool_->dispose_page(current);
+    if (OB_FAIL(rc)) {
+      // 键值已经取出来了，页面释放失败只是浪费一个页面
+      LOG_WARN("failed to dispose hash overflow page. page num=%d, rc=%s", current, strrc(rc));
+    }
+  }
+
+  Frame *new_frame = nullptr;
+  rc               = allocate_bucket(local_depth + 1, new_frame);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  bucket->local_depth   = local_depth + 1;
+  bucket->size          = 0;
+  bucket->overflow_page = BP_INVALID_PAGE_NUM;
+  frame->mark_dirty();
+
+  for (size_t offset = 0; offset < keys.size() && OB_SUCC(rc); offset += key_length) {
+    const char *key = keys.data() + offset;
+    rc              = append_key((hash_of(key) >> local_depth) & 1 ? new_frame : frame, key);
+  }
+
+  const PageNum new_page = new_frame->page_num();
+  disk_buffer_pool_->unpin_page(new_frame);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  // 原来指向这个桶的目录项中，第 local_depth 位是1的都指向新的桶
+  const size_t step = size_t(1) << local_depth;
+  for (size_t i = 0; i < directory_.size(); i++) {
+    if (directory_[i] == page_num && (i & step) != 0) {
+      directory_[i] = new_page;
+      dirty_pages.insert(static_cast<int>(i / HashIndexFileHeader::DIR_ENTRIES_PER_PAGE));
+    }
+  }
+
+  rc = write_directory(dirty_pages);
+  if (OB_SUCC(rc)) {
+    rc = write_header();
+  }
+  return rc;
+}
+
+RC ExtendibleHashHandler::insert_entry(const char *user_key, const RID *rid)
+{
+  vector<char> key(file_header_.key_length);
+  key_normalizer_.normalize(user_key, *rid, key.data());
+
+  const int      attr_length = key_normalizer_.attr_length();
+  const int      key_length  = file_header_.key_length;
+  const int      capacity    = bucket_capacity();
+  const uint64_t hash        = hash_of(key.data());
+
+  lock_guard<SharedMutex> guard(lock_);
+  while (true) {
+    const PageNum page_num = bucket_of(hash);
+    Frame        *frame    = nullptr;
+    RC            rc       = disk_buffer_pool_->get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get hash bucket page. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    // 检查重复的同时，看看链表中的键值能不能通过分裂分开
+    const int      local_depth = bucket_page(frame)->local_depth;
+    const uint64_t split_mask  = ((1ULL << HashIndexFileHeader::MAX_GLOBAL_DEPTH) - 1) & ~((1ULL << local_depth) - 1);
+    bool           has_space   = false;
+    bool           splittable  = false;
+    Frame         *current     = frame;
+    while (OB_SUCC(rc)) {
+      HashBucketPage *bucket = bucket_page(current);
+      for (int i = 0; i < bucket->size; i++) {
+        const char *item = bucket->keys + i * key_length;
+        if (memcmp(item, key.data(), attr_length) == 0) {
+          if (is_unique_ == 1 || memcmp(item, key.data(), key_length) == 0) {
+            rc = RC::RECORD_DUPLICATE_KEY;
+            break;
+          }
+        } else if (!splittable && ((hash_of(item) ^ hash) & split_mask) != 0) {
+          splittable = true;
+        }
+      }
+      has_space = has_space || bucket->size < capacity;
+
+      const PageNum next_page = bucket->overflow_page;
+      if (current != frame) {
+        disk_buffer_pool_->unpin_page(current);
+      }
+      current = nullptr;
+      if (OB_FAIL(rc) || next_page == BP_INVALID_PAGE_NUM) {
+        break;
+      }
+      rc = disk_buffer_pool_->get_this_page(next_page, &current);
+    }
+
+    if (OB_FAIL(rc)) {
+      disk_buffer_pool_->unpin_page(frame);
+      return rc;
+    }
+
+    // 桶已经满了，并且分裂能把键值分开时才分裂，否则挂溢出页面
+    if (!has_space && splittable && local_depth < HashIndexFileHeader::MAX_GLOBAL_DEPTH) {
+      rc = split_bucket(page_num, frame);
+      disk_buffer_pool_->unpin_page(frame);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to split hash bucket. page num=%d, rc=%s", page_num, strrc(rc));
+        return rc;
+      }
+      continue;
+    }
+
+    rc = append_key(frame, key.data());
+    disk_buffer_pool_->unpin_page(frame);
+    return rc;
+  }
+}
+
+RC ExtendibleHashHandler::delete_entry(const char *user_key, const RID *rid)
+{
+  vector<char> key(file_header_.key_length);
+  key_normalizer_.normalize(user_key, *rid, key.data());
+
+  const int key_length = file_header_.key_length;
+
+  lock_guard<SharedMutex> guard(lock_);
+  const PageNum page_num = bucket_of(hash_of(key.data()));
+  Frame        *frame    = nullptr;
+  RC            rc       = disk_buffer_pool_->get_this_page(page_num, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get hash bucket page. page num=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+
+  Frame *prev = nullptr;
+  while (true) {
+    HashBucketPage *bucket = bucket_page(frame);
+    for (int i = 0; i < bucket->size; i++) {
+      char *item = bucket->keys + i * key_length;
+      if (memcmp(item, key.data(), key_length) != 0) {
+        continue;
+      }
+
+      // 键值在页面内是无序的，用最后一个键值填补空位
+      bucket->size--;
+      if (i != bucket->size) {
+        memcpy(item, bucket->keys + bucket->size * key_length, key_length);
+      }
+      frame->mark_dirty();
+
+      // 空的溢出页面从链表中摘掉，桶的第一个页面总是保留
+      const PageNum current = frame->page_num();
+      if (bucket->size == 0 && prev != nullptr) {
+        bucket_page(prev)->overflow_page = bucket->overflow_page;
+        prev->mark_dirty();
+        disk_buffer_pool_->unpin_page(frame);
+        disk_buffer_pool_->unpin_page(prev);
+        return disk_buffer_pool_->dispose_page(current);
+      }
+
+      disk_buffer_pool_->unpin_page(frame);
+      if (prev != nullptr) {
+        disk_buffer_pool_->unpin_page(prev);
+      }
+      return RC::SUCCESS;
+    }
+
+    const PageNum next_page = bucket->overflow_page;
+    if (prev != nullptr) {
+      disk_buffer_pool_->unpin_page(prev);
+    }
+    prev = frame;
+    if (next_page == BP_INVALID_PAGE_NUM) {
+      disk_buffer_pool_->unpin_page(prev);
+      return RC::RECORD_NOT_EXIST;
+    }
+
+    rc = disk_buffer_pool_->get_this_page(next_page, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get hash overflow page. page num=%d, rc=%s", next_page, strrc(rc));
+      disk_buffer_pool_->unpin_page(prev);
+      return rc;
+    }
+  }
+}
+
+RC ExtendibleHashHandler::get_entries(const char *user_key, vector<RID> &rids)
+{
+  vector<char> key(file_header_.key_length);
+  key_normalizer_.normalize(user_key, RID(), key.data());
+
+  const int attr_length = key_normalizer_.attr_length();
+  const int key_length  = file_header_.key_length;
+
+  shared_lock<SharedMutex> guard(lock_);
+  PageNum                  page_num = bucket_of(hash_of(key.data()));
+  while (page_num != BP_INVALID_PAGE_NUM) {
+    Frame *frame = nullptr;
+    RC     rc    = disk_buffer_pool_->get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get hash bucket page. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    const HashBucketPage *bucket = bucket_page(frame);
+    for (int i = 0; i < bucket->size; i++) {
+      const char *item = bucket->keys + i * key_length;
+      if (memcmp(item, key.data(), attr_length) == 0) {
+        rids.push_back(key_normalizer_.rid(item));
+      }
+    }
+    page_num = bucket->overflow_page;
+    disk_buffer_pool_->unpin_page(frame);
+  }
+  return RC::SUCCESS;
+}
+
+bool ExtendibleHashHandler::validate()
+{
+  shared_lock<SharedMutex> guard(lock_);
+
+  const int global_depth = file_header_.global_depth;
+  if (directory_.size() != (size_t(1) << global_depth)) {
+    LOG_WARN("directory size mismatch. size=%d, global depth=%d", static_cast<int>(directory_.size()), global_depth);
+    return false;
+  }
+
+  // 每个桶被 2^(global_depth - local_depth) 个目录项引用，这些目录项的低 local_depth 位都相同
+  map<PageNum, size_t> first_slot;
+  map<PageNum, size_t> references;
+  for (size_t i = 0; i < directory_.size(); i++) {
+    first_slot.emplace(directory_[i], i);
+    references[directory_[i]]++;
+  }
+
+  for (const auto &[page_num, slot] : first_slot) {
+    Frame *frame = nullptr;
+    if (OB_FAIL(disk_buffer_pool_->get_this_page(page_num, &frame))) {
+      return false;
+    }
+    const int      local_depth = bucket_page(frame)->local_depth;
+    const uint64_t local_mask  = (1ULL << local_depth) - 1;
+    disk_buffer_pool_->unpin_page(frame);
+
+    if (local_depth > global_depth || references[page_num] != (size_t(1) << (global_depth - local_depth))) {
+      LOG_WARN("invalid bucket reference. page num=%d, local depth=%d, global depth=%d, references=%d",
+          page_num, local_depth, global_depth, static_cast<int>(references[page_num]));
+      return false;
+    }
+
+    PageNum current = page_num;
+    while (current != BP_INVALID_PAGE_NUM) {
+      if (OB_FAIL(disk_buffer_pool_->get_this_page(current, &frame))) {
+        return false;
+      }
+      const HashBucketPage *bucket = bucket_page(frame);
+      bool                  valid  = bucket->size >= 0 && bucket->size <= bucket_capacity();
+      for (int i = 0; valid && i < bucket->size; i++) {
+        const uint64_t hash = hash_of(bucket->keys + i * file_header_.key_length);
+        valid               = (hash & local_mask) == (slot & local_mask);
+      }
+      current = bucket->overflow_page;
+      disk_buffer_pool_->unpin_page(frame);
+      if (!valid) {
+        LOG_WARN("invalid key in hash bucket. page num=%d", page_num);
+        return false;
+      }
+    }
+  }
+  return true;
+}
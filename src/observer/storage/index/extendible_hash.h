@@ -0,0 +1,140 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <set>
+#include <vector>
+
+#include "common/lang/mutex.h"
+#include "common/rc.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/index/bplus_tree.h"
+
+/**
+ * @brief 可扩展哈希索引
+ * @defgroup ExtendibleHash
+ * @details 目录保存 2^global_depth 个桶的页号，使用键值哈希值的低 global_depth 位定位桶。
+ * 桶满了之后分裂成两个，只在桶的 local_depth 等于 global_depth 时目录才需要翻倍。
+ * 目录常驻内存，等值查找通常只需要访问一个桶页面。
+ * 所有键值都相同的桶无法通过分裂解决，使用溢出页面串起来。
+ */
+
+/**
+ * @brief 哈希索引的文件头，放在文件的第一个页面
+ * @ingroup ExtendibleHash
+ */
+struct HashIndexFileHeader
+{
+  static constexpr int32_t CURRENT_FORMAT_VERSION = 1;
+  static constexpr int     DIR_ENTRIES_PER_PAGE   = BP_PAGE_DATA_SIZE / sizeof(PageNum);  ///< 一个目录页面存放的页号个数
+  static constexpr int     MAX_DIR_PAGES          = 1024;
+  static constexpr int     MAX_GLOBAL_DEPTH       = 20;
+
+  int32_t  format_version;
+  int32_t  attr_num;
+  int32_t  attr_length[MAX_NUM];
+  AttrType attr_type[MAX_NUM];
+  int32_t  key_length;      ///< 规范化编码之后的字段值加上RID的长度
+  int32_t  global_depth;    ///< 目录中有 2^global_depth 项
+  int32_t  dir_page_count;  ///< 目录占用的页面个数
+  PageNum  dir_pages[MAX_DIR_PAGES];
+};
+
+static_assert(sizeof(HashIndexFileHeader) <= BP_PAGE_DATA_SIZE, "hash index file header is too large");
+static_assert((1 << HashIndexFileHeader::MAX_GLOBAL_DEPTH) <=
+                  HashIndexFileHeader::DIR_ENTRIES_PER_PAGE * HashIndexFileHeader::MAX_DIR_PAGES,
+    "hash index directory cannot hold max global depth");
+
+/**
+ * @brief 哈希桶页面的页头，后面紧跟着键值数组
+ * @details 键值与B+树一样是规范化编码的字段值加上RID，参考 KeyNormalizer
+ * @ingroup ExtendibleHash
+ */
+struct HashBucketPage
+{
+  static constexpr int HEADER_SIZE = 12;
+
+  int32_t local_depth;    ///< 溢出页面中不使用
+  int32_t size;           ///< 当前页面中的键值个数
+  PageNum overflow_page;  ///< 下一个溢出页面，没有时是 BP_INVALID_PAGE_NUM
+  char    keys[0];
+};
+
+/**
+ * @brief 可扩展哈希的操作入口
+ * @ingroup ExtendibleHash
+ * @details 查找持有共享锁，插入和删除持有排他锁。
+ */
+class ExtendibleHashHandler
+{
+public:
+  ExtendibleHashHandler() = default;
+  ~ExtendibleHashHandler() { close(); }
+
+  RC create(const char *file_name, std::vector<AttrType> attr_type, std::vector<int> attr_length);
+  RC open(const char *file_name);
+  RC close();
+
+  /**
+   * @brief 把文件头和所有的脏页刷到磁盘
+   */
+  RC sync();
+
+  void set_unique(int unique) { is_unique_ = unique; }
+
+  /**
+   * @brief 插入一个键值
+   * @param user_key 字段的原始值，多个字段时按照索引字段的顺序拼接在一起
+   * @return 唯一索引中字段值已经存在，或者同样的键值已经存在时，返回 RECORD_DUPLICATE_KEY
+   */
+  RC insert_entry(const char *user_key, const RID *rid);
+
+  /**
+   * @brief 删除一个键值
+   * @return 找不到时返回 RECORD_NOT_EXIST
+   */
+  RC delete_entry(const char *user_key, const RID *rid);
+
+  /**
+   * @brief 找出字段值等于 user_key 的所有记录
+   */
+  RC get_entries(const char *user_key, std::vector<RID> &rids);
+
+  const KeyNormalizer &key_normalizer() const { return key_normalizer_; }
+
+  int global_depth() const { return file_header_.global_depth; }
+
+  /**
+   * @brief 检查目录和每个桶是否一致，测试使用
+   */
+  bool validate();
+
+private:
+  uint64_t hash_of(const char *key) const;
+  int      bucket_capacity() const { return (BP_PAGE_DATA_SIZE - HashBucketPage::HEADER_SIZE) / file_header_.key_length; }
+  PageNum  bucket_of(uint64_t hash) const { return directory_[hash & ((1ULL << file_header_.global_depth) - 1)]; }
+
+  RC allocate_bucket(int local_depth, Frame *&frame);
+  RC split_bucket(PageNum page_num, Frame *frame);
+  RC append_key(Frame *frame, const char *key);
+
+  RC load_directory();
+  RC write_directory(const std::set<int> &dirty_pages);
+  RC write_header();
+
+private:
+  DiskBufferPool      *disk_buffer_pool_ = nullptr;
+  HashIndexFileHeader  file_header_;
+  std::vector<PageNum> directory_;
+  KeyNormalizer        key_normalizer_;
+  int                  is_unique_ = 0;
+  common::SharedMutex  lock_;
+};
@@ -0,0 +1,158 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/hash_index.h"
+#include "common/log/log.h"
+
+#include <string.h>
+
+HashIndex::~HashIndex() noexcept { close(); }
+
+RC HashIndex::create(const char *file_name, const IndexMeta &index_meta, std::vector<FieldMeta> field_meta)
+{
+  if (inited_) {
+    LOG_WARN("Failed to create index due to the index has been created before. file_name:%s, index:%s, field:%s",
+        file_name, index_meta.name(), index_meta.field());
+    return RC::RECORD_OPENNED;
+  }
+
+  Index::init(index_meta, field_meta);
+
+  std::vector<int>      field_length;
+  std::vector<AttrType> field_type;
+  for (const FieldMeta &field : field_meta) {
+    field_length.push_back(field.len());
+    field_type.push_back(field.type());
+  }
+
+  RC rc = index_handler_.create(file_name, field_type, field_length);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to create hash index handler, file_name:%s, index:%s, field:%s, rc:%s",
+        file_name, index_meta.name(), index_meta.field(), strrc(rc));
+    return rc;
+  }
+
+  inited_ = true;
+  LOG_INFO("Successfully create hash index, file_name:%s, index:%s, field:%s",
+      file_name, index_meta.name(), index_meta.field());
+  return RC::SUCCESS;
+}
+
+RC HashIndex::open(const char *file_name, const IndexMeta &index_meta, std::vector<FieldMeta> &field_meta)
+{
+  if (inited_) {
+    LOG_WARN("Failed to open index due to the index has been initedd before. file_name:%s, index:%s, field:%s",
+        file_name, index_meta.name(), index_meta.field());
+    return RC::RECORD_OPENNED;
+  }
+
+  Index::init(index_meta, field_meta);
+
+  RC rc = index_handler_.open(file_name);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to open hash index handler, file_name:%s, index:%s, field:%s, rc:%s",
+        file_name, index_meta.name(), index_meta.field(), strrc(rc));
+    return rc;
+  }
+
+  inited_ = true;
+  LOG_INFO("Successfully open hash index, file_name:%s, index:%s, field:%s",
+      file_name, index_meta.name(), index_meta.field());
+  return RC::SUCCESS;
+}
+
+RC HashIndex::close()
+{
+  if (inited_) {
+    LOG_INFO("Begin to close hash index, index:%s, field:%s", index_meta_.name(), index_meta_.field());
+    index_handler_.close();
+    inited_ = false;
+  }
+  return RC::SUCCESS;
+}
+
+RC HashIndex::bulk_load(RecordFileScanner &scanner, const IndexBuildOptions &options, const char *run_file)
+{
+  std::vector<char> user_key(index_handler_.key_normalizer().attr_length());
+  Record            record;
+  RC                rc = RC::SUCCESS;
+  while (scanner.has_next()) {
+    rc = scanner.next(record);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to scan records while loading index. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+      return rc;
+    }
+
+    make_user_key(record.data(), user_key.data());
+    rc = index_handler_.insert_entry(user_key.data(), &record.rid());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to insert key into hash index. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+      return rc;
+    }
+  }
+
+  LOG_INFO("loaded hash index. index=%s, global depth=%d", index_meta_.name(), index_handler_.global_depth());
+  return index_handler_.sync();
+}
+
+RC HashIndex::insert_entry(const char *record, const RID *rid)
+{
+  std::vector<char> user_key(index_handler_.key_normalizer().attr_length());
+  make_user_key(record, user_key.data());
+  return index_handler_.insert_entry(user_key.data(), rid);
+}
+
+RC HashIndex::delete_entry(const char *record, const RID *rid)
+{
+  std::vector<char> user_key(index_handler_.key_normalizer().attr_length());
+  make_user_key(record, user_key.data());
+  return index_handler_.delete_entry(user_key.data(), rid);
+}
+
+IndexScanner *HashIndex::create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
+    int right_len, bool right_inclusive, bool reverse)
+{
+  if (left_key == nullptr || right_key == nullptr || !left_inclusive || !right_inclusive || left_len != right_len ||
+      memcmp(left_key, right_key, left_len) != 0) {
+    LOG_WARN("hash index only supports equality lookup. index=%s", index_meta_.name());
+    return nullptr;
+  }
+
+  // 字符串等较短的值需要补齐到字段的长度
+  const int         attr_length = index_handler_.key_normalizer().attr_length();
+  std::vector<char> user_key(attr_length, 0);
+  memcpy(user_key.data(), left_key, std::min(left_len, attr_length));
+
+  std::vector<RID> rids;
+  RC               rc = index_handler_.get_entries(user_key.data(), rids);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to lookup hash index. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+    return nullptr;
+  }
+  return new HashIndexScanner(std::move(rids));
+}
+
+RC HashIndex::sync() { return index_handler_.sync(); }
+
+////////////////////////////////////////////////////////////////////////////////
+RC HashIndexScanner::next_entry(RID *rid)
+{
+  if (pos_ >= rids_.size()) {
+    return RC::RECORD_EOF;
+  }
+  *rid = rids_[pos_++];
+  return RC::SUCCESS;
+}
+
+RC HashIndexScanner::destroy()
+{
+  delete this;
+  return RC::SUCCESS;
+}
@@ -0,0 +1,71 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "storage/index/extendible_hash.h"
+#include "storage/index/index.h"
+
+/**
+ * @brief 哈希索引
+ * @ingroup Index
+ * @details 只支持等值查找，参考 ExtendibleHashHandler
+ */
+class HashIndex : public Index
+{
+public:
+  HashIndex(int is_unique) : is_unique_(is_unique) { index_handler_.set_unique(is_unique); }
+  virtual ~HashIndex() noexcept;
+
+  RC create(const char *file_name, const IndexMeta &index_meta, std::vector<FieldMeta> field_meta);
+  RC open(const char *file_name, const IndexMeta &index_meta, std::vector<FieldMeta> &field_meta);
+  RC close() override;
+
+  /**
+   * @brief 逐条插入表中已有的数据
+   * @details 哈希索引不需要有序的输入，排序相关的参数和临时文件都不使用
+   */
+  RC bulk_load(RecordFileScanner &scanner, const IndexBuildOptions &options, const char *run_file) override;
+
+  RC insert_entry(const char *record, const RID *rid) override;
+  RC delete_entry(const char *record, const RID *rid) override;
+
+  /**
+   * @brief 只能扫描左右边界相同并且都包含边界的范围，即等值查找。所有的项键值都相同，不区分扫描的方向
+   */
+  IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
+      int right_len, bool right_inclusive, bool reverse = false) override;
+
+  RC sync() override;
+
+private:
+  bool                  inited_ = false;
+  int                   is_unique_;
+  ExtendibleHashHandler index_handler_;
+};
+
+/**
+ * @brief 哈希索引扫描器
+ * @ingroup Index
+ * @details 创建时就取出所有匹配的RID，不会在扫描过程中持有页面
+ */
+class HashIndexScanner : public IndexScanner
+{
+public:
+  HashIndexScanner(std::vector<RID> &&rids) : rids_(std::move(rids)) {}
+  ~HashIndexScanner() noexcept override = default;
+
+  RC next_entry(RID *rid) override;
+  RC destroy() override;
+
+private:
+  std::vector<RID> rids_;
+  size_t           pos_ = 0;
+};
@@ -14,9 +14,42 @@ See the Mulan PSL v2 for more details. */
 
 #include "storage/index/index.h"
 
+#include <string.h>
+
 RC Index::init(const IndexMeta &index_meta, std::vector<FieldMeta> &field_meta)
 {
   index_meta_ = index_meta;
   field_meta_.assign(field_meta.begin(), field_meta.end());
   return RC::SUCCESS;
 }
+
+void Index::make_user_key(const char *record, char *user_key) const
+{
+  int pos = 0;
+  for (const FieldMeta &field : field_meta_) {
+    memcpy(user_key + pos, record + field.offset(), field.len());
+    pos += field.len();
+  }
+}
+
+RC Index::insert_entries(const std::vector<Record> &records)
+{
+  for (const Record &record : records) {
+    RC rc = insert_entry(record.data(), &record.rid());
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC Index::delete_entries(const std::vector<Record> &records)
+{
+  for (const Record &record : records) {
+    RC rc = delete_entry(record.data(), &record.rid());
+    if (OB_FAIL(rc) && rc != RC::RECORD_NOT_EXIST) {
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
@@ -24,6 +24,17 @@ See the Mulan PSL v2 for more details. */
 
 class IndexScanner;
 
+/**
+ * @brief 创建索引时批量导入已有数据的参数
+ * @ingroup Index
+ */
+struct IndexBuildOptions
+{
+  int     fill_factor      = 90;                ///< 节点填充的百分比，参考 BplusTreeHandler::bulk_load
+  int64_t sort_buffer_size = 64 * 1024 * 1024;  ///< 键值排序时内存中最多缓存多少字节，超过之后写临时文件
+  int     threads          = 0;                 ///< 键值排序使用的线程数，0表示由CPU个数决定
+};
+
 /**
  * @brief 索引
  * @defgroup Index
@@ -42,6 +53,20 @@ public:
 
   const IndexMeta &index_meta() const { return index_meta_; }
 
+  /**
+   * @brief 关闭索引文件
+   */
+  virtual RC close() = 0;
+
+  /**
+   * @brief 把表中已有的数据批量导入到刚创建的索引中
+   *
+   * @param scanner 表数据的扫描器
+   * @param options 导入使用的参数，不同的索引可能只用到其中一部分
+   * @param run_file 导入过程中需要的临时文件名前缀
+   */
+  virtual RC bulk_load(RecordFileScanner &scanner, const IndexBuildOptions &options, const char *run_file) = 0;
+
   /**
    * @brief 插入一条数据
    *
@@ -58,6 +83,17 @@ public:
    */
   virtual RC delete_entry(const char *record, const RID *rid) = 0;
 
+  /**
+   * @brief 批量插入多条记录的键值
+   * @details 默认逐条插入。遇到错误时立即返回，已经插入的键值由调用者使用 delete_entries 删除
+   */
+  virtual RC insert_entries(const std::vector<Record> &records);
+
+  /**
+   * @brief 批量删除多条记录的键值，不存在的键值被忽略
+   */
+  virtual RC delete_entries(const std::vector<Record> &records);
+
   /**
    * @brief 创建一个索引数据的扫描器
    *
@@ -67,9 +103,10 @@ public:
    * @param right_key 要扫描的右边界
    * @param right_len 右边界的长度
    * @param right_inclusive 是否包含右边界
+   * @param reverse 是否按照键值从大到小返回，不是所有的索引都支持
    */
   virtual IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
-      int right_len, bool right_inclusive) = 0;
+      int right_len, bool right_inclusive, bool reverse = false) = 0;
 
   /**
    * @brief 同步索引数据到磁盘
@@ -80,7 +117,12 @@ public:
 protected:
   // RC init(const IndexMeta &index_meta, const FieldMeta &field_meta);
   RC init(const IndexMeta &index_meta, std::vector<FieldMeta> &field_meta);
-  
+
+  /**
+   * @brief 从记录中取出索引字段，按照索引字段的顺序拼接成索引使用的原始键值
+   */
+  void make_user_key(const char *record, char *user_key) const;
+
 protected:
   IndexMeta index_meta_;  ///< 索引的元数据
   // FieldMeta field_meta_;  ///< 当前实现仅考虑一个字段的索引
@@ -24,9 +24,10 @@ const static Json::StaticString FIELD_FIELD_NAME("field_name");
 const static Json::StaticString INDEX_NAME("index_name");
 const static Json::StaticString INDEX_FIELD_NAMES("index_field_names");
 const static Json::StaticString UNIQUE_OR_NOT("unique");
+const static Json::StaticString INDEX_TYPE("index_type");
 
 // 利用field vector初始化Indexmeta
-RC IndexMeta::init(const char *name, std::vector<const FieldMeta *> fields,int unique)
+RC IndexMeta::init(const char *name, std::vector<const FieldMeta *> fields, int unique, IndexType type)
 {
   if (common::is_blank(name)) {
     LOG_ERROR("Failed to init index, name is empty.");
@@ -36,6 +37,7 @@ RC IndexMeta::init(const char *name, std::vector<const FieldMeta *> fields,int u
   // 初始化IndexMeta
   name_ = name;
   unique_ = unique;
+  type_   = type;
   field_.clear();
   for (const FieldMeta *field : fields) {
     field_.push_back(field->name());
@@ -62,6 +64,7 @@ void IndexMeta::to_json(Json::Value &json_value) const
 {
   json_value[INDEX_NAME]    = name_;
   json_value[UNIQUE_OR_NOT] = unique_;
+  json_value[INDEX_TYPE]    = static_cast<int>(type_);
   json_value[FIELD_FIELD_NAME] = get_field_names_str();
   // for (int i = 0; i < int(field_.size()); i++) {
   //   json_value[FIELD_FIELD_NAME][i] = field_.at(i);
@@ -135,7 +138,25 @@ RC IndexMeta::from_json(const TableMeta &table, const Json::Value &json_value, I
     fields.push_back(field_name);
   }
 
-  return index.init(name_value.asCString(), fields);
+  // 老版本的元数据中没有索引类型，都是B+树
+  IndexType          type       = IndexType::BPLUS_TREE;
+  const Json::Value &type_value = json_value[INDEX_TYPE];
+  if (!type_value.isNull()) {
+    if (!type_value.isInt()) {
+      LOG_ERROR("Index type of index [%s] is not an integer. json value=%s",
+                name_value.asCString(), type_value.toStyledString().c_str());
+      return RC::INVALID_ARGUMENT;
+    }
+    type = static_cast<IndexType>(type_value.asInt());
+  }
+
+  RC rc = index.init(name_value.asCString(), fields);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  index.unique_ = unique_value.asBool();
+  index.type_   = type;
+  return rc;
 }
 
 // 是否为唯一索引
@@ -15,6 +15,7 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "common/rc.h"
+#include "common/types.h"
 #include <string>
 #include <vector>
 
@@ -28,8 +29,7 @@ class Value;
 /**
  * @brief 描述一个索引
  * @ingroup Index
- * @details 一个索引包含了表的哪些字段，索引的名称等。
- * 如果以后实现了多种类型的索引，还需要记录索引的类型，对应类型的一些元数据等
+ * @details 一个索引包含了表的哪些字段，索引的名称，索引的类型等。
  */
 class IndexMeta
 {
@@ -37,12 +37,14 @@ public:
   IndexMeta() = default;
 
   // RC init(const char *name, const FieldMeta &field);
-  RC init(const char *name, std::vector<const FieldMeta *> fields,int unique);
+  RC init(const char *name, std::vector<const FieldMeta *> fields, int unique,
+      IndexType type = IndexType::BPLUS_TREE);
   RC init(const char *name, std::vector<std::string> fields);
 
 public:
   const char *name() const;
   const bool is_unique() const;
+  IndexType  type() const { return type_; }
   const int field_count() const;
   const char *field() const;
   const std::vector<std::string> *fields() const;
@@ -57,6 +59,7 @@ public:
 
 protected:
   bool unique_ = false;             // wether unique index
+  IndexType type_ = IndexType::BPLUS_TREE;  ///< 索引的类型
   std::string name_;   // index's name
   // std::string field_;  // field's name
   std::vector<std::string> field_; //field's name(multi)
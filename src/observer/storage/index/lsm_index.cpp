@@ -0,0 +1,166 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/lsm_index.h"
+#include "common/log/log.h"
+#include "storage/index/bplus_tree_key_sorter.h"
+
+#include <inttypes.h>
+
+LsmIndex::~LsmIndex() noexcept { close(); }
+
+RC LsmIndex::create(const char *file_name, const IndexMeta &index_meta, std::vector<FieldMeta> field_meta)
+{
+  if (inited_) {
+    LOG_WARN("Failed to create index due to the index has been created before. file_name:%s, index:%s, field:%s",
+        file_name, index_meta.name(), index_meta.field());
+    return RC::RECORD_OPENNED;
+  }
+
+  Index::init(index_meta, field_meta);
+
+  std::vector<int>      field_length;
+  std::vector<AttrType> field_type;
+  for (const FieldMeta &field : field_meta) {
+    field_length.push_back(field.len());
+    field_type.push_back(field.type());
+  }
+
+  RC rc = index_handler_.create(file_name, field_type, field_length);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to create lsm index handler, file_name:%s, index:%s, field:%s, rc:%s",
+        file_name, index_meta.name(), index_meta.field(), strrc(rc));
+    return rc;
+  }
+
+  inited_ = true;
+  LOG_INFO("Successfully create lsm index, file_name:%s, index:%s, field:%s",
+      file_name, index_meta.name(), index_meta.field());
+  return RC::SUCCESS;
+}
+
+RC LsmIndex::open(const char *file_name, const IndexMeta &index_meta, std::vector<FieldMeta> &field_meta)
+{
+  if (inited_) {
+    LOG_WARN("Failed to open index due to the index has been initedd before. file_name:%s, index:%s, field:%s",
+        file_name, index_meta.name(), index_meta.field());
+    return RC::RECORD_OPENNED;
+  }
+
+  Index::init(index_meta, field_meta);
+
+  RC rc = index_handler_.open(file_name);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("Failed to open lsm index handler, file_name:%s, index:%s, field:%s, rc:%s",
+        file_name, index_meta.name(), index_meta.field(), strrc(rc));
+    return rc;
+  }
+
+  inited_ = true;
+  LOG_INFO("Successfully open lsm index, file_name:%s, index:%s, field:%s",
+      file_name, index_meta.name(), index_meta.field());
+  return RC::SUCCESS;
+}
+
+RC LsmIndex::close()
+{
+  if (inited_) {
+    LOG_INFO("Begin to close lsm index, index:%s, field:%s", index_meta_.name(), index_meta_.field());
+    index_handler_.close();
+    inited_ = false;
+  }
+  return RC::SUCCESS;
+}
+
+RC LsmIndex::bulk_load(RecordFileScanner &scanner, const IndexBuildOptions &options, const char *run_file)
+{
+  BplusTreeKeySorter sorter;
+  RC rc = sorter.init(index_handler_.key_normalizer(), run_file, options.sort_buffer_size, options.threads);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init key sorter. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+    return rc;
+  }
+
+  std::vector<char> user_key(index_handler_.key_normalizer().attr_length());
+  Record            record;
+  while (scanner.has_next()) {
+    rc = scanner.next(record);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to scan records while loading index. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+      return rc;
+    }
+
+    make_user_key(record.data(), user_key.data());
+    rc = sorter.add(user_key.data(), record.rid());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to add key into sorter. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+      return rc;
+    }
+  }
+
+  rc = sorter.finish();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to sort index keys. index=%s, rc=%s", index_meta_.name(), strrc(rc));
+    return rc;
+  }
+
+  LOG_INFO("sorted index keys. index=%s, keys=%" PRId64 ", runs=%d",
+      index_meta_.name(), sorter.count(), sorter.run_count());
+  return index_handler_.bulk_load(sorter);
+}
+
+RC LsmIndex::insert_entry(const char *record, const RID *rid)
+{
+  std::vector<char> user_key(index_handler_.key_normalizer().attr_length());
+  make_user_key(record, user_key.data());
+  return index_handler_.insert_entry(user_key.data(), rid);
+}
+
+RC LsmIndex::delete_entry(const char *record, const RID *rid)
+{
+  std::vector<char> user_key(index_handler_.key_normalizer().attr_length());
+  make_user_key(record, user_key.data());
+  return index_handler_.delete_entry(user_key.data(), rid);
+}
+
+IndexScanner *LsmIndex::create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
+    int right_len, bool right_inclusive, bool reverse)
+{
+  if (reverse) {
+    LOG_WARN("lsm index does not support reverse scan. index=%s", index_meta_.name());
+    return nullptr;
+  }
+
+  LsmIndexScanner *index_scanner = new LsmIndexScanner(index_handler_);
+  RC rc = index_scanner->open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to open index scanner. rc=%d:%s", rc, strrc(rc));
+    delete index_scanner;
+    return nullptr;
+  }
+  return index_scanner;
+}
+
+RC LsmIndex::sync() { return index_handler_.sync(); }
+
+////////////////////////////////////////////////////////////////////////////////
+RC LsmIndexScanner::open(
+    const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len, bool right_inclusive)
+{
+  return tree_scanner_.open(left_key, left_len, left_inclusive, right_key, right_len, right_inclusive);
+}
+
+RC LsmIndexScanner::next_entry(RID *rid) { return tree_scanner_.next_entry(*rid); }
+
+RC LsmIndexScanner::destroy()
+{
+  delete this;
+  return RC::SUCCESS;
+}
@@ -0,0 +1,71 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "storage/index/index.h"
+#include "storage/index/lsm_tree.h"
+
+/**
+ * @brief LSM树索引
+ * @ingroup Index
+ * @details 适合写入很多的表，支持范围查询，参考 LsmTreeHandler
+ */
+class LsmIndex : public Index
+{
+public:
+  LsmIndex(int is_unique) : is_unique_(is_unique) { index_handler_.set_unique(is_unique); }
+  virtual ~LsmIndex() noexcept;
+
+  RC create(const char *file_name, const IndexMeta &index_meta, std::vector<FieldMeta> field_meta);
+  RC open(const char *file_name, const IndexMeta &index_meta, std::vector<FieldMeta> &field_meta);
+  RC close() override;
+
+  /**
+   * @brief 对表中已有的数据排序之后直接写成一个有序段
+   */
+  RC bulk_load(RecordFileScanner &scanner, const IndexBuildOptions &options, const char *run_file) override;
+
+  RC insert_entry(const char *record, const RID *rid) override;
+  RC delete_entry(const char *record, const RID *rid) override;
+
+  /**
+   * @brief 只支持按照键值从小到大扫描
+   */
+  IndexScanner *create_scanner(const char *left_key, int left_len, bool left_inclusive, const char *right_key,
+      int right_len, bool right_inclusive, bool reverse = false) override;
+
+  RC sync() override;
+
+private:
+  bool           inited_ = false;
+  int            is_unique_;
+  LsmTreeHandler index_handler_;
+};
+
+/**
+ * @brief LSM树索引扫描器
+ * @ingroup Index
+ */
+class LsmIndexScanner : public IndexScanner
+{
+public:
+  LsmIndexScanner(LsmTreeHandler &tree_handler) : tree_scanner_(tree_handler) {}
+  ~LsmIndexScanner() noexcept override = default;
+
+  RC open(const char *left_key, int left_len, bool left_inclusive, const char *right_key, int right_len,
+      bool right_inclusive);
+
+  RC next_entry(RID *rid) override;
+  RC destroy() override;
+
+private:
+  LsmTreeScanner tree_scanner_;
+};
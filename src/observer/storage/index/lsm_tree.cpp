@@ -0,0 +1,1038 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/index/lsm_tree.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <set>
+#include <string.h>
+#include <unistd.h>
+
+#include "common/io/io.h"
+#include "common/log/log.h"
+#include "common/os/path.h"
+#include "storage/index/bplus_tree_key_sorter.h"
+
+using namespace std;
+using namespace common;
+
+/// memtable 中每一项除了键值之外大约还要占用多少内存(红黑树节点和字符串对象)
+static constexpr int64_t MEMTABLE_ENTRY_OVERHEAD = 64;
+
+/**
+ * @brief 有序数据来源的游标，扫描和归并时把多个来源合并起来
+ * @ingroup LsmTree
+ */
+class LsmCursor
+{
+public:
+  virtual ~LsmCursor() = default;
+
+  virtual bool        valid() const     = 0;
+  virtual const char *key() const       = 0;
+  virtual bool        tombstone() const = 0;
+  virtual RC          next()            = 0;
+};
+
+namespace {
+
+/**
+ * @brief 打开扫描时从 memtable 中复制出来的数据
+ */
+class CopiedCursor : public LsmCursor
+{
+public:
+  CopiedCursor(vector<pair<string, bool>> &&entries) : entries_(std::move(entries)) {}
+
+  bool        valid() const override { return pos_ < entries_.size(); }
+  const char *key() const override { return entries_[pos_].first.data(); }
+  bool        tombstone() const override { return entries_[pos_].second; }
+  RC          next() override
+  {
+    pos_++;
+    return RC::SUCCESS;
+  }
+
+private:
+  vector<pair<string, bool>> entries_;
+  size_t                     pos_ = 0;
+};
+
+/**
+ * @brief 只读的 memtable，不会再被修改，可以直接遍历
+ */
+class MemTableCursor : public LsmCursor
+{
+public:
+  MemTableCursor(shared_ptr<const LsmMemTable> memtable, const string &start_key)
+      : memtable_(std::move(memtable)), iter_(memtable_->lower_bound(start_key))
+  {}
+
+  bool        valid() const override { return iter_ != memtable_->end(); }
+  const char *key() const override { return iter_->first.data(); }
+  bool        tombstone() const override { return iter_->second; }
+  RC          next() override
+  {
+    ++iter_;
+    return RC::SUCCESS;
+  }
+
+private:
+  shared_ptr<const LsmMemTable> memtable_;
+  LsmMemTable::const_iterator   iter_;
+};
+
+/**
+ * @brief 有序段的游标，每次读取一个数据块
+ */
+class RunCursor : public LsmCursor
+{
+public:
+  RunCursor(shared_ptr<LsmRun> run) : run_(std::move(run)), block_(LsmRun::BLOCK_SIZE, 0) {}
+
+  RC seek(const string &start_key)
+  {
+    RC rc = load(run_->find_block(start_key.data()));
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+
+    const int key_length = run_->entry_size() - 1;
+    int       low        = 0;
+    int       high       = count_;
+    while (low < high) {
+      const int mid = (low + high) / 2;
+      if (memcmp(entry(mid), start_key.data(), key_length) < 0) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    pos_ = low;
+    return pos_ < count_ ? RC::SUCCESS : load(block_index_ + 1);
+  }
+
+  bool        valid() const override { return block_index_ < run_->block_count(); }
+  const char *key() const override { return entry(pos_); }
+  bool        tombstone() const override { return entry(pos_)[run_->entry_size() - 1] != 0; }
+  RC          next() override
+  {
+    if (++pos_ < count_) {
+      return RC::SUCCESS;
+    }
+    return load(block_index_ + 1);
+  }
+
+private:
+  const char *entry(int index) const { return block_.data() + static_cast<size_t>(index) * run_->entry_size(); }
+
+  RC load(int block_index)
+  {
+    block_index_ = block_index;
+    pos_         = 0;
+    count_       = 0;
+    if (block_index_ >= run_->block_count()) {
+      return RC::SUCCESS;
+    }
+    count_ = run_->block_entry_count(block_index_);
+    return run_->read_block(block_index_, block_.data());
+  }
+
+private:
+  shared_ptr<LsmRun> run_;
+  string             block_;
+  int                block_index_ = 0;
+  int                pos_         = 0;
+  int                count_       = 0;
+};
+
+/**
+ * @brief 从多个游标中取出下一个最小的键值
+ * @details 游标按照从新到旧排列，同一个键值以最新的为准，其它游标上相同的键值被跳过
+ * @param[out] found 所有游标都结束时为 false
+ */
+RC next_merged(vector<unique_ptr<LsmCursor>> &cursors, int key_length, string &key, bool &tombstone, bool &found)
+{
+  LsmCursor *newest = nullptr;
+  for (unique_ptr<LsmCursor> &cursor : cursors) {
+    if (cursor->valid() && (newest == nullptr || memcmp(cursor->key(), newest->key(), key_length) < 0)) {
+      newest = cursor.get();
+    }
+  }
+
+  found = newest != nullptr;
+  if (!found) {
+    return RC::SUCCESS;
+  }
+
+  key.assign(newest->key(), key_length);
+  tombstone = newest->tombstone();
+  for (unique_ptr<LsmCursor> &cursor : cursors) {
+    if (cursor->valid() && memcmp(cursor->key(), key.data(), key_length) == 0) {
+      RC rc = cursor->next();
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+  }
+  return RC::SUCCESS;
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+LsmRun::~LsmRun()
+{
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  if (obsolete_) {
+    ::unlink(file_name_.c_str());
+    LOG_INFO("removed obsolete lsm run. file=%s", file_name_.c_str());
+  }
+}
+
+RC LsmRun::open(int key_length)
+{
+  fd_ = ::open(file_name_.c_str(), O_RDONLY);
+  if (fd_ < 0) {
+    LOG_WARN("failed to open lsm run. file=%s, error=%s", file_name_.c_str(), strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+
+  const off_t file_size = ::lseek(fd_, 0, SEEK_END);
+  if (file_size < static_cast<off_t>(sizeof(footer_)) ||
+      ::pread(fd_, &footer_, sizeof(footer_), file_size - sizeof(footer_)) != sizeof(footer_)) {
+    LOG_WARN("failed to read lsm run footer. file=%s, size=%ld", file_name_.c_str(), static_cast<long>(file_size));
+    return RC::IOERR_READ;
+  }
+  if (footer_.magic != LsmRunFooter::MAGIC || footer_.key_length != key_length || footer_.block_count <= 0) {
+    LOG_WARN("invalid lsm run footer. file=%s, magic=%x, key length=%d, block count=%d",
+        file_name_.c_str(), footer_.magic, footer_.key_length, footer_.block_count);
+    return RC::IOERR_READ;
+  }
+
+  fences_.resize(static_cast<size_t>(footer_.block_count + 1) * key_length);
+  vector<uint64_t> words(footer_.bloom_word_count);
+  const ssize_t    words_size = static_cast<ssize_t>(words.size() * sizeof(uint64_t));
+  if (::pread(fd_, fences_.data(), fences_.size(), footer_.fence_offset) != static_cast<ssize_t>(fences_.size()) ||
+      ::pread(fd_, words.data(), words_size, footer_.bloom_offset) != words_size) {
+    LOG_WARN("failed to read lsm run index. file=%s, error=%s", file_name_.c_str(), strerror(errno));
+    return RC::IOERR_READ;
+  }
+  bloom_.init(std::move(words), footer_.bloom_hash_count);
+  return RC::SUCCESS;
+}
+
+int LsmRun::find_block(const char *key) const
+{
+  int low  = 0;
+  int high = footer_.block_count - 1;
+  while (low < high) {
+    const int mid = (low + high + 1) / 2;
+    if (memcmp(fences_.data() + static_cast<size_t>(mid) * footer_.key_length, key, footer_.key_length) <= 0) {
+      low = mid;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return low;
+}
+
+int LsmRun::block_entry_count(int block) const
+{
+  const int64_t remain = footer_.entry_count - static_cast<int64_t>(block) * footer_.entries_per_block;
+  return static_cast<int>(std::min<int64_t>(remain, footer_.entries_per_block));
+}
+
+RC LsmRun::read_block(int block, char *buf) const
+{
+  const ssize_t size   = static_cast<ssize_t>(block_entry_count(block)) * entry_size();
+  const off_t   offset = static_cast<off_t>(block) * footer_.entries_per_block * entry_size();
+  if (::pread(fd_, buf, size, offset) != size) {
+    LOG_WARN("failed to read lsm run block. file=%s, block=%d, error=%s", file_name_.c_str(), block, strerror(errno));
+    return RC::IOERR_READ;
+  }
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+LsmRunWriter::~LsmRunWriter()
+{
+  // 没有写完的文件没有用处
+  if (fd_ >= 0) {
+    ::close(fd_);
+    ::unlink(file_name_.c_str());
+  }
+}
+
+RC LsmRunWriter::open(const string &file_name, const KeyNormalizer &normalizer, int64_t expected_entries)
+{
+  file_name_ = file_name;
+  fd_        = ::open(file_name.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0600);
+  if (fd_ < 0) {
+    LOG_WARN("failed to create lsm run. file=%s, error=%s", file_name.c_str(), strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+
+  attr_length_               = normalizer.attr_length();
+  footer_.magic              = LsmRunFooter::MAGIC;
+  footer_.key_length         = normalizer.key_length();
+  footer_.entries_per_block  = LsmRun::BLOCK_SIZE / (footer_.key_length + 1);
+  block_.reserve(LsmRun::BLOCK_SIZE);
+  bloom_.init(expected_entries);
+  return RC::SUCCESS;
+}
+
+RC LsmRunWriter::add(const char *key, bool tombstone)
+{
+  const int entry_size = footer_.key_length + 1;
+  if (static_cast<int>(block_.size()) / entry_size >= footer_.entries_per_block) {
+    RC rc = flush_block();
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  if (block_.empty()) {
+    fences_.append(key, footer_.key_length);
+  }
+  block_.append(key, footer_.key_length);
+  block_.push_back(tombstone ? 1 : 0);
+  last_key_.assign(key, footer_.key_length);
+  bloom_.add(BloomFilter::hash(key, attr_length_));
+  footer_.entry_count++;
+  return RC::SUCCESS;
+}
+
+RC LsmRunWriter::write(const char *data, int size)
+{
+  int ret = writen(fd_, data, size);
+  if (ret != 0) {
+    LOG_WARN("failed to write lsm run. file=%s, error=%s", file_name_.c_str(), strerror(ret));
+    return RC::IOERR_WRITE;
+  }
+  offset_ += size;
+  return RC::SUCCESS;
+}
+
+RC LsmRunWriter::flush_block()
+{
+  RC rc = write(block_.data(), static_cast<int>(block_.size()));
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  footer_.block_count++;
+  block_.clear();
+  return RC::SUCCESS;
+}
+
+RC LsmRunWriter::finish()
+{
+  RC rc = RC::SUCCESS;
+  if (!block_.empty() && OB_FAIL(rc = flush_block())) {
+    return rc;
+  }
+
+  footer_.fence_offset = offset_;
+  fences_.append(last_key_);
+  if (OB_FAIL(rc = write(fences_.data(), static_cast<int>(fences_.size())))) {
+    return rc;
+  }
+
+  const vector<uint64_t> &words = bloom_.words();
+  footer_.bloom_offset          = offset_;
+  footer_.bloom_word_count      = static_cast<int32_t>(words.size());
+  footer_.bloom_hash_count      = bloom_.hash_count();
+  if (OB_FAIL(rc = write(reinterpret_cast<const char *>(words.data()), static_cast<int>(words.size() * sizeof(uint64_t)))) ||
+      OB_FAIL(rc = write(reinterpret_cast<const char *>(&footer_), sizeof(footer_)))) {
+    return rc;
+  }
+
+  if (::fsync(fd_) != 0) {
+    LOG_WARN("failed to sync lsm run. file=%s, error=%s", file_name_.c_str(), strerror(errno));
+    return RC::IOERR_SYNC;
+  }
+  ::close(fd_);
+  fd_ = -1;
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+LsmTreeScanner::LsmTreeScanner(LsmTreeHandler &handler) : handler_(handler) {}
+
+LsmTreeScanner::~LsmTreeScanner() { close(); }
+
+RC LsmTreeScanner::open(const char *left_user_key, int left_len, bool left_inclusive, const char *right_user_key,
+    int right_len, bool right_inclusive)
+{
+  const KeyNormalizer &normalizer  = handler_.key_normalizer_;
+  const int            attr_length = normalizer.attr_length();
+  const int            key_length  = normalizer.key_length();
+
+  // 字符串等较短的值需要补齐到字段的长度
+  auto make_key = [&normalizer, attr_length, key_length](const char *user_key, int len, const RID &rid) {
+    string padded(attr_length, 0);
+    memcpy(padded.data(), user_key, std::min(len, attr_length));
+    string key(key_length, 0);
+    normalizer.normalize(padded.data(), rid, key.data());
+    return key;
+  };
+
+  close();
+
+  // 全0是最小的键值。RID的最小值和最大值不会出现在索引中，用来表示包含或不包含边界
+  string start_key(key_length, 0);
+  if (left_user_key != nullptr) {
+    start_key = make_key(left_user_key, left_len, left_inclusive ? *RID::min() : *RID::max());
+  }
+  if (right_user_key != nullptr) {
+    end_key_ = make_key(right_user_key, right_len, right_inclusive ? *RID::max() : *RID::min());
+    if (memcmp(start_key.data(), end_key_.data(), key_length) >= 0) {
+      return RC::SUCCESS;
+    }
+  }
+
+  const bool equal = left_user_key != nullptr && right_user_key != nullptr && left_inclusive && right_inclusive &&
+                     memcmp(start_key.data(), end_key_.data(), attr_length) == 0;
+  const uint64_t attr_hash = equal ? BloomFilter::hash(start_key.data(), attr_length) : 0;
+
+  lock_guard<mutex> lock(handler_.mutex_);
+  return handler_.open_scanner(*this, start_key, equal ? &attr_hash : nullptr);
+}
+
+RC LsmTreeScanner::next_entry(RID &rid)
+{
+  const int key_length = handler_.key_normalizer_.key_length();
+  while (true) {
+    bool tombstone = false;
+    bool found     = false;
+    RC   rc        = next_merged(cursors_, key_length, current_key_, tombstone, found);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    if (!found || (!end_key_.empty() && memcmp(current_key_.data(), end_key_.data(), key_length) >= 0)) {
+      return RC::RECORD_EOF;
+    }
+    if (!tombstone) {
+      rid = handler_.key_normalizer_.rid(current_key_.data());
+      return RC::SUCCESS;
+    }
+  }
+}
+
+RC LsmTreeScanner::close()
+{
+  cursors_.clear();
+  end_key_.clear();
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+RC LsmTreeHandler::create(const char *file_name, vector<AttrType> attr_type, vector<int> attr_length)
+{
+  if (attr_type.empty() || attr_type.size() > MAX_NUM || attr_type.size() != attr_length.size()) {
+    LOG_WARN("invalid lsm index attributes. file name=%s, attr num=%d", file_name, static_cast<int>(attr_type.size()));
+    return RC::INVALID_ARGUMENT;
+  }
+  if (::access(file_name, F_OK) == 0) {
+    LOG_WARN("lsm index file already exists. file name=%s", file_name);
+    return RC::FILE_EXIST;
+  }
+
+  key_normalizer_.init(attr_type, attr_length);
+
+  // 同名的索引删除时可能留下了有序段文件
+  remove_run_files(file_name);
+
+  RC rc = init_handler(file_name);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  lock_guard<mutex> lock(mutex_);
+  rc = write_manifest();
+  if (OB_SUCC(rc)) {
+    LOG_INFO("created lsm index. file name=%s, key length=%d", file_name, key_normalizer_.key_length());
+  }
+  return rc;
+}
+
+RC LsmTreeHandler::open(const char *file_name)
+{
+  int fd = ::open(file_name, O_RDONLY);
+  if (fd < 0) {
+    LOG_WARN("failed to open lsm index manifest. file name=%s, error=%s", file_name, strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+
+  LsmManifestHeader header;
+  int               ret = readn(fd, &header, sizeof(header));
+  vector<int64_t>   run_ids;
+  if (ret == 0 && header.magic == LsmManifestHeader::MAGIC && header.run_count >= 0) {
+    run_ids.resize(header.run_count);
+    ret = readn(fd, run_ids.data(), static_cast<int>(run_ids.size() * sizeof(int64_t)));
+  }
+  ::close(fd);
+  if (ret != 0 || header.magic != LsmManifestHeader::MAGIC) {
+    LOG_WARN("failed to read lsm index manifest. file name=%s, ret=%d", file_name, ret);
+    return RC::IOERR_READ;
+  }
+
+  key_normalizer_.init(vector<AttrType>(header.attr_type, header.attr_type + header.attr_num),
+      vector<int>(header.attr_length, header.attr_length + header.attr_num));
+  file_name_   = file_name;
+  next_run_id_ = header.next_run_id;
+
+  runs_.clear();
+  for (int64_t id : run_ids) {
+    auto run = make_shared<LsmRun>(id, run_file_name(id));
+    RC   rc  = run->open(key_normalizer_.key_length());
+    if (OB_FAIL(rc)) {
+      runs_.clear();
+      return rc;
+    }
+    runs_.push_back(run);
+  }
+
+  // 写完但还没有记到清单中的有序段(比如归并过程中宕机)是没有用的
+  string dir       = ".";
+  string base_name = file_name;
+  if (const char *slash = strrchr(file_name, '/')) {
+    dir.assign(file_name, slash - file_name);
+    base_name = slash + 1;
+  }
+  vector<string> files;
+  list_file(dir.c_str(), nullptr, files);
+  for (const string &file : files) {
+    const string prefix = base_name + ".";
+    if (file.compare(0, prefix.size(), prefix) != 0 || file.size() == prefix.size()) {
+      continue;
+    }
+    const string suffix = file.substr(prefix.size());
+    if (std::all_of(suffix.begin(), suffix.end(), ::isdigit) &&
+        std::none_of(run_ids.begin(), run_ids.end(), [&suffix](int64_t id) { return std::to_string(id) == suffix; })) {
+      ::unlink((dir + "/" + file).c_str());
+      LOG_INFO("removed orphan lsm run. file=%s/%s", dir.c_str(), file.c_str());
+    }
+  }
+
+  RC rc = init_handler(file_name);
+  if (OB_SUCC(rc)) {
+    LOG_INFO("opened lsm index. file name=%s, runs=%d", file_name, static_cast<int>(runs_.size()));
+  }
+  return rc;
+}
+
+RC LsmTreeHandler::init_handler(const char *file_name)
+{
+  file_name_ = file_name;
+  set_memtable_size(memtable_size_);
+  memtable_  = make_unique<LsmMemTable>();
+  immutable_.reset();
+  stop_     = false;
+  busy_     = false;
+  bg_error_ = RC::SUCCESS;
+  opened_   = true;
+  worker_   = thread(&LsmTreeHandler::background_work, this);
+  return RC::SUCCESS;
+}
+
+RC LsmTreeHandler::close()
+{
+  if (!opened_) {
+    return RC::SUCCESS;
+  }
+
+  RC rc = sync();
+  {
+    lock_guard<mutex> lock(mutex_);
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+  worker_.join();
+
+  runs_.clear();
+  memtable_.reset();
+  immutable_.reset();
+  opened_ = false;
+  LOG_INFO("closed lsm index. file name=%s, rc=%s", file_name_.c_str(), strrc(rc));
+  return rc;
+}
+
+RC LsmTreeHandler::sync()
+{
+  unique_lock<mutex> lock(mutex_);
+  if (!opened_) {
+    return RC::SUCCESS;
+  }
+
+  RC rc = rotate_memtable(lock);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  done_cv_.wait(lock, [this] { return immutable_ == nullptr || OB_FAIL(bg_error_); });
+  return bg_error_;
+}
+
+RC LsmTreeHandler::remove_run_files(const char *file_name)
+{
+  string dir       = ".";
+  string base_name = file_name;
+  if (const char *slash = strrchr(file_name, '/')) {
+    dir.assign(file_name, slash - file_name);
+    base_name = slash + 1;
+  }
+
+  vector<string> files;
+  if (list_file(dir.c_str(), nullptr, files) < 0) {
+    return RC::IOERR_READ;
+  }
+
+  const string prefix = base_name + ".";
+  for (const string &file : files) {
+    if (file.compare(0, prefix.size(), prefix) != 0 || file.size() == prefix.size()) {
+      continue;
+    }
+    const string suffix = file.substr(prefix.size());
+    if (suffix == "tmp" || std::all_of(suffix.begin(), suffix.end(), ::isdigit)) {
+      ::unlink((dir + "/" + file).c_str());
+    }
+  }
+  return RC::SUCCESS;
+}
+
+void LsmTreeHandler::set_memtable_size(int64_t size)
+{
+  memtable_size_        = size;
+  memtable_max_entries_ = std::max<int64_t>(16, size / (key_normalizer_.key_length() + MEMTABLE_ENTRY_OVERHEAD));
+}
+
+RC LsmTreeHandler::insert_entry(const char *user_key, const RID *rid)
+{
+  string key(key_normalizer_.key_length(), 0);
+  key_normalizer_.normalize(user_key, *rid, key.data());
+
+  unique_lock<mutex> lock(mutex_);
+  if (is_unique_) {
+    bool exists = false;
+    RC   rc     = exists_live_key(user_key, exists);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    if (exists) {
+      return RC::RECORD_DUPLICATE_KEY;
+    }
+  }
+  return put(lock, std::move(key), false /*tombstone*/);
+}
+
+RC LsmTreeHandler::delete_entry(const char *user_key, const RID *rid)
+{
+  string key(key_normalizer_.key_length(), 0);
+  key_normalizer_.normalize(user_key, *rid, key.data());
+
+  unique_lock<mutex> lock(mutex_);
+  return put(lock, std::move(key), true /*tombstone*/);
+}
+
+RC LsmTreeHandler::put(unique_lock<mutex> &lock, string key, bool tombstone)
+{
+  if (OB_FAIL(bg_error_)) {
+    return bg_error_;
+  }
+
+  (*memtable_)[std::move(key)] = tombstone;
+  if (static_cast<int64_t>(memtable_->size()) >= memtable_max_entries_) {
+    return rotate_memtable(lock);
+  }
+  return RC::SUCCESS;
+}
+
+RC LsmTreeHandler::rotate_memtable(unique_lock<mutex> &lock)
+{
+  // 上一个 memtable 还没有写完时只能等待，避免内存无限增长
+  done_cv_.wait(lock, [this] { return immutable_ == nullptr || OB_FAIL(bg_error_); });
+  if (OB_FAIL(bg_error_)) {
+    return bg_error_;
+  }
+  if (memtable_->empty()) {
+    return RC::SUCCESS;
+  }
+
+  immutable_ = std::move(memtable_);
+  memtable_  = make_unique<LsmMemTable>();
+  work_cv_.notify_one();
+  return RC::SUCCESS;
+}
+
+RC LsmTreeHandler::exists_live_key(const char *user_key, bool &exists)
+{
+  LsmTreeScanner scanner(*this);
+  string         start_key(key_normalizer_.key_length(), 0);
+  scanner.end_key_.resize(key_normalizer_.key_length());
+  key_normalizer_.normalize(user_key, *RID::min(), start_key.data());
+  key_normalizer_.normalize(user_key, *RID::max(), scanner.end_key_.data());
+
+  const uint64_t attr_hash = BloomFilter::hash(start_key.data(), key_normalizer_.attr_length());
+  RC             rc        = open_scanner(scanner, start_key, &attr_hash);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  RID rid;
+  rc     = scanner.next_entry(rid);
+  exists = rc == RC::SUCCESS;
+  return rc == RC::RECORD_EOF ? RC::SUCCESS : rc;
+}
+
+RC LsmTreeHandler::open_scanner(LsmTreeScanner &scanner, const string &start_key, const uint64_t *attr_hash)
+{
+  const int     key_length = key_normalizer_.key_length();
+  const string &end_key    = scanner.end_key_;
+  auto before_end = [&end_key, key_length](const char *key) {
+    return end_key.empty() || memcmp(key, end_key.data(), key_length) < 0;
+  };
+
+  // 当前的 memtable 还会被修改，复制一份。它最多只有 memtable_size_ 大小
+  vector<pair<string, bool>> entries;
+  for (auto iter = memtable_->lower_bound(start_key); iter != memtable_->end() && before_end(iter->first.data());
+       ++iter) {
+    entries.emplace_back(*iter);
+  }
+  if (!entries.empty()) {
+    scanner.cursors_.push_back(make_unique<CopiedCursor>(std::move(entries)));
+  }
+
+  if (immutable_ != nullptr) {
+    auto cursor = make_unique<MemTableCursor>(immutable_, start_key);
+    if (cursor->valid() && before_end(cursor->key())) {
+      scanner.cursors_.push_back(std::move(cursor));
+    }
+  }
+
+  for (const shared_ptr<LsmRun> &run : runs_) {
+    if (memcmp(run->last_key(), start_key.data(), key_length) < 0 || !before_end(run->first_key()) ||
+        (attr_hash != nullptr && !run->may_contain(*attr_hash))) {
+      continue;
+    }
+
+    auto cursor = make_unique<RunCursor>(run);
+    RC   rc     = cursor->seek(start_key);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    if (cursor->valid()) {
+      scanner.cursors_.push_back(std::move(cursor));
+    }
+  }
+  return RC::SUCCESS;
+}
+
+RC LsmTreeHandler::bulk_load(BplusTreeKeySorter &sorter)
+{
+  const int  key_length  = key_normalizer_.key_length();
+  const int  attr_length = key_normalizer_.attr_length();
+  string     last_key;
+  const char *key = nullptr;
+  RC          rc  = RC::SUCCESS;
+
+  int64_t      id = 0;
+  LsmRunWriter writer;
+  {
+    lock_guard<mutex> lock(mutex_);
+    if (!runs_.empty() || !memtable_->empty() || immutable_ != nullptr) {
+      LOG_WARN("lsm index is not empty, cannot bulk load. file name=%s", file_name_.c_str());
+      return RC::INTERNAL;
+    }
+    id = next_run_id_++;
+  }
+
+  rc = writer.open(run_file_name(id), key_normalizer_, sorter.count());
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  while (OB_SUCC(rc = sorter.next(key))) {
+    if (is_unique_ && !last_key.empty() && memcmp(last_key.data(), key, attr_length) == 0) {
+      LOG_WARN("duplicate key found while loading unique lsm index. file name=%s", file_name_.c_str());
+      return RC::RECORD_DUPLICATE_KEY;
+    }
+    last_key.assign(key, key_length);
+
+    rc = writer.add(key, false /*tombstone*/);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+  if (rc != RC::RECORD_EOF) {
+    return rc;
+  }
+  if (writer.entry_count() == 0) {
+    return RC::SUCCESS;
+  }
+
+  rc = writer.finish();
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  auto run = make_shared<LsmRun>(id, run_file_name(id));
+  rc       = run->open(key_length);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  lock_guard<mutex> lock(mutex_);
+  runs_.push_back(run);
+  rc = write_manifest();
+  LOG_INFO("bulk loaded lsm index. file name=%s, entries=%" PRId64 ", rc=%s",
+      file_name_.c_str(), run->entry_count(), strrc(rc));
+  return rc;
+}
+
+RC LsmTreeHandler::wait_for_background()
+{
+  unique_lock<mutex> lock(mutex_);
+  size_t             begin = 0;
+  size_t             end   = 0;
+  done_cv_.wait(lock, [&] {
+    return OB_FAIL(bg_error_) || (immutable_ == nullptr && !busy_ && !pick_compaction(begin, end));
+  });
+  return bg_error_;
+}
+
+int LsmTreeHandler::run_count()
+{
+  lock_guard<mutex> lock(mutex_);
+  return static_cast<int>(runs_.size());
+}
+
+RC LsmTreeHandler::write_manifest()
+{
+  LsmManifestHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic    = LsmManifestHeader::MAGIC;
+  header.attr_num = static_cast<int32_t>(key_normalizer_.attr_type().size());
+  for (int i = 0; i < header.attr_num; i++) {
+    header.attr_type[i]   = key_normalizer_.attr_type()[i];
+    header.attr_length[i] = key_normalizer_.attr_lengths()[i];
+  }
+  header.next_run_id = next_run_id_;
+  header.run_count   = static_cast<int32_t>(runs_.size());
+
+  vector<int64_t> run_ids;
+  for (const shared_ptr<LsmRun> &run : runs_) {
+    run_ids.push_back(run->id());
+  }
+
+  // 先写临时文件再改名，清单文件任何时候都是完整的
+  const string tmp_file = file_name_ + ".tmp";
+  int          fd       = ::open(tmp_file.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0600);
+  if (fd < 0) {
+    LOG_WARN("failed to create lsm manifest. file=%s, error=%s", tmp_file.c_str(), strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+  int ret = writen(fd, &header, sizeof(header));
+  if (ret == 0) {
+    ret = writen(fd, run_ids.data(), static_cast<int>(run_ids.size() * sizeof(int64_t)));
+  }
+  if (ret == 0 && ::fsync(fd) != 0) {
+    ret = errno;
+  }
+  ::close(fd);
+  if (ret != 0 || ::rename(tmp_file.c_str(), file_name_.c_str()) != 0) {
+    LOG_WARN("failed to write lsm manifest. file=%s, error=%s", file_name_.c_str(), strerror(ret != 0 ? ret : errno));
+    return RC::IOERR_WRITE;
+  }
+  return RC::SUCCESS;
+}
+
+void LsmTreeHandler::background_work()
+{
+  unique_lock<mutex> lock(mutex_);
+  while (true) {
+    if (immutable_ != nullptr && OB_SUCC(bg_error_)) {
+      shared_ptr<const LsmMemTable> memtable = immutable_;
+      const int64_t                 id       = next_run_id_++;
+      busy_                                  = true;
+      lock.unlock();
+
+      shared_ptr<LsmRun> run;
+      RC                 rc = write_memtable(*memtable, id, run);
+
+      lock.lock();
+      busy_ = false;
+      if (OB_SUCC(rc)) {
+        runs_.insert(runs_.begin(), run);
+        immutable_.reset();
+        rc = write_manifest();
+      }
+      if (OB_FAIL(rc)) {
+        LOG_ERROR("failed to flush lsm memtable. file name=%s, rc=%s", file_name_.c_str(), strrc(rc));
+        bg_error_ = rc;
+      }
+      done_cv_.notify_all();
+      continue;
+    }
+
+    size_t begin = 0;
+    size_t end   = 0;
+    if (!stop_ && OB_SUCC(bg_error_) && pick_compaction(begin, end)) {
+      vector<shared_ptr<LsmRun>> inputs(runs_.begin() + begin, runs_.begin() + end);
+      // 包含了最老的有序段时，删除标记已经没有需要覆盖的数据了
+      const bool    drop_tombstones = end == runs_.size();
+      const int64_t id              = next_run_id_++;
+      busy_                         = true;
+      lock.unlock();
+
+      shared_ptr<LsmRun> run;
+      RC                 rc = merge_runs(inputs, drop_tombstones, id, run);
+
+      lock.lock();
+      busy_ = false;
+      if (OB_SUCC(rc)) {
+        // 只有后台线程会修改 runs_，这段时间里新写的有序段都在前面，begin 之后的位置没有变化
+        const size_t offset = runs_.size() - end;
+        begin               = runs_.size() - offset - inputs.size();
+        runs_.erase(runs_.begin() + begin, runs_.begin() + begin + inputs.size());
+        if (run != nullptr) {
+          runs_.insert(runs_.begin() + begin, run);
+        }
+        rc = write_manifest();
+      }
+      if (OB_SUCC(rc)) {
+        for (const shared_ptr<LsmRun> &input : inputs) {
+          input->set_obsolete();
+        }
+        LOG_INFO("compacted lsm runs. file name=%s, inputs=%d, entries=%" PRId64,
+            file_name_.c_str(), static_cast<int>(inputs.size()), run != nullptr ? run->entry_count() : 0);
+      } else {
+        LOG_ERROR("failed to compact lsm runs. file name=%s, rc=%s", file_name_.c_str(), strrc(rc));
+        bg_error_ = rc;
+      }
+      done_cv_.notify_all();
+      continue;
+    }
+
+    if (stop_) {
+      break;
+    }
+    work_cv_.wait(lock);
+  }
+}
+
+bool LsmTreeHandler::pick_compaction(size_t &begin, size_t &end) const
+{
+  // 第 n 层的有序段大约是 memtable 的 COMPACTION_TRIGGER^n 倍大，相邻的同一层有序段达到一定数量就归并
+  auto tier_of = [this](const shared_ptr<LsmRun> &run) {
+    int tier = 0;
+    for (int64_t size = memtable_max_entries_; run->entry_count() > size && tier < 32; size *= COMPACTION_TRIGGER) {
+      tier++;
+    }
+    return tier;
+  };
+
+  size_t i = 0;
+  while (i < runs_.size()) {
+    const int tier = tier_of(runs_[i]);
+    size_t    j    = i + 1;
+    while (j < runs_.size() && tier_of(runs_[j]) == tier) {
+      j++;
+    }
+    if (j - i >= static_cast<size_t>(COMPACTION_TRIGGER)) {
+      begin = i;
+      end   = j;
+      return true;
+    }
+    i = j;
+  }
+  return false;
+}
+
+RC LsmTreeHandler::write_memtable(const LsmMemTable &memtable, int64_t id, shared_ptr<LsmRun> &run)
+{
+  LsmRunWriter writer;
+  RC           rc = writer.open(run_file_name(id), key_normalizer_, static_cast<int64_t>(memtable.size()));
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+  for (const auto &[key, tombstone] : memtable) {
+    if (OB_FAIL(rc = writer.add(key.data(), tombstone))) {
+      return rc;
+    }
+  }
+  if (OB_FAIL(rc = writer.finish())) {
+    return rc;
+  }
+
+  run = make_shared<LsmRun>(id, run_file_name(id));
+  rc  = run->open(key_normalizer_.key_length());
+  LOG_INFO("flushed lsm memtable. file=%s, entries=%d, rc=%s",
+      run_file_name(id).c_str(), static_cast<int>(memtable.size()), strrc(rc));
+  return rc;
+}
+
+RC LsmTreeHandler::merge_runs(
+    const vector<shared_ptr<LsmRun>> &inputs, bool drop_tombstones, int64_t id, shared_ptr<LsmRun> &run)
+{
+  const int key_length = key_normalizer_.key_length();
+
+  int64_t                       expected_entries = 0;
+  vector<unique_ptr<LsmCursor>> cursors;
+  for (const shared_ptr<LsmRun> &input : inputs) {
+    auto cursor = make_unique<RunCursor>(input);
+    RC   rc     = cursor->seek(string(key_length, 0));
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    expected_entries += input->entry_count();
+    cursors.push_back(std::move(cursor));
+  }
+
+  LsmRunWriter writer;
+  RC           rc = writer.open(run_file_name(id), key_normalizer_, expected_entries);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  string key;
+  bool   tombstone = false;
+  bool   found     = false;
+  while (OB_SUCC(rc = next_merged(cursors, key_length, key, tombstone, found)) && found) {
+    if (tombstone && drop_tombstones) {
+      continue;
+    }
+    if (OB_FAIL(rc = writer.add(key.data(), tombstone))) {
+      return rc;
+    }
+  }
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  // 所有的数据都被删除了
+  if (writer.entry_count() == 0) {
+    run = nullptr;
+    return RC::SUCCESS;
+  }
+
+  if (OB_FAIL(rc = writer.finish())) {
+    return rc;
+  }
+  run = make_shared<LsmRun>(id, run_file_name(id));
+  return run->open(key_length);
+}
@@ -0,0 +1,320 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/lang/bloom_filter.h"
+#include "common/rc.h"
+#include "storage/index/bplus_tree.h"
+
+class BplusTreeKeySorter;
+class LsmCursor;
+
+/**
+ * @brief LSM树索引
+ * @defgroup LsmTree
+ * @details 写入先放到内存中的有序表(memtable)，写满之后变成只读的，由后台线程写成磁盘上一个
+ * 不可修改的有序段(run)。有序段多了之后，后台线程把大小相近的相邻有序段归并成一个。
+ * 插入只修改内存，不需要像B+树那样随机读写页面；代价是查找时要合并所有有序段的结果，
+ * 每个有序段带一个字段值的布隆过滤器，等值查找可以跳过大部分有序段。
+ * 删除是写入一个删除标记，归并到最老的有序段时才真正丢弃。
+ * memtable 没有单独的日志，重启之后由 clog 重做时重新插入。
+ */
+
+/// 内存中的有序表，键值是规范化编码的字段值加上RID，值表示是否是删除标记
+using LsmMemTable = std::map<std::string, bool>;
+
+/**
+ * @brief 有序段文件的尾部，记录各部分的位置
+ * @ingroup LsmTree
+ * @details 文件依次是数据块、每个数据块的第一个键值和整个文件的最后一个键值、布隆过滤器、这个尾部。
+ * 每一项是规范化编码的键值(参考 KeyNormalizer)加上一个字节的删除标记，数据块中的项是定长的。
+ */
+struct LsmRunFooter
+{
+  static constexpr int32_t MAGIC = 0x4c534d52;
+
+  int32_t magic;
+  int32_t key_length;
+  int64_t entry_count;
+  int32_t entries_per_block;
+  int32_t block_count;
+  int64_t fence_offset;  ///< 每个数据块第一个键值的位置，后面多放一个最后的键值
+  int64_t bloom_offset;  ///< 布隆过滤器位图的位置
+  int32_t bloom_word_count;
+  int32_t bloom_hash_count;
+};
+
+/**
+ * @brief 磁盘上一个不可修改的有序段
+ * @ingroup LsmTree
+ * @details 打开时把块索引和布隆过滤器读到内存中，数据块在访问时才读取。
+ * 被归并掉的有序段标记为废弃，最后一个使用者释放它时才删除文件，正在进行的扫描不受影响。
+ */
+class LsmRun
+{
+public:
+  /// 数据块的大小，一次读取一个数据块
+  static constexpr int BLOCK_SIZE = 4096;
+
+public:
+  LsmRun(int64_t id, std::string file_name) : id_(id), file_name_(std::move(file_name)) {}
+  ~LsmRun();
+
+  RC open(int key_length);
+
+  int64_t id() const { return id_; }
+  int64_t entry_count() const { return footer_.entry_count; }
+  int     entry_size() const { return footer_.key_length + 1; }
+
+  const char *first_key() const { return fences_.data(); }
+  const char *last_key() const { return fences_.data() + static_cast<size_t>(footer_.block_count) * footer_.key_length; }
+
+  /**
+   * @brief 字段值的哈希值是否可能出现在这个有序段中
+   */
+  bool may_contain(uint64_t attr_hash) const { return bloom_.may_contain(attr_hash); }
+
+  /**
+   * @brief 找到可能包含 key 的数据块，即第一个键值不大于 key 的最后一个数据块
+   */
+  int find_block(const char *key) const;
+
+  int block_count() const { return footer_.block_count; }
+  int block_entry_count(int block) const;
+
+  /**
+   * @brief 读取一个数据块，buf 至少要有 BLOCK_SIZE 大小
+   */
+  RC read_block(int block, char *buf) const;
+
+  void set_obsolete() { obsolete_ = true; }
+
+private:
+  int64_t             id_;
+  std::string         file_name_;
+  int                 fd_ = -1;
+  LsmRunFooter        footer_{};
+  std::string         fences_;  ///< 每个数据块的第一个键值，最后多一个整个有序段的最后一个键值
+  common::BloomFilter bloom_;
+  bool                obsolete_ = false;
+};
+
+/**
+ * @brief 按顺序写一个有序段文件
+ * @ingroup LsmTree
+ */
+class LsmRunWriter
+{
+public:
+  LsmRunWriter() = default;
+  ~LsmRunWriter();
+
+  /**
+   * @param expected_entries 预计写入的项数，用来确定布隆过滤器的大小
+   */
+  RC open(const std::string &file_name, const KeyNormalizer &normalizer, int64_t expected_entries);
+
+  /**
+   * @brief 追加一项，键值必须比之前的都大
+   */
+  RC add(const char *key, bool tombstone);
+
+  /**
+   * @brief 写入块索引、布隆过滤器和文件尾，同步到磁盘
+   */
+  RC finish();
+
+  int64_t entry_count() const { return footer_.entry_count; }
+
+private:
+  RC write(const char *data, int size);
+  RC flush_block();
+
+private:
+  std::string         file_name_;
+  int                 fd_          = -1;
+  int                 attr_length_ = 0;
+  int64_t             offset_      = 0;
+  LsmRunFooter        footer_{};
+  std::string         block_;
+  std::string         fences_;
+  std::string         last_key_;
+  common::BloomFilter bloom_;
+};
+
+class LsmTreeHandler;
+
+/**
+ * @brief LSM树的扫描器
+ * @ingroup LsmTree
+ * @details 打开时复制当前 memtable 中在范围内的部分，并引用只读的 memtable 和所有的有序段，
+ * 之后的扫描不再需要加锁。所有来源按照从新到旧排列，同一个键值以最新的一个为准。
+ */
+class LsmTreeScanner
+{
+public:
+  LsmTreeScanner(LsmTreeHandler &handler);
+  ~LsmTreeScanner();
+
+  /**
+   * @brief 扫描指定范围的数据，参数的含义与 BplusTreeScanner::open 相同
+   * @details 字段值可以比索引字段短(比如字符串)，会在后面补0。左右边界相同并且都包含时是等值查找，
+   * 会使用布隆过滤器跳过不可能包含这个值的有序段
+   */
+  RC open(const char *left_user_key, int left_len, bool left_inclusive, const char *right_user_key, int right_len,
+      bool right_inclusive);
+
+  RC next_entry(RID &rid);
+  RC close();
+
+private:
+  friend class LsmTreeHandler;
+
+  LsmTreeHandler                         &handler_;
+  std::vector<std::unique_ptr<LsmCursor>> cursors_;  ///< 从新到旧
+  std::string                             end_key_;  ///< 不包含，为空表示没有右边界
+  std::string                             current_key_;
+};
+
+/**
+ * @brief LSM树的清单文件头，清单文件就是索引文件
+ * @ingroup LsmTree
+ * @details 后面紧跟着 run_count 个有序段的编号，从新到旧排列。
+ * 每次修改都先写一个临时文件再改名，所以清单文件总是完整的。
+ */
+struct LsmManifestHeader
+{
+  static constexpr int32_t MAGIC = 0x4c534d4d;
+
+  int32_t  magic;
+  int32_t  attr_num;
+  int32_t  attr_length[MAX_NUM];
+  AttrType attr_type[MAX_NUM];
+  int64_t  next_run_id;
+  int32_t  run_count;
+};
+
+/**
+ * @brief LSM树的操作入口
+ * @ingroup LsmTree
+ * @details 有序段文件的名字是索引文件名加上编号。每个打开的索引有一个后台线程负责写盘和归并。
+ */
+class LsmTreeHandler
+{
+public:
+  /// memtable 默认最多使用的内存
+  static constexpr int64_t DEFAULT_MEMTABLE_SIZE = 4 * 1024 * 1024;
+  /// 大小相近的有序段达到这个数量时归并成一个
+  static constexpr int COMPACTION_TRIGGER = 4;
+
+public:
+  LsmTreeHandler() = default;
+  ~LsmTreeHandler() { close(); }
+
+  RC create(const char *file_name, std::vector<AttrType> attr_type, std::vector<int> attr_length);
+  RC open(const char *file_name);
+
+  /**
+   * @brief 把 memtable 写成有序段，停止后台线程
+   */
+  RC close();
+
+  /**
+   * @brief 把 memtable 中的数据写成有序段
+   */
+  RC sync();
+
+  /**
+   * @brief 删除索引的所有有序段文件，清单文件由调用者删除
+   */
+  static RC remove_run_files(const char *file_name);
+
+  void set_unique(int unique) { is_unique_ = unique; }
+
+  /**
+   * @brief 设置 memtable 最多使用的内存，用于测试
+   */
+  void set_memtable_size(int64_t size);
+
+  /**
+   * @brief 插入一个键值
+   * @details 唯一索引需要先查找字段值是否已经存在，查找期间会阻塞其它写入
+   * @return 唯一索引中字段值已经存在时返回 RECORD_DUPLICATE_KEY
+   */
+  RC insert_entry(const char *user_key, const RID *rid);
+
+  /**
+   * @brief 删除一个键值，只写入删除标记，不检查是否存在
+   */
+  RC delete_entry(const char *user_key, const RID *rid);
+
+  /**
+   * @brief 把排好序的键值直接写成一个有序段，只能用于刚创建的空索引
+   */
+  RC bulk_load(BplusTreeKeySorter &sorter);
+
+  /**
+   * @brief 等待后台线程把只读的 memtable 写完，并完成所有需要的归并，测试使用
+   */
+  RC wait_for_background();
+
+  const KeyNormalizer &key_normalizer() const { return key_normalizer_; }
+
+  int run_count();
+
+private:
+  friend class LsmTreeScanner;
+
+  std::string run_file_name(int64_t id) const { return file_name_ + "." + std::to_string(id); }
+
+  RC   init_handler(const char *file_name);
+  RC   write_manifest();
+  RC   put(std::unique_lock<std::mutex> &lock, std::string key, bool tombstone);
+  RC   rotate_memtable(std::unique_lock<std::mutex> &lock);
+  RC   open_scanner(LsmTreeScanner &scanner, const std::string &start_key, const uint64_t *attr_hash);
+  RC   exists_live_key(const char *user_key, bool &exists);
+
+  void background_work();
+  bool pick_compaction(size_t &begin, size_t &end) const;
+  RC   write_memtable(const LsmMemTable &memtable, int64_t id, std::shared_ptr<LsmRun> &run);
+  RC   merge_runs(const std::vector<std::shared_ptr<LsmRun>> &inputs, bool drop_tombstones, int64_t id,
+        std::shared_ptr<LsmRun> &run);
+
+private:
+  std::string   file_name_;
+  KeyNormalizer key_normalizer_;
+  int           is_unique_            = 0;
+  int64_t       memtable_size_        = DEFAULT_MEMTABLE_SIZE;
+  int64_t       memtable_max_entries_ = 0;
+  bool          opened_               = false;
+
+  std::mutex              mutex_;
+  std::condition_variable work_cv_;  ///< 唤醒后台线程
+  std::condition_variable done_cv_;  ///< 后台线程完成了一次写盘或归并
+
+  std::unique_ptr<LsmMemTable>         memtable_;
+  std::shared_ptr<const LsmMemTable>   immutable_;  ///< 正在等待写盘的 memtable
+  std::vector<std::shared_ptr<LsmRun>> runs_;       ///< 从新到旧
+  int64_t                              next_run_id_ = 1;
+
+  std::thread worker_;
+  bool        stop_     = false;
+  bool        busy_     = false;        ///< 后台线程正在不持有锁地写文件
+  RC          bg_error_ = RC::SUCCESS;  ///< 后台线程写文件失败之后，不再接受写入
+};
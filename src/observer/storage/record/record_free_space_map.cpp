@@ -0,0 +1,321 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <string.h>
+
+#include "storage/record/record_free_space_map.h"
+#include "common/lang/bitmap.h"
+#include "common/log/log.h"
+#include "storage/buffer/disk_buffer_pool.h"
+
+using namespace common;
+
+/// 每个FSM页面可以记录多少个页面的空闲等级，每个页面占2个bit
+static constexpr int LEVELS_PER_MAP_PAGE = (BP_PAGE_DATA_SIZE - sizeof(FreeSpaceMapPageHeader)) * 4;
+
+/// 第一个FSM页面紧跟在BufferPool文件头页面后面
+static constexpr PageNum FIRST_MAP_PAGE = BP_HEADER_PAGE + 1;
+
+RC RecordFreeSpaceMap::create(DiskBufferPool &buffer_pool)
+{
+  const int map_page_count = (BPFileHeader::MAX_PAGE_NUM + LEVELS_PER_MAP_PAGE - 1) / LEVELS_PER_MAP_PAGE;
+
+  RC rc = RC::SUCCESS;
+  for (int i = 0; i < map_page_count; i++) {
+    Frame *frame = nullptr;
+    rc           = buffer_pool.allocate_page(&frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate free space map page. rc=%s", strrc(rc));
+      return rc;
+    }
+
+    if (frame->page_num() != FIRST_MAP_PAGE + i) {
+      LOG_WARN("free space map should be created on a new file. page num=%d", frame->page_num());
+      buffer_pool.unpin_page(frame);
+      return RC::INTERNAL;
+    }
+
+    memset(frame->data(), 0, BP_PAGE_DATA_SIZE);
+    auto *header           = reinterpret_cast<FreeSpaceMapPageHeader *>(frame->data());
+    header->magic          = MAGIC;
+    header->index          = i;
+    header->map_page_count = map_page_count;
+    frame->mark_dirty();
+    buffer_pool.unpin_page(frame);
+  }
+
+  disk_buffer_pool_ = &buffer_pool;
+  map_page_count_   = map_page_count;
+  levels_.assign(FIRST_MAP_PAGE + map_page_count, FULL);
+  resize_groups();
+  free_page_count_     = 0;
+  overflow_page_count_ = 0;
+  LOG_INFO("create free space map done. map page count=%d", map_page_count);
+  return rc;
+}
+
+RC RecordFreeSpaceMap::open(DiskBufferPool &buffer_pool, bool &found)
+{
+  found             = false;
+  disk_buffer_pool_ = &buffer_pool;
+  map_page_count_      = 0;
+  free_page_count_     = 0;
+  overflow_page_count_ = 0;
+  levels_.clear();
+  group_free_counts_.clear();
+  for (std::vector<char> &bitmap : group_bitmaps_) {
+    bitmap.clear();
+  }
+
+  BufferPoolIterator bp_iterator;
+  bp_iterator.init(buffer_pool);
+  if (!bp_iterator.has_next() || bp_iterator.next() != FIRST_MAP_PAGE) {
+    return RC::SUCCESS;
+  }
+
+  Frame *frame = nullptr;
+  RC     rc    = buffer_pool.get_this_page(FIRST_MAP_PAGE, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get free space map page. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  if (!is_map_page(frame->data())) {
+    buffer_pool.unpin_page(frame);
+    return RC::SUCCESS;
+  }
+
+  const auto *first_header   = reinterpret_cast<const FreeSpaceMapPageHeader *>(frame->data());
+  const int   map_page_count = first_header->map_page_count;
+  overflow_page_count_       = first_header->overflow_page_count;
+  buffer_pool.unpin_page(frame);
+
+  levels_.assign(FIRST_MAP_PAGE + map_page_count, FULL);
+  resize_groups();
+  for (int i = 0; i < map_page_count; i++) {
+    rc = buffer_pool.get_this_page(FIRST_MAP_PAGE + i, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get free space map page. page num=%d, rc=%s", FIRST_MAP_PAGE + i, strrc(rc));
+      return rc;
+    }
+
+    const char *data = frame->data() + sizeof(FreeSpaceMapPageHeader);
+    for (int j = 0; j < LEVELS_PER_MAP_PAGE; j++) {
+      const uint8_t level = (data[j / 4] >> ((j % 4) * 2)) & 0x3;
+      if (level == FULL) {
+        continue;
+      }
+
+      set_level(i * LEVELS_PER_MAP_PAGE + j, level);
+    }
+    buffer_pool.unpin_page(frame);
+  }
+
+  map_page_count_ = map_page_count;
+  found           = true;
+  LOG_INFO("load free space map done. map page count=%d, free page count=%d, overflow page count=%d",
+           map_page_count_, free_page_count_, overflow_page_count_);
+  return RC::SUCCESS;
+}
+
+void RecordFreeSpaceMap::close()
+{
+  disk_buffer_pool_    = nullptr;
+  map_page_count_      = 0;
+  free_page_count_     = 0;
+  overflow_page_count_ = 0;
+  levels_.clear();
+  group_free_counts_.clear();
+  for (std::vector<char> &bitmap : group_bitmaps_) {
+    bitmap.clear();
+  }
+}
+
+bool RecordFreeSpaceMap::is_map_page_num(PageNum page_num) const
+{
+  return page_num >= FIRST_MAP_PAGE && page_num < FIRST_MAP_PAGE + map_page_count_;
+}
+
+void RecordFreeSpaceMap::add_overflow_pages(int count)
+{
+  if (count == 0) {
+    return;
+  }
+
+  lock_.lock();
+  overflow_page_count_ = std::max(overflow_page_count_ + count, 0);
+  if (map_page_count_ > 0) {
+    Frame *frame = nullptr;
+    RC     rc    = disk_buffer_pool_->get_this_page(FIRST_MAP_PAGE, &frame);
+    if (OB_SUCC(rc)) {
+      reinterpret_cast<FreeSpaceMapPageHeader *>(frame->data())->overflow_page_count = overflow_page_count_;
+      frame->mark_dirty();
+      disk_buffer_pool_->unpin_page(frame);
+    } else {
+      LOG_WARN("failed to get free space map page. rc=%s", strrc(rc));
+    }
+  }
+  lock_.unlock();
+}
+
+RC RecordFreeSpaceMap::update(PageNum page_num, FreeSpaceLevel level)
+{
+  if (page_num < FIRST_MAP_PAGE + map_page_count_) {
+    return RC::INVALID_ARGUMENT;
+  }
+
+  lock_.lock();
+  if (page_num < static_cast<PageNum>(levels_.size()) && levels_[page_num] == level) {
+    lock_.unlock();
+    return RC::SUCCESS;
+  }
+
+  set_level(page_num, level);
+
+  RC rc = RC::SUCCESS;
+  if (map_page_count_ > 0) {
+    rc = write_level(page_num, level);
+  }
+  lock_.unlock();
+  return rc;
+}
+
+PageNum RecordFreeSpaceMap::find_free_page(PageNum start_page, FreeSpaceLevel min_level)
+{
+  lock_.lock();
+  if (free_page_count_ <= 0) {
+    lock_.unlock();
+    return BP_INVALID_PAGE_NUM;
+  }
+
+  const PageNum page_count = static_cast<PageNum>(levels_.size());
+  if (start_page < 0 || start_page >= page_count) {
+    start_page = 0;
+  }
+  const int count_index = std::max<int>(min_level, LOW) - 1;
+
+  // 在一个组内查找 [begin, end) 范围的页面，一个组最多 GROUP_SIZE 个页面
+  auto find_in_group = [this, page_count, min_level](PageNum begin, PageNum end) {
+    for (PageNum current = begin; current < std::min(end, page_count); current++) {
+      if (levels_[current] >= min_level) {
+        return current;
+      }
+    }
+    return BP_INVALID_PAGE_NUM;
+  };
+
+  // 先找 start_page 所在的组中 start_page 之后的页面，再用位图找到下一个(循环)有足够空闲页面的组。
+  // 位图中的位与 group_free_counts_ 一起维护，置位的组中一定能找到，不用逐个组地检查计数。
+  // 转了一圈回到 start_page 所在的组时，只剩 start_page 前面的页面没有找过
+  const int      group_count = static_cast<int>(group_free_counts_.size());
+  const int      start_group = start_page / GROUP_SIZE;
+  common::Bitmap groups(group_bitmaps_[count_index].data(), group_count);
+
+  PageNum page_num = BP_INVALID_PAGE_NUM;
+  if (groups.get_bit(start_group)) {
+    page_num = find_in_group(start_page, (start_group + 1) * GROUP_SIZE);
+  }
+  if (page_num == BP_INVALID_PAGE_NUM) {
+    int group = groups.next_setted_bit(start_group + 1);
+    if (group < 0) {
+      group = groups.next_setted_bit(0);
+    }
+    if (group == start_group) {
+      page_num = find_in_group(group * GROUP_SIZE, start_page);
+    } else if (group >= 0) {
+      page_num = find_in_group(group * GROUP_SIZE, (group + 1) * GROUP_SIZE);
+    }
+  }
+  lock_.unlock();
+  return page_num;
+}
+
+void RecordFreeSpaceMap::set_level(PageNum page_num, uint8_t level)
+{
+  if (page_num >= static_cast<PageNum>(levels_.size())) {
+    levels_.resize(page_num + 1, FULL);
+    resize_groups();
+  }
+
+  const uint8_t old_level = levels_[page_num];
+  levels_[page_num]       = level;
+  if (old_level == FULL && level != FULL) {
+    free_page_count_++;
+  } else if (old_level != FULL && level == FULL) {
+    free_page_count_--;
+  }
+
+  const int                   group  = page_num / GROUP_SIZE;
+  std::array<int32_t, EMPTY> &counts = group_free_counts_[group];
+  for (int i = LOW; i <= EMPTY; i++) {
+    const int delta = static_cast<int>(level >= i) - static_cast<int>(old_level >= i);
+    if (delta == 0) {
+      continue;
+    }
+
+    counts[i - 1] += delta;
+    common::Bitmap bitmap(group_bitmaps_[i - 1].data(), static_cast<int>(group_free_counts_.size()));
+    if (counts[i - 1] > 0) {
+      bitmap.set_bit(group);
+    } else {
+      bitmap.clear_bit(group);
+    }
+  }
+}
+
+void RecordFreeSpaceMap::resize_groups()
+{
+  const size_t group_count = (levels_.size() + GROUP_SIZE - 1) / GROUP_SIZE;
+  group_free_counts_.resize(group_count, {});
+  for (std::vector<char> &bitmap : group_bitmaps_) {
+    bitmap.resize((group_count + 7) / 8, 0);
+  }
+}
+
+RecordFreeSpaceMap::FreeSpaceLevel RecordFreeSpaceMap::level_of(int record_num, int record_capacity)
+{
+  if (record_num >= record_capacity) {
+    return FULL;
+  }
+  if (record_num == 0) {
+    return EMPTY;
+  }
+  return (record_capacity - record_num) * 2 >= record_capacity ? HIGH : LOW;
+}
+
+bool RecordFreeSpaceMap::is_map_page(const char *page_data)
+{
+  return reinterpret_cast<const FreeSpaceMapPageHeader *>(page_data)->magic == MAGIC;
+}
+
+RC RecordFreeSpaceMap::write_level(PageNum page_num, FreeSpaceLevel level)
+{
+  const PageNum map_page_num = FIRST_MAP_PAGE + page_num / LEVELS_PER_MAP_PAGE;
+  const int     index        = page_num % LEVELS_PER_MAP_PAGE;
+  if (map_page_num >= FIRST_MAP_PAGE + map_page_count_) {
+    LOG_WARN("page num out of free space map range. page num=%d", page_num);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  Frame *frame = nullptr;
+  RC     rc    = disk_buffer_pool_->get_this_page(map_page_num, &frame);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get free space map page. page num=%d, rc=%s", map_page_num, strrc(rc));
+    return rc;
+  }
+
+  char     *byte  = frame->data() + sizeof(FreeSpaceMapPageHeader) + index / 4;
+  const int shift = (index % 4) * 2;
+  *byte           = static_cast<char>((*byte & ~(0x3 << shift)) | (level << shift));
+  frame->mark_dirty();
+  disk_buffer_pool_->unpin_page(frame);
+  return rc;
+}
@@ -0,0 +1,146 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "common/lang/mutex.h"
+#include "common/rc.h"
+#include "common/types.h"
+#include "storage/buffer/page.h"
+
+class DiskBufferPool;
+
+/**
+ * @brief 空闲空间映射页面(FSM页面)的页头
+ * @ingroup RecordManager
+ */
+struct FreeSpaceMapPageHeader
+{
+  int32_t magic;                ///< 用来区分FSM页面与记录页面
+  int32_t index;                ///< 当前是第几个FSM页面
+  int32_t map_page_count;       ///< 一共有多少个FSM页面
+  int32_t overflow_page_count;  ///< 变长格式的溢出页面个数，只记录在第一个FSM页面上
+};
+
+/**
+ * @brief 记录文件的空闲空间映射(Free Space Map)
+ * @ingroup RecordManager
+ * @details 每个页面使用2个bit记录它的空闲程度(参考 FreeSpaceLevel)，存放在数据文件中紧跟着
+ * BufferPool文件头的几个专用页面中。这样打开表时只需要读取这几个页面，不再需要遍历整个文件。
+ * 内存中保存一份完整的副本用来查找空闲页面，只有某个页面的空闲等级发生变化时，才会写到对应的
+ * FSM页面上并标记为脏页，由buffer pool负责刷盘。
+ *
+ * FSM中的信息只是一个提示：插入记录时拿到页面锁后依然会检查页面是否真的还有空间，如果不一致就修正FSM。
+ * 所以FSM不需要记录日志，崩溃后FSM落后于数据页面也不影响正确性，恢复时重做的插入也会更新FSM。
+ *
+ * 老版本创建的数据文件中没有FSM页面，这时由 RecordFileHandler 在启动时扫描所有页面，
+ * FSM 仅在内存中维护。
+ */
+class RecordFreeSpaceMap
+{
+public:
+  /**
+   * @brief 页面的空闲等级
+   */
+  enum FreeSpaceLevel : uint8_t
+  {
+    FULL  = 0,  ///< 已经满了(或者不是记录页面)
+    LOW   = 1,  ///< 空闲空间不到一半
+    HIGH  = 2,  ///< 空闲空间超过一半
+    EMPTY = 3,  ///< 页面上没有记录
+  };
+
+  static constexpr int32_t MAGIC = 0x46534d31;  // "FSM1"
+
+public:
+  RecordFreeSpaceMap() = default;
+  ~RecordFreeSpaceMap() = default;
+
+  /**
+   * @brief 在一个新的数据文件上创建FSM页面
+   * @details 必须在文件还没有分配任何数据页面时调用，这样FSM页面就是紧跟文件头的几个页面
+   */
+  RC create(DiskBufferPool &buffer_pool);
+
+  /**
+   * @brief 从数据文件中加载FSM
+   *
+   * @param found 返回文件中是否有FSM页面。没有时，调用者需要自己扫描数据页面并调用 update 填充
+   */
+  RC open(DiskBufferPool &buffer_pool, bool &found);
+
+  void close();
+
+  /**
+   * @brief 更新某个页面的空闲等级
+   */
+  RC update(PageNum page_num, FreeSpaceLevel level);
+
+  /**
+   * @brief 从 start_page 开始(循环)查找一个空闲等级不低于 min_level 的页面
+   * @return 找不到时返回 BP_INVALID_PAGE_NUM
+   */
+  PageNum find_free_page(PageNum start_page, FreeSpaceLevel min_level = LOW);
+
+  /**
+   * @brief 分配或者释放了 count 个溢出页面(释放时为负数)
+   * @details 溢出页面个数只用来计算记录页面的个数，与空闲等级一样不记录日志，崩溃之后可能不准确
+   */
+  void add_overflow_pages(int count);
+
+  /**
+   * @brief 页面是否是FSM页面
+   */
+  bool is_map_page_num(PageNum page_num) const;
+
+  int map_page_count() const { return map_page_count_; }
+  int overflow_page_count() const { return overflow_page_count_; }
+
+  /**
+   * @brief 根据页面上的记录个数和容量计算空闲等级
+   */
+  static FreeSpaceLevel level_of(int record_num, int record_capacity);
+
+  /**
+   * @brief 判断某个页面的内容是否是FSM页面
+   */
+  static bool is_map_page(const char *page_data);
+
+private:
+  RC write_level(PageNum page_num, FreeSpaceLevel level);
+
+  /**
+   * @brief 修改内存中某个页面的空闲等级，同时维护 group_free_counts_ 和 group_bitmaps_。调用者需要加锁
+   */
+  void set_level(PageNum page_num, uint8_t level);
+
+  /**
+   * @brief 页面个数变多时，扩大按组汇总的计数和位图。调用者需要加锁
+   */
+  void resize_groups();
+
+  /// 每 GROUP_SIZE 个页面汇总一次空闲页面个数，查找时跳过没有空闲页面的组
+  static constexpr int GROUP_SIZE = 256;
+
+private:
+  DiskBufferPool      *disk_buffer_pool_ = nullptr;
+  std::vector<uint8_t> levels_;                  ///< 每个页面的空闲等级，下标就是页号
+  int                  free_page_count_     = 0;  ///< 没有满的页面个数
+  /// 每组页面中空闲等级不低于 LOW/HIGH/EMPTY 的页面个数
+  std::vector<std::array<int32_t, EMPTY>> group_free_counts_;
+  /// 对应 LOW/HIGH/EMPTY 各一个位图，第 i 位表示第 i 组中有没有不低于这个等级的页面
+  std::array<std::vector<char>, EMPTY> group_bitmaps_;
+  int                  map_page_count_      = 0;  ///< FSM页面个数，为0表示FSM仅在内存中
+  int                  overflow_page_count_ = 0;  ///< 溢出页面个数
+  common::Mutex        lock_;
+};
@@ -11,10 +11,17 @@ See the Mulan PSL v2 for more details. */
 //
 // Created by Meiyi & Longda on 2021/4/13.
 //
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+
 #include "storage/record/record_manager.h"
 #include "common/lang/bitmap.h"
 #include "common/log/log.h"
 #include "storage/common/condition_filter.h"
+#include "storage/table/table.h"
+#include "storage/table/table_meta.h"
 #include "storage/trx/trx.h"
 
 using namespace common;
@@ -50,6 +57,29 @@ int page_record_capacity(int page_size, int record_size)
  */
 int page_bitmap_size(int record_capacity) { return (record_capacity + 7) / 8; }
 
+/**
+ * @brief 把新的值写到记录中指定字段的位置
+ */
+static void write_field_value(Record &record, Field *field, const Value *value)
+{
+  LOG_DEBUG("[[[[[[[RC RecordPageHandler::update_record]]]]]]] test:%d, value_len:%d",field->meta()->len(), strlen(value->data()));
+
+  // 更新value
+  // ATTENTION!!!:地址越界问题：字符串情况下，value的长度只会是字符串的长度，因此如果直接memcpy
+  // meta长度的话，直接就越界了 memcpy(rec->data() + field->meta()->offset(), value->data(), field->meta()->len());
+
+  // 获取字段最大长度和输入值的长度
+  size_t max_field_len = field->meta()->len();   // 字段的最大长度
+  size_t input_len     = strlen(value->data());  // 输入值的实际长度
+
+  // 计算要复制的长度，取输入长度和字段最大长度中的较小者
+  size_t copy_len = (input_len < max_field_len) ? input_len : max_field_len - 1;
+  memcpy(record.data() + field->meta()->offset(),
+      value->data(),
+      copy_len);  // 将数据复制到记录中，确保不会超过字段的最大长度
+  record.data()[field->meta()->offset() + copy_len] = '\0';  // 在复制后的字符串末尾添加空字符，确保字符串正确终止
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 RecordPageIterator::RecordPageIterator() {}
 RecordPageIterator::~RecordPageIterator() {}
@@ -250,10 +280,6 @@ RC RecordPageHandler::delete_record(const RID *rid)
     page_header_->record_num--;
     frame_->mark_dirty();
 
-    if (page_header_->record_num == 0) {
-      // PageNum page_num = get_page_num();
-      cleanup();
-    }
     return RC::SUCCESS;
   } else {
     LOG_DEBUG("Invalid slot_num %d, slot is empty, page_num %d.", rid->slot_num, frame_->page_num());
@@ -279,23 +305,7 @@ RC RecordPageHandler::update_record(const RID *rid, Field *field, const Value *v
   // 在memory中对应的Field中写入新Value
   // 更新指定字段: 当前方案为 1.取出已有record，2.在mem
   // pile上写新数据到record中，3.flush整个record到原始指针处（不写单个field了）
-
-  LOG_DEBUG("[[[[[[[RC RecordPageHandler::update_record]]]]]]] test:%d, value_len:%d",field->meta()->len(), strlen(value->data()));
-
-  // 更新value
-  // ATTENTION!!!:地址越界问题：字符串情况下，value的长度只会是字符串的长度，因此如果直接memcpy
-  // meta长度的话，直接就越界了 memcpy(rec->data() + field->meta()->offset(), value->data(), field->meta()->len());
-
-  // 获取字段最大长度和输入值的长度
-  size_t max_field_len = field->meta()->len();   // 字段的最大长度
-  size_t input_len     = strlen(value->data());  // 输入值的实际长度
-
-  // 计算要复制的长度，取输入长度和字段最大长度中的较小者
-  size_t copy_len = (input_len < max_field_len) ? input_len : max_field_len - 1;
-  memcpy(rec->data() + field->meta()->offset(),
-      value->data(),
-      copy_len);  // 将数据复制到记录中，确保不会超过字段的最大长度
-  rec->data()[field->meta()->offset() + copy_len] = '\0';  // 在复制后的字符串末尾添加空字符，确保字符串正确终止
+  write_field_value(*rec, field, value);
 
   // 更新memory
   char *record_data = get_record_data(rid->slot_num);  // 奥卡姆剃刀
@@ -323,6 +333,17 @@ RC RecordPageHandler::get_record(const RID *rid, Record *rec)
   return RC::SUCCESS;
 }
 
+bool RecordPageHandler::is_slot_used(SlotNum slot_num) const
+{
+  if (slot_num < 0 || slot_num >= page_header_->record_capacity) {
+    LOG_ERROR("Invalid slot_num:%d, exceed page's record capacity, page_num %d.", slot_num, frame_->page_num());
+    return false;
+  }
+
+  Bitmap bitmap(bitmap_, page_header_->record_capacity);
+  return bitmap.get_bit(slot_num);
+}
+
 PageNum RecordPageHandler::get_page_num() const
 {
   if (nullptr == page_header_) {
@@ -333,33 +354,106 @@ PageNum RecordPageHandler::get_page_num() const
 
 bool RecordPageHandler::is_full() const { return page_header_->record_num >= page_header_->record_capacity; }
 
+RecordFreeSpaceMap::FreeSpaceLevel RecordPageHandler::free_level() const
+{
+  return RecordFreeSpaceMap::level_of(page_header_->record_num, page_header_->record_capacity);
+}
+
+bool RecordPageHandler::is_record_page() const { return !RecordFreeSpaceMap::is_map_page(frame_->data()); }
+
 ////////////////////////////////////////////////////////////////////////////////
 
+
 RecordFileHandler::~RecordFileHandler() { this->close(); }
 
-RC RecordFileHandler::init(DiskBufferPool *buffer_pool)
+RC RecordFileHandler::init(DiskBufferPool *buffer_pool, const TableMeta *table_meta, const char *zone_map_file)
 {
   if (disk_buffer_pool_ != nullptr) {
     LOG_ERROR("record file handler has been openned.");
     return RC::RECORD_OPENNED;
   }
 
+  storage_format_ = StorageFormat::ROW_FORMAT;
+  if (table_meta != nullptr && table_meta->storage_format() == StorageFormat::VARLEN_FORMAT) {
+    RC rc = varlen_codec_.init(*table_meta->field_metas(), table_meta->record_size());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init varlen record codec. table=%s, rc=%s", table_meta->name(), strrc(rc));
+      return rc;
+    }
+    storage_format_ = StorageFormat::VARLEN_FORMAT;
+  }
+
   disk_buffer_pool_ = buffer_pool;
+  for (std::atomic<PageNum> &target_page : insert_target_pages_) {
+    target_page.store(BP_INVALID_PAGE_NUM);
+  }
+
+  // 新文件直接创建空闲空间映射页面，已有的文件从映射页面中加载，老版本的文件只能遍历所有页面
+  RC                 rc = RC::SUCCESS;
+  BufferPoolIterator bp_iterator;
+  bp_iterator.init(*disk_buffer_pool_);
+  if (!bp_iterator.has_next()) {
+    rc = free_space_map_.create(*disk_buffer_pool_);
+  } else {
+    bool found = false;
+    rc         = free_space_map_.open(*disk_buffer_pool_, found);
+    if (OB_SUCC(rc) && !found) {
+      rc = init_free_pages();
+    }
+  }
 
-  RC rc = init_free_pages();
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init free space map. rc=%s", strrc(rc));
+    disk_buffer_pool_ = nullptr;
+    return rc;
+  }
+
+  if (table_meta != nullptr && zone_map_file != nullptr) {
+    std::vector<const FieldMeta *> field_metas;
+    for (int i = table_meta->sys_field_num(); i < table_meta->field_num(); i++) {
+      field_metas.push_back(table_meta->field(i));
+    }
+
+    bool found = false;
+    rc         = zone_map_.open(zone_map_file, field_metas, found);
+    if (OB_SUCC(rc) && !found && zone_map_.enabled()) {
+      rc = init_zone_map();
+    }
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init zone map. rc=%s", strrc(rc));
+      free_space_map_.close();
+      disk_buffer_pool_ = nullptr;
+      return rc;
+    }
+  }
 
   LOG_INFO("open record file handle done. rc=%s", strrc(rc));
   return RC::SUCCESS;
 }
 
+int32_t RecordFileHandler::data_page_count() const
+{
+  // 除去文件头页面、空闲空间映射页面和溢出页面，剩下的都是记录页面
+  const int32_t pages = disk_buffer_pool_->allocated_pages() - 1 - free_space_map_.map_page_count() -
+                        free_space_map_.overflow_page_count();
+  return std::max(pages, 0);
+}
+
 void RecordFileHandler::close()
 {
   if (disk_buffer_pool_ != nullptr) {
-    free_pages_.clear();
+    free_space_map_.close();
+    zone_map_.close();
     disk_buffer_pool_ = nullptr;
   }
 }
 
+std::atomic<PageNum> &RecordFileHandler::insert_target_page()
+{
+  const size_t slot = std::hash<std::thread::id>()(std::this_thread::get_id()) % INSERT_TARGET_SLOTS;
+  return insert_target_pages_[slot];
+}
+
 RC RecordFileHandler::init_free_pages()
 {
   // 遍历当前文件上所有页面，找到没有满的页面
@@ -372,10 +466,28 @@ RC RecordFileHandler::init_free_pages()
   bp_iterator.init(*disk_buffer_pool_);
   RecordPageHandler record_page_handler;
   PageNum           current_page_num = 0;
+  int               free_page_num    = 0;
 
   while (bp_iterator.has_next()) {
     current_page_num = bp_iterator.next();
 
+    if (storage_format_ == StorageFormat::VARLEN_FORMAT) {
+      VarLenRecordPageHandler varlen_page_handler;
+      rc = varlen_page_handler.init(*disk_buffer_pool_, current_page_num, true /*readonly*/);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to init varlen page handler. page num=%d, rc=%s", current_page_num, strrc(rc));
+        return rc;
+      }
+
+      if (!varlen_page_handler.is_record_page()) {
+        free_space_map_.add_overflow_pages(1);
+      } else if (varlen_page_handler.free_level() != RecordFreeSpaceMap::FULL) {
+        free_space_map_.update(current_page_num, varlen_page_handler.free_level());
+        free_page_num++;
+      }
+      continue;
+    }
+
     rc = record_page_handler.init(*disk_buffer_pool_, current_page_num, true /*readonly*/);
     if (rc != RC::SUCCESS) {
       LOG_WARN("failed to init record page handler. page num=%d, rc=%d:%s", current_page_num, rc, strrc(rc));
@@ -383,32 +495,70 @@ RC RecordFileHandler::init_free_pages()
     }
 
     if (!record_page_handler.is_full()) {
-      free_pages_.insert(current_page_num);
+      free_space_map_.update(current_page_num, record_page_handler.free_level());
+      free_page_num++;
     }
     record_page_handler.cleanup();
   }
-  LOG_INFO("record file handler init free pages done. free page num=%d, rc=%s", free_pages_.size(), strrc(rc));
+  LOG_INFO("record file handler init free pages done. free page num=%d, rc=%s", free_page_num, strrc(rc));
   return rc;
 }
 
-RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
+RC RecordFileHandler::init_zone_map()
 {
-  RC ret = RC::SUCCESS;
+  // 与 init_free_pages 一样是初始化时的动作，不需要加锁控制并发
+  RC                 rc = RC::SUCCESS;
+  BufferPoolIterator bp_iterator;
+  bp_iterator.init(*disk_buffer_pool_);
+  int page_count = 0;
+  while (bp_iterator.has_next()) {
+    const PageNum current_page_num = bp_iterator.next();
+    rc = visit_page_records(current_page_num, [this, current_page_num](const Record &record) {
+      zone_map_.update(current_page_num, record.data());
+    });
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to visit records of page. page num=%d, rc=%s", current_page_num, strrc(rc));
+      return rc;
+    }
+    page_count++;
+  }
+  LOG_INFO("record file handler rebuild zone map done. page count=%d", page_count);
+  return rc;
+}
 
-  RecordPageHandler record_page_handler;
-  bool              page_found       = false;
-  PageNum           current_page_num = 0;
+RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
+{
+  if (storage_format_ == StorageFormat::VARLEN_FORMAT) {
+    return insert_varlen_record(data, rid);
+  }
 
-  // 当前要访问free_pages对象，所以需要加锁。在非并发编译模式下，不需要考虑这个锁
-  lock_.lock();
+  RC ret = RC::SUCCESS;
 
-  // 找到没有填满的页面
-  while (!free_pages_.empty()) {
-    current_page_num = *free_pages_.begin();
+  RecordPageHandler     record_page_handler;
+  bool                  page_found       = false;
+  PageNum               current_page_num = BP_INVALID_PAGE_NUM;
+  std::atomic<PageNum> &target_page      = insert_target_page();
+
+  // 优先使用当前线程上次插入的页面，否则从空闲空间映射中找一个没有填满的页面。
+  // 空闲空间映射只是提示，拿到页面写锁后还要再检查一下，已经满了的话就修正映射再找下一个
+  while (true) {
+    const PageNum hint_page = target_page.load();
+    if (hint_page != BP_INVALID_PAGE_NUM) {
+      current_page_num = hint_page;
+    } else {
+      PageNum start_page = current_page_num;
+      if (start_page == BP_INVALID_PAGE_NUM) {
+        // 不同的线程从不同的位置开始查找，尽量分散到不同的页面上
+        start_page = static_cast<PageNum>(std::hash<std::thread::id>()(std::this_thread::get_id()) % 1024);
+      }
+      current_page_num = free_space_map_.find_free_page(start_page);
+    }
+    if (current_page_num == BP_INVALID_PAGE_NUM) {
+      break;
+    }
 
     ret = record_page_handler.init(*disk_buffer_pool_, current_page_num, false /*readonly*/);
     if (ret != RC::SUCCESS) {
-      lock_.unlock();
       LOG_WARN("failed to init record page handler. page num=%d, rc=%d:%s", current_page_num, ret, strrc(ret));
       return ret;
     }
@@ -418,9 +568,9 @@ RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
       break;
     }
     record_page_handler.cleanup();
-    free_pages_.erase(free_pages_.begin());
+    free_space_map_.update(current_page_num, RecordFreeSpaceMap::FULL);
+    target_page = BP_INVALID_PAGE_NUM;
   }
-  lock_.unlock();  // 如果找到了一个有效的页面，那么此时已经拿到了页面的写锁
 
   // 找不到就分配一个新的页面
   if (!page_found) {
@@ -442,22 +592,156 @@ RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
 
     // frame 在allocate_page的时候，是有一个pin的，在init_empty_page时又会增加一个，所以这里手动释放一个
     frame->unpin();
-
-    // 这里的加锁顺序看起来与上面是相反的，但是不会出现死锁
-    // 上面的逻辑是先加lock锁，然后加页面写锁，这里是先加上
-    // 了页面写锁，然后加lock的锁，但是不会引起死锁。
-    // 为什么？
-    lock_.lock();
-    free_pages_.insert(current_page_num);
-    lock_.unlock();
   }
 
+  target_page = current_page_num;
+
+  // 先扩大页面的范围再插入，扫描看到这条记录时区域映射一定已经包含了它
+  zone_map_.update(current_page_num, data);
+
   // 找到空闲位置
-  return record_page_handler.insert_record(data, rid);
+  ret = record_page_handler.insert_record(data, rid);
+  if (OB_SUCC(ret)) {
+    // 此时还拿着页面写锁，所以更新到映射中的空闲等级就是页面当前的状态
+    free_space_map_.update(current_page_num, record_page_handler.free_level());
+  }
+  return ret;
+}
+
+RC RecordFileHandler::insert_varlen_record(const char *data, RID *rid)
+{
+  RC ret = RC::SUCCESS;
+
+  std::vector<char> image_buffer;
+  varlen_codec_.encode(data, image_buffer);
+  const char *image     = image_buffer.data();
+  const int   image_len = static_cast<int>(image_buffer.size());
+
+  // 超长的记录，页面中放不下的部分先写到溢出页面中
+  const int inline_len          = std::min(image_len, VarLenRecordPageHandler::MAX_INLINE_SIZE);
+  PageNum   overflow_page       = BP_INVALID_PAGE_NUM;
+  int       overflow_page_count = 0;
+  if (inline_len < image_len) {
+    ret = VarLenRecordPageHandler::write_overflow_pages(
+        *disk_buffer_pool_, image + inline_len, image_len - inline_len, overflow_page, &overflow_page_count);
+    if (OB_FAIL(ret)) {
+      LOG_WARN("failed to write overflow pages. rc=%s", strrc(ret));
+      return ret;
+    }
+  }
+
+  // 变长记录大小不一，空闲空间不到一半的页面不一定放得下。这样的页面只尝试几个，
+  // 然后就只找空闲空间超过一半的页面，因为 MAX_INLINE_SIZE 的限制，这样的页面一定放得下
+  static constexpr int MAX_LOW_LEVEL_TRIES = 4;
+  static constexpr int MAX_TRIES           = 64;
+
+  VarLenRecordPageHandler page_handler;
+  bool                    page_found       = false;
+  PageNum                 current_page_num = BP_INVALID_PAGE_NUM;
+  std::atomic<PageNum>   &target_page      = insert_target_page();
+  PageNum                 start_page =
+      static_cast<PageNum>(std::hash<std::thread::id>()(std::this_thread::get_id()) % 1024);
+
+  for (int tries = 0; tries < MAX_TRIES; tries++) {
+    const PageNum hint_page = target_page.exchange(BP_INVALID_PAGE_NUM);
+    if (hint_page != BP_INVALID_PAGE_NUM) {
+      current_page_num = hint_page;
+    } else {
+      const auto min_level = tries < MAX_LOW_LEVEL_TRIES ? RecordFreeSpaceMap::LOW : RecordFreeSpaceMap::HIGH;
+      current_page_num     = free_space_map_.find_free_page(start_page, min_level);
+      if (current_page_num == BP_INVALID_PAGE_NUM) {
+        if (min_level == RecordFreeSpaceMap::HIGH) {
+          break;
+        }
+        tries = MAX_LOW_LEVEL_TRIES - 1;
+        continue;
+      }
+    }
+
+    ret = page_handler.init(*disk_buffer_pool_, current_page_num, false /*readonly*/);
+    if (OB_FAIL(ret)) {
+      LOG_WARN("failed to init varlen page handler. page num=%d, rc=%s", current_page_num, strrc(ret));
+      break;
+    }
+
+    if (page_handler.is_record_page() && page_handler.can_hold(inline_len)) {
+      page_found = true;
+      break;
+    }
+
+    // 修正空闲空间映射中过时的信息
+    free_space_map_.update(current_page_num,
+        page_handler.is_record_page() ? page_handler.free_level() : RecordFreeSpaceMap::FULL);
+    page_handler.cleanup();
+    start_page = current_page_num + 1;
+  }
+
+  // 找不到就分配一个新的页面
+  if (OB_SUCC(ret) && !page_found) {
+    Frame *frame = nullptr;
+    if ((ret = disk_buffer_pool_->allocate_page(&frame)) == RC::SUCCESS) {
+      current_page_num = frame->page_num();
+
+      ret = page_handler.init_empty_page(*disk_buffer_pool_, current_page_num);
+      // frame 在allocate_page的时候，是有一个pin的，在init_empty_page时又会增加一个，所以这里手动释放一个
+      frame->unpin();
+    }
+  }
+
+  if (OB_SUCC(ret)) {
+    zone_map_.update(current_page_num, data);
+    ret = page_handler.insert_record(image, inline_len, overflow_page, rid);
+  }
+
+  if (OB_FAIL(ret)) {
+    LOG_WARN("failed to insert varlen record. rc=%s", strrc(ret));
+    if (overflow_page != BP_INVALID_PAGE_NUM) {
+      VarLenRecordPageHandler::dispose_overflow_pages(*disk_buffer_pool_, overflow_page);
+    }
+    return ret;
+  }
+
+  free_space_map_.add_overflow_pages(overflow_page_count);
+  free_space_map_.update(current_page_num, page_handler.free_level());
+  target_page = current_page_num;
+  return ret;
 }
 
 RC RecordFileHandler::recover_insert_record(const char *data, int record_size, const RID &rid)
 {
+  if (storage_format_ == StorageFormat::VARLEN_FORMAT) {
+    // 日志中记录的就是编码后的数据
+    const int inline_len    = std::min(record_size, VarLenRecordPageHandler::MAX_INLINE_SIZE);
+    PageNum   overflow_page = BP_INVALID_PAGE_NUM;
+    if (inline_len < record_size) {
+      int overflow_page_count = 0;
+      RC  rc                  = VarLenRecordPageHandler::write_overflow_pages(
+          *disk_buffer_pool_, data + inline_len, record_size - inline_len, overflow_page, &overflow_page_count);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to write overflow pages. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+        return rc;
+      }
+      free_space_map_.add_overflow_pages(overflow_page_count);
+    }
+
+    VarLenRecordPageHandler page_handler;
+    RC                      rc = page_handler.recover_init(*disk_buffer_pool_, rid.page_num);
+    if (OB_SUCC(rc)) {
+      rc = page_handler.recover_insert_record(data, inline_len, overflow_page, rid.slot_num);
+    }
+    if (OB_SUCC(rc)) {
+      free_space_map_.update(rid.page_num, page_handler.free_level());
+    }
+    if (OB_SUCC(rc) && zone_map_.enabled()) {
+      std::vector<char> record(varlen_codec_.record_size());
+      rc = varlen_codec_.decode(data, record_size, record.data());
+      if (OB_SUCC(rc)) {
+        zone_map_.update(rid.page_num, record.data());
+      }
+    }
+    return rc;
+  }
+
   RC ret = RC::SUCCESS;
 
   RecordPageHandler record_page_handler;
@@ -468,13 +752,36 @@ RC RecordFileHandler::recover_insert_record(const char *data, int record_size, c
     return ret;
   }
 
-  return record_page_handler.recover_insert_record(data, rid);
+  ret = record_page_handler.recover_insert_record(data, rid);
+  if (OB_SUCC(ret)) {
+    free_space_map_.update(rid.page_num, record_page_handler.free_level());
+    zone_map_.update(rid.page_num, data);
+  }
+  return ret;
 }
 
 RC RecordFileHandler::update_record(const RID *rid, Record &record, Field *field, const Value *value)
 {
   RC rc = RC::SUCCESS;
 
+  if (storage_format_ == StorageFormat::VARLEN_FORMAT) {
+    VarLenRecordPageHandler page_handler;
+    if ((rc = page_handler.init(*disk_buffer_pool_, rid->page_num, false /*readonly*/)) != RC::SUCCESS) {
+      LOG_ERROR("Failed to init varlen page handler.page number=%d. rc=%s", rid->page_num, strrc(rc));
+      return rc;
+    }
+
+    write_field_value(record, field, value);
+    int overflow_page_delta = 0;
+    rc = page_handler.update_record(varlen_codec_, rid->slot_num, record.data(), &overflow_page_delta);
+    if (OB_SUCC(rc)) {
+      free_space_map_.add_overflow_pages(overflow_page_delta);
+      free_space_map_.update(rid->page_num, page_handler.free_level());
+      zone_map_.update(rid->page_num, record.data());
+    }
+    return rc;
+  }
+
   RecordPageHandler page_handler;
   if ((rc = page_handler.init(*disk_buffer_pool_, rid->page_num, false /*readonly*/)) != RC::SUCCESS) {
     LOG_ERROR("Failed to init record page handler.page number=%d. rc=%s", rid->page_num, strrc(rc));
@@ -483,6 +790,9 @@ RC RecordFileHandler::update_record(const RID *rid, Record &record, Field *field
 
   // main update memory operation func
   rc = page_handler.update_record(rid, field, value, &record);
+  if (OB_SUCC(rc)) {
+    zone_map_.update(rid->page_num, record.data());
+  }
 
   return rc;
 }
@@ -491,6 +801,28 @@ RC RecordFileHandler::delete_record(const RID *rid)
 {
   RC rc = RC::SUCCESS;
 
+  if (storage_format_ == StorageFormat::VARLEN_FORMAT) {
+    VarLenRecordPageHandler page_handler;
+    if ((rc = page_handler.init(*disk_buffer_pool_, rid->page_num, false /*readonly*/)) != RC::SUCCESS) {
+      LOG_ERROR("Failed to init varlen page handler.page number=%d. rc=%s", rid->page_num, strrc(rc));
+      return rc;
+    }
+
+    PageNum overflow_page = BP_INVALID_PAGE_NUM;
+    rc                    = page_handler.delete_record(rid->slot_num, overflow_page);
+    if (OB_SUCC(rc)) {
+      free_space_map_.update(rid->page_num, page_handler.free_level());
+    }
+    page_handler.cleanup();
+
+    if (OB_SUCC(rc) && overflow_page != BP_INVALID_PAGE_NUM) {
+      int overflow_page_count = 0;
+      rc = VarLenRecordPageHandler::dispose_overflow_pages(*disk_buffer_pool_, overflow_page, &overflow_page_count);
+      free_space_map_.add_overflow_pages(-overflow_page_count);
+    }
+    return rc;
+  }
+
   RecordPageHandler page_handler;
   if ((rc = page_handler.init(*disk_buffer_pool_, rid->page_num, false /*readonly*/)) != RC::SUCCESS) {
     LOG_ERROR("Failed to init record page handler.page number=%d. rc=%s", rid->page_num, strrc(rc));
@@ -498,18 +830,70 @@ RC RecordFileHandler::delete_record(const RID *rid)
   }
 
   rc = page_handler.delete_record(rid);
-  // 📢 这里注意要清理掉资源，否则会与insert_record中的加锁顺序冲突而可能出现死锁
-  // delete record的加锁逻辑是拿到页面锁，删除指定记录，然后加上和释放record manager锁
-  // insert record是加上 record manager锁，然后拿到指定页面锁再释放record manager锁
-  page_handler.cleanup();
   if (OB_SUCC(rc)) {
-    // 因为这里已经释放了页面锁，并发时，其它线程可能又把该页面填满了，那就不应该再放入 free_pages_
-    // 中。但是这里可以不关心，因为在查找空闲页面时，会自动过滤掉已经满的页面
-    lock_.lock();
-    free_pages_.insert(rid->page_num);
-    LOG_TRACE("add free page %d to free page list", rid->page_num);
-    lock_.unlock();
+    // 拿着页面写锁更新空闲空间映射，保证映射中的空闲等级与页面一致
+    free_space_map_.update(rid->page_num, page_handler.free_level());
+    LOG_TRACE("update free space of page %d", rid->page_num);
+  }
+  page_handler.cleanup();
+  return rc;
+}
+
+RC RecordFileHandler::delete_records(PageNum page_num, const std::vector<SlotNum> &slot_nums)
+{
+  RC rc = RC::SUCCESS;
+
+  if (storage_format_ == StorageFormat::VARLEN_FORMAT) {
+    VarLenRecordPageHandler page_handler;
+    if ((rc = page_handler.init(*disk_buffer_pool_, page_num, false /*readonly*/)) != RC::SUCCESS) {
+      LOG_ERROR("Failed to init varlen page handler.page number=%d. rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    // 溢出页在释放页面锁之后再回收
+    std::vector<PageNum> overflow_pages;
+    for (SlotNum slot_num : slot_nums) {
+      PageNum overflow_page = BP_INVALID_PAGE_NUM;
+      rc                    = page_handler.delete_record(slot_num, overflow_page);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to delete record. rid=%s, rc=%s", RID(page_num, slot_num).to_string().c_str(), strrc(rc));
+        break;
+      }
+      if (overflow_page != BP_INVALID_PAGE_NUM) {
+        overflow_pages.push_back(overflow_page);
+      }
+    }
+    free_space_map_.update(page_num, page_handler.free_level());
+    page_handler.cleanup();
+
+    for (PageNum overflow_page : overflow_pages) {
+      int overflow_page_count = 0;
+      RC  dispose_rc =
+          VarLenRecordPageHandler::dispose_overflow_pages(*disk_buffer_pool_, overflow_page, &overflow_page_count);
+      free_space_map_.add_overflow_pages(-overflow_page_count);
+      if (OB_SUCC(rc)) {
+        rc = dispose_rc;
+      }
+    }
+    return rc;
+  }
+
+  RecordPageHandler page_handler;
+  if ((rc = page_handler.init(*disk_buffer_pool_, page_num, false /*readonly*/)) != RC::SUCCESS) {
+    LOG_ERROR("Failed to init record page handler.page number=%d. rc=%s", page_num, strrc(rc));
+    return rc;
   }
+
+  for (SlotNum slot_num : slot_nums) {
+    RID rid(page_num, slot_num);
+    rc = page_handler.delete_record(&rid);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to delete record. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+      break;
+    }
+  }
+  free_space_map_.update(page_num, page_handler.free_level());
+  page_handler.cleanup();
   return rc;
 }
 
@@ -520,17 +904,58 @@ RC RecordFileHandler::get_record(RecordPageHandler &page_handler, const RID *rid
     return RC::INVALID_ARGUMENT;
   }
 
+  if (storage_format_ == StorageFormat::VARLEN_FORMAT) {
+    // 变长格式返回的是解码后的副本，不需要 page_handler 拿着页面
+    VarLenRecordPageHandler varlen_page_handler;
+    RC                      rc = varlen_page_handler.init(*disk_buffer_pool_, rid->page_num, true /*readonly*/);
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("Failed to init varlen page handler.page number=%d", rid->page_num);
+      return rc;
+    }
+    return varlen_page_handler.get_record(varlen_codec_, rid->slot_num, *rec);
+  }
+
+  RC ret = page_handler.init(*disk_buffer_pool_, rid->page_num, readonly);
+  if (OB_FAIL(ret) && ret != RC::RECORD_OPENNED) {
+    LOG_ERROR("Failed to init record page handler.page number=%d", rid->page_num);
+    return ret;
+  }
+
+  return page_handler.get_record(rid, rec);
+}
+
+RC RecordFileHandler::get_record_if_exists(RecordPageHandler &page_handler, const RID *rid, bool readonly, Record *rec)
+{
+  // 变长格式的页面在记录不存在时本来就不打印日志
+  if (nullptr == rid || nullptr == rec || storage_format_ == StorageFormat::VARLEN_FORMAT) {
+    return get_record(page_handler, rid, readonly, rec);
+  }
+
   RC ret = page_handler.init(*disk_buffer_pool_, rid->page_num, readonly);
   if (OB_FAIL(ret) && ret != RC::RECORD_OPENNED) {
     LOG_ERROR("Failed to init record page handler.page number=%d", rid->page_num);
     return ret;
   }
 
+  if (!page_handler.is_slot_used(rid->slot_num)) {
+    LOG_TRACE("record not exists. page num=%d, slot num=%d", rid->page_num, rid->slot_num);
+    return RC::RECORD_NOT_EXIST;
+  }
   return page_handler.get_record(rid, rec);
 }
 
 RC RecordFileHandler::visit_record(const RID &rid, bool readonly, std::function<void(Record &)> visitor)
 {
+  if (storage_format_ == StorageFormat::VARLEN_FORMAT) {
+    VarLenRecordPageHandler page_handler;
+    RC                      rc = page_handler.init(*disk_buffer_pool_, rid.page_num, readonly);
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("Failed to init varlen page handler.page number=%d", rid.page_num);
+      return rc;
+    }
+    return visit_varlen_record(page_handler, rid.slot_num, readonly, visitor);
+  }
+
   RecordPageHandler page_handler;
 
   RC rc = page_handler.init(*disk_buffer_pool_, rid.page_num, readonly);
@@ -550,6 +975,133 @@ RC RecordFileHandler::visit_record(const RID &rid, bool readonly, std::function<
   return rc;
 }
 
+RC RecordFileHandler::visit_records(
+    PageNum page_num, const std::vector<SlotNum> &slot_nums, bool readonly, std::function<void(Record &)> visitor)
+{
+  if (storage_format_ == StorageFormat::VARLEN_FORMAT) {
+    VarLenRecordPageHandler page_handler;
+    RC                      rc = page_handler.init(*disk_buffer_pool_, page_num, readonly);
+    if (OB_FAIL(rc)) {
+      LOG_ERROR("Failed to init varlen page handler.page number=%d", page_num);
+      return rc;
+    }
+
+    for (SlotNum slot_num : slot_nums) {
+      rc = visit_varlen_record(page_handler, slot_num, readonly, visitor);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    }
+    return rc;
+  }
+
+  RecordPageHandler page_handler;
+
+  RC rc = page_handler.init(*disk_buffer_pool_, page_num, readonly);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to init record page handler.page number=%d", page_num);
+    return rc;
+  }
+
+  Record record;
+  for (SlotNum slot_num : slot_nums) {
+    RID rid(page_num, slot_num);
+    rc = page_handler.get_record(&rid, &record);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get record from record page handle. rid=%s, rc=%s", rid.to_string().c_str(), strrc(rc));
+      return rc;
+    }
+
+    visitor(record);
+  }
+  return rc;
+}
+
+RC RecordFileHandler::visit_page_records(PageNum page_num, std::function<void(const Record &)> visitor)
+{
+  if (storage_format_ == StorageFormat::VARLEN_FORMAT) {
+    VarLenRecordPageHandler page_handler;
+    RC                      rc = page_handler.init(*disk_buffer_pool_, page_num, true /*readonly*/);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to init varlen page handler. page_num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+    if (!page_handler.is_record_page()) {
+      return rc;
+    }
+
+    Record record;
+    for (SlotNum slot_num = page_handler.next_record(0); slot_num != -1;
+         slot_num         = page_handler.next_record(slot_num + 1)) {
+      rc = page_handler.get_record(varlen_codec_, slot_num, record);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to get varlen record. page_num=%d, slot_num=%d, rc=%s", page_num, slot_num, strrc(rc));
+        return rc;
+      }
+      visitor(record);
+    }
+    return rc;
+  }
+
+  RecordPageHandler page_handler;
+  RC                rc = page_handler.init(*disk_buffer_pool_, page_num, true /*readonly*/);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init record page handler. page_num=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+  if (!page_handler.is_record_page()) {
+    return rc;
+  }
+
+  RecordPageIterator iterator;
+  iterator.init(page_handler);
+  Record record;
+  while (iterator.has_next()) {
+    rc = iterator.next(record);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get next record from page. page_num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+    visitor(record);
+  }
+  return rc;
+}
+
+RC RecordFileHandler::visit_varlen_record(
+    VarLenRecordPageHandler &page_handler, SlotNum slot_num, bool readonly, std::function<void(Record &)> &visitor)
+{
+  Record record;
+  RC     rc = page_handler.get_record(varlen_codec_, slot_num, record);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to get varlen record. page num=%d, slot num=%d, rc=%s",
+             page_handler.get_page_num(), slot_num, strrc(rc));
+    return rc;
+  }
+
+  if (readonly) {
+    visitor(record);
+    return rc;
+  }
+
+  // visitor 修改的是解码后的副本，有变化时再编码写回页面
+  std::vector<char> origin(record.data(), record.data() + record.len());
+  visitor(record);
+  if (memcmp(origin.data(), record.data(), record.len()) == 0) {
+    return rc;
+  }
+
+  int overflow_page_delta = 0;
+  rc                      = page_handler.update_record(varlen_codec_, slot_num, record.data(), &overflow_page_delta);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to write back varlen record. page num=%d, slot num=%d, rc=%s",
+             page_handler.get_page_num(), slot_num, strrc(rc));
+    return rc;
+  }
+  free_space_map_.add_overflow_pages(overflow_page_delta);
+  free_space_map_.update(page_handler.get_page_num(), page_handler.free_level());
+  return rc;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 RecordFileScanner::~RecordFileScanner() { close_scan(); }
@@ -564,12 +1116,20 @@ RC RecordFileScanner::open_scan(
   trx_              = trx;
   readonly_         = readonly;
 
+  storage_format_ = StorageFormat::ROW_FORMAT;
+  varlen_codec_   = nullptr;
+  if (table != nullptr && table->record_handler()->storage_format() == StorageFormat::VARLEN_FORMAT) {
+    storage_format_ = StorageFormat::VARLEN_FORMAT;
+    varlen_codec_   = &table->record_handler()->varlen_codec();
+  }
+
   RC rc = bp_iterator_.init(buffer_pool);
   if (rc != RC::SUCCESS) {
     LOG_WARN("failed to init bp iterator. rc=%d:%s", rc, strrc(rc));
     return rc;
   }
   condition_filter_ = condition_filter;
+  skipped_pages_    = 0;
 
   rc = fetch_next_record();
   if (rc == RC::RECORD_EOF) {
@@ -587,7 +1147,7 @@ RC RecordFileScanner::open_scan(
 RC RecordFileScanner::fetch_next_record()
 {
   RC rc = RC::SUCCESS;
-  if (record_page_iterator_.is_valid()) {
+  if (record_page_iterator_.is_valid() || varlen_record_index_ < varlen_records_.size()) {
     // 当前页面还是有效的，尝试看一下是否有有效记录
     rc = fetch_next_record_in_page();
     if (rc == RC::SUCCESS || rc != RC::RECORD_EOF) {
@@ -601,14 +1161,32 @@ RC RecordFileScanner::fetch_next_record()
   // 上个页面遍历完了，或者还没有开始遍历某个页面，那么就从一个新的页面开始遍历查找
   while (bp_iterator_.has_next()) {
     PageNum page_num = bp_iterator_.next();
-    record_page_handler_.cleanup();
-    rc = record_page_handler_.init(*disk_buffer_pool_, page_num, readonly_);
-    if (OB_FAIL(rc)) {
-      LOG_WARN("failed to init record page handler. page_num=%d, rc=%s", page_num, strrc(rc));
-      return rc;
+    if (!zone_map_conditions_.empty() && table_ != nullptr &&
+        !table_->record_handler()->zone_map().may_match(page_num, zone_map_conditions_)) {
+      skipped_pages_++;
+      continue;
+    }
+
+    if (storage_format_ == StorageFormat::VARLEN_FORMAT) {
+      rc = load_varlen_page(page_num);
+      if (OB_FAIL(rc)) {
+        return rc;
+      }
+    } else {
+      record_page_handler_.cleanup();
+      rc = record_page_handler_.init(*disk_buffer_pool_, page_num, readonly_);
+      if (OB_FAIL(rc)) {
+        LOG_WARN("failed to init record page handler. page_num=%d, rc=%s", page_num, strrc(rc));
+        return rc;
+      }
+
+      if (!record_page_handler_.is_record_page()) {
+        continue;
+      }
+
+      record_page_iterator_.init(record_page_handler_);
     }
 
-    record_page_iterator_.init(record_page_handler_);
     rc = fetch_next_record_in_page();
     if (rc == RC::SUCCESS || rc != RC::RECORD_EOF) {
       // 有有效记录：RC::SUCCESS
@@ -630,16 +1208,28 @@ RC RecordFileScanner::fetch_next_record()
 RC RecordFileScanner::fetch_next_record_in_page()
 {
   RC rc = RC::SUCCESS;
-  while (record_page_iterator_.has_next()) {
-    rc = record_page_iterator_.next(next_record_);
-    if (rc != RC::SUCCESS) {
-      const auto page_num = record_page_handler_.get_page_num();
-      LOG_TRACE("failed to get next record from page. page_num=%d, rc=%s", page_num, strrc(rc));
-      return rc;
+  while (true) {
+    if (storage_format_ == StorageFormat::VARLEN_FORMAT) {
+      if (varlen_record_index_ >= varlen_records_.size()) {
+        break;
+      }
+      next_record_ = varlen_records_[varlen_record_index_++];
+    } else {
+      if (!record_page_iterator_.has_next()) {
+        break;
+      }
+      rc = record_page_iterator_.next(next_record_);
+      if (rc != RC::SUCCESS) {
+        const auto page_num = record_page_handler_.get_page_num();
+        LOG_TRACE("failed to get next record from page. page_num=%d, rc=%s", page_num, strrc(rc));
+        return rc;
+      }
     }
 
-    // 如果有过滤条件，就用过滤条件过滤一下
-    if (condition_filter_ != nullptr && !condition_filter_->filter(next_record_)) {
+    // 行格式下记录直接指向固定在内存中的页面，在拷贝记录和判断可见性之前先过滤。
+    // 变长格式的记录在 load_varlen_page 中已经过滤过了
+    if (storage_format_ == StorageFormat::ROW_FORMAT && condition_filter_ != nullptr &&
+        !condition_filter_->filter(next_record_)) {
       continue;
     }
 
@@ -662,6 +1252,40 @@ RC RecordFileScanner::fetch_next_record_in_page()
   return RC::RECORD_EOF;
 }
 
+RC RecordFileScanner::load_varlen_page(PageNum page_num)
+{
+  varlen_records_.clear();
+  varlen_record_index_ = 0;
+
+  VarLenRecordPageHandler page_handler;
+  RC                      rc = page_handler.init(*disk_buffer_pool_, page_num, true /*readonly*/);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init varlen page handler. page_num=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+
+  // 溢出页面和空闲空间映射页面没有记录
+  if (!page_handler.is_record_page()) {
+    return rc;
+  }
+
+  for (SlotNum slot_num = page_handler.next_record(0); slot_num != -1;
+       slot_num         = page_handler.next_record(slot_num + 1)) {
+    varlen_records_.emplace_back();
+    rc = page_handler.get_record(*varlen_codec_, slot_num, varlen_records_.back());
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get varlen record. page_num=%d, slot_num=%d, rc=%s", page_num, slot_num, strrc(rc));
+      return rc;
+    }
+
+    // 解码之后马上过滤，不满足条件的记录不保留
+    if (condition_filter_ != nullptr && !condition_filter_->filter(varlen_records_.back())) {
+      varlen_records_.pop_back();
+    }
+  }
+  return rc;
+}
+
 RC RecordFileScanner::close_scan()
 {
   if (disk_buffer_pool_ != nullptr) {
@@ -673,6 +1297,8 @@ RC RecordFileScanner::close_scan()
   }
 
   record_page_handler_.cleanup();
+  varlen_records_.clear();
+  varlen_record_index_ = 0;
 
   return RC::SUCCESS;
 }
@@ -17,8 +17,13 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/bitmap.h"
 #include "storage/buffer/disk_buffer_pool.h"
 #include "storage/record/record.h"
+#include "storage/record/record_free_space_map.h"
+#include "storage/record/record_zone_map.h"
+#include "storage/record/varlen_record_manager.h"
 #include "storage/trx/latch_memo.h"
 #include "storage/field/field.h"
+#include <array>
+#include <atomic>
 #include <limits>
 #include <sstream>
 
@@ -26,6 +31,7 @@ class ConditionFilter;
 class RecordPageHandler;
 class Trx;
 class Table;
+class TableMeta;
 class Field;
 
 /**
@@ -35,17 +41,17 @@ class Field;
  * @details 表记录管理的内容包括如何在文件上存放、读取、检索。也就是记录的增删改查。
  * 这里的文件都会被拆分成页面，每个页面都有一样的大小。更详细的信息可以参考BufferPool。
  * 按照BufferPool的设计，第一个页面用来存放BufferPool本身的元数据，比如当前文件有多少页面、已经分配了多少页面、
- * 每个页面的分配状态等。所以第一个页面对RecordManager来说没有作用。RecordManager 本身没有再单独拿一个页面
- * 来存放元数据，每一个页面都存放了一个页面头信息，也就是每个页面都有 RecordManager 的元数据信息，可以参考
- * PageHeader，这虽然有点浪费但是做起来简单。
+ * 每个页面的分配状态等。所以第一个页面对RecordManager来说没有作用。紧接着的几个页面存放空闲空间映射(FSM)，
+ * 记录每个页面还有多少空闲空间，参考 RecordFreeSpaceMap。每个页面上数值字段的范围记录在数据文件旁边的
+ * 区域映射文件中，扫描时用来跳过页面，参考 RecordZoneMap。其它每一个页面都存放了一个页面头信息，也就是每个页面
+ * 都有 RecordManager 的元数据信息，可以参考PageHeader，这虽然有点浪费但是做起来简单。
  *
  * 对单个页面来说，最开始是一个页头，然后接着就是一行行记录（会对齐）。
  * 如何标识一个记录，或者定位一个记录？
  * 使用RID，即record identifier。使用 page num 表示所在的页面，slot num 表示当前在页面中的位置。因为这里的
  * 记录都是定长的，所以根据slot num 可以直接计算出记录的起始位置。
- * 问题1：那么如果记录不是定长的，还能使用 slot num 吗？
- * 问题2：如何更有效地存放不定长数据呢？
- * 问题3：如果一个页面不能存放一个记录，那么怎么组织记录存放效果更好呢？
+ * 建表时也可以选择变长格式(StorageFormat::VARLEN_FORMAT)，这时页面使用槽位目录组织，CHARS 字段只存放实际长度，
+ * 超长的记录使用溢出页面存放，可以参考 VarLenRecordPageHandler。
  *
  * 按照上面的描述，这里提供了几个类，分别是：
  * - RecordFileHandler：管理整个文件/表的记录增删改查
@@ -199,6 +205,13 @@ public:
    */
   RC get_record(const RID *rid, Record *rec);
 
+  /**
+   * @brief 指定的槽位上是否有记录
+   * @details 槽位为空时不打印日志，通过索引访问已经删除的记录是正常的。槽位超出页面容量说明数据已经损坏，
+   * 依然打印错误日志并返回 false
+   */
+  bool is_slot_used(SlotNum slot_num) const;
+
   /**
    * @brief 返回该记录页的页号
    */
@@ -209,6 +222,16 @@ public:
    */
   bool is_full() const;
 
+  /**
+   * @brief 当前页面的空闲等级，用来更新空闲空间映射
+   */
+  RecordFreeSpaceMap::FreeSpaceLevel free_level() const;
+
+  /**
+   * @brief 当前页面是否是记录页面。数据文件中还有空闲空间映射页面，遍历时需要跳过
+   */
+  bool is_record_page() const;
+
 protected:
   /**
    * @details
@@ -261,9 +284,11 @@ public:
   /**
    * @brief 初始化
    *
-   * @param buffer_pool 当前操作的是哪个文件
+   * @param buffer_pool   当前操作的是哪个文件
+   * @param table_meta    表的元数据，用来确定记录的存放格式。为空时使用定长格式
+   * @param zone_map_file 区域映射保存的文件，为空时不维护区域映射
    */
-  RC init(DiskBufferPool *buffer_pool);
+  RC init(DiskBufferPool *buffer_pool, const TableMeta *table_meta = nullptr, const char *zone_map_file = nullptr);
 
   /**
    * @brief 关闭，做一些资源清理的工作
@@ -277,6 +302,14 @@ public:
    */
   RC delete_record(const RID *rid);
 
+  /**
+   * @brief 删除同一个页面上的多条记录
+   * @details 页面只会获取(pin)和加锁一次，适用于事务回滚时撤销大量插入的场景
+   * @param page_num  记录所在的页面
+   * @param slot_nums 要删除的记录槽位
+   */
+  RC delete_records(PageNum page_num, const std::vector<SlotNum> &slot_nums);
+
   RC update_record(const RID *rid,Record &record, Field *field, const Value *value);
 
   /**
@@ -309,6 +342,12 @@ public:
    */
   RC get_record(RecordPageHandler &page_handler, const RID *rid, bool readonly, Record *rec);
 
+  /**
+   * @brief 与get_record相同，但是记录已经删除时直接返回 RECORD_NOT_EXIST，不打印错误日志
+   * @details 删除记录时不会删除索引项，索引扫描拿到的记录可能已经删除了
+   */
+  RC get_record_if_exists(RecordPageHandler &page_handler, const RID *rid, bool readonly, Record *rec);
+
   /**
    * @brief 与get_record类似，访问某个记录，并提供回调函数来操作相应的记录
    *
@@ -318,16 +357,86 @@ public:
    */
   RC visit_record(const RID &rid, bool readonly, std::function<void(Record &)> visitor);
 
+  /**
+   * @brief 批量访问同一个页面上的多条记录
+   * @details 页面只会获取(pin)和加锁一次，然后按照 slot_nums 的顺序依次对每条记录调用visitor。
+   * 适用于事务提交、回滚这种一次修改大量记录，而记录又集中在少量页面上的场景。
+   * @param page_num  记录所在的页面
+   * @param slot_nums 要访问的记录槽位
+   * @param readonly  是否会修改记录
+   * @param visitor   访问记录的回调函数
+   */
+  RC visit_records(PageNum page_num, const std::vector<SlotNum> &slot_nums, bool readonly,
+      std::function<void(Record &)> visitor);
+
+  /**
+   * @brief 只读地访问一个页面上的所有记录
+   * @details 页面不是记录页面(比如空闲空间映射页面、变长格式的溢出页面)时什么都不做。ANALYZE 按页面采样时使用
+   * @param page_num 要访问的页面
+   * @param visitor  访问记录的回调函数
+   */
+  RC visit_page_records(PageNum page_num, std::function<void(const Record &)> visitor);
+
+  /**
+   * @brief 提示即将访问这些页面上的记录，参考 DiskBufferPool::prefetch_pages
+   */
+  void prefetch_pages(std::vector<PageNum> page_nums) { disk_buffer_pool_->prefetch_pages(std::move(page_nums)); }
+
+  /**
+   * @brief 存放记录的页面个数，不包括文件头、空闲空间映射页面和变长格式的溢出页面
+   */
+  int32_t data_page_count() const;
+
+  /**
+   * @brief 页面是否是空闲空间映射页面
+   */
+  bool is_map_page(PageNum page_num) const { return free_space_map_.is_map_page_num(page_num); }
+
+  StorageFormat            storage_format() const { return storage_format_; }
+  const VarLenRecordCodec &varlen_codec() const { return varlen_codec_; }
+  const RecordZoneMap     &zone_map() const { return zone_map_; }
+
 private:
   /**
-   * @brief 初始化当前没有填满记录的页面，初始化free_pages_成员
+   * @brief 变长格式下编码并插入一条记录
+   */
+  RC insert_varlen_record(const char *data, RID *rid);
+
+  /**
+   * @brief 变长格式下访问记录。非只读访问时，如果visitor修改了记录，会编码后写回页面
+   */
+  RC visit_varlen_record(
+      VarLenRecordPageHandler &page_handler, SlotNum slot_num, bool readonly, std::function<void(Record &)> &visitor);
+
+  /**
+   * @brief 老版本的数据文件没有空闲空间映射页面，只能遍历所有页面初始化 free_space_map_
    */
   RC init_free_pages();
 
+  /**
+   * @brief 没有找到区域映射文件(新建的表或者进程崩溃)时，遍历所有记录重建区域映射
+   */
+  RC init_zone_map();
+
+  /**
+   * @brief 当前线程在这个文件上插入记录的目标页面
+   * @details 每个线程优先往自己上次插入的页面中插入，这样并发插入时不会都争抢同一个页面，
+   * 查找页面时也不需要加全局的锁。线程按照线程ID散列到固定个数的槽位上，散列到同一个槽位的线程共用一个目标页面，
+   * 目标页面只是提示，拿到页面锁之后还会检查空间
+   */
+  std::atomic<PageNum> &insert_target_page();
+
+  /// 缓存插入目标页面的槽位个数，参考 insert_target_page
+  static constexpr int INSERT_TARGET_SLOTS = 16;
+
 private:
-  DiskBufferPool             *disk_buffer_pool_ = nullptr;
-  std::unordered_set<PageNum> free_pages_;  ///< 没有填充满的页面集合
-  common::Mutex               lock_;  ///< 当编译时增加-DCONCURRENCY=ON 选项时，才会真正的支持并发
+  DiskBufferPool    *disk_buffer_pool_ = nullptr;
+  RecordFreeSpaceMap free_space_map_;                              ///< 每个页面的空闲空间，持久化在数据文件中
+  RecordZoneMap      zone_map_;                                    ///< 每个页面上数值字段的范围
+  StorageFormat      storage_format_ = StorageFormat::ROW_FORMAT;  ///< 记录的存放格式
+  VarLenRecordCodec  varlen_codec_;                                ///< 变长格式下记录的编解码
+
+  std::array<std::atomic<PageNum>, INSERT_TARGET_SLOTS> insert_target_pages_;  ///< 参考 insert_target_page
 };
 
 /**
@@ -343,7 +452,8 @@ public:
 
   /**
    * @brief 打开一个文件扫描。
-   * @details 如果条件不为空，则要对每条记录进行条件比较，只有满足所有条件的记录才被返回
+   * @details 如果条件不为空，则要对每条记录进行条件比较，只有满足所有条件的记录才被返回。
+   * 行格式下直接在页面上的记录数据上判断条件，不满足条件的记录不会拷贝出来，也不需要判断事务可见性
    * @param table            遍历的哪张表
    * @param buffer_pool      访问的文件
    * @param readonly         当前是否只读操作。访问数据时，需要对页面加锁。比如
@@ -372,6 +482,20 @@ public:
    */
   RC next(Record &record);
 
+  /**
+   * @brief 设置区域映射的过滤条件，在 open_scan 之前调用
+   * @details 页面上的范围不可能满足这些条件时，整个页面都会跳过。条件会一直保留，重新打开扫描时依然有效
+   */
+  void set_zone_map_conditions(std::vector<ZoneMapCondition> conditions)
+  {
+    zone_map_conditions_ = std::move(conditions);
+  }
+
+  /**
+   * @brief 最近一次扫描因为区域映射跳过了多少页面
+   */
+  int skipped_pages() const { return skipped_pages_; }
+
 private:
   /**
    * @brief 获取该文件中的下一条记录
@@ -383,6 +507,13 @@ private:
    */
   RC fetch_next_record_in_page();
 
+  /**
+   * @brief 变长格式下，进入一个页面时把页面上所有的记录解码出来，然后就释放页面
+   * @details 解码后的记录是副本，修改记录需要通过 RecordFileHandler 写回页面。
+   * 遍历过程中不持有页面锁，所以上层修改记录时也不会与遍历冲突
+   */
+  RC load_varlen_page(PageNum page_num);
+
 private:
   // TODO 对于一个纯粹的record遍历器来说，不应该关心表和事务
   Table *table_ = nullptr;  ///< 当前遍历的是哪张表。这个字段仅供事务函数使用，如果设计合适，可以去掉
@@ -396,4 +527,12 @@ private:
   RecordPageHandler  record_page_handler_;         ///< 处理文件某页面的记录
   RecordPageIterator record_page_iterator_;        ///< 遍历某个页面上的所有record
   Record             next_record_;                 ///< 获取的记录放在这里缓存起来
+
+  StorageFormat            storage_format_ = StorageFormat::ROW_FORMAT;
+  const VarLenRecordCodec *varlen_codec_   = nullptr;
+  std::vector<Record>      varlen_records_;          ///< 变长格式下当前页面解码出来的记录
+  size_t                   varlen_record_index_ = 0;  ///< 下一个要访问的 varlen_records_ 下标
+
+  std::vector<ZoneMapCondition> zone_map_conditions_;
+  int                           skipped_pages_ = 0;
 };
\ No newline at end of file
@@ -0,0 +1,255 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common/io/io.h"
+#include "common/log/log.h"
+#include "storage/field/field_meta.h"
+#include "storage/record/record_zone_map.h"
+
+using namespace std;
+using namespace common;
+
+namespace {
+
+/**
+ * @brief 区域映射文件的文件头，后面紧跟着 valid 数组和 bounds 数组
+ */
+struct ZoneMapFileHeader
+{
+  int32_t magic;
+  int32_t column_num;
+  int32_t page_count;
+  int32_t clean;  ///< 表正常关闭时写入为1，打开之后立即改成0
+};
+
+bool less_than(AttrType attr_type, const char *a, const char *b)
+{
+  if (attr_type == FLOATS) {
+    float fa, fb;
+    memcpy(&fa, a, sizeof(fa));
+    memcpy(&fb, b, sizeof(fb));
+    return fa < fb;
+  }
+
+  // INTS 和 DATES 都是4字节的整数
+  int32_t ia, ib;
+  memcpy(&ia, a, sizeof(ia));
+  memcpy(&ib, b, sizeof(ib));
+  return ia < ib;
+}
+
+}  // namespace
+
+RC RecordZoneMap::open(const char *file_name, const vector<const FieldMeta *> &field_metas, bool &found)
+{
+  found      = false;
+  file_name_ = file_name;
+  columns_.clear();
+  valid_.clear();
+  bounds_.clear();
+
+  for (const FieldMeta *field_meta : field_metas) {
+    const AttrType attr_type = field_meta->type();
+    if ((attr_type == INTS || attr_type == FLOATS || attr_type == DATES) && field_meta->len() == 4) {
+      columns_.push_back(Column{field_meta->offset(), attr_type});
+    }
+  }
+  if (columns_.empty()) {
+    return RC::SUCCESS;
+  }
+
+  int fd = ::open(file_name, O_RDWR);
+  if (fd < 0) {
+    if (errno != ENOENT) {
+      LOG_WARN("failed to open zone map file, rebuild it. file=%s, error=%s", file_name, strerror(errno));
+    }
+    return RC::SUCCESS;
+  }
+
+  ZoneMapFileHeader header;
+  int               ret = readn(fd, &header, sizeof(header));
+  if (ret == 0 && header.magic == MAGIC && header.column_num == static_cast<int32_t>(columns_.size()) &&
+      header.page_count >= 0 && header.clean == 1) {
+    valid_.resize(header.page_count);
+    bounds_.resize(static_cast<size_t>(header.page_count) * columns_.size());
+    ret = readn(fd, valid_.data(), static_cast<int>(valid_.size()));
+    if (ret == 0) {
+      ret = readn(fd, bounds_.data(), static_cast<int>(bounds_.size() * sizeof(Bound)));
+    }
+  } else {
+    ret = -1;
+  }
+
+  // 加载之后把文件标记为无效，进程崩溃时不会用到过时的映射，正常关闭时再整个重写。
+  // 标记失败时只能删除文件
+  if (ret == 0) {
+    header.clean = 0;
+    if (::pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) || ::fdatasync(fd) != 0) {
+      LOG_WARN("failed to mark zone map file dirty, rebuild it. file=%s, error=%s", file_name, strerror(errno));
+      ::unlink(file_name);
+      ret = -1;
+    }
+  }
+  ::close(fd);
+
+  if (ret != 0) {
+    LOG_WARN("invalid zone map file, rebuild it. file=%s", file_name);
+    valid_.clear();
+    bounds_.clear();
+    return RC::SUCCESS;
+  }
+
+  found = true;
+  LOG_INFO("load zone map done. file=%s, columns=%d, pages=%d", file_name, header.column_num, header.page_count);
+  return RC::SUCCESS;
+}
+
+RC RecordZoneMap::close()
+{
+  if (columns_.empty()) {
+    return RC::SUCCESS;
+  }
+
+  lock_.lock();
+  ZoneMapFileHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic      = MAGIC;
+  header.column_num = static_cast<int32_t>(columns_.size());
+  header.page_count = static_cast<int32_t>(valid_.size());
+  header.clean      = 1;
+
+  // 先写临时文件再改名，映射文件任何时候都是完整的
+  const string tmp_file = file_name_ + ".tmp";
+  int          fd       = ::open(tmp_file.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0600);
+  int          ret      = fd < 0 ? errno : 0;
+  if (ret == 0) {
+    ret = writen(fd, &header, sizeof(header));
+  }
+  if (ret == 0) {
+    ret = writen(fd, valid_.data(), static_cast<int>(valid_.size()));
+  }
+  if (ret == 0) {
+    ret = writen(fd, bounds_.data(), static_cast<int>(bounds_.size() * sizeof(Bound)));
+  }
+  if (fd >= 0) {
+    ::close(fd);
+  }
+  if (ret == 0 && ::rename(tmp_file.c_str(), file_name_.c_str()) != 0) {
+    ret = errno;
+  }
+
+  columns_.clear();
+  valid_.clear();
+  bounds_.clear();
+  lock_.unlock();
+
+  if (ret != 0) {
+    // 下次打开时重建
+    LOG_WARN("failed to write zone map file. file=%s, error=%s", file_name_.c_str(), strerror(ret));
+    ::unlink(tmp_file.c_str());
+    return RC::IOERR_WRITE;
+  }
+  return RC::SUCCESS;
+}
+
+int RecordZoneMap::find_column(int field_offset) const
+{
+  for (size_t i = 0; i < columns_.size(); i++) {
+    if (columns_[i].offset == field_offset) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+void RecordZoneMap::widen(PageNum page_num, int column, const char *data)
+{
+  Bound         *page_bound = bound(page_num, column);
+  const AttrType attr_type  = columns_[column].attr_type;
+  if (!valid_[page_num]) {
+    memcpy(page_bound->min, data, sizeof(page_bound->min));
+    memcpy(page_bound->max, data, sizeof(page_bound->max));
+    return;
+  }
+  if (less_than(attr_type, data, page_bound->min)) {
+    memcpy(page_bound->min, data, sizeof(page_bound->min));
+  }
+  if (less_than(attr_type, page_bound->max, data)) {
+    memcpy(page_bound->max, data, sizeof(page_bound->max));
+  }
+}
+
+void RecordZoneMap::update(PageNum page_num, const char *record)
+{
+  if (columns_.empty() || page_num < 0) {
+    return;
+  }
+
+  lock_.lock();
+  if (page_num >= static_cast<PageNum>(valid_.size())) {
+    valid_.resize(page_num + 1, 0);
+    bounds_.resize(valid_.size() * columns_.size());
+  }
+
+  for (size_t i = 0; i < columns_.size(); i++) {
+    widen(page_num, static_cast<int>(i), record + columns_[i].offset);
+  }
+  valid_[page_num] = 1;
+  lock_.unlock();
+}
+
+bool RecordZoneMap::column_may_match(PageNum page_num, int column, const ZoneMapCondition &condition) const
+{
+  // 数值类型之间可以直接比较，其它类型的常量不使用区域映射
+  const AttrType attr_type  = columns_[column].attr_type;
+  const AttrType value_type = condition.value.attr_type();
+  const bool     is_number  = (attr_type == INTS || attr_type == FLOATS) && (value_type == INTS || value_type == FLOATS);
+  if (value_type != attr_type && !is_number) {
+    return true;
+  }
+
+  const Bound *page_bound = bound(page_num, column);
+  const Value  min_value(attr_type, const_cast<char *>(page_bound->min), sizeof(page_bound->min));
+  const Value  max_value(attr_type, const_cast<char *>(page_bound->max), sizeof(page_bound->max));
+  const Value &value = condition.value;
+  switch (condition.comp) {
+    case EQUAL_TO: return min_value.compare(value) <= 0 && max_value.compare(value) >= 0;
+    case LESS_THAN: return min_value.compare(value) < 0;
+    case LESS_EQUAL: return min_value.compare(value) <= 0;
+    case GREAT_THAN: return max_value.compare(value) > 0;
+    case GREAT_EQUAL: return max_value.compare(value) >= 0;
+    case NOT_EQUAL: return min_value.compare(value) != 0 || max_value.compare(value) != 0;
+    default: return true;
+  }
+}
+
+bool RecordZoneMap::may_match(PageNum page_num, const vector<ZoneMapCondition> &conditions) const
+{
+  if (columns_.empty()) {
+    return true;
+  }
+
+  lock_.lock();
+  bool result = page_num >= 0 && page_num < static_cast<PageNum>(valid_.size()) && valid_[page_num];
+  for (size_t i = 0; result && i < conditions.size(); i++) {
+    const int column = find_column(conditions[i].field_offset);
+    if (column >= 0) {
+      result = column_may_match(page_num, column, conditions[i]);
+    }
+  }
+  lock_.unlock();
+  return result;
+}
@@ -0,0 +1,114 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/lang/mutex.h"
+#include "common/rc.h"
+#include "common/types.h"
+#include "sql/parser/value.h"
+
+class FieldMeta;
+
+/**
+ * @brief 可以用区域映射判断的条件：字段 comp 常量
+ * @ingroup RecordManager
+ */
+struct ZoneMapCondition
+{
+  int    field_offset = -1;  ///< 字段在记录中的偏移量，用来找到对应的列
+  CompOp comp         = NO_OP;
+  Value  value;
+};
+
+/**
+ * @brief 记录文件的区域映射(Zone Map)
+ * @ingroup RecordManager
+ * @details 为每个数据页面记录某些字段的最小值和最大值，扫描时跳过不可能有匹配记录的页面。
+ * 按插入时间聚集的表(比如时序数据)上，时间字段的范围查询只需要读取少量页面。
+ *
+ * 只维护定长的数值字段(INTS/FLOATS/DATES)。插入和更新记录时扩大页面的范围，删除记录时不缩小，
+ * 所以映射中的范围总是包含页面上所有的记录，只是可能比实际的范围大。从来没有插入过记录的页面
+ * (包括空闲空间映射页面和溢出页面)没有范围，扫描时直接跳过。
+ *
+ * 映射保存在数据文件旁边单独的文件中，只在表正常关闭时写入，文件头中标记为有效。打开时加载之后
+ * 立即把文件标记为无效，进程崩溃之后文件依然是无效的，由 RecordFileHandler 遍历所有记录重建，因此不需要记录日志。
+ */
+class RecordZoneMap
+{
+public:
+  static constexpr int32_t MAGIC = 0x5a4d4150;  // "ZMAP"
+
+public:
+  RecordZoneMap()  = default;
+  ~RecordZoneMap() = default;
+
+  /**
+   * @brief 打开区域映射
+   *
+   * @param file_name   映射保存的文件
+   * @param field_metas 表的用户字段，从中挑选需要维护的字段
+   * @param found       返回是否从文件中加载成功。不成功时，调用者需要遍历所有的记录调用 update 重建
+   */
+  RC open(const char *file_name, const std::vector<const FieldMeta *> &field_metas, bool &found);
+
+  /**
+   * @brief 把映射写到文件中
+   */
+  RC close();
+
+  /**
+   * @brief 是否有需要维护的字段
+   */
+  bool enabled() const { return !columns_.empty(); }
+
+  /**
+   * @brief 插入或更新记录之后，用页面上记录的值扩大页面的范围
+   */
+  void update(PageNum page_num, const char *record);
+
+  /**
+   * @brief 页面上是否可能有同时满足所有条件的记录
+   */
+  bool may_match(PageNum page_num, const std::vector<ZoneMapCondition> &conditions) const;
+
+private:
+  struct Column
+  {
+    int      offset;
+    AttrType attr_type;
+  };
+
+  /**
+   * @brief 每个页面上每一列的范围，都是4字节的值
+   */
+  struct Bound
+  {
+    char min[4];
+    char max[4];
+  };
+
+  int  find_column(int field_offset) const;
+  void widen(PageNum page_num, int column, const char *data);
+  bool column_may_match(PageNum page_num, int column, const ZoneMapCondition &condition) const;
+
+  Bound       *bound(PageNum page_num, int column) { return &bounds_[page_num * columns_.size() + column]; }
+  const Bound *bound(PageNum page_num, int column) const { return &bounds_[page_num * columns_.size() + column]; }
+
+private:
+  std::string           file_name_;
+  std::vector<Column>   columns_;
+  std::vector<uint8_t>  valid_;   ///< 页面是否有范围，下标就是页号
+  std::vector<Bound>    bounds_;  ///< 页号 * 列数 + 列号
+  mutable common::Mutex lock_;
+};
@@ -0,0 +1,90 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+
+#include "storage/record/rid_bitmap.h"
+
+void RidBitmap::add(const RID &rid)
+{
+  std::vector<uint64_t> &words = pages_[rid.page_num];
+  const size_t           word  = static_cast<size_t>(rid.slot_num) / 64;
+  if (words.size() <= word) {
+    words.resize(word + 1, 0);
+  }
+  words[word] |= 1ULL << (rid.slot_num % 64);
+}
+
+void RidBitmap::intersect_with(const RidBitmap &other)
+{
+  auto iter       = pages_.begin();
+  auto other_iter = other.pages_.begin();
+  while (iter != pages_.end()) {
+    while (other_iter != other.pages_.end() && other_iter->first < iter->first) {
+      ++other_iter;
+    }
+    if (other_iter == other.pages_.end() || other_iter->first != iter->first) {
+      iter = pages_.erase(iter);
+      continue;
+    }
+
+    std::vector<uint64_t>       &words       = iter->second;
+    const std::vector<uint64_t> &other_words = other_iter->second;
+    words.resize(std::min(words.size(), other_words.size()));
+
+    bool any = false;
+    for (size_t i = 0; i < words.size(); i++) {
+      words[i] &= other_words[i];
+      any = any || words[i] != 0;
+    }
+    if (any) {
+      ++iter;
+    } else {
+      iter = pages_.erase(iter);
+    }
+  }
+}
+
+void RidBitmap::union_with(const RidBitmap &other)
+{
+  for (const auto &[page_num, other_words] : other.pages_) {
+    std::vector<uint64_t> &words = pages_[page_num];
+    if (words.size() < other_words.size()) {
+      words.resize(other_words.size(), 0);
+    }
+    for (size_t i = 0; i < other_words.size(); i++) {
+      words[i] |= other_words[i];
+    }
+  }
+}
+
+size_t RidBitmap::size() const
+{
+  size_t count = 0;
+  for (const auto &[page_num, words] : pages_) {
+    for (uint64_t word : words) {
+      count += __builtin_popcountll(word);
+    }
+  }
+  return count;
+}
+
+void RidBitmap::collect_slots(const std::vector<uint64_t> &words, std::vector<SlotNum> &slot_nums)
+{
+  slot_nums.clear();
+  for (size_t i = 0; i < words.size(); i++) {
+    uint64_t word = words[i];
+    while (word != 0) {
+      const int bit = __builtin_ctzll(word);
+      slot_nums.push_back(static_cast<SlotNum>(i * 64 + bit));
+      word &= word - 1;
+    }
+  }
+}
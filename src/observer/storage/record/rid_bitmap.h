@@ -0,0 +1,59 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <map>
+#include <stdint.h>
+#include <vector>
+
+#include "storage/record/record.h"
+
+/**
+ * @brief 按照页面组织的RID集合
+ * @ingroup RecordManager
+ * @details 每个页面使用一个位图记录哪些槽位被选中，页面按照页号排序。
+ * 从多个索引中取出的RID可以在这里求交集或并集，最后按照页号顺序访问数据页面，
+ * 每个页面只需要读取一次。
+ */
+class RidBitmap
+{
+public:
+  /// 页号到槽位位图的映射，位图中第 i 位对应槽位 i
+  using PageMap = std::map<PageNum, std::vector<uint64_t>>;
+
+public:
+  void add(const RID &rid);
+
+  /**
+   * @brief 只保留同时出现在 other 中的RID
+   */
+  void intersect_with(const RidBitmap &other);
+
+  /**
+   * @brief 加入 other 中所有的RID
+   */
+  void union_with(const RidBitmap &other);
+
+  bool   empty() const { return pages_.empty(); }
+  size_t page_count() const { return pages_.size(); }
+  size_t size() const;
+  void   clear() { pages_.clear(); }
+
+  const PageMap &pages() const { return pages_; }
+
+  /**
+   * @brief 把一个页面位图中被选中的槽位按照从小到大的顺序放到 slot_nums 中
+   */
+  static void collect_slots(const std::vector<uint64_t> &words, std::vector<SlotNum> &slot_nums);
+
+private:
+  PageMap pages_;  ///< 不会保存没有任何槽位被选中的页面
+};
@@ -0,0 +1,601 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <string.h>
+
+#include "storage/record/varlen_record_manager.h"
+#include "common/log/log.h"
+#include "storage/record/record.h"
+
+using namespace common;
+
+static constexpr int VARLEN_PAGE_HEADER_SIZE = sizeof(VarLenPageHeader);
+static constexpr int VARLEN_SLOT_SIZE        = sizeof(VarLenSlot);
+
+/// 页面中可以存放槽位和记录的空间大小
+static constexpr int VARLEN_PAGE_CAPACITY = BP_PAGE_DATA_SIZE - VARLEN_PAGE_HEADER_SIZE;
+
+/// 每个溢出页面可以存放的数据长度
+static constexpr int OVERFLOW_PAGE_CAPACITY = BP_PAGE_DATA_SIZE - sizeof(VarLenOverflowPageHeader);
+
+/// CHARS 字段在编码后的数据中使用2个字节保存长度
+using CharsLength = uint16_t;
+
+RC VarLenRecordCodec::init(const std::vector<FieldMeta> &fields, int record_size)
+{
+  segments_.clear();
+  record_size_ = record_size;
+
+  for (const FieldMeta &field : fields) {
+    const bool chars = field.type() == CHARS;
+    if (chars && field.len() > std::numeric_limits<CharsLength>::max()) {
+      LOG_WARN("chars field is too long for variable-length format. field=%s, len=%d", field.name(), field.len());
+      return RC::INVALID_ARGUMENT;
+    }
+
+    if (!chars && !segments_.empty() && !segments_.back().chars &&
+        segments_.back().offset + segments_.back().len == field.offset()) {
+      segments_.back().len += field.len();
+    } else {
+      segments_.push_back(Segment{field.offset(), field.len(), chars});
+    }
+  }
+  return RC::SUCCESS;
+}
+
+void VarLenRecordCodec::encode(const char *record, std::vector<char> &image) const
+{
+  image.clear();
+  image.reserve(record_size_);
+  for (const Segment &segment : segments_) {
+    const char *data = record + segment.offset;
+    if (!segment.chars) {
+      image.insert(image.end(), data, data + segment.len);
+      continue;
+    }
+
+    const CharsLength len = static_cast<CharsLength>(strnlen(data, segment.len));
+    image.insert(image.end(), reinterpret_cast<const char *>(&len), reinterpret_cast<const char *>(&len) + sizeof(len));
+    image.insert(image.end(), data, data + len);
+  }
+}
+
+RC VarLenRecordCodec::decode(const char *image, int image_len, char *record) const
+{
+  const char *image_end = image + image_len;
+  for (const Segment &segment : segments_) {
+    char *data = record + segment.offset;
+    if (!segment.chars) {
+      if (image + segment.len > image_end) {
+        return RC::RECORD_INVALID_KEY;
+      }
+      memcpy(data, image, segment.len);
+      image += segment.len;
+      continue;
+    }
+
+    CharsLength len = 0;
+    if (image + sizeof(len) > image_end) {
+      return RC::RECORD_INVALID_KEY;
+    }
+    memcpy(&len, image, sizeof(len));
+    image += sizeof(len);
+    if (len > segment.len || image + len > image_end) {
+      return RC::RECORD_INVALID_KEY;
+    }
+    memcpy(data, image, len);
+    memset(data + len, 0, segment.len - len);
+    image += len;
+  }
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+VarLenRecordPageHandler::~VarLenRecordPageHandler() { cleanup(); }
+
+RC VarLenRecordPageHandler::init(DiskBufferPool &buffer_pool, PageNum page_num, bool readonly)
+{
+  cleanup();
+
+  RC rc = buffer_pool.get_this_page(page_num, &frame_);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to get page handle from disk buffer pool. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  if (readonly) {
+    frame_->read_latch();
+  } else {
+    frame_->write_latch();
+  }
+  disk_buffer_pool_ = &buffer_pool;
+  readonly_         = readonly;
+  recovering_       = false;
+  page_header_      = reinterpret_cast<VarLenPageHeader *>(frame_->data());
+  return rc;
+}
+
+RC VarLenRecordPageHandler::recover_init(DiskBufferPool &buffer_pool, PageNum page_num)
+{
+  cleanup();
+
+  RC rc = buffer_pool.get_this_page(page_num, &frame_);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to get page handle from disk buffer pool. rc=%s", strrc(rc));
+    return rc;
+  }
+
+  disk_buffer_pool_ = &buffer_pool;
+  readonly_         = false;
+  recovering_       = true;
+  page_header_      = reinterpret_cast<VarLenPageHeader *>(frame_->data());
+
+  buffer_pool.recover_page(page_num);
+
+  // 页面分配后会立即刷盘，所以正常情况下这里已经是一个记录页面了
+  if (page_header_->page_type != RECORD_PAGE) {
+    LOG_WARN("recover a page which is not initialized. page num=%d", page_num);
+    memset(frame_->data(), 0, BP_PAGE_DATA_SIZE);
+    page_header_->page_type   = RECORD_PAGE;
+    page_header_->free_offset = BP_PAGE_DATA_SIZE;
+    frame_->mark_dirty();
+  }
+  return rc;
+}
+
+RC VarLenRecordPageHandler::init_empty_page(DiskBufferPool &buffer_pool, PageNum page_num)
+{
+  RC rc = init(buffer_pool, page_num, false /*readonly*/);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to init empty page. page_num=%d, rc=%s", page_num, strrc(rc));
+    return rc;
+  }
+
+  page_header_->page_type     = RECORD_PAGE;
+  page_header_->record_num    = 0;
+  page_header_->slot_num      = 0;
+  page_header_->free_offset   = BP_PAGE_DATA_SIZE;
+  page_header_->fragment_size = 0;
+
+  rc = buffer_pool.flush_page(*frame_);
+  if (OB_FAIL(rc)) {
+    LOG_ERROR("Failed to flush page header %d:%d.", buffer_pool.file_desc(), page_num);
+    return rc;
+  }
+  return rc;
+}
+
+RC VarLenRecordPageHandler::cleanup()
+{
+  if (disk_buffer_pool_ != nullptr) {
+    if (!recovering_) {
+      if (readonly_) {
+        frame_->read_unlatch();
+      } else {
+        frame_->write_unlatch();
+      }
+    }
+    disk_buffer_pool_->unpin_page(frame_);
+    disk_buffer_pool_ = nullptr;
+    page_header_      = nullptr;
+  }
+  return RC::SUCCESS;
+}
+
+PageNum VarLenRecordPageHandler::get_page_num() const
+{
+  return page_header_ == nullptr ? BP_INVALID_PAGE_NUM : frame_->page_num();
+}
+
+bool VarLenRecordPageHandler::is_record_page() const { return page_header_->page_type == RECORD_PAGE; }
+
+VarLenSlot *VarLenRecordPageHandler::slot(SlotNum slot_num) const
+{
+  return reinterpret_cast<VarLenSlot *>(frame_->data() + VARLEN_PAGE_HEADER_SIZE) + slot_num;
+}
+
+int VarLenRecordPageHandler::slot_end() const
+{
+  return VARLEN_PAGE_HEADER_SIZE + page_header_->slot_num * VARLEN_SLOT_SIZE;
+}
+
+int VarLenRecordPageHandler::free_size() const
+{
+  return page_header_->free_offset - slot_end() + page_header_->fragment_size;
+}
+
+bool VarLenRecordPageHandler::can_hold(int length) const
+{
+  const bool has_empty_slot = page_header_->record_num < page_header_->slot_num;
+  return free_size() >= length + (has_empty_slot ? 0 : VARLEN_SLOT_SIZE);
+}
+
+RecordFreeSpaceMap::FreeSpaceLevel VarLenRecordPageHandler::free_level() const
+{
+  if (page_header_->record_num == 0) {
+    return RecordFreeSpaceMap::EMPTY;
+  }
+
+  const int free = free_size() - VARLEN_SLOT_SIZE;
+  if (free <= 0) {
+    return RecordFreeSpaceMap::FULL;
+  }
+  return RecordFreeSpaceMap::level_of(VARLEN_PAGE_CAPACITY - free, VARLEN_PAGE_CAPACITY);
+}
+
+void VarLenRecordPageHandler::compact()
+{
+  char buffer[BP_PAGE_DATA_SIZE];
+  memcpy(buffer, frame_->data(), BP_PAGE_DATA_SIZE);
+
+  int free_offset = BP_PAGE_DATA_SIZE;
+  for (SlotNum i = 0; i < page_header_->slot_num; i++) {
+    VarLenSlot *current = slot(i);
+    if (current->offset == 0) {
+      continue;
+    }
+
+    free_offset -= current->length;
+    memcpy(frame_->data() + free_offset, buffer + current->offset, current->length);
+    current->offset = static_cast<uint16_t>(free_offset);
+  }
+
+  page_header_->free_offset   = free_offset;
+  page_header_->fragment_size = 0;
+  frame_->mark_dirty();
+}
+
+RC VarLenRecordPageHandler::place_record(SlotNum slot_num, const char *data, int length, PageNum overflow_page)
+{
+  if (page_header_->free_offset - slot_end() < length) {
+    compact();
+  }
+  if (page_header_->free_offset - slot_end() < length) {
+    return RC::RECORD_NOMEM;
+  }
+
+  page_header_->free_offset -= length;
+  memcpy(frame_->data() + page_header_->free_offset, data, length);
+
+  VarLenSlot *target    = slot(slot_num);
+  target->offset        = static_cast<uint16_t>(page_header_->free_offset);
+  target->length        = static_cast<uint16_t>(length);
+  target->overflow_page = overflow_page;
+  frame_->mark_dirty();
+  return RC::SUCCESS;
+}
+
+RC VarLenRecordPageHandler::insert_record(const char *data, int length, PageNum overflow_page, RID *rid)
+{
+  ASSERT(readonly_ == false, "cannot insert record into page while the page is readonly");
+  // 长度为0的记录也要占用一个字节，因为偏移为0表示空槽位
+  length = std::max(length, 1);
+  if (length > MAX_INLINE_SIZE || !can_hold(length)) {
+    return RC::RECORD_NOMEM;
+  }
+
+  SlotNum slot_num = 0;
+  while (slot_num < page_header_->slot_num && slot(slot_num)->offset != 0) {
+    slot_num++;
+  }
+
+  if (slot_num == page_header_->slot_num) {
+    // 新增一个槽位，槽位目录会占用数据区前面的空间
+    if (page_header_->free_offset - slot_end() < VARLEN_SLOT_SIZE) {
+      compact();
+    }
+    page_header_->slot_num++;
+    slot(slot_num)->offset = 0;
+  }
+
+  RC rc = place_record(slot_num, data, length, overflow_page);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  page_header_->record_num++;
+  if (rid != nullptr) {
+    rid->page_num = get_page_num();
+    rid->slot_num = slot_num;
+  }
+  return rc;
+}
+
+RC VarLenRecordPageHandler::recover_insert_record(const char *data, int length, PageNum overflow_page, SlotNum slot_num)
+{
+  length = std::max(length, 1);
+  if (slot_num < 0 || length > MAX_INLINE_SIZE) {
+    return RC::RECORD_INVALID_RID;
+  }
+
+  while (page_header_->slot_num <= slot_num) {
+    if (page_header_->free_offset - slot_end() < VARLEN_SLOT_SIZE) {
+      compact();
+      if (page_header_->free_offset - slot_end() < VARLEN_SLOT_SIZE) {
+        return RC::RECORD_NOMEM;
+      }
+    }
+    VarLenSlot *new_slot    = slot(page_header_->slot_num);
+    new_slot->offset        = 0;
+    new_slot->length        = 0;
+    new_slot->overflow_page = BP_INVALID_PAGE_NUM;
+    page_header_->slot_num++;
+  }
+
+  VarLenSlot *target = slot(slot_num);
+  if (target->offset != 0) {
+    page_header_->fragment_size += target->length;
+    target->offset = 0;
+  } else {
+    page_header_->record_num++;
+  }
+  return place_record(slot_num, data, length, overflow_page);
+}
+
+RC VarLenRecordPageHandler::update_record(SlotNum slot_num, const char *data, int length, PageNum overflow_page)
+{
+  ASSERT(readonly_ == false, "cannot update record in page while the page is readonly");
+  length = std::max(length, 1);
+  if (slot_num < 0 || slot_num >= page_header_->slot_num || slot(slot_num)->offset == 0) {
+    return RC::RECORD_NOT_EXIST;
+  }
+  if (length > MAX_INLINE_SIZE) {
+    return RC::RECORD_NOMEM;
+  }
+
+  VarLenSlot *target = slot(slot_num);
+  if (length <= target->length) {
+    memcpy(frame_->data() + target->offset, data, length);
+    page_header_->fragment_size += target->length - length;
+    target->length        = static_cast<uint16_t>(length);
+    target->overflow_page = overflow_page;
+    frame_->mark_dirty();
+    return RC::SUCCESS;
+  }
+
+  if (free_size() + target->length < length) {
+    return RC::RECORD_NOMEM;
+  }
+
+  // 原来的空间变成碎片，整理页面时会被回收
+  page_header_->fragment_size += target->length;
+  target->offset = 0;
+  return place_record(slot_num, data, length, overflow_page);
+}
+
+RC VarLenRecordPageHandler::delete_record(SlotNum slot_num, PageNum &overflow_page)
+{
+  ASSERT(readonly_ == false, "cannot delete record from page while the page is readonly");
+  if (slot_num < 0 || slot_num >= page_header_->slot_num || slot(slot_num)->offset == 0) {
+    return RC::RECORD_NOT_EXIST;
+  }
+
+  VarLenSlot *target = slot(slot_num);
+  overflow_page      = target->overflow_page;
+  page_header_->fragment_size += target->length;
+  target->offset        = 0;
+  target->length        = 0;
+  target->overflow_page = BP_INVALID_PAGE_NUM;
+  page_header_->record_num--;
+
+  // 末尾的空槽位可以直接回收
+  while (page_header_->slot_num > 0 && slot(page_header_->slot_num - 1)->offset == 0) {
+    page_header_->slot_num--;
+  }
+  frame_->mark_dirty();
+  return RC::SUCCESS;
+}
+
+RC VarLenRecordPageHandler::get_record(SlotNum slot_num, const char *&data, int &length, PageNum &overflow_page) const
+{
+  if (slot_num < 0 || slot_num >= page_header_->slot_num || slot(slot_num)->offset == 0) {
+    return RC::RECORD_NOT_EXIST;
+  }
+
+  const VarLenSlot *target = slot(slot_num);
+  data                     = frame_->data() + target->offset;
+  length                   = target->length;
+  overflow_page            = target->overflow_page;
+  return RC::SUCCESS;
+}
+
+SlotNum VarLenRecordPageHandler::next_record(SlotNum start_slot_num) const
+{
+  for (SlotNum i = std::max(start_slot_num, 0); i < page_header_->slot_num; i++) {
+    if (slot(i)->offset != 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+RC VarLenRecordPageHandler::get_record(const VarLenRecordCodec &codec, SlotNum slot_num, Record &record) const
+{
+  const char *data          = nullptr;
+  int         length        = 0;
+  PageNum     overflow_page = BP_INVALID_PAGE_NUM;
+
+  RC rc = get_record(slot_num, data, length, overflow_page);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  std::vector<char> image;
+  if (overflow_page != BP_INVALID_PAGE_NUM) {
+    image.assign(data, data + length);
+    rc = read_overflow_pages(*disk_buffer_pool_, overflow_page, image);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+    data   = image.data();
+    length = static_cast<int>(image.size());
+  }
+
+  char *record_data = (char *)malloc(codec.record_size());
+  ASSERT(nullptr != record_data, "failed to malloc memory. record data size=%d", codec.record_size());
+  rc = codec.decode(data, length, record_data);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to decode record. page num=%d, slot num=%d, rc=%s", get_page_num(), slot_num, strrc(rc));
+    free(record_data);
+    return rc;
+  }
+
+  record.set_data_owner(record_data, codec.record_size());
+  record.set_rid(get_page_num(), slot_num);
+  return rc;
+}
+
+RC VarLenRecordPageHandler::update_record(
+    const VarLenRecordCodec &codec, SlotNum slot_num, const char *record, int *overflow_page_delta)
+{
+  if (overflow_page_delta != nullptr) {
+    *overflow_page_delta = 0;
+  }
+
+  const char *old_data          = nullptr;
+  int         old_length        = 0;
+  PageNum     old_overflow_page = BP_INVALID_PAGE_NUM;
+
+  RC rc = get_record(slot_num, old_data, old_length, old_overflow_page);
+  if (OB_FAIL(rc)) {
+    return rc;
+  }
+
+  std::vector<char> image;
+  codec.encode(record, image);
+  const int image_len = static_cast<int>(image.size());
+
+  // 优先全部放在当前页面，放不下时当前页面只保留原来那么长的数据，其余的放到溢出页面
+  int inline_len = std::min(image_len, MAX_INLINE_SIZE);
+  if (free_size() + old_length < inline_len) {
+    inline_len = std::min(inline_len, old_length);
+  }
+
+  PageNum overflow_page  = BP_INVALID_PAGE_NUM;
+  int     written_pages  = 0;
+  int     disposed_pages = 0;
+  if (inline_len < image_len) {
+    rc = write_overflow_pages(
+        *disk_buffer_pool_, image.data() + inline_len, image_len - inline_len, overflow_page, &written_pages);
+    if (OB_FAIL(rc)) {
+      return rc;
+    }
+  }
+
+  rc = update_record(slot_num, image.data(), inline_len, overflow_page);
+  if (OB_FAIL(rc)) {
+    dispose_overflow_pages(*disk_buffer_pool_, overflow_page);
+    return rc;
+  }
+
+  if (old_overflow_page != BP_INVALID_PAGE_NUM) {
+    dispose_overflow_pages(*disk_buffer_pool_, old_overflow_page, &disposed_pages);
+  }
+  if (overflow_page_delta != nullptr) {
+    *overflow_page_delta = written_pages - disposed_pages;
+  }
+  return rc;
+}
+
+RC VarLenRecordPageHandler::write_overflow_pages(
+    DiskBufferPool &buffer_pool, const char *data, int length, PageNum &first_page, int *page_count)
+{
+  if (page_count != nullptr) {
+    *page_count = 0;
+  }
+
+  // 从后往前写，这样每个页面分配时就知道下一个页面的页号
+  first_page            = BP_INVALID_PAGE_NUM;
+  const int total_pages = (length + OVERFLOW_PAGE_CAPACITY - 1) / OVERFLOW_PAGE_CAPACITY;
+  for (int i = total_pages - 1; i >= 0; i--) {
+    Frame *frame = nullptr;
+    RC     rc    = buffer_pool.allocate_page(&frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to allocate overflow page. rc=%s", strrc(rc));
+      dispose_overflow_pages(buffer_pool, first_page);
+      first_page = BP_INVALID_PAGE_NUM;
+      return rc;
+    }
+
+    const int data_len = std::min(OVERFLOW_PAGE_CAPACITY, length - i * OVERFLOW_PAGE_CAPACITY);
+    auto     *header   = reinterpret_cast<VarLenOverflowPageHeader *>(frame->data());
+    header->page_type  = OVERFLOW_PAGE;
+    header->next_page  = first_page;
+    header->data_len   = data_len;
+    memcpy(frame->data() + sizeof(VarLenOverflowPageHeader), data + i * OVERFLOW_PAGE_CAPACITY, data_len);
+    frame->mark_dirty();
+
+    first_page = frame->page_num();
+    buffer_pool.unpin_page(frame);
+  }
+
+  if (page_count != nullptr) {
+    *page_count = total_pages;
+  }
+  return RC::SUCCESS;
+}
+
+RC VarLenRecordPageHandler::read_overflow_pages(DiskBufferPool &buffer_pool, PageNum first_page, std::vector<char> &data)
+{
+  PageNum page_num = first_page;
+  while (page_num != BP_INVALID_PAGE_NUM) {
+    Frame *frame = nullptr;
+    RC     rc    = buffer_pool.get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get overflow page. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    auto *header = reinterpret_cast<VarLenOverflowPageHeader *>(frame->data());
+    if (header->page_type != OVERFLOW_PAGE) {
+      LOG_WARN("invalid overflow page. page num=%d", page_num);
+      buffer_pool.unpin_page(frame);
+      return RC::RECORD_INVALID_RID;
+    }
+
+    const char *page_data = frame->data() + sizeof(VarLenOverflowPageHeader);
+    data.insert(data.end(), page_data, page_data + header->data_len);
+    page_num = header->next_page;
+    buffer_pool.unpin_page(frame);
+  }
+  return RC::SUCCESS;
+}
+
+RC VarLenRecordPageHandler::dispose_overflow_pages(DiskBufferPool &buffer_pool, PageNum first_page, int *page_count)
+{
+  if (page_count != nullptr) {
+    *page_count = 0;
+  }
+
+  PageNum page_num = first_page;
+  while (page_num != BP_INVALID_PAGE_NUM) {
+    Frame *frame = nullptr;
+    RC     rc    = buffer_pool.get_this_page(page_num, &frame);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to get overflow page. page num=%d, rc=%s", page_num, strrc(rc));
+      return rc;
+    }
+
+    auto         *header    = reinterpret_cast<VarLenOverflowPageHeader *>(frame->data());
+    const PageNum next_page = header->page_type == OVERFLOW_PAGE ? header->next_page : BP_INVALID_PAGE_NUM;
+    buffer_pool.unpin_page(frame);
+
+    rc = buffer_pool.dispose_page(page_num);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to dispose overflow page. page num=%d, rc=%s", page_num, strrc(rc));
+    } else if (page_count != nullptr) {
+      (*page_count)++;
+    }
+    page_num = next_page;
+  }
+  return RC::SUCCESS;
+}
@@ -0,0 +1,237 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <vector>
+
+#include "common/rc.h"
+#include "common/types.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/field/field_meta.h"
+#include "storage/record/record.h"
+#include "storage/record/record_free_space_map.h"
+
+/**
+ * @brief 变长记录的编解码
+ * @ingroup RecordManager
+ * @details 上层(表、索引、执行算子)看到的记录始终是定长的格式，每个字段在记录中的偏移是固定的。
+ * 变长格式的表在存放到页面之前，先把记录编码成紧凑的格式：非CHARS字段原样保留，
+ * CHARS 字段只保存实际的字符串(2字节长度 + 内容)，不再保留末尾的填充。
+ * 从页面读取时再解码回定长格式，CHARS字段剩余的部分填0。
+ */
+class VarLenRecordCodec
+{
+public:
+  /**
+   * @param fields      表的所有字段(包括系统字段)
+   * @param record_size 定长格式的记录大小
+   */
+  RC init(const std::vector<FieldMeta> &fields, int record_size);
+
+  int record_size() const { return record_size_; }
+
+  /**
+   * @brief 把定长格式的记录编码成存放在页面中的格式
+   */
+  void encode(const char *record, std::vector<char> &image) const;
+
+  /**
+   * @brief 把页面中存放的数据解码成定长格式的记录，record 至少有 record_size 个字节
+   */
+  RC decode(const char *image, int image_len, char *record) const;
+
+private:
+  /// 记录中一段连续的数据，要么是一个CHARS字段，要么是若干个连续的非CHARS字段
+  struct Segment
+  {
+    int  offset;
+    int  len;
+    bool chars;
+  };
+
+  std::vector<Segment> segments_;
+  int                  record_size_ = 0;
+};
+
+/**
+ * @brief 变长记录页面的页头
+ * @ingroup RecordManager
+ */
+struct VarLenPageHeader
+{
+  int32_t page_type;      ///< 页面类型，参考 VarLenRecordPageHandler::RECORD_PAGE
+  int32_t record_num;     ///< 当前页面有效记录的个数
+  int32_t slot_num;       ///< 槽位目录中槽位的个数，包括空槽位
+  int32_t free_offset;    ///< 记录数据从页面尾部往前存放，这是已使用数据区的起始位置
+  int32_t fragment_size;  ///< 删除或缩短记录后留下的空洞大小，整理页面后可以重新使用
+};
+
+/**
+ * @brief 槽位目录中的一项
+ * @ingroup RecordManager
+ */
+struct VarLenSlot
+{
+  uint16_t offset;         ///< 记录在页面中的偏移，0 表示空槽位
+  uint16_t length;         ///< 记录存放在当前页面中的长度
+  PageNum  overflow_page;  ///< 超长记录剩余的数据存放在溢出页面链表中，没有时为 BP_INVALID_PAGE_NUM
+};
+
+/**
+ * @brief 溢出页面的页头，页头后面紧跟着数据
+ * @ingroup RecordManager
+ */
+struct VarLenOverflowPageHeader
+{
+  int32_t page_type;  ///< VarLenRecordPageHandler::OVERFLOW_PAGE
+  PageNum next_page;  ///< 下一个溢出页面
+  int32_t data_len;   ///< 当前页面存放的数据长度
+};
+
+/**
+ * @brief 负责处理变长记录页面(slotted page)中的各种操作
+ * @ingroup RecordManager
+ * @details 页面的组织大概是这样的：
+ * @code
+ * | VarLenPageHeader | slot0 | slot1 | ... | slotN | -> free space <- | recordN | ... | record1 | record0 |
+ * @endcode
+ * 槽位目录从前往后增长，记录数据从页面尾部往前存放。RID 中的 slot num 就是槽位的下标，
+ * 记录在页面内移动(比如整理碎片)时只需要修改槽位中的偏移，RID 不会变化。
+ * 记录太长时，页面中只存放前面一部分(不超过 MAX_INLINE_SIZE)，剩余的数据存放在溢出页面链表中。
+ */
+class VarLenRecordPageHandler
+{
+public:
+  static constexpr int32_t RECORD_PAGE   = 0x564c5250;  // "VLRP"
+  static constexpr int32_t OVERFLOW_PAGE = 0x564c4f50;  // "VLOP"
+
+  /// 一条记录在页面中最多存放的数据长度，保证空闲空间超过一半的页面一定能够放下一条记录
+  static constexpr int MAX_INLINE_SIZE =
+      (BP_PAGE_DATA_SIZE - static_cast<int>(sizeof(VarLenPageHeader))) / 4 - static_cast<int>(sizeof(VarLenSlot));
+
+public:
+  VarLenRecordPageHandler() = default;
+  ~VarLenRecordPageHandler();
+
+  RC init(DiskBufferPool &buffer_pool, PageNum page_num, bool readonly);
+
+  /**
+   * @brief 数据库恢复时使用，不加锁
+   */
+  RC recover_init(DiskBufferPool &buffer_pool, PageNum page_num);
+
+  /**
+   * @brief 初始化一个新的记录页面
+   */
+  RC init_empty_page(DiskBufferPool &buffer_pool, PageNum page_num);
+
+  RC cleanup();
+
+  PageNum get_page_num() const;
+
+  /**
+   * @brief 当前页面是否是变长记录页面，而不是空闲空间映射页面或溢出页面
+   */
+  bool is_record_page() const;
+
+  /**
+   * @brief 当前页面是否能放下指定长度的记录(可能需要整理碎片)
+   */
+  bool can_hold(int length) const;
+
+  RecordFreeSpaceMap::FreeSpaceLevel free_level() const;
+
+  /**
+   * @brief 插入一条记录
+   *
+   * @param data          存放在当前页面的数据
+   * @param length        数据长度，不能超过 MAX_INLINE_SIZE
+   * @param overflow_page 剩余数据所在的溢出页面
+   * @param rid           返回记录的位置
+   */
+  RC insert_record(const char *data, int length, PageNum overflow_page, RID *rid);
+
+  /**
+   * @brief 数据库恢复时，在指定的槽位放入数据。槽位上已经有数据时直接覆盖
+   */
+  RC recover_insert_record(const char *data, int length, PageNum overflow_page, SlotNum slot_num);
+
+  /**
+   * @brief 修改一条记录，长度变长时可能会在页面内移动位置
+   * @return 当前页面放不下时返回 RECORD_NOMEM，记录保持原样
+   */
+  RC update_record(SlotNum slot_num, const char *data, int length, PageNum overflow_page);
+
+  /**
+   * @brief 删除一条记录
+   *
+   * @param overflow_page 返回这条记录的溢出页面，由调用者释放
+   */
+  RC delete_record(SlotNum slot_num, PageNum &overflow_page);
+
+  /**
+   * @brief 获取一条记录存放在当前页面中的数据，数据直接指向页面内存
+   */
+  RC get_record(SlotNum slot_num, const char *&data, int &length, PageNum &overflow_page) const;
+
+  /**
+   * @brief 从 start_slot_num 开始找到下一个有效的槽位，没有时返回 -1
+   */
+  SlotNum next_record(SlotNum start_slot_num) const;
+
+  /**
+   * @brief 读取一条完整的记录(包括溢出页面中的数据)并解码成定长格式，解码后的内存由 record 管理
+   */
+  RC get_record(const VarLenRecordCodec &codec, SlotNum slot_num, Record &record) const;
+
+  /**
+   * @brief 使用定长格式的记录覆盖指定槽位上的记录，RID 保持不变
+   * @details 当前页面放不下变长后的记录时，会把更多的数据放到溢出页面中
+   * @param overflow_page_delta 返回新分配的溢出页面个数减去释放的个数
+   */
+  RC update_record(
+      const VarLenRecordCodec &codec, SlotNum slot_num, const char *record, int *overflow_page_delta = nullptr);
+
+public:
+  /**
+   * @brief 把数据写到新分配的溢出页面链表中
+   *
+   * @param first_page 返回链表中的第一个页面
+   * @param page_count 返回分配的页面个数
+   */
+  static RC write_overflow_pages(
+      DiskBufferPool &buffer_pool, const char *data, int length, PageNum &first_page, int *page_count = nullptr);
+
+  /**
+   * @brief 读取溢出页面链表中的数据，追加到 data 后面
+   */
+  static RC read_overflow_pages(DiskBufferPool &buffer_pool, PageNum first_page, std::vector<char> &data);
+
+  /**
+   * @brief 释放溢出页面链表
+   * @param page_count 返回释放的页面个数
+   */
+  static RC dispose_overflow_pages(DiskBufferPool &buffer_pool, PageNum first_page, int *page_count = nullptr);
+
+private:
+  VarLenSlot *slot(SlotNum slot_num) const;
+  int         slot_end() const;
+  int         free_size() const;
+  void        compact();
+  RC          place_record(SlotNum slot_num, const char *data, int length, PageNum overflow_page);
+
+private:
+  DiskBufferPool   *disk_buffer_pool_ = nullptr;
+  Frame            *frame_            = nullptr;
+  bool              readonly_         = false;
+  bool              recovering_       = false;
+  VarLenPageHeader *page_header_      = nullptr;
+};
@@ -13,7 +13,10 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include <algorithm>
+#include <inttypes.h>
 #include <limits.h>
+#include <limits>
+#include <random>
 #include <string.h>
 
 #include "common/defs.h"
@@ -23,7 +26,9 @@ See the Mulan PSL v2 for more details. */
 #include "storage/common/condition_filter.h"
 #include "storage/common/meta_util.h"
 #include "storage/index/bplus_tree_index.h"
+#include "storage/index/hash_index.h"
 #include "storage/index/index.h"
+#include "storage/index/lsm_index.h"
 #include "storage/record/record_manager.h"
 #include "storage/table/table.h"
 #include "storage/table/table_meta.h"
@@ -53,7 +58,7 @@ Table::~Table()
 }
 
 RC Table::create(int32_t table_id, const char *path, const char *name, const char *base_dir, int attribute_count,
-    const AttrInfoSqlNode attributes[])
+    const AttrInfoSqlNode attributes[], StorageFormat storage_format)
 {
   if (table_id < 0) {
     LOG_WARN("invalid table id. table_id=%d, table_name=%s", table_id, name);
@@ -88,7 +93,7 @@ RC Table::create(int32_t table_id, const char *path, const char *name, const cha
   close(fd);
 
   // 创建文件
-  if ((rc = table_meta_.init(table_id, name, attribute_count, attributes)) != RC::SUCCESS) {
+  if ((rc = table_meta_.init(table_id, name, attribute_count, attributes, storage_format)) != RC::SUCCESS) {
     LOG_ERROR("Failed to init table meta. name:%s, ret:%d", name, rc);
     return rc;  // delete table file
   }
@@ -160,11 +165,15 @@ RC Table::drop(const char *path, const char *name, const char *base_dir)
   // 删除索引文件
   for (std::vector<Index *>::size_type i = 0; i < indexes_.size(); i++) {
     std::string index_file = table_index_file(base_dir_.c_str(), name, indexes_[i]->index_meta().name());
-    rc                     = reinterpret_cast<BplusTreeIndex *>(indexes_[i])->close();
+    rc                     = indexes_[i]->close();
     if (rc != RC::SUCCESS) {
       LOG_ERROR("Failed to close disk buffer pool of index file. file name=%s", index_file.c_str());
       return rc;
     }
+    if (indexes_[i]->index_meta().type() == IndexType::LSM) {
+      // LSM树的有序段保存在单独的文件中
+      LsmTreeHandler::remove_run_files(index_file.c_str());
+    }
     rc = data_buffer_pool_->drop_file(index_file.c_str());
     if (rc != RC::SUCCESS) {
       LOG_ERROR("Failed to drop disk buffer pool of index file. file name=%s", index_file.c_str());
@@ -172,6 +181,19 @@ RC Table::drop(const char *path, const char *name, const char *base_dir)
     }
   }
 
+  // 统计信息文件可能不存在
+  std::string stats_file = table_stats_file(base_dir, name);
+  if (::unlink(stats_file.c_str()) != 0 && errno != ENOENT) {
+    LOG_WARN("Failed to remove table stats file. file name=%s, errmsg=%s", stats_file.c_str(), strerror(errno));
+  }
+
+  // 区域映射在关闭时才写入文件
+  record_handler_->close();
+  std::string zone_map_file = table_zone_map_file(base_dir, name);
+  if (::unlink(zone_map_file.c_str()) != 0 && errno != ENOENT) {
+    LOG_WARN("Failed to remove zone map file. file name=%s, errmsg=%s", zone_map_file.c_str(), strerror(errno));
+  }
+
   // 真正删除该数据表
   int fd = ::unlink(path);
   if (-1 == fd) {
@@ -231,10 +253,21 @@ RC Table::open(const char *meta_file, const char *base_dir)
       field_metas->push_back(*field_meta);
     }
 
-    BplusTreeIndex *index      = new BplusTreeIndex();
-    std::string     index_file = table_index_file(base_dir, name(), index_meta->name());
-
-    rc = index->open(index_file.c_str(), *index_meta, *field_metas);
+    std::string index_file = table_index_file(base_dir, name(), index_meta->name());
+    Index      *index      = nullptr;
+    if (index_meta->type() == IndexType::HASH) {
+      HashIndex *hash_index = new HashIndex(index_meta->is_unique());
+      rc                    = hash_index->open(index_file.c_str(), *index_meta, *field_metas);
+      index                 = hash_index;
+    } else if (index_meta->type() == IndexType::LSM) {
+      LsmIndex *lsm_index = new LsmIndex(index_meta->is_unique());
+      rc                  = lsm_index->open(index_file.c_str(), *index_meta, *field_metas);
+      index               = lsm_index;
+    } else {
+      BplusTreeIndex *tree_index = new BplusTreeIndex(index_meta->is_unique());
+      rc                         = tree_index->open(index_file.c_str(), *index_meta, *field_metas);
+      index                      = tree_index;
+    }
     if (rc != RC::SUCCESS) {
       delete index;
       LOG_ERROR("Failed to open index. table=%s, index=%s, file=%s, rc=%s",
@@ -246,6 +279,17 @@ RC Table::open(const char *meta_file, const char *base_dir)
     indexes_.push_back(index);
   }
 
+  std::string                 stats_file = table_stats_file(base_dir, name());
+  std::shared_ptr<TableStats> stats      = std::make_shared<TableStats>();
+  RC                          stats_rc   = stats->load(stats_file.c_str());
+  if (OB_FAIL(stats_rc)) {
+    // 统计信息只影响执行计划的选择，读不出来就当作没有做过 ANALYZE
+    LOG_WARN("Failed to load table stats, ignore it. table=%s, file=%s, rc=%s",
+             name(), stats_file.c_str(), strrc(stats_rc));
+  } else {
+    stats_ = stats;
+  }
+
   return rc;
 }
 
@@ -274,11 +318,53 @@ RC Table::insert_record(Record &record)
   return rc;
 }
 
+RC Table::insert_records(std::vector<Record> &records)
+{
+  RC     rc       = RC::SUCCESS;
+  size_t inserted = 0;
+  for (; inserted < records.size(); inserted++) {
+    Record &record = records[inserted];
+    rc = record_handler_->insert_record(record.data(), table_meta_.record_size(), &record.rid());
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Insert record failed. table name=%s, rc=%s", table_meta_.name(), strrc(rc));
+      break;
+    }
+  }
+
+  if (rc == RC::SUCCESS) {
+    rc = insert_entries_of_indexes(records);
+    if (rc != RC::SUCCESS) {  // 可能出现了键值重复
+      RC rc2 = delete_entries_of_indexes(records);
+      if (rc2 != RC::SUCCESS) {
+        LOG_ERROR("Failed to rollback index data when insert index entries failed. table name=%s, rc=%d:%s",
+                  name(), rc2, strrc(rc2));
+      }
+    }
+  }
+
+  if (rc != RC::SUCCESS) {
+    for (size_t i = 0; i < inserted; i++) {
+      RC rc2 = record_handler_->delete_record(&records[i].rid());
+      if (rc2 != RC::SUCCESS) {
+        LOG_PANIC("Failed to rollback record data when insert records failed. table name=%s, rc=%d:%s",
+                  name(), rc2, strrc(rc2));
+      }
+    }
+  }
+  return rc;
+}
+
 RC Table::visit_record(const RID &rid, bool readonly, std::function<void(Record &)> visitor)
 {
   return record_handler_->visit_record(rid, readonly, visitor);
 }
 
+RC Table::visit_records(
+    PageNum page_num, const std::vector<SlotNum> &slot_nums, bool readonly, std::function<void(Record &)> visitor)
+{
+  return record_handler_->visit_records(page_num, slot_nums, readonly, visitor);
+}
+
 RC Table::get_record(const RID &rid, Record &record)
 {
   const int record_size = table_meta_.record_size();
@@ -311,12 +397,38 @@ RC Table::get_record(const RID &rid, Record &record)
 RC Table::recover_insert_record(Record &record)
 {
   RC rc = RC::SUCCESS;
-  rc    = record_handler_->recover_insert_record(record.data(), table_meta_.record_size(), record.rid());
+  if (table_meta_.storage_format() == StorageFormat::VARLEN_FORMAT) {
+    // 变长格式的日志中记录的是编码后的数据，插入索引前需要先解码成定长格式
+    rc = record_handler_->recover_insert_record(record.data(), record.len(), record.rid());
+    if (OB_SUCC(rc)) {
+      const int record_size = table_meta_.record_size();
+      char     *record_data = (char *)malloc(record_size);
+      ASSERT(nullptr != record_data, "failed to malloc memory. record data size=%d", record_size);
+      rc = record_handler_->varlen_codec().decode(record.data(), record.len(), record_data);
+      if (OB_FAIL(rc)) {
+        free(record_data);
+      } else {
+        record.set_data_owner(record_data, record_size);
+      }
+    }
+  } else {
+    rc = record_handler_->recover_insert_record(record.data(), table_meta_.record_size(), record.rid());
+  }
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Insert record failed. table name=%s, rc=%s", table_meta_.name(), strrc(rc));
     return rc;
   }
 
+  // 索引页面可能在写日志之后已经刷到了磁盘(比如哈希索引)，先删掉可能存在的键值，保证重做是幂等的
+  for (Index *index : indexes_) {
+    rc = index->delete_entry(record.data(), &record.rid());
+    if (rc != RC::SUCCESS && rc != RC::RECORD_NOT_EXIST) {
+      LOG_ERROR("Failed to remove index entry before redo. table name=%s, index=%s, rc=%s",
+                name(), index->index_meta().name(), strrc(rc));
+      return rc;
+    }
+  }
+
   rc = insert_entry_of_indexes(record.data(), record.rid());
   if (rc != RC::SUCCESS) {  // 可能出现了键值重复
     RC rc2 = delete_entry_of_indexes(record.data(), record.rid(), false /*error_on_not_exists*/);
@@ -361,6 +473,8 @@ RC Table::make_record(int value_num, const Value *values, Record &record)
   // 复制所有字段的值
   int   record_size = table_meta_.record_size();
   char *record_data = (char *)malloc(record_size);
+  // 系统字段(事务号)清零，不经过事务写入的数据(比如 load data 导入的)事务号就是0
+  memset(record_data, 0, record_size);
 
   for (int i = 0; i < value_num; i++) {
     const FieldMeta *field    = table_meta_.field(i + normal_field_start_index);
@@ -409,7 +523,8 @@ RC Table::init_record_handler(const char *base_dir)
 
   record_handler_ = new RecordFileHandler();
 
-  rc = record_handler_->init(data_buffer_pool_);
+  std::string zone_map_file = table_zone_map_file(base_dir, table_meta_.name());
+  rc = record_handler_->init(data_buffer_pool_, &table_meta_, zone_map_file.c_str());
   if (rc != RC::SUCCESS) {
     LOG_ERROR("Failed to init record handler. rc=%s", strrc(rc));
     data_buffer_pool_->close_file();
@@ -422,9 +537,9 @@ RC Table::init_record_handler(const char *base_dir)
   return rc;
 }
 
-RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly)
+RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly, ConditionFilter *condition_filter)
 {
-  RC rc = scanner.open_scan(this, *data_buffer_pool_, trx, readonly, nullptr);
+  RC rc = scanner.open_scan(this, *data_buffer_pool_, trx, readonly, condition_filter);
   if (rc != RC::SUCCESS) {
     LOG_ERROR("failed to open scanner. rc=%s", strrc(rc));
   }
@@ -531,7 +646,8 @@ RC Table::get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly
 // }
 
 // create_index核心函数：当前连接trx，field_list，index_name
-RC Table::create_index(Trx *trx, int unique, std::vector<const FieldMeta *> field_meta_list, const char *index_name)
+RC Table::create_index(Trx *trx, int unique, std::vector<const FieldMeta *> field_meta_list, const char *index_name,
+    IndexType index_type, const IndexBuildOptions &options)
 {
   // 合法性检查
   if (common::is_blank(index_name) || 0 == field_meta_list.size()) {
@@ -541,16 +657,14 @@ RC Table::create_index(Trx *trx, int unique, std::vector<const FieldMeta *> fiel
 
   IndexMeta new_index_meta;
 
-  RC rc = new_index_meta.init(index_name, field_meta_list, unique);  // 初始化IndexMeta
+  RC rc = new_index_meta.init(index_name, field_meta_list, unique, index_type);  // 初始化IndexMeta
   if (rc != RC::SUCCESS) {
     LOG_INFO("Failed to init IndexMeta in table:%s, index_name:%s, field_size:%d", 
              name(), index_name, field_meta_list.size());
     return rc;
   }
 
-  // 创建索引相关数据
-  BplusTreeIndex *index      = new BplusTreeIndex(unique);
-  std::string     index_file = table_index_file(base_dir_.c_str(), name(), index_name);  // 在磁盘创建索引文件
+  std::string index_file = table_index_file(base_dir_.c_str(), name(), index_name);  // 在磁盘创建索引文件
 
   // 写的不优雅：用于将 std::vector<const FieldMeta *>转化为 std::vector<FieldMeta>
   std::vector<FieldMeta> field_meta_list_non_const;
@@ -558,15 +672,28 @@ RC Table::create_index(Trx *trx, int unique, std::vector<const FieldMeta *> fiel
     field_meta_list_non_const.push_back(*meta);
   }
 
-  // TODO 创建索引核心调用部分
-  rc = index->create(index_file.c_str(), new_index_meta, field_meta_list_non_const);
+  // 创建索引相关数据
+  Index *index = nullptr;
+  if (index_type == IndexType::HASH) {
+    HashIndex *hash_index = new HashIndex(unique);
+    rc                    = hash_index->create(index_file.c_str(), new_index_meta, field_meta_list_non_const);
+    index                 = hash_index;
+  } else if (index_type == IndexType::LSM) {
+    LsmIndex *lsm_index = new LsmIndex(unique);
+    rc                  = lsm_index->create(index_file.c_str(), new_index_meta, field_meta_list_non_const);
+    index               = lsm_index;
+  } else {
+    BplusTreeIndex *tree_index = new BplusTreeIndex(unique);
+    rc                         = tree_index->create(index_file.c_str(), new_index_meta, field_meta_list_non_const);
+    index                      = tree_index;
+  }
   if (rc != RC::SUCCESS) {
     delete index;
-    LOG_ERROR("Failed to create bplus tree index. file name=%s, rc=%d:%s", index_file.c_str(), rc, strrc(rc));
+    LOG_ERROR("Failed to create index. file name=%s, rc=%d:%s", index_file.c_str(), rc, strrc(rc));
     return rc;
   }
 
-  // 遍历当前的所有数据，插入这个索引
+  // 遍历当前的所有数据，排序后批量导入这个索引
   RecordFileScanner scanner;
   rc = get_record_scanner(scanner, trx, true /*readonly*/);
   if (rc != RC::SUCCESS) {
@@ -575,28 +702,21 @@ RC Table::create_index(Trx *trx, int unique, std::vector<const FieldMeta *> fiel
     return rc;
   }
 
-  Record record;
-  while (scanner.has_next()) {
-    rc = scanner.next(record);
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to scan records while creating index. table=%s, index=%s, rc=%s",
-               name(), index_name, strrc(rc));
-      return rc;
-    }
-    LOG_DEBUG("[[[[[[[[[[[[[[unique index data]]]]]]]]]]]]]] data:%d",record.data());
-    rc = index->insert_entry(record.data(), &record.rid());  // 插入索引节点
-    if (rc != RC::SUCCESS) {
-      LOG_WARN("failed to insert record into index while creating index. table=%s, index=%s, rc=%s",
-               name(), index_name, strrc(rc));
+  const std::string run_file = index_file + ".sort";
+  rc = index->bulk_load(scanner, options, run_file.c_str());
+  scanner.close_scan();
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("failed to load records into index while creating index. table=%s, index=%s, rc=%s",
+             name(), index_name, strrc(rc));
 
-      // data_buffer_pool_->close_file();
-      data_buffer_pool_->drop_file(index_file.c_str());  // 删除临时创建的索引文件 此处连续操作会有内存泄露bug
-      // data_buffer_pool_ = nullptr;
-      return rc;
+    delete index;  // 关闭索引文件之后再删除
+    if (index_type == IndexType::LSM) {
+      LsmTreeHandler::remove_run_files(index_file.c_str());
     }
+    data_buffer_pool_->drop_file(index_file.c_str());  // 删除临时创建的索引文件
+    return rc;
   }
-  scanner.close_scan();
-  LOG_INFO("inserted all records into new index. table=%s, index=%s", name(), index_name);
+  LOG_INFO("loaded all records into new index. table=%s, index=%s", name(), index_name);
 
   indexes_.push_back(index);
 
@@ -655,6 +775,11 @@ RC Table::delete_record(const Record &record)
   return rc;
 }
 
+RC Table::delete_records(PageNum page_num, const std::vector<SlotNum> &slot_nums)
+{
+  return record_handler_->delete_records(page_num, slot_nums);
+}
+
 RC Table::update_record(Record &record)
 {
   RC rc = RC::SUCCESS;
@@ -716,6 +841,30 @@ RC Table::delete_entry_of_indexes(const char *record, const RID &rid, bool error
   return rc;
 }
 
+RC Table::insert_entries_of_indexes(const std::vector<Record> &records)
+{
+  RC rc = RC::SUCCESS;
+  for (Index *index : indexes_) {
+    rc = index->insert_entries(records);
+    if (rc != RC::SUCCESS) {
+      break;
+    }
+  }
+  return rc;
+}
+
+RC Table::delete_entries_of_indexes(const std::vector<Record> &records)
+{
+  RC rc = RC::SUCCESS;
+  for (Index *index : indexes_) {
+    rc = index->delete_entries(records);
+    if (rc != RC::SUCCESS) {
+      break;
+    }
+  }
+  return rc;
+}
+
 Index *Table::find_index(const char *index_name) const
 {
   for (Index *index : indexes_) {
@@ -735,6 +884,38 @@ Index *Table::find_index_by_field(const char *field_name) const
   return nullptr;
 }
 
+Index *Table::find_equal_index_by_field(const char *field_name) const
+{
+  // 哈希索引查找一个值通常只需要访问一个页面，比B+树更合适
+  Index *found = nullptr;
+  for (Index *index : indexes_) {
+    const std::vector<std::string> *fields = index->index_meta().fields();
+    if (fields->size() != 1 || fields->front() != field_name) {
+      continue;
+    }
+    if (index->index_meta().type() == IndexType::HASH) {
+      return index;
+    }
+    if (found == nullptr) {
+      found = index;
+    }
+  }
+  return found;
+}
+
+Index *Table::find_range_index_by_field(const char *field_name) const
+{
+  for (Index *index : indexes_) {
+    const std::vector<std::string> *fields = index->index_meta().fields();
+    const IndexType                 type   = index->index_meta().type();
+    if (fields->size() == 1 && fields->front() == field_name &&
+        (type == IndexType::BPLUS_TREE || type == IndexType::LSM)) {
+      return index;
+    }
+  }
+  return nullptr;
+}
+
 // Index *Table ::find_index_by_field(std::vector<std::string> field) const{
 //   for (Index &index : indexes_) {
 //     if (field == *index) {
@@ -743,6 +924,125 @@ Index *Table::find_index_by_field(const char *field_name) const
 //   }
 // }
 
+RC Table::analyze(const std::vector<const FieldMeta *> &field_metas, const std::function<RC()> &page_visited)
+{
+  std::lock_guard<std::mutex> analyze_guard(analyze_lock_);
+
+  // 采样期间发生的修改不一定能被看到，所以只扣除开始时的计数
+  const TableModifications modifications = this->modifications();
+
+  std::vector<PageNum> page_nums;
+  BufferPoolIterator   bp_iterator;
+  RC                   rc = bp_iterator.init(*data_buffer_pool_);
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to init bp iterator. table=%s, rc=%s", name(), strrc(rc));
+    return rc;
+  }
+  // 空闲空间映射页面上没有记录，不参与采样，记录的页面数与 data_page_count 一致
+  while (bp_iterator.has_next()) {
+    const PageNum page_num = bp_iterator.next();
+    if (!record_handler_->is_map_page(page_num)) {
+      page_nums.push_back(page_num);
+    }
+  }
+
+  // 页面很多时随机挑选一部分，再按页号排序，尽量顺序读
+  const int64_t total_pages = static_cast<int64_t>(page_nums.size());
+  const int     sample_pages = TableStatsCollector::MAX_SAMPLE_PAGES;
+  if (total_pages > sample_pages) {
+    std::mt19937 random_engine(std::random_device{}());
+    for (int i = 0; i < sample_pages; i++) {
+      std::uniform_int_distribution<int64_t> distribution(i, total_pages - 1);
+      std::swap(page_nums[i], page_nums[distribution(random_engine)]);
+    }
+    page_nums.resize(sample_pages);
+    std::sort(page_nums.begin(), page_nums.end());
+  }
+
+  // 页面上的记录不一定都有效。MVCC 的删除只在提交时设置 end_xid，记录还留在页面上；
+  // 没有提交的插入 begin_xid 小于0。这两种记录都不计入统计信息，没有提交的删除仍然算作存在。
+  // 字段的含义与 MvccTrx 一致：没有删除的记录 end_xid 是最大的事务号，正在删除的记录 end_xid 小于0
+  Field                                   begin_xid_field;
+  Field                                   end_xid_field;
+  const std::pair<const FieldMeta *, int> trx_fields = table_meta_.trx_fields();
+  const bool                              has_xid    = trx_fields.second >= 2;
+  if (has_xid) {
+    begin_xid_field = Field(this, &trx_fields.first[0]);
+    end_xid_field   = Field(this, &trx_fields.first[1]);
+  }
+  auto live_record = [&](const Record &record) {
+    if (!has_xid) {
+      return true;
+    }
+    const int32_t begin_xid = begin_xid_field.get_int(record);
+    const int32_t end_xid   = end_xid_field.get_int(record);
+    return begin_xid > 0 && (end_xid < 0 || end_xid == std::numeric_limits<int32_t>::max());
+  };
+
+  TableStatsCollector collector(field_metas);
+  for (PageNum page_num : page_nums) {
+    rc = record_handler_->visit_page_records(page_num, [&collector, &live_record](const Record &record) {
+      if (live_record(record)) {
+        collector.add_record(record);
+      }
+    });
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to visit records of page. table=%s, page_num=%d, rc=%s", name(), page_num, strrc(rc));
+      return rc;
+    }
+    if (page_visited) {
+      rc = page_visited();
+      if (OB_FAIL(rc)) {
+        LOG_INFO("analyze stopped. table=%s, rc=%s", name(), strrc(rc));
+        return rc;
+      }
+    }
+  }
+
+  std::shared_ptr<TableStats> new_stats = std::make_shared<TableStats>(*stats());
+  collector.finish(total_pages, static_cast<int64_t>(page_nums.size()), *new_stats);
+
+  std::string stats_file = table_stats_file(base_dir_.c_str(), name());
+  rc                     = new_stats->save(stats_file.c_str());
+  if (OB_FAIL(rc)) {
+    LOG_WARN("failed to save table stats. table=%s, file=%s, rc=%s", name(), stats_file.c_str(), strrc(rc));
+    return rc;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(stats_lock_);
+    stats_ = new_stats;
+  }
+  add_modifications(-modifications.inserts, -modifications.updates, -modifications.deletes);
+  LOG_INFO("table analyzed. table=%s, rows=%" PRId64 ", pages=%" PRId64 ", sampled pages=%d",
+           name(), new_stats->row_count(), new_stats->page_count(), static_cast<int>(page_nums.size()));
+  return rc;
+}
+
+int32_t Table::data_page_count() const { return record_handler_->data_page_count(); }
+
+std::shared_ptr<const TableStats> Table::stats() const
+{
+  std::lock_guard<std::mutex> guard(stats_lock_);
+  return stats_;
+}
+
+void Table::add_modifications(int64_t inserts, int64_t updates, int64_t deletes)
+{
+  inserted_rows_ += inserts;
+  updated_rows_ += updates;
+  deleted_rows_ += deletes;
+}
+
+TableModifications Table::modifications() const
+{
+  TableModifications modifications;
+  modifications.inserts = inserted_rows_.load();
+  modifications.updates = updated_rows_.load();
+  modifications.deletes = deleted_rows_.load();
+  return modifications;
+}
+
 RC Table::sync()
 {
   RC rc = RC::SUCCESS;
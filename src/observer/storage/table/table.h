@@ -14,8 +14,13 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/types.h"
 #include "storage/table/table_meta.h"
+#include "storage/table/table_stats.h"
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
 
 struct RID;
 class Record;
@@ -26,6 +31,7 @@ class ConditionFilter;
 class DefaultConditionFilter;
 class Index;
 class IndexScanner;
+struct IndexBuildOptions;
 class RecordDeleter;
 class Trx;
 class Field;
@@ -47,9 +53,10 @@ public:
    * @param base_dir 表数据存放的路径
    * @param attribute_count 字段个数
    * @param attributes 字段
+   * @param storage_format 记录的存放格式
    */
   RC create(int32_t table_id, const char *path, const char *name, const char *base_dir, int attribute_count,
-      const AttrInfoSqlNode attributes[]);
+      const AttrInfoSqlNode attributes[], StorageFormat storage_format = StorageFormat::ROW_FORMAT);
   /**
    * drop table
    * @param  {char*} path     :
@@ -82,13 +89,24 @@ public:
    */
   RC insert_record(Record &record);
 
+  /**
+   * @brief 在当前的表中批量插入多条记录
+   * @details 先把所有记录插入表文件，再按索引逐个批量插入键值，每个索引只需要按键值顺序走一遍。
+   * 任何一条记录失败时整批回滚，调用者可以再逐条插入找出出错的记录。同样不关心事务相关操作。
+   * @param records[in/out] 插入成功会通过每条记录返回RID
+   */
+  RC insert_records(std::vector<Record> &records);
+
   // 更新记录
   RC update_record(Record &record);
 
   RC update_record(Record &record, Field *field, const Value *value);
 
   RC delete_record(const Record &record);
+  RC delete_records(PageNum page_num, const std::vector<SlotNum> &slot_nums);
   RC visit_record(const RID &rid, bool readonly, std::function<void(Record &)> visitor);
+  RC visit_records(PageNum page_num, const std::vector<SlotNum> &slot_nums, bool readonly,
+      std::function<void(Record &)> visitor);
   RC get_record(const RID &rid, Record &record);
 
   RC recover_insert_record(Record &record);
@@ -97,26 +115,41 @@ public:
   RC create_index(Trx *trx, const FieldMeta *field_meta, const char *index_name);
 
   // multi-index
-  RC create_index(Trx *trx, int unique, std::vector<const FieldMeta *> field_meta_list, const char *index_name);
+  /**
+   * @brief 创建索引，表中已有的数据批量导入到索引中
+   * @param index_type 索引的类型，B+树或者哈希
+   * @param options 批量导入的参数，参考 IndexBuildOptions
+   */
+  RC create_index(Trx *trx, int unique, std::vector<const FieldMeta *> field_meta_list, const char *index_name,
+      IndexType index_type, const IndexBuildOptions &options);
 
-  RC get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly);
+  /**
+   * @brief 打开表上的记录扫描
+   * @param condition_filter 下推到扫描器中的过滤条件，可以为空。扫描结束之前调用者需要保证它有效
+   */
+  RC get_record_scanner(RecordFileScanner &scanner, Trx *trx, bool readonly,
+      ConditionFilter *condition_filter = nullptr);
 
   RecordFileHandler *record_handler() const { return record_handler_; }
 
+  /**
+   * @brief 数据文件中存放记录的页面数，不包括文件头、空闲空间映射页面和溢出页面
+   */
+  int32_t data_page_count() const;
+
 public:
   int32_t     table_id() const { return table_meta_.table_id(); }
   const char *name() const;
 
   const TableMeta &table_meta() const;
 
-  RC set_cost(int cost){ cost_ = cost;};
-  const int get_cost(){return cost_;};
-
   RC sync();
 
 private:
   RC insert_entry_of_indexes(const char *record, const RID &rid);
   RC delete_entry_of_indexes(const char *record, const RID &rid, bool error_on_not_exists);
+  RC insert_entries_of_indexes(const std::vector<Record> &records);
+  RC delete_entries_of_indexes(const std::vector<Record> &records);
 
 private:
   RC init_record_handler(const char *base_dir);
@@ -124,23 +157,41 @@ private:
 public:
   Index     *find_index(const char *index_name) const;
   Index     *find_index_by_field(const char *field_name) const;
+
+  /**
+   * @brief 找一个适合做等值查找的单字段索引，优先使用哈希索引
+   */
+  Index     *find_equal_index_by_field(const char *field_name) const;
+
+  /**
+   * @brief 找一个可以做范围查找的单字段索引(B+树或LSM树)
+   */
+  Index     *find_range_index_by_field(const char *field_name) const;
   IndexMeta *find_index_by_field(std::vector<std::string> field) const;
 
-  // 设置表对应的全部数据内容
-  RC set_data_matrix(std::vector<std::vector<Value>> data_matrix){
-    data_matrix_.clear();
-    data_matrix_ = data_matrix;
-  }
+  /**
+   * @brief 收集统计信息(ANALYZE)
+   * @details 从数据文件中随机采样一部分页面，每个页面只读一次，流式地生成这些字段的统计信息，
+   * 然后保存到统计信息文件中。没有分析的字段保留之前的统计信息
+   * 同一张表同时只会有一个 ANALYZE 在执行，成功之后扣除开始时看到的修改计数
+   * @param field_metas 要分析的字段
+   * @param page_visited 每读完一个采样页面调用一次，后台刷新统计信息时用来限速。返回错误时放弃这次分析
+   */
+  RC analyze(const std::vector<const FieldMeta *> &field_metas, const std::function<RC()> &page_visited = nullptr);
 
-  // 设置表对应的分析矩阵结果
-  RC set_analyzed_value(std::vector<std::vector<Value>> analyzed_value){
-    analyzed_value_.clear();
-    analyzed_value_ = analyzed_value;
-  }
+  /**
+   * @brief 最近一次 ANALYZE 的统计信息
+   * @details 返回的是一个快照，ANALYZE 不会修改已经返回的对象
+   */
+  std::shared_ptr<const TableStats> stats() const;
+
+  /**
+   * @brief 累加上次 ANALYZE 之后修改的行数
+   * @details 由事务在修改生效时调用：VacuousTrx 每次修改之后，MvccTrx 在提交时，LOAD DATA 在批量插入之后
+   */
+  void add_modifications(int64_t inserts, int64_t updates, int64_t deletes);
 
-  std::vector<std::vector<Value>> get_analyzed_value(){
-    return analyzed_value_;
-  }
+  TableModifications modifications() const;
 
 private:
   std::string          base_dir_;
@@ -148,7 +199,12 @@ private:
   DiskBufferPool      *data_buffer_pool_ = nullptr;  /// 数据文件关联的buffer pool
   RecordFileHandler   *record_handler_   = nullptr;  /// 记录操作
   std::vector<Index *> indexes_;
-  std::vector<std::vector<Value>> data_matrix_;  // ANALYZE得到的表全部数据，对象存储，若内存不够可改为指针
-  std::vector<std::vector<Value>> analyzed_value_;  // ANALYZE得到的直方图
-  int cost_;
+
+  std::mutex                        analyze_lock_;  /// 保证同一张表同时只有一个 ANALYZE
+  mutable std::mutex                stats_lock_;
+  std::shared_ptr<const TableStats> stats_ = std::make_shared<TableStats>();  /// 统计信息，ANALYZE 时整体替换
+
+  std::atomic<int64_t> inserted_rows_{0};  /// 上次 ANALYZE 之后插入的行数
+  std::atomic<int64_t> updated_rows_{0};
+  std::atomic<int64_t> deleted_rows_{0};
 };
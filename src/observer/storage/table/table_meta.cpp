@@ -26,6 +26,7 @@ static const Json::StaticString FIELD_TABLE_ID("table_id");
 static const Json::StaticString FIELD_TABLE_NAME("table_name");
 static const Json::StaticString FIELD_FIELDS("fields");
 static const Json::StaticString FIELD_INDEXES("indexes");
+static const Json::StaticString FIELD_STORAGE_FORMAT("storage_format");
 static const Json::StaticString UNIQUE_INDEX("unique");
 
 TableMeta::TableMeta(const TableMeta &other)
@@ -33,7 +34,8 @@ TableMeta::TableMeta(const TableMeta &other)
       name_(other.name_),
       fields_(other.fields_),
       indexes_(other.indexes_),
-      record_size_(other.record_size_)
+      record_size_(other.record_size_),
+      storage_format_(other.storage_format_)
 {}
 
 void TableMeta::swap(TableMeta &other) noexcept
@@ -42,9 +44,11 @@ void TableMeta::swap(TableMeta &other) noexcept
   fields_.swap(other.fields_);
   indexes_.swap(other.indexes_);
   std::swap(record_size_, other.record_size_);
+  std::swap(storage_format_, other.storage_format_);
 }
 
-RC TableMeta::init(int32_t table_id, const char *name, int field_num, const AttrInfoSqlNode attributes[])
+RC TableMeta::init(int32_t table_id, const char *name, int field_num, const AttrInfoSqlNode attributes[],
+    StorageFormat storage_format)
 {
   if (common::is_blank(name)) {
     LOG_ERROR("Name cannot be empty");
@@ -88,7 +92,8 @@ RC TableMeta::init(int32_t table_id, const char *name, int field_num, const Attr
     field_offset += attr_info.length;
   }
 
-  record_size_ = field_offset;
+  record_size_    = field_offset;
+  storage_format_ = storage_format;
 
   table_id_ = table_id;
   name_     = name;
@@ -190,6 +195,7 @@ int TableMeta::serialize(std::ostream &ss) const
   Json::Value table_value;
   table_value[FIELD_TABLE_ID]   = table_id_;
   table_value[FIELD_TABLE_NAME] = name_;
+  table_value[FIELD_STORAGE_FORMAT] = static_cast<int>(storage_format_);
 
   Json::Value fields_value;
   for (const FieldMeta &field : fields_) {
@@ -247,6 +253,18 @@ int TableMeta::deserialize(std::istream &is)
 
   std::string table_name = table_name_value.asString();
 
+  // 老版本的元数据文件中没有存放格式，都是定长格式
+  StorageFormat      storage_format       = StorageFormat::ROW_FORMAT;
+  const Json::Value &storage_format_value = table_value[FIELD_STORAGE_FORMAT];
+  if (!storage_format_value.isNull()) {
+    if (!storage_format_value.isInt() || storage_format_value.asInt() <= static_cast<int>(StorageFormat::UNKNOWN_FORMAT) ||
+        storage_format_value.asInt() > static_cast<int>(StorageFormat::VARLEN_FORMAT)) {
+      LOG_ERROR("Invalid storage format. json value=%s", storage_format_value.toStyledString().c_str());
+      return -1;
+    }
+    storage_format = static_cast<StorageFormat>(storage_format_value.asInt());
+  }
+
   const Json::Value &fields_value = table_value[FIELD_FIELDS];
   if (!fields_value.isArray() || fields_value.size() <= 0) {
     LOG_ERROR("Invalid table meta. fields is not array, json value=%s", fields_value.toStyledString().c_str());
@@ -274,7 +292,8 @@ int TableMeta::deserialize(std::istream &is)
   table_id_ = table_id;
   name_.swap(table_name);
   fields_.swap(fields);
-  record_size_ = fields_.back().offset() + fields_.back().len() - fields_.begin()->offset();
+  record_size_    = fields_.back().offset() + fields_.back().len() - fields_.begin()->offset();
+  storage_format_ = storage_format;
 
   const Json::Value &indexes_value = table_value[FIELD_INDEXES];
   if (!indexes_value.empty()) {
@@ -19,6 +19,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "common/lang/serializable.h"
 #include "common/rc.h"
+#include "common/types.h"
 #include "storage/field/field_meta.h"
 #include "storage/index/index_meta.h"
 
@@ -36,7 +37,8 @@ public:
 
   void swap(TableMeta &other) noexcept;
 
-  RC init(int32_t table_id, const char *name, int field_num, const AttrInfoSqlNode attributes[]);
+  RC init(int32_t table_id, const char *name, int field_num, const AttrInfoSqlNode attributes[],
+      StorageFormat storage_format = StorageFormat::ROW_FORMAT);
 
   RC add_index(const IndexMeta &index);
 
@@ -61,6 +63,8 @@ public:
 
   int record_size() const;
 
+  StorageFormat storage_format() const { return storage_format_; }
+
 public:
   int  serialize(std::ostream &os) const override;
   int  deserialize(std::istream &is) override;
@@ -76,4 +80,6 @@ protected:
   std::vector<IndexMeta> indexes_;
 
   int record_size_ = 0;
+
+  StorageFormat storage_format_ = StorageFormat::ROW_FORMAT;  ///< 记录在数据文件中的存放格式
 };
@@ -0,0 +1,332 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <cmath>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common/io/io.h"
+#include "common/lang/bloom_filter.h"
+#include "common/log/log.h"
+#include "storage/field/field_meta.h"
+#include "storage/record/record.h"
+#include "storage/table/table_stats.h"
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief 统计信息文件的文件头，后面紧跟着每个字段的统计信息
+ * @details 每个字段依次是：名字长度(int32)、名字、类型(int32)、空值比例(double)、不同值个数(int64)、
+ * 直方图边界个数(int32)，然后是每个边界的长度(int32)和数据
+ */
+struct TableStatsHeader
+{
+  static constexpr uint32_t MAGIC = 0x5354424dU;  // "MBTS"
+
+  uint32_t magic;
+  int32_t  column_num;
+  int64_t  row_count;
+  int64_t  page_count;
+};
+
+template <typename T>
+void append(string &buffer, const T &value)
+{
+  buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void append_bytes(string &buffer, const char *data, int32_t len)
+{
+  append(buffer, len);
+  buffer.append(data, len);
+}
+
+/**
+ * @brief 按顺序读取统计信息文件的内容，越界时 ok() 返回false
+ */
+class StatsReader
+{
+public:
+  StatsReader(const char *data, size_t size) : data_(data), size_(size) {}
+
+  template <typename T>
+  T read()
+  {
+    T value{};
+    if (ok_ && pos_ + sizeof(T) <= size_) {
+      memcpy(&value, data_ + pos_, sizeof(T));
+      pos_ += sizeof(T);
+    } else {
+      ok_ = false;
+    }
+    return value;
+  }
+
+  string read_bytes()
+  {
+    const int32_t len = read<int32_t>();
+    if (!ok_ || len < 0 || pos_ + len > size_) {
+      ok_ = false;
+      return string();
+    }
+    string bytes(data_ + pos_, len);
+    pos_ += len;
+    return bytes;
+  }
+
+  bool ok() const { return ok_; }
+
+private:
+  const char *data_ = nullptr;
+  size_t      size_ = 0;
+  size_t      pos_  = 0;
+  bool        ok_   = true;
+};
+
+/**
+ * @brief 字段值在记录中实际的长度。字符串不包含结尾的0
+ */
+int value_length(const FieldMeta &field_meta, const char *data)
+{
+  if (field_meta.type() == CHARS) {
+    return static_cast<int>(strnlen(data, field_meta.len()));
+  }
+  return field_meta.len();
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+const ColumnStats *TableStats::column(const char *field_name) const
+{
+  for (const ColumnStats &column : columns_) {
+    if (column.field_name == field_name) {
+      return &column;
+    }
+  }
+  return nullptr;
+}
+
+void TableStats::update(int64_t row_count, int64_t page_count, vector<ColumnStats> columns)
+{
+  analyzed_   = true;
+  row_count_  = row_count;
+  page_count_ = page_count;
+  for (ColumnStats &column : columns) {
+    auto iter = find_if(columns_.begin(), columns_.end(), [&column](const ColumnStats &old) {
+      return old.field_name == column.field_name;
+    });
+    if (iter != columns_.end()) {
+      *iter = std::move(column);
+    } else {
+      columns_.push_back(std::move(column));
+    }
+  }
+}
+
+RC TableStats::save(const char *file_name) const
+{
+  TableStatsHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic      = TableStatsHeader::MAGIC;
+  header.column_num = static_cast<int32_t>(columns_.size());
+  header.row_count  = row_count_;
+  header.page_count = page_count_;
+
+  string buffer;
+  append(buffer, header);
+  for (const ColumnStats &column : columns_) {
+    append_bytes(buffer, column.field_name.data(), static_cast<int32_t>(column.field_name.size()));
+    append(buffer, static_cast<int32_t>(column.attr_type));
+    append(buffer, column.null_fraction);
+    append(buffer, column.distinct_count);
+    append(buffer, static_cast<int32_t>(column.bounds.size()));
+    for (const Value &bound : column.bounds) {
+      append_bytes(buffer, bound.data(), bound.length());
+    }
+  }
+
+  // 先写临时文件再改名，统计信息文件任何时候都是完整的
+  const string tmp_file = string(file_name) + ".tmp";
+  int          fd       = ::open(tmp_file.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0600);
+  if (fd < 0) {
+    LOG_WARN("failed to create table stats file. file=%s, error=%s", tmp_file.c_str(), strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+  int ret = common::writen(fd, buffer.data(), static_cast<int>(buffer.size()));
+  ::close(fd);
+  if (ret != 0 || ::rename(tmp_file.c_str(), file_name) != 0) {
+    LOG_WARN("failed to write table stats file. file=%s, error=%s", file_name, strerror(ret != 0 ? ret : errno));
+    return RC::IOERR_WRITE;
+  }
+  return RC::SUCCESS;
+}
+
+RC TableStats::load(const char *file_name)
+{
+  int fd = ::open(file_name, O_RDONLY);
+  if (fd < 0) {
+    if (errno == ENOENT) {
+      return RC::SUCCESS;
+    }
+    LOG_WARN("failed to open table stats file. file=%s, error=%s", file_name, strerror(errno));
+    return RC::IOERR_OPEN;
+  }
+
+  struct stat st;
+  string      buffer;
+  int         ret = ::fstat(fd, &st) == 0 ? 0 : errno;
+  if (ret == 0) {
+    buffer.resize(st.st_size);
+    ret = common::readn(fd, buffer.data(), static_cast<int>(buffer.size()));
+  }
+  ::close(fd);
+  if (ret != 0) {
+    LOG_WARN("failed to read table stats file. file=%s, ret=%d", file_name, ret);
+    return RC::IOERR_READ;
+  }
+
+  StatsReader      reader(buffer.data(), buffer.size());
+  TableStatsHeader header = reader.read<TableStatsHeader>();
+  if (!reader.ok() || header.magic != TableStatsHeader::MAGIC || header.column_num < 0) {
+    LOG_WARN("invalid table stats file. file=%s", file_name);
+    return RC::IOERR_READ;
+  }
+
+  vector<ColumnStats> columns(header.column_num);
+  for (ColumnStats &column : columns) {
+    column.field_name     = reader.read_bytes();
+    column.attr_type      = static_cast<AttrType>(reader.read<int32_t>());
+    column.null_fraction  = reader.read<double>();
+    column.distinct_count = reader.read<int64_t>();
+    const int32_t bound_num = reader.read<int32_t>();
+    for (int32_t i = 0; reader.ok() && i < bound_num; i++) {
+      const string data = reader.read_bytes();
+      Value        bound;
+      bound.set_type(column.attr_type);
+      bound.set_data(data.data(), static_cast<int>(data.size()));
+      column.bounds.push_back(bound);
+    }
+  }
+  if (!reader.ok()) {
+    LOG_WARN("invalid table stats file. file=%s", file_name);
+    return RC::IOERR_READ;
+  }
+
+  analyzed_   = true;
+  row_count_  = header.row_count;
+  page_count_ = header.page_count;
+  columns_.swap(columns);
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TableStatsCollector::TableStatsCollector(const vector<const FieldMeta *> &field_metas)
+    : random_engine_(random_device()())
+{
+  columns_.resize(field_metas.size());
+  for (size_t i = 0; i < field_metas.size(); i++) {
+    columns_[i].field_meta = field_metas[i];
+  }
+}
+
+void TableStatsCollector::add_record(const Record &record)
+{
+  row_count_++;
+  for (ColumnCollector &column : columns_) {
+    const FieldMeta &field_meta = *column.field_meta;
+    const char      *data       = record.data() + field_meta.offset();
+    const int        len        = value_length(field_meta, data);
+    column.hll.add(common::BloomFilter::hash(data, len));
+
+    // 蓄水池采样：第 row_count_ 行以 RESERVOIR_SIZE / row_count_ 的概率替换掉一个已有的样本
+    int64_t slot = static_cast<int64_t>(column.reservoir.size());
+    if (slot >= RESERVOIR_SIZE) {
+      slot = uniform_int_distribution<int64_t>(0, row_count_ - 1)(random_engine_);
+      if (slot >= RESERVOIR_SIZE) {
+        continue;
+      }
+    } else {
+      column.reservoir.emplace_back();
+    }
+    column.reservoir[slot].set_type(field_meta.type());
+    column.reservoir[slot].set_data(data, len);
+  }
+}
+
+void TableStatsCollector::finish(int64_t total_pages, int64_t sampled_pages, TableStats &stats)
+{
+  double sample_ratio = 1.0;
+  if (sampled_pages > 0 && sampled_pages < total_pages) {
+    sample_ratio = static_cast<double>(sampled_pages) / total_pages;
+  }
+
+  vector<ColumnStats> columns;
+  for (ColumnCollector &column : columns_) {
+    columns.push_back(build_column_stats(column, sample_ratio));
+  }
+
+  const int64_t row_count = llround(row_count_ / sample_ratio);
+  for (ColumnStats &column : columns) {
+    column.distinct_count = min(column.distinct_count, row_count);
+  }
+  stats.update(row_count, total_pages, std::move(columns));
+}
+
+ColumnStats TableStatsCollector::build_column_stats(ColumnCollector &column, double sample_ratio)
+{
+  ColumnStats stats;
+  stats.field_name = column.field_meta->name();
+  stats.attr_type  = column.field_meta->type();
+
+  vector<Value> &samples = column.reservoir;
+  sort(samples.begin(), samples.end(), [](const Value &left, const Value &right) {
+    return left.compare(right) < 0;
+  });
+
+  // 等深直方图：从排好序的样本中等间隔地取边界
+  const int64_t sample_num = static_cast<int64_t>(samples.size());
+  if (sample_num > 0) {
+    const int64_t buckets = min<int64_t>(HISTOGRAM_BUCKETS, sample_num);
+    for (int64_t i = 0; i <= buckets; i++) {
+      stats.bounds.push_back(samples[i * (sample_num - 1) / buckets]);
+    }
+  }
+
+  double distinct = row_count_ == 0 ? 0 : max(1.0, column.hll.estimate());
+  if (sample_ratio < 1.0 && sample_num > 0) {
+    // 只读了一部分页面时使用 Duj1 估计整张表的不同值个数：n * d / (n - f1 + f1 * n / N)
+    // f1 是样本中只出现一次的值的个数，这里用蓄水池中只出现一次的比例来近似
+    int64_t singletons = 0;
+    for (int64_t i = 0; i < sample_num; i++) {
+      const bool same_as_prev = i > 0 && samples[i].compare(samples[i - 1]) == 0;
+      const bool same_as_next = i + 1 < sample_num && samples[i].compare(samples[i + 1]) == 0;
+      if (!same_as_prev && !same_as_next) {
+        singletons++;
+      }
+    }
+    const double n  = static_cast<double>(row_count_);
+    const double f1 = min(distinct, n * singletons / sample_num);
+    distinct        = n * distinct / (n - f1 + f1 * sample_ratio);
+  }
+  stats.distinct_count = llround(distinct);
+
+  // 样本用完就释放掉
+  vector<Value>().swap(samples);
+  return stats;
+}
@@ -0,0 +1,123 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/lang/hyper_log_log.h"
+#include "common/rc.h"
+#include "sql/parser/value.h"
+
+class FieldMeta;
+class Record;
+
+/**
+ * @brief 一个字段的统计信息
+ */
+struct ColumnStats
+{
+  std::string        field_name;
+  AttrType           attr_type      = UNDEFINED;
+  double             null_fraction  = 0;  ///< 空值的比例。当前字段都不允许为空，预留给以后支持NULL
+  int64_t            distinct_count = 0;  ///< 不同值的个数(NDV)
+  std::vector<Value> bounds;              ///< 等深直方图的边界，相邻两个边界之间的行数大致相同
+};
+
+/**
+ * @brief 上次 ANALYZE 之后表中修改的行数
+ * @details 只在内存中维护，重启之后从0开始。后台的 StatsRefresher 据此判断统计信息是否过期
+ */
+struct TableModifications
+{
+  int64_t inserts = 0;
+  int64_t updates = 0;
+  int64_t deletes = 0;
+
+  int64_t total() const { return inserts + updates + deletes; }
+};
+
+/**
+ * @brief 表的统计信息，由 ANALYZE 收集，优化器使用
+ * @details 以二进制格式保存在表目录下的 <table>.stats 文件中，表打开时加载。
+ */
+class TableStats
+{
+public:
+  /**
+   * @brief 是否做过 ANALYZE
+   */
+  bool analyzed() const { return analyzed_; }
+
+  int64_t row_count() const { return row_count_; }
+  int64_t page_count() const { return page_count_; }
+
+  const std::vector<ColumnStats> &columns() const { return columns_; }
+  const ColumnStats              *column(const char *field_name) const;
+
+  /**
+   * @brief 设置表的行数和页面数，并用新的统计信息替换同名的字段，其它字段的统计信息保留
+   */
+  void update(int64_t row_count, int64_t page_count, std::vector<ColumnStats> columns);
+
+  RC save(const char *file_name) const;
+
+  /**
+   * @brief 从文件中加载统计信息。文件不存在时返回成功，相当于没有做过 ANALYZE
+   */
+  RC load(const char *file_name);
+
+private:
+  bool                     analyzed_   = false;
+  int64_t                  row_count_  = 0;
+  int64_t                  page_count_ = 0;
+  std::vector<ColumnStats> columns_;
+};
+
+/**
+ * @brief 从采样的页面中流式地收集统计信息
+ * @details 调用者逐个页面读取记录交给 add_record，内存占用与表的大小无关：
+ * 每个字段维护一个固定大小的蓄水池样本用来生成等深直方图，以及一个 HyperLogLog 用来估计不同值的个数。
+ */
+class TableStatsCollector
+{
+public:
+  static constexpr int MAX_SAMPLE_PAGES  = 1024;   ///< 最多读取的页面数
+  static constexpr int RESERVOIR_SIZE    = 10000;  ///< 每个字段最多保留的样本数
+  static constexpr int HISTOGRAM_BUCKETS = 32;     ///< 直方图的桶数
+
+  explicit TableStatsCollector(const std::vector<const FieldMeta *> &field_metas);
+
+  void add_record(const Record &record);
+
+  /**
+   * @brief 根据采样的结果估计整张表的统计信息
+   * @param total_pages   表的数据文件一共有多少页面
+   * @param sampled_pages 实际读取了多少页面
+   */
+  void finish(int64_t total_pages, int64_t sampled_pages, TableStats &stats);
+
+private:
+  struct ColumnCollector
+  {
+    const FieldMeta    *field_meta = nullptr;
+    common::HyperLogLog hll;
+    std::vector<Value>  reservoir;
+  };
+
+  ColumnStats build_column_stats(ColumnCollector &column, double sample_ratio);
+
+private:
+  std::vector<ColumnCollector> columns_;
+  int64_t                      row_count_ = 0;  ///< 采样的页面中一共读到了多少行
+  std::mt19937_64              random_engine_;
+};
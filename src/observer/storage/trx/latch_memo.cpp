@@ -12,6 +12,8 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai on 2023/03/08.
 //
 
+#include <algorithm>
+
 #include "storage/trx/latch_memo.h"
 #include "common/lang/mutex.h"
 #include "storage/buffer/disk_buffer_pool.h"
@@ -106,6 +108,18 @@ void LatchMemo::slatch(common::SharedMutex *lock)
   items_.emplace_back(LatchMemoType::SHARED, lock);
 }
 
+void LatchMemo::push_path(Frame *frame) { path_.push_back(frame); }
+
+Frame *LatchMemo::parent_of(const Frame *frame) const
+{
+  for (size_t i = 1; i < path_.size(); i++) {
+    if (path_[i] == frame) {
+      return path_[i - 1];
+    }
+  }
+  return nullptr;
+}
+
 void LatchMemo::release_item(LatchMemoItem &item)
 {
   switch (item.type) {
@@ -140,7 +154,10 @@ void LatchMemo::release()
   release_to(point);
 
   for (PageNum page_num : disposed_pages_) {
-    buffer_pool_->dispose_page(page_num);
+    RC rc = buffer_pool_->dispose_page(page_num);
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to dispose page. page num=%d, rc=%s", page_num, strrc(rc));
+    }
   }
   disposed_pages_.clear();
 }
@@ -157,4 +174,16 @@ void LatchMemo::release_to(int point)
     release_item(item);
   }
   items_.erase(items_.begin(), iter);
+
+  // 查找路径与加锁的顺序一致，前面的节点锁释放了，就不能再作为父节点使用
+  while (!path_.empty()) {
+    const Frame *frame   = path_.front();
+    bool         latched = std::any_of(items_.begin(), items_.end(), [frame](const LatchMemoItem &item) {
+      return item.frame == frame && item.type != LatchMemoType::PIN;
+    });
+    if (latched) {
+      break;
+    }
+    path_.pop_front();
+  }
 }
@@ -66,6 +66,19 @@ public:
   void xlatch(common::SharedMutex *lock);
   void slatch(common::SharedMutex *lock);
 
+  /**
+   * @brief 记录B+树从根节点往下查找时经过的节点(已经加锁)
+   * @details B+树节点中不保存父节点的页号，分裂或合并需要修改父节点时，通过 parent_of 从查找路径中获取。
+   * 节点的锁释放后，它也会从路径中移除
+   */
+  void push_path(Frame *frame);
+
+  /**
+   * @brief 返回查找路径中指定节点的父节点
+   * @return 指定节点是路径中的第一个节点(根节点，或者父节点的锁已经释放)或者不在路径中时返回nullptr
+   */
+  Frame *parent_of(const Frame *frame) const;
+
   void release();
 
   void release_to(int point);
@@ -79,4 +92,5 @@ private:
   DiskBufferPool           *buffer_pool_ = nullptr;
   std::deque<LatchMemoItem> items_;
   std::vector<PageNum>      disposed_pages_;
+  std::deque<Frame *>       path_;  ///< 从根节点开始的查找路径
 };
\ No newline at end of file
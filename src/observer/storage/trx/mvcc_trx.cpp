@@ -44,6 +44,13 @@ const vector<FieldMeta> *MvccTrxKit::trx_fields() const { return &fields_; }
 
 int32_t MvccTrxKit::next_trx_id() { return ++current_trx_id_; }
 
+void MvccTrxKit::advance_trx_id(int32_t trx_id)
+{
+  int32_t current = current_trx_id_.load();
+  while (current < trx_id && !current_trx_id_.compare_exchange_weak(current, trx_id)) {
+  }
+}
+
 int32_t MvccTrxKit::max_trx_id() const { return numeric_limits<int32_t>::max(); }
 
 Trx *MvccTrxKit::create_trx(CLogManager *log_manager)
@@ -120,6 +127,11 @@ MvccTrx::~MvccTrx() {}
 
 RC MvccTrx::insert_record(Table *table, Record &record)
 {
+  if (readonly_) {
+    LOG_WARN("cannot insert record in readonly trx. table=%s", table->name());
+    return RC::INVALID_ARGUMENT;
+  }
+
   Field begin_field;
   Field end_field;
   trx_fields(table, begin_field, end_field);
@@ -133,10 +145,20 @@ RC MvccTrx::insert_record(Table *table, Record &record)
     return rc;
   }
 
+  // 变长格式的表记录编码后的数据，与页面中存放的数据一致，日志也更小
+  const char       *log_data = record.data();
+  int               log_len  = record.len();
+  std::vector<char> image;
+  if (table->table_meta().storage_format() == StorageFormat::VARLEN_FORMAT) {
+    table->record_handler()->varlen_codec().encode(record.data(), image);
+    log_data = image.data();
+    log_len  = static_cast<int>(image.size());
+  }
+
   rc = log_manager_->append_log(
-      CLogType::INSERT, trx_id_, table->table_id(), record.rid(), record.len(), 0 /*offset*/, record.data());
+      CLogType::INSERT, trx_id_, table->table_id(), record.rid(), log_len, 0 /*offset*/, log_data);
   ASSERT(rc == RC::SUCCESS, "failed to append insert record log. trx id=%d, table id=%d, rid=%s, record len=%d, rc=%s",
-      trx_id_, table->table_id(), record.rid().to_string().c_str(), record.len(), strrc(rc));
+      trx_id_, table->table_id(), record.rid().to_string().c_str(), log_len, strrc(rc));
 
   pair<OperationSet::iterator, bool> ret = operations_.insert(Operation(Operation::Type::INSERT, table, record.rid()));
   if (!ret.second) {
@@ -148,6 +170,11 @@ RC MvccTrx::insert_record(Table *table, Record &record)
 
 RC MvccTrx::delete_record(Table *table, Record &record)
 {
+  if (readonly_) {
+    LOG_WARN("cannot delete record in readonly trx. table=%s", table->name());
+    return RC::INVALID_ARGUMENT;
+  }
+
   Field begin_field;
   Field end_field;
   trx_fields(table, begin_field, end_field);
@@ -155,15 +182,38 @@ RC MvccTrx::delete_record(Table *table, Record &record)
   int32_t                  begin_xid = begin_field.get_int(record);
   [[maybe_unused]] int32_t end_xid   = end_field.get_int(record);
   /// 在删除之前，第一次获取record时，就已经对record做了对应的检查，并且保证不会有其它的事务来访问这条数据
-  ASSERT(end_xid > 0, "concurrency conflit: other transaction is updating this record. end_xid=%d, current trx id=%d, rid=%s",
+  ASSERT(end_xid >= 0, "concurrency conflit: other transaction is updating this record. end_xid=%d, current trx id=%d, rid=%s",
          end_xid, trx_id_, record.rid().to_string().c_str());
-  if (end_xid != trx_kit_.max_trx_id()) {
+  if (!is_latest_version(end_xid)) {
     // 当前不是多版本数据中的最新记录，不需要删除
     return RC::SUCCESS;
   }
 
   end_field.set_int(record, -trx_id_);
-  RC rc = log_manager_->append_log(CLogType::DELETE, trx_id_, table->table_id(), record.rid(), 0, 0, nullptr);
+
+  RC rc = RC::SUCCESS;
+  if (table->table_meta().storage_format() == StorageFormat::VARLEN_FORMAT) {
+    // 变长格式扫描出来的记录是解码后的副本，需要写回页面。
+    // 遍历时没有拿着页面锁，写回时再检查一次，防止其它事务已经删除了这条记录
+    bool conflict = false;
+    rc            = table->visit_record(record.rid(), false /*readonly*/, [&](Record &page_record) {
+      if (!is_latest_version(end_field.get_int(page_record))) {
+        conflict = true;
+        return;
+      }
+      end_field.set_int(page_record, -trx_id_);
+    });
+    if (OB_FAIL(rc)) {
+      LOG_WARN("failed to write back deleted varlen record. rid=%s, rc=%s", record.rid().to_string().c_str(), strrc(rc));
+      return rc;
+    }
+    if (conflict) {
+      LOG_TRACE("concurrency conflict while deleting varlen record. rid=%s", record.rid().to_string().c_str());
+      return RC::LOCKED_CONCURRENCY_CONFLICT;
+    }
+  }
+
+  rc = log_manager_->append_log(CLogType::DELETE, trx_id_, table->table_id(), record.rid(), 0, 0, nullptr);
   ASSERT(rc == RC::SUCCESS, "failed to append delete record log. trx id=%d, table id=%d, rid=%s, record len=%d, rc=%s",
       trx_id_, table->table_id(), record.rid().to_string().c_str(), record.len(), strrc(rc));
   if (begin_xid == -trx_id_) {
@@ -207,8 +257,30 @@ RC MvccTrx::visit_record(Table *table, Record &record, bool readonly)
   int32_t begin_xid = begin_field.get_int(record);
   int32_t end_xid   = end_field.get_int(record);
 
+  if (readonly_) {
+    // 只读事务没有自己的修改，trx_id_ 是开始时已分配的最大事务号(快照)。
+    // 快照号可能与某个活跃事务的事务号相同，所以未提交的数据都按照其他事务的修改来处理：
+    // 未提交的插入不可见，未提交的删除仍然可见
+    if (begin_xid < 0) {
+      return RC::RECORD_INVISIBLE;
+    }
+    if (end_xid < 0) {
+      return RC::SUCCESS;
+    }
+    // 不经过事务写入的数据(比如 load data 导入的)事务号是0，对所有的快照都可见。
+    // 快照号本身可能就是某个已提交事务的提交号，因此删除提交号等于快照号时不可见
+    if (begin_xid > 0 && trx_id_ < begin_xid) {
+      return RC::RECORD_INVISIBLE;
+    }
+    if (end_xid > 0 && trx_id_ >= end_xid) {
+      return RC::RECORD_INVISIBLE;
+    }
+    return RC::SUCCESS;
+  }
+
   RC rc = RC::SUCCESS;
-  if (begin_xid > 0 && end_xid > 0) {
+  if (begin_xid >= 0 && end_xid > 0) {
+    // begin xid 为0的数据不是通过事务写入的，只需要检查删除
     if (trx_id_ >= begin_xid && trx_id_ <= end_xid) {
       rc = RC::SUCCESS;
     } else {
@@ -264,27 +336,70 @@ RC MvccTrx::start_if_need()
   return RC::SUCCESS;
 }
 
+RC MvccTrx::start_readonly_if_need()
+{
+  if (!started_) {
+    ASSERT(operations_.empty(), "try to start a new trx while operations is not empty");
+    trx_id_   = trx_kit_.current_trx_id();
+    readonly_ = true;
+    started_  = true;
+    LOG_DEBUG("current thread change to readonly trx with snapshot %d", trx_id_);
+  }
+  return RC::SUCCESS;
+}
+
 RC MvccTrx::commit()
 {
+  if (readonly_) {
+    ASSERT(operations_.empty(), "readonly trx should not have any operation");
+    readonly_ = false;
+    started_  = false;
+    return RC::SUCCESS;
+  }
+
   int32_t commit_id = trx_kit_.next_trx_id();
   return commit_with_trx_id(commit_id);
 }
 
+/**
+ * @brief 将事务的操作按照(表, 页面)分组
+ * @details 提交和回滚时，同一个页面上的记录只需要获取和加锁一次页面。
+ * 使用有序的map，保证按照表和页面的顺序加锁
+ */
+void MvccTrx::group_operations_by_page(PageOperations &page_operations) const
+{
+  for (const Operation &operation : operations_) {
+    PageOperationKey key{operation.table_id(), operation.page_num()};
+    page_operations[key].push_back(&operation);
+  }
+}
+
 RC MvccTrx::commit_with_trx_id(int32_t commit_xid)
 {
   // TODO 这里存在一个很大的问题，不能让其他事务一次性看到当前事务更新到的数据或同时看不到
   RC rc    = RC::SUCCESS;
   started_ = false;
 
-  for (const Operation &operation : operations_) {
-    switch (operation.type()) {
-      case Operation::Type::INSERT: {
-        RID    rid(operation.page_num(), operation.slot_num());
-        Table *table = operation.table();
-        Field  begin_xid_field, end_xid_field;
-        trx_fields(table, begin_xid_field, end_xid_field);
-
-        auto record_updater = [this, &begin_xid_field, commit_xid](Record &record) {
+  PageOperations page_operations;
+  group_operations_by_page(page_operations);
+
+  for (const auto &[key, operations] : page_operations) {
+    Table *table = operations.front()->table();
+    Field  begin_xid_field, end_xid_field;
+    trx_fields(table, begin_xid_field, end_xid_field);
+
+    vector<SlotNum> slot_nums;
+    slot_nums.reserve(operations.size());
+    for (const Operation *operation : operations) {
+      slot_nums.push_back(operation->slot_num());
+    }
+
+    // visit_records 按照 slot_nums 的顺序访问记录，所以这里可以用下标找到对应的操作
+    size_t index          = 0;
+    auto   record_updater = [this, &operations, &index, &begin_xid_field, &end_xid_field, commit_xid](Record &record) {
+      const Operation *operation = operations[index++];
+      switch (operation->type()) {
+        case Operation::Type::INSERT: {
           LOG_DEBUG("before commit insert record. trx id=%d, begin xid=%d, commit xid=%d, lbt=%s",
                     trx_id_, begin_xid_field.get_int(record), commit_xid, lbt());
           ASSERT(begin_xid_field.get_int(record) == -this->trx_id_, 
@@ -292,44 +407,37 @@ RC MvccTrx::commit_with_trx_id(int32_t commit_xid)
                  begin_xid_field.get_int(record), trx_id_);
 
           begin_xid_field.set_int(record, commit_xid);
-        };
+        } break;
 
-        rc = operation.table()->visit_record(rid, false /*readonly*/, record_updater);
-        ASSERT(rc == RC::SUCCESS, "failed to get record while committing. rid=%s, rc=%s",
-               rid.to_string().c_str(), strrc(rc));
-      } break;
-
-      case Operation::Type::DELETE: {
-        Table *table = operation.table();
-        RID    rid(operation.page_num(), operation.slot_num());
-
-        Field begin_xid_field, end_xid_field;
-        trx_fields(table, begin_xid_field, end_xid_field);
-
-        auto record_updater = [this, &end_xid_field, commit_xid](Record &record) {
-          (void)this;
+        case Operation::Type::DELETE: {
           ASSERT(end_xid_field.get_int(record) == -trx_id_, 
                  "got an invalid record while committing. end xid=%d, this trx id=%d", 
                  end_xid_field.get_int(record), trx_id_);
 
           end_xid_field.set_int(record, commit_xid);
-        };
-
-        rc = operation.table()->visit_record(rid, false /*readonly*/, record_updater);
-        ASSERT(rc == RC::SUCCESS, "failed to get record while committing. rid=%s, rc=%s",
-               rid.to_string().c_str(), strrc(rc));
-      } break;
+        } break;
 
-      default: {
-        ASSERT(false, "unsupported operation. type=%d", static_cast<int>(operation.type()));
+        default: {
+          ASSERT(false, "unsupported operation. type=%d", static_cast<int>(operation->type()));
+        }
       }
+    };
+
+    rc = table->visit_records(key.second, slot_nums, false /*readonly*/, record_updater);
+    ASSERT(rc == RC::SUCCESS, "failed to get records while committing. table=%s, page num=%d, rc=%s",
+           table->name(), key.second, strrc(rc));
+
+    int64_t inserts = 0;
+    for (const Operation *operation : operations) {
+      inserts += operation->type() == Operation::Type::INSERT ? 1 : 0;
     }
+    table->add_modifications(inserts, 0, static_cast<int64_t>(operations.size()) - inserts);
   }
 
   operations_.clear();
 
   if (!recovering_) {
-    rc = log_manager_->commit_trx(trx_id_, commit_xid);
+    rc = log_manager_->commit_trx(trx_id_, commit_xid, async_commit_);
   }
   LOG_TRACE("append trx commit log. trx id=%d, commit_xid=%d, rc=%s", trx_id_, commit_xid, strrc(rc));
   return rc;
@@ -340,50 +448,61 @@ RC MvccTrx::rollback()
   RC rc    = RC::SUCCESS;
   started_ = false;
 
-  for (const Operation &operation : operations_) {
-    switch (operation.type()) {
-      case Operation::Type::INSERT: {
-        RID    rid(operation.page_num(), operation.slot_num());
-        Record record;
-        Table *table = operation.table();
-        // TODO 这里虽然调用get_record好像多次一举，而且看起来放在table的实现中更好，
-        // 而且实际上trx应该记录下来自己曾经插入过的数据
-        // 也就是不需要从table中获取这条数据，可以直接从当前内存中获取
-        // 这里也可以不删除，仅仅给数据加个标识位，等垃圾回收器来收割也行
-        rc = table->get_record(rid, record);
-        ASSERT(rc == RC::SUCCESS, "failed to get record while rollback. rid=%s, rc=%s", 
-               rid.to_string().c_str(), strrc(rc));
-        rc = table->delete_record(record);
-        ASSERT(rc == RC::SUCCESS, "failed to delete record while rollback. rid=%s, rc=%s",
-              rid.to_string().c_str(), strrc(rc));
-      } break;
-
-      case Operation::Type::DELETE: {
-        Table *table = operation.table();
-        RID    rid(operation.page_num(), operation.slot_num());
-
-        ASSERT(rc == RC::SUCCESS, "failed to get record while rollback. rid=%s, rc=%s",
-              rid.to_string().c_str(), strrc(rc));
-        Field begin_xid_field, end_xid_field;
-        trx_fields(table, begin_xid_field, end_xid_field);
-
-        auto record_updater = [this, &end_xid_field](Record &record) {
-          ASSERT(end_xid_field.get_int(record) == -trx_id_, 
-                "got an invalid record while rollback. end xid=%d, this trx id=%d", 
-                end_xid_field.get_int(record), trx_id_);
+  if (readonly_) {
+    ASSERT(operations_.empty(), "readonly trx should not have any operation");
+    readonly_ = false;
+    return RC::SUCCESS;
+  }
+
+  PageOperations page_operations;
+  group_operations_by_page(page_operations);
+
+  for (const auto &[key, operations] : page_operations) {
+    Table *table = operations.front()->table();
 
-          end_xid_field.set_int(record, trx_kit_.max_trx_id());
-        };
+    vector<SlotNum> inserted_slot_nums;
+    vector<SlotNum> deleted_slot_nums;
+    for (const Operation *operation : operations) {
+      switch (operation->type()) {
+        case Operation::Type::INSERT: {
+          inserted_slot_nums.push_back(operation->slot_num());
+        } break;
 
-        rc = table->visit_record(rid, false /*readonly*/, record_updater);
-        ASSERT(rc == RC::SUCCESS, "failed to get record while committing. rid=%s, rc=%s",
-               rid.to_string().c_str(), strrc(rc));
-      } break;
+        case Operation::Type::DELETE: {
+          deleted_slot_nums.push_back(operation->slot_num());
+        } break;
 
-      default: {
-        ASSERT(false, "unsupported operation. type=%d", static_cast<int>(operation.type()));
+        default: {
+          ASSERT(false, "unsupported operation. type=%d", static_cast<int>(operation->type()));
+        }
       }
     }
+
+    // 插入的记录直接删掉。同一个页面上的记录在一次加锁中处理，与提交时一样
+    if (!inserted_slot_nums.empty()) {
+      rc = table->delete_records(key.second, inserted_slot_nums);
+      ASSERT(rc == RC::SUCCESS, "failed to delete records while rollback. table=%s, page num=%d, rc=%s",
+             table->name(), key.second, strrc(rc));
+    }
+
+    if (deleted_slot_nums.empty()) {
+      continue;
+    }
+
+    Field begin_xid_field, end_xid_field;
+    trx_fields(table, begin_xid_field, end_xid_field);
+
+    auto record_updater = [this, &end_xid_field](Record &record) {
+      ASSERT(end_xid_field.get_int(record) == -trx_id_, 
+            "got an invalid record while rollback. end xid=%d, this trx id=%d", 
+            end_xid_field.get_int(record), trx_id_);
+
+      end_xid_field.set_int(record, trx_kit_.max_trx_id());
+    };
+
+    rc = table->visit_records(key.second, deleted_slot_nums, false /*readonly*/, record_updater);
+    ASSERT(rc == RC::SUCCESS, "failed to get records while rollback. table=%s, page num=%d, rc=%s",
+           table->name(), key.second, strrc(rc));
   }
 
   operations_.clear();
@@ -446,7 +565,7 @@ RC MvccTrx::redo(Db *db, const CLogRecord &log_record)
 
       auto record_updater = [this, &end_field](Record &record) {
         (void)this;
-        ASSERT(end_field.get_int(record) == trx_kit_.max_trx_id(), 
+        ASSERT(is_latest_version(end_field.get_int(record)), 
                "got an invalid record while committing. end xid=%d, this trx id=%d", 
                end_field.get_int(record), trx_id_);
 
@@ -462,6 +581,7 @@ RC MvccTrx::redo(Db *db, const CLogRecord &log_record)
 
     case CLogType::MTR_COMMIT: {
       const CLogRecordCommitData &commit_record = log_record.commit_record();
+      trx_kit_.advance_trx_id(commit_record.commit_xid_);
       commit_with_trx_id(commit_record.commit_xid_);
     } break;
 
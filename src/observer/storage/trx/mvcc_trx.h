@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <map>
 #include <vector>
 
 #include "storage/trx/trx.h"
@@ -42,6 +43,18 @@ public:
 public:
   int32_t next_trx_id();
 
+  /**
+   * @brief 当前已经分配出去的最大事务号
+   * @details 只读事务使用它作为快照，不消耗新的事务号
+   */
+  int32_t current_trx_id() const { return current_trx_id_.load(); }
+
+  /**
+   * @brief 保证后续分配的事务号比指定的事务号大
+   * @details 恢复时提交事务号也需要计入，否则重启后的快照看不到已经提交的数据
+   */
+  void advance_trx_id(int32_t trx_id);
+
 public:
   int32_t max_trx_id() const;
 
@@ -84,26 +97,42 @@ public:
   RC visit_record(Table *table, Record &record, bool readonly) override;
 
   RC start_if_need() override;
+  RC start_readonly_if_need() override;
   RC commit() override;
   RC rollback() override;
 
   RC redo(Db *db, const CLogRecord &log_record) override;
 
+  void set_async_commit(bool async_commit) override { async_commit_ = async_commit; }
+
   int32_t id() const override { return trx_id_; }
 
 private:
+  /// (表ID, 页面编号) -> 这个页面上的操作
+  using PageOperationKey = std::pair<int32_t, PageNum>;
+  using PageOperations   = std::map<PageOperationKey, std::vector<const Operation *>>;
+
   RC   commit_with_trx_id(int32_t commit_id);
+  void group_operations_by_page(PageOperations &page_operations) const;
   void trx_fields(Table *table, Field &begin_xid_field, Field &end_xid_field) const;
 
+  /**
+   * @brief 记录是不是最新的版本(没有被删除)
+   * @details 不经过事务写入的数据(比如 load data 导入的)事务号都是0，end xid 为0与 max_trx_id 一样表示没有删除
+   */
+  bool is_latest_version(int32_t end_xid) const { return end_xid == trx_kit_.max_trx_id() || end_xid == 0; }
+
 private:
   static const int32_t MAX_TRX_ID = std::numeric_limits<int32_t>::max();
 
 private:
   using OperationSet = std::unordered_set<Operation, OperationHasher, OperationEqualer>;
   MvccTrxKit  &trx_kit_;
-  CLogManager *log_manager_ = nullptr;
-  int32_t      trx_id_      = -1;
-  bool         started_     = false;
-  bool         recovering_  = false;
+  CLogManager *log_manager_  = nullptr;
+  int32_t      trx_id_       = -1;
+  bool         started_      = false;
+  bool         recovering_   = false;
+  bool         readonly_     = false;  ///< 只读快照事务，trx_id_ 是快照而不是分配的事务号
+  bool         async_commit_ = false;  ///< 提交时不等待日志刷盘
   OperationSet operations_;
 };
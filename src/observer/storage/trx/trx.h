@@ -143,10 +143,23 @@ public:
   virtual RC update_record(Table *table, Field *field, const Value *value, Record &record) = 0;
   virtual RC visit_record(Table *table, Record &record, bool readonly)                     = 0;
   virtual RC start_if_need()                                                               = 0;
+
+  /**
+   * @brief 以只读快照的方式启动事务
+   * @details 只读事务不分配事务号、不写日志，提交和回滚也不会产生任何开销。
+   * 默认实现与start_if_need相同，具体的事务模型可以按需优化
+   */
+  virtual RC start_readonly_if_need() { return start_if_need(); }
   virtual RC commit()                                                                      = 0;
   virtual RC rollback()                                                                    = 0;
 
   virtual RC redo(Db *db, const CLogRecord &log_record);
 
+  /**
+   * @brief 设置事务是否异步提交
+   * @details 异步提交时，提交日志写入缓存就返回，不等待日志刷盘。参考 CLogManager
+   */
+  virtual void set_async_commit(bool async_commit) {}
+
   virtual int32_t id() const = 0;
 };
@@ -32,16 +32,34 @@ void VacuousTrxKit::all_trxes(std::vector<Trx *> &trxes) { return; }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-RC VacuousTrx::insert_record(Table *table, Record &record) { return table->insert_record(record); }
+RC VacuousTrx::insert_record(Table *table, Record &record)
+{
+  RC rc = table->insert_record(record);
+  if (OB_SUCC(rc)) {
+    table->add_modifications(1, 0, 0);
+  }
+  return rc;
+}
 
-RC VacuousTrx::delete_record(Table *table, Record &record) { return table->delete_record(record); }
+RC VacuousTrx::delete_record(Table *table, Record &record)
+{
+  RC rc = table->delete_record(record);
+  if (OB_SUCC(rc)) {
+    table->add_modifications(0, 0, 1);
+  }
+  return rc;
+}
 
 // maybe can optimize to this
 RC VacuousTrx::update_record(Table *table, Record &record) { return table->delete_record(record); }
 
 RC VacuousTrx::update_record(Table *table, Field *field, const Value *value, Record &record)
 {
-  return table->update_record(record, field, value);
+  RC rc = table->update_record(record, field, value);
+  if (OB_SUCC(rc)) {
+    table->add_modifications(0, 1, 0);
+  }
+  return rc;
 }
 
 RC VacuousTrx::visit_record(Table *table, Record &record, bool readonly) { return RC::SUCCESS; }
@@ -0,0 +1,190 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <vector>
+
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/index/bplus_tree.h"
+
+using namespace std;
+using namespace common;
+
+// [begin, end) 中每隔 step 取一个值，RID 的槽位号就是这个值，返回排好序的规范化键值
+static vector<char> make_keys(const KeyNormalizer &normalizer, int begin, int end, int step)
+{
+  vector<char> keys;
+  for (int32_t i = begin; i < end; i += step) {
+    keys.resize(keys.size() + normalizer.key_length());
+    normalizer.normalize(reinterpret_cast<const char *>(&i), RID(1, i), keys.data() + keys.size() - normalizer.key_length());
+  }
+  return keys;
+}
+
+static vector<int> scan_all(BplusTreeHandler &handler)
+{
+  vector<int>      values;
+  BplusTreeScanner scanner(handler);
+  EXPECT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, true, nullptr, 0, true));
+  RID rid;
+  while (scanner.next_entry(rid) == RC::SUCCESS) {
+    values.push_back(rid.slot_num);
+  }
+  return values;
+}
+
+TEST(bplus_tree_entries, insert_and_delete)
+{
+  const char *index_name = "bplus_tree_entries_test.btree";
+  ::remove(index_name);
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, INTS, sizeof(int32_t), 5 /*internal max size*/, 5 /*leaf max size*/));
+  handler.set_unique(0);
+  const KeyNormalizer &normalizer = handler.key_normalizer();
+  const int            key_length = normalizer.key_length();
+
+  // 先逐条插入一部分，批量插入的键值要穿插到已有的叶子节点中，还会引起很多次分裂
+  for (int32_t i = 0; i < 300; i += 3) {
+    const RID rid(1, i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&i), &rid));
+  }
+  vector<char> keys = make_keys(normalizer, 1, 1000, 3);
+  ASSERT_EQ(RC::SUCCESS, handler.insert_entries(keys.data(), static_cast<int>(keys.size()) / key_length));
+  ASSERT_TRUE(handler.validate_tree());
+
+  vector<int> expected;
+  for (int i = 0; i < 1000; i++) {
+    if ((i < 300 && i % 3 == 0) || i % 3 == 1) {
+      expected.push_back(i);
+    }
+  }
+  ASSERT_EQ(expected, scan_all(handler));
+
+  // 删除所有的偶数，其中一部分不存在
+  keys = make_keys(normalizer, 0, 1000, 2);
+  ASSERT_EQ(RC::SUCCESS, handler.delete_entries(keys.data(), static_cast<int>(keys.size()) / key_length));
+  ASSERT_TRUE(handler.validate_tree());
+  vector<int> odd;
+  for (int i : expected) {
+    if (i % 2 == 1) {
+      odd.push_back(i);
+    }
+  }
+  ASSERT_EQ(odd, scan_all(handler));
+
+  // 全部删除之后再批量插入，从空树开始
+  keys = make_keys(normalizer, 0, 1000, 1);
+  ASSERT_EQ(RC::SUCCESS, handler.delete_entries(keys.data(), static_cast<int>(keys.size()) / key_length));
+  ASSERT_TRUE(scan_all(handler).empty());
+  ASSERT_EQ(RC::SUCCESS, handler.insert_entries(keys.data(), static_cast<int>(keys.size()) / key_length));
+  ASSERT_TRUE(handler.validate_tree());
+  ASSERT_EQ(1000, static_cast<int>(scan_all(handler).size()));
+  handler.close();
+}
+
+TEST(bplus_tree_entries, unique)
+{
+  const char *index_name = "bplus_tree_entries_test.btree";
+  ::remove(index_name);
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, INTS, sizeof(int32_t), 5 /*internal max size*/, 5 /*leaf max size*/));
+  handler.set_unique(1);
+
+  // 同一批中字段值相同的两个键值排在一起
+  const KeyNormalizer &normalizer = handler.key_normalizer();
+  vector<char>         keys       = make_keys(normalizer, 0, 10, 1);
+  const int32_t        value      = 5;
+  keys.resize(keys.size() + normalizer.key_length());
+  normalizer.normalize(reinterpret_cast<const char *>(&value), RID(2, 0), keys.data() + keys.size() - normalizer.key_length());
+  const int count = static_cast<int>(keys.size()) / normalizer.key_length();
+
+  ASSERT_EQ(RC::SUCCESS, handler.insert_entries(keys.data(), count - 1));
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler.insert_entries(keys.data() + (count - 1) * normalizer.key_length(), 1));
+  handler.close();
+}
+
+// 倒序扫描 [left, right] 范围，left/right 为空表示没有边界
+static vector<int> scan_reverse(
+    BplusTreeHandler &handler, const int32_t *left, bool left_inclusive, const int32_t *right, bool right_inclusive)
+{
+  vector<int>      values;
+  BplusTreeScanner scanner(handler);
+  scanner.set_reverse(true);
+  EXPECT_EQ(RC::SUCCESS,
+      scanner.open(reinterpret_cast<const char *>(left), sizeof(int32_t), left_inclusive,
+                   reinterpret_cast<const char *>(right), sizeof(int32_t), right_inclusive));
+  RID rid;
+  while (scanner.next_entry(rid) == RC::SUCCESS) {
+    values.push_back(rid.slot_num);
+  }
+  scanner.close();
+  return values;
+}
+
+TEST(bplus_tree_entries, reverse_scan)
+{
+  const char *index_name = "bplus_tree_entries_test.btree";
+  ::remove(index_name);
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, INTS, sizeof(int32_t), 5 /*internal max size*/, 5 /*leaf max size*/));
+  handler.set_unique(0);
+
+  // 删除一段连续的键值和所有 3 的倍数，留下空的范围和不满的叶子节点
+  vector<int> values;
+  for (int32_t i = 1; i < 200; i += 2) {
+    const RID rid(1, i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&i), &rid));
+  }
+  for (int32_t i = 1; i < 200; i += 2) {
+    if ((i > 100 && i < 150) || i % 3 == 0) {
+      const RID rid(1, i);
+      ASSERT_EQ(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&i), &rid));
+    } else {
+      values.push_back(i);
+    }
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  auto expect = [&values](int left, bool left_inclusive, int right, bool right_inclusive) {
+    vector<int> result;
+    for (auto iter = values.rbegin(); iter != values.rend(); ++iter) {
+      if ((left_inclusive ? *iter >= left : *iter > left) && (right_inclusive ? *iter <= right : *iter < right)) {
+        result.push_back(*iter);
+      }
+    }
+    return result;
+  };
+
+  ASSERT_EQ(vector<int>(values.rbegin(), values.rend()), scan_reverse(handler, nullptr, true, nullptr, true));
+  for (int32_t bound = -1; bound <= 201; bound++) {
+    ASSERT_EQ(expect(INT32_MIN, true, bound, true), scan_reverse(handler, nullptr, true, &bound, true)) << bound;
+    ASSERT_EQ(expect(INT32_MIN, true, bound, false), scan_reverse(handler, nullptr, true, &bound, false)) << bound;
+    ASSERT_EQ(expect(bound, true, INT32_MAX, true), scan_reverse(handler, &bound, true, nullptr, true)) << bound;
+    ASSERT_EQ(expect(bound, false, INT32_MAX, true), scan_reverse(handler, &bound, false, nullptr, true)) << bound;
+  }
+
+  const int32_t left = 11, right = 91, single = 95;
+  ASSERT_EQ(expect(left, true, right, true), scan_reverse(handler, &left, true, &right, true));
+  ASSERT_EQ(expect(left, false, right, false), scan_reverse(handler, &left, false, &right, false));
+  ASSERT_EQ(expect(single, true, single, true), scan_reverse(handler, &single, true, &single, true));
+  handler.close();
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("bplus_tree_entries_test.log", LOG_LEVEL_INFO);
+  BufferPoolManager::set_instance(new BufferPoolManager());
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,517 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/index/bplus_tree.h"
+
+using namespace std;
+using namespace common;
+
+/**
+ * @brief 读取B+树内部的结构，检查节点的前缀和文件头
+ */
+class BplusTreeTester
+{
+public:
+  struct NodeInfo
+  {
+    bool leaf;
+    int  size;
+    int  prefix_length;
+    int  fence_prefix_length;  ///< 两个边界键值的公共前缀长度，缺少边界时是-1
+  };
+
+  static const IndexFileHeader &file_header(BplusTreeHandler &handler) { return handler.file_header_; }
+
+  static void collect(BplusTreeHandler &handler, vector<NodeInfo> &nodes)
+  {
+    nodes.clear();
+    if (!handler.is_empty()) {
+      collect_recursive(handler, handler.file_header_.root_page, nullptr, nullptr, nodes);
+    }
+  }
+
+private:
+  static void collect_recursive(
+      BplusTreeHandler &handler, PageNum page_num, const char *lower, const char *upper, vector<NodeInfo> &nodes)
+  {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, handler.disk_buffer_pool_->get_this_page(page_num, &frame));
+
+    const IndexFileHeader &header     = handler.file_header_;
+    const int              key_length = header.key_length;
+    IndexNodeHandler       node(header, frame);
+
+    NodeInfo info;
+    info.leaf                = node.is_leaf();
+    info.size                = node.size();
+    info.prefix_length       = node.prefix_length();
+    info.fence_prefix_length = -1;
+    if (lower != nullptr && upper != nullptr) {
+      info.fence_prefix_length = IndexNodeHandler::common_prefix_length(lower, upper, key_length);
+    }
+    nodes.push_back(info);
+
+    if (!node.is_leaf()) {
+      InternalIndexNodeHandler internal_node(header, frame);
+      vector<char>             child_lower(key_length);
+      vector<char>             child_upper(key_length);
+      for (int i = 0; i < internal_node.size(); i++) {
+        if (i > 0) {
+          internal_node.get_key(i, child_lower.data());
+        }
+        if (i < internal_node.size() - 1) {
+          internal_node.get_key(i + 1, child_upper.data());
+        }
+        collect_recursive(handler,
+            internal_node.value_at(i),
+            i > 0 ? child_lower.data() : lower,
+            i < internal_node.size() - 1 ? child_upper.data() : upper,
+            nodes);
+      }
+    }
+
+    handler.disk_buffer_pool_->unpin_page(frame);
+  }
+};
+
+// 两个键值规范化编码之后 memcmp 的结果，只保留符号
+static int compare_normalized(const KeyNormalizer &normalizer, const char *v1, const RID &rid1, const char *v2, const RID &rid2)
+{
+  vector<char> k1(normalizer.key_length());
+  vector<char> k2(normalizer.key_length());
+  normalizer.normalize(v1, rid1, k1.data());
+  normalizer.normalize(v2, rid2, k2.data());
+  const int result = memcmp(k1.data(), k2.data(), k1.size());
+  return result < 0 ? -1 : (result > 0 ? 1 : 0);
+}
+
+TEST(bplus_tree_format, normalize_numbers)
+{
+  KeyNormalizer int_normalizer;
+  int_normalizer.init({INTS}, {sizeof(int32_t)});
+  const vector<int32_t> ints = {INT32_MIN, -65536, -256, -1, 0, 1, 255, 256, 65536, INT32_MAX};
+  for (size_t i = 0; i < ints.size(); i++) {
+    for (size_t j = 0; j < ints.size(); j++) {
+      const int expected = i < j ? -1 : (i > j ? 1 : 0);
+      ASSERT_EQ(expected,
+          compare_normalized(int_normalizer, (const char *)&ints[i], RID(1, 1), (const char *)&ints[j], RID(1, 1)))
+          << ints[i] << " vs " << ints[j];
+    }
+
+    // 字段值相同时按照 RID 排序
+    ASSERT_EQ(-1, compare_normalized(int_normalizer, (const char *)&ints[i], RID(1, 2), (const char *)&ints[i], RID(2, 1)));
+    ASSERT_EQ(-1, compare_normalized(int_normalizer, (const char *)&ints[i], RID(1, 1), (const char *)&ints[i], RID(1, 2)));
+
+    char    key[sizeof(int32_t) + sizeof(RID)];
+    int32_t value = 0;
+    RID     rid;
+    int_normalizer.normalize((const char *)&ints[i], RID(3, 4), key);
+    int_normalizer.denormalize(key, (char *)&value, rid);
+    ASSERT_EQ(ints[i], value);
+    ASSERT_EQ(3, rid.page_num);
+    ASSERT_EQ(4, rid.slot_num);
+  }
+
+  KeyNormalizer float_normalizer;
+  float_normalizer.init({FLOATS}, {sizeof(float)});
+  const vector<float> floats = {
+      -INFINITY, -1e30f, -2.5f, -1.0f, -1e-30f, 0.0f, 1e-30f, 1.0f, 1.5f, 2.5f, 1e30f, INFINITY};
+  for (size_t i = 0; i < floats.size(); i++) {
+    for (size_t j = 0; j < floats.size(); j++) {
+      const int expected = i < j ? -1 : (i > j ? 1 : 0);
+      ASSERT_EQ(expected,
+          compare_normalized(
+              float_normalizer, (const char *)&floats[i], RID(1, 1), (const char *)&floats[j], RID(1, 1)))
+          << floats[i] << " vs " << floats[j];
+    }
+  }
+
+  // -0.0 与 0.0 相等
+  const float negative_zero = -0.0f;
+  const float zero          = 0.0f;
+  ASSERT_EQ(0, compare_normalized(float_normalizer, (const char *)&negative_zero, RID(1, 1), (const char *)&zero, RID(1, 1)));
+}
+
+TEST(bplus_tree_format, normalize_chars)
+{
+  KeyNormalizer normalizer;
+  normalizer.init({CHARS}, {8});
+
+  // '\0' 后面残留的内容不参与比较
+  const char clean[8]   = {'a', 'b', 'c', 0, 0, 0, 0, 0};
+  const char garbage[8] = {'a', 'b', 'c', 0, 'x', 'y', 'z', 0};
+  ASSERT_EQ(0, compare_normalized(normalizer, clean, RID(1, 1), garbage, RID(1, 1)));
+
+  const char shorter[8] = {'a', 'b', 0, 'z', 'z', 'z', 'z', 'z'};
+  const char longer[8]  = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'};  // 占满整个字段，没有'\0'
+  const char prefix[8]  = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 0};
+  ASSERT_EQ(-1, compare_normalized(normalizer, shorter, RID(1, 1), garbage, RID(1, 1)));
+  ASSERT_EQ(-1, compare_normalized(normalizer, garbage, RID(1, 1), longer, RID(1, 1)));
+  ASSERT_EQ(-1, compare_normalized(normalizer, prefix, RID(1, 1), longer, RID(1, 1)));
+  ASSERT_EQ(1, compare_normalized(normalizer, longer, RID(1, 1), shorter, RID(1, 1)));
+
+  // 还原之后'\0'后面都是0
+  char key[8 + sizeof(RID)];
+  char value[8];
+  RID  rid;
+  normalizer.normalize(garbage, RID(1, 1), key);
+  normalizer.denormalize(key, value, rid);
+  ASSERT_EQ(0, memcmp(clean, value, sizeof(value)));
+
+  // 多个字段时先比较前面的字段
+  KeyNormalizer multi_normalizer;
+  multi_normalizer.init({INTS, CHARS}, {sizeof(int32_t), 4});
+  auto make_value = [](int32_t i, const char *s) {
+    string value(sizeof(int32_t) + 4, '\0');
+    memcpy(value.data(), &i, sizeof(i));
+    memcpy(value.data() + sizeof(i), s, std::min<size_t>(strlen(s), 4));
+    return value;
+  };
+  const vector<string> values = {make_value(-1, "zz"), make_value(0, ""), make_value(0, "a"), make_value(0, "ab"),
+      make_value(0, "b"), make_value(1, "")};
+  for (size_t i = 0; i + 1 < values.size(); i++) {
+    ASSERT_EQ(-1, compare_normalized(multi_normalizer, values[i].data(), RID(1, 1), values[i + 1].data(), RID(1, 1))) << i;
+  }
+}
+
+static vector<int> scan_all(BplusTreeHandler &handler)
+{
+  vector<int>      values;
+  BplusTreeScanner scanner(handler);
+  EXPECT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, true, nullptr, 0, true));
+  RID rid;
+  while (scanner.next_entry(rid) == RC::SUCCESS) {
+    values.push_back(rid.slot_num);
+  }
+  return values;
+}
+
+TEST(bplus_tree_format, ordered_scan)
+{
+  const char *index_name = "bplus_tree_format_test.btree";
+  ::remove(index_name);
+
+  // 正负数交替插入，扫描出来的顺序与数值顺序一致
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, FLOATS, sizeof(float), 5 /*internal max size*/, 5 /*leaf max size*/));
+  handler.set_unique(0);
+
+  vector<float> values;
+  for (int i = 0; i < 200; i++) {
+    const float value = (i % 2 == 0 ? -1.0f : 1.0f) * (i * 0.25f + (i % 7) * 100.0f);
+    const RID   rid(1, i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+    values.push_back(value);
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  vector<int> expected(values.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    expected[i] = static_cast<int>(i);
+  }
+  std::stable_sort(expected.begin(), expected.end(), [&values](int a, int b) { return values[a] < values[b]; });
+  ASSERT_EQ(expected, scan_all(handler));
+
+  // 范围扫描的边界也要先规范化
+  const float   left = -300.0f, right = 150.5f;
+  vector<int>   range;
+  for (int i : expected) {
+    if (values[i] >= left && values[i] < right) {
+      range.push_back(i);
+    }
+  }
+  vector<int> result;
+  {
+    BplusTreeScanner scanner(handler);
+    ASSERT_EQ(RC::SUCCESS,
+        scanner.open(reinterpret_cast<const char *>(&left), sizeof(left), true,
+                     reinterpret_cast<const char *>(&right), sizeof(right), false));
+    RID rid;
+    while (scanner.next_entry(rid) == RC::SUCCESS) {
+      result.push_back(rid.slot_num);
+    }
+    scanner.close();
+  }
+  ASSERT_EQ(range, result);
+  handler.close();
+
+  // 字符串'\0'后面的内容不同，依然是同一个键值
+  ::remove(index_name);
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, CHARS, 8, 5 /*internal max size*/, 5 /*leaf max size*/));
+  handler.set_unique(1);
+  const char key1[8] = {'k', 'e', 'y', 0, 'a', 'b', 'c', 'd'};
+  const char key2[8] = {'k', 'e', 'y', 0, 'x', 0, 0, 0};
+  const RID  rid1(1, 1), rid2(1, 2);
+  ASSERT_EQ(RC::SUCCESS, handler.insert_entry(key1, &rid1));
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler.insert_entry(key2, &rid2));
+
+  list<RID> rids;
+  ASSERT_EQ(RC::SUCCESS, handler.get_entry("key", 3, rids));
+  ASSERT_EQ(1, static_cast<int>(rids.size()));
+  ASSERT_EQ(1, rids.front().slot_num);
+  handler.close();
+}
+
+// 有很长公共前缀的字符串键值，分成几组，组之间的前缀不同
+static string prefix_key(int i)
+{
+  static const char *groups[] = {"customer_account_", "customer_address_", "order_line_item_"};
+  char               buf[64];
+  snprintf(buf, sizeof(buf), "%s%06d", groups[i % 3], i / 3);
+  string key(buf);
+  key.resize(32, '\0');
+  return key;
+}
+
+/**
+ * @brief 检查每个节点的前缀都不超过两个边界键值的公共前缀，没有边界的节点不提取前缀
+ * @param[out] fenced 有两个边界的节点个数
+ * @param[out] full 前缀正好是两个边界键值公共前缀的节点个数
+ */
+static void check_prefix(BplusTreeHandler &handler, int &fenced, int &full)
+{
+  fenced = 0;
+  full   = 0;
+  ASSERT_TRUE(handler.validate_tree());
+
+  vector<BplusTreeTester::NodeInfo> nodes;
+  BplusTreeTester::collect(handler, nodes);
+  for (const BplusTreeTester::NodeInfo &node : nodes) {
+    if (node.fence_prefix_length < 0) {
+      ASSERT_EQ(0, node.prefix_length);
+    } else {
+      ASSERT_LE(node.prefix_length, node.fence_prefix_length);
+      fenced++;
+      full += node.prefix_length == node.fence_prefix_length ? 1 : 0;
+    }
+    ASSERT_LE(node.size, IndexNodeHandler::max_size_of(BplusTreeTester::file_header(handler), node.leaf, node.prefix_length));
+  }
+}
+
+TEST(bplus_tree_format, prefix_maintenance)
+{
+  const char *index_name = "bplus_tree_format_test.btree";
+  ::remove(index_name);
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, CHARS, 32, 5 /*internal max size*/, 5 /*leaf max size*/));
+  handler.set_unique(0);
+
+  // 分裂出来的两个节点的前缀扩展成新的边界键值的公共前缀。父节点分裂时，原来在边上的子节点多了一个边界，
+  // 前缀不会马上扩展，所以不是所有的节点前缀都是最长的
+  const int count  = 600;
+  int       fenced = 0;
+  int       full   = 0;
+  for (int i = 0; i < count; i++) {
+    const string key = prefix_key(i);
+    const RID    rid(1, i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(key.data(), &rid));
+    if (i % 50 == 0) {
+      check_prefix(handler, fenced, full);
+    }
+  }
+  check_prefix(handler, fenced, full);
+  ASSERT_GT(full * 10, fenced * 9);
+
+  vector<BplusTreeTester::NodeInfo> nodes;
+  BplusTreeTester::collect(handler, nodes);
+  const size_t node_count        = nodes.size();
+  const int    long_prefix_nodes = static_cast<int>(std::count_if(nodes.begin(), nodes.end(),
+      [](const BplusTreeTester::NodeInfo &node) { return node.prefix_length >= (int)strlen("customer_account_"); }));
+  ASSERT_GT(long_prefix_nodes, 0);
+
+  // 删除会引起合并和重新分配，合并之后前缀缩短为公共部分，始终不能超出边界键值的公共前缀
+  vector<int> remaining;
+  for (int i = 0; i < count; i++) {
+    if (i % 5 == 0 || (i > 200 && i < 400)) {
+      const string key = prefix_key(i);
+      const RID    rid(1, i);
+      ASSERT_EQ(RC::SUCCESS, handler.delete_entry(key.data(), &rid));
+      check_prefix(handler, fenced, full);
+    } else {
+      remaining.push_back(i);
+    }
+  }
+
+  BplusTreeTester::collect(handler, nodes);
+  ASSERT_LT(nodes.size(), node_count);
+
+  std::sort(remaining.begin(), remaining.end(), [](int a, int b) { return prefix_key(a) < prefix_key(b); });
+  ASSERT_EQ(remaining, scan_all(handler));
+
+  // 前缀变短之后再插入其它分组的键值
+  for (int i = 201; i < 400; i += 2) {
+    const string key = prefix_key(i);
+    const RID    rid(1, i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(key.data(), &rid));
+    remaining.push_back(i);
+  }
+  check_prefix(handler, fenced, full);
+  std::sort(remaining.begin(), remaining.end(), [](int a, int b) { return prefix_key(a) < prefix_key(b); });
+  ASSERT_EQ(remaining, scan_all(handler));
+  handler.close();
+}
+
+/**
+ * @brief 按照老版本的格式写一棵两层的树：一个根节点和两个叶子节点，键值是字段原始值加上RID
+ * @details 版本0的节点页头后面有父节点的页号，版本1去掉了父节点页号。文件头中的最大项数是按照页面大小计算出来的
+ */
+static void write_old_format_tree(const char *index_name, int version, const vector<int32_t> &values)
+{
+  ::remove(index_name);
+  {
+    BplusTreeHandler handler;
+    ASSERT_EQ(RC::SUCCESS, handler.create(index_name, INTS, sizeof(int32_t)));
+    handler.close();
+  }
+
+  BufferPoolManager &bpm = BufferPoolManager::instance();
+  DiskBufferPool    *bp  = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(index_name, bp));
+
+  Frame *header_frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bp->get_this_page(1, &header_frame));
+  IndexFileHeader *header = reinterpret_cast<IndexFileHeader *>(header_frame->data());
+
+  const int parent_size = version < 1 ? sizeof(PageNum) : 0;
+  const int key_length  = header->key_length;
+
+  Frame *leaf_frames[2] = {nullptr, nullptr};
+  Frame *root_frame     = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&leaf_frames[0]));
+  ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&leaf_frames[1]));
+  ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&root_frame));
+
+  auto write_header = [parent_size](char *data, bool leaf, int key_num, PageNum parent) {
+    memset(data, 0, BP_PAGE_DATA_SIZE);
+    IndexNode *node = reinterpret_cast<IndexNode *>(data);
+    node->is_leaf   = leaf;
+    node->key_num   = key_num;
+    if (parent_size > 0) {
+      memcpy(data + IndexNode::HEADER_SIZE, &parent, sizeof(parent));
+    }
+    return data + IndexNode::HEADER_SIZE + parent_size;
+  };
+
+  const int half = static_cast<int>(values.size()) / 2;
+  for (int l = 0; l < 2; l++) {
+    const int begin = l == 0 ? 0 : half;
+    const int end   = l == 0 ? half : static_cast<int>(values.size());
+
+    char         *pos  = write_header(leaf_frames[l]->data(), true, end - begin, root_frame->page_num());
+    const PageNum next = l == 0 ? leaf_frames[1]->page_num() : BP_INVALID_PAGE_NUM;
+    memcpy(pos, &next, sizeof(next));
+    pos += sizeof(next);
+    for (int i = begin; i < end; i++) {
+      const RID rid(1, i);
+      memcpy(pos, &values[i], sizeof(int32_t));
+      memcpy(pos + sizeof(int32_t), &rid, sizeof(rid));
+      memcpy(pos + key_length, &rid, sizeof(rid));
+      pos += key_length + sizeof(RID);
+    }
+    leaf_frames[l]->mark_dirty();
+  }
+
+  // 内部节点的第一个键值是无效的，第二个键值是右边叶子节点的第一个键值
+  char         *pos       = write_header(root_frame->data(), false, 2, BP_INVALID_PAGE_NUM);
+  const PageNum left_leaf = leaf_frames[0]->page_num();
+  memcpy(pos + key_length, &left_leaf, sizeof(left_leaf));
+  pos += key_length + sizeof(PageNum);
+  const RID     separator_rid(1, half);
+  const PageNum right_leaf = leaf_frames[1]->page_num();
+  memcpy(pos, &values[half], sizeof(int32_t));
+  memcpy(pos + sizeof(int32_t), &separator_rid, sizeof(separator_rid));
+  memcpy(pos + key_length, &right_leaf, sizeof(right_leaf));
+  root_frame->mark_dirty();
+
+  header->root_page         = root_frame->page_num();
+  header->format_version    = version;
+  header->internal_max_size = (BP_PAGE_DATA_SIZE - InternalIndexNode::HEADER_SIZE - parent_size) / (key_length + sizeof(PageNum));
+  header->leaf_max_size     = (BP_PAGE_DATA_SIZE - LeafIndexNode::HEADER_SIZE - parent_size) / (key_length + sizeof(RID));
+  header_frame->mark_dirty();
+
+  bp->unpin_page(leaf_frames[0]);
+  bp->unpin_page(leaf_frames[1]);
+  bp->unpin_page(root_frame);
+  bp->unpin_page(header_frame);
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(index_name));
+}
+
+TEST(bplus_tree_format, upgrade_old_format)
+{
+  const char *index_name = "bplus_tree_format_test.btree";
+
+  // 老版本中键值按照字段原始值比较，负数排在前面
+  vector<int32_t> values;
+  for (int32_t i = -100; i < 100; i += 2) {
+    values.push_back(i * 1000);
+  }
+
+  for (int version : {0, 1}) {
+    write_old_format_tree(index_name, version, values);
+
+    BplusTreeHandler handler;
+    ASSERT_EQ(RC::SUCCESS, handler.open(index_name)) << version;
+    ASSERT_EQ(IndexFileHeader::CURRENT_FORMAT_VERSION, BplusTreeTester::file_header(handler).format_version);
+    ASSERT_EQ(0, BplusTreeTester::file_header(handler).internal_max_size);
+    ASSERT_EQ(0, BplusTreeTester::file_header(handler).leaf_max_size);
+    ASSERT_TRUE(handler.validate_tree()) << version;
+
+    vector<int> expected;
+    for (int i = 0; i < static_cast<int>(values.size()); i++) {
+      expected.push_back(i);
+    }
+    ASSERT_EQ(expected, scan_all(handler)) << version;
+
+    list<RID> rids;
+    ASSERT_EQ(RC::SUCCESS, handler.get_entry(reinterpret_cast<const char *>(&values[10]), sizeof(int32_t), rids));
+    ASSERT_EQ(1, static_cast<int>(rids.size()));
+    ASSERT_EQ(10, rids.front().slot_num);
+
+    // 升级之后可以继续修改，重新打开时不再升级
+    for (int i = 0; i < static_cast<int>(values.size()); i += 4) {
+      const RID rid(1, i);
+      ASSERT_EQ(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&values[i]), &rid));
+    }
+    for (int i = 0; i < 100; i++) {
+      const int32_t value = (i - 50) * 1000 + 1;
+      const RID     rid(2, static_cast<int>(values.size()) + i);
+      ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+    }
+    ASSERT_TRUE(handler.validate_tree());
+    const vector<int> before_reopen = scan_all(handler);
+    ASSERT_EQ(static_cast<int>(values.size()) * 3 / 4 + 100, static_cast<int>(before_reopen.size()));
+    ASSERT_EQ(RC::SUCCESS, handler.sync());  // 根节点可能变了，关闭之前把文件头写回去
+    handler.close();
+
+    ASSERT_EQ(RC::SUCCESS, handler.open(index_name));
+    ASSERT_EQ(IndexFileHeader::CURRENT_FORMAT_VERSION, BplusTreeTester::file_header(handler).format_version);
+    ASSERT_TRUE(handler.validate_tree());
+    ASSERT_EQ(before_reopen, scan_all(handler));
+    handler.close();
+  }
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("bplus_tree_format_test.log", LOG_LEVEL_INFO);
+  BufferPoolManager::set_instance(new BufferPoolManager());
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,141 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <random>
+#include <string.h>
+#include <vector>
+
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/index/bplus_tree_key_sorter.h"
+
+using namespace std;
+using namespace common;
+
+// 添加 count 个随机整数，检查返回的顺序和个数
+static void sort_and_check(int count, int64_t memory_size, int threads, int expected_runs)
+{
+  KeyNormalizer normalizer;
+  normalizer.init({INTS}, {sizeof(int32_t)});
+
+  BplusTreeKeySorter sorter;
+  ASSERT_EQ(RC::SUCCESS, sorter.init(normalizer, "key_sorter_test.sort", memory_size, threads));
+
+  mt19937 rng(count);
+  for (int i = 0; i < count; i++) {
+    const int32_t value = static_cast<int32_t>(rng() % 1000) - 500;
+    ASSERT_EQ(RC::SUCCESS, sorter.add(reinterpret_cast<const char *>(&value), RID(i / 100, i % 100)));
+  }
+  ASSERT_EQ(RC::SUCCESS, sorter.finish());
+  ASSERT_EQ(expected_runs, sorter.run_count());
+
+  vector<char> last;
+  const char  *key   = nullptr;
+  int          total = 0;
+  RC           rc    = RC::SUCCESS;
+  while (OB_SUCC(rc = sorter.next(key))) {
+    if (!last.empty()) {
+      ASSERT_LT(memcmp(last.data(), key, sorter.key_length()), 0);
+    }
+    last.assign(key, key + sorter.key_length());
+    total++;
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  ASSERT_EQ(count, total);
+}
+
+TEST(bplus_tree_key_sorter, in_memory)
+{
+  sort_and_check(0, 1 << 20, 1, 0);
+  sort_and_check(1, 1 << 20, 1, 0);
+  sort_and_check(50000, 16 << 20, 4, 0);
+}
+
+TEST(bplus_tree_key_sorter, spill_runs)
+{
+  // 每个键值 12 字节，加上排序用的 4 字节下标，1600 字节的内存可以放 100 个键值
+  sort_and_check(1000, 1600, 2, 10);
+  sort_and_check(1001, 1600, 2, 11);
+}
+
+TEST(bplus_tree_key_sorter, bulk_load)
+{
+  const char *index_name = "key_sorter_test.btree";
+  ::remove(index_name);
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, INTS, sizeof(int32_t), 5 /*internal max size*/, 5 /*leaf max size*/));
+  handler.set_unique(0);
+
+  BplusTreeKeySorter sorter;
+  ASSERT_EQ(RC::SUCCESS, sorter.init(handler.key_normalizer(), "key_sorter_test.sort", 1 << 20, 1));
+  const int count = 1000;
+  for (int i = 0; i < count; i++) {
+    const int32_t value = (i * 7) % count;
+    ASSERT_EQ(RC::SUCCESS, sorter.add(reinterpret_cast<const char *>(&value), RID(1, i)));
+  }
+  ASSERT_EQ(RC::SUCCESS, sorter.finish());
+  ASSERT_EQ(RC::SUCCESS, handler.bulk_load(sorter, 80 /*fill factor*/));
+  ASSERT_TRUE(handler.validate_tree());
+
+  BplusTreeScanner scanner(handler);
+  ASSERT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, true, nullptr, 0, true));
+  RID rid;
+  int total = 0;
+  while (scanner.next_entry(rid) == RC::SUCCESS) {
+    total++;
+  }
+  scanner.close();
+  ASSERT_EQ(count, total);
+
+  // 导入之后继续插入和删除，节点的分裂与合并都要正常
+  for (int i = 0; i < count; i += 2) {
+    const int32_t value = (i * 7) % count;
+    const RID     rid(1, i);
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&value), &rid));
+  }
+  for (int i = 0; i < 100; i++) {
+    const int32_t value = i;
+    const RID     rid(2, i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+  }
+  ASSERT_TRUE(handler.validate_tree());
+  handler.close();
+}
+
+TEST(bplus_tree_key_sorter, unique_violation)
+{
+  const char *index_name = "key_sorter_test.btree";
+  ::remove(index_name);
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, INTS, sizeof(int32_t)));
+  handler.set_unique(1);
+
+  BplusTreeKeySorter sorter;
+  ASSERT_EQ(RC::SUCCESS, sorter.init(handler.key_normalizer(), "key_sorter_test.sort", 1 << 20, 1));
+  for (int i = 0; i < 100; i++) {
+    const int32_t value = i == 99 ? 50 : i;
+    ASSERT_EQ(RC::SUCCESS, sorter.add(reinterpret_cast<const char *>(&value), RID(1, i)));
+  }
+  ASSERT_EQ(RC::SUCCESS, sorter.finish());
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler.bulk_load(sorter, 90 /*fill factor*/));
+  handler.close();
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("bplus_tree_key_sorter_test.log", LOG_LEVEL_INFO);
+  BufferPoolManager::set_instance(new BufferPoolManager());
+  return RUN_ALL_TESTS();
+}
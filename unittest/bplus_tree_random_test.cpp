@@ -0,0 +1,218 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <atomic>
+#include <list>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/index/bplus_tree.h"
+
+using namespace std;
+using namespace common;
+
+static vector<int> scan_all(BplusTreeHandler &handler)
+{
+  vector<int>      values;
+  BplusTreeScanner scanner(handler);
+  EXPECT_EQ(RC::SUCCESS, scanner.open(nullptr, 0, true, nullptr, 0, true));
+  RID rid;
+  while (scanner.next_entry(rid) == RC::SUCCESS) {
+    values.push_back(rid.slot_num);
+  }
+  return values;
+}
+
+// 随机插入和删除，每一步之后都检查整棵树，分裂和合并时父节点都是从查找路径中拿到的
+TEST(bplus_tree_random, insert_and_delete)
+{
+  const char *index_name = "bplus_tree_random_test.btree";
+  ::remove(index_name);
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, INTS, sizeof(int32_t), 4 /*internal max size*/, 4 /*leaf max size*/));
+  handler.set_unique(0);
+
+  mt19937       random(20231019);
+  const int32_t max_value = 500;
+  set<int32_t>  values;
+  for (int step = 0; step < 5000; step++) {
+    const int32_t value = static_cast<int32_t>(random() % max_value);
+    const RID     rid(1, value);
+
+    // 前半段插入多一些，让树长高，后半段删除多一些，让树变矮
+    const bool insert = random() % 100 < (step < 2500 ? 70 : 30);
+    if (insert && values.count(value) > 0) {
+      // 同一个键值和RID只插入一次
+      continue;
+    }
+    if (insert) {
+      RC rc = handler.insert_entry(reinterpret_cast<const char *>(&value), &rid);
+      ASSERT_EQ(RC::SUCCESS, rc) << "step=" << step << ", value=" << value;
+      values.insert(value);
+    } else {
+      RC rc = handler.delete_entry(reinterpret_cast<const char *>(&value), &rid);
+      if (values.erase(value) > 0) {
+        ASSERT_EQ(RC::SUCCESS, rc) << "step=" << step << ", value=" << value;
+      } else {
+        ASSERT_EQ(RC::RECORD_NOT_EXIST, rc) << "step=" << step << ", value=" << value;
+      }
+    }
+
+    ASSERT_TRUE(handler.validate_tree()) << "step=" << step << ", value=" << value << ", insert=" << insert;
+    if (step % 100 == 0) {
+      ASSERT_EQ(vector<int>(values.begin(), values.end()), scan_all(handler)) << "step=" << step;
+    }
+  }
+
+  // 全部删掉，树变成空的
+  for (int32_t value : values) {
+    const RID rid(1, value);
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&value), &rid));
+    ASSERT_TRUE(handler.validate_tree());
+  }
+  ASSERT_TRUE(handler.is_empty());
+  handler.close();
+}
+
+// 页面比缓冲池中的页帧还多，修改过的页面会被淘汰出去再重新加载，合并和重新分配的结果都不能丢
+TEST(bplus_tree_random, evict_pages)
+{
+  const char *index_name = "bplus_tree_random_test.btree";
+  ::remove(index_name);
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, INTS, sizeof(int32_t), 4 /*internal max size*/, 4 /*leaf max size*/));
+  handler.set_unique(0);
+
+  const int32_t value_num = 12000;
+  for (int32_t value = 0; value < value_num; value++) {
+    const RID rid(1, value);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&value), &rid)) << "value=" << value;
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  vector<int> expected;
+  for (int32_t value = 0; value < value_num; value++) {
+    const RID rid(1, value);
+    if (value % 2 == 0) {
+      ASSERT_EQ(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&value), &rid)) << "value=" << value;
+    } else {
+      expected.push_back(value);
+    }
+  }
+  ASSERT_TRUE(handler.validate_tree());
+  ASSERT_EQ(expected, scan_all(handler));
+  handler.close();
+}
+
+#ifdef CONCURRENCY
+// 多个线程同时插入和删除不同的键值，互相穿插在相同的叶子节点中，同时还有线程在读。
+// 没有开启 CONCURRENCY 时页面锁什么都不做，不能并发修改
+TEST(bplus_tree_random, concurrent_split_and_merge)
+{
+  const char *index_name = "bplus_tree_random_test.btree";
+  ::remove(index_name);
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(index_name, INTS, sizeof(int32_t), 4 /*internal max size*/, 4 /*leaf max size*/));
+  handler.set_unique(0);
+
+  const int thread_num      = 4;
+  const int value_per_round = 3000;  // 页面比缓冲池中的页帧多，加载和淘汰页面也会并发进行
+  const int rounds          = 3;
+
+  atomic<bool> stop{false};
+  atomic<int>  errors{0};
+
+  // 每个线程的键值是 i * thread_num + t，保证不同线程的键值交替出现在同一个叶子节点中
+  auto writer = [&](int t) {
+    for (int round = 0; round < rounds; round++) {
+      for (int32_t i = 0; i < value_per_round; i++) {
+        const int32_t value = i * thread_num + t;
+        const RID     rid(1, value);
+        if (handler.insert_entry(reinterpret_cast<const char *>(&value), &rid) != RC::SUCCESS) {
+          errors++;
+        }
+      }
+
+      // 最后一轮留下一半，其它轮次全部删掉，引起大量的合并和重新分配
+      for (int32_t i = 0; i < value_per_round; i++) {
+        if (round == rounds - 1 && i % 2 == 0) {
+          continue;
+        }
+        const int32_t value = i * thread_num + t;
+        const RID     rid(1, value);
+        if (handler.delete_entry(reinterpret_cast<const char *>(&value), &rid) != RC::SUCCESS) {
+          errors++;
+        }
+      }
+    }
+  };
+
+  // 读线程只能看到自己查找的键值，扫描结果必须是有序的
+  auto reader = [&]() {
+    mt19937 random(7);
+    while (!stop.load()) {
+      const int32_t value = static_cast<int32_t>(random() % (value_per_round * thread_num));
+      list<RID>     rids;
+      if (handler.get_entry(reinterpret_cast<const char *>(&value), sizeof(value), rids) != RC::SUCCESS) {
+        errors++;
+      }
+      for (const RID &rid : rids) {
+        if (rid.slot_num != value) {
+          errors++;
+        }
+      }
+
+      vector<int> values = scan_all(handler);
+      if (!is_sorted(values.begin(), values.end())) {
+        errors++;
+      }
+    }
+  };
+
+  vector<thread> writers;
+  for (int t = 0; t < thread_num; t++) {
+    writers.emplace_back(writer, t);
+  }
+  thread reader_thread(reader);
+  for (thread &th : writers) {
+    th.join();
+  }
+  stop = true;
+  reader_thread.join();
+
+  ASSERT_EQ(0, errors.load());
+  ASSERT_TRUE(handler.validate_tree());
+
+  vector<int> expected;
+  for (int32_t i = 0; i < value_per_round; i += 2) {
+    for (int t = 0; t < thread_num; t++) {
+      expected.push_back(i * thread_num + t);
+    }
+  }
+  ASSERT_EQ(expected, scan_all(handler));
+  handler.close();
+}
+#endif  // CONCURRENCY
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("bplus_tree_random_test.log", LOG_LEVEL_INFO);
+  BufferPoolManager::set_instance(new BufferPoolManager());
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,97 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/index/bplus_tree_search.h"
+
+using namespace std;
+using namespace bplus_tree_search;
+
+// 生成 count 个不相等、已经排序的键值，每项后面跟着 value_size 个字节的值
+static vector<char> make_items(mt19937 &rng, int key_size, int value_size, int count)
+{
+  vector<string> keys;
+  while ((int)keys.size() < count) {
+    string key(key_size, 0);
+    for (char &c : key) {
+      c = static_cast<char>(rng() % 4);  // 取值范围小一些，让键值有较长的公共前缀
+    }
+    keys.push_back(key);
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+  }
+
+  vector<char> items;
+  for (const string &key : keys) {
+    items.insert(items.end(), key.begin(), key.end());
+    items.insert(items.end(), value_size, static_cast<char>(0xff));
+  }
+  return items;
+}
+
+TEST(bplus_tree_search, fixed_equals_generic)
+{
+  mt19937 rng(2024);
+  for (int key_size = 1; key_size <= MAX_SPECIALIZED_KEY_SIZE; key_size++) {
+    const int  value_size = 8;
+    const int  item_size  = key_size + value_size;
+    SearchFunc search     = search_function(key_size);
+    ASSERT_NE(search, generic_lower_bound);
+
+    for (int count : {0, 1, 2, 3, 7, 64, 255}) {
+      if (key_size <= 4 && count > (1 << (2 * key_size)) / 2) {
+        continue;  // 每个字节只有4个不同的值，短键值生成不了这么多不同的键值
+      }
+      vector<char> items = make_items(rng, key_size, value_size, count);
+      for (int i = 0; i < 200; i++) {
+        string key(key_size, 0);
+        if (count > 0 && i % 2 == 0) {
+          key.assign(items.data() + (rng() % count) * item_size, key_size);
+        } else {
+          for (char &c : key) {
+            c = static_cast<char>(rng() % 4);
+          }
+        }
+
+        bool      generic_found = false;
+        bool      fixed_found   = false;
+        const int expected = generic_lower_bound(items.data(), item_size, count, key.data(), key_size, &generic_found);
+        const int actual   = search(items.data(), item_size, count, key.data(), key_size, &fixed_found);
+        ASSERT_EQ(expected, actual) << "key_size=" << key_size << ", count=" << count;
+        ASSERT_EQ(generic_found, fixed_found) << "key_size=" << key_size << ", count=" << count;
+      }
+    }
+  }
+}
+
+TEST(bplus_tree_search, select_function)
+{
+  ASSERT_EQ(search_function(0), empty_lower_bound);
+  ASSERT_EQ(search_function(12), fixed_lower_bound<12>);
+  ASSERT_EQ(search_function(MAX_SPECIALIZED_KEY_SIZE + 1), generic_lower_bound);
+
+  char items[12] = {0};
+  bool found     = false;
+  ASSERT_EQ(0, search_function(0)(items, 4, 3, items, 0, &found));
+  ASSERT_TRUE(found);
+  ASSERT_EQ(0, search_function(0)(items, 4, 0, items, 0, &found));
+  ASSERT_FALSE(found);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -12,7 +12,9 @@ See the Mulan PSL v2 for more details. */
 // Created by huhaosheng.hhs on 2022
 //
 
+#include <chrono>
 #include <string.h>
+#include <thread>
 
 #include "common/log/log.h"
 #include "storage/clog/clog.h"
@@ -44,6 +46,49 @@ TEST(test_clog, test_clog)
   */
 }
 
+int count_log_records(const char *path)
+{
+  CLogFile log_file;
+  EXPECT_EQ(RC::SUCCESS, log_file.init(path));
+
+  CLogRecordIterator iterator;
+  iterator.init(log_file);
+
+  int count = 0;
+  for (RC rc = iterator.next(); OB_SUCC(rc) && iterator.valid(); rc = iterator.next()) {
+    count++;
+  }
+  return count;
+}
+
+TEST(test_clog, test_async_commit)
+{
+  const char *path      = ".";
+  const char *clog_file = "./clog";
+  remove(clog_file);
+
+  CLogManager log_mgr;
+  ASSERT_EQ(RC::SUCCESS, log_mgr.init(path));
+  ASSERT_EQ(RC::SUCCESS, log_mgr.set_flush_interval_ms(20));
+  ASSERT_EQ(RC::INVALID_ARGUMENT, log_mgr.set_flush_interval_ms(0));
+
+  ASSERT_EQ(RC::SUCCESS, log_mgr.begin_trx(1));
+  ASSERT_EQ(RC::SUCCESS, log_mgr.commit_trx(1, 2, true /*async*/));
+
+  // 异步提交返回时日志还在缓存中，后台线程在刷盘间隔内会把日志写到文件。
+  // 机器繁忙时后台线程可能被推迟调度，所以轮询到日志出现为止，超时才认为失败
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (count_log_records(path) < 2 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_EQ(2, count_log_records(path));
+
+  // 同步提交会把之前缓存的日志一起刷盘
+  ASSERT_EQ(RC::SUCCESS, log_mgr.begin_trx(3));
+  ASSERT_EQ(RC::SUCCESS, log_mgr.commit_trx(3, 4, false /*async*/));
+  ASSERT_EQ(4, count_log_records(path));
+}
+
 int main(int argc, char **argv)
 {
   // 分析gtest程序的命令行参数
@@ -0,0 +1,258 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <memory>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+#include "sql/expr/expression.h"
+#include "sql/optimizer/cost_model.h"
+#include "sql/optimizer/join_order_optimizer.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+using namespace common;
+
+TEST(cost_model, access_path)
+{
+  // 2000个页面，40万行
+  const double pages = 2000;
+  const double rows  = 400000;
+  const double scan  = CostModel::table_scan(pages, rows, 1);
+
+  // 匹配的记录很少时索引扫描最便宜
+  EXPECT_LT(CostModel::index_scan(pages, 1, 1), CostModel::bitmap_heap_scan(pages, 1, 1, 1));
+  EXPECT_LT(CostModel::index_scan(pages, 10, 1), scan);
+
+  // 匹配的记录较多时位图堆扫描比索引扫描便宜，但是大部分记录都匹配时不如全表扫描
+  EXPECT_LT(CostModel::bitmap_heap_scan(pages, 5000, 5000, 1), CostModel::index_scan(pages, 5000, 1));
+  EXPECT_LT(CostModel::bitmap_heap_scan(pages, 5000, 5000, 1), scan);
+  EXPECT_LT(scan, CostModel::bitmap_heap_scan(pages, rows * 3 / 4, rows * 3 / 4, 1));
+  EXPECT_LT(scan, CostModel::index_scan(pages, rows / 2, 1));
+
+  // 多个索引求交集之后，匹配的记录越少回表的代价越低
+  EXPECT_LT(CostModel::bitmap_heap_scan(pages, 20000, 100, 1), CostModel::bitmap_heap_scan(pages, 20000, 10000, 1));
+}
+
+TEST(cost_model, join)
+{
+  const double outer_cost = CostModel::table_scan(100, 10000, 0);
+  const double inner_cost = CostModel::table_scan(50, 5000, 0);
+
+  // 两边都很大时哈希连接远比嵌套循环便宜
+  EXPECT_LT(CostModel::hash_join(inner_cost, 5000, outer_cost, 10000),
+      CostModel::nested_loop_join(outer_cost, 10000, inner_cost, 5000));
+
+  // 外表只有一行时嵌套循环只需要把内表扫描一遍
+  EXPECT_NEAR(CostModel::nested_loop_join(1, 1, inner_cost, 5000),
+      1 + inner_cost + CostModel::CPU_TUPLE_COST * 5000,
+      1e-6);
+
+  // 内表上的索引查找代价很低时，索引连接比哈希连接便宜
+  EXPECT_LT(CostModel::index_join(1, 10, CostModel::index_scan(50, 1, 0)),
+      CostModel::hash_join(inner_cost, 5000, 1, 10));
+}
+
+TEST(cost_model, sort_and_aggregate)
+{
+  EXPECT_GT(CostModel::sort(0, 2000), 2 * CostModel::sort(0, 1000));
+  EXPECT_GT(CostModel::aggregate(0, 1000, 2), CostModel::aggregate(0, 1000, 1));
+  EXPECT_GT(CostModel::sort(10, 1000), CostModel::aggregate(10, 1000, 1));
+
+  // 只取前几行时堆很小，比完整的排序便宜；limit 不小于行数时就是完整的排序
+  EXPECT_LT(CostModel::top_n(10, 100000, 10), CostModel::sort(10, 100000));
+  EXPECT_LT(CostModel::top_n(10, 100000, 10), CostModel::top_n(10, 100000, 1000));
+  EXPECT_DOUBLE_EQ(CostModel::sort(10, 1000), CostModel::top_n(10, 1000, 1000));
+}
+
+TEST(cost_model, small_table_without_stats)
+{
+  char base_dir[] = "cost_model_test.XXXXXX";
+  ASSERT_NE(nullptr, mkdtemp(base_dir));
+
+  if (TrxKit::instance() == nullptr) {
+    ASSERT_EQ(TrxKit::init_global("vacuous"), RC::SUCCESS);
+  }
+
+  AttrInfoSqlNode attrs[2];
+  attrs[0].type   = INTS;
+  attrs[0].name   = "id";
+  attrs[0].length = 4;
+  attrs[1].type   = CHARS;
+  attrs[1].name   = "name";
+  attrs[1].length = 4;
+
+  for (StorageFormat format : {StorageFormat::ROW_FORMAT, StorageFormat::VARLEN_FORMAT}) {
+    const std::string name = format == StorageFormat::ROW_FORMAT ? "t_row" : "t_varlen";
+    const std::string path = std::string(base_dir) + "/" + name + ".table";
+
+    Table table;
+    ASSERT_EQ(RC::SUCCESS, table.create(1, path.c_str(), name.c_str(), base_dir, 2, attrs, format));
+
+    for (int i = 0; i < 4; i++) {
+      Value  values[2] = {Value(i), Value("abc")};
+      Record record;
+      ASSERT_EQ(RC::SUCCESS, table.make_record(2, values, record));
+      ASSERT_EQ(RC::SUCCESS, table.insert_record(record));
+    }
+
+    // 文件头和空闲空间映射页面不算数据页面，没有统计信息时只按照一个满的页面估算
+    ASSERT_FALSE(table.stats()->analyzed());
+    EXPECT_EQ(1, table.data_page_count());
+    EXPECT_EQ(1, CardinalityEstimator::table_pages(&table));
+    EXPECT_EQ(BP_PAGE_DATA_SIZE / table.table_meta().record_size(), CardinalityEstimator::table_rows(&table));
+  }
+}
+
+/**
+ * @brief 创建一张只有 id 字段的表，插入 0..row_num-1 并收集统计信息
+ */
+static void create_join_table(Table &table, const char *base_dir, int32_t table_id, const char *name, int row_num)
+{
+  AttrInfoSqlNode attr;
+  attr.type   = INTS;
+  attr.name   = "id";
+  attr.length = 4;
+
+  const std::string path = std::string(base_dir) + "/" + name + ".table";
+  ASSERT_EQ(RC::SUCCESS, table.create(table_id, path.c_str(), name, base_dir, 1, &attr));
+  for (int i = 0; i < row_num; i++) {
+    Value  value(i);
+    Record record;
+    ASSERT_EQ(RC::SUCCESS, table.make_record(1, &value, record));
+    ASSERT_EQ(RC::SUCCESS, table.insert_record(record));
+  }
+  ASSERT_EQ(RC::SUCCESS, table.analyze({table.table_meta().field("id")}));
+}
+
+static std::unique_ptr<Expression> equal_join(Table &left, Table &right)
+{
+  return std::make_unique<ComparisonExpr>(EQUAL_TO,
+      std::make_unique<FieldExpr>(&left, left.table_meta().field("id")),
+      std::make_unique<FieldExpr>(&right, right.table_meta().field("id")));
+}
+
+/**
+ * @brief 连接树写成 (外表 内表) 的形式，叶子节点用表名
+ */
+static std::string join_tree_string(const JoinTreeNode &node, const std::vector<Table *> &tables)
+{
+  if (node.table >= 0) {
+    return tables[node.table]->name();
+  }
+  return "(" + join_tree_string(*node.left, tables) + " " + join_tree_string(*node.right, tables) + ")";
+}
+
+/**
+ * @brief 连接树中笛卡尔积的个数，也就是两边之间没有连接条件的连接节点个数
+ */
+static int cross_products(const JoinTreeNode &node, const JoinOrderOptimizer &optimizer, size_t conjunct_num)
+{
+  if (node.table >= 0) {
+    return 0;
+  }
+  bool connected = false;
+  for (size_t i = 0; i < conjunct_num; i++) {
+    const uint64_t tables = optimizer.tables_of(i);
+    connected = connected || ((tables & node.left->tables) != 0 && (tables & node.right->tables) != 0);
+  }
+  return (connected ? 0 : 1) + cross_products(*node.left, optimizer, conjunct_num) +
+         cross_products(*node.right, optimizer, conjunct_num);
+}
+
+class JoinOrderTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_NE(nullptr, mkdtemp(base_dir_));
+    if (TrxKit::instance() == nullptr) {
+      ASSERT_EQ(TrxKit::init_global("vacuous"), RC::SUCCESS);
+    }
+    create_join_table(big_, base_dir_, 1, "big", 5000);
+    create_join_table(middle_, base_dir_, 2, "middle", 500);
+    create_join_table(small_, base_dir_, 3, "small", 5);
+    create_join_table(other_, base_dir_, 4, "other", 50);
+  }
+
+  char  base_dir_[32] = "join_order_test.XXXXXX";
+  Table big_;
+  Table middle_;
+  Table small_;
+  Table other_;
+};
+
+// 链状连接图 big - middle - small。FROM 中的顺序需要 big 和 small 的笛卡尔积，
+// 动态规划选择的连接树没有笛卡尔积，最小的表在最外层
+TEST_F(JoinOrderTest, chain)
+{
+  std::vector<Table *>                     tables = {&big_, &small_, &middle_};
+  std::vector<std::unique_ptr<Expression>> conjuncts;
+  conjuncts.push_back(equal_join(big_, middle_));
+  conjuncts.push_back(equal_join(middle_, small_));
+
+  JoinOrderOptimizer            optimizer(tables, conjuncts);
+  std::unique_ptr<JoinTreeNode> from_order = optimizer.from_order();
+  std::unique_ptr<JoinTreeNode> best       = optimizer.optimize(JoinOrderOptimizer::MAX_DP_TABLES);
+  EXPECT_EQ("((big small) middle)", join_tree_string(*from_order, tables));
+  EXPECT_EQ("((small middle) big)", join_tree_string(*best, tables));
+  EXPECT_EQ(0, cross_products(*best, optimizer, conjuncts.size()));
+  EXPECT_LT(best->cost, from_order->cost);
+
+  // 连接之后的行数与连接顺序无关
+  EXPECT_NEAR(from_order->rows, best->rows, 1e-6 * best->rows);
+  EXPECT_EQ(uint64_t(7), best->tables);
+
+  // 贪心算法也不会选择笛卡尔积
+  std::unique_ptr<JoinTreeNode> greedy = optimizer.optimize(1 /*dp_threshold*/);
+  EXPECT_EQ(0, cross_products(*greedy, optimizer, conjuncts.size()));
+  EXPECT_GE(greedy->cost, best->cost);
+}
+
+// 连接图不连通：big - middle 和 small - other 是两个连通分量，只需要一次笛卡尔积。
+// 笛卡尔积不一定在最上层，和很小的表做笛卡尔积可能比和连接之后的结果做更便宜
+TEST_F(JoinOrderTest, disconnected_graph)
+{
+  std::vector<Table *>                     tables = {&big_, &small_, &middle_, &other_};
+  std::vector<std::unique_ptr<Expression>> conjuncts;
+  conjuncts.push_back(equal_join(big_, middle_));
+  conjuncts.push_back(equal_join(small_, other_));
+
+  JoinOrderOptimizer            optimizer(tables, conjuncts);
+  std::unique_ptr<JoinTreeNode> from_order = optimizer.from_order();
+  for (int dp_threshold : {JoinOrderOptimizer::MAX_DP_TABLES, 1}) {
+    std::unique_ptr<JoinTreeNode> best = optimizer.optimize(dp_threshold);
+    EXPECT_EQ(uint64_t(15), best->tables);
+    EXPECT_EQ(1, cross_products(*best, optimizer, conjuncts.size()))
+        << "dp_threshold=" << dp_threshold << ", tree=" << join_tree_string(*best, tables);
+    EXPECT_LE(best->cost, from_order->cost);
+    EXPECT_NEAR(from_order->rows, best->rows, 1e-6 * best->rows);
+  }
+  EXPECT_EQ("(((middle big) small) other)",
+      join_tree_string(*optimizer.optimize(JoinOrderOptimizer::MAX_DP_TABLES), tables));
+
+  // 完全没有连接条件时，也能生成包含所有表的连接树
+  std::vector<std::unique_ptr<Expression>> no_conjuncts;
+  JoinOrderOptimizer                       cross_optimizer(tables, no_conjuncts);
+  std::unique_ptr<JoinTreeNode>            cross = cross_optimizer.optimize(JoinOrderOptimizer::MAX_DP_TABLES);
+  EXPECT_EQ(uint64_t(15), cross->tables);
+}
+
+int main(int argc, char **argv)
+{
+  LoggerFactory::init_default("cost_model_test.log", LOG_LEVEL_INFO);
+  BufferPoolManager::set_instance(new BufferPoolManager());
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,125 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <chrono>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+#include "storage/buffer/disk_buffer_pool.h"
+
+using namespace std;
+using namespace common;
+
+// 释放页面时还有读者 pin 着这个页面，要等读者 unpin 之后才能释放
+TEST(disk_buffer_pool, dispose_page_waits_for_unpin)
+{
+  const char *file_name = "disk_buffer_pool_test.bp";
+  ::remove(file_name);
+
+  BufferPoolManager bpm;
+  DiskBufferPool   *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  Frame *frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+  const PageNum page_num = frame->page_num();
+  ASSERT_EQ(RC::SUCCESS, bp->unpin_page(frame));
+
+  Frame *reader_frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page_num, &reader_frame));
+
+  std::thread reader([bp, reader_frame]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    bp->unpin_page(reader_frame);
+  });
+
+  const int32_t allocated_pages = bp->allocated_pages();
+  ASSERT_EQ(RC::SUCCESS, bp->dispose_page(page_num));
+  reader.join();
+  ASSERT_EQ(allocated_pages - 1, bp->allocated_pages());
+
+  // 释放的页面可以重新分配
+  ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+  ASSERT_EQ(page_num, frame->page_num());
+  ASSERT_EQ(RC::SUCCESS, bp->unpin_page(frame));
+
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+}
+
+// 预读只是给操作系统的提示：不占用页帧，跳过无效的页面，读取到的页面内容不变
+TEST(disk_buffer_pool, prefetch_pages)
+{
+  const char *file_name = "disk_buffer_pool_test.bp";
+  ::remove(file_name);
+
+  BufferPoolManager bpm;
+  DiskBufferPool   *bp = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm.create_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  const int       page_count = 32;
+  vector<PageNum> page_nums;
+  for (int i = 0; i < page_count; i++) {
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->allocate_page(&frame));
+    memcpy(frame->data(), &i, sizeof(i));
+    frame->mark_dirty();
+    page_nums.push_back(frame->page_num());
+    ASSERT_EQ(RC::SUCCESS, bp->unpin_page(frame));
+  }
+
+  // 释放掉中间的一个页面，重新打开文件之后只有文件头在缓冲池中
+  ASSERT_EQ(RC::SUCCESS, bp->dispose_page(page_nums[10]));
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+  ASSERT_EQ(RC::SUCCESS, bpm.open_file(file_name, bp));
+
+  Frame *cached_frame = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page_nums[20], &cached_frame));
+
+  // 乱序、重复、已经释放、已经在缓冲池中、超出文件范围的页面混在一起
+  vector<PageNum> prefetch_nums = {page_nums[5], page_nums[3], page_nums[4], page_nums[4], page_nums[10],
+      page_nums[20], page_nums[31], -1, page_nums[31] + 100};
+  bp->prefetch_pages(prefetch_nums);
+  bp->prefetch_pages(page_nums);
+  bp->prefetch_pages({});
+
+  // 预读不会 pin 住页面
+  ASSERT_EQ(RC::SUCCESS, bp->unpin_page(cached_frame));
+  ASSERT_EQ(RC::SUCCESS, bp->check_all_pages_unpinned());
+
+  for (int i = 0; i < page_count; i++) {
+    if (i == 10) {
+      continue;
+    }
+    Frame *frame = nullptr;
+    ASSERT_EQ(RC::SUCCESS, bp->get_this_page(page_nums[i], &frame));
+    int value = -1;
+    memcpy(&value, frame->data(), sizeof(value));
+    ASSERT_EQ(i, value);
+    ASSERT_EQ(RC::SUCCESS, bp->unpin_page(frame));
+  }
+  // 释放了一个页面，另外还有文件头
+  ASSERT_EQ(page_count, bp->allocated_pages());
+
+  // 预读之后马上关闭文件也没有问题
+  bp->prefetch_pages(page_nums);
+  ASSERT_EQ(RC::SUCCESS, bpm.close_file(file_name));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("disk_buffer_pool_test.log", LOG_LEVEL_INFO);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,156 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <vector>
+
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/index/extendible_hash.h"
+
+using namespace std;
+using namespace common;
+
+static const char *INDEX_NAME = "extendible_hash_test.hash";
+
+static vector<RID> lookup(ExtendibleHashHandler &handler, int32_t value)
+{
+  vector<RID> rids;
+  EXPECT_EQ(RC::SUCCESS, handler.get_entries(reinterpret_cast<const char *>(&value), rids));
+  return rids;
+}
+
+TEST(extendible_hash, insert_split_delete)
+{
+  ::remove(INDEX_NAME);
+
+  ExtendibleHashHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(INDEX_NAME, {INTS}, {sizeof(int32_t)}));
+  handler.set_unique(0);
+
+  // 每个桶能放五百多个键值，两万个键值需要分裂很多次
+  const int count = 20000;
+  for (int i = 0; i < count; i++) {
+    const int32_t value = i;
+    const RID     rid(i / 100 + 1, i % 100);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+  }
+  ASSERT_GE(handler.global_depth(), 5);
+  ASSERT_TRUE(handler.validate());
+
+  for (int i = 0; i < count; i += 7) {
+    vector<RID> rids = lookup(handler, i);
+    ASSERT_EQ(1, static_cast<int>(rids.size()));
+    ASSERT_EQ(RID(i / 100 + 1, i % 100), rids[0]);
+  }
+  ASSERT_TRUE(lookup(handler, count).empty());
+
+  // 同样的键值重复插入
+  const int32_t value = 10;
+  const RID     rid(10 / 100 + 1, 10 % 100);
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+
+  for (int i = 0; i < count; i += 2) {
+    const int32_t value = i;
+    const RID     rid(i / 100 + 1, i % 100);
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&value), &rid));
+  }
+  ASSERT_EQ(RC::RECORD_NOT_EXIST, handler.delete_entry(reinterpret_cast<const char *>(&value), &rid));
+  ASSERT_TRUE(handler.validate());
+  ASSERT_TRUE(lookup(handler, 100).empty());
+  ASSERT_EQ(1, static_cast<int>(lookup(handler, 101).size()));
+
+  // 重新打开之后目录和数据都还在
+  const int global_depth = handler.global_depth();
+  ASSERT_EQ(RC::SUCCESS, handler.sync());
+  handler.close();
+
+  ASSERT_EQ(RC::SUCCESS, handler.open(INDEX_NAME));
+  ASSERT_EQ(global_depth, handler.global_depth());
+  ASSERT_TRUE(handler.validate());
+  for (int i = 0; i < count; i += 3) {
+    ASSERT_EQ(i % 2 == 0 ? 0 : 1, static_cast<int>(lookup(handler, i).size()));
+  }
+  handler.close();
+}
+
+TEST(extendible_hash, duplicate_overflow)
+{
+  ::remove(INDEX_NAME);
+
+  ExtendibleHashHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(INDEX_NAME, {INTS}, {sizeof(int32_t)}));
+  handler.set_unique(0);
+
+  // 相同的值无法通过分裂分开，只能挂溢出页面
+  const int     count = 3000;
+  const int32_t value = 42;
+  for (int i = 0; i < count; i++) {
+    const RID rid(i / 100 + 1, i % 100);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+  }
+  for (int i = 0; i < 100; i++) {
+    const int32_t other = i + 1000;
+    const RID     rid(100, i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&other), &rid));
+  }
+  ASSERT_TRUE(handler.validate());
+  ASSERT_EQ(count, static_cast<int>(lookup(handler, value).size()));
+  ASSERT_EQ(1, static_cast<int>(lookup(handler, 1050).size()));
+
+  // 删掉大部分之后空的溢出页面被释放
+  for (int i = 0; i < count - 1; i++) {
+    const RID rid(i / 100 + 1, i % 100);
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&value), &rid));
+  }
+  ASSERT_TRUE(handler.validate());
+  vector<RID> rids = lookup(handler, value);
+  ASSERT_EQ(1, static_cast<int>(rids.size()));
+  ASSERT_EQ(RID((count - 1) / 100 + 1, (count - 1) % 100), rids[0]);
+  handler.close();
+}
+
+TEST(extendible_hash, unique)
+{
+  ::remove(INDEX_NAME);
+
+  ExtendibleHashHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(INDEX_NAME, {INTS, CHARS}, {sizeof(int32_t), 8}));
+  handler.set_unique(1);
+
+  char key[12] = {0};
+  for (int i = 0; i < 1000; i++) {
+    memcpy(key, &i, sizeof(i));
+    snprintf(key + 4, 8, "k%d", i % 10);
+    const RID rid(1, i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(key, &rid));
+  }
+
+  const int32_t value = 500;
+  memcpy(key, &value, sizeof(value));
+  snprintf(key + 4, 8, "k%d", value % 10);
+  const RID rid(2, 0);
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler.insert_entry(key, &rid));
+
+  // 只有一个字段相同不算重复
+  snprintf(key + 4, 8, "other");
+  ASSERT_EQ(RC::SUCCESS, handler.insert_entry(key, &rid));
+  ASSERT_TRUE(handler.validate());
+  handler.close();
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("extendible_hash_test.log", LOG_LEVEL_INFO);
+  BufferPoolManager::set_instance(new BufferPoolManager());
+  return RUN_ALL_TESTS();
+}
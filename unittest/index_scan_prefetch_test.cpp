@@ -0,0 +1,249 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+#include "sql/expr/tuple.h"
+#include "sql/operator/index_scan_physical_operator.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/index/bplus_tree.h"
+#include "storage/index/index.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+using namespace common;
+
+/**
+ * @brief 用 BplusTreeScanner 扫描 [left, right]，返回 RID 的 slot_num。left/right 为空表示不限制
+ */
+static vector<int> scan_tree(
+    BplusTreeHandler &handler, int prefetch_leaves, bool reverse, const int32_t *left, const int32_t *right)
+{
+  vector<int>      slots;
+  BplusTreeScanner scanner(handler);
+  scanner.set_prefetch_leaves(prefetch_leaves);
+  scanner.set_reverse(reverse);
+  EXPECT_EQ(RC::SUCCESS,
+      scanner.open(reinterpret_cast<const char *>(left),
+          left == nullptr ? 0 : sizeof(*left),
+          true,
+          reinterpret_cast<const char *>(right),
+          right == nullptr ? 0 : sizeof(*right),
+          true));
+  RID rid;
+  while (scanner.next_entry(rid) == RC::SUCCESS) {
+    slots.push_back(rid.slot_num);
+  }
+  return slots;
+}
+
+// 开启预读之后扫描跨过很多叶子节点，正序和逆序的结果都与不预读时相同
+TEST(index_scan_prefetch, bplus_tree_scanner)
+{
+  const char *index_name = "index_scan_prefetch_test.btree";
+  ::remove(index_name);
+
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS,
+      handler.create(index_name, INTS, sizeof(int32_t), 6 /*internal max size*/, 8 /*leaf max size*/));
+  handler.set_unique(0);
+
+  // 键值有重复，插入的顺序是乱的
+  const int   entry_num = 3000;
+  vector<int> slots(entry_num);
+  for (int i = 0; i < entry_num; i++) {
+    slots[i] = i;
+  }
+  shuffle(slots.begin(), slots.end(), mt19937(20231019));
+  for (int slot : slots) {
+    const int32_t key = slot / 3;
+    const RID     rid(1, slot);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&key), &rid));
+  }
+  ASSERT_TRUE(handler.validate_tree());
+
+  vector<int> expected(entry_num);
+  for (int i = 0; i < entry_num; i++) {
+    expected[i] = i;
+  }
+  vector<int> reversed(expected.rbegin(), expected.rend());
+
+  const int32_t low  = 123;
+  const int32_t high = 876;
+  for (int prefetch_leaves : {0, 1, 3, 8, 32}) {
+    SCOPED_TRACE("prefetch_leaves=" + to_string(prefetch_leaves));
+
+    ASSERT_EQ(expected, scan_tree(handler, prefetch_leaves, false, nullptr, nullptr));
+    ASSERT_EQ(reversed, scan_tree(handler, prefetch_leaves, true, nullptr, nullptr));
+
+    // 从中间的叶子节点开始，预读窗口用完之后要从根节点重新找后面的叶子节点
+    vector<int> range = scan_tree(handler, 0, false, &low, &high);
+    ASSERT_EQ(static_cast<size_t>((high - low + 1) * 3), range.size());
+    ASSERT_EQ(range, scan_tree(handler, prefetch_leaves, false, &low, &high));
+    ASSERT_EQ(vector<int>(range.rbegin(), range.rend()), scan_tree(handler, prefetch_leaves, true, &low, &high));
+    ASSERT_EQ(vector<int>(expected.begin() + low * 3, expected.end()),
+        scan_tree(handler, prefetch_leaves, false, &low, nullptr));
+  }
+  handler.close();
+}
+
+/**
+ * @brief 一张 (id int, pad char(200)) 的表，id 上有 B+ 树索引。pad 让记录分散在很多个页面中
+ */
+class IndexScanPrefetchTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_NE(nullptr, mkdtemp(base_dir_));
+
+    AttrInfoSqlNode attrs[2];
+    attrs[0].type   = INTS;
+    attrs[0].name   = "id";
+    attrs[0].length = 4;
+    attrs[1].type   = CHARS;
+    attrs[1].name   = "pad";
+    attrs[1].length = 200;
+
+    table_            = make_unique<Table>();
+    const string path = string(base_dir_) + "/t.table";
+    ASSERT_EQ(RC::SUCCESS, table_->create(1, path.c_str(), "t", base_dir_, 2, attrs));
+
+    trx_ = TrxKit::instance()->create_trx(nullptr /*log_manager*/);
+    vector<const FieldMeta *> field_metas = {table_->table_meta().field("id")};
+    ASSERT_EQ(RC::SUCCESS,
+        table_->create_index(trx_, 0 /*unique*/, field_metas, "t_id", IndexType::BPLUS_TREE, IndexBuildOptions()));
+    index_ = table_->find_index("t_id");
+    ASSERT_NE(nullptr, index_);
+  }
+
+  void TearDown() override
+  {
+    TrxKit::instance()->destroy_trx(trx_);
+    table_.reset();
+    filesystem::remove_all(base_dir_);
+  }
+
+  void insert(int id)
+  {
+    Value  values[2] = {Value(id), Value("x")};
+    Record record;
+    ASSERT_EQ(RC::SUCCESS, table_->make_record(2, values, record));
+    ASSERT_EQ(RC::SUCCESS, table_->insert_record(record));
+  }
+
+  /**
+   * @brief 用 IndexScanPhysicalOperator 扫描，RID 是成批从索引中取出的
+   */
+  vector<int> operator_scan(const Value *left, const Value *right, bool reverse)
+  {
+    vector<int>               ids;
+    IndexScanPhysicalOperator oper(table_.get(), index_, true /*readonly*/, left, true, right, true);
+    oper.set_reverse(reverse);
+    EXPECT_EQ(RC::SUCCESS, oper.open(trx_));
+    RC rc = RC::SUCCESS;
+    while (RC::SUCCESS == (rc = oper.next())) {
+      Value value;
+      EXPECT_EQ(RC::SUCCESS, oper.current_tuple()->find_cell(TupleCellSpec("t", "id"), value));
+      ids.push_back(value.get_int());
+    }
+    EXPECT_EQ(RC::RECORD_EOF, rc);
+    EXPECT_EQ(RC::SUCCESS, oper.close());
+    return ids;
+  }
+
+  /**
+   * @brief 直接在索引上逐条取出 RID 再读取记录，作为对照
+   */
+  vector<int> index_scan(const Value *left, const Value *right, bool reverse)
+  {
+    vector<int>   ids;
+    IndexScanner *scanner = index_->create_scanner(left == nullptr ? nullptr : left->data(),
+        left == nullptr ? 0 : left->length(),
+        true,
+        right == nullptr ? nullptr : right->data(),
+        right == nullptr ? 0 : right->length(),
+        true,
+        reverse);
+    EXPECT_NE(nullptr, scanner);
+    const FieldMeta *id_meta = table_->table_meta().field("id");
+    RID              rid;
+    while (RC::SUCCESS == scanner->next_entry(&rid)) {
+      Record record;
+      EXPECT_EQ(RC::SUCCESS, table_->get_record(rid, record));
+      ids.push_back(*reinterpret_cast<const int *>(record.data() + id_meta->offset()));
+    }
+    scanner->destroy();
+    return ids;
+  }
+
+  char              base_dir_[40] = "index_scan_prefetch_test.XXXXXX";
+  unique_ptr<Table> table_;
+  Trx              *trx_   = nullptr;
+  Index            *index_ = nullptr;
+};
+
+// 成批取出 RID 并预读数据页面之后，记录仍然按照索引的顺序返回
+TEST_F(IndexScanPrefetchTest, batched_index_scan)
+{
+  // 插入顺序打乱，索引顺序和记录在数据页面中的顺序不同。键值有重复
+  const int   row_num = 1000;
+  vector<int> ids;
+  for (int i = 0; i < row_num; i++) {
+    ids.push_back(i / 2);
+  }
+  shuffle(ids.begin(), ids.end(), mt19937(20231019));
+  for (int id : ids) {
+    insert(id);
+  }
+  ASSERT_GT(table_->data_page_count(), 10);
+
+  sort(ids.begin(), ids.end());
+  vector<int> reversed(ids.rbegin(), ids.rend());
+
+  ASSERT_EQ(ids, operator_scan(nullptr, nullptr, false));
+  ASSERT_EQ(ids, index_scan(nullptr, nullptr, false));
+  ASSERT_EQ(reversed, operator_scan(nullptr, nullptr, true));
+  ASSERT_EQ(reversed, index_scan(nullptr, nullptr, true));
+
+  // 范围内的行数不是批次大小的整数倍
+  const Value left(37);
+  const Value right(211);
+  vector<int> range = index_scan(&left, &right, false);
+  ASSERT_EQ(static_cast<size_t>((211 - 37 + 1) * 2), range.size());
+  ASSERT_EQ(range, operator_scan(&left, &right, false));
+  ASSERT_EQ(vector<int>(range.rbegin(), range.rend()), operator_scan(&left, &right, true));
+
+  // 空范围和只有一个键值的范围
+  const Value missing(row_num);
+  const Value last(row_num / 2 - 1);
+  ASSERT_TRUE(operator_scan(&missing, nullptr, false).empty());
+  ASSERT_EQ(vector<int>({row_num / 2 - 1, row_num / 2 - 1}), operator_scan(&last, &last, true));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("index_scan_prefetch_test.log", LOG_LEVEL_INFO);
+  BufferPoolManager::set_instance(new BufferPoolManager());
+  if (TrxKit::init_global("vacuous") != RC::SUCCESS) {
+    return 1;
+  }
+  return RUN_ALL_TESTS();
+}
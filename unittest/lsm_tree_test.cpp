@@ -0,0 +1,158 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/index/lsm_tree.h"
+
+using namespace std;
+
+static const char *INDEX_NAME = "lsm_tree_test.lsm";
+
+static RID rid_of(int i) { return RID(i / 100 + 1, i % 100); }
+
+static vector<RID> scan(LsmTreeHandler &handler, const int32_t *left, bool left_inclusive, const int32_t *right,
+    bool right_inclusive)
+{
+  vector<RID>    rids;
+  LsmTreeScanner scanner(handler);
+  EXPECT_EQ(RC::SUCCESS,
+      scanner.open(reinterpret_cast<const char *>(left), sizeof(int32_t), left_inclusive,
+          reinterpret_cast<const char *>(right), sizeof(int32_t), right_inclusive));
+  RID rid;
+  RC  rc = RC::SUCCESS;
+  while (OB_SUCC(rc = scanner.next_entry(rid))) {
+    rids.push_back(rid);
+  }
+  EXPECT_EQ(RC::RECORD_EOF, rc);
+  return rids;
+}
+
+static vector<RID> lookup(LsmTreeHandler &handler, int32_t value)
+{
+  return scan(handler, &value, true, &value, true);
+}
+
+TEST(lsm_tree, flush_compact_scan)
+{
+  LsmTreeHandler::remove_run_files(INDEX_NAME);
+  ::remove(INDEX_NAME);
+
+  LsmTreeHandler handler;
+  // memtable 只能放几十个键值，插入的过程中会写出很多有序段并且归并
+  handler.set_memtable_size(2048);
+  ASSERT_EQ(RC::SUCCESS, handler.create(INDEX_NAME, {INTS}, {sizeof(int32_t)}));
+
+  const int   count = 5000;
+  vector<int> values(count);
+  for (int i = 0; i < count; i++) {
+    values[i] = i;
+  }
+  shuffle(values.begin(), values.end(), mt19937(1));
+  for (int i : values) {
+    const int32_t value = i / 2;  // 每个值出现两次
+    const RID     rid   = rid_of(i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+  }
+  ASSERT_EQ(RC::SUCCESS, handler.wait_for_background());
+  ASSERT_LT(handler.run_count(), LsmTreeHandler::COMPACTION_TRIGGER * 4);
+
+  // 全部扫描是有序的
+  vector<RID> all = scan(handler, nullptr, false, nullptr, false);
+  ASSERT_EQ(count, static_cast<int>(all.size()));
+  for (int i = 0; i < count; i++) {
+    ASSERT_EQ(rid_of(i), all[i]);
+  }
+
+  const int32_t left  = 100;
+  const int32_t right = 200;
+  ASSERT_EQ(198, static_cast<int>(scan(handler, &left, false, &right, false).size()));
+  ASSERT_EQ(200, static_cast<int>(scan(handler, &left, true, &right, false).size()));
+  ASSERT_EQ(202, static_cast<int>(scan(handler, &left, true, &right, true).size()));
+  ASSERT_EQ(2 * (count / 2 - 200), static_cast<int>(scan(handler, &right, true, nullptr, false).size()));
+  ASSERT_TRUE(scan(handler, &right, true, &left, true).empty());
+  ASSERT_EQ((vector<RID>{rid_of(20), rid_of(21)}), lookup(handler, 10));
+  ASSERT_TRUE(lookup(handler, count).empty());
+
+  // 删除一半，删除标记要覆盖有序段中的数据
+  for (int i = 0; i < count; i += 2) {
+    const int32_t value = i / 2;
+    const RID     rid   = rid_of(i);
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&value), &rid));
+  }
+  ASSERT_EQ((vector<RID>{rid_of(21)}), lookup(handler, 10));
+  ASSERT_EQ(count / 2, static_cast<int>(scan(handler, nullptr, false, nullptr, false).size()));
+
+  // 重新打开之后数据都还在
+  ASSERT_EQ(RC::SUCCESS, handler.close());
+  ASSERT_EQ(RC::SUCCESS, handler.open(INDEX_NAME));
+  ASSERT_EQ((vector<RID>{rid_of(21)}), lookup(handler, 10));
+  vector<RID> rest = scan(handler, nullptr, false, nullptr, false);
+  ASSERT_EQ(count / 2, static_cast<int>(rest.size()));
+  for (int i = 0; i < count / 2; i++) {
+    ASSERT_EQ(rid_of(2 * i + 1), rest[i]);
+  }
+
+  // 删除剩下的数据之后，归并到最老的有序段时删除标记也会被丢弃
+  for (int i = 1; i < count; i += 2) {
+    const int32_t value = i / 2;
+    const RID     rid   = rid_of(i);
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&value), &rid));
+  }
+  ASSERT_EQ(RC::SUCCESS, handler.sync());
+  ASSERT_EQ(RC::SUCCESS, handler.wait_for_background());
+  ASSERT_TRUE(scan(handler, nullptr, false, nullptr, false).empty());
+
+  handler.close();
+  LsmTreeHandler::remove_run_files(INDEX_NAME);
+  ::remove(INDEX_NAME);
+}
+
+TEST(lsm_tree, unique)
+{
+  LsmTreeHandler::remove_run_files(INDEX_NAME);
+  ::remove(INDEX_NAME);
+
+  LsmTreeHandler handler;
+  handler.set_unique(1);
+  handler.set_memtable_size(1024);
+  ASSERT_EQ(RC::SUCCESS, handler.create(INDEX_NAME, {INTS}, {sizeof(int32_t)}));
+
+  for (int i = 0; i < 1000; i++) {
+    const int32_t value = i;
+    const RID     rid   = rid_of(i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+  }
+  ASSERT_EQ(RC::SUCCESS, handler.sync());
+
+  // 已经写到有序段中的值也要检查
+  const int32_t value = 10;
+  const RID     rid   = rid_of(2000);
+  ASSERT_EQ(RC::RECORD_DUPLICATE_KEY, handler.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+
+  // 删除之后可以再插入
+  const RID old_rid = rid_of(10);
+  ASSERT_EQ(RC::SUCCESS, handler.delete_entry(reinterpret_cast<const char *>(&value), &old_rid));
+  ASSERT_EQ(RC::SUCCESS, handler.insert_entry(reinterpret_cast<const char *>(&value), &rid));
+  ASSERT_EQ((vector<RID>{rid}), lookup(handler, value));
+
+  handler.close();
+  LsmTreeHandler::remove_run_files(INDEX_NAME);
+  ::remove(INDEX_NAME);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,372 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/clog/clog.h"
+#include "storage/record/record_manager.h"
+#include "storage/table/table.h"
+#include "storage/table/table_stats.h"
+#include "storage/trx/mvcc_trx.h"
+
+using namespace std;
+using namespace common;
+
+/**
+ * @brief 一张 (id int) 的表，所有的修改都通过 MVCC 事务进行
+ */
+class MvccTrxTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_NE(nullptr, mkdtemp(base_dir_));
+    ASSERT_EQ(RC::SUCCESS, log_manager_.init(base_dir_));
+
+    AttrInfoSqlNode attr;
+    attr.type   = INTS;
+    attr.name   = "id";
+    attr.length = 4;
+
+    table_            = make_unique<Table>();
+    const string path = string(base_dir_) + "/t.table";
+    ASSERT_EQ(RC::SUCCESS, table_->create(1, path.c_str(), "t", base_dir_, 1, &attr));
+  }
+
+  void TearDown() override
+  {
+    table_.reset();
+    filesystem::remove_all(base_dir_);
+  }
+
+  MvccTrxKit &trx_kit() { return *static_cast<MvccTrxKit *>(TrxKit::instance()); }
+
+  /**
+   * @brief 在事务中插入一行
+   */
+  void insert(Trx *trx, int id)
+  {
+    Value  value(id);
+    Record record;
+    ASSERT_EQ(RC::SUCCESS, table_->make_record(1, &value, record));
+    ASSERT_EQ(RC::SUCCESS, trx->insert_record(table_.get(), record));
+  }
+
+  /**
+   * @brief 在事务中删除 id 相同的行
+   */
+  void remove(Trx *trx, int id)
+  {
+    RecordFileScanner scanner;
+    ASSERT_EQ(RC::SUCCESS, table_->get_record_scanner(scanner, trx, false /*readonly*/));
+    const FieldMeta *id_meta = table_->table_meta().field("id");
+    Record           record;
+    while (scanner.has_next()) {
+      ASSERT_EQ(RC::SUCCESS, scanner.next(record));
+      if (*reinterpret_cast<const int *>(record.data() + id_meta->offset()) == id) {
+        ASSERT_EQ(RC::SUCCESS, trx->delete_record(table_.get(), record));
+      }
+    }
+    scanner.close_scan();
+  }
+
+  /**
+   * @brief 事务能看到的所有 id
+   */
+  vector<int> scan(Trx *trx)
+  {
+    vector<int>       ids;
+    RecordFileScanner scanner;
+    EXPECT_EQ(RC::SUCCESS, table_->get_record_scanner(scanner, trx, true /*readonly*/));
+    const FieldMeta *id_meta = table_->table_meta().field("id");
+    Record           record;
+    while (scanner.has_next()) {
+      EXPECT_EQ(RC::SUCCESS, scanner.next(record));
+      ids.push_back(*reinterpret_cast<const int *>(record.data() + id_meta->offset()));
+    }
+    scanner.close_scan();
+    return ids;
+  }
+
+  /**
+   * @brief 表中实际存放的记录数，不考虑可见性
+   */
+  int physical_rows()
+  {
+    int               count = 0;
+    RecordFileScanner scanner;
+    EXPECT_EQ(RC::SUCCESS, table_->get_record_scanner(scanner, nullptr /*trx*/, true /*readonly*/));
+    Record record;
+    while (scanner.has_next()) {
+      EXPECT_EQ(RC::SUCCESS, scanner.next(record));
+      count++;
+    }
+    scanner.close_scan();
+    return count;
+  }
+
+  /**
+   * @brief 自动提交模式下的只读语句：只读快照事务
+   */
+  Trx *snapshot()
+  {
+    Trx *trx = trx_kit().create_trx(&log_manager_);
+    EXPECT_EQ(RC::SUCCESS, trx->start_readonly_if_need());
+    return trx;
+  }
+
+  char              base_dir_[32] = "mvcc_trx_test.XXXXXX";
+  CLogManager       log_manager_;
+  unique_ptr<Table> table_;
+};
+
+// 只读快照看不到并发的未提交写入，写入提交之后新的快照可以看到。
+// 快照在提交之前获取时，提交之后也看不到
+TEST_F(MvccTrxTest, snapshot_read_concurrent_insert)
+{
+  Trx *writer = trx_kit().create_trx(&log_manager_);
+  ASSERT_EQ(RC::SUCCESS, writer->start_if_need());
+  insert(writer, 1);
+
+  // 写事务自己可以看到
+  ASSERT_EQ(vector<int>{1}, scan(writer));
+
+  // 快照号可能等于正在写的事务号，未提交的插入也不可见
+  Trx *before_commit = snapshot();
+  ASSERT_EQ(writer->id(), before_commit->id());
+  ASSERT_TRUE(scan(before_commit).empty());
+
+  ASSERT_EQ(RC::SUCCESS, writer->commit());
+  ASSERT_TRUE(scan(before_commit).empty());
+
+  Trx *after_commit = snapshot();
+  ASSERT_EQ(vector<int>{1}, scan(after_commit));
+
+  // 只读快照的提交什么都不做，也不消耗新的事务号
+  const int32_t current_trx_id = trx_kit().current_trx_id();
+  ASSERT_EQ(RC::SUCCESS, before_commit->commit());
+  ASSERT_EQ(RC::SUCCESS, after_commit->commit());
+  ASSERT_EQ(current_trx_id, trx_kit().current_trx_id());
+
+  // 只读快照不能修改数据
+  Trx   *readonly = snapshot();
+  Value  value(2);
+  Record record;
+  ASSERT_EQ(RC::SUCCESS, table_->make_record(1, &value, record));
+  ASSERT_NE(RC::SUCCESS, readonly->insert_record(table_.get(), record));
+
+  trx_kit().destroy_trx(readonly);
+  trx_kit().destroy_trx(after_commit);
+  trx_kit().destroy_trx(before_commit);
+  trx_kit().destroy_trx(writer);
+}
+
+// 不经过事务直接写入表中的数据(load data)没有事务号，只读快照也要能看到，删除提交之后看不到
+TEST_F(MvccTrxTest, snapshot_read_rows_without_xid)
+{
+  vector<Record> records(3);
+  for (int i = 0; i < 3; i++) {
+    Value value(i);
+    ASSERT_EQ(RC::SUCCESS, table_->make_record(1, &value, records[i]));
+  }
+  ASSERT_EQ(RC::SUCCESS, table_->insert_records(records));
+
+  Trx *before_delete = snapshot();
+  ASSERT_EQ(vector<int>({0, 1, 2}), scan(before_delete));
+
+  Trx *writer = trx_kit().create_trx(&log_manager_);
+  ASSERT_EQ(RC::SUCCESS, writer->start_if_need());
+  remove(writer, 1);
+
+  // 未提交的删除对快照不起作用
+  Trx *uncommitted = snapshot();
+  ASSERT_EQ(vector<int>({0, 1, 2}), scan(uncommitted));
+
+  ASSERT_EQ(RC::SUCCESS, writer->commit());
+  ASSERT_EQ(vector<int>({0, 1, 2}), scan(before_delete));
+  ASSERT_EQ(vector<int>({0, 1, 2}), scan(uncommitted));
+
+  Trx *after_delete = snapshot();
+  ASSERT_EQ(vector<int>({0, 2}), scan(after_delete));
+
+  trx_kit().destroy_trx(after_delete);
+  trx_kit().destroy_trx(uncommitted);
+  trx_kit().destroy_trx(writer);
+  trx_kit().destroy_trx(before_delete);
+}
+
+// 未提交的删除对只读快照不生效，删除提交之后新的快照才看不到
+TEST_F(MvccTrxTest, snapshot_read_concurrent_delete)
+{
+  Trx *writer = trx_kit().create_trx(&log_manager_);
+  ASSERT_EQ(RC::SUCCESS, writer->start_if_need());
+  insert(writer, 1);
+  insert(writer, 2);
+  ASSERT_EQ(RC::SUCCESS, writer->commit());
+  trx_kit().destroy_trx(writer);
+
+  Trx *deleter = trx_kit().create_trx(&log_manager_);
+  ASSERT_EQ(RC::SUCCESS, deleter->start_if_need());
+  remove(deleter, 1);
+  ASSERT_EQ(vector<int>{2}, scan(deleter));
+
+  Trx *before_commit = snapshot();
+  ASSERT_EQ((vector<int>{1, 2}), scan(before_commit));
+
+  ASSERT_EQ(RC::SUCCESS, deleter->commit());
+  ASSERT_EQ((vector<int>{1, 2}), scan(before_commit));
+
+  Trx *after_commit = snapshot();
+  ASSERT_EQ(vector<int>{2}, scan(after_commit));
+
+  // 回滚的写入对之后的快照也不可见
+  Trx *rollbacker = trx_kit().create_trx(&log_manager_);
+  ASSERT_EQ(RC::SUCCESS, rollbacker->start_if_need());
+  insert(rollbacker, 3);
+  ASSERT_EQ(RC::SUCCESS, rollbacker->rollback());
+  Trx *after_rollback = snapshot();
+  ASSERT_EQ(vector<int>{2}, scan(after_rollback));
+
+  trx_kit().destroy_trx(after_rollback);
+  trx_kit().destroy_trx(rollbacker);
+  trx_kit().destroy_trx(after_commit);
+  trx_kit().destroy_trx(before_commit);
+  trx_kit().destroy_trx(deleter);
+}
+
+// 一个事务在多个页面上交替插入和删除，提交和回滚时按照页面分组处理，每个页面上的操作都要正确处理
+TEST_F(MvccTrxTest, rollback_and_commit_across_pages)
+{
+  const int row_num = 3000;  // 每行只有12个字节，占用多个页面
+  Trx      *loader  = trx_kit().create_trx(&log_manager_);
+  ASSERT_EQ(RC::SUCCESS, loader->start_if_need());
+  for (int id = 0; id < row_num; id++) {
+    insert(loader, id);
+  }
+  ASSERT_EQ(RC::SUCCESS, loader->commit());
+  trx_kit().destroy_trx(loader);
+  ASSERT_GT(table_->data_page_count(), 3);
+
+  vector<int> original;
+  for (int id = 0; id < row_num; id++) {
+    original.push_back(id);
+  }
+
+  // 删除分布在所有页面上，和插入交替进行，插入的记录追加到后面的页面上
+  auto modify = [this](Trx *trx) {
+    for (int id = 0; id < row_num; id += 3) {
+      remove(trx, id);
+      insert(trx, row_num + id);
+      insert(trx, row_num * 2 + id);
+    }
+  };
+
+  Trx *rollbacker = trx_kit().create_trx(&log_manager_);
+  ASSERT_EQ(RC::SUCCESS, rollbacker->start_if_need());
+  modify(rollbacker);
+  ASSERT_EQ(RC::SUCCESS, rollbacker->rollback());
+  trx_kit().destroy_trx(rollbacker);
+
+  // 回滚时插入的记录真正删除，删除的记录恢复可见
+  ASSERT_EQ(row_num, physical_rows());
+
+  Trx        *after_rollback = snapshot();
+  vector<int> ids            = scan(after_rollback);
+  sort(ids.begin(), ids.end());
+  ASSERT_EQ(original, ids);
+  trx_kit().destroy_trx(after_rollback);
+
+  // 回滚之后再做一次同样的修改并提交
+  Trx *committer = trx_kit().create_trx(&log_manager_);
+  ASSERT_EQ(RC::SUCCESS, committer->start_if_need());
+  modify(committer);
+  ASSERT_EQ(RC::SUCCESS, committer->commit());
+  trx_kit().destroy_trx(committer);
+
+  vector<int> expected;
+  for (int id = 0; id < row_num; id++) {
+    if (id % 3 != 0) {
+      expected.push_back(id);
+    } else {
+      expected.push_back(row_num + id);
+      expected.push_back(row_num * 2 + id);
+    }
+  }
+  sort(expected.begin(), expected.end());
+
+  Trx *after_commit = snapshot();
+  ids               = scan(after_commit);
+  sort(ids.begin(), ids.end());
+  ASSERT_EQ(expected, ids);
+  trx_kit().destroy_trx(after_commit);
+}
+
+// ANALYZE 只统计有效的记录：已经提交删除的记录和没有提交的插入都不算，没有提交的删除仍然算
+TEST_F(MvccTrxTest, analyze_skips_deleted_and_uncommitted_records)
+{
+  Trx *loader = trx_kit().create_trx(&log_manager_);
+  ASSERT_EQ(RC::SUCCESS, loader->start_if_need());
+  for (int id = 0; id < 100; id++) {
+    insert(loader, id);
+  }
+  ASSERT_EQ(RC::SUCCESS, loader->commit());
+  trx_kit().destroy_trx(loader);
+
+  Trx *deleter = trx_kit().create_trx(&log_manager_);
+  ASSERT_EQ(RC::SUCCESS, deleter->start_if_need());
+  for (int id = 0; id < 40; id++) {
+    remove(deleter, id);
+  }
+  ASSERT_EQ(RC::SUCCESS, deleter->commit());
+  trx_kit().destroy_trx(deleter);
+
+  Trx *inserter = trx_kit().create_trx(&log_manager_);
+  ASSERT_EQ(RC::SUCCESS, inserter->start_if_need());
+  for (int id = 100; id < 120; id++) {
+    insert(inserter, id);
+  }
+  Trx *uncommitted_deleter = trx_kit().create_trx(&log_manager_);
+  ASSERT_EQ(RC::SUCCESS, uncommitted_deleter->start_if_need());
+  for (int id = 50; id < 60; id++) {
+    remove(uncommitted_deleter, id);
+  }
+
+  const FieldMeta *id_meta = table_->table_meta().field("id");
+  ASSERT_EQ(RC::SUCCESS, table_->analyze({id_meta}));
+  std::shared_ptr<const TableStats> stats = table_->stats();
+  ASSERT_EQ(60, stats->row_count());
+  ASSERT_NEAR(60, stats->column("id")->distinct_count, 2);
+  ASSERT_EQ(40, stats->column("id")->bounds.front().get_int());
+  ASSERT_EQ(99, stats->column("id")->bounds.back().get_int());
+
+  ASSERT_EQ(RC::SUCCESS, inserter->rollback());
+  ASSERT_EQ(RC::SUCCESS, uncommitted_deleter->rollback());
+  trx_kit().destroy_trx(uncommitted_deleter);
+  trx_kit().destroy_trx(inserter);
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("mvcc_trx_test.log", LOG_LEVEL_INFO);
+  BufferPoolManager::set_instance(new BufferPoolManager());
+  if (TrxKit::init_global("mvcc") != RC::SUCCESS) {
+    return 1;
+  }
+  return RUN_ALL_TESTS();
+}
@@ -16,7 +16,9 @@ See the Mulan PSL v2 for more details. */
 #include <string.h>
 
 #include "storage/buffer/disk_buffer_pool.h"
+#include "storage/common/condition_filter.h"
 #include "storage/record/record_manager.h"
+#include "storage/table/table_meta.h"
 #include "storage/trx/vacuous_trx.h"
 #include "gtest/gtest.h"
 
@@ -104,6 +106,13 @@ TEST(test_record_page_handler, test_record_page_handler)
   }
   ASSERT_EQ(count, 6);
 
+  // 删除的槽位是空的，超出页面容量的槽位也不能访问
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(i % 2 != 0, record_page_handle.is_slot_used(i));
+  }
+  ASSERT_FALSE(record_page_handle.is_slot_used(-1));
+  ASSERT_FALSE(record_page_handle.is_slot_used(BP_PAGE_DATA_SIZE));
+
   record_page_handle.cleanup();
   bpm->close_file(record_manager_file);
   delete bpm;
@@ -184,6 +193,309 @@ TEST(test_record_page_handler, test_record_file_iterator)
   delete bpm;
 }
 
+TEST(test_record_page_handler, test_record_file_scanner_filter)
+{
+  const char *record_manager_file = "record_manager.bp";
+  ::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  DiskBufferPool    *bp  = nullptr;
+  RC                 rc  = bpm->create_file(record_manager_file);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  rc = bpm->open_file(record_manager_file, bp);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  RecordFileHandler file_handler;
+  rc = file_handler.init(bp);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  const int record_insert_num = 1000;
+  char      record_data[20];
+  memset(record_data, 0, sizeof(record_data));
+  for (int i = 0; i < record_insert_num; i++) {
+    memcpy(record_data, &i, sizeof(i));
+    RID rid;
+    rc = file_handler.insert_record(record_data, sizeof(record_data), &rid);
+    ASSERT_EQ(rc, RC::SUCCESS);
+  }
+
+  // 第一个字段 >= 900
+  ConDesc left;
+  left.is_attr     = true;
+  left.attr_length = sizeof(int);
+  left.attr_offset = 0;
+  ConDesc right;
+  right.is_attr     = false;
+  right.attr_length = 0;
+  right.attr_offset = 0;
+  right.value       = Value(900);
+
+  DefaultConditionFilter filter;
+  rc = filter.init(left, right, INTS, GREAT_EQUAL);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  VacuousTrx        trx;
+  RecordFileScanner file_scanner;
+  rc = file_scanner.open_scan(nullptr /*table*/, *bp, &trx, true /*readonly*/, &filter);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  int    count = 0;
+  Record record;
+  while (file_scanner.has_next()) {
+    rc = file_scanner.next(record);
+    ASSERT_EQ(rc, RC::SUCCESS);
+    int value = 0;
+    memcpy(&value, record.data(), sizeof(value));
+    ASSERT_GE(value, 900);
+    count++;
+  }
+  file_scanner.close_scan();
+  ASSERT_EQ(count, 100);
+
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
+TEST(test_record_page_handler, test_record_free_space_map)
+{
+  const char *record_manager_file = "record_manager.bp";
+  ::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  DiskBufferPool    *bp  = nullptr;
+  RC                 rc  = bpm->create_file(record_manager_file);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  rc = bpm->open_file(record_manager_file, bp);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  const int        record_insert_num = 2000;
+  char             record_data[20];
+  std::vector<RID> rids;
+  PageNum          max_page_num = 0;
+  {
+    RecordFileHandler file_handler;
+    rc = file_handler.init(bp);
+    ASSERT_EQ(rc, RC::SUCCESS);
+
+    for (int i = 0; i < record_insert_num; i++) {
+      RID rid;
+      rc = file_handler.insert_record(record_data, sizeof(record_data), &rid);
+      ASSERT_EQ(rc, RC::SUCCESS);
+      rids.push_back(rid);
+      max_page_num = std::max(max_page_num, rid.page_num);
+    }
+
+    for (int i = 0; i < record_insert_num; i += 2) {
+      rc = file_handler.delete_record(&rids[i]);
+      ASSERT_EQ(rc, RC::SUCCESS);
+    }
+    file_handler.close();
+  }
+
+  bpm->close_file(record_manager_file);
+  rc = bpm->open_file(record_manager_file, bp);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  // 重新打开后，空闲空间映射从文件中加载，删除记录腾出来的空间可以直接复用，不需要分配新的页面
+  RecordFileHandler file_handler;
+  rc = file_handler.init(bp);
+  ASSERT_EQ(rc, RC::SUCCESS);
+  for (int i = 0; i < record_insert_num / 2; i++) {
+    RID rid;
+    rc = file_handler.insert_record(record_data, sizeof(record_data), &rid);
+    ASSERT_EQ(rc, RC::SUCCESS);
+    ASSERT_LE(rid.page_num, max_page_num);
+  }
+
+  VacuousTrx        trx;
+  RecordFileScanner file_scanner;
+  rc = file_scanner.open_scan(nullptr /*table*/, *bp, &trx, true /*readonly*/, nullptr /*condition_filter*/);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  int    count = 0;
+  Record record;
+  while (file_scanner.has_next()) {
+    rc = file_scanner.next(record);
+    ASSERT_EQ(rc, RC::SUCCESS);
+    count++;
+  }
+  file_scanner.close_scan();
+  ASSERT_EQ(count, record_insert_num);
+
+  file_handler.close();
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
+TEST(test_record_page_handler, test_free_space_map_find_free_page)
+{
+  const char *record_manager_file = "record_manager.bp";
+  ::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  DiskBufferPool    *bp  = nullptr;
+  ASSERT_EQ(RC::SUCCESS, bpm->create_file(record_manager_file));
+  ASSERT_EQ(RC::SUCCESS, bpm->open_file(record_manager_file, bp));
+
+  RecordFreeSpaceMap free_space_map;
+  ASSERT_EQ(RC::SUCCESS, free_space_map.create(*bp));
+  ASSERT_EQ(BP_INVALID_PAGE_NUM, free_space_map.find_free_page(0));
+
+  // 空闲页面分散在不同的组中，查找时从 start_page 开始转一圈
+  const PageNum first_page = free_space_map.map_page_count() + 1;
+  const PageNum low_page   = first_page + 10;
+  const PageNum high_page  = first_page + 1000;
+  const PageNum empty_page = first_page + 5000;
+  ASSERT_EQ(RC::SUCCESS, free_space_map.update(low_page, RecordFreeSpaceMap::LOW));
+  ASSERT_EQ(RC::SUCCESS, free_space_map.update(high_page, RecordFreeSpaceMap::HIGH));
+  ASSERT_EQ(RC::SUCCESS, free_space_map.update(empty_page, RecordFreeSpaceMap::EMPTY));
+
+  ASSERT_EQ(low_page, free_space_map.find_free_page(0));
+  ASSERT_EQ(low_page, free_space_map.find_free_page(low_page));
+  ASSERT_EQ(high_page, free_space_map.find_free_page(low_page + 1));
+  ASSERT_EQ(empty_page, free_space_map.find_free_page(high_page + 1));
+  ASSERT_EQ(low_page, free_space_map.find_free_page(empty_page + 1));
+  ASSERT_EQ(high_page, free_space_map.find_free_page(0, RecordFreeSpaceMap::HIGH));
+  ASSERT_EQ(high_page, free_space_map.find_free_page(empty_page + 1, RecordFreeSpaceMap::HIGH));
+  ASSERT_EQ(empty_page, free_space_map.find_free_page(high_page + 1, RecordFreeSpaceMap::EMPTY));
+  ASSERT_EQ(empty_page, free_space_map.find_free_page(empty_page + 1, RecordFreeSpaceMap::EMPTY));
+
+  // 同一个组中的页面变满之后，组内的其它空闲页面依然可以找到
+  ASSERT_EQ(RC::SUCCESS, free_space_map.update(low_page + 1, RecordFreeSpaceMap::HIGH));
+  ASSERT_EQ(RC::SUCCESS, free_space_map.update(low_page, RecordFreeSpaceMap::FULL));
+  ASSERT_EQ(low_page + 1, free_space_map.find_free_page(0));
+  ASSERT_EQ(low_page + 1, free_space_map.find_free_page(empty_page + 1, RecordFreeSpaceMap::HIGH));
+
+  for (PageNum page_num : {low_page + 1, high_page, empty_page}) {
+    ASSERT_EQ(RC::SUCCESS, free_space_map.update(page_num, RecordFreeSpaceMap::FULL));
+  }
+  ASSERT_EQ(BP_INVALID_PAGE_NUM, free_space_map.find_free_page(0));
+
+  // 只剩 start_page 所在组中前面的页面时，转一圈回到这个组再找。相隔很远的组直接通过位图找到
+  const PageNum far_page = first_page + 60000;
+  ASSERT_EQ(RC::SUCCESS, free_space_map.update(high_page, RecordFreeSpaceMap::HIGH));
+  ASSERT_EQ(high_page, free_space_map.find_free_page(high_page + 1));
+  ASSERT_EQ(RC::SUCCESS, free_space_map.update(far_page, RecordFreeSpaceMap::EMPTY));
+  ASSERT_EQ(far_page, free_space_map.find_free_page(high_page + 1));
+  ASSERT_EQ(high_page, free_space_map.find_free_page(far_page + 1));
+  ASSERT_EQ(far_page, free_space_map.find_free_page(0, RecordFreeSpaceMap::EMPTY));
+  ASSERT_EQ(RC::SUCCESS, free_space_map.update(far_page, RecordFreeSpaceMap::FULL));
+  ASSERT_EQ(BP_INVALID_PAGE_NUM, free_space_map.find_free_page(0, RecordFreeSpaceMap::EMPTY));
+  ASSERT_EQ(high_page, free_space_map.find_free_page(far_page + 1));
+
+  free_space_map.close();
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
+TEST(test_record_page_handler, test_varlen_record_file)
+{
+  const char *record_manager_file = "record_manager.bp";
+  ::remove(record_manager_file);
+
+  BufferPoolManager *bpm = new BufferPoolManager();
+  DiskBufferPool    *bp  = nullptr;
+  RC                 rc  = bpm->create_file(record_manager_file);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  rc = bpm->open_file(record_manager_file, bp);
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  AttrInfoSqlNode attrs[2];
+  attrs[0].type   = INTS;
+  attrs[0].name   = "id";
+  attrs[0].length = 4;
+  attrs[1].type   = CHARS;
+  attrs[1].name   = "name";
+  attrs[1].length = 6000;
+
+  if (TrxKit::instance() == nullptr) {
+    ASSERT_EQ(TrxKit::init_global("vacuous"), RC::SUCCESS);
+  }
+
+  TableMeta table_meta;
+  rc = table_meta.init(0, "t", 2, attrs, StorageFormat::VARLEN_FORMAT);
+  ASSERT_EQ(rc, RC::SUCCESS);
+  const int record_size = table_meta.record_size();
+  const int id_offset   = table_meta.field("id")->offset();
+  const int name_offset = table_meta.field("name")->offset();
+
+  RecordFileHandler file_handler;
+  rc = file_handler.init(bp, &table_meta);
+  ASSERT_EQ(rc, RC::SUCCESS);
+  ASSERT_EQ(file_handler.storage_format(), StorageFormat::VARLEN_FORMAT);
+
+  // 短记录只占用实际的长度，每隔一段插入一条超过一个页面的长记录，放在溢出页面中
+  const int         record_insert_num = 1000;
+  std::vector<char> record_data(record_size);
+  std::vector<RID>  rids;
+  for (int i = 0; i < record_insert_num; i++) {
+    memset(record_data.data(), 0, record_size);
+    memcpy(record_data.data() + id_offset, &i, sizeof(i));
+    const int name_len = (i % 100 == 0) ? 5000 : i % 50;
+    memset(record_data.data() + name_offset, 'a' + i % 26, name_len);
+
+    RID rid;
+    rc = file_handler.insert_record(record_data.data(), record_size, &rid);
+    ASSERT_EQ(rc, RC::SUCCESS);
+    rids.push_back(rid);
+  }
+
+  // 定长格式下每个页面只能放一条记录
+  ASSERT_LT(rids.back().page_num, record_insert_num / 10);
+
+  // 每条长记录占用一个溢出页面，记录页面数不包括溢出页面和空闲空间映射页面
+  const int overflow_pages = record_insert_num / 100;
+  ASSERT_EQ(file_handler.data_page_count(), bp->allocated_pages() - 1 - 3 - overflow_pages);
+  ASSERT_EQ(file_handler.data_page_count(), rids.back().page_num - 3 - overflow_pages);
+  const int data_pages = file_handler.data_page_count();
+
+  for (int i = 0; i < record_insert_num; i += 3) {
+    rc = file_handler.delete_record(&rids[i]);
+    ASSERT_EQ(rc, RC::SUCCESS);
+  }
+
+  for (int i = 0; i < record_insert_num; i++) {
+    bool visited = false;
+    rc           = file_handler.visit_record(rids[i], true /*readonly*/, [&](Record &record) {
+      visited = true;
+      ASSERT_EQ(record.len(), record_size);
+      ASSERT_EQ(0, memcmp(record.data() + id_offset, &i, sizeof(i)));
+
+      const int name_len = (i % 100 == 0) ? 5000 : i % 50;
+      ASSERT_EQ((int)strnlen(record.data() + name_offset, 6000), name_len);
+      ASSERT_TRUE(name_len == 0 || record.data()[name_offset + name_len - 1] == 'a' + i % 26);
+    });
+    if (i % 3 == 0) {
+      ASSERT_NE(rc, RC::SUCCESS);
+      ASSERT_FALSE(visited);
+    } else {
+      ASSERT_EQ(rc, RC::SUCCESS);
+      ASSERT_TRUE(visited);
+    }
+  }
+
+  // 修改记录会重新编码写回页面，RID 保持不变
+  rc = file_handler.visit_record(rids[1], false /*readonly*/, [&](Record &record) {
+    memset(record.data() + name_offset, 'z', 4000);
+  });
+  ASSERT_EQ(rc, RC::SUCCESS);
+  rc = file_handler.visit_record(rids[1], true /*readonly*/, [&](Record &record) {
+    ASSERT_EQ((int)strnlen(record.data() + name_offset, 6000), 4000);
+  });
+  ASSERT_EQ(rc, RC::SUCCESS);
+
+  // 删除了 4 条长记录，释放它们的溢出页面，修改后的记录新占用一个溢出页面，记录页面数不变
+  ASSERT_EQ(file_handler.data_page_count(), data_pages);
+  ASSERT_EQ(file_handler.data_page_count(), bp->allocated_pages() - 1 - 3 - (overflow_pages - 4 + 1));
+
+  file_handler.close();
+  bpm->close_file(record_manager_file);
+  delete bpm;
+}
+
 int main(int argc, char **argv)
 {
   // 分析gtest程序的命令行参数
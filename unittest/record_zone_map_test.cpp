@@ -0,0 +1,134 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <unistd.h>
+
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+#include "storage/field/field_meta.h"
+#include "storage/record/record_zone_map.h"
+
+using namespace std;
+using namespace common;
+
+static const char *ZONE_MAP_FILE = "record_zone_map_test.zonemap";
+
+static void update_value(RecordZoneMap &zone_map, PageNum page_num, int32_t value)
+{
+  zone_map.update(page_num, reinterpret_cast<const char *>(&value));
+}
+
+static vector<ZoneMapCondition> conditions(CompOp comp, int32_t value)
+{
+  ZoneMapCondition condition;
+  condition.field_offset = 0;
+  condition.comp         = comp;
+  condition.value.set_int(value);
+  return {condition};
+}
+
+class RecordZoneMapTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ::unlink(ZONE_MAP_FILE);
+    field_metas_.push_back(&field_meta_);
+  }
+
+  void TearDown() override { ::unlink(ZONE_MAP_FILE); }
+
+  FieldMeta                field_meta_{"v", INTS, 0 /*offset*/, 4 /*len*/, true /*visible*/};
+  vector<const FieldMeta *> field_metas_;
+};
+
+// 页面上记录的范围与条件没有交集时跳过页面，没有插入过记录的页面也跳过
+TEST_F(RecordZoneMapTest, skip_pages)
+{
+  RecordZoneMap zone_map;
+  bool          found = true;
+  ASSERT_EQ(RC::SUCCESS, zone_map.open(ZONE_MAP_FILE, field_metas_, found));
+  ASSERT_FALSE(found);
+  ASSERT_TRUE(zone_map.enabled());
+
+  for (int32_t value = 1; value <= 10; value++) {
+    update_value(zone_map, 1, value);
+    update_value(zone_map, 3, value + 100);
+  }
+
+  ASSERT_TRUE(zone_map.may_match(1, conditions(EQUAL_TO, 5)));
+  ASSERT_FALSE(zone_map.may_match(3, conditions(EQUAL_TO, 5)));
+  ASSERT_FALSE(zone_map.may_match(1, conditions(GREAT_THAN, 10)));
+  ASSERT_TRUE(zone_map.may_match(3, conditions(GREAT_THAN, 10)));
+  ASSERT_TRUE(zone_map.may_match(1, conditions(LESS_EQUAL, 1)));
+  ASSERT_FALSE(zone_map.may_match(3, conditions(LESS_THAN, 101)));
+  ASSERT_FALSE(zone_map.may_match(2, conditions(GREAT_THAN, 0)));
+  ASSERT_FALSE(zone_map.may_match(100, conditions(GREAT_THAN, 0)));
+
+  // 更新之后页面的范围扩大，新的值不会被跳过
+  update_value(zone_map, 1, 1000);
+  ASSERT_TRUE(zone_map.may_match(1, conditions(EQUAL_TO, 1000)));
+  ASSERT_TRUE(zone_map.may_match(1, conditions(GREAT_THAN, 10)));
+  ASSERT_EQ(RC::SUCCESS, zone_map.close());
+}
+
+// 正常关闭之后文件一直保留，打开时加载。打开之后文件标记为无效，没有关闭(进程崩溃)就需要重建
+TEST_F(RecordZoneMapTest, reopen_and_crash)
+{
+  {
+    RecordZoneMap zone_map;
+    bool          found = true;
+    ASSERT_EQ(RC::SUCCESS, zone_map.open(ZONE_MAP_FILE, field_metas_, found));
+    ASSERT_FALSE(found);
+    update_value(zone_map, 1, 10);
+    ASSERT_EQ(RC::SUCCESS, zone_map.close());
+  }
+  ASSERT_EQ(0, ::access(ZONE_MAP_FILE, F_OK));
+
+  {
+    RecordZoneMap zone_map;
+    bool          found = false;
+    ASSERT_EQ(RC::SUCCESS, zone_map.open(ZONE_MAP_FILE, field_metas_, found));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(0, ::access(ZONE_MAP_FILE, F_OK));
+    ASSERT_TRUE(zone_map.may_match(1, conditions(EQUAL_TO, 10)));
+    ASSERT_FALSE(zone_map.may_match(1, conditions(EQUAL_TO, 20)));
+
+    // 加载之后的修改只在内存中，这里不关闭，模拟进程崩溃
+    update_value(zone_map, 1, 20);
+    ASSERT_TRUE(zone_map.may_match(1, conditions(EQUAL_TO, 20)));
+  }
+
+  {
+    RecordZoneMap zone_map;
+    bool          found = true;
+    ASSERT_EQ(RC::SUCCESS, zone_map.open(ZONE_MAP_FILE, field_metas_, found));
+    ASSERT_FALSE(found);
+
+    // 重建之后正常关闭，下次又可以加载了
+    update_value(zone_map, 1, 10);
+    update_value(zone_map, 1, 20);
+    ASSERT_EQ(RC::SUCCESS, zone_map.close());
+  }
+
+  RecordZoneMap zone_map;
+  bool          found = false;
+  ASSERT_EQ(RC::SUCCESS, zone_map.open(ZONE_MAP_FILE, field_metas_, found));
+  ASSERT_TRUE(found);
+  ASSERT_TRUE(zone_map.may_match(1, conditions(EQUAL_TO, 20)));
+  ASSERT_EQ(RC::SUCCESS, zone_map.close());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("record_zone_map_test.log", LOG_LEVEL_INFO);
+  return RUN_ALL_TESTS();
+}
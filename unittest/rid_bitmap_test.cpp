@@ -0,0 +1,88 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/record/rid_bitmap.h"
+
+using namespace std;
+
+static vector<RID> to_rids(const RidBitmap &bitmap)
+{
+  vector<RID>     rids;
+  vector<SlotNum> slot_nums;
+  for (const auto &[page_num, words] : bitmap.pages()) {
+    RidBitmap::collect_slots(words, slot_nums);
+    for (SlotNum slot_num : slot_nums) {
+      rids.emplace_back(page_num, slot_num);
+    }
+  }
+  return rids;
+}
+
+TEST(rid_bitmap, page_order)
+{
+  RidBitmap bitmap;
+  // 按照索引顺序加入的RID是乱序的，还有重复的
+  bitmap.add(RID(7, 130));
+  bitmap.add(RID(2, 3));
+  bitmap.add(RID(7, 1));
+  bitmap.add(RID(2, 3));
+  bitmap.add(RID(5, 64));
+  bitmap.add(RID(2, 0));
+
+  ASSERT_EQ(5, static_cast<int>(bitmap.size()));
+  ASSERT_EQ(3, static_cast<int>(bitmap.page_count()));
+  vector<RID> expected = {RID(2, 0), RID(2, 3), RID(5, 64), RID(7, 1), RID(7, 130)};
+  ASSERT_EQ(expected, to_rids(bitmap));
+}
+
+TEST(rid_bitmap, intersect_and_union)
+{
+  RidBitmap left;
+  RidBitmap right;
+  for (int i = 0; i < 1000; i++) {
+    if (i % 2 == 0) {
+      left.add(RID(i / 100 + 1, i % 100));
+    }
+    if (i % 3 == 0) {
+      right.add(RID(i / 100 + 1, i % 100));
+    }
+  }
+  // 只在一边出现的页面
+  left.add(RID(100, 1));
+  right.add(RID(200, 1));
+
+  RidBitmap intersection = left;
+  intersection.intersect_with(right);
+  vector<RID> rids = to_rids(intersection);
+  ASSERT_EQ(167, static_cast<int>(rids.size()));
+  for (const RID &rid : rids) {
+    const int i = (rid.page_num - 1) * 100 + rid.slot_num;
+    ASSERT_EQ(0, i % 6);
+  }
+
+  RidBitmap united = left;
+  united.union_with(right);
+  ASSERT_EQ(500 + 334 - 167 + 2, static_cast<int>(united.size()));
+
+  // 没有交集时不留下空的页面
+  RidBitmap empty;
+  empty.add(RID(1, 1));
+  empty.intersect_with(right);
+  ASSERT_TRUE(empty.empty());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
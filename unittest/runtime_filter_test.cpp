@@ -0,0 +1,169 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+#include "sql/expr/tuple.h"
+#include "sql/operator/runtime_filter.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+using namespace common;
+
+/**
+ * @brief build 端和 probe 端各一张表，字段都是 (id int, name char(4))
+ */
+class RuntimeFilterTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_NE(nullptr, mkdtemp(base_dir_));
+    if (TrxKit::instance() == nullptr) {
+      ASSERT_EQ(TrxKit::init_global("vacuous"), RC::SUCCESS);
+    }
+
+    AttrInfoSqlNode attrs[2];
+    attrs[0].type   = INTS;
+    attrs[0].name   = "id";
+    attrs[0].length = 4;
+    attrs[1].type   = CHARS;
+    attrs[1].name   = "name";
+    attrs[1].length = 4;
+
+    const string build_path = string(base_dir_) + "/build_t.table";
+    const string probe_path = string(base_dir_) + "/probe_t.table";
+    ASSERT_EQ(RC::SUCCESS, build_table_.create(1, build_path.c_str(), "build_t", base_dir_, 2, attrs));
+    ASSERT_EQ(RC::SUCCESS, probe_table_.create(2, probe_path.c_str(), "probe_t", base_dir_, 2, attrs));
+  }
+
+  Field build_field(const char *name) { return Field(&build_table_, build_table_.table_meta().field(name)); }
+  Field probe_field(const char *name) { return Field(&probe_table_, probe_table_.table_meta().field(name)); }
+
+  /**
+   * @brief 把 build 端的一行放到过滤器中
+   */
+  void add_build_row(RuntimeFilter &filter, int id, const char *name)
+  {
+    Value  values[2] = {Value(id), Value(name)};
+    Record record;
+    ASSERT_EQ(RC::SUCCESS, build_table_.make_record(2, values, record));
+
+    RowTuple tuple;
+    tuple.set_schema(&build_table_, build_table_.table_meta().field_metas());
+    tuple.set_record(&record);
+    ASSERT_EQ(RC::SUCCESS, filter.add(tuple));
+  }
+
+  /**
+   * @brief probe 端的记录。trailing 不为空时，写在 name 字段的 '\0' 之后
+   */
+  bool probe(const RuntimeFilter &filter, int id, const char *name, const char *trailing = nullptr)
+  {
+    Value  values[2] = {Value(id), Value(name)};
+    Record record;
+    EXPECT_EQ(RC::SUCCESS, probe_table_.make_record(2, values, record));
+
+    vector<char> data(record.data(), record.data() + probe_table_.table_meta().record_size());
+    if (trailing != nullptr) {
+      const FieldMeta *name_meta = probe_table_.table_meta().field("name");
+      const size_t     name_len  = strlen(name);
+      memcpy(data.data() + name_meta->offset() + name_len + 1, trailing, name_meta->len() - name_len - 1);
+    }
+
+    Record probe_record;
+    probe_record.set_data(data.data(), static_cast<int>(data.size()));
+    return filter.filter(probe_record);
+  }
+
+  char  base_dir_[32] = "runtime_filter_test.XXXXXX";
+  Table build_table_;
+  Table probe_table_;
+};
+
+// build 端没有数据时，probe 端所有的记录都过滤掉
+TEST_F(RuntimeFilterTest, empty_build_side)
+{
+  RuntimeFilter int_filter(probe_field("id"), build_field("id"));
+  RuntimeFilter char_filter(probe_field("name"), build_field("name"));
+
+  // 还没有生成时不过滤
+  ASSERT_FALSE(int_filter.ready());
+  ASSERT_TRUE(probe(int_filter, 1, "a"));
+
+  int_filter.finish();
+  char_filter.finish();
+  for (int id : {-1, 0, 1, 100}) {
+    EXPECT_FALSE(probe(int_filter, id, "a")) << "id=" << id;
+  }
+  for (const char *name : {"", "a", "abcd"}) {
+    EXPECT_FALSE(probe(char_filter, 1, name)) << "name=" << name;
+  }
+  EXPECT_EQ(4, int_filter.checked_rows());
+  EXPECT_EQ(4, int_filter.filtered_rows());
+  EXPECT_EQ(3, char_filter.filtered_rows());
+}
+
+// 字符串只比较到第一个 '\0'，之后的字节不影响结果；占满整个字段的字符串没有 '\0'
+TEST_F(RuntimeFilterTest, chars_with_trailing_bytes)
+{
+  RuntimeFilter filter(probe_field("name"), build_field("name"));
+  add_build_row(filter, 1, "ab");
+  add_build_row(filter, 2, "abcd");
+  filter.finish();
+
+  EXPECT_TRUE(probe(filter, 1, "ab"));
+  EXPECT_TRUE(probe(filter, 1, "ab", "x"));
+  EXPECT_FALSE(probe(filter, 1, "a", "bc"));
+  EXPECT_TRUE(probe(filter, 1, "abcd"));
+  EXPECT_FALSE(probe(filter, 1, "abc"));
+  EXPECT_FALSE(probe(filter, 1, "", "ab"));
+}
+
+// 整数超出 build 端的最小值和最大值时一定过滤掉，范围内存在的值一定保留
+TEST_F(RuntimeFilterTest, ints_min_max)
+{
+  RuntimeFilter filter(probe_field("id"), build_field("id"));
+  for (int id = 100; id <= 200; id += 10) {
+    add_build_row(filter, id, "a");
+  }
+  filter.finish();
+
+  for (int id = 100; id <= 200; id += 10) {
+    EXPECT_TRUE(probe(filter, id, "a")) << "id=" << id;
+  }
+  for (int id : {-200, 0, 99, 201, 1000}) {
+    EXPECT_FALSE(probe(filter, id, "a")) << "id=" << id;
+  }
+  EXPECT_EQ(16, filter.checked_rows());
+  EXPECT_EQ(5, filter.filtered_rows());
+}
+
+TEST_F(RuntimeFilterTest, supported)
+{
+  EXPECT_TRUE(RuntimeFilter::supported(probe_field("id"), build_field("id")));
+  EXPECT_TRUE(RuntimeFilter::supported(probe_field("name"), build_field("name")));
+  EXPECT_FALSE(RuntimeFilter::supported(probe_field("id"), build_field("name")));
+}
+
+int main(int argc, char **argv)
+{
+  LoggerFactory::init_default("runtime_filter_test.log", LOG_LEVEL_INFO);
+  BufferPoolManager::set_instance(new BufferPoolManager());
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,219 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <chrono>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+
+#include "common/global_context.h"
+#include "common/log/log.h"
+#include "gtest/gtest.h"
+#include "storage/buffer/disk_buffer_pool.h"
+#include "storage/db/db.h"
+#include "storage/db/stats_refresher.h"
+#include "storage/table/table.h"
+#include "storage/trx/trx.h"
+
+using namespace std;
+using namespace common;
+
+/**
+ * @brief 创建一张 (id int) 的表，插入 row_num 行，并记录为修改过的行
+ */
+static Table *create_table(Db &db, const char *name, int row_num)
+{
+  AttrInfoSqlNode attr;
+  attr.type   = INTS;
+  attr.name   = "id";
+  attr.length = 4;
+  if (db.create_table(name, 1, &attr) != RC::SUCCESS) {
+    return nullptr;
+  }
+
+  Table *table = db.find_table(name);
+  for (int i = 0; i < row_num; i++) {
+    Value  value(i);
+    Record record;
+    EXPECT_EQ(RC::SUCCESS, table->make_record(1, &value, record));
+    EXPECT_EQ(RC::SUCCESS, table->insert_record(record));
+  }
+  table->add_modifications(row_num, 0, 0);
+  return table;
+}
+
+/**
+ * @brief 等待后台线程刷新表的统计信息
+ */
+static bool wait_for_analyzed(Table &table, int64_t row_count)
+{
+  const auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+  while (chrono::steady_clock::now() < deadline) {
+    if (table.stats()->analyzed() && table.stats()->row_count() == row_count) {
+      return true;
+    }
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+  return false;
+}
+
+class StatsRefresherTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_NE(nullptr, mkdtemp(db_dir_));
+    if (TrxKit::instance() == nullptr) {
+      ASSERT_EQ(TrxKit::init_global("vacuous"), RC::SUCCESS);
+    }
+    GCTX.trx_kit_ = TrxKit::instance();  // 打开 DB 时恢复日志需要
+
+    db_ = new Db();
+    ASSERT_EQ(RC::SUCCESS, db_->init("stats_refresher_test", db_dir_));
+    ASSERT_NE(nullptr, db_->stats_refresher());
+    ASSERT_EQ(RC::SUCCESS, db_->stats_refresher()->set_interval_ms(1));
+  }
+
+  void TearDown() override { delete db_; }
+
+  char db_dir_[32] = "stats_refresher_test.XXXXXX";
+  Db  *db_         = nullptr;
+};
+
+// 修改的行数超过阈值之后，后台线程刷新统计信息，并清零修改计数
+TEST_F(StatsRefresherTest, refresh_stale_table)
+{
+  Table *table = create_table(*db_, "t_stale", 200);
+  ASSERT_NE(nullptr, table);
+  ASSERT_TRUE(wait_for_analyzed(*table, 200));
+  ASSERT_EQ(0, table->modifications().total());
+
+  // 修改很少的表不刷新
+  Table *small_table = create_table(*db_, "t_small", StatsRefresher::MIN_MODIFIED_ROWS / 2);
+  ASSERT_NE(nullptr, small_table);
+  this_thread::sleep_for(chrono::milliseconds(50));
+  ASSERT_FALSE(small_table->stats()->analyzed());
+}
+
+// 后台线程在运行时不停地创建和删除表。删除表和分析表都在 Db 的表锁中进行，后台线程不会拿到已经删除的表
+TEST_F(StatsRefresherTest, drop_table_while_refreshing)
+{
+  for (int i = 0; i < 20; i++) {
+    const string name = "t_drop_" + to_string(i);
+    ASSERT_NE(nullptr, create_table(*db_, name.c_str(), 100 + i * 20));
+    this_thread::sleep_for(chrono::microseconds(i * 200));
+    ASSERT_EQ(RC::SUCCESS, db_->drop_table(name.c_str()));
+    ASSERT_EQ(nullptr, db_->find_table(name.c_str()));
+  }
+
+  Table *table = create_table(*db_, "t_after_drop", 300);
+  ASSERT_NE(nullptr, table);
+  ASSERT_TRUE(wait_for_analyzed(*table, 300));
+}
+
+// 后台线程只在挑选表时持有表锁。引用的表在删除时等待引用释放，等待期间可以创建其它的表，同名的表不能创建
+TEST_F(StatsRefresherTest, drop_waits_for_acquired_table)
+{
+  ASSERT_NE(nullptr, create_table(*db_, "t_acquired", 0));
+  Table *table = db_->acquire_table([](const vector<Table *> &tables) {
+    for (Table *table : tables) {
+      if (strcmp(table->name(), "t_acquired") == 0) {
+        return table;
+      }
+    }
+    return static_cast<Table *>(nullptr);
+  });
+  ASSERT_NE(nullptr, table);
+  ASSERT_FALSE(db_->dropping(table));
+
+  RC     drop_rc = RC::INTERNAL;
+  thread dropper([this, &drop_rc]() { drop_rc = db_->drop_table("t_acquired"); });
+
+  const auto deadline = chrono::steady_clock::now() + chrono::seconds(10);
+  while (!db_->dropping(table) && chrono::steady_clock::now() < deadline) {
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+  ASSERT_TRUE(db_->dropping(table));
+  ASSERT_EQ(table, db_->find_table("t_acquired"));
+  ASSERT_NE(nullptr, create_table(*db_, "t_other", 0));
+  ASSERT_EQ(nullptr, create_table(*db_, "t_acquired", 0));
+  ASSERT_NE(RC::SUCCESS, db_->drop_table("t_acquired"));
+
+  // 正在删除的表不会再被挑选出来
+  Table *chosen = db_->acquire_table([](const vector<Table *> &tables) {
+    for (Table *table : tables) {
+      EXPECT_STRNE("t_acquired", table->name());
+    }
+    return static_cast<Table *>(nullptr);
+  });
+  ASSERT_EQ(nullptr, chosen);
+
+  db_->release_table(table);
+  dropper.join();
+  ASSERT_EQ(RC::SUCCESS, drop_rc);
+  ASSERT_EQ(nullptr, db_->find_table("t_acquired"));
+}
+
+// stop 返回时后台线程已经退出，之后不会再分析任何表；stop 可以重复调用，停止之后可以重新启动
+TEST_F(StatsRefresherTest, stop_and_restart)
+{
+  StatsRefresher *refresher = db_->stats_refresher();
+  Table          *table     = create_table(*db_, "t_restart", 200);
+  ASSERT_NE(nullptr, table);
+  ASSERT_TRUE(wait_for_analyzed(*table, 200));
+
+  refresher->stop();
+  refresher->stop();
+  for (int i = 0; i < 200; i++) {
+    Value  value(i);
+    Record record;
+    ASSERT_EQ(RC::SUCCESS, table->make_record(1, &value, record));
+    ASSERT_EQ(RC::SUCCESS, table->insert_record(record));
+  }
+  table->add_modifications(200, 0, 0);
+  this_thread::sleep_for(chrono::milliseconds(50));
+  ASSERT_EQ(200, table->stats()->row_count());
+  ASSERT_EQ(200, table->modifications().total());
+
+  refresher->start();
+  refresher->start();
+  ASSERT_TRUE(wait_for_analyzed(*table, 400));
+}
+
+// 关闭 DB 时先停止后台线程再关闭表。后台线程正在分析一张大表时，停止也不需要等分析时的休息
+TEST_F(StatsRefresherTest, close_db_while_refreshing)
+{
+  Table *table = create_table(*db_, "t_big", 50000);
+  ASSERT_NE(nullptr, table);
+  this_thread::sleep_for(chrono::milliseconds(5));
+
+  const auto begin = chrono::steady_clock::now();
+  delete db_;
+  db_ = nullptr;
+  ASSERT_LT(chrono::steady_clock::now() - begin, chrono::seconds(5));
+
+  // 重新打开之后表还在，后台线程正常工作
+  db_ = new Db();
+  ASSERT_EQ(RC::SUCCESS, db_->init("stats_refresher_test", db_dir_));
+  ASSERT_EQ(RC::SUCCESS, db_->stats_refresher()->set_interval_ms(1));
+  table = db_->find_table("t_big");
+  ASSERT_NE(nullptr, table);
+  table->add_modifications(100, 0, 0);
+  ASSERT_TRUE(wait_for_analyzed(*table, 50000));
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  LoggerFactory::init_default("stats_refresher_test.log", LOG_LEVEL_INFO);
+  BufferPoolManager::set_instance(new BufferPoolManager());
+  return RUN_ALL_TESTS();
+}
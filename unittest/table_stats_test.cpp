@@ -0,0 +1,113 @@
+/* Copyright (c) 2021 OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <vector>
+
+#include "common/lang/bloom_filter.h"
+#include "common/lang/hyper_log_log.h"
+#include "gtest/gtest.h"
+#include "storage/field/field_meta.h"
+#include "storage/record/record.h"
+#include "storage/table/table_stats.h"
+
+using namespace std;
+
+TEST(hyper_log_log, estimate)
+{
+  for (int count : {10, 1000, 100000}) {
+    common::HyperLogLog hll;
+    for (int round = 0; round < 3; round++) {  // 重复加入不影响结果
+      for (int32_t i = 0; i < count; i++) {
+        hll.add(common::BloomFilter::hash(reinterpret_cast<const char *>(&i), sizeof(i)));
+      }
+    }
+    ASSERT_NEAR(count, hll.estimate(), count * 0.03 + 1);
+  }
+}
+
+TEST(table_stats, collect_and_persist)
+{
+  // 记录格式：id int, v int, name char(8)
+  FieldMeta id_field("id", INTS, 0, 4, true);
+  FieldMeta v_field("v", INTS, 4, 4, true);
+  FieldMeta name_field("name", CHARS, 8, 8, true);
+
+  const int           count = 50000;
+  TableStatsCollector collector({&id_field, &v_field, &name_field});
+  for (int32_t i = 0; i < count; i++) {
+    char data[16];
+    memset(data, 0, sizeof(data));
+    const int32_t v = i % 100;
+    memcpy(data, &i, sizeof(i));
+    memcpy(data + 4, &v, sizeof(v));
+    snprintf(data + 8, 8, "n%d", i % 7);
+
+    Record record;
+    record.set_data(data, sizeof(data));
+    collector.add_record(record);
+  }
+
+  // 假设只读取了一半的页面
+  TableStats stats;
+  collector.finish(200, 100, stats);
+  ASSERT_TRUE(stats.analyzed());
+  ASSERT_EQ(2 * count, stats.row_count());
+  ASSERT_EQ(200, stats.page_count());
+
+  const ColumnStats *id_stats = stats.column("id");
+  ASSERT_NE(nullptr, id_stats);
+  // 每个值只出现一次，按比例放大
+  ASSERT_NEAR(2 * count, id_stats->distinct_count, count * 0.1);
+  ASSERT_EQ(TableStatsCollector::HISTOGRAM_BUCKETS + 1, static_cast<int>(id_stats->bounds.size()));
+  for (size_t i = 1; i < id_stats->bounds.size(); i++) {
+    ASSERT_LE(id_stats->bounds[i - 1].get_int(), id_stats->bounds[i].get_int());
+  }
+  // 等深直方图的中间边界应该在中位数附近
+  ASSERT_NEAR(count / 2, id_stats->bounds[TableStatsCollector::HISTOGRAM_BUCKETS / 2].get_int(), count * 0.05);
+
+  // 重复的值很多时不会放大
+  ASSERT_NEAR(100, stats.column("v")->distinct_count, 5);
+  ASSERT_NEAR(7, stats.column("name")->distinct_count, 1);
+  ASSERT_EQ("n0", stats.column("name")->bounds.front().get_string());
+  ASSERT_EQ("n6", stats.column("name")->bounds.back().get_string());
+
+  const char *file_name = "table_stats_test.stats";
+  ASSERT_EQ(RC::SUCCESS, stats.save(file_name));
+
+  TableStats loaded;
+  ASSERT_EQ(RC::SUCCESS, loaded.load(file_name));
+  ASSERT_TRUE(loaded.analyzed());
+  ASSERT_EQ(stats.row_count(), loaded.row_count());
+  ASSERT_EQ(stats.page_count(), loaded.page_count());
+  ASSERT_EQ(stats.columns().size(), loaded.columns().size());
+  for (const ColumnStats &column : stats.columns()) {
+    const ColumnStats *loaded_column = loaded.column(column.field_name.c_str());
+    ASSERT_NE(nullptr, loaded_column);
+    ASSERT_EQ(column.attr_type, loaded_column->attr_type);
+    ASSERT_EQ(column.distinct_count, loaded_column->distinct_count);
+    ASSERT_EQ(column.bounds.size(), loaded_column->bounds.size());
+    for (size_t i = 0; i < column.bounds.size(); i++) {
+      ASSERT_EQ(0, column.bounds[i].compare(loaded_column->bounds[i]));
+    }
+  }
+
+  // 文件不存在时相当于没有统计信息
+  ::remove(file_name);
+  TableStats empty;
+  ASSERT_EQ(RC::SUCCESS, empty.load(file_name));
+  ASSERT_FALSE(empty.analyzed());
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}